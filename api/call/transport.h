@@ -35,6 +35,9 @@ struct PacketOptions {
   bool batchable = false;
   // Whether this packet is the last of a batch.
   bool last_packet_in_batch = false;
+  // Whether the packet should be sent with the ECN codepoint ECT(1), marking
+  // it as L4S capable.
+  bool send_as_ect1 = false;
 };
 
 class Transport {
@@ -1388,6 +1388,9 @@ struct RTC_EXPORT PeerConnectionDependencies final {
   std::unique_ptr<webrtc::AsyncDnsResolverFactoryInterface>
       async_dns_resolver_factory;
   std::unique_ptr<webrtc::IceTransportFactory> ice_transport_factory;
+  // Generates the certificate if none is configured. Pass an
+  // rtc::PooledRTCCertificateGenerator to take certificates generated ahead of
+  // time from a pool shared by many PeerConnections.
   std::unique_ptr<rtc::RTCCertificateGeneratorInterface> cert_generator;
   std::unique_ptr<rtc::SSLCertificateVerifier> tls_cert_verifier;
   std::unique_ptr<webrtc::VideoBitrateAllocatorFactory>
@@ -1511,6 +1514,21 @@ class RTC_EXPORT PeerConnectionFactoryInterface
 
     // Sets crypto related options, e.g. enabled cipher suites.
     CryptoOptions crypto_options = {};
+
+    // If set to true, the DTLS transports of all PeerConnections created by
+    // the factory share a session cache, and a handshake with a peer whose
+    // certificate was seen before resumes the earlier session, saving one
+    // round trip. Resumed sessions share the master secret of the original
+    // handshake, so this weakens forward secrecy.
+    bool enable_dtls_session_resumption = false;
+
+    // If greater than zero, SRTP encryption and decryption for the
+    // PeerConnections created by the factory run on a pool of this many
+    // threads instead of the network thread. Each transport is kept on one
+    // thread of the pool, so its packets stay in order. The pool is created
+    // by the first PeerConnection that uses it and keeps its size. Not used
+    // with external auth.
+    int srtp_crypto_threads = 0;
   };
 
   // Set the options to be used for subsequently created PeerConnections.
@@ -17,13 +17,15 @@ EmulatedIpPacket::EmulatedIpPacket(const rtc::SocketAddress& from,
                                    const rtc::SocketAddress& to,
                                    rtc::CopyOnWriteBuffer data,
                                    Timestamp arrival_time,
-                                   uint16_t application_overhead)
+                                   uint16_t application_overhead,
+                                   rtc::EcnMarking ecn)
     : from(from),
       to(to),
       data(data),
       headers_size(to.ipaddr().overhead() + application_overhead +
                    cricket::kUdpHeaderSize),
-      arrival_time(arrival_time) {
+      arrival_time(arrival_time),
+      ecn(ecn) {
   RTC_DCHECK(to.family() == AF_INET || to.family() == AF_INET6);
 }
 
@@ -22,6 +22,7 @@
 #include "api/units/timestamp.h"
 #include "rtc_base/copy_on_write_buffer.h"
 #include "rtc_base/ip_address.h"
+#include "rtc_base/network/ecn_marking.h"
 #include "rtc_base/socket_address.h"
 
 namespace webrtc {
@@ -32,7 +33,8 @@ struct EmulatedIpPacket {
                    const rtc::SocketAddress& to,
                    rtc::CopyOnWriteBuffer data,
                    Timestamp arrival_time,
-                   uint16_t application_overhead = 0);
+                   uint16_t application_overhead = 0,
+                   rtc::EcnMarking ecn = rtc::EcnMarking::kNotEct);
   ~EmulatedIpPacket() = default;
   // This object is not copyable or assignable.
   EmulatedIpPacket(const EmulatedIpPacket&) = delete;
@@ -51,6 +53,7 @@ struct EmulatedIpPacket {
   rtc::CopyOnWriteBuffer data;
   uint16_t headers_size;
   Timestamp arrival_time;
+  rtc::EcnMarking ecn;
 };
 
 // Interface for handling IP packets from an emulated network. This is used with
@@ -250,10 +253,12 @@ class EmulatedEndpoint : public EmulatedNetworkReceiverInterface {
   // socket.
   // `to` will be used for routing verification and picking right socket by port
   // on destination endpoint.
+  // `ecn` is the ECN marking the packet is sent with.
   virtual void SendPacket(const rtc::SocketAddress& from,
                           const rtc::SocketAddress& to,
                           rtc::CopyOnWriteBuffer packet_data,
-                          uint16_t application_overhead = 0) = 0;
+                          uint16_t application_overhead = 0,
+                          rtc::EcnMarking ecn = rtc::EcnMarking::kNotEct) = 0;
 
   // Binds receiver to this endpoint to send and receive data.
   // `desired_port` is a port that should be used. If it is equal to 0,
@@ -19,33 +19,48 @@
 #include "absl/functional/any_invocable.h"
 #include "absl/types/optional.h"
 #include "api/units/data_rate.h"
+#include "api/units/time_delta.h"
+#include "rtc_base/network/ecn_marking.h"
 #include "rtc_base/random.h"
 #include "rtc_base/thread_annotations.h"
 
 namespace webrtc {
 
 struct PacketInFlightInfo {
-  PacketInFlightInfo(size_t size, int64_t send_time_us, uint64_t packet_id)
-      : size(size), send_time_us(send_time_us), packet_id(packet_id) {}
+  PacketInFlightInfo(size_t size,
+                     int64_t send_time_us,
+                     uint64_t packet_id,
+                     rtc::EcnMarking ecn = rtc::EcnMarking::kNotEct)
+      : size(size),
+        send_time_us(send_time_us),
+        packet_id(packet_id),
+        ecn(ecn) {}
 
   size_t size;
   int64_t send_time_us;
   // Unique identifier for the packet in relation to other packets in flight.
   uint64_t packet_id;
+  // ECN marking of the packet as sent. The network may change it to
+  // congestion experienced.
+  rtc::EcnMarking ecn;
 };
 
 struct PacketDeliveryInfo {
   static constexpr int kNotReceived = -1;
   PacketDeliveryInfo(PacketInFlightInfo source, int64_t receive_time_us)
-      : receive_time_us(receive_time_us), packet_id(source.packet_id) {}
+      : receive_time_us(receive_time_us),
+        packet_id(source.packet_id),
+        ecn(source.ecn) {}
 
   bool operator==(const PacketDeliveryInfo& other) const {
     return receive_time_us == other.receive_time_us &&
-           packet_id == other.packet_id;
+           packet_id == other.packet_id && ecn == other.ecn;
   }
 
   int64_t receive_time_us;
   uint64_t packet_id;
+  // ECN marking of the packet as delivered.
+  rtc::EcnMarking ecn;
 };
 
 // BuiltInNetworkBehaviorConfig is a built-in network behavior configuration
@@ -71,6 +86,11 @@ struct BuiltInNetworkBehaviorConfig {
   int avg_burst_loss_length = -1;
   // Additional bytes to add to packet size.
   int packet_overhead = 0;
+  // L4S capable packets, marked ECT(1), that have queued for longer than this
+  // before leaving the capacity limited link are marked as congestion
+  // experienced, like by an L4S AQM with a step marking threshold (RFC 9332).
+  // Other packets are never marked. Infinite disables marking.
+  TimeDelta ecn_marking_queue_delay = TimeDelta::PlusInfinity();
 };
 
 // Interface that represents a Network behaviour.
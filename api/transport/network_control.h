@@ -111,6 +111,10 @@ class NetworkControllerFactoryInterface {
   // Returns the interval by which the network controller expects
   // OnProcessInterval calls.
   virtual TimeDelta GetProcessInterval() const = 0;
+  // Whether the network controllers reduce their rate when packets are
+  // reported as received with the ECN codepoint CE. Only then may packets be
+  // sent as ECT(1), which lets L4S bottlenecks mark them instead of queueing.
+  virtual bool ReactsToEcnCeMarks() const { return false; }
 };
 
 // Under development, subject to change without notice.
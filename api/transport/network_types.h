@@ -19,6 +19,7 @@
 #include "api/units/data_size.h"
 #include "api/units/time_delta.h"
 #include "api/units/timestamp.h"
+#include "rtc_base/network/ecn_marking.h"
 
 namespace webrtc {
 
@@ -166,6 +167,9 @@ struct RTC_EXPORT PacketResult {
 
   SentPacket sent_packet;
   Timestamp receive_time = Timestamp::PlusInfinity();
+  // ECN marking of the packet as received. Only reported by RFC 8888
+  // congestion control feedback.
+  rtc::EcnMarking ecn = rtc::EcnMarking::kNotEct;
 };
 
 struct RTC_EXPORT TransportPacketsFeedback {
@@ -24,6 +24,7 @@
 #include "rtc_base/crypto_random.h"
 #include "rtc_base/logging.h"
 #include "rtc_base/message_digest.h"
+#include "rtc_base/openssl_digest.h"
 #include "system_wrappers/include/metrics.h"
 
 using rtc::ByteBufferReader;
@@ -85,6 +86,25 @@ bool LengthValid(int type, int length) {
   return true;
 }
 
+// Checks the MESSAGE-INTEGRITY attribute at offset `mi_pos` of the message in
+// `data`, whose value is the first `mi_size` bytes of the HMAC. The HMAC
+// covers the message up to the attribute, with a length in the header that
+// ends with the attribute. Only the header is copied to set that length.
+bool CheckMessageIntegrity(const uint8_t* data,
+                           size_t mi_pos,
+                           size_t mi_size,
+                           const rtc::OpenSSLHmacSha1& hmac) {
+  uint8_t header[kStunHeaderSize];
+  memcpy(header, data, kStunHeaderSize);
+  rtc::SetBE16(header + 2,
+               static_cast<uint16_t>(mi_pos + kStunAttributeHeaderSize +
+                                     mi_size - kStunHeaderSize));
+  uint8_t mac[kStunMessageIntegritySize];
+  hmac.Compute(header, kStunHeaderSize, data + kStunHeaderSize,
+               mi_pos - kStunHeaderSize, mac);
+  return memcmp(data + mi_pos + kStunAttributeHeaderSize, mac, mi_size) == 0;
+}
+
 }  // namespace
 
 const char STUN_ERROR_REASON_TRY_ALTERNATE_SERVER[] = "Try Alternate Server";
@@ -104,6 +124,20 @@ const char EMPTY_TRANSACTION_ID[] = "0000000000000000";
 const uint32_t STUN_FINGERPRINT_XOR_VALUE = 0x5354554E;
 const int SERVER_NOT_REACHABLE_ERROR = 701;
 
+// StunMessageIntegrityKey
+
+StunMessageIntegrityKey::StunMessageIntegrityKey(absl::string_view password)
+    : password_(password),
+      hmac_(std::make_unique<rtc::OpenSSLHmacSha1>(password)) {}
+
+StunMessageIntegrityKey::StunMessageIntegrityKey(StunMessageIntegrityKey&&) =
+    default;
+
+StunMessageIntegrityKey& StunMessageIntegrityKey::operator=(
+    StunMessageIntegrityKey&&) = default;
+
+StunMessageIntegrityKey::~StunMessageIntegrityKey() = default;
+
 // StunMessage
 
 StunMessage::StunMessage()
@@ -241,13 +275,25 @@ const StunUInt16ListAttribute* StunMessage::GetUnknownAttributes() const {
 
 StunMessage::IntegrityStatus StunMessage::ValidateMessageIntegrity(
     const std::string& password) {
+  return ValidateMessageIntegrityWithHmac(password,
+                                          rtc::OpenSSLHmacSha1(password));
+}
+
+StunMessage::IntegrityStatus StunMessage::ValidateMessageIntegrity(
+    const StunMessageIntegrityKey& key) {
+  return ValidateMessageIntegrityWithHmac(key.password(), key.hmac());
+}
+
+StunMessage::IntegrityStatus StunMessage::ValidateMessageIntegrityWithHmac(
+    absl::string_view password,
+    const rtc::OpenSSLHmacSha1& hmac) {
   RTC_DCHECK(integrity_ == IntegrityStatus::kNotSet)
       << "Usage error: Verification should only be done once";
-  password_ = password;
+  password_ = std::string(password);
   if (GetByteString(STUN_ATTR_MESSAGE_INTEGRITY)) {
     if (ValidateMessageIntegrityOfType(
             STUN_ATTR_MESSAGE_INTEGRITY, kStunMessageIntegritySize,
-            buffer_.c_str(), buffer_.size(), password)) {
+            buffer_.c_str(), buffer_.size(), hmac)) {
       integrity_ = IntegrityStatus::kIntegrityOk;
     } else {
       integrity_ = IntegrityStatus::kIntegrityBad;
@@ -255,7 +301,7 @@ StunMessage::IntegrityStatus StunMessage::ValidateMessageIntegrity(
   } else if (GetByteString(STUN_ATTR_GOOG_MESSAGE_INTEGRITY_32)) {
     if (ValidateMessageIntegrityOfType(
             STUN_ATTR_GOOG_MESSAGE_INTEGRITY_32, kStunMessageIntegrity32Size,
-            buffer_.c_str(), buffer_.size(), password)) {
+            buffer_.c_str(), buffer_.size(), hmac)) {
       integrity_ = IntegrityStatus::kIntegrityOk;
     } else {
       integrity_ = IntegrityStatus::kIntegrityBad;
@@ -345,7 +391,7 @@ bool StunMessage::ValidateMessageIntegrityForTesting(
     const std::string& password) {
   return ValidateMessageIntegrityOfType(STUN_ATTR_MESSAGE_INTEGRITY,
                                         kStunMessageIntegritySize, data, size,
-                                        password);
+                                        rtc::OpenSSLHmacSha1(password));
 }
 
 bool StunMessage::ValidateMessageIntegrity32ForTesting(
@@ -354,7 +400,7 @@ bool StunMessage::ValidateMessageIntegrity32ForTesting(
     const std::string& password) {
   return ValidateMessageIntegrityOfType(STUN_ATTR_GOOG_MESSAGE_INTEGRITY_32,
                                         kStunMessageIntegrity32Size, data, size,
-                                        password);
+                                        rtc::OpenSSLHmacSha1(password));
 }
 
 // Deprecated
@@ -363,7 +409,7 @@ bool StunMessage::ValidateMessageIntegrity(const char* data,
                                            const std::string& password) {
   return ValidateMessageIntegrityOfType(STUN_ATTR_MESSAGE_INTEGRITY,
                                         kStunMessageIntegritySize, data, size,
-                                        password);
+                                        rtc::OpenSSLHmacSha1(password));
 }
 
 // Deprecated
@@ -372,16 +418,17 @@ bool StunMessage::ValidateMessageIntegrity32(const char* data,
                                              const std::string& password) {
   return ValidateMessageIntegrityOfType(STUN_ATTR_GOOG_MESSAGE_INTEGRITY_32,
                                         kStunMessageIntegrity32Size, data, size,
-                                        password);
+                                        rtc::OpenSSLHmacSha1(password));
 }
 
 // Verifies a STUN message has a valid MESSAGE-INTEGRITY attribute, using the
 // procedure outlined in RFC 5389, section 15.4.
-bool StunMessage::ValidateMessageIntegrityOfType(int mi_attr_type,
-                                                 size_t mi_attr_size,
-                                                 const char* data,
-                                                 size_t size,
-                                                 const std::string& password) {
+bool StunMessage::ValidateMessageIntegrityOfType(
+    int mi_attr_type,
+    size_t mi_attr_size,
+    const char* data,
+    size_t size,
+    const rtc::OpenSSLHmacSha1& hmac) {
   RTC_DCHECK(mi_attr_size <= kStunMessageIntegritySize);
 
   // Verifying the size of the message.
@@ -426,53 +473,38 @@ bool StunMessage::ValidateMessageIntegrityOfType(int mi_attr_type,
     return false;
   }
 
-  // Getting length of the message to calculate Message Integrity.
-  size_t mi_pos = current_pos;
-  std::unique_ptr<char[]> temp_data(new char[current_pos]);
-  memcpy(temp_data.get(), data, current_pos);
-  if (size > mi_pos + kStunAttributeHeaderSize + mi_attr_size) {
-    // Stun message has other attributes after message integrity.
-    // Adjust the length parameter in stun message to calculate HMAC.
-    size_t extra_offset =
-        size - (mi_pos + kStunAttributeHeaderSize + mi_attr_size);
-    size_t new_adjusted_len = size - extra_offset - kStunHeaderSize;
-
-    // Writing new length of the STUN message @ Message Length in temp buffer.
-    //      0                   1                   2                   3
-    //      0 1 2 3 4 5 6 7 8 9 0 1 2 3 4 5 6 7 8 9 0 1 2 3 4 5 6 7 8 9 0 1
-    //     +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
-    //     |0 0|     STUN Message Type     |         Message Length        |
-    //     +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
-    rtc::SetBE16(temp_data.get() + 2, static_cast<uint16_t>(new_adjusted_len));
-  }
-
-  char hmac[kStunMessageIntegritySize];
-  size_t ret =
-      rtc::ComputeHmac(rtc::DIGEST_SHA_1, password.c_str(), password.size(),
-                       temp_data.get(), mi_pos, hmac, sizeof(hmac));
-  RTC_DCHECK(ret == sizeof(hmac));
-  if (ret != sizeof(hmac)) {
-    return false;
-  }
-
-  // Comparing the calculated HMAC with the one present in the message.
-  return memcmp(data + current_pos + kStunAttributeHeaderSize, hmac,
-                mi_attr_size) == 0;
+  return CheckMessageIntegrity(reinterpret_cast<const uint8_t*>(data),
+                               current_pos, mi_attr_size, hmac);
 }
 
 bool StunMessage::AddMessageIntegrity(absl::string_view password) {
   return AddMessageIntegrityOfType(STUN_ATTR_MESSAGE_INTEGRITY,
-                                   kStunMessageIntegritySize, password);
+                                   kStunMessageIntegritySize, password,
+                                   rtc::OpenSSLHmacSha1(password));
+}
+
+bool StunMessage::AddMessageIntegrity(const StunMessageIntegrityKey& key) {
+  return AddMessageIntegrityOfType(STUN_ATTR_MESSAGE_INTEGRITY,
+                                   kStunMessageIntegritySize, key.password(),
+                                   key.hmac());
 }
 
 bool StunMessage::AddMessageIntegrity32(absl::string_view password) {
   return AddMessageIntegrityOfType(STUN_ATTR_GOOG_MESSAGE_INTEGRITY_32,
-                                   kStunMessageIntegrity32Size, password);
+                                   kStunMessageIntegrity32Size, password,
+                                   rtc::OpenSSLHmacSha1(password));
+}
+
+bool StunMessage::AddMessageIntegrity32(const StunMessageIntegrityKey& key) {
+  return AddMessageIntegrityOfType(STUN_ATTR_GOOG_MESSAGE_INTEGRITY_32,
+                                   kStunMessageIntegrity32Size, key.password(),
+                                   key.hmac());
 }
 
 bool StunMessage::AddMessageIntegrityOfType(int attr_type,
                                             size_t attr_size,
-                                            absl::string_view key) {
+                                            absl::string_view password,
+                                            const rtc::OpenSSLHmacSha1& hmac) {
   // Add the attribute with a dummy value. Since this is a known attribute, it
   // can't fail.
   RTC_DCHECK(attr_size <= kStunMessageIntegritySize);
@@ -488,20 +520,12 @@ bool StunMessage::AddMessageIntegrityOfType(int attr_type,
 
   int msg_len_for_hmac = static_cast<int>(
       buf.Length() - kStunAttributeHeaderSize - msg_integrity_attr->length());
-  char hmac[kStunMessageIntegritySize];
-  size_t ret =
-      rtc::ComputeHmac(rtc::DIGEST_SHA_1, key.data(), key.size(), buf.Data(),
-                       msg_len_for_hmac, hmac, sizeof(hmac));
-  RTC_DCHECK(ret == sizeof(hmac));
-  if (ret != sizeof(hmac)) {
-    RTC_LOG(LS_ERROR) << "HMAC computation failed. Message-Integrity "
-                         "has dummy value.";
-    return false;
-  }
+  char mac[kStunMessageIntegritySize];
+  hmac.Compute(buf.Data(), msg_len_for_hmac, nullptr, 0, mac);
 
   // Insert correct HMAC into the attribute.
-  msg_integrity_attr->CopyBytes(hmac, attr_size);
-  password_ = std::string(key);
+  msg_integrity_attr->CopyBytes(mac, attr_size);
+  password_ = std::string(password);
   integrity_ = IntegrityStatus::kIntegrityOk;
   return true;
 }
@@ -1522,4 +1546,126 @@ std::unique_ptr<StunMessage> StunMessage::Clone() const {
   return copy;
 }
 
+// StunBindingWriter
+
+StunBindingWriter::StunBindingWriter(uint16_t type,
+                                     absl::string_view transaction_id) {
+  RTC_DCHECK_EQ(transaction_id.size(), kStunTransactionIdLength);
+  rtc::SetBE16(buffer_, type);
+  rtc::SetBE16(buffer_ + 2, 0);
+  rtc::SetBE32(buffer_ + kStunTransactionIdOffset - kStunMagicCookieLength,
+               kStunMagicCookie);
+  memcpy(buffer_ + kStunTransactionIdOffset, transaction_id.data(),
+         kStunTransactionIdLength);
+  size_ = kStunHeaderSize;
+}
+
+uint8_t* StunBindingWriter::AppendAttribute(uint16_t type, size_t length) {
+  size_t padded_length = (length + 3) & ~size_t{3};
+  if (finished_ || kStunAttributeHeaderSize + padded_length > kCapacity - size_)
+    return nullptr;
+  uint8_t* attr = buffer_ + size_;
+  rtc::SetBE16(attr, type);
+  rtc::SetBE16(attr + 2, static_cast<uint16_t>(length));
+  uint8_t* value = attr + kStunAttributeHeaderSize;
+  memset(value + length, 0, padded_length - length);
+  size_ += kStunAttributeHeaderSize + padded_length;
+  rtc::SetBE16(buffer_ + 2, static_cast<uint16_t>(size_ - kStunHeaderSize));
+  return value;
+}
+
+bool StunBindingWriter::AddUInt32(uint16_t type, uint32_t value) {
+  uint8_t* data = AppendAttribute(type, sizeof(value));
+  if (!data)
+    return false;
+  rtc::SetBE32(data, value);
+  return true;
+}
+
+bool StunBindingWriter::AddUInt64(uint16_t type, uint64_t value) {
+  uint8_t* data = AppendAttribute(type, sizeof(value));
+  if (!data)
+    return false;
+  rtc::SetBE64(data, value);
+  return true;
+}
+
+bool StunBindingWriter::AddByteString(uint16_t type, absl::string_view value) {
+  uint8_t* data = AppendAttribute(type, value.size());
+  if (!data)
+    return false;
+  memcpy(data, value.data(), value.size());
+  return true;
+}
+
+bool StunBindingWriter::AddUInt16List(uint16_t type,
+                                      rtc::ArrayView<const uint16_t> values) {
+  uint8_t* data = AppendAttribute(type, values.size() * sizeof(uint16_t));
+  if (!data)
+    return false;
+  for (uint16_t value : values) {
+    rtc::SetBE16(data, value);
+    data += sizeof(value);
+  }
+  return true;
+}
+
+bool StunBindingWriter::AddXorAddress(uint16_t type,
+                                      const rtc::SocketAddress& address) {
+  const rtc::IPAddress& ip = address.ipaddr();
+  uint8_t family;
+  size_t ip_size;
+  switch (ip.family()) {
+    case AF_INET:
+      family = STUN_ADDRESS_IPV4;
+      ip_size = sizeof(in_addr);
+      break;
+    case AF_INET6:
+      family = STUN_ADDRESS_IPV6;
+      ip_size = sizeof(in6_addr);
+      break;
+    default:
+      return false;
+  }
+  uint8_t* data = AppendAttribute(type, 4 + ip_size);
+  if (!data)
+    return false;
+  data[0] = 0;
+  data[1] = family;
+  rtc::SetBE16(data + 2, address.port() ^ (kStunMagicCookie >> 16));
+  if (family == STUN_ADDRESS_IPV4) {
+    in_addr v4 = ip.ipv4_address();
+    memcpy(data + 4, &v4, ip_size);
+  } else {
+    in6_addr v6 = ip.ipv6_address();
+    memcpy(data + 4, &v6, ip_size);
+  }
+  // The address is XORed with the magic cookie and, for IPv6, the
+  // transaction id, which follow each other in the header.
+  const uint8_t* mask = buffer_ + kStunMagicCookieLength;
+  for (size_t i = 0; i < ip_size; ++i) {
+    data[4 + i] ^= mask[i];
+  }
+  return true;
+}
+
+bool StunBindingWriter::Finish(const StunMessageIntegrityKey& key) {
+  constexpr size_t kTrailerSize = kStunAttributeHeaderSize +
+                                  kStunMessageIntegritySize +
+                                  kStunAttributeHeaderSize + sizeof(uint32_t);
+  if (finished_ || kTrailerSize > kCapacity - size_)
+    return false;
+  size_t mi_pos = size_;
+  uint8_t* mac =
+      AppendAttribute(STUN_ATTR_MESSAGE_INTEGRITY, kStunMessageIntegritySize);
+  key.hmac().Compute(buffer_, mi_pos, nullptr, 0, mac);
+  size_t fingerprint_pos = size_;
+  uint8_t* fingerprint =
+      AppendAttribute(STUN_ATTR_FINGERPRINT, sizeof(uint32_t));
+  rtc::SetBE32(fingerprint, rtc::ComputeCrc32(buffer_, fingerprint_pos) ^
+                                STUN_FINGERPRINT_XOR_VALUE);
+  finished_ = true;
+  return true;
+}
+
 }  // namespace cricket
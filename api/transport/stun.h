@@ -28,6 +28,10 @@
 #include "rtc_base/ip_address.h"
 #include "rtc_base/socket_address.h"
 
+namespace rtc {
+class OpenSSLHmacSha1;
+}  // namespace rtc
+
 namespace cricket {
 
 // These are the types of STUN messages defined in RFC 5389.
@@ -139,6 +143,25 @@ class StunUInt32Attribute;
 class StunUInt64Attribute;
 class StunXorAddressAttribute;
 
+// A password used for MESSAGE-INTEGRITY, with its HMAC-SHA1 key schedule
+// computed once. An ICE connection signs and checks every connectivity check
+// with the same two passwords, and keeping a key for each saves the key setup
+// and the allocations that passing the password costs for every message.
+class StunMessageIntegrityKey {
+ public:
+  explicit StunMessageIntegrityKey(absl::string_view password = "");
+  StunMessageIntegrityKey(StunMessageIntegrityKey&&);
+  StunMessageIntegrityKey& operator=(StunMessageIntegrityKey&&);
+  ~StunMessageIntegrityKey();
+
+  const std::string& password() const { return password_; }
+  const rtc::OpenSSLHmacSha1& hmac() const { return *hmac_; }
+
+ private:
+  std::string password_;
+  std::unique_ptr<rtc::OpenSSLHmacSha1> hmac_;
+};
+
 // Records a complete STUN/TURN message.  Each message consists of a type and
 // any number of attributes.  Each attribute is parsed into an instance of an
 // appropriate class (see above).  The Get* methods will return instances of
@@ -218,7 +241,11 @@ class StunMessage {
 
   // Validates that a STUN message has a correct MESSAGE-INTEGRITY value.
   // This uses the buffered raw-format message stored by Read().
+  // The password overloads here and below set up the HMAC key on every call;
+  // callers that handle many messages with one password keep a
+  // StunMessageIntegrityKey instead.
   IntegrityStatus ValidateMessageIntegrity(const std::string& password);
+  IntegrityStatus ValidateMessageIntegrity(const StunMessageIntegrityKey& key);
 
   // Revalidates the STUN message with (possibly) a new password.
   // Indicates that calling logic needs review - probably previous call
@@ -242,10 +269,12 @@ class StunMessage {
 
   // Adds a MESSAGE-INTEGRITY attribute that is valid for the current message.
   bool AddMessageIntegrity(absl::string_view password);
+  bool AddMessageIntegrity(const StunMessageIntegrityKey& key);
 
   // Adds a STUN_ATTR_GOOG_MESSAGE_INTEGRITY_32 attribute that is valid for the
   // current message.
   bool AddMessageIntegrity32(absl::string_view password);
+  bool AddMessageIntegrity32(const StunMessageIntegrityKey& key);
 
   // Verify that a buffer has stun magic cookie and one of the specified
   // methods. Note that it does not check for the existance of FINGERPRINT.
@@ -322,12 +351,16 @@ class StunMessage {
   static bool IsValidTransactionId(absl::string_view transaction_id);
   bool AddMessageIntegrityOfType(int mi_attr_type,
                                  size_t mi_attr_size,
-                                 absl::string_view key);
+                                 absl::string_view password,
+                                 const rtc::OpenSSLHmacSha1& hmac);
+  IntegrityStatus ValidateMessageIntegrityWithHmac(
+      absl::string_view password,
+      const rtc::OpenSSLHmacSha1& hmac);
   static bool ValidateMessageIntegrityOfType(int mi_attr_type,
                                              size_t mi_attr_size,
                                              const char* data,
                                              size_t size,
-                                             const std::string& password);
+                                             const rtc::OpenSSLHmacSha1& hmac);
 
   uint16_t type_ = STUN_INVALID_MESSAGE_TYPE;
   uint16_t length_ = 0;
@@ -803,6 +836,48 @@ class IceMessage : public StunMessage {
   StunMessage* CreateNew() const override;
 };
 
+// Writes a STUN Binding request or response, such as an ICE connectivity
+// check, into a buffer inside the writer. Unlike StunMessage it creates no
+// attribute objects and does not allocate: the attributes are written in
+// place, and MESSAGE-INTEGRITY and FINGERPRINT are computed over the written
+// bytes. Only RFC 5389 messages, with 12 byte transaction ids, are supported.
+class StunBindingWriter {
+ public:
+  // Fits a connectivity check with every attribute Connection adds to it,
+  // except for a large GOOG-DELTA.
+  static constexpr size_t kCapacity = 256;
+
+  StunBindingWriter(uint16_t type, absl::string_view transaction_id);
+
+  // The Add methods append an attribute. They return false, and leave the
+  // message unchanged, if the attribute does not fit or if the message has
+  // been finished.
+  bool AddUInt32(uint16_t type, uint32_t value);
+  bool AddUInt64(uint16_t type, uint64_t value);
+  bool AddByteString(uint16_t type, absl::string_view value);
+  bool AddUInt16List(uint16_t type, rtc::ArrayView<const uint16_t> values);
+  bool AddXorAddress(uint16_t type, const rtc::SocketAddress& address);
+
+  // Appends MESSAGE-INTEGRITY, computed with `key`, and FINGERPRINT. Nothing
+  // can be added afterwards.
+  bool Finish(const StunMessageIntegrityKey& key);
+
+  // The message written so far.
+  rtc::ArrayView<const uint8_t> data() const {
+    return rtc::ArrayView<const uint8_t>(buffer_, size_);
+  }
+
+ private:
+  // Appends the header of an attribute with a `length` byte value, and the
+  // padding after the value. Returns where the value goes, or null if it does
+  // not fit.
+  uint8_t* AppendAttribute(uint16_t type, size_t length);
+
+  uint8_t buffer_[kCapacity];
+  size_t size_ = 0;
+  bool finished_ = false;
+};
+
 }  // namespace cricket
 
 #endif  // API_TRANSPORT_STUN_H_
@@ -15,6 +15,7 @@
 #include <memory>
 #include <string>
 #include <utility>
+#include <vector>
 
 #include "rtc_base/arraysize.h"
 #include "rtc_base/byte_buffer.h"
@@ -1867,4 +1868,103 @@ TEST_F(StunTest, ValidateMessageIntegrityWithParser) {
   EXPECT_EQ(webrtc::metrics::NumSamples("WebRTC.Stun.Integrity.Request"), 2);
 }
 
+TEST_F(StunTest, MessageIntegrityWithKey) {
+  StunMessageIntegrityKey key(kRfc5769SampleMsgPassword);
+  EXPECT_EQ(key.password(), kRfc5769SampleMsgPassword);
+
+  StunMessage message;
+  rtc::ByteBufferReader reader(kRfc5769SampleRequest);
+  ASSERT_TRUE(message.Read(&reader));
+  EXPECT_EQ(message.ValidateMessageIntegrity(key),
+            StunMessage::IntegrityStatus::kIntegrityOk);
+  EXPECT_EQ(message.password(), kRfc5769SampleMsgPassword);
+
+  StunMessage other;
+  rtc::ByteBufferReader other_reader(kRfc5769SampleResponse);
+  ASSERT_TRUE(other.Read(&other_reader));
+  EXPECT_EQ(other.ValidateMessageIntegrity(
+                StunMessageIntegrityKey("InvalidPassword")),
+            StunMessage::IntegrityStatus::kIntegrityBad);
+
+  IceMessage msg;
+  rtc::ByteBufferReader buf(kRfc5769SampleRequestWithoutMI);
+  ASSERT_TRUE(msg.Read(&buf));
+  EXPECT_TRUE(msg.AddMessageIntegrity(key));
+  const StunByteStringAttribute* mi_attr =
+      msg.GetByteString(STUN_ATTR_MESSAGE_INTEGRITY);
+  ASSERT_NE(mi_attr, nullptr);
+  EXPECT_EQ(0, memcmp(mi_attr->array_view().data(), kCalculatedHmac1,
+                      sizeof(kCalculatedHmac1)));
+
+  IceMessage msg32;
+  rtc::ByteBufferReader buf32(kRfc5769SampleRequestWithoutMI);
+  ASSERT_TRUE(msg32.Read(&buf32));
+  EXPECT_TRUE(msg32.AddMessageIntegrity32(key));
+  const StunByteStringAttribute* mi32_attr =
+      msg32.GetByteString(STUN_ATTR_GOOG_MESSAGE_INTEGRITY_32);
+  ASSERT_NE(mi32_attr, nullptr);
+  EXPECT_EQ(0, memcmp(mi32_attr->array_view().data(), kCalculatedHmac1_32,
+                      sizeof(kCalculatedHmac1_32)));
+}
+
+// The writer must produce the same bytes as StunMessage for a connectivity
+// check.
+TEST_F(StunTest, BindingWriterMatchesStunMessage) {
+  const std::string kTransactionId = "ABCDEFGHIJKL";
+  const uint16_t kMiscInfo[] = {1, 2};
+  StunMessageIntegrityKey key(kRfc5769SampleMsgPassword);
+  for (const rtc::SocketAddress& address :
+       {kRfc5769SampleMsgMappedAddress, kRfc5769SampleMsgIPv6MappedAddress}) {
+    IceMessage msg(STUN_BINDING_REQUEST, kTransactionId);
+    msg.AddAttribute(std::make_unique<StunByteStringAttribute>(
+        STUN_ATTR_USERNAME, kRfc5769SampleMsgUsername));
+    msg.AddAttribute(
+        std::make_unique<StunUInt32Attribute>(STUN_ATTR_PRIORITY, 0x6e0001ff));
+    msg.AddAttribute(std::make_unique<StunUInt64Attribute>(
+        STUN_ATTR_ICE_CONTROLLING, 0x932ff9b151263b36));
+    msg.AddAttribute(
+        std::make_unique<StunByteStringAttribute>(STUN_ATTR_USE_CANDIDATE));
+    auto list =
+        StunAttribute::CreateUInt16ListAttribute(STUN_ATTR_GOOG_MISC_INFO);
+    for (uint16_t value : kMiscInfo) {
+      list->AddType(value);
+    }
+    msg.AddAttribute(std::move(list));
+    msg.AddAttribute(std::make_unique<StunXorAddressAttribute>(
+        STUN_ATTR_XOR_MAPPED_ADDRESS, address));
+    ASSERT_TRUE(msg.AddMessageIntegrity(kRfc5769SampleMsgPassword));
+    ASSERT_TRUE(msg.AddFingerprint());
+    rtc::ByteBufferWriter expected;
+    ASSERT_TRUE(msg.Write(&expected));
+
+    StunBindingWriter writer(STUN_BINDING_REQUEST, kTransactionId);
+    EXPECT_TRUE(
+        writer.AddByteString(STUN_ATTR_USERNAME, kRfc5769SampleMsgUsername));
+    EXPECT_TRUE(writer.AddUInt32(STUN_ATTR_PRIORITY, 0x6e0001ff));
+    EXPECT_TRUE(
+        writer.AddUInt64(STUN_ATTR_ICE_CONTROLLING, 0x932ff9b151263b36));
+    EXPECT_TRUE(writer.AddByteString(STUN_ATTR_USE_CANDIDATE, ""));
+    EXPECT_TRUE(writer.AddUInt16List(STUN_ATTR_GOOG_MISC_INFO, kMiscInfo));
+    EXPECT_TRUE(writer.AddXorAddress(STUN_ATTR_XOR_MAPPED_ADDRESS, address));
+    EXPECT_TRUE(writer.Finish(key));
+
+    EXPECT_EQ(std::vector<uint8_t>(writer.data().begin(), writer.data().end()),
+              std::vector<uint8_t>(expected.Data(),
+                                   expected.Data() + expected.Length()));
+    EXPECT_FALSE(writer.AddUInt32(STUN_ATTR_PRIORITY, 0));
+    EXPECT_FALSE(writer.Finish(key));
+  }
+}
+
+TEST_F(StunTest, BindingWriterRejectsAttributesThatDoNotFit) {
+  StunBindingWriter writer(STUN_BINDING_REQUEST, "ABCDEFGHIJKL");
+  std::string value(StunBindingWriter::kCapacity, 'x');
+  EXPECT_FALSE(writer.AddByteString(STUN_ATTR_USERNAME, value));
+  EXPECT_EQ(writer.data().size(), kStunHeaderSize);
+  value.resize(StunBindingWriter::kCapacity - kStunHeaderSize -
+               kStunAttributeHeaderSize);
+  EXPECT_TRUE(writer.AddByteString(STUN_ATTR_USERNAME, value));
+  EXPECT_FALSE(writer.Finish(StunMessageIntegrityKey("password")));
+}
+
 }  // namespace cricket
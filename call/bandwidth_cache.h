@@ -0,0 +1,52 @@
+/*
+ *  Copyright (c) 2024 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef CALL_BANDWIDTH_CACHE_H_
+#define CALL_BANDWIDTH_CACHE_H_
+
+#include "absl/strings/string_view.h"
+#include "absl/types/optional.h"
+#include "api/units/data_rate.h"
+#include "rtc_base/network_route.h"
+
+namespace webrtc {
+
+// Remembers bandwidth estimates per destination and network route across
+// calls. A call whose route to its destination has a remembered estimate
+// starts its bandwidth estimation, and the initial probing, from there rather
+// than from the configured start bitrate, and so reaches the capacity of a
+// good link faster.
+//
+// The destination is an ID of the remote party chosen by the application,
+// see CallConfig::bandwidth_cache_destination. rtc::NetworkRoute doesn't tell
+// remote parties apart, so estimates are only cached for calls that have one.
+//
+// Shared between calls, so implementations must be thread safe. They may
+// persist the estimates, and should forget estimates that are too old to be
+// trusted.
+class BandwidthCache {
+ public:
+  virtual ~BandwidthCache() = default;
+
+  // Returns the estimate last recorded for `route` to `destination`, if any.
+  virtual absl::optional<DataRate> GetEstimate(
+      absl::string_view destination,
+      const rtc::NetworkRoute& route) = 0;
+
+  // Records `estimate` for `route` to `destination`, replacing any earlier
+  // estimate.
+  virtual void SetEstimate(absl::string_view destination,
+                           const rtc::NetworkRoute& route,
+                           DataRate estimate) = 0;
+};
+
+}  // namespace webrtc
+
+#endif  // CALL_BANDWIDTH_CACHE_H_
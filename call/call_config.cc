@@ -29,6 +29,9 @@ RtpTransportConfig CallConfig::ExtractTransportConfig() const {
   transport_config.network_state_predictor_factory =
       network_state_predictor_factory;
   transport_config.pacer_burst_interval = pacer_burst_interval;
+  transport_config.pacer_scheduler = pacer_scheduler;
+  transport_config.bandwidth_cache = bandwidth_cache;
+  transport_config.bandwidth_cache_destination = bandwidth_cache_destination;
 
   return transport_config;
 }
@@ -10,6 +10,8 @@
 #ifndef CALL_CALL_CONFIG_H_
 #define CALL_CALL_CONFIG_H_
 
+#include <string>
+
 #include "api/environment/environment.h"
 #include "api/fec_controller.h"
 #include "api/metronome/metronome.h"
@@ -74,6 +76,18 @@ struct CallConfig {
   // The burst interval of the pacer, see TaskQueuePacedSender constructor.
   absl::optional<TimeDelta> pacer_burst_interval;
 
+  // Scheduler shared with the pacers of other calls on the same worker task
+  // queue, see TaskQueuePacedSender constructor. Must outlive the call.
+  PacerScheduler* pacer_scheduler = nullptr;
+
+  // Bandwidth estimates remembered across calls, see BandwidthCache. Must
+  // outlive the call.
+  BandwidthCache* bandwidth_cache = nullptr;
+  // ID of the remote party of the call, e.g. of the remote peer or of the
+  // media server, that `bandwidth_cache` keys estimates on. Estimates are
+  // neither used nor recorded when it is empty.
+  std::string bandwidth_cache_destination;
+
   // Enables send packet batching from the egress RTP sender.
   bool enable_send_packet_batching = false;
 };
@@ -0,0 +1,66 @@
+/*
+ *  Copyright (c) 2024 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "call/in_memory_bandwidth_cache.h"
+
+#include "absl/algorithm/container.h"
+#include "rtc_base/checks.h"
+
+namespace webrtc {
+
+InMemoryBandwidthCache::InMemoryBandwidthCache(Clock* clock, Config config)
+    : clock_(clock), config_(config) {
+  RTC_DCHECK_GT(config_.max_routes, 0);
+}
+
+InMemoryBandwidthCache::~InMemoryBandwidthCache() = default;
+
+absl::optional<DataRate> InMemoryBandwidthCache::GetEstimate(
+    absl::string_view destination,
+    const rtc::NetworkRoute& route) {
+  const Timestamp now = clock_->CurrentTime();
+  MutexLock lock(&mutex_);
+  auto it = absl::c_find_if(entries_, [&](const Entry& entry) {
+    return entry.destination == destination && entry.local == route.local &&
+           entry.remote == route.remote;
+  });
+  if (it == entries_.end()) {
+    return absl::nullopt;
+  }
+  if (now - it->update_time > config_.max_age) {
+    entries_.erase(it);
+    return absl::nullopt;
+  }
+  return it->estimate;
+}
+
+void InMemoryBandwidthCache::SetEstimate(absl::string_view destination,
+                                         const rtc::NetworkRoute& route,
+                                         DataRate estimate) {
+  const Timestamp now = clock_->CurrentTime();
+  MutexLock lock(&mutex_);
+  // Entries are kept in the order they were recorded in.
+  auto it = absl::c_find_if(entries_, [&](const Entry& entry) {
+    return entry.destination == destination && entry.local == route.local &&
+           entry.remote == route.remote;
+  });
+  if (it != entries_.end()) {
+    entries_.erase(it);
+  } else if (entries_.size() == config_.max_routes) {
+    entries_.erase(entries_.begin());
+  }
+  entries_.push_back({.destination = std::string(destination),
+                      .local = route.local,
+                      .remote = route.remote,
+                      .estimate = estimate,
+                      .update_time = now});
+}
+
+}  // namespace webrtc
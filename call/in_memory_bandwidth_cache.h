@@ -0,0 +1,74 @@
+/*
+ *  Copyright (c) 2024 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef CALL_IN_MEMORY_BANDWIDTH_CACHE_H_
+#define CALL_IN_MEMORY_BANDWIDTH_CACHE_H_
+
+#include <stddef.h>
+
+#include <string>
+#include <vector>
+
+#include "absl/strings/string_view.h"
+#include "absl/types/optional.h"
+#include "api/units/data_rate.h"
+#include "api/units/time_delta.h"
+#include "api/units/timestamp.h"
+#include "call/bandwidth_cache.h"
+#include "rtc_base/network_route.h"
+#include "rtc_base/synchronization/mutex.h"
+#include "rtc_base/thread_annotations.h"
+#include "system_wrappers/include/clock.h"
+
+namespace webrtc {
+
+// BandwidthCache keeping the estimates of the process in memory. Routes to a
+// destination are identified by the network and adapter of both endpoints,
+// and by whether they are relayed.
+class InMemoryBandwidthCache : public BandwidthCache {
+ public:
+  struct Config {
+    // Estimates older than this are not used.
+    TimeDelta max_age = TimeDelta::Minutes(30);
+    // Number of routes remembered, over all destinations. When full, the
+    // estimate that was recorded first is forgotten.
+    size_t max_routes = 100;
+  };
+
+  InMemoryBandwidthCache(Clock* clock, Config config);
+  explicit InMemoryBandwidthCache(Clock* clock)
+      : InMemoryBandwidthCache(clock, Config()) {}
+  ~InMemoryBandwidthCache() override;
+
+  absl::optional<DataRate> GetEstimate(absl::string_view destination,
+                                       const rtc::NetworkRoute& route) override;
+  void SetEstimate(absl::string_view destination,
+                   const rtc::NetworkRoute& route,
+                   DataRate estimate) override;
+
+ private:
+  struct Entry {
+    std::string destination;
+    rtc::RouteEndpoint local;
+    rtc::RouteEndpoint remote;
+    DataRate estimate;
+    Timestamp update_time;
+  };
+
+  Clock* const clock_;
+  const Config config_;
+
+  Mutex mutex_;
+  std::vector<Entry> entries_ RTC_GUARDED_BY(mutex_);
+};
+
+}  // namespace webrtc
+
+#endif  // CALL_IN_MEMORY_BANDWIDTH_CACHE_H_
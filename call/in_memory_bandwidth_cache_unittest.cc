@@ -0,0 +1,102 @@
+/*
+ *  Copyright (c) 2024 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "call/in_memory_bandwidth_cache.h"
+
+#include <stdint.h>
+
+#include "absl/types/optional.h"
+#include "api/units/data_rate.h"
+#include "api/units/time_delta.h"
+#include "rtc_base/network_route.h"
+#include "system_wrappers/include/clock.h"
+#include "test/gtest.h"
+
+namespace webrtc {
+namespace {
+
+constexpr DataRate kEstimate = DataRate::KilobitsPerSec(2500);
+constexpr char kPeer[] = "peer";
+
+rtc::NetworkRoute CreateRoute(uint16_t local_network_id,
+                              uint16_t remote_network_id,
+                              bool relayed = false) {
+  rtc::NetworkRoute route;
+  route.connected = true;
+  route.local = rtc::RouteEndpoint(rtc::ADAPTER_TYPE_WIFI, /*adapter_id=*/1,
+                                   local_network_id, relayed);
+  route.remote = rtc::RouteEndpoint::CreateWithNetworkId(remote_network_id);
+  return route;
+}
+
+TEST(InMemoryBandwidthCacheTest, ReturnsEstimateOfRoute) {
+  SimulatedClock clock(Timestamp::Seconds(1000));
+  InMemoryBandwidthCache cache(&clock);
+  EXPECT_EQ(cache.GetEstimate(kPeer, CreateRoute(1, 2)), absl::nullopt);
+
+  cache.SetEstimate(kPeer, CreateRoute(1, 2), kEstimate);
+  EXPECT_EQ(cache.GetEstimate(kPeer, CreateRoute(1, 2)), kEstimate);
+  EXPECT_EQ(cache.GetEstimate(kPeer, CreateRoute(1, 3)), absl::nullopt);
+  EXPECT_EQ(cache.GetEstimate(kPeer, CreateRoute(1, 2, /*relayed=*/true)),
+            absl::nullopt);
+
+  cache.SetEstimate(kPeer, CreateRoute(1, 2), 2 * kEstimate);
+  EXPECT_EQ(cache.GetEstimate(kPeer, CreateRoute(1, 2)), 2 * kEstimate);
+}
+
+TEST(InMemoryBandwidthCacheTest, KeepsEstimatesPerDestination) {
+  SimulatedClock clock(Timestamp::Seconds(1000));
+  InMemoryBandwidthCache cache(&clock);
+  cache.SetEstimate("peer1", CreateRoute(1, 1), kEstimate);
+  cache.SetEstimate("peer2", CreateRoute(1, 1), 2 * kEstimate);
+
+  EXPECT_EQ(cache.GetEstimate("peer1", CreateRoute(1, 1)), kEstimate);
+  EXPECT_EQ(cache.GetEstimate("peer2", CreateRoute(1, 1)), 2 * kEstimate);
+  EXPECT_EQ(cache.GetEstimate("peer3", CreateRoute(1, 1)), absl::nullopt);
+}
+
+TEST(InMemoryBandwidthCacheTest, IgnoresPacketOverheadOfRoute) {
+  SimulatedClock clock(Timestamp::Seconds(1000));
+  InMemoryBandwidthCache cache(&clock);
+  rtc::NetworkRoute route = CreateRoute(1, 2);
+  cache.SetEstimate(kPeer, route, kEstimate);
+
+  route.packet_overhead = 48;
+  route.last_sent_packet_id = 17;
+  EXPECT_EQ(cache.GetEstimate(kPeer, route), kEstimate);
+}
+
+TEST(InMemoryBandwidthCacheTest, ForgetsOldEstimates) {
+  SimulatedClock clock(Timestamp::Seconds(1000));
+  InMemoryBandwidthCache cache(&clock, {.max_age = TimeDelta::Minutes(10)});
+  cache.SetEstimate(kPeer, CreateRoute(1, 2), kEstimate);
+
+  clock.AdvanceTime(TimeDelta::Minutes(10));
+  EXPECT_EQ(cache.GetEstimate(kPeer, CreateRoute(1, 2)), kEstimate);
+  clock.AdvanceTime(TimeDelta::Millis(1));
+  EXPECT_EQ(cache.GetEstimate(kPeer, CreateRoute(1, 2)), absl::nullopt);
+}
+
+TEST(InMemoryBandwidthCacheTest, ForgetsFirstRecordedRouteWhenFull) {
+  SimulatedClock clock(Timestamp::Seconds(1000));
+  InMemoryBandwidthCache cache(&clock, {.max_routes = 2});
+  cache.SetEstimate(kPeer, CreateRoute(1, 1), kEstimate);
+  cache.SetEstimate(kPeer, CreateRoute(1, 2), kEstimate);
+  // Recording an estimate again makes the route the last recorded one.
+  cache.SetEstimate(kPeer, CreateRoute(1, 1), kEstimate);
+
+  cache.SetEstimate(kPeer, CreateRoute(1, 3), kEstimate);
+  EXPECT_EQ(cache.GetEstimate(kPeer, CreateRoute(1, 1)), kEstimate);
+  EXPECT_EQ(cache.GetEstimate(kPeer, CreateRoute(1, 2)), absl::nullopt);
+  EXPECT_EQ(cache.GetEstimate(kPeer, CreateRoute(1, 3)), kEstimate);
+}
+
+}  // namespace
+}  // namespace webrtc
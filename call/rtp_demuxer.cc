@@ -159,6 +159,7 @@ bool RtpDemuxer::AddSink(const RtpDemuxerCriteria& criteria,
   }
 
   RefreshKnownMids();
+  resolved_sink_by_ssrc_.clear();
 
   RTC_DLOG(LS_INFO) << "Added sink = " << sink << " for criteria "
                     << criteria.ToString();
@@ -252,6 +253,7 @@ bool RtpDemuxer::RemoveSink(const RtpPacketSinkInterface* sink) {
                        RemoveFromMapByValue(&sink_by_mid_and_rsid_, sink) +
                        RemoveFromMapByValue(&sink_by_rsid_, sink);
   RefreshKnownMids();
+  resolved_sink_by_ssrc_.clear();
   return num_removed > 0;
 }
 
@@ -292,6 +294,18 @@ RtpPacketSinkInterface* RtpDemuxer::ResolveSink(
   }
   uint32_t ssrc = packet.Ssrc();
 
+  // IDs not included in the packet are latched for its SSRC. If the included
+  // ones match those the SSRC was last resolved by, so does the sink, and the
+  // SSRC binding and latched IDs were already recorded back then.
+  const auto resolved = resolved_sink_by_ssrc_.find(ssrc);
+  if (resolved != resolved_sink_by_ssrc_.end() &&
+      (!has_mid ||
+       (resolved->second.has_mid && resolved->second.mid == packet_mid)) &&
+      (!has_rsid ||
+       (resolved->second.has_rsid && resolved->second.rsid == packet_rsid))) {
+    return resolved->second.sink;
+  }
+
   // The BUNDLE spec says to drop any packets with unknown MIDs, even if the
   // SSRC is known/latched.
   if (has_mid && known_mids_.find(packet_mid) == known_mids_.end()) {
@@ -328,6 +342,31 @@ RtpPacketSinkInterface* RtpDemuxer::ResolveSink(
     }
   }
 
+  RtpPacketSinkInterface* sink =
+      ResolveSinkByIds(mid, rsid, ssrc, packet.PayloadType());
+
+  // Dropped packets are not worth remembering, and without IDs the sink
+  // depends on the payload type unless the SSRC is bound to a sink. The IDs
+  // latched for the SSRC may have changed all the same.
+  if (sink == nullptr || (mid == nullptr && rsid == nullptr &&
+                          sink_by_ssrc_.find(ssrc) == sink_by_ssrc_.end())) {
+    resolved_sink_by_ssrc_.erase(ssrc);
+  } else if (resolved != resolved_sink_by_ssrc_.end() ||
+             resolved_sink_by_ssrc_.size() < kMaxSsrcBindings) {
+    ResolvedSink& resolved_sink = resolved_sink_by_ssrc_[ssrc];
+    resolved_sink.has_mid = mid != nullptr;
+    resolved_sink.mid = mid != nullptr ? *mid : std::string();
+    resolved_sink.has_rsid = rsid != nullptr;
+    resolved_sink.rsid = rsid != nullptr ? *rsid : std::string();
+    resolved_sink.sink = sink;
+  }
+  return sink;
+}
+
+RtpPacketSinkInterface* RtpDemuxer::ResolveSinkByIds(const std::string* mid,
+                                                     const std::string* rsid,
+                                                     uint32_t ssrc,
+                                                     uint8_t payload_type) {
   // If MID and/or RSID is specified, prioritize that for demuxing the packet.
   // The motivation behind the BUNDLE algorithm is that we trust these are used
   // deliberately by senders and are more likely to be correct than SSRC/payload
@@ -373,7 +412,7 @@ RtpPacketSinkInterface* RtpDemuxer::ResolveSink(
   }
 
   // Legacy senders will only signal payload type, support that as last resort.
-  return ResolveSinkByPayloadType(packet.PayloadType(), ssrc);
+  return ResolveSinkByPayloadType(payload_type, ssrc);
 }
 
 RtpPacketSinkInterface* RtpDemuxer::ResolveSinkByMid(absl::string_view mid,
@@ -13,6 +13,7 @@
 
 #include <map>
 #include <string>
+#include <unordered_map>
 #include <utility>
 #include <vector>
 
@@ -169,6 +170,13 @@ class RtpDemuxer {
   // If the packet should be dropped, this method returns null.
   RtpPacketSinkInterface* ResolveSink(const RtpPacketReceived& packet);
 
+  // Resolves the sink by the MID and RSID of the packet, either included in it
+  // or latched for its SSRC, then by SSRC and last by payload type.
+  RtpPacketSinkInterface* ResolveSinkByIds(const std::string* mid,
+                                           const std::string* rsid,
+                                           uint32_t ssrc,
+                                           uint8_t payload_type);
+
   // Used by the ResolveSink algorithm.
   RtpPacketSinkInterface* ResolveSinkByMid(absl::string_view mid,
                                            uint32_t ssrc);
@@ -210,6 +218,19 @@ class RtpDemuxer {
   flat_map<uint32_t, std::string> mid_by_ssrc_;
   flat_map<uint32_t, std::string> rsid_by_ssrc_;
 
+  // Sink resolved for each SSRC, along with the MID and RSID it was resolved
+  // by, so that the packets of a known stream only need a hash lookup and a
+  // comparison of the IDs they include. Cleared whenever a sink is added or
+  // removed, as the resolution depends on all the criteria.
+  struct ResolvedSink {
+    bool has_mid = false;
+    std::string mid;
+    bool has_rsid = false;
+    std::string rsid;
+    RtpPacketSinkInterface* sink = nullptr;
+  };
+  std::unordered_map<uint32_t, ResolvedSink> resolved_sink_by_ssrc_;
+
   // Adds a binding from the SSRC to the given sink.
   void AddSsrcSinkBinding(uint32_t ssrc, RtpPacketSinkInterface* sink);
 
@@ -0,0 +1,74 @@
+/*
+ *  Copyright 2024 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <string>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "call/rtp_demuxer.h"
+#include "call/rtp_packet_sink_interface.h"
+#include "modules/rtp_rtcp/include/rtp_header_extension_map.h"
+#include "modules/rtp_rtcp/source/rtp_header_extensions.h"
+#include "modules/rtp_rtcp/source/rtp_packet_received.h"
+#include "rtc_base/checks.h"
+
+namespace webrtc {
+namespace {
+
+constexpr uint32_t kFirstSsrc = 1000;
+
+class CountingSink : public RtpPacketSinkInterface {
+ public:
+  void OnRtpPacket(const RtpPacketReceived& packet) override { ++packets_; }
+
+ private:
+  int packets_ = 0;
+};
+
+// Demuxes the packets of `state.range(0)` streams bundled on one transport,
+// each with its own MID, the way a receiver with that many transceivers does.
+void BM_DemuxByMid(benchmark::State& state) {
+  const int num_sinks = state.range(0);
+  RtpHeaderExtensionMap extensions;
+  extensions.Register<RtpMid>(1);
+
+  RtpDemuxer demuxer;
+  std::vector<CountingSink> sinks(num_sinks);
+  std::vector<RtpPacketReceived> packets;
+  for (int i = 0; i < num_sinks; ++i) {
+    const std::string mid = std::to_string(i);
+    RTC_CHECK(demuxer.AddSink(RtpDemuxerCriteria(mid), &sinks[i]));
+    RtpPacketReceived packet(&extensions);
+    packet.SetPayloadType(96);
+    packet.SetSsrc(kFirstSsrc + i);
+    RTC_CHECK(packet.SetExtension<RtpMid>(mid));
+    packets.push_back(packet);
+  }
+
+  size_t i = 0;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(demuxer.OnRtpPacket(packets[i]));
+    if (++i == packets.size()) {
+      i = 0;
+    }
+  }
+
+  for (CountingSink& sink : sinks) {
+    demuxer.RemoveSink(&sink);
+  }
+}
+
+BENCHMARK(BM_DemuxByMid)->Arg(10)->Arg(100)->Arg(1000);
+
+}  // namespace
+}  // namespace webrtc
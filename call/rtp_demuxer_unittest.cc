@@ -1238,6 +1238,53 @@ TEST_F(RtpDemuxerTest, PacketWithMidAndUnknownRsidIsNotRoutedByPayloadType) {
   EXPECT_FALSE(demuxer_.OnRtpPacket(*packet));
 }
 
+// Tests that a sink added for the MID a stream has been routed by takes over
+// the packets of the stream that only have the SSRC.
+TEST_F(RtpDemuxerTest, PacketsWithLatchedMidRoutedToReplacedSink) {
+  constexpr uint32_t ssrc = 10;
+  const std::string mid = "v";
+
+  MockRtpPacketSink old_sink;
+  AddSinkOnlyMid(mid, &old_sink);
+  auto packet_with_mid = CreatePacketWithSsrcMid(ssrc, mid);
+  EXPECT_CALL(old_sink, OnRtpPacket(_)).Times(1);
+  EXPECT_TRUE(demuxer_.OnRtpPacket(*packet_with_mid));
+  RemoveSink(&old_sink);
+
+  MockRtpPacketSink new_sink;
+  AddSinkOnlyMid(mid, &new_sink);
+  auto packet_ssrc_only = CreatePacketWithSsrc(ssrc);
+  EXPECT_CALL(new_sink, OnRtpPacket(SamePacketAs(*packet_ssrc_only)))
+      .Times(1);
+  EXPECT_TRUE(demuxer_.OnRtpPacket(*packet_ssrc_only));
+}
+
+// Tests that a dropped packet with another MID changes the MID latched for its
+// SSRC, even though the stream was routed by the previous MID before.
+TEST_F(RtpDemuxerTest, DroppedPacketWithNewMidChangesLatchedMid) {
+  constexpr uint32_t ssrc = 10;
+  const std::string mid = "a";
+  const std::string other_mid = "b";
+  const std::string other_rsid = "1";
+
+  MockRtpPacketSink sink;
+  AddSinkOnlyMid(mid, &sink);
+  MockRtpPacketSink other_sink;
+  AddSinkBothMidRsid(other_mid, other_rsid, &other_sink);
+
+  auto packet_with_mid = CreatePacketWithSsrcMid(ssrc, mid);
+  EXPECT_CALL(sink, OnRtpPacket(_)).Times(1);
+  EXPECT_TRUE(demuxer_.OnRtpPacket(*packet_with_mid));
+
+  // Without an RSID, the packet matches no sink for `other_mid`.
+  auto packet_with_other_mid = CreatePacketWithSsrcMid(ssrc, other_mid);
+  EXPECT_CALL(other_sink, OnRtpPacket(_)).Times(0);
+  EXPECT_FALSE(demuxer_.OnRtpPacket(*packet_with_other_mid));
+
+  auto packet_ssrc_only = CreatePacketWithSsrc(ssrc);
+  EXPECT_FALSE(demuxer_.OnRtpPacket(*packet_ssrc_only));
+}
+
 TEST_F(RtpDemuxerTest, MidMustNotExceedMaximumLength) {
   MockRtpPacketSink sink1;
   std::string mid1(BaseRtpStringExtension::kMaxValueSizeBytes + 1, 'a');
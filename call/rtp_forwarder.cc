@@ -0,0 +1,323 @@
+/*
+ *  Copyright (c) 2024 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+#include "call/rtp_forwarder.h"
+
+#include <string.h>
+
+#include <algorithm>
+#include <utility>
+
+#include "api/video/video_frame_type.h"
+#include "modules/include/module_common_types_public.h"
+#include "modules/rtp_rtcp/source/byte_io.h"
+#include "modules/rtp_rtcp/source/create_video_rtp_depacketizer.h"
+#include "modules/rtp_rtcp/source/rtp_dependency_descriptor_extension.h"
+#include "modules/rtp_rtcp/source/rtp_packet_received.h"
+#include "modules/rtp_rtcp/source/rtp_packet_to_send.h"
+#include "modules/rtp_rtcp/source/rtp_sender.h"
+#include "rtc_base/checks.h"
+#include "rtc_base/logging.h"
+
+namespace webrtc {
+namespace {
+
+// Extensions copied from the received packets. The others either describe
+// the hop to the forwarder, are set by the subscriber's RtpRtcp module, or
+// are rewritten, as the dependency descriptor is.
+constexpr RTPExtensionType kCopiedExtensions[] = {
+    kRtpExtensionAbsoluteCaptureTime,   kRtpExtensionVideoRotation,
+    kRtpExtensionPlayoutDelay,          kRtpExtensionVideoContentType,
+    kRtpExtensionVideoLayersAllocation, kRtpExtensionVideoTiming,
+    kRtpExtensionColorSpace,            kRtpExtensionVideoFrameTrackingId,
+};
+
+// Offset of the frame number in the mandatory dependency descriptor fields.
+constexpr size_t kFrameNumberOffset = 1;
+
+constexpr int kRtpTicksPerMs = kVideoPayloadTypeFrequency / 1000;
+
+}  // namespace
+
+RtpForwarder::RtpForwarder(const Config& config) : clock_(config.clock) {
+  RTC_DCHECK(clock_);
+  RTC_DCHECK(config.receiver_controller);
+  RTC_DCHECK(!config.ssrcs.empty());
+  streams_.reserve(config.ssrcs.size());
+  for (uint32_t ssrc : config.ssrcs) {
+    streams_.push_back(
+        {.ssrc = ssrc,
+         .receiver = config.receiver_controller->CreateReceiver(ssrc, this)});
+  }
+  for (const auto& [payload_type, codec] : config.payload_types) {
+    depacketizers_[payload_type] = CreateVideoRtpDepacketizer(codec);
+  }
+}
+
+RtpForwarder::~RtpForwarder() {
+  RTC_DCHECK_RUN_ON(&sequence_checker_);
+}
+
+void RtpForwarder::AddSubscriber(RtpRtcpInterface* rtp_rtcp) {
+  RTC_DCHECK_RUN_ON(&sequence_checker_);
+  RTC_DCHECK(rtp_rtcp->RtpSender());
+  RTC_DCHECK(!FindSubscriber(rtp_rtcp));
+  subscribers_.push_back(
+      {.rtp_rtcp = rtp_rtcp,
+       .max_spatial_layer = DependencyDescriptor::kMaxSpatialIds - 1,
+       .max_temporal_layer = DependencyDescriptor::kMaxTemporalIds - 1,
+       .spatial_layer = 0,
+       .temporal_layer = 0});
+}
+
+void RtpForwarder::RemoveSubscriber(RtpRtcpInterface* rtp_rtcp) {
+  RTC_DCHECK_RUN_ON(&sequence_checker_);
+  auto it = std::find_if(subscribers_.begin(), subscribers_.end(),
+                         [rtp_rtcp](const Subscriber& subscriber) {
+                           return subscriber.rtp_rtcp == rtp_rtcp;
+                         });
+  RTC_DCHECK(it != subscribers_.end());
+  if (it != subscribers_.end()) {
+    subscribers_.erase(it);
+  }
+}
+
+void RtpForwarder::SetMaxLayers(RtpRtcpInterface* rtp_rtcp,
+                                int spatial_layer,
+                                int temporal_layer) {
+  RTC_DCHECK_RUN_ON(&sequence_checker_);
+  RTC_DCHECK_GE(spatial_layer, 0);
+  RTC_DCHECK_GE(temporal_layer, 0);
+  Subscriber* subscriber = FindSubscriber(rtp_rtcp);
+  RTC_DCHECK(subscriber);
+  if (!subscriber) {
+    return;
+  }
+  subscriber->max_spatial_layer = spatial_layer;
+  subscriber->max_temporal_layer = temporal_layer;
+  subscriber->spatial_layer =
+      std::min(subscriber->spatial_layer, spatial_layer);
+  subscriber->temporal_layer =
+      std::min(subscriber->temporal_layer, temporal_layer);
+}
+
+void RtpForwarder::OnRtpPacket(const RtpPacketReceived& packet) {
+  RTC_DCHECK_RUN_ON(&sequence_checker_);
+  PacketInfo info;
+  if (!GetPacketInfo(packet, info) || packet.payload_size() == 0) {
+    return;
+  }
+  Timestamp now = clock_->CurrentTime();
+  for (Subscriber& subscriber : subscribers_) {
+    if (SelectPacket(subscriber, info, packet.Timestamp(), now)) {
+      Forward(subscriber, packet, info, now);
+    }
+  }
+}
+
+bool RtpForwarder::GetPacketInfo(const RtpPacketReceived& packet,
+                                 PacketInfo& info) {
+  auto stream = std::find_if(streams_.begin(), streams_.end(),
+                             [&](const SourceStream& stream) {
+                               return stream.ssrc == packet.Ssrc();
+                             });
+  if (stream == streams_.end()) {
+    return false;
+  }
+  info.stream = stream - streams_.begin();
+  // Late packets of earlier frames neither start a frame nor move the
+  // timestamp back.
+  const bool newer_timestamp =
+      !stream->last_timestamp ||
+      IsNewerTimestamp(packet.Timestamp(), *stream->last_timestamp);
+
+  info.dependency_descriptor =
+      packet.GetRawExtension<RtpDependencyDescriptorExtension>();
+  if (info.dependency_descriptor.empty()) {
+    // Without a dependency descriptor the stream can't be split in layers,
+    // and only its key frames are switching points.
+    info.first_packet_in_frame = newer_timestamp;
+    info.last_packet_in_frame = packet.Marker();
+    if (info.first_packet_in_frame) {
+      stream->key_frame = IsKeyFrame(packet);
+    }
+  } else {
+    DependencyDescriptor descriptor;
+    if (!RtpDependencyDescriptorExtension::Parse(info.dependency_descriptor,
+                                                 stream->structure.get(),
+                                                 &descriptor)) {
+      // Dropped until the next key frame attaches a structure to parse with.
+      return false;
+    }
+    info.has_dependency_descriptor = true;
+    info.first_packet_in_frame = descriptor.first_packet_in_frame;
+    info.last_packet_in_frame = descriptor.last_packet_in_frame;
+    if (descriptor.first_packet_in_frame) {
+      stream->key_frame = descriptor.attached_structure != nullptr;
+    }
+    info.spatial_id = descriptor.frame_dependencies.spatial_id;
+    info.temporal_id = descriptor.frame_dependencies.temporal_id;
+    info.frame_number = descriptor.frame_number;
+    if (descriptor.attached_structure) {
+      stream->structure = std::move(descriptor.attached_structure);
+    }
+  }
+  if (newer_timestamp) {
+    stream->last_timestamp = packet.Timestamp();
+  }
+  info.key_frame = stream->key_frame;
+
+  for (RTPExtensionType type : kCopiedExtensions) {
+    rtc::ArrayView<const uint8_t> data = packet.FindExtension(type);
+    if (!data.empty()) {
+      info.extensions.push_back({.type = type, .data = data});
+    }
+  }
+  return true;
+}
+
+bool RtpForwarder::IsKeyFrame(const RtpPacketReceived& packet) {
+  auto it = depacketizers_.find(packet.PayloadType());
+  if (it == depacketizers_.end()) {
+    return false;
+  }
+  absl::optional<VideoRtpDepacketizer::ParsedRtpPayload> parsed =
+      it->second->Parse(packet.PayloadBuffer());
+  return parsed &&
+         parsed->video_header.frame_type == VideoFrameType::kVideoFrameKey;
+}
+
+size_t RtpForwarder::TargetStream(const Subscriber& subscriber) const {
+  return std::min<size_t>(subscriber.max_spatial_layer, streams_.size() - 1);
+}
+
+bool RtpForwarder::SelectPacket(Subscriber& subscriber,
+                                const PacketInfo& info,
+                                uint32_t timestamp,
+                                Timestamp now) {
+  const bool switching_point = info.key_frame && info.first_packet_in_frame;
+  if (subscriber.stream != info.stream) {
+    if (info.stream != TargetStream(subscriber) || !switching_point) {
+      return false;
+    }
+    if (subscriber.last_timestamp) {
+      // Continue the subscriber's timestamps and frame numbers from where the
+      // previous stream left off.
+      int64_t elapsed_ticks =
+          (now - subscriber.last_timestamp_time).ms() * kRtpTicksPerMs;
+      uint32_t next_timestamp =
+          *subscriber.last_timestamp + std::max<int64_t>(elapsed_ticks, 1);
+      subscriber.timestamp_offset = next_timestamp - timestamp;
+      subscriber.frame_number_offset =
+          subscriber.last_frame_number + 1 - info.frame_number;
+    }
+    subscriber.stream = info.stream;
+    subscriber.spatial_layer = subscriber.max_spatial_layer;
+    subscriber.temporal_layer = subscriber.max_temporal_layer;
+  } else if (switching_point) {
+    subscriber.spatial_layer = subscriber.max_spatial_layer;
+    subscriber.temporal_layer = subscriber.max_temporal_layer;
+  } else if (info.first_packet_in_frame && info.temporal_id == 0) {
+    // Frames of the lowest temporal layer only reference frames of the same
+    // layer, so higher temporal layers can be added from here on.
+    subscriber.temporal_layer = subscriber.max_temporal_layer;
+  }
+
+  // Simulcast streams are selected as a whole.
+  if (streams_.size() == 1 && info.spatial_id > subscriber.spatial_layer) {
+    return false;
+  }
+  return info.temporal_id <= subscriber.temporal_layer;
+}
+
+void RtpForwarder::Forward(Subscriber& subscriber,
+                           const RtpPacketReceived& packet,
+                           const PacketInfo& info,
+                           Timestamp now) {
+  RtpRtcpInterface& rtp_rtcp = *subscriber.rtp_rtcp;
+  if (!rtp_rtcp.Sending()) {
+    return;
+  }
+  const uint32_t timestamp = packet.Timestamp() + subscriber.timestamp_offset;
+  const bool new_frame =
+      !subscriber.last_timestamp ||
+      IsNewerTimestamp(timestamp, *subscriber.last_timestamp);
+  if (new_frame &&
+      !rtp_rtcp.OnSendingRtpFrame(timestamp, /*capture_time_ms=*/-1,
+                                  packet.PayloadType(),
+                                  /*force_sender_report=*/info.key_frame)) {
+    return;
+  }
+
+  RTPSender& sender = *rtp_rtcp.RtpSender();
+  std::unique_ptr<RtpPacketToSend> forwarded =
+      sender.AllocatePacket(packet.Csrcs());
+  forwarded->SetPayloadType(packet.PayloadType());
+  // The marker ends the highest spatial layer forwarded, which may be lower
+  // than the highest layer received.
+  forwarded->SetMarker(packet.Marker() ||
+                       (info.has_dependency_descriptor &&
+                        info.last_packet_in_frame && streams_.size() == 1 &&
+                        info.spatial_id == subscriber.spatial_layer));
+  forwarded->SetTimestamp(timestamp + rtp_rtcp.StartTimestamp());
+  for (const Extension& extension : info.extensions) {
+    rtc::ArrayView<uint8_t> data =
+        forwarded->AllocateExtension(extension.type, extension.data.size());
+    if (data.size() == extension.data.size()) {
+      memcpy(data.data(), extension.data.data(), data.size());
+    }
+  }
+  if (info.has_dependency_descriptor) {
+    rtc::ArrayView<uint8_t> data =
+        forwarded->AllocateExtension(kRtpExtensionDependencyDescriptor,
+                                     info.dependency_descriptor.size());
+    if (data.size() == info.dependency_descriptor.size()) {
+      memcpy(data.data(), info.dependency_descriptor.data(), data.size());
+      uint16_t frame_number =
+          info.frame_number + subscriber.frame_number_offset;
+      ByteWriter<uint16_t>::WriteBigEndian(&data[kFrameNumberOffset],
+                                           frame_number);
+      subscriber.last_frame_number = frame_number;
+    }
+  }
+
+  uint8_t* payload = forwarded->AllocatePayload(packet.payload_size());
+  if (!payload) {
+    RTC_LOG(LS_WARNING) << "Dropping packet of SSRC " << packet.Ssrc()
+                        << " too large to forward to SSRC "
+                        << rtp_rtcp.SSRC();
+    return;
+  }
+  memcpy(payload, packet.payload().data(), packet.payload_size());
+
+  forwarded->set_packet_type(RtpPacketMediaType::kVideo);
+  forwarded->set_allow_retransmission(true);
+  forwarded->set_first_packet_of_frame(info.first_packet_in_frame);
+  forwarded->set_is_key_frame(info.key_frame);
+  if (new_frame) {
+    subscriber.last_timestamp = timestamp;
+    subscriber.last_timestamp_time = now;
+  }
+
+  std::vector<std::unique_ptr<RtpPacketToSend>> packets;
+  packets.push_back(std::move(forwarded));
+  sender.EnqueuePackets(std::move(packets));
+}
+
+RtpForwarder::Subscriber* RtpForwarder::FindSubscriber(
+    RtpRtcpInterface* rtp_rtcp) {
+  for (Subscriber& subscriber : subscribers_) {
+    if (subscriber.rtp_rtcp == rtp_rtcp) {
+      return &subscriber;
+    }
+  }
+  return nullptr;
+}
+
+}  // namespace webrtc
@@ -0,0 +1,173 @@
+/*
+ *  Copyright (c) 2024 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+#ifndef CALL_RTP_FORWARDER_H_
+#define CALL_RTP_FORWARDER_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <map>
+#include <memory>
+#include <vector>
+
+#include "absl/container/inlined_vector.h"
+#include "absl/types/optional.h"
+#include "api/array_view.h"
+#include "api/sequence_checker.h"
+#include "api/transport/rtp/dependency_descriptor.h"
+#include "api/units/timestamp.h"
+#include "api/video/video_codec_type.h"
+#include "call/rtp_packet_sink_interface.h"
+#include "call/rtp_stream_receiver_controller_interface.h"
+#include "modules/rtp_rtcp/include/rtp_rtcp_defines.h"
+#include "modules/rtp_rtcp/source/rtp_rtcp_interface.h"
+#include "modules/rtp_rtcp/source/video_rtp_depacketizer.h"
+#include "rtc_base/system/no_unique_address.h"
+#include "rtc_base/thread_annotations.h"
+#include "system_wrappers/include/clock.h"
+
+namespace webrtc {
+
+class RtpPacketReceived;
+
+// Forwards one received video source to any number of subscribers without
+// decoding it, as a selective forwarding unit does. Each subscriber is an
+// RtpRtcp module configured for sending with its own SSRC, pacer, packet
+// history and RTX, so packets are re-sent with the subscriber's SSRC and
+// sequence numbers, and retransmitted from its history on NACK.
+//
+// A source is either a single stream, possibly with spatial layers, or a set
+// of simulcast streams. Layers are selected per subscriber using the
+// dependency descriptor. Switching up a spatial layer or to another
+// simulcast stream waits for a key frame, which the caller is expected to
+// request from the sender when SetMaxLayers() changes the target. Streams
+// without a dependency descriptor are forwarded as a whole, and their key
+// frames are found by parsing the payload of the first packet of each
+// frame. RTP
+// timestamps and dependency descriptor frame numbers are rewritten so that
+// they continue across stream switches.
+//
+// Must be used on the sequence the receiver controller delivers packets on.
+class RtpForwarder : public RtpPacketSinkInterface {
+ public:
+  struct Config {
+    Clock* clock = nullptr;
+    RtpStreamReceiverControllerInterface* receiver_controller = nullptr;
+    // SSRCs of the source's simulcast streams, lowest resolution first, or
+    // the single SSRC of a source without simulcast.
+    std::vector<uint32_t> ssrcs;
+    // Codecs of the source's payload types, which key frames of packets
+    // without a dependency descriptor are found with. Such packets of other
+    // payload types are never a key frame, so forwarding never starts on
+    // them.
+    std::map<uint8_t, VideoCodecType> payload_types;
+  };
+
+  explicit RtpForwarder(const Config& config);
+  ~RtpForwarder() override;
+
+  RtpForwarder(const RtpForwarder&) = delete;
+  RtpForwarder& operator=(const RtpForwarder&) = delete;
+
+  // Starts forwarding all layers to `rtp_rtcp`, beginning with the next key
+  // frame of the highest simulcast stream.
+  void AddSubscriber(RtpRtcpInterface* rtp_rtcp);
+  void RemoveSubscriber(RtpRtcpInterface* rtp_rtcp);
+
+  // Limits the layers forwarded to `rtp_rtcp`. For simulcast sources
+  // `spatial_layer` is the index of the stream to forward, which is switched
+  // to on its next key frame. Otherwise lowering a limit takes effect
+  // immediately and raising it on the next frame that allows switching up.
+  void SetMaxLayers(RtpRtcpInterface* rtp_rtcp,
+                    int spatial_layer,
+                    int temporal_layer);
+
+  // Implements RtpPacketSinkInterface.
+  void OnRtpPacket(const RtpPacketReceived& packet) override;
+
+ private:
+  struct SourceStream {
+    uint32_t ssrc;
+    std::unique_ptr<RtpStreamReceiverInterface> receiver;
+    std::unique_ptr<FrameDependencyStructure> structure;
+    absl::optional<uint32_t> last_timestamp;
+    // Whether the frame being received is a key frame.
+    bool key_frame = false;
+  };
+
+  struct Extension {
+    RTPExtensionType type;
+    rtc::ArrayView<const uint8_t> data;
+  };
+
+  // The properties of a received packet that forwarding depends on, found
+  // once for all subscribers.
+  struct PacketInfo {
+    size_t stream;
+    bool has_dependency_descriptor = false;
+    bool first_packet_in_frame = false;
+    bool last_packet_in_frame = false;
+    // Whether the packet is part of a key frame, which can be switched to at
+    // its first packet.
+    bool key_frame = false;
+    int spatial_id = 0;
+    int temporal_id = 0;
+    uint16_t frame_number = 0;
+    // Extensions that are copied to the forwarded packets as is.
+    absl::InlinedVector<Extension, 8> extensions;
+    rtc::ArrayView<const uint8_t> dependency_descriptor;
+  };
+
+  struct Subscriber {
+    RtpRtcpInterface* rtp_rtcp;
+    int max_spatial_layer;
+    int max_temporal_layer;
+    // The layers forwarded now, which lag behind the maximum layers until the
+    // next switching point.
+    int spatial_layer;
+    int temporal_layer;
+    // Index of the source stream being forwarded, if any.
+    absl::optional<size_t> stream;
+    uint32_t timestamp_offset = 0;
+    uint16_t frame_number_offset = 0;
+    absl::optional<uint32_t> last_timestamp;
+    Timestamp last_timestamp_time = Timestamp::MinusInfinity();
+    uint16_t last_frame_number = 0;
+  };
+
+  bool GetPacketInfo(const RtpPacketReceived& packet, PacketInfo& info)
+      RTC_RUN_ON(sequence_checker_);
+  bool IsKeyFrame(const RtpPacketReceived& packet)
+      RTC_RUN_ON(sequence_checker_);
+  size_t TargetStream(const Subscriber& subscriber) const;
+  // Updates the layers and stream forwarded to `subscriber` if `info` is a
+  // switching point and returns whether to forward the packet.
+  bool SelectPacket(Subscriber& subscriber,
+                    const PacketInfo& info,
+                    uint32_t timestamp,
+                    Timestamp now) RTC_RUN_ON(sequence_checker_);
+  void Forward(Subscriber& subscriber,
+               const RtpPacketReceived& packet,
+               const PacketInfo& info,
+               Timestamp now) RTC_RUN_ON(sequence_checker_);
+  Subscriber* FindSubscriber(RtpRtcpInterface* rtp_rtcp)
+      RTC_RUN_ON(sequence_checker_);
+
+  RTC_NO_UNIQUE_ADDRESS SequenceChecker sequence_checker_;
+  Clock* const clock_;
+  std::vector<SourceStream> streams_ RTC_GUARDED_BY(sequence_checker_);
+  std::map<uint8_t, std::unique_ptr<VideoRtpDepacketizer>> depacketizers_
+      RTC_GUARDED_BY(sequence_checker_);
+  std::vector<Subscriber> subscribers_ RTC_GUARDED_BY(sequence_checker_);
+};
+
+}  // namespace webrtc
+
+#endif  // CALL_RTP_FORWARDER_H_
@@ -0,0 +1,154 @@
+/*
+ *  Copyright 2024 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "api/array_view.h"
+#include "api/call/transport.h"
+#include "api/transport/rtp/dependency_descriptor.h"
+#include "benchmark/benchmark.h"
+#include "call/rtp_forwarder.h"
+#include "call/rtp_stream_receiver_controller.h"
+#include "modules/rtp_rtcp/include/rtp_header_extension_map.h"
+#include "modules/rtp_rtcp/include/rtp_packet_sender.h"
+#include "modules/rtp_rtcp/source/rtp_dependency_descriptor_extension.h"
+#include "modules/rtp_rtcp/source/rtp_packet_received.h"
+#include "modules/rtp_rtcp/source/rtp_packet_to_send.h"
+#include "modules/rtp_rtcp/source/rtp_rtcp_impl2.h"
+#include "rtc_base/checks.h"
+#include "system_wrappers/include/clock.h"
+#include "test/explicit_key_value_config.h"
+#include "test/run_loop.h"
+
+namespace webrtc {
+namespace {
+
+constexpr int kDependencyDescriptorId = 1;
+constexpr uint32_t kSourceSsrc = 1000;
+constexpr uint32_t kFirstSubscriberSsrc = 2000;
+constexpr size_t kPayloadSize = 1100;
+constexpr int kNumFrames = 256;
+
+// A subscriber's RtpRtcp module, sending packets without pacing them to a
+// transport that drops them.
+class Subscriber : public Transport, public RtpPacketSender {
+ public:
+  Subscriber(Clock* clock,
+             uint32_t ssrc,
+             const FieldTrialsView& field_trials) {
+    RtpRtcpInterface::Configuration config;
+    config.audio = false;
+    config.clock = clock;
+    config.outgoing_transport = this;
+    config.paced_sender = this;
+    config.local_media_ssrc = ssrc;
+    config.field_trials = &field_trials;
+    rtp_rtcp_ = ModuleRtpRtcpImpl2::Create(config);
+    rtp_rtcp_->SetSendingStatus(true);
+    rtp_rtcp_->SetSendingMediaStatus(true);
+    rtp_rtcp_->SetStorePacketsStatus(true, 600);
+    rtp_rtcp_->RegisterRtpHeaderExtension(
+        RtpDependencyDescriptorExtension::Uri(), kDependencyDescriptorId);
+  }
+
+  RtpRtcpInterface* rtp_rtcp() { return rtp_rtcp_.get(); }
+
+  void EnqueuePackets(
+      std::vector<std::unique_ptr<RtpPacketToSend>> packets) override {
+    for (auto& packet : packets) {
+      rtp_rtcp_->TrySendPacket(std::move(packet), {});
+    }
+  }
+
+  bool SendRtp(rtc::ArrayView<const uint8_t> packet,
+               const PacketOptions& options) override {
+    return true;
+  }
+  bool SendRtcp(rtc::ArrayView<const uint8_t> packet) override { return true; }
+
+ private:
+  std::unique_ptr<ModuleRtpRtcpImpl2> rtp_rtcp_;
+};
+
+RtpPacketReceived CreatePacket(const RtpHeaderExtensionMap* extensions,
+                               const FrameDependencyStructure& structure,
+                               int frame_number) {
+  RtpPacketReceived packet(extensions);
+  packet.SetPayloadType(96);
+  packet.SetSsrc(kSourceSsrc);
+  packet.SetSequenceNumber(frame_number);
+  packet.SetTimestamp(3000 * frame_number);
+  packet.SetMarker(true);
+  DependencyDescriptor descriptor;
+  descriptor.frame_number = frame_number;
+  descriptor.frame_dependencies = structure.templates[0];
+  if (frame_number == 0) {
+    descriptor.attached_structure =
+        std::make_unique<FrameDependencyStructure>(structure);
+  }
+  RTC_CHECK(packet.SetExtension<RtpDependencyDescriptorExtension>(structure,
+                                                                  descriptor));
+  packet.AllocatePayload(kPayloadSize);
+  return packet;
+}
+
+// Forwards single packet frames of one stream to `state.range(0)`
+// subscribers, all receiving every layer.
+void BM_ForwardToSubscribers(benchmark::State& state) {
+  test::RunLoop loop;
+  Clock* clock = Clock::GetRealTimeClock();
+  test::ExplicitKeyValueConfig field_trials("");
+  RtpStreamReceiverController receiver_controller;
+  RtpForwarder forwarder({.clock = clock,
+                          .receiver_controller = &receiver_controller,
+                          .ssrcs = {kSourceSsrc}});
+  std::vector<std::unique_ptr<Subscriber>> subscribers;
+  for (int i = 0; i < state.range(0); ++i) {
+    subscribers.push_back(std::make_unique<Subscriber>(
+        clock, kFirstSubscriberSsrc + i, field_trials));
+    forwarder.AddSubscriber(subscribers.back()->rtp_rtcp());
+  }
+
+  RtpHeaderExtensionMap extensions;
+  extensions.Register<RtpDependencyDescriptorExtension>(
+      kDependencyDescriptorId);
+  FrameDependencyStructure structure;
+  structure.num_decode_targets = 1;
+  structure.templates = {FrameDependencyTemplate().Dtis("S").FrameDiffs({1})};
+  // The key frame, which starts forwarding.
+  receiver_controller.OnRtpPacket(CreatePacket(&extensions, structure, 0));
+  std::vector<RtpPacketReceived> packets;
+  for (int i = 1; i <= kNumFrames; ++i) {
+    packets.push_back(CreatePacket(&extensions, structure, i));
+  }
+
+  size_t i = 0;
+  for (auto _ : state) {
+    receiver_controller.OnRtpPacket(packets[i]);
+    if (++i == packets.size()) {
+      i = 0;
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+
+  for (const auto& subscriber : subscribers) {
+    forwarder.RemoveSubscriber(subscriber->rtp_rtcp());
+  }
+}
+
+BENCHMARK(BM_ForwardToSubscribers)->Arg(1)->Arg(10)->Arg(100);
+
+}  // namespace
+}  // namespace webrtc
@@ -0,0 +1,393 @@
+/*
+ *  Copyright (c) 2024 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "call/rtp_forwarder.h"
+
+#include <stdint.h>
+#include <string.h>
+
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "api/array_view.h"
+#include "api/call/transport.h"
+#include "api/transport/rtp/dependency_descriptor.h"
+#include "api/units/time_delta.h"
+#include "api/units/timestamp.h"
+#include "call/rtp_stream_receiver_controller.h"
+#include "modules/rtp_rtcp/include/rtp_header_extension_map.h"
+#include "modules/rtp_rtcp/include/rtp_packet_sender.h"
+#include "modules/rtp_rtcp/source/rtp_dependency_descriptor_extension.h"
+#include "modules/rtp_rtcp/source/rtp_packet_received.h"
+#include "modules/rtp_rtcp/source/rtp_packet_to_send.h"
+#include "modules/rtp_rtcp/source/rtp_rtcp_impl2.h"
+#include "modules/rtp_rtcp/source/rtp_sender.h"
+#include "test/explicit_key_value_config.h"
+#include "test/gmock.h"
+#include "test/gtest.h"
+#include "test/time_controller/simulated_time_controller.h"
+
+namespace webrtc {
+namespace {
+
+using ::testing::ElementsAreArray;
+using ::testing::SizeIs;
+
+constexpr int kDependencyDescriptorId = 1;
+constexpr int kPayloadType = 96;
+constexpr uint32_t kLowSsrc = 1000;
+constexpr uint32_t kHighSsrc = 1001;
+constexpr uint32_t kSubscriberSsrc = 2000;
+constexpr uint8_t kPayload[] = {1, 2, 3, 4};
+// VP8 payloads that start a frame, for streams without a dependency
+// descriptor.
+constexpr uint8_t kVp8KeyFrame[] = {0x10, 0x00, 0x00, 0x00, 0x9d, 0x01,
+                                    0x2a, 0x40, 0x01, 0xf0, 0x00};
+constexpr uint8_t kVp8DeltaFrame[] = {0x10, 0x01, 0x00, 0x00};
+
+// A subscriber's RtpRtcp module, with a pacer that sends packets right away
+// and a transport that keeps them.
+class Subscriber : public Transport, public RtpPacketSender {
+ public:
+  Subscriber(Clock* clock, uint32_t ssrc) {
+    RtpRtcpInterface::Configuration config;
+    config.audio = false;
+    config.clock = clock;
+    config.outgoing_transport = this;
+    config.paced_sender = this;
+    config.local_media_ssrc = ssrc;
+    config.field_trials = &field_trials_;
+    rtp_rtcp_ = ModuleRtpRtcpImpl2::Create(config);
+    rtp_rtcp_->SetSendingStatus(true);
+    rtp_rtcp_->SetSendingMediaStatus(true);
+    rtp_rtcp_->SetStorePacketsStatus(true, 100);
+    rtp_rtcp_->RegisterRtpHeaderExtension(
+        RtpDependencyDescriptorExtension::Uri(), kDependencyDescriptorId);
+    extensions_.Register<RtpDependencyDescriptorExtension>(
+        kDependencyDescriptorId);
+  }
+
+  RtpRtcpInterface* rtp_rtcp() { return rtp_rtcp_.get(); }
+  const std::vector<RtpPacketReceived>& sent_packets() const {
+    return sent_packets_;
+  }
+
+  void EnqueuePackets(
+      std::vector<std::unique_ptr<RtpPacketToSend>> packets) override {
+    for (auto& packet : packets) {
+      EXPECT_TRUE(rtp_rtcp_->TrySendPacket(std::move(packet), {}));
+    }
+  }
+
+  bool SendRtp(rtc::ArrayView<const uint8_t> packet,
+               const PacketOptions& options) override {
+    sent_packets_.emplace_back(&extensions_);
+    EXPECT_TRUE(sent_packets_.back().Parse(packet));
+    return true;
+  }
+  bool SendRtcp(rtc::ArrayView<const uint8_t> packet) override { return true; }
+
+ private:
+  test::ExplicitKeyValueConfig field_trials_{""};
+  RtpHeaderExtensionMap extensions_;
+  std::unique_ptr<ModuleRtpRtcpImpl2> rtp_rtcp_;
+  std::vector<RtpPacketReceived> sent_packets_;
+};
+
+// Two spatial layers with two temporal layers each.
+FrameDependencyStructure L2T2Structure() {
+  FrameDependencyStructure structure;
+  structure.num_decode_targets = 4;
+  structure.templates = {
+      FrameDependencyTemplate().S(0).T(0).Dtis("SSSS"),
+      FrameDependencyTemplate().S(0).T(1).Dtis("-D-D"),
+      FrameDependencyTemplate().S(1).T(0).Dtis("--SS"),
+      FrameDependencyTemplate().S(1).T(1).Dtis("---D"),
+  };
+  return structure;
+}
+
+struct Frame {
+  uint32_t ssrc = kLowSsrc;
+  uint32_t timestamp = 0;
+  int spatial_id = 0;
+  int temporal_id = 0;
+  int frame_number = 0;
+  bool key_frame = false;
+  bool marker = true;
+};
+
+class RtpForwarderTest : public ::testing::Test {
+ protected:
+  RtpForwarderTest()
+      : time_controller_(Timestamp::Seconds(10000)),
+        forwarder_({.clock = time_controller_.GetClock(),
+                    .receiver_controller = &receiver_controller_,
+                    .ssrcs = {kLowSsrc, kHighSsrc},
+                    .payload_types = {{kPayloadType, kVideoCodecVP8}}}) {
+    extensions_.Register<RtpDependencyDescriptorExtension>(
+        kDependencyDescriptorId);
+  }
+
+  // Receives a single packet VP8 frame without a dependency descriptor.
+  void ReceivePacket(uint32_t ssrc,
+                     uint32_t timestamp,
+                     bool key_frame,
+                     int payload_type = kPayloadType) {
+    RtpPacketReceived packet(&extensions_);
+    packet.SetPayloadType(payload_type);
+    packet.SetSsrc(ssrc);
+    packet.SetSequenceNumber(sequence_number_++);
+    packet.SetTimestamp(timestamp);
+    packet.SetMarker(true);
+    rtc::ArrayView<const uint8_t> payload =
+        key_frame ? rtc::ArrayView<const uint8_t>(kVp8KeyFrame)
+                  : rtc::ArrayView<const uint8_t>(kVp8DeltaFrame);
+    memcpy(packet.AllocatePayload(payload.size()), payload.data(),
+           payload.size());
+    receiver_controller_.OnRtpPacket(packet);
+  }
+
+  // Receives a single packet frame with a dependency descriptor.
+  void ReceiveFrame(const Frame& frame) {
+    RtpPacketReceived packet(&extensions_);
+    packet.SetPayloadType(kPayloadType);
+    packet.SetSsrc(frame.ssrc);
+    packet.SetSequenceNumber(sequence_number_++);
+    packet.SetTimestamp(frame.timestamp);
+    packet.SetMarker(frame.marker);
+    DependencyDescriptor descriptor;
+    descriptor.frame_number = frame.frame_number;
+    descriptor.frame_dependencies.spatial_id = frame.spatial_id;
+    descriptor.frame_dependencies.temporal_id = frame.temporal_id;
+    descriptor.frame_dependencies.decode_target_indications =
+        structure_.templates[2 * frame.spatial_id + frame.temporal_id]
+            .decode_target_indications;
+    if (frame.key_frame) {
+      descriptor.attached_structure =
+          std::make_unique<FrameDependencyStructure>(structure_);
+    }
+    ASSERT_TRUE(packet.SetExtension<RtpDependencyDescriptorExtension>(
+        structure_, descriptor));
+    memcpy(packet.AllocatePayload(sizeof(kPayload)), kPayload,
+           sizeof(kPayload));
+    receiver_controller_.OnRtpPacket(packet);
+  }
+
+  static uint16_t FrameNumber(const RtpPacketReceived& packet) {
+    DependencyDescriptorMandatory descriptor;
+    EXPECT_TRUE(RtpDependencyDescriptorExtension::Parse(
+        packet.GetRawExtension<RtpDependencyDescriptorExtension>(),
+        &descriptor));
+    return descriptor.frame_number();
+  }
+
+  GlobalSimulatedTimeController time_controller_;
+  RtpStreamReceiverController receiver_controller_;
+  RtpHeaderExtensionMap extensions_;
+  const FrameDependencyStructure structure_ = L2T2Structure();
+  uint16_t sequence_number_ = 100;
+  RtpForwarder forwarder_;
+};
+
+TEST_F(RtpForwarderTest, ForwardsWithSubscriberSsrcAndSequenceNumbers) {
+  Subscriber subscriber1(time_controller_.GetClock(), kSubscriberSsrc);
+  Subscriber subscriber2(time_controller_.GetClock(), kSubscriberSsrc + 1);
+  forwarder_.AddSubscriber(subscriber1.rtp_rtcp());
+  forwarder_.AddSubscriber(subscriber2.rtp_rtcp());
+
+  ReceivePacket(kHighSsrc, 3000, /*key_frame=*/true);
+  ReceivePacket(kHighSsrc, 6000, /*key_frame=*/false);
+  ReceivePacket(kHighSsrc, 9000, /*key_frame=*/false);
+
+  for (Subscriber* subscriber : {&subscriber1, &subscriber2}) {
+    const std::vector<RtpPacketReceived>& packets = subscriber->sent_packets();
+    ASSERT_THAT(packets, SizeIs(3));
+    for (size_t i = 0; i < packets.size(); ++i) {
+      EXPECT_EQ(packets[i].Ssrc(), subscriber->rtp_rtcp()->SSRC());
+      EXPECT_EQ(packets[i].SequenceNumber(),
+                static_cast<uint16_t>(packets[0].SequenceNumber() + i));
+      EXPECT_EQ(packets[i].Timestamp(),
+                packets[0].Timestamp() + static_cast<uint32_t>(3000 * i));
+      EXPECT_THAT(packets[i].payload(),
+                  ElementsAreArray(i == 0 ? rtc::ArrayView<const uint8_t>(
+                                                kVp8KeyFrame)
+                                          : rtc::ArrayView<const uint8_t>(
+                                                kVp8DeltaFrame)));
+    }
+  }
+}
+
+TEST_F(RtpForwarderTest, IgnoresUnknownSsrcAndStreamsNotSelected) {
+  Subscriber subscriber(time_controller_.GetClock(), kSubscriberSsrc);
+  forwarder_.AddSubscriber(subscriber.rtp_rtcp());
+
+  ReceivePacket(kLowSsrc, 3000, /*key_frame=*/true);
+  ReceivePacket(kHighSsrc + 1, 3000, /*key_frame=*/true);
+  EXPECT_THAT(subscriber.sent_packets(), SizeIs(0));
+}
+
+TEST_F(RtpForwarderTest, WaitsForKeyFrameInPayloadWithoutDescriptor) {
+  Subscriber subscriber(time_controller_.GetClock(), kSubscriberSsrc);
+  forwarder_.AddSubscriber(subscriber.rtp_rtcp());
+
+  ReceivePacket(kHighSsrc, 3000, /*key_frame=*/false);
+  // Key frames of payload types without a known codec aren't found.
+  ReceivePacket(kHighSsrc, 6000, /*key_frame=*/true, kPayloadType + 1);
+  EXPECT_THAT(subscriber.sent_packets(), SizeIs(0));
+  ReceivePacket(kHighSsrc, 9000, /*key_frame=*/true);
+  ReceivePacket(kHighSsrc, 12000, /*key_frame=*/false);
+  EXPECT_THAT(subscriber.sent_packets(), SizeIs(2));
+}
+
+TEST_F(RtpForwarderTest, LatePacketOfEarlierFrameIsNoSwitchingPoint) {
+  Subscriber subscriber(time_controller_.GetClock(), kSubscriberSsrc);
+  forwarder_.AddSubscriber(subscriber.rtp_rtcp());
+
+  ReceivePacket(kHighSsrc, 6000, /*key_frame=*/false);
+  // A reordered packet of the previous frame doesn't start a frame, even if
+  // its payload parses as a key frame.
+  ReceivePacket(kHighSsrc, 3000, /*key_frame=*/true);
+  EXPECT_THAT(subscriber.sent_packets(), SizeIs(0));
+  ReceivePacket(kHighSsrc, 6000, /*key_frame=*/true);
+  EXPECT_THAT(subscriber.sent_packets(), SizeIs(0));
+  ReceivePacket(kHighSsrc, 9000, /*key_frame=*/true);
+  EXPECT_THAT(subscriber.sent_packets(), SizeIs(1));
+}
+
+TEST_F(RtpForwarderTest, WaitsForKeyFrameOfSelectedStream) {
+  Subscriber subscriber(time_controller_.GetClock(), kSubscriberSsrc);
+  forwarder_.AddSubscriber(subscriber.rtp_rtcp());
+
+  ReceiveFrame({.ssrc = kLowSsrc, .key_frame = true});
+  EXPECT_THAT(subscriber.sent_packets(), SizeIs(0));
+  // Without the key frame's structure, the descriptor can't be parsed.
+  ReceiveFrame({.ssrc = kHighSsrc, .timestamp = 3000, .frame_number = 1});
+  EXPECT_THAT(subscriber.sent_packets(), SizeIs(0));
+  ReceiveFrame({.ssrc = kHighSsrc,
+                .timestamp = 6000,
+                .frame_number = 2,
+                .key_frame = true});
+  EXPECT_THAT(subscriber.sent_packets(), SizeIs(1));
+}
+
+TEST_F(RtpForwarderTest, DropsTemporalLayersAboveMax) {
+  Subscriber all_layers(time_controller_.GetClock(), kSubscriberSsrc);
+  Subscriber base_layer(time_controller_.GetClock(), kSubscriberSsrc + 1);
+  forwarder_.AddSubscriber(all_layers.rtp_rtcp());
+  forwarder_.AddSubscriber(base_layer.rtp_rtcp());
+  forwarder_.SetMaxLayers(base_layer.rtp_rtcp(), 1, 0);
+
+  ReceiveFrame({.ssrc = kHighSsrc, .key_frame = true});
+  ReceiveFrame({.ssrc = kHighSsrc, .timestamp = 3000, .temporal_id = 1});
+  ReceiveFrame({.ssrc = kHighSsrc, .timestamp = 6000});
+  ReceiveFrame({.ssrc = kHighSsrc, .timestamp = 9000, .temporal_id = 1});
+
+  EXPECT_THAT(all_layers.sent_packets(), SizeIs(4));
+  const std::vector<RtpPacketReceived>& packets = base_layer.sent_packets();
+  ASSERT_THAT(packets, SizeIs(2));
+  EXPECT_EQ(packets[1].SequenceNumber(),
+            static_cast<uint16_t>(packets[0].SequenceNumber() + 1));
+  EXPECT_EQ(packets[1].Timestamp(), packets[0].Timestamp() + 6000);
+}
+
+TEST_F(RtpForwarderTest, RaisesTemporalLayerOnBaseLayerFrame) {
+  Subscriber subscriber(time_controller_.GetClock(), kSubscriberSsrc);
+  forwarder_.AddSubscriber(subscriber.rtp_rtcp());
+  forwarder_.SetMaxLayers(subscriber.rtp_rtcp(), 1, 0);
+
+  ReceiveFrame({.ssrc = kHighSsrc, .key_frame = true});
+  forwarder_.SetMaxLayers(subscriber.rtp_rtcp(), 1, 1);
+  ReceiveFrame({.ssrc = kHighSsrc, .timestamp = 3000, .temporal_id = 1});
+  EXPECT_THAT(subscriber.sent_packets(), SizeIs(1));
+  ReceiveFrame({.ssrc = kHighSsrc, .timestamp = 6000});
+  ReceiveFrame({.ssrc = kHighSsrc, .timestamp = 9000, .temporal_id = 1});
+  EXPECT_THAT(subscriber.sent_packets(), SizeIs(3));
+}
+
+TEST_F(RtpForwarderTest, DropsSpatialLayersAboveMaxAndMovesMarker) {
+  RtpForwarder forwarder({.clock = time_controller_.GetClock(),
+                          .receiver_controller = &receiver_controller_,
+                          .ssrcs = {kHighSsrc + 1}});
+  Subscriber subscriber(time_controller_.GetClock(), kSubscriberSsrc);
+  forwarder.AddSubscriber(subscriber.rtp_rtcp());
+  forwarder.SetMaxLayers(subscriber.rtp_rtcp(), 0, 1);
+
+  ReceiveFrame({.ssrc = kHighSsrc + 1, .key_frame = true, .marker = false});
+  ReceiveFrame({.ssrc = kHighSsrc + 1, .spatial_id = 1, .frame_number = 1});
+
+  const std::vector<RtpPacketReceived>& packets = subscriber.sent_packets();
+  ASSERT_THAT(packets, SizeIs(1));
+  EXPECT_TRUE(packets[0].Marker());
+}
+
+TEST_F(RtpForwarderTest, SwitchesStreamOnKeyFrameWithContinuousNumbering) {
+  Subscriber subscriber(time_controller_.GetClock(), kSubscriberSsrc);
+  forwarder_.AddSubscriber(subscriber.rtp_rtcp());
+
+  ReceiveFrame({.ssrc = kHighSsrc,
+                .timestamp = 90000,
+                .frame_number = 500,
+                .key_frame = true});
+  ReceiveFrame({.ssrc = kLowSsrc, .timestamp = 1000, .key_frame = true});
+  forwarder_.SetMaxLayers(subscriber.rtp_rtcp(), 0, 1);
+  time_controller_.AdvanceTime(TimeDelta::Millis(10));
+  // The previous stream is forwarded until the new one has a key frame.
+  ReceiveFrame({.ssrc = kHighSsrc, .timestamp = 90900, .frame_number = 501});
+  ReceiveFrame({.ssrc = kLowSsrc, .timestamp = 1900, .frame_number = 1});
+  EXPECT_THAT(subscriber.sent_packets(), SizeIs(2));
+
+  time_controller_.AdvanceTime(TimeDelta::Millis(20));
+  ReceiveFrame({.ssrc = kLowSsrc,
+                .timestamp = 3700,
+                .frame_number = 2,
+                .key_frame = true});
+  ReceiveFrame({.ssrc = kHighSsrc, .timestamp = 92700, .frame_number = 502});
+  ReceiveFrame({.ssrc = kLowSsrc, .timestamp = 6700, .frame_number = 3});
+
+  const std::vector<RtpPacketReceived>& packets = subscriber.sent_packets();
+  ASSERT_THAT(packets, SizeIs(4));
+  EXPECT_EQ(packets[2].SequenceNumber(),
+            static_cast<uint16_t>(packets[1].SequenceNumber() + 1));
+  EXPECT_EQ(packets[2].Timestamp(), packets[1].Timestamp() + 20 * 90);
+  EXPECT_EQ(packets[3].Timestamp(), packets[2].Timestamp() + 3000);
+  EXPECT_EQ(FrameNumber(packets[1]), 501);
+  EXPECT_EQ(FrameNumber(packets[2]), 502);
+  EXPECT_EQ(FrameNumber(packets[3]), 503);
+}
+
+TEST_F(RtpForwarderTest, RetransmitsFromSubscriberHistory) {
+  Subscriber subscriber(time_controller_.GetClock(), kSubscriberSsrc);
+  forwarder_.AddSubscriber(subscriber.rtp_rtcp());
+  ReceivePacket(kHighSsrc, 3000, /*key_frame=*/true);
+  ASSERT_THAT(subscriber.sent_packets(), SizeIs(1));
+  const uint16_t sequence_number =
+      subscriber.sent_packets()[0].SequenceNumber();
+
+  EXPECT_GT(subscriber.rtp_rtcp()->RtpSender()->ReSendPacket(sequence_number),
+            0);
+  const std::vector<RtpPacketReceived>& packets = subscriber.sent_packets();
+  ASSERT_THAT(packets, SizeIs(2));
+  EXPECT_EQ(packets[1].SequenceNumber(), sequence_number);
+  EXPECT_THAT(packets[1].payload(), ElementsAreArray(kVp8KeyFrame));
+}
+
+TEST_F(RtpForwarderTest, StopsForwardingToRemovedSubscriber) {
+  Subscriber subscriber(time_controller_.GetClock(), kSubscriberSsrc);
+  forwarder_.AddSubscriber(subscriber.rtp_rtcp());
+  ReceivePacket(kHighSsrc, 3000, /*key_frame=*/true);
+  forwarder_.RemoveSubscriber(subscriber.rtp_rtcp());
+  ReceivePacket(kHighSsrc, 6000, /*key_frame=*/false);
+  EXPECT_THAT(subscriber.sent_packets(), SizeIs(1));
+}
+
+}  // namespace
+}  // namespace webrtc
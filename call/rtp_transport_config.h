@@ -12,6 +12,7 @@
 #define CALL_RTP_TRANSPORT_CONFIG_H_
 
 #include <memory>
+#include <string>
 
 #include "absl/types/optional.h"
 #include "api/environment/environment.h"
@@ -22,6 +23,9 @@
 
 namespace webrtc {
 
+class BandwidthCache;
+class PacerScheduler;
+
 struct RtpTransportConfig {
   Environment env;
 
@@ -38,6 +42,17 @@ struct RtpTransportConfig {
 
   // The burst interval of the pacer, see TaskQueuePacedSender constructor.
   absl::optional<TimeDelta> pacer_burst_interval;
+
+  // Scheduler shared with the pacers of other transports on the same task
+  // queue, see TaskQueuePacedSender constructor. Must outlive the transport.
+  PacerScheduler* pacer_scheduler = nullptr;
+
+  // Bandwidth estimates to start from on known network routes, and to record
+  // the estimates of this transport in. Must outlive the transport.
+  BandwidthCache* bandwidth_cache = nullptr;
+  // ID of the remote party that `bandwidth_cache` keys estimates on. Estimates
+  // are neither used nor recorded when it is empty.
+  std::string bandwidth_cache_destination;
 };
 }  // namespace webrtc
 
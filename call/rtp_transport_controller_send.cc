@@ -9,6 +9,7 @@
  */
 #include "call/rtp_transport_controller_send.h"
 
+#include <algorithm>
 #include <cstdint>
 #include <memory>
 #include <utility>
@@ -24,13 +25,16 @@
 #include "api/units/data_rate.h"
 #include "api/units/time_delta.h"
 #include "api/units/timestamp.h"
+#include "call/bandwidth_cache.h"
 #include "call/rtp_video_sender.h"
 #include "logging/rtc_event_log/events/rtc_event_remote_estimate.h"
 #include "logging/rtc_event_log/events/rtc_event_route_change.h"
 #include "modules/rtp_rtcp/include/rtp_rtcp_defines.h"
+#include "modules/rtp_rtcp/source/rtcp_packet/congestion_control_feedback.h"
 #include "modules/rtp_rtcp/source/rtcp_packet/transport_feedback.h"
 #include "modules/rtp_rtcp/source/rtp_header_extensions.h"
 #include "rtc_base/checks.h"
+#include "rtc_base/experiments/field_trial_parser.h"
 #include "rtc_base/logging.h"
 #include "rtc_base/rate_limiter.h"
 
@@ -80,7 +84,8 @@ RtpTransportControllerSend::RtpTransportControllerSend(
              &packet_router_,
              env_.field_trials(),
              TimeDelta::Millis(5),
-             3),
+             3,
+             config.pacer_scheduler),
       observer_(nullptr),
       controller_factory_override_(config.network_controller_factory),
       controller_factory_fallback_(
@@ -98,6 +103,10 @@ RtpTransportControllerSend::RtpTransportControllerSend(
       reset_bwe_on_adapter_id_change_(
           env_.field_trials().IsEnabled("WebRTC-Bwe-ResetOnAdapterIdChange")),
       relay_bandwidth_cap_("relay_cap", DataRate::PlusInfinity()),
+      bandwidth_cache_(config.bandwidth_cache_destination.empty()
+                           ? nullptr
+                           : config.bandwidth_cache),
+      bandwidth_cache_destination_(config.bandwidth_cache_destination),
       transport_overhead_bytes_per_packet_(0),
       network_available_(false),
       congestion_window_size_(DataSize::PlusInfinity()),
@@ -122,11 +131,34 @@ RtpTransportControllerSend::RtpTransportControllerSend(
              const PacedPacketInfo& pacing_info) {
         return NotifyBweOfPacedSentPacket(packet, pacing_info);
       });
+  if (env_.field_trials().IsEnabled(
+          "WebRTC-RFC8888CongestionControlFeedback")) {
+    transport_feedback_adapter_.EnableCongestionControlFeedback();
+    // Packets are only sent as ECT(1) if the network controller reduces its
+    // rate on the CE marks reported by the feedback. Otherwise L4S
+    // bottlenecks would signal congestion with marks that nothing reacts to.
+    FieldTrialParameter<bool> send_ect1("send_ect1", false);
+    ParseFieldTrial(
+        {&send_ect1},
+        env_.field_trials().Lookup("WebRTC-RFC8888CongestionControlFeedback"));
+    const bool sends_ect1 = send_ect1 && controller_factory_override_ &&
+                            controller_factory_override_->ReactsToEcnCeMarks();
+    packet_router_.ConfigureForRfc8888Feedback(sends_ect1);
+    // L4S bottlenecks mark packets that queue for about a millisecond, so a
+    // video frame sent in one burst would be marked even below the link
+    // capacity.
+    if (sends_ect1 && !config.pacer_burst_interval) {
+      pacer_.SetSendBurstInterval(TimeDelta::Zero());
+    }
+  }
 }
 
 RtpTransportControllerSend::~RtpTransportControllerSend() {
   RTC_DCHECK_RUN_ON(&sequence_checker_);
   RTC_DCHECK(video_rtp_senders_.empty());
+  for (const auto& [transport_name, route] : network_routes_) {
+    CacheEstimate(route);
+  }
   pacer_queue_update_task_.Stop();
   controller_task_.Stop();
 }
@@ -351,7 +383,19 @@ void RtpTransportControllerSend::OnNetworkRouteChanged(
       UpdateBitrateConstraints(*relay_constraint_update);
     }
     transport_overhead_bytes_per_packet_ = network_route.packet_overhead;
-    // No need to reset BWE if this is the first time the network connects.
+    // No need to reset BWE if this is the first time the network connects,
+    // unless it can start from the estimate of an earlier call on the route.
+    NetworkRouteChange msg;
+    msg.at_time = Timestamp::Millis(env_.clock().TimeInMilliseconds());
+    msg.constraints =
+        ConvertConstraints(bitrate_configurator_.GetConfig(), &env_.clock());
+    if (ApplyCachedStartRate(network_route, msg.constraints)) {
+      if (controller_) {
+        PostUpdates(controller_->OnNetworkRouteChange(msg));
+      } else {
+        UpdateInitialConstraints(msg.constraints);
+      }
+    }
     return;
   }
 
@@ -374,6 +418,9 @@ void RtpTransportControllerSend::OnNetworkRouteChanged(
     NetworkRouteChange msg;
     msg.at_time = Timestamp::Millis(env_.clock().TimeInMilliseconds());
     msg.constraints = ConvertConstraints(bitrate_config, &env_.clock());
+    CacheEstimate(old_route);
+    last_target_rate_ = absl::nullopt;
+    ApplyCachedStartRate(network_route, msg.constraints);
     transport_overhead_bytes_per_packet_ = network_route.packet_overhead;
     if (reset_feedback_on_route_change_) {
       transport_feedback_adapter_.SetNetworkRoute(network_route);
@@ -525,6 +572,33 @@ RtpTransportControllerSend::ApplyOrLiftRelayCap(bool is_relayed) {
   return bitrate_configurator_.UpdateWithRelayCap(cap);
 }
 
+bool RtpTransportControllerSend::ApplyCachedStartRate(
+    const rtc::NetworkRoute& route,
+    TargetRateConstraints& constraints) {
+  if (bandwidth_cache_ == nullptr) {
+    return false;
+  }
+  absl::optional<DataRate> estimate =
+      bandwidth_cache_->GetEstimate(bandwidth_cache_destination_, route);
+  if (!estimate) {
+    return false;
+  }
+  constraints.starting_rate =
+      std::max(std::min(*estimate, *constraints.max_data_rate),
+               *constraints.min_data_rate);
+  RTC_LOG(LS_INFO) << "Starting from cached estimate "
+                   << ToString(*constraints.starting_rate) << " on route "
+                   << route.DebugString();
+  return true;
+}
+
+void RtpTransportControllerSend::CacheEstimate(const rtc::NetworkRoute& route) {
+  if (bandwidth_cache_ != nullptr && last_target_rate_) {
+    bandwidth_cache_->SetEstimate(bandwidth_cache_destination_, route,
+                                  *last_target_rate_);
+  }
+}
+
 void RtpTransportControllerSend::OnTransportOverheadChanged(
     size_t transport_overhead_bytes_per_packet) {
   RTC_DCHECK_RUN_ON(&sequence_checker_);
@@ -621,6 +695,22 @@ void RtpTransportControllerSend::OnTransportFeedback(
   }
 }
 
+void RtpTransportControllerSend::OnCongestionControlFeedback(
+    Timestamp receive_time,
+    const rtcp::CongestionControlFeedback& feedback) {
+  RTC_DCHECK_RUN_ON(&sequence_checker_);
+  absl::optional<TransportPacketsFeedback> feedback_msg =
+      transport_feedback_adapter_.ProcessCongestionControlFeedback(
+          feedback, receive_time);
+  if (feedback_msg) {
+    if (controller_)
+      PostUpdates(controller_->OnTransportPacketsFeedback(*feedback_msg));
+
+    // Only update outstanding data if any packet is first time acked.
+    UpdateCongestedState();
+  }
+}
+
 void RtpTransportControllerSend::OnRemoteNetworkEstimate(
     NetworkStateEstimate estimate) {
   RTC_DCHECK_RUN_ON(&sequence_checker_);
@@ -727,6 +817,7 @@ void RtpTransportControllerSend::PostUpdates(NetworkControlUpdate update) {
     pacer_.CreateProbeClusters(std::move(update.probe_cluster_configs));
   }
   if (update.target_rate) {
+    last_target_rate_ = update.target_rate->target_rate;
     control_handler_->SetTargetRate(*update.target_rate);
     UpdateControlState();
   }
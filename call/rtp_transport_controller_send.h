@@ -116,6 +116,9 @@ class RtpTransportControllerSend final
   void OnRttUpdate(Timestamp receive_time, TimeDelta rtt) override;
   void OnTransportFeedback(Timestamp receive_time,
                            const rtcp::TransportFeedback& feedback) override;
+  void OnCongestionControlFeedback(
+      Timestamp receive_time,
+      const rtcp::CongestionControlFeedback& feedback) override;
 
   // Implements NetworkStateEstimateObserver interface
   void OnRemoteNetworkEstimate(NetworkStateEstimate estimate) override;
@@ -135,6 +138,13 @@ class RtpTransportControllerSend final
   void UpdateControllerWithTimeInterval() RTC_RUN_ON(sequence_checker_);
 
   absl::optional<BitrateConstraints> ApplyOrLiftRelayCap(bool is_relayed);
+  // Sets the starting rate of `constraints` to the estimate cached for
+  // `route`, if there is one, and returns whether there was.
+  bool ApplyCachedStartRate(const rtc::NetworkRoute& route,
+                            TargetRateConstraints& constraints)
+      RTC_RUN_ON(sequence_checker_);
+  void CacheEstimate(const rtc::NetworkRoute& route)
+      RTC_RUN_ON(sequence_checker_);
   bool IsRelevantRouteChange(const rtc::NetworkRoute& old_route,
                              const rtc::NetworkRoute& new_route) const;
   void UpdateBitrateConstraints(const BitrateConstraints& updated);
@@ -203,6 +213,14 @@ class RtpTransportControllerSend final
 
   FieldTrialParameter<DataRate> relay_bandwidth_cap_;
 
+  // Null unless the remote party is identified by
+  // `bandwidth_cache_destination_`.
+  BandwidthCache* const bandwidth_cache_;
+  const std::string bandwidth_cache_destination_;
+  // Last target rate of the controller, recorded in `bandwidth_cache_` for the
+  // route it was estimated on.
+  absl::optional<DataRate> last_target_rate_ RTC_GUARDED_BY(sequence_checker_);
+
   size_t transport_overhead_bytes_per_packet_ RTC_GUARDED_BY(sequence_checker_);
   bool network_available_ RTC_GUARDED_BY(sequence_checker_);
   RepeatingTaskHandle pacer_queue_update_task_
@@ -8,18 +8,23 @@
  *  be found in the AUTHORS file in the root of the source tree.
  */
 #include <iostream>
+#include <memory>
 
+#include "absl/types/optional.h"
+#include "p2p/base/sharded_server.h"
 #include "p2p/base/stun_server.h"
 #include "rtc_base/async_udp_socket.h"
 #include "rtc_base/socket_address.h"
 #include "rtc_base/socket_server.h"
+#include "rtc_base/string_to_number.h"
 #include "rtc_base/thread.h"
 
+using cricket::ShardedStunServer;
 using cricket::StunServer;
 
 int main(int argc, char* argv[]) {
-  if (argc != 2) {
-    std::cerr << "usage: stunserver address" << std::endl;
+  if (argc != 2 && argc != 3) {
+    std::cerr << "usage: stunserver address [num-workers]" << std::endl;
     return 1;
   }
 
@@ -29,9 +34,33 @@ int main(int argc, char* argv[]) {
     return 1;
   }
 
+  absl::optional<int> num_workers = 1;
+  if (argc == 3) {
+    num_workers = rtc::StringToNumber<int>(argv[2]);
+    if (!num_workers || *num_workers < 1) {
+      std::cerr << "Invalid number of workers: " << argv[2] << std::endl;
+      return 1;
+    }
+  }
+
   rtc::Thread* pthMain = rtc::ThreadManager::Instance()->WrapCurrentThread();
   RTC_DCHECK(pthMain);
 
+  if (*num_workers > 1) {
+    // Serve from several threads sharing the address with SO_REUSEPORT; the
+    // main thread only waits.
+    std::unique_ptr<ShardedStunServer> server =
+        ShardedStunServer::Create(*num_workers, server_addr);
+    if (!server) {
+      std::cerr << "Failed to create the worker sockets" << std::endl;
+      return 1;
+    }
+    std::cout << "Listening at " << server->address().ToString() << " with "
+              << server->num_workers() << " workers" << std::endl;
+    pthMain->Run();
+    return 0;
+  }
+
   rtc::AsyncUDPSocket* server_socket =
       rtc::AsyncUDPSocket::Create(pthMain->socketserver(), server_addr);
   if (!server_socket) {
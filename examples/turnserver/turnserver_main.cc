@@ -11,18 +11,22 @@
 #include <fstream>
 #include <iostream>
 #include <map>
+#include <memory>
 #include <string>
 #include <utility>
 
 #include "absl/strings/string_view.h"
+#include "absl/types/optional.h"
 #include "examples/turnserver/read_auth_file.h"
 #include "p2p/base/basic_packet_socket_factory.h"
 #include "p2p/base/port_interface.h"
+#include "p2p/base/sharded_server.h"
 #include "p2p/base/turn_server.h"
 #include "rtc_base/async_udp_socket.h"
 #include "rtc_base/ip_address.h"
 #include "rtc_base/physical_socket_server.h"
 #include "rtc_base/socket_address.h"
+#include "rtc_base/string_to_number.h"
 #include "rtc_base/thread.h"
 
 namespace {
@@ -52,8 +56,9 @@ class TurnFileAuth : public cricket::TurnAuthInterface {
 }  // namespace
 
 int main(int argc, char* argv[]) {
-  if (argc != 5) {
-    std::cerr << "usage: turnserver int-addr ext-ip realm auth-file"
+  if (argc != 5 && argc != 6) {
+    std::cerr << "usage: turnserver int-addr ext-ip realm auth-file "
+                 "[num-workers]"
               << std::endl;
     return 1;
   }
@@ -70,8 +75,45 @@ int main(int argc, char* argv[]) {
     return 1;
   }
 
+  absl::optional<int> num_workers = 1;
+  if (argc == 6) {
+    num_workers = rtc::StringToNumber<int>(argv[5]);
+    if (!num_workers || *num_workers < 1) {
+      std::cerr << "Invalid number of workers: " << argv[5] << std::endl;
+      return 1;
+    }
+  }
+
   rtc::PhysicalSocketServer socket_server;
   rtc::AutoSocketServerThread main(&socket_server);
+  std::fstream auth_file(argv[4], std::fstream::in);
+  // TurnFileAuth does not change after construction, so workers can share it.
+  TurnFileAuth auth(auth_file.is_open()
+                        ? webrtc_examples::ReadAuthFile(&auth_file)
+                        : std::map<std::string, std::string>());
+
+  if (*num_workers > 1) {
+    // Every worker runs its own TurnServer on a socket sharing `int_addr`
+    // with SO_REUSEPORT; the main thread only waits.
+    std::unique_ptr<cricket::ShardedTurnServer> server =
+        cricket::ShardedTurnServer::Create(
+            *num_workers, int_addr, ext_addr,
+            [&](cricket::TurnServer& turn_server) {
+              turn_server.set_realm(argv[3]);
+              turn_server.set_software(kSoftware);
+              turn_server.set_auth_hook(&auth);
+            });
+    if (!server) {
+      std::cerr << "Failed to create the worker sockets bound at "
+                << int_addr.ToString() << std::endl;
+      return 1;
+    }
+    std::cout << "Listening internally at " << server->address().ToString()
+              << " with " << server->num_workers() << " workers" << std::endl;
+    main.Run();
+    return 0;
+  }
+
   rtc::AsyncUDPSocket* int_socket =
       rtc::AsyncUDPSocket::Create(&socket_server, int_addr);
   if (!int_socket) {
@@ -81,11 +123,6 @@ int main(int argc, char* argv[]) {
   }
 
   cricket::TurnServer server(&main);
-  std::fstream auth_file(argv[4], std::fstream::in);
-
-  TurnFileAuth auth(auth_file.is_open()
-                        ? webrtc_examples::ReadAuthFile(&auth_file)
-                        : std::map<std::string, std::string>());
   server.set_realm(argv[3]);
   server.set_software(kSoftware);
   server.set_auth_hook(&auth);
@@ -207,6 +207,7 @@ bool MediaChannelUtil::TransportForMediaChannels::SendRtp(
        included_in_allocation = options.included_in_allocation,
        batchable = options.batchable,
        last_packet_in_batch = options.last_packet_in_batch,
+       send_as_ect1 = options.send_as_ect1,
        packet = rtc::CopyOnWriteBuffer(packet, kMaxRtpPacketLen)]() mutable {
         rtc::PacketOptions rtc_options;
         rtc_options.packet_id = packet_id;
@@ -219,6 +220,7 @@ bool MediaChannelUtil::TransportForMediaChannels::SendRtp(
             included_in_allocation;
         rtc_options.batchable = batchable;
         rtc_options.last_packet_in_batch = last_packet_in_batch;
+        rtc_options.ecn_1 = send_as_ect1;
         DoSendPacket(&packet, false, rtc_options);
       };
 
@@ -0,0 +1,37 @@
+/*
+ *  Copyright (c) 2024 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "modules/congestion_controller/l4s/l4s_factory.h"
+
+#include <cstdint>
+#include <memory>
+
+#include "modules/congestion_controller/l4s/l4s_network_controller.h"
+
+namespace webrtc {
+
+L4sNetworkControllerFactory::L4sNetworkControllerFactory() = default;
+
+std::unique_ptr<NetworkControllerInterface> L4sNetworkControllerFactory::Create(
+    NetworkControllerConfig config) {
+  return std::make_unique<L4sNetworkController>(config);
+}
+
+TimeDelta L4sNetworkControllerFactory::GetProcessInterval() const {
+  // Must be finite, the feedback timeout backoff runs in OnProcessInterval.
+  const int64_t kUpdateIntervalMs = 25;
+  return TimeDelta::Millis(kUpdateIntervalMs);
+}
+
+bool L4sNetworkControllerFactory::ReactsToEcnCeMarks() const {
+  return true;
+}
+
+}  // namespace webrtc
@@ -0,0 +1,35 @@
+/*
+ *  Copyright (c) 2024 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef MODULES_CONGESTION_CONTROLLER_L4S_L4S_FACTORY_H_
+#define MODULES_CONGESTION_CONTROLLER_L4S_L4S_FACTORY_H_
+
+#include <memory>
+
+#include "api/transport/network_control.h"
+#include "api/units/time_delta.h"
+
+namespace webrtc {
+
+// Creates L4sNetworkController instances, which react to CE marks. Packets
+// are only sent as ECT(1) if also enabled by the "send_ect1" parameter of the
+// "WebRTC-RFC8888CongestionControlFeedback" field trial.
+class L4sNetworkControllerFactory : public NetworkControllerFactoryInterface {
+ public:
+  L4sNetworkControllerFactory();
+  std::unique_ptr<NetworkControllerInterface> Create(
+      NetworkControllerConfig config) override;
+  TimeDelta GetProcessInterval() const override;
+  bool ReactsToEcnCeMarks() const override;
+};
+
+}  // namespace webrtc
+
+#endif  // MODULES_CONGESTION_CONTROLLER_L4S_L4S_FACTORY_H_
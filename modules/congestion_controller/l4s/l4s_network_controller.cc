@@ -0,0 +1,297 @@
+/*
+ *  Copyright (c) 2024 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "modules/congestion_controller/l4s/l4s_network_controller.h"
+
+#include <algorithm>
+
+#include "rtc_base/checks.h"
+#include "rtc_base/network/ecn_marking.h"
+
+namespace webrtc {
+namespace {
+constexpr DataRate kDefaultStartingRate = DataRate::KilobitsPerSec(300);
+constexpr TimeDelta kDefaultRtt = TimeDelta::Millis(200);
+// Rate changes are paced by at least this round trip time.
+constexpr TimeDelta kMinControlRtt = TimeDelta::Millis(5);
+constexpr double kRttGain = 1.0 / 8;
+constexpr TimeDelta kMinRttWindow = TimeDelta::Seconds(10);
+
+// Gain of the moving average of the fraction of CE marked packets, `g` of
+// DCTCP and Prague.
+constexpr double kCeFractionGain = 1.0 / 16;
+// The rate increases by this much data per round trip, per round trip, like
+// a window that grows by half a packet per round trip. Growing slower than
+// Prague keeps the queue of the frame bursts of video shallow.
+constexpr DataSize kIncreasePerRtt = DataSize::Bytes(600);
+// Rate growth per round trip in startup.
+constexpr double kStartupGrowthPerRtt = 0.5;
+constexpr double kMaxRateOverAckedRate = 1.5;
+constexpr double kLossReductionFactor = 0.7;
+// Bottlenecks that do not mark packets are noticed by the queueing delay.
+constexpr TimeDelta kMaxQueueDelay = TimeDelta::Millis(50);
+constexpr double kQueueDelayReductionFactor = 0.9;
+// Lets the pacer catch up after large video frames. Pacing much faster than
+// the target rate would send bursts above the link capacity, which L4S
+// bottlenecks mark once they queue for about a millisecond.
+constexpr double kPacingFactor = 1.2;
+// Without feedback while sending, the rate backs off until feedback returns,
+// like the RTT based backoff of GoogCC, see WebRTC-Bwe-MaxRttLimit.
+constexpr TimeDelta kFeedbackTimeout = TimeDelta::Seconds(3);
+constexpr TimeDelta kFeedbackTimeoutReductionInterval = TimeDelta::Seconds(1);
+constexpr double kFeedbackTimeoutReductionFactor = 0.8;
+constexpr DataRate kFeedbackTimeoutRateFloor = DataRate::KilobitsPerSec(5);
+}  // namespace
+
+L4sNetworkController::L4sNetworkController(NetworkControllerConfig config)
+    : starting_rate_(kDefaultStartingRate) {
+  ApplyConstraints(config.constraints);
+  ResetEstimate();
+}
+
+L4sNetworkController::~L4sNetworkController() = default;
+
+NetworkControlUpdate L4sNetworkController::OnNetworkAvailability(
+    NetworkAvailability msg) {
+  return NetworkControlUpdate();
+}
+
+NetworkControlUpdate L4sNetworkController::OnNetworkRouteChange(
+    NetworkRouteChange msg) {
+  ApplyConstraints(msg.constraints);
+  ResetEstimate();
+  return CreateRateUpdate(msg.at_time);
+}
+
+NetworkControlUpdate L4sNetworkController::OnProcessInterval(
+    ProcessInterval msg) {
+  if (IsFeedbackTimedOut() &&
+      msg.at_time - last_reduction_time_ >= kFeedbackTimeoutReductionInterval &&
+      target_rate_ > kFeedbackTimeoutRateFloor) {
+    ReduceRate(msg.at_time, kFeedbackTimeoutReductionFactor);
+    target_rate_ = std::clamp(std::max(target_rate_, kFeedbackTimeoutRateFloor),
+                              min_rate_, max_rate_);
+  }
+  return CreateRateUpdate(msg.at_time);
+}
+
+NetworkControlUpdate L4sNetworkController::OnTargetRateConstraints(
+    TargetRateConstraints msg) {
+  ApplyConstraints(msg);
+  if (last_feedback_time_.IsInfinite()) {
+    target_rate_ = starting_rate_;
+  }
+  target_rate_ = std::clamp(target_rate_, min_rate_, max_rate_);
+  return CreateRateUpdate(msg.at_time);
+}
+
+NetworkControlUpdate L4sNetworkController::OnTransportPacketsFeedback(
+    TransportPacketsFeedback msg) {
+  const Timestamp now = msg.feedback_time;
+  int packets = 0;
+  int marked_packets = 0;
+  int lost_packets = 0;
+  DataSize acked_size = DataSize::Zero();
+  // The packets that are reported soonest after arriving give the shortest
+  // round trip time.
+  TimeDelta rtt = TimeDelta::PlusInfinity();
+  for (const PacketResult& packet : msg.packet_feedbacks) {
+    if (!packet.IsReceived()) {
+      ++lost_packets;
+      continue;
+    }
+    ++packets;
+    if (packet.ecn == rtc::EcnMarking::kCe) {
+      ++marked_packets;
+    }
+    acked_size += packet.sent_packet.size;
+    rtt = std::min(rtt, now - packet.sent_packet.send_time);
+  }
+  if (rtt.IsFinite()) {
+    UpdateRtt(now, rtt);
+  }
+  if (smoothed_rtt_.IsInfinite()) {
+    return NetworkControlUpdate();
+  }
+  const TimeDelta control_rtt = ControlRtt();
+
+  if (round_start_.IsInfinite()) {
+    round_start_ = now;
+  }
+  round_packets_ += packets;
+  round_marked_packets_ += marked_packets;
+  round_acked_size_ += acked_size;
+  if (now - round_start_ >= control_rtt) {
+    // Kept at its initial value in startup, see ResetEstimate().
+    if (round_packets_ > 0 && !in_startup_) {
+      double marked_fraction =
+          static_cast<double>(round_marked_packets_) / round_packets_;
+      ce_fraction_ += kCeFractionGain * (marked_fraction - ce_fraction_);
+    }
+    acked_rate_ = round_acked_size_ / (now - round_start_);
+    round_start_ = now;
+    round_packets_ = 0;
+    round_marked_packets_ = 0;
+    round_acked_size_ = DataSize::Zero();
+  }
+
+  // Reductions wait a round trip for the previous one to take effect.
+  const bool can_reduce = now - last_reduction_time_ >= control_rtt;
+  if (marked_packets > 0) {
+    if (can_reduce) {
+      ReduceRate(now, 1 - ce_fraction_ / 2);
+    }
+  } else if (lost_packets > 0) {
+    if (can_reduce) {
+      ReduceRate(now, kLossReductionFactor);
+    }
+  } else if (smoothed_rtt_ - min_rtt_ > kMaxQueueDelay) {
+    if (can_reduce) {
+      ReduceRate(now, kQueueDelayReductionFactor);
+    }
+  } else if (last_feedback_time_.IsFinite() &&
+             (acked_rate_.IsInfinite() ||
+              target_rate_ < kMaxRateOverAckedRate * acked_rate_)) {
+    const double rtts_since_last_feedback =
+        std::min(now - last_feedback_time_, control_rtt) / control_rtt;
+    const DataRate increase_per_rtt = in_startup_
+                                          ? kStartupGrowthPerRtt * target_rate_
+                                          : kIncreasePerRtt / control_rtt;
+    target_rate_ += rtts_since_last_feedback * increase_per_rtt;
+  }
+  target_rate_ = std::clamp(target_rate_, min_rate_, max_rate_);
+  last_feedback_time_ = now;
+  return CreateRateUpdate(now);
+}
+
+NetworkControlUpdate L4sNetworkController::OnSentPacket(SentPacket msg) {
+  last_sent_packet_time_ = std::max(last_sent_packet_time_, msg.send_time);
+  return NetworkControlUpdate();
+}
+
+NetworkControlUpdate L4sNetworkController::OnStreamsConfig(StreamsConfig msg) {
+  return NetworkControlUpdate();
+}
+
+NetworkControlUpdate L4sNetworkController::OnRemoteBitrateReport(
+    RemoteBitrateReport msg) {
+  return NetworkControlUpdate();
+}
+
+NetworkControlUpdate L4sNetworkController::OnRoundTripTimeUpdate(
+    RoundTripTimeUpdate msg) {
+  return NetworkControlUpdate();
+}
+
+NetworkControlUpdate L4sNetworkController::OnTransportLossReport(
+    TransportLossReport msg) {
+  return NetworkControlUpdate();
+}
+
+NetworkControlUpdate L4sNetworkController::OnReceivedPacket(
+    ReceivedPacket msg) {
+  return NetworkControlUpdate();
+}
+
+NetworkControlUpdate L4sNetworkController::OnNetworkStateEstimate(
+    NetworkStateEstimate msg) {
+  return NetworkControlUpdate();
+}
+
+void L4sNetworkController::ApplyConstraints(
+    const TargetRateConstraints& constraints) {
+  if (constraints.min_data_rate) {
+    min_rate_ = *constraints.min_data_rate;
+  }
+  if (constraints.max_data_rate) {
+    max_rate_ = *constraints.max_data_rate;
+  }
+  if (constraints.starting_rate) {
+    starting_rate_ = *constraints.starting_rate;
+  }
+  RTC_DCHECK_LE(min_rate_, max_rate_);
+}
+
+void L4sNetworkController::ResetEstimate() {
+  target_rate_ = std::clamp(starting_rate_, min_rate_, max_rate_);
+  in_startup_ = true;
+  // The first mark halves the rate, as the rate may have overshot a lot in
+  // startup.
+  ce_fraction_ = 1.0;
+  smoothed_rtt_ = TimeDelta::PlusInfinity();
+  min_rtt_ = TimeDelta::PlusInfinity();
+  min_rtt_time_ = Timestamp::MinusInfinity();
+  last_feedback_time_ = Timestamp::MinusInfinity();
+  last_sent_packet_time_ = Timestamp::MinusInfinity();
+  last_reduction_time_ = Timestamp::MinusInfinity();
+  round_start_ = Timestamp::MinusInfinity();
+  round_packets_ = 0;
+  round_marked_packets_ = 0;
+  round_acked_size_ = DataSize::Zero();
+  acked_rate_ = DataRate::PlusInfinity();
+}
+
+void L4sNetworkController::UpdateRtt(Timestamp at_time, TimeDelta rtt) {
+  if (rtt <= min_rtt_ || at_time - min_rtt_time_ > kMinRttWindow) {
+    min_rtt_ = rtt;
+    min_rtt_time_ = at_time;
+  }
+  if (smoothed_rtt_.IsInfinite()) {
+    smoothed_rtt_ = rtt;
+  } else {
+    smoothed_rtt_ += kRttGain * (rtt - smoothed_rtt_);
+  }
+}
+
+TimeDelta L4sNetworkController::ControlRtt() const {
+  return std::max(smoothed_rtt_, kMinControlRtt);
+}
+
+bool L4sNetworkController::IsFeedbackTimedOut() const {
+  // There is no round trip time to time out on before the first feedback.
+  if (last_feedback_time_.IsInfinite()) {
+    return false;
+  }
+  // Feedback is not expected when no packets are being sent.
+  TimeDelta time_without_feedback = std::max(
+      last_sent_packet_time_ - last_feedback_time_, TimeDelta::Zero());
+  return time_without_feedback + ControlRtt() > kFeedbackTimeout;
+}
+
+void L4sNetworkController::ReduceRate(Timestamp at_time, double factor) {
+  target_rate_ = target_rate_ * factor;
+  last_reduction_time_ = at_time;
+  in_startup_ = false;
+}
+
+NetworkControlUpdate L4sNetworkController::CreateRateUpdate(
+    Timestamp at_time) const {
+  const TimeDelta rtt =
+      smoothed_rtt_.IsFinite() ? smoothed_rtt_ : kDefaultRtt;
+  NetworkControlUpdate update;
+  TargetTransferRate target_rate_msg;
+  target_rate_msg.at_time = at_time;
+  target_rate_msg.network_estimate.at_time = at_time;
+  target_rate_msg.network_estimate.round_trip_time = rtt;
+  target_rate_msg.network_estimate.bwe_period = rtt;
+  target_rate_msg.target_rate = target_rate_;
+  target_rate_msg.stable_target_rate = target_rate_;
+  update.target_rate = target_rate_msg;
+
+  PacerConfig pacer_config;
+  pacer_config.at_time = at_time;
+  pacer_config.time_window = TimeDelta::Seconds(1);
+  pacer_config.data_window =
+      kPacingFactor * target_rate_ * pacer_config.time_window;
+  update.pacer_config = pacer_config;
+  return update;
+}
+
+}  // namespace webrtc
@@ -0,0 +1,101 @@
+/*
+ *  Copyright (c) 2024 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef MODULES_CONGESTION_CONTROLLER_L4S_L4S_NETWORK_CONTROLLER_H_
+#define MODULES_CONGESTION_CONTROLLER_L4S_L4S_NETWORK_CONTROLLER_H_
+
+#include "api/transport/network_control.h"
+#include "api/transport/network_types.h"
+#include "api/units/data_rate.h"
+#include "api/units/data_size.h"
+#include "api/units/time_delta.h"
+#include "api/units/timestamp.h"
+
+namespace webrtc {
+
+// Congestion controller for L4S (RFC 9330) bottlenecks, in the style of TCP
+// Prague and SCReAM. It reacts to the ECN-CE marks reported by RFC 8888
+// congestion control feedback on packets sent as ECT(1).
+//
+// The target rate increases by about half a packet per round trip, and is
+// reduced at most once per round trip, in proportion to the smoothed fraction
+// of CE marked packets. As L4S bottlenecks mark packets at a shallow queue,
+// this keeps the queueing delay low at full link utilization. Packet loss and
+// large queueing delay reduce the rate as well, for bottlenecks that do not
+// mark packets. If feedback stops arriving while packets are sent, the rate
+// backs off once a second until it does.
+class L4sNetworkController : public NetworkControllerInterface {
+ public:
+  explicit L4sNetworkController(NetworkControllerConfig config);
+  ~L4sNetworkController() override;
+
+  // NetworkControllerInterface
+  NetworkControlUpdate OnNetworkAvailability(NetworkAvailability msg) override;
+  NetworkControlUpdate OnNetworkRouteChange(NetworkRouteChange msg) override;
+  NetworkControlUpdate OnProcessInterval(ProcessInterval msg) override;
+  NetworkControlUpdate OnTargetRateConstraints(
+      TargetRateConstraints msg) override;
+  NetworkControlUpdate OnTransportPacketsFeedback(
+      TransportPacketsFeedback msg) override;
+  NetworkControlUpdate OnSentPacket(SentPacket msg) override;
+
+  // Not used by the L4S controller.
+  NetworkControlUpdate OnStreamsConfig(StreamsConfig msg) override;
+  NetworkControlUpdate OnRemoteBitrateReport(RemoteBitrateReport msg) override;
+  NetworkControlUpdate OnRoundTripTimeUpdate(RoundTripTimeUpdate msg) override;
+  NetworkControlUpdate OnTransportLossReport(TransportLossReport msg) override;
+  NetworkControlUpdate OnReceivedPacket(ReceivedPacket msg) override;
+  NetworkControlUpdate OnNetworkStateEstimate(
+      NetworkStateEstimate msg) override;
+
+ private:
+  void ApplyConstraints(const TargetRateConstraints& constraints);
+  void ResetEstimate();
+  void UpdateRtt(Timestamp at_time, TimeDelta rtt);
+  // The round trip time that rate changes are paced by.
+  TimeDelta ControlRtt() const;
+  // Whether feedback is overdue for the packets sent since the last one.
+  bool IsFeedbackTimedOut() const;
+  void ReduceRate(Timestamp at_time, double factor);
+  NetworkControlUpdate CreateRateUpdate(Timestamp at_time) const;
+
+  DataRate min_rate_ = DataRate::Zero();
+  DataRate max_rate_ = DataRate::PlusInfinity();
+  DataRate starting_rate_ = DataRate::Zero();
+  DataRate target_rate_ = DataRate::Zero();
+
+  // In startup the rate grows multiplicatively, until the first sign of
+  // congestion.
+  bool in_startup_ = true;
+  // Smoothed fraction of packets marked CE per round trip, `alpha` of
+  // DCTCP and Prague.
+  double ce_fraction_ = 1.0;
+
+  TimeDelta smoothed_rtt_ = TimeDelta::PlusInfinity();
+  TimeDelta min_rtt_ = TimeDelta::PlusInfinity();
+  Timestamp min_rtt_time_ = Timestamp::MinusInfinity();
+
+  Timestamp last_feedback_time_ = Timestamp::MinusInfinity();
+  Timestamp last_sent_packet_time_ = Timestamp::MinusInfinity();
+  Timestamp last_reduction_time_ = Timestamp::MinusInfinity();
+
+  // Packets acknowledged in the round trip that started at `round_start_`.
+  Timestamp round_start_ = Timestamp::MinusInfinity();
+  int round_packets_ = 0;
+  int round_marked_packets_ = 0;
+  DataSize round_acked_size_ = DataSize::Zero();
+  // Rate acknowledged in the last round trip. The target rate is not
+  // increased far above it, as it would not be tested by the sent packets.
+  DataRate acked_rate_ = DataRate::PlusInfinity();
+};
+
+}  // namespace webrtc
+
+#endif  // MODULES_CONGESTION_CONTROLLER_L4S_L4S_NETWORK_CONTROLLER_H_
@@ -0,0 +1,400 @@
+/*
+ *  Copyright (c) 2024 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "modules/congestion_controller/l4s/l4s_network_controller.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <memory>
+#include <vector>
+
+#include "api/environment/environment.h"
+#include "api/environment/environment_factory.h"
+#include "api/test/simulated_network.h"
+#include "api/transport/network_types.h"
+#include "api/units/data_rate.h"
+#include "api/units/data_size.h"
+#include "api/units/time_delta.h"
+#include "api/units/timestamp.h"
+#include "modules/congestion_controller/l4s/l4s_factory.h"
+#include "rtc_base/network/ecn_marking.h"
+#include "test/field_trial.h"
+#include "test/gmock.h"
+#include "test/gtest.h"
+#include "test/network/simulated_network.h"
+#include "test/scenario/scenario.h"
+
+namespace webrtc {
+namespace {
+
+using ::testing::Ge;
+using ::testing::Property;
+
+constexpr DataRate kStartRate = DataRate::KilobitsPerSec(300);
+constexpr TimeDelta kRtt = TimeDelta::Millis(40);
+constexpr TimeDelta kFeedbackInterval = TimeDelta::Millis(25);
+constexpr DataSize kPacketSize = DataSize::Bytes(1200);
+
+class L4sNetworkControllerTest : public ::testing::Test {
+ protected:
+  L4sNetworkControllerTest() : env_(CreateEnvironment()) {
+    NetworkControllerConfig config(env_);
+    config.constraints.at_time = now_;
+    config.constraints.min_data_rate = DataRate::KilobitsPerSec(30);
+    config.constraints.max_data_rate = DataRate::KilobitsPerSec(10000);
+    config.constraints.starting_rate = kStartRate;
+    controller_ = std::make_unique<L4sNetworkController>(config);
+  }
+
+  // Reports `packets` packets sent a round trip ago, of which the first
+  // `marked_packets` are marked CE and the last `lost_packets` are lost.
+  DataRate SendFeedback(int packets,
+                        int marked_packets = 0,
+                        int lost_packets = 0) {
+    now_ += kFeedbackInterval;
+    TransportPacketsFeedback feedback;
+    feedback.feedback_time = now_;
+    for (int i = 0; i < packets; ++i) {
+      PacketResult result;
+      result.sent_packet.send_time = now_ - kRtt;
+      result.sent_packet.size = kPacketSize;
+      result.sent_packet.sequence_number = sequence_number_++;
+      if (i < packets - lost_packets) {
+        result.receive_time = now_ - kRtt / 2;
+        result.ecn = i < marked_packets ? rtc::EcnMarking::kCe
+                                        : rtc::EcnMarking::kEct1;
+      }
+      feedback.packet_feedbacks.push_back(result);
+    }
+    NetworkControlUpdate update =
+        controller_->OnTransportPacketsFeedback(feedback);
+    EXPECT_TRUE(update.target_rate.has_value());
+    return update.target_rate->target_rate;
+  }
+
+  // Runs the process interval for `duration` without feedback, sending a
+  // packet every interval if `send_packets` is set. Returns the target rate.
+  DataRate RunWithoutFeedback(TimeDelta duration, bool send_packets) {
+    const Timestamp end = now_ + duration;
+    DataRate rate = DataRate::Zero();
+    while (now_ < end) {
+      now_ += kFeedbackInterval;
+      if (send_packets) {
+        SentPacket sent;
+        sent.send_time = now_;
+        sent.size = kPacketSize;
+        sent.sequence_number = sequence_number_++;
+        controller_->OnSentPacket(sent);
+      }
+      NetworkControlUpdate update =
+          controller_->OnProcessInterval({.at_time = now_});
+      EXPECT_TRUE(update.target_rate.has_value());
+      rate = update.target_rate->target_rate;
+    }
+    return rate;
+  }
+
+  // Feedback on as many packets as the target rate sends in an interval.
+  DataRate SendFeedbackAtRate(DataRate rate) {
+    return SendFeedback(
+        std::max<int64_t>(rate * kFeedbackInterval / kPacketSize, 1));
+  }
+
+  const Environment env_;
+  Timestamp now_ = Timestamp::Seconds(1000);
+  int64_t sequence_number_ = 0;
+  std::unique_ptr<L4sNetworkController> controller_;
+};
+
+TEST_F(L4sNetworkControllerTest, SendsConfigurationOnFirstProcess) {
+  NetworkControlUpdate update =
+      controller_->OnProcessInterval({.at_time = now_});
+  ASSERT_TRUE(update.target_rate.has_value());
+  EXPECT_EQ(update.target_rate->target_rate, kStartRate);
+  ASSERT_TRUE(update.pacer_config.has_value());
+  EXPECT_THAT(*update.pacer_config,
+              Property(&PacerConfig::data_rate, Ge(kStartRate)));
+}
+
+TEST_F(L4sNetworkControllerTest, IncreasesRateWithoutMarks) {
+  DataRate rate = kStartRate;
+  for (int i = 0; i < 40; ++i) {
+    rate = SendFeedbackAtRate(rate);
+  }
+  EXPECT_GT(rate, 2 * kStartRate);
+}
+
+TEST_F(L4sNetworkControllerTest, HalvesRateOnFirstMark) {
+  DataRate rate = kStartRate;
+  for (int i = 0; i < 40; ++i) {
+    rate = SendFeedbackAtRate(rate);
+  }
+  DataRate reduced_rate = SendFeedback(10, /*marked_packets=*/1);
+  EXPECT_NEAR(reduced_rate.kbps(), rate.kbps() / 2, 1);
+}
+
+TEST_F(L4sNetworkControllerTest, ReducesRateInProportionToMarkedPackets) {
+  DataRate rate = kStartRate;
+  for (int i = 0; i < 40; ++i) {
+    rate = SendFeedbackAtRate(rate);
+  }
+  SendFeedback(10, /*marked_packets=*/1);
+  // Without further marks, the smoothed fraction of marked packets decays
+  // and later marks reduce the rate only a little.
+  for (int i = 0; i < 200; ++i) {
+    rate = SendFeedbackAtRate(rate);
+  }
+  DataRate reduced_rate = SendFeedback(10, /*marked_packets=*/1);
+  EXPECT_LT(reduced_rate, rate);
+  EXPECT_GT(reduced_rate, 0.95 * rate);
+}
+
+TEST_F(L4sNetworkControllerTest, ReducesRateOnceWithinRoundTrip) {
+  DataRate rate = kStartRate;
+  for (int i = 0; i < 40; ++i) {
+    rate = SendFeedbackAtRate(rate);
+  }
+  DataRate reduced_rate = SendFeedback(10, /*marked_packets=*/10);
+  EXPECT_LT(reduced_rate, rate);
+  // The next feedback arrives before the reduction takes effect.
+  EXPECT_EQ(SendFeedback(10, /*marked_packets=*/10), reduced_rate);
+}
+
+TEST_F(L4sNetworkControllerTest, ReducesRateOnLoss) {
+  DataRate rate = kStartRate;
+  for (int i = 0; i < 40; ++i) {
+    rate = SendFeedbackAtRate(rate);
+  }
+  DataRate reduced_rate = SendFeedback(10, /*marked_packets=*/0,
+                                       /*lost_packets=*/1);
+  EXPECT_NEAR(reduced_rate.kbps(), rate.kbps() * 0.7, 1);
+}
+
+TEST_F(L4sNetworkControllerTest, BacksOffWhileFeedbackTimesOut) {
+  DataRate rate = kStartRate;
+  for (int i = 0; i < 40; ++i) {
+    rate = SendFeedbackAtRate(rate);
+  }
+  // Feedback is not overdue until three seconds, including the round trip.
+  EXPECT_EQ(RunWithoutFeedback(TimeDelta::Millis(2900),
+                               /*send_packets=*/true),
+            rate);
+  DataRate reduced_rate =
+      RunWithoutFeedback(TimeDelta::Millis(100), /*send_packets=*/true);
+  EXPECT_NEAR(reduced_rate.kbps(), rate.kbps() * 0.8, 1);
+  // Further reductions follow once a second.
+  EXPECT_EQ(RunWithoutFeedback(TimeDelta::Millis(900), /*send_packets=*/true),
+            reduced_rate);
+  EXPECT_NEAR(
+      RunWithoutFeedback(TimeDelta::Millis(100), /*send_packets=*/true).kbps(),
+      reduced_rate.kbps() * 0.8, 1);
+  // Down to the configured minimum rate.
+  EXPECT_EQ(RunWithoutFeedback(TimeDelta::Seconds(30), /*send_packets=*/true),
+            DataRate::KilobitsPerSec(30));
+
+  // Once feedback is back, the rate increases again.
+  DataRate recovered_rate = DataRate::KilobitsPerSec(30);
+  for (int i = 0; i < 40; ++i) {
+    recovered_rate = SendFeedbackAtRate(recovered_rate);
+  }
+  EXPECT_GT(recovered_rate, DataRate::KilobitsPerSec(30));
+}
+
+TEST_F(L4sNetworkControllerTest, DoesNotBackOffWithoutSentPackets) {
+  DataRate rate = kStartRate;
+  for (int i = 0; i < 40; ++i) {
+    rate = SendFeedbackAtRate(rate);
+  }
+  EXPECT_EQ(RunWithoutFeedback(TimeDelta::Seconds(10),
+                               /*send_packets=*/false),
+            rate);
+}
+
+// Sends 30 fps video over a link that marks packets queueing for more than a
+// millisecond, with a pacer that does not send frames in bursts.
+TEST_F(L4sNetworkControllerTest, UsesLinkWithMillisecondMarkingThreshold) {
+  constexpr DataRate kLinkCapacity = DataRate::KilobitsPerSec(2000);
+  constexpr TimeDelta kOneWayDelay = TimeDelta::Millis(25);
+  constexpr TimeDelta kFrameInterval = TimeDelta::Millis(33);
+  constexpr TimeDelta kWarmup = TimeDelta::Seconds(10);
+  constexpr TimeDelta kDuration = TimeDelta::Seconds(30);
+  SimulatedNetwork::Config network_config;
+  network_config.link_capacity = kLinkCapacity;
+  network_config.queue_delay_ms = kOneWayDelay.ms();
+  network_config.ecn_marking_queue_delay = TimeDelta::Millis(1);
+  SimulatedNetwork network(network_config);
+
+  DataRate target_rate = kStartRate;
+  DataRate pacing_rate = kStartRate;
+  auto apply = [&](const NetworkControlUpdate& update) {
+    if (update.target_rate) {
+      target_rate = update.target_rate->target_rate;
+    }
+    if (update.pacer_config) {
+      pacing_rate = update.pacer_config->data_rate();
+    }
+  };
+  const Timestamp start = now_;
+  apply(controller_->OnProcessInterval({.at_time = now_}));
+
+  std::map<int64_t, SentPacket> sent_packets;
+  DataSize queued_media = DataSize::Zero();
+  DataSize media_debt = DataSize::Zero();
+  Timestamp next_frame_time = now_;
+  TransportPacketsFeedback pending_feedback;
+  std::deque<TransportPacketsFeedback> feedback_in_flight;
+  DataSize received = DataSize::Zero();
+  TimeDelta total_queue_delay = TimeDelta::Zero();
+  int received_packets = 0;
+  for (; now_ < start + kDuration; now_ += TimeDelta::Millis(1)) {
+    // The encoder skips frames while the pacer queue holds two frames.
+    if (now_ >= next_frame_time) {
+      next_frame_time += kFrameInterval;
+      if (queued_media < 2 * target_rate * kFrameInterval) {
+        queued_media += target_rate * kFrameInterval;
+      }
+    }
+
+    media_debt -= std::min(media_debt, pacing_rate * TimeDelta::Millis(1));
+    while (queued_media >= kPacketSize && media_debt.IsZero()) {
+      SentPacket& sent = sent_packets[sequence_number_];
+      sent.send_time = now_;
+      sent.size = kPacketSize;
+      sent.sequence_number = sequence_number_;
+      network.EnqueuePacket(PacketInFlightInfo(kPacketSize.bytes(), now_.us(),
+                                               sequence_number_++,
+                                               rtc::EcnMarking::kEct1));
+      queued_media -= kPacketSize;
+      media_debt += kPacketSize;
+    }
+
+    for (const PacketDeliveryInfo& delivery :
+         network.DequeueDeliverablePackets(now_.us())) {
+      PacketResult result;
+      result.sent_packet = sent_packets[delivery.packet_id];
+      result.receive_time = Timestamp::Micros(delivery.receive_time_us);
+      result.ecn = delivery.ecn;
+      pending_feedback.packet_feedbacks.push_back(result);
+      if (now_ >= start + kWarmup) {
+        received += kPacketSize;
+        total_queue_delay += result.receive_time -
+                             result.sent_packet.send_time - kOneWayDelay -
+                             kPacketSize / kLinkCapacity;
+        ++received_packets;
+      }
+    }
+
+    if ((now_ - start).ms() % kFeedbackInterval.ms() == 0 &&
+        !pending_feedback.packet_feedbacks.empty()) {
+      pending_feedback.feedback_time = now_ + kOneWayDelay;
+      feedback_in_flight.push_back(pending_feedback);
+      pending_feedback = {};
+    }
+    while (!feedback_in_flight.empty() &&
+           feedback_in_flight.front().feedback_time <= now_) {
+      apply(
+          controller_->OnTransportPacketsFeedback(feedback_in_flight.front()));
+      feedback_in_flight.pop_front();
+    }
+  }
+
+  ASSERT_GT(received_packets, 0);
+  EXPECT_GT(received / (kDuration - kWarmup), 0.85 * kLinkCapacity);
+  EXPECT_LT(total_queue_delay / received_packets, TimeDelta::Millis(2));
+}
+
+TEST(L4sNetworkControllerFactoryTest, HasFiniteProcessInterval) {
+  // RtpTransportControllerSend only calls OnProcessInterval for a finite
+  // interval, which the feedback timeout backoff depends on.
+  L4sNetworkControllerFactory factory;
+  EXPECT_TRUE(factory.GetProcessInterval().IsFinite());
+}
+
+TEST(L4sScenarioTest, KeepsQueueingDelayLowAtFullLinkUtilization) {
+  test::ScopedFieldTrials trial(
+      "WebRTC-RFC8888CongestionControlFeedback/"
+      "Enabled,force_send:true,send_ect1:true/");
+  constexpr DataRate kLinkCapacity = DataRate::KilobitsPerSec(2000);
+  constexpr TimeDelta kOneWayDelay = TimeDelta::Millis(25);
+  L4sNetworkControllerFactory factory;
+  test::Scenario s("l4s_unit/low_queueing_delay", false);
+  test::CallClientConfig config;
+  config.transport.cc_factory = &factory;
+  config.transport.rates.start_rate = DataRate::KilobitsPerSec(300);
+  config.transport.rates.max_rate = 2 * kLinkCapacity;
+  auto* send_net =
+      s.CreateSimulationNode([&](test::NetworkSimulationConfig* c) {
+        c->bandwidth = kLinkCapacity;
+        c->delay = kOneWayDelay;
+        // Marks packets like the L queue of a DualQ coupled AQM.
+        c->ecn_marking_queue_delay = TimeDelta::Millis(1);
+      });
+  auto* ret_net = s.CreateSimulationNode(
+      [&](test::NetworkSimulationConfig* c) { c->delay = kOneWayDelay; });
+  test::CallClient* client = s.CreateClient("send", config);
+  auto* route =
+      s.CreateRoutes(client, {send_net},
+                     s.CreateClient("return", test::CallClientConfig()),
+                     {ret_net});
+  test::VideoStreamConfig video;
+  video.stream.use_rtx = false;
+  s.CreateVideoStream(route->forward(), video);
+  s.RunFor(TimeDelta::Seconds(20));
+
+  EXPECT_GT(client->target_rate(), 0.8 * kLinkCapacity);
+  EXPECT_LT(client->target_rate(), 1.1 * kLinkCapacity);
+  EXPECT_LT(client->GetStats().rtt_ms,
+            (2 * kOneWayDelay + TimeDelta::Millis(20)).ms());
+}
+
+TEST(L4sScenarioTest, BacksOffWhenFeedbackStops) {
+  test::ScopedFieldTrials trial(
+      "WebRTC-RFC8888CongestionControlFeedback/"
+      "Enabled,force_send:true,send_ect1:true/");
+  constexpr DataRate kLinkCapacity = DataRate::KilobitsPerSec(2000);
+  constexpr TimeDelta kOneWayDelay = TimeDelta::Millis(25);
+  L4sNetworkControllerFactory factory;
+  test::Scenario s("l4s_unit/feedback_timeout", false);
+  test::CallClientConfig config;
+  config.transport.cc_factory = &factory;
+  config.transport.rates.start_rate = DataRate::KilobitsPerSec(300);
+  config.transport.rates.max_rate = 2 * kLinkCapacity;
+  auto* send_net =
+      s.CreateSimulationNode([&](test::NetworkSimulationConfig* c) {
+        c->bandwidth = kLinkCapacity;
+        c->delay = kOneWayDelay;
+        c->ecn_marking_queue_delay = TimeDelta::Millis(1);
+      });
+  auto* ret_net = s.CreateMutableSimulationNode(
+      [&](test::NetworkSimulationConfig* c) { c->delay = kOneWayDelay; });
+  test::CallClient* client = s.CreateClient("send", config);
+  auto* route =
+      s.CreateRoutes(client, {send_net},
+                     s.CreateClient("return", test::CallClientConfig()),
+                     {ret_net->node()});
+  test::VideoStreamConfig video;
+  video.stream.use_rtx = false;
+  s.CreateVideoStream(route->forward(), video);
+  s.RunFor(TimeDelta::Seconds(20));
+  const DataRate rate_before_pause = client->target_rate();
+  EXPECT_GT(rate_before_pause, 0.8 * kLinkCapacity);
+
+  // No feedback arrives for ten seconds.
+  ret_net->PauseTransmissionUntil(s.Now() + TimeDelta::Seconds(10));
+  s.RunFor(TimeDelta::Seconds(2));
+  EXPECT_GT(client->target_rate(), 0.8 * kLinkCapacity);
+  s.RunFor(TimeDelta::Seconds(8));
+  EXPECT_LT(client->target_rate(), 0.4 * rate_before_pause);
+}
+
+}  // namespace
+}  // namespace webrtc
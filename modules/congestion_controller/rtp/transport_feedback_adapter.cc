@@ -18,7 +18,9 @@
 
 #include "absl/algorithm/container.h"
 #include "api/units/timestamp.h"
+#include "modules/include/module_common_types_public.h"
 #include "modules/rtp_rtcp/include/rtp_rtcp_defines.h"
+#include "modules/rtp_rtcp/source/rtcp_packet/congestion_control_feedback.h"
 #include "modules/rtp_rtcp/source/rtcp_packet/transport_feedback.h"
 #include "rtc_base/checks.h"
 #include "rtc_base/logging.h"
@@ -26,6 +28,9 @@
 namespace webrtc {
 
 constexpr TimeDelta kSendTimeHistoryWindow = TimeDelta::Seconds(60);
+// Larger gaps in the RTP sequence numbers reported by congestion control
+// feedback are not reported as lost, the stream is assumed to have restarted.
+constexpr int kMaxLostPacketsPerGap = 1000;
 
 void InFlightBytesTracker::AddInFlightPacketBytes(
     const PacketFeedback& packet) {
@@ -85,6 +90,10 @@ bool InFlightBytesTracker::NetworkRouteComparator::operator()(
 
 TransportFeedbackAdapter::TransportFeedbackAdapter() = default;
 
+void TransportFeedbackAdapter::EnableCongestionControlFeedback() {
+  congestion_control_feedback_enabled_ = true;
+}
+
 void TransportFeedbackAdapter::AddPacket(const RtpPacketSendInfo& packet_info,
                                          size_t overhead_bytes,
                                          Timestamp creation_time) {
@@ -96,6 +105,8 @@ void TransportFeedbackAdapter::AddPacket(const RtpPacketSendInfo& packet_info,
   packet.sent.audio = packet_info.packet_type == RtpPacketMediaType::kAudio;
   packet.network_route = network_route_;
   packet.sent.pacing_info = packet_info.pacing_info;
+  packet.ssrc = packet_info.ssrc;
+  packet.rtp_sequence_number = packet_info.sequence_number;
 
   while (!history_.empty() &&
          creation_time - history_.begin()->second.creation_time >
@@ -103,9 +114,14 @@ void TransportFeedbackAdapter::AddPacket(const RtpPacketSendInfo& packet_info,
     // TODO(sprang): Warn if erasing (too many) old items?
     if (history_.begin()->second.sent.sequence_number > last_ack_seq_num_)
       in_flight_.RemoveInFlightPacketBytes(history_.begin()->second);
-    history_.erase(history_.begin());
+    EraseFromHistory(history_.begin());
   }
   history_.insert(std::make_pair(packet.sent.sequence_number, packet));
+  if (congestion_control_feedback_enabled_) {
+    rtp_to_transport_sequence_number_.insert_or_assign(
+        RtpPacketKey(packet.ssrc, packet.rtp_sequence_number),
+        packet.sent.sequence_number);
+  }
 }
 
 absl::optional<SentPacket> TransportFeedbackAdapter::ProcessSentPacket(
@@ -167,6 +183,79 @@ TransportFeedbackAdapter::ProcessTransportFeedback(
   return msg;
 }
 
+absl::optional<TransportPacketsFeedback>
+TransportFeedbackAdapter::ProcessCongestionControlFeedback(
+    const rtcp::CongestionControlFeedback& feedback,
+    Timestamp feedback_receive_time) {
+  if (feedback.packets().empty()) {
+    RTC_LOG(LS_INFO) << "Empty congestion control feedback packet received.";
+    return absl::nullopt;
+  }
+
+  // Compact NTP timestamps are in units of 1/2^16 seconds.
+  int64_t report_timestamp_compact_ntp = report_timestamp_unwrapper_.Unwrap(
+      feedback.report_timestamp_compact_ntp());
+  if (first_report_time_.IsInfinite()) {
+    first_report_timestamp_compact_ntp_ = report_timestamp_compact_ntp;
+    first_report_time_ = feedback_receive_time;
+  }
+  const Timestamp report_time =
+      first_report_time_ +
+      TimeDelta::Micros((report_timestamp_compact_ntp -
+                         first_report_timestamp_compact_ntp_) *
+                        1'000'000 / (1 << 16));
+
+  PacketResults results;
+  results.packets.reserve(feedback.packets().size());
+  for (const rtcp::CongestionControlFeedback::PacketInfo& packet :
+       feedback.packets()) {
+    // Only received packets are reported, the ones skipped since the last
+    // reported packet of the SSRC are lost.
+    auto [last_reported, inserted] = last_reported_sequence_numbers_.emplace(
+        packet.ssrc, packet.sequence_number);
+    if (!inserted &&
+        IsNewerSequenceNumber(packet.sequence_number, last_reported->second)) {
+      uint16_t num_lost = packet.sequence_number - last_reported->second - 1;
+      if (num_lost <= kMaxLostPacketsPerGap) {
+        for (uint16_t sequence_number = last_reported->second + 1;
+             sequence_number != packet.sequence_number; ++sequence_number) {
+          auto it = rtp_to_transport_sequence_number_.find(
+              RtpPacketKey(packet.ssrc, sequence_number));
+          if (it != rtp_to_transport_sequence_number_.end()) {
+            AddPacketResult(it->second, Timestamp::PlusInfinity(),
+                            rtc::EcnMarking::kNotEct, results);
+          }
+        }
+      }
+      last_reported->second = packet.sequence_number;
+    }
+
+    auto it = rtp_to_transport_sequence_number_.find(
+        RtpPacketKey(packet.ssrc, packet.sequence_number));
+    if (it == rtp_to_transport_sequence_number_.end()) {
+      ++results.failed_lookups;
+      continue;
+    }
+    AddPacketResult(it->second, report_time - packet.arrival_time_offset,
+                    packet.ecn, results);
+  }
+
+  TransportPacketsFeedback msg;
+  msg.feedback_time = feedback_receive_time;
+  msg.packet_feedbacks = TakePacketResults(results);
+  if (msg.packet_feedbacks.empty())
+    return absl::nullopt;
+  // Feedback is grouped by SSRC, while the packets were sent interleaved.
+  absl::c_sort(msg.packet_feedbacks,
+               [](const PacketResult& a, const PacketResult& b) {
+                 return a.sent_packet.sequence_number <
+                        b.sent_packet.sequence_number;
+               });
+  msg.data_in_flight = in_flight_.GetOutstandingData(network_route_);
+
+  return msg;
+}
+
 void TransportFeedbackAdapter::SetNetworkRoute(
     const rtc::NetworkRoute& network_route) {
   network_route_ = network_route;
@@ -199,71 +288,98 @@ TransportFeedbackAdapter::ProcessTransportFeedbackInner(
   }
   last_timestamp_ = feedback.BaseTime();
 
-  std::vector<PacketResult> packet_result_vector;
-  packet_result_vector.reserve(feedback.GetPacketStatusCount());
-
-  size_t failed_lookups = 0;
-  size_t ignored = 0;
+  PacketResults results;
+  results.packets.reserve(feedback.GetPacketStatusCount());
 
   feedback.ForAllPackets(
       [&](uint16_t sequence_number, TimeDelta delta_since_base) {
-        int64_t seq_num = seq_num_unwrapper_.Unwrap(sequence_number);
-
-        if (seq_num > last_ack_seq_num_) {
-          // Starts at history_.begin() if last_ack_seq_num_ < 0, since any
-          // valid sequence number is >= 0.
-          for (auto it = history_.upper_bound(last_ack_seq_num_);
-               it != history_.upper_bound(seq_num); ++it) {
-            in_flight_.RemoveInFlightPacketBytes(it->second);
-          }
-          last_ack_seq_num_ = seq_num;
-        }
+        AddPacketResult(
+            seq_num_unwrapper_.Unwrap(sequence_number),
+            delta_since_base.IsFinite()
+                ? current_offset_ +
+                      delta_since_base.RoundDownTo(TimeDelta::Millis(1))
+                : Timestamp::PlusInfinity(),
+            rtc::EcnMarking::kNotEct, results);
+      });
 
-        auto it = history_.find(seq_num);
-        if (it == history_.end()) {
-          ++failed_lookups;
-          return;
-        }
+  return TakePacketResults(results);
+}
 
-        if (it->second.sent.send_time.IsInfinite()) {
-          // TODO(srte): Fix the tests that makes this happen and make this a
-          // DCHECK.
-          RTC_DLOG(LS_ERROR)
-              << "Received feedback before packet was indicated as sent";
-          return;
-        }
+void TransportFeedbackAdapter::AddPacketResult(int64_t seq_num,
+                                               Timestamp receive_time,
+                                               rtc::EcnMarking ecn,
+                                               PacketResults& results) {
+  if (seq_num > last_ack_seq_num_) {
+    // Starts at history_.begin() if last_ack_seq_num_ < 0, since any
+    // valid sequence number is >= 0.
+    for (auto it = history_.upper_bound(last_ack_seq_num_);
+         it != history_.upper_bound(seq_num); ++it) {
+      in_flight_.RemoveInFlightPacketBytes(it->second);
+    }
+    last_ack_seq_num_ = seq_num;
+  }
 
-        PacketFeedback packet_feedback = it->second;
-        if (delta_since_base.IsFinite()) {
-          packet_feedback.receive_time =
-              current_offset_ +
-              delta_since_base.RoundDownTo(TimeDelta::Millis(1));
-          // Note: Lost packets are not removed from history because they might
-          // be reported as received by a later feedback.
-          history_.erase(it);
-        }
-        if (packet_feedback.network_route == network_route_) {
-          PacketResult result;
-          result.sent_packet = packet_feedback.sent;
-          result.receive_time = packet_feedback.receive_time;
-          packet_result_vector.push_back(result);
-        } else {
-          ++ignored;
-        }
-      });
+  auto it = history_.find(seq_num);
+  if (it == history_.end()) {
+    ++results.failed_lookups;
+    return;
+  }
+
+  if (it->second.sent.send_time.IsInfinite()) {
+    // TODO(srte): Fix the tests that makes this happen and make this a
+    // DCHECK.
+    RTC_DLOG(LS_ERROR)
+        << "Received feedback before packet was indicated as sent";
+    return;
+  }
+
+  PacketFeedback packet_feedback = it->second;
+  if (receive_time.IsFinite()) {
+    packet_feedback.receive_time = receive_time;
+    // Note: Lost packets are not removed from history because they might
+    // be reported as received by a later feedback.
+    EraseFromHistory(it);
+  }
+  if (packet_feedback.network_route == network_route_) {
+    PacketResult result;
+    result.sent_packet = packet_feedback.sent;
+    result.receive_time = packet_feedback.receive_time;
+    result.ecn = ecn;
+    results.packets.push_back(result);
+  } else {
+    ++results.ignored;
+  }
+}
 
-  if (failed_lookups > 0) {
+std::vector<PacketResult> TransportFeedbackAdapter::TakePacketResults(
+    PacketResults& results) {
+  if (results.failed_lookups > 0) {
     RTC_LOG(LS_WARNING)
-        << "Failed to lookup send time for " << failed_lookups << " packet"
-        << (failed_lookups > 1 ? "s" : "")
+        << "Failed to lookup send time for " << results.failed_lookups
+        << " packet" << (results.failed_lookups > 1 ? "s" : "")
         << ". Packets reordered or send time history too small?";
   }
-  if (ignored > 0) {
-    RTC_LOG(LS_INFO) << "Ignoring " << ignored
+  if (results.ignored > 0) {
+    RTC_LOG(LS_INFO) << "Ignoring " << results.ignored
                      << " packets because they were sent on a different route.";
   }
+  return std::move(results.packets);
+}
 
-  return packet_result_vector;
+std::map<int64_t, PacketFeedback>::iterator
+TransportFeedbackAdapter::EraseFromHistory(
+    std::map<int64_t, PacketFeedback>::iterator it) {
+  if (congestion_control_feedback_enabled_) {
+    auto rtp_it = rtp_to_transport_sequence_number_.find(
+        RtpPacketKey(it->second.ssrc, it->second.rtp_sequence_number));
+    // A later packet may have been sent with the same SSRC and RTP sequence
+    // number.
+    if (rtp_it != rtp_to_transport_sequence_number_.end() &&
+        rtp_it->second == it->first) {
+      rtp_to_transport_sequence_number_.erase(rtp_it);
+    }
+  }
+  return history_.erase(it);
 }
 
 }  // namespace webrtc
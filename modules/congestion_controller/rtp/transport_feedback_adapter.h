@@ -11,15 +11,21 @@
 #ifndef MODULES_CONGESTION_CONTROLLER_RTP_TRANSPORT_FEEDBACK_ADAPTER_H_
 #define MODULES_CONGESTION_CONTROLLER_RTP_TRANSPORT_FEEDBACK_ADAPTER_H_
 
+#include <stddef.h>
+#include <stdint.h>
+
 #include <deque>
 #include <map>
-#include <utility>
+#include <unordered_map>
 #include <vector>
 
+#include "absl/types/optional.h"
 #include "api/sequence_checker.h"
 #include "api/transport/network_types.h"
 #include "api/units/timestamp.h"
 #include "modules/rtp_rtcp/include/rtp_rtcp_defines.h"
+#include "modules/rtp_rtcp/source/rtcp_packet/congestion_control_feedback.h"
+#include "rtc_base/network/ecn_marking.h"
 #include "rtc_base/network/sent_packet.h"
 #include "rtc_base/network_route.h"
 #include "rtc_base/numerics/sequence_number_unwrapper.h"
@@ -36,6 +42,10 @@ struct PacketFeedback {
   // receiver's clock. For unreceived packet, Timestamp::PlusInfinity() is
   // used.
   Timestamp receive_time = Timestamp::PlusInfinity();
+  // SSRC and RTP sequence number the packet was sent with, which RFC 8888
+  // congestion control feedback identifies it by.
+  uint32_t ssrc = 0;
+  uint16_t rtp_sequence_number = 0;
 
   // The network route that this packet is associated with.
   rtc::NetworkRoute network_route;
@@ -59,6 +69,11 @@ class TransportFeedbackAdapter {
  public:
   TransportFeedbackAdapter();
 
+  // Makes the packets added from now on known to
+  // ProcessCongestionControlFeedback(), which looks them up by SSRC and RTP
+  // sequence number.
+  void EnableCongestionControlFeedback();
+
   void AddPacket(const RtpPacketSendInfo& packet_info,
                  size_t overhead_bytes,
                  Timestamp creation_time);
@@ -69,6 +84,10 @@ class TransportFeedbackAdapter {
       const rtcp::TransportFeedback& feedback,
       Timestamp feedback_receive_time);
 
+  absl::optional<TransportPacketsFeedback> ProcessCongestionControlFeedback(
+      const rtcp::CongestionControlFeedback& feedback,
+      Timestamp feedback_receive_time);
+
   void SetNetworkRoute(const rtc::NetworkRoute& network_route);
 
   DataSize GetOutstandingData() const;
@@ -76,15 +95,47 @@ class TransportFeedbackAdapter {
  private:
   enum class SendTimeHistoryStatus { kNotAdded, kOk, kDuplicate };
 
+  // Feedback about the packets of one feedback message.
+  struct PacketResults {
+    std::vector<PacketResult> packets;
+    // Packets that are not in the history.
+    size_t failed_lookups = 0;
+    // Packets sent on another network route than the current one.
+    size_t ignored = 0;
+  };
+
   std::vector<PacketResult> ProcessTransportFeedbackInner(
       const rtcp::TransportFeedback& feedback,
       Timestamp feedback_receive_time);
 
+  // Adds the feedback about the packet with unwrapped transport sequence
+  // number `seq_num` to `results`. `receive_time` is infinite for packets
+  // reported as lost.
+  void AddPacketResult(int64_t seq_num,
+                       Timestamp receive_time,
+                       rtc::EcnMarking ecn,
+                       PacketResults& results);
+
+  // Returns the packets of `results`, logging the ones that were dropped.
+  static std::vector<PacketResult> TakePacketResults(PacketResults& results);
+
+  std::map<int64_t, PacketFeedback>::iterator EraseFromHistory(
+      std::map<int64_t, PacketFeedback>::iterator it);
+
+  static uint64_t RtpPacketKey(uint32_t ssrc, uint16_t rtp_sequence_number) {
+    return (uint64_t{ssrc} << 16) | rtp_sequence_number;
+  }
+
   DataSize pending_untracked_size_ = DataSize::Zero();
   Timestamp last_send_time_ = Timestamp::MinusInfinity();
   Timestamp last_untracked_send_time_ = Timestamp::MinusInfinity();
   RtpSequenceNumberUnwrapper seq_num_unwrapper_;
   std::map<int64_t, PacketFeedback> history_;
+  bool congestion_control_feedback_enabled_ = false;
+  // Unwrapped transport sequence numbers of the packets in `history_`, by
+  // RtpPacketKey() of the SSRC and RTP sequence number they were sent with.
+  // Only filled if congestion control feedback is enabled.
+  std::unordered_map<uint64_t, int64_t> rtp_to_transport_sequence_number_;
 
   // Sequence numbers are never negative, using -1 as it always < a real
   // sequence number.
@@ -94,6 +145,15 @@ class TransportFeedbackAdapter {
   Timestamp current_offset_ = Timestamp::MinusInfinity();
   Timestamp last_timestamp_ = Timestamp::MinusInfinity();
 
+  // Report timestamps of congestion control feedback are mapped to a local
+  // time base selected on the first feedback.
+  SeqNumUnwrapper<uint32_t> report_timestamp_unwrapper_;
+  int64_t first_report_timestamp_compact_ntp_ = 0;
+  Timestamp first_report_time_ = Timestamp::MinusInfinity();
+  // Highest RTP sequence number per SSRC reported by congestion control
+  // feedback. Packets up to it that are not reported are lost.
+  std::map<uint32_t, uint16_t> last_reported_sequence_numbers_;
+
   rtc::NetworkRoute network_route_;
 };
 
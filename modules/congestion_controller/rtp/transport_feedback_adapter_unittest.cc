@@ -15,8 +15,10 @@
 #include <vector>
 
 #include "modules/rtp_rtcp/include/rtp_rtcp_defines.h"
+#include "modules/rtp_rtcp/source/rtcp_packet/congestion_control_feedback.h"
 #include "modules/rtp_rtcp/source/rtcp_packet/transport_feedback.h"
 #include "rtc_base/checks.h"
+#include "rtc_base/network/ecn_marking.h"
 #include "rtc_base/numerics/safe_conversions.h"
 #include "system_wrappers/include/clock.h"
 #include "test/field_trial.h"
@@ -104,6 +106,8 @@ class TransportFeedbackAdapterTest : public ::testing::Test {
     packet_info.transport_sequence_number =
         packet_feedback.sent_packet.sequence_number;
     packet_info.rtp_sequence_number = 0;
+    packet_info.ssrc = kSsrc;
+    packet_info.sequence_number = packet_feedback.sent_packet.sequence_number;
     packet_info.length = packet_feedback.sent_packet.size.bytes();
     packet_info.pacing_info = packet_feedback.sent_packet.pacing_info;
     packet_info.packet_type = RtpPacketMediaType::kVideo;
@@ -374,6 +378,71 @@ TEST_F(TransportFeedbackAdapterTest, TimestampDeltas) {
   }
 }
 
+TEST_F(TransportFeedbackAdapterTest, AdaptsCongestionControlFeedback) {
+  adapter_->EnableCongestionControlFeedback();
+  std::vector<PacketResult> packets = {
+      CreatePacket(100, 200, 0, 1500, kPacingInfo0),
+      CreatePacket(110, 210, 1, 1500, kPacingInfo0),
+      CreatePacket(120, 220, 2, 1500, kPacingInfo0),
+      CreatePacket(130, 230, 3, 1500, kPacingInfo0),
+      CreatePacket(140, 240, 4, 1500, kPacingInfo0)};
+  for (const auto& packet : packets)
+    OnSentPacket(packet);
+
+  // Reported at 150 ms in the time of the receiver, packet 2 is lost.
+  constexpr uint32_t kReportTimestampCompactNtp = 0x1234'0000;
+  rtcp::CongestionControlFeedback feedback(
+      {{.ssrc = kSsrc,
+        .sequence_number = 0,
+        .arrival_time_offset = TimeDelta::Millis(50)},
+       {.ssrc = kSsrc,
+        .sequence_number = 1,
+        .arrival_time_offset = TimeDelta::Millis(40)},
+       {.ssrc = kSsrc,
+        .sequence_number = 3,
+        .arrival_time_offset = TimeDelta::Millis(20),
+        .ecn = rtc::EcnMarking::kCe}},
+      kReportTimestampCompactNtp);
+  absl::optional<TransportPacketsFeedback> result =
+      adapter_->ProcessCongestionControlFeedback(feedback,
+                                                 Timestamp::Millis(1000));
+  ASSERT_TRUE(result.has_value());
+  std::vector<PacketResult> expected_packets(packets.begin(),
+                                             packets.begin() + 4);
+  ComparePacketFeedbackVectors(expected_packets, result->packet_feedbacks);
+  EXPECT_FALSE(result->packet_feedbacks[2].IsReceived());
+  EXPECT_EQ(result->packet_feedbacks[0].ecn, rtc::EcnMarking::kNotEct);
+  EXPECT_EQ(result->packet_feedbacks[3].ecn, rtc::EcnMarking::kCe);
+
+  // Report timestamps are in units of 1/2^16 seconds.
+  rtcp::CongestionControlFeedback next_feedback(
+      {{.ssrc = kSsrc,
+        .sequence_number = 4,
+        .arrival_time_offset = TimeDelta::Millis(10)}},
+      kReportTimestampCompactNtp + (1 << 16));
+  result = adapter_->ProcessCongestionControlFeedback(next_feedback,
+                                                      Timestamp::Millis(2000));
+  ASSERT_TRUE(result.has_value());
+  ASSERT_EQ(result->packet_feedbacks.size(), 1u);
+  EXPECT_EQ(result->packet_feedbacks[0].sent_packet.sequence_number, 4);
+  EXPECT_EQ(result->packet_feedbacks[0].receive_time,
+            Timestamp::Millis(1000 + 1000 - 10));
+}
+
+TEST_F(TransportFeedbackAdapterTest,
+       IgnoresCongestionControlFeedbackUnlessEnabled) {
+  PacketResult packet = CreatePacket(100, 200, 0, 1500, kPacingInfo0);
+  OnSentPacket(packet);
+
+  rtcp::CongestionControlFeedback feedback(
+      {{.ssrc = kSsrc,
+        .sequence_number = 0,
+        .arrival_time_offset = TimeDelta::Millis(50)}},
+      /*report_timestamp_compact_ntp=*/0x1234'0000);
+  EXPECT_FALSE(adapter_->ProcessCongestionControlFeedback(
+      feedback, Timestamp::Millis(1000)));
+}
+
 TEST_F(TransportFeedbackAdapterTest, IgnoreDuplicatePacketSentCalls) {
   auto packet = CreatePacket(100, 200, 0, 1500, kPacingInfo0);
 
@@ -0,0 +1,127 @@
+/*
+ *  Copyright (c) 2024 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "modules/pacing/pacer_scheduler.h"
+
+#include <stdint.h>
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+#include "rtc_base/checks.h"
+#include "rtc_base/trace_event.h"
+
+namespace webrtc {
+
+PacerScheduler::PacerScheduler(Clock* clock, TimeDelta coalescing_window)
+    : clock_(clock),
+      coalescing_window_(coalescing_window),
+      task_queue_(TaskQueueBase::Current()) {
+  RTC_DCHECK(task_queue_);
+  RTC_DCHECK_GE(coalescing_window_, TimeDelta::Zero());
+}
+
+PacerScheduler::~PacerScheduler() {
+  RTC_DCHECK_RUN_ON(task_queue_);
+  RTC_DCHECK(scheduled_.empty());
+}
+
+void PacerScheduler::Schedule(Client* client, Timestamp time) {
+  RTC_DCHECK_RUN_ON(task_queue_);
+  RTC_DCHECK(time.IsFinite());
+  auto it = scheduled_.find(client);
+  if (it != scheduled_.end()) {
+    queue_.erase(it->second);
+    it->second = queue_.emplace(time, client);
+  } else {
+    scheduled_.emplace(client, queue_.emplace(time, client));
+  }
+  MaybePostWakeup();
+}
+
+void PacerScheduler::Cancel(Client* client) {
+  RTC_DCHECK_RUN_ON(task_queue_);
+  auto it = scheduled_.find(client);
+  if (it != scheduled_.end()) {
+    queue_.erase(it->second);
+    scheduled_.erase(it);
+  }
+}
+
+size_t PacerScheduler::num_wakeups() const {
+  RTC_DCHECK_RUN_ON(task_queue_);
+  return num_wakeups_;
+}
+
+Timestamp PacerScheduler::RoundUpToWindow(Timestamp time) const {
+  if (coalescing_window_.IsZero()) {
+    return time;
+  }
+  int64_t window_us = coalescing_window_.us();
+  return Timestamp::Micros((time.us() + window_us - 1) / window_us *
+                           window_us);
+}
+
+// RTC_RUN_ON(task_queue_)
+void PacerScheduler::MaybePostWakeup() {
+  if (queue_.empty()) {
+    return;
+  }
+  // Clients that are already due wait for the next window, so that a client
+  // rescheduling itself for now is not called again in the same one.
+  const Timestamp now = clock_->CurrentTime();
+  Timestamp wakeup_time =
+      std::max(RoundUpToWindow(queue_.begin()->first),
+               RoundUpToWindow(now + TimeDelta::Micros(1)));
+  if (wakeup_time >= wakeup_time_) {
+    return;
+  }
+  // Superseding the pending task, if any, rather than cancelling it.
+  wakeup_time_ = wakeup_time;
+  TimeDelta delay = wakeup_time_ - now;
+  task_queue_->PostDelayedHighPrecisionTask(
+      SafeTask(safety_.flag(),
+               [this, wakeup_time = wakeup_time_] { OnWakeup(wakeup_time); }),
+      delay.RoundUpTo(TimeDelta::Millis(1)));
+}
+
+void PacerScheduler::OnWakeup(Timestamp wakeup_time) {
+  RTC_DCHECK_RUN_ON(task_queue_);
+  if (wakeup_time != wakeup_time_) {
+    return;
+  }
+  TRACE_EVENT0(TRACE_DISABLED_BY_DEFAULT("webrtc"), "PacerScheduler::OnWakeup");
+  wakeup_time_ = Timestamp::PlusInfinity();
+  ++num_wakeups_;
+
+  // Clients reschedule themselves when called, possibly within the window, so
+  // the batch is taken before calling any of them. Each client is called at
+  // most once per wakeup.
+  const Timestamp deadline = std::max(wakeup_time, clock_->CurrentTime());
+  std::vector<std::pair<Client*, Timestamp>> batch;
+  for (auto it = queue_.begin(); it != queue_.end() && it->first <= deadline;
+       ++it) {
+    batch.emplace_back(it->second, it->first);
+  }
+  for (const auto& [client, scheduled_time] : batch) {
+    auto it = scheduled_.find(client);
+    // Skip clients cancelled or rescheduled by those called before them.
+    if (it == scheduled_.end() || it->second->first != scheduled_time) {
+      continue;
+    }
+    queue_.erase(it->second);
+    scheduled_.erase(it);
+    client->OnScheduledProcess(scheduled_time);
+  }
+  MaybePostWakeup();
+}
+
+}  // namespace webrtc
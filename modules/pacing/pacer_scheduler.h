@@ -0,0 +1,91 @@
+/*
+ *  Copyright (c) 2024 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef MODULES_PACING_PACER_SCHEDULER_H_
+#define MODULES_PACING_PACER_SCHEDULER_H_
+
+#include <stddef.h>
+
+#include <map>
+#include <unordered_map>
+
+#include "api/task_queue/pending_task_safety_flag.h"
+#include "api/task_queue/task_queue_base.h"
+#include "api/units/time_delta.h"
+#include "api/units/timestamp.h"
+#include "rtc_base/thread_annotations.h"
+#include "system_wrappers/include/clock.h"
+
+namespace webrtc {
+
+// Drives the delayed processing of many pacers, typically one
+// TaskQueuePacedSender per RtpTransportControllerSend, from a single delayed
+// task. The process times the pacers ask for are kept in one ordered
+// structure and rounded up to multiples of `coalescing_window`, and each
+// wakeup processes every pacer due by then. A server with many transports
+// thus wakes up at most once per window rather than once per pacer and
+// packet burst. Each pacer keeps its own PacingController, and with it its
+// own budgets.
+//
+// Must be created, used and destroyed on the task queue the pacers run on,
+// and outlive them.
+class PacerScheduler {
+ public:
+  class Client {
+   public:
+    // Called on the task queue at the end of the coalescing window that
+    // `scheduled_time` falls in, or later if the task queue is busy.
+    virtual void OnScheduledProcess(Timestamp scheduled_time) = 0;
+
+   protected:
+    virtual ~Client() = default;
+  };
+
+  explicit PacerScheduler(Clock* clock,
+                          TimeDelta coalescing_window = TimeDelta::Millis(1));
+  ~PacerScheduler();
+
+  PacerScheduler(const PacerScheduler&) = delete;
+  PacerScheduler& operator=(const PacerScheduler&) = delete;
+
+  // Schedules a call to `client` at `time`, replacing its earlier scheduled
+  // call, if any.
+  void Schedule(Client* client, Timestamp time);
+  void Cancel(Client* client);
+
+  // Number of delayed tasks that have run, for tests and stats.
+  size_t num_wakeups() const;
+
+ private:
+  using Queue = std::multimap<Timestamp, Client*>;
+
+  Timestamp RoundUpToWindow(Timestamp time) const;
+  void MaybePostWakeup() RTC_RUN_ON(task_queue_);
+  void OnWakeup(Timestamp wakeup_time);
+
+  Clock* const clock_;
+  const TimeDelta coalescing_window_;
+  TaskQueueBase* const task_queue_;
+
+  Queue queue_ RTC_GUARDED_BY(task_queue_);
+  std::unordered_map<Client*, Queue::iterator> scheduled_
+      RTC_GUARDED_BY(task_queue_);
+  // Time of the pending delayed task, or plus infinity if there is none.
+  // Tasks posted for other times have been superseded and do nothing.
+  Timestamp wakeup_time_ RTC_GUARDED_BY(task_queue_) =
+      Timestamp::PlusInfinity();
+  size_t num_wakeups_ RTC_GUARDED_BY(task_queue_) = 0;
+
+  ScopedTaskSafety safety_;
+};
+
+}  // namespace webrtc
+
+#endif  // MODULES_PACING_PACER_SCHEDULER_H_
@@ -0,0 +1,151 @@
+/*
+ *  Copyright (c) 2024 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "modules/pacing/pacer_scheduler.h"
+
+#include "api/units/time_delta.h"
+#include "api/units/timestamp.h"
+#include "test/gmock.h"
+#include "test/gtest.h"
+#include "test/time_controller/simulated_time_controller.h"
+
+namespace webrtc {
+namespace {
+
+using ::testing::_;
+using ::testing::Mock;
+
+class MockClient : public PacerScheduler::Client {
+ public:
+  MOCK_METHOD(void, OnScheduledProcess, (Timestamp), (override));
+};
+
+class PacerSchedulerTest : public ::testing::Test {
+ protected:
+  PacerSchedulerTest()
+      : time_controller_(Timestamp::Millis(1000)),
+        start_time_(time_controller_.GetClock()->CurrentTime()) {}
+
+  GlobalSimulatedTimeController time_controller_;
+  const Timestamp start_time_;
+};
+
+TEST_F(PacerSchedulerTest, CallsClientWhenDue) {
+  PacerScheduler scheduler(time_controller_.GetClock());
+  MockClient client;
+  const Timestamp scheduled_time = start_time_ + TimeDelta::Millis(5);
+  scheduler.Schedule(&client, scheduled_time);
+
+  EXPECT_CALL(client, OnScheduledProcess).Times(0);
+  time_controller_.AdvanceTime(TimeDelta::Millis(4));
+  Mock::VerifyAndClearExpectations(&client);
+
+  EXPECT_CALL(client, OnScheduledProcess(scheduled_time));
+  time_controller_.AdvanceTime(TimeDelta::Millis(1));
+  EXPECT_EQ(scheduler.num_wakeups(), 1u);
+}
+
+TEST_F(PacerSchedulerTest, CoalescesClientsDueInSameWindow) {
+  PacerScheduler scheduler(time_controller_.GetClock(),
+                           /*coalescing_window=*/TimeDelta::Millis(5));
+  MockClient clients[4];
+  scheduler.Schedule(&clients[0], start_time_ + TimeDelta::Millis(1));
+  scheduler.Schedule(&clients[1], start_time_ + TimeDelta::Millis(3));
+  scheduler.Schedule(&clients[2], start_time_ + TimeDelta::Millis(5));
+  scheduler.Schedule(&clients[3], start_time_ + TimeDelta::Millis(6));
+
+  EXPECT_CALL(clients[0], OnScheduledProcess).Times(0);
+  EXPECT_CALL(clients[1], OnScheduledProcess).Times(0);
+  time_controller_.AdvanceTime(TimeDelta::Millis(4));
+  Mock::VerifyAndClearExpectations(&clients[0]);
+  Mock::VerifyAndClearExpectations(&clients[1]);
+
+  EXPECT_CALL(clients[0], OnScheduledProcess);
+  EXPECT_CALL(clients[1], OnScheduledProcess);
+  EXPECT_CALL(clients[2], OnScheduledProcess);
+  EXPECT_CALL(clients[3], OnScheduledProcess).Times(0);
+  time_controller_.AdvanceTime(TimeDelta::Millis(1));
+  EXPECT_EQ(scheduler.num_wakeups(), 1u);
+  Mock::VerifyAndClearExpectations(&clients[3]);
+
+  EXPECT_CALL(clients[3], OnScheduledProcess);
+  time_controller_.AdvanceTime(TimeDelta::Millis(5));
+  EXPECT_EQ(scheduler.num_wakeups(), 2u);
+}
+
+TEST_F(PacerSchedulerTest, RescheduleReplacesEarlierTime) {
+  PacerScheduler scheduler(time_controller_.GetClock());
+  MockClient client;
+  scheduler.Schedule(&client, start_time_ + TimeDelta::Millis(5));
+  scheduler.Schedule(&client, start_time_ + TimeDelta::Millis(10));
+
+  EXPECT_CALL(client, OnScheduledProcess(start_time_ + TimeDelta::Millis(10)));
+  time_controller_.AdvanceTime(TimeDelta::Millis(20));
+}
+
+TEST_F(PacerSchedulerTest, EarlierScheduleWakesUpEarlier) {
+  PacerScheduler scheduler(time_controller_.GetClock());
+  MockClient client;
+  scheduler.Schedule(&client, start_time_ + TimeDelta::Millis(10));
+  scheduler.Schedule(&client, start_time_ + TimeDelta::Millis(5));
+
+  EXPECT_CALL(client, OnScheduledProcess(start_time_ + TimeDelta::Millis(5)));
+  time_controller_.AdvanceTime(TimeDelta::Millis(5));
+  Mock::VerifyAndClearExpectations(&client);
+
+  // The superseded wakeup does nothing.
+  EXPECT_CALL(client, OnScheduledProcess).Times(0);
+  time_controller_.AdvanceTime(TimeDelta::Millis(10));
+  EXPECT_EQ(scheduler.num_wakeups(), 1u);
+}
+
+TEST_F(PacerSchedulerTest, DoesNotCallCancelledClient) {
+  PacerScheduler scheduler(time_controller_.GetClock());
+  MockClient client;
+  scheduler.Schedule(&client, start_time_ + TimeDelta::Millis(5));
+  scheduler.Cancel(&client);
+
+  EXPECT_CALL(client, OnScheduledProcess).Times(0);
+  time_controller_.AdvanceTime(TimeDelta::Millis(10));
+}
+
+TEST_F(PacerSchedulerTest, DoesNotCallClientCancelledByClientInSameBatch) {
+  PacerScheduler scheduler(time_controller_.GetClock());
+  MockClient first;
+  MockClient second;
+  scheduler.Schedule(&first, start_time_ + TimeDelta::Millis(1));
+  scheduler.Schedule(&second, start_time_ + TimeDelta::Millis(1));
+
+  EXPECT_CALL(first, OnScheduledProcess).WillOnce([&](Timestamp) {
+    scheduler.Cancel(&second);
+  });
+  EXPECT_CALL(second, OnScheduledProcess).Times(0);
+  time_controller_.AdvanceTime(TimeDelta::Millis(1));
+}
+
+TEST_F(PacerSchedulerTest, ClientRescheduledWhenCalledRunsOncePerWakeup) {
+  PacerScheduler scheduler(time_controller_.GetClock(),
+                           /*coalescing_window=*/TimeDelta::Millis(5));
+  MockClient client;
+  scheduler.Schedule(&client, start_time_ + TimeDelta::Millis(5));
+
+  // Rescheduling within the current window is served by the next wakeup.
+  EXPECT_CALL(client, OnScheduledProcess)
+      .Times(4)
+      .WillRepeatedly([&](Timestamp) {
+        scheduler.Schedule(&client, time_controller_.GetClock()->CurrentTime());
+      });
+  time_controller_.AdvanceTime(TimeDelta::Millis(20));
+  EXPECT_EQ(scheduler.num_wakeups(), 4u);
+  scheduler.Cancel(&client);
+}
+
+}  // namespace
+}  // namespace webrtc
@@ -82,6 +82,12 @@ void PacketRouter::RegisterNotifyBweCallback(
   notify_bwe_callback_ = std::move(callback);
 }
 
+void PacketRouter::ConfigureForRfc8888Feedback(bool send_rtp_packets_as_ect1) {
+  RTC_DCHECK_RUN_ON(&thread_checker_);
+  use_cc_feedback_according_to_rfc8888_ = true;
+  send_rtp_packets_as_ect1_ = send_rtp_packets_as_ect1;
+}
+
 void PacketRouter::AddSendRtpModuleToMap(RtpRtcpInterface* rtp_module,
                                          uint32_t ssrc) {
   RTC_DCHECK_RUN_ON(&thread_checker_);
@@ -178,11 +184,13 @@ void PacketRouter::SendPacket(std::unique_ptr<RtpPacketToSend> packet,
     RTC_LOG(LS_WARNING) << "Failed to send packet, Not sending media";
     return;
   }
-  // TODO(bugs.webrtc.org/15368): Even if the TransportSequenceNumber extension
-  // is not negotiated, we will need the transport sequence number for BWE.
-  if (packet->HasExtension<TransportSequenceNumber>()) {
+  if (use_cc_feedback_according_to_rfc8888_ ||
+      packet->HasExtension<TransportSequenceNumber>()) {
     packet->set_transport_sequence_number(transport_seq_++);
   }
+  if (send_rtp_packets_as_ect1_) {
+    packet->set_send_as_ect1(true);
+  }
   rtp_module->AssignSequenceNumber(*packet);
   if (notify_bwe_callback_) {
     notify_bwe_callback_(*packet, cluster_info);
@@ -54,6 +54,13 @@ class PacketRouter : public PacingController::PacketSender {
       absl::AnyInvocable<void(const RtpPacketToSend& packet,
                               const PacedPacketInfo& pacing_info)> callback);
 
+  // Assigns transport sequence numbers to all packets, also when the
+  // TransportSequenceNumber extension is not negotiated, since RFC 8888
+  // congestion control feedback identifies packets by SSRC and RTP sequence
+  // number. If `send_rtp_packets_as_ect1` is true, packets are sent as L4S
+  // capable.
+  void ConfigureForRfc8888Feedback(bool send_rtp_packets_as_ect1);
+
   void AddSendRtpModule(RtpRtcpInterface* rtp_module, bool remb_candidate);
   void RemoveSendRtpModule(RtpRtcpInterface* rtp_module);
 
@@ -114,6 +121,9 @@ class PacketRouter : public PacingController::PacketSender {
       RTC_GUARDED_BY(thread_checker_);
 
   uint64_t transport_seq_ RTC_GUARDED_BY(thread_checker_);
+  bool use_cc_feedback_according_to_rfc8888_
+      RTC_GUARDED_BY(thread_checker_) = false;
+  bool send_rtp_packets_as_ect1_ RTC_GUARDED_BY(thread_checker_) = false;
   absl::AnyInvocable<void(RtpPacketToSend& packet,
                           const PacedPacketInfo& pacing_info)>
       notify_bwe_callback_ RTC_GUARDED_BY(thread_checker_) = nullptr;
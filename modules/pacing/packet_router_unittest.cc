@@ -427,6 +427,32 @@ TEST_F(PacketRouterTest, SendPacketWithoutTransportSequenceNumbers) {
   packet_router_.RemoveSendRtpModule(&rtp_1);
 }
 
+TEST_F(PacketRouterTest, SendsPacketsForRfc8888Feedback) {
+  const uint16_t kSsrc1 = 1234;
+  NiceMock<MockRtpRtcpInterface> rtp_1;
+  ON_CALL(rtp_1, SendingMedia).WillByDefault(Return(true));
+  ON_CALL(rtp_1, SSRC).WillByDefault(Return(kSsrc1));
+  ON_CALL(rtp_1, CanSendPacket).WillByDefault(Return(true));
+  packet_router_.AddSendRtpModule(&rtp_1, false);
+  packet_router_.ConfigureForRfc8888Feedback(/*send_rtp_packets_as_ect1=*/true);
+
+  // Transport sequence numbers are assigned also without the
+  // TransportSequenceNumber extension.
+  RtpHeaderExtensionMap extension_manager;
+  auto packet = std::make_unique<RtpPacketToSend>(&extension_manager);
+  packet->SetSsrc(kSsrc1);
+  EXPECT_CALL(
+      rtp_1,
+      SendPacket(
+          AllOf(Pointee(Property(&RtpPacketToSend::transport_sequence_number,
+                                 1)),
+                Pointee(Property(&RtpPacketToSend::send_as_ect1, true))),
+          _));
+  packet_router_.SendPacket(std::move(packet), PacedPacketInfo());
+  packet_router_.OnBatchComplete();
+  packet_router_.RemoveSendRtpModule(&rtp_1);
+}
+
 TEST_F(PacketRouterTest, DoesNotIncrementTransportSequenceNumberOnSendFailure) {
   NiceMock<MockRtpRtcpInterface> rtp;
   constexpr uint32_t kSsrc = 1234;
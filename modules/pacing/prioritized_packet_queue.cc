@@ -12,6 +12,7 @@
 
 #include <algorithm>
 #include <array>
+#include <iterator>
 #include <utility>
 
 #include "absl/container/inlined_vector.h"
@@ -79,65 +80,20 @@ DataSize PrioritizedPacketQueue::QueuedPacket::PacketSize() const {
 }
 
 PrioritizedPacketQueue::StreamQueue::StreamQueue(Timestamp creation_time)
-    : last_enqueue_time_(creation_time), num_keyframe_packets_(0) {}
-
-bool PrioritizedPacketQueue::StreamQueue::EnqueuePacket(QueuedPacket packet,
-                                                        int priority_level) {
-  if (packet.packet->is_key_frame()) {
-    ++num_keyframe_packets_;
-  }
-  bool first_packet_at_level = packets_[priority_level].empty();
-  packets_[priority_level].push_back(std::move(packet));
-  return first_packet_at_level;
-}
-
-PrioritizedPacketQueue::QueuedPacket
-PrioritizedPacketQueue::StreamQueue::DequeuePacket(int priority_level) {
-  RTC_DCHECK(!packets_[priority_level].empty());
-  QueuedPacket packet = std::move(packets_[priority_level].front());
-  packets_[priority_level].pop_front();
-  if (packet.packet->is_key_frame()) {
-    RTC_DCHECK_GT(num_keyframe_packets_, 0);
-    --num_keyframe_packets_;
-  }
-  return packet;
-}
-
-bool PrioritizedPacketQueue::StreamQueue::HasPacketsAtPrio(
-    int priority_level) const {
-  return !packets_[priority_level].empty();
+    : last_enqueue_time(creation_time) {
+  std::fill(std::begin(first_packet), std::end(first_packet), kNoPacket);
+  std::fill(std::begin(last_packet), std::end(last_packet), kNoPacket);
 }
 
 bool PrioritizedPacketQueue::StreamQueue::IsEmpty() const {
-  for (const std::deque<QueuedPacket>& queue : packets_) {
-    if (!queue.empty()) {
+  for (int packet : first_packet) {
+    if (packet != kNoPacket) {
       return false;
     }
   }
   return true;
 }
 
-Timestamp PrioritizedPacketQueue::StreamQueue::LeadingPacketEnqueueTime(
-    int priority_level) const {
-  RTC_DCHECK(!packets_[priority_level].empty());
-  return packets_[priority_level].begin()->enqueue_time;
-}
-
-Timestamp PrioritizedPacketQueue::StreamQueue::LastEnqueueTime() const {
-  return last_enqueue_time_;
-}
-
-std::array<std::deque<PrioritizedPacketQueue::QueuedPacket>,
-           PrioritizedPacketQueue::kNumPriorityLevels>
-PrioritizedPacketQueue::StreamQueue::DequeueAll() {
-  std::array<std::deque<QueuedPacket>, kNumPriorityLevels> packets_by_prio;
-  for (int i = 0; i < kNumPriorityLevels; ++i) {
-    packets_by_prio[i].swap(packets_[i]);
-  }
-  num_keyframe_packets_ = 0;
-  return packets_by_prio;
-}
-
 PrioritizedPacketQueue::PrioritizedPacketQueue(
     Timestamp creation_time,
     bool prioritize_audio_retransmission,
@@ -163,8 +119,6 @@ void PrioritizedPacketQueue::Push(Timestamp enqueue_time,
   }
   stream_queue = it->second.get();
 
-  auto enqueue_time_iterator =
-      enqueue_times_.insert(enqueue_times_.end(), enqueue_time);
   RTC_DCHECK(packet->packet_type().has_value());
   RtpPacketMediaType packet_type = packet->packet_type().value();
   int prio_level =
@@ -174,9 +128,6 @@ void PrioritizedPacketQueue::Push(Timestamp enqueue_time,
   PurgeOldPacketsAtPriorityLevel(prio_level, enqueue_time);
   RTC_DCHECK_GE(prio_level, 0);
   RTC_DCHECK_LT(prio_level, kNumPriorityLevels);
-  QueuedPacket queued_packed = {.packet = std::move(packet),
-                                .enqueue_time = enqueue_time,
-                                .enqueue_time_iterator = enqueue_time_iterator};
   // In order to figure out how much time a packet has spent in the queue
   // while not in a paused state, we subtract the total amount of time the
   // queue has been paused so far, and when the packet is popped we subtract
@@ -184,15 +135,36 @@ void PrioritizedPacketQueue::Push(Timestamp enqueue_time,
   // way we subtract the total amount of time the packet has spent in the
   // queue while in a paused state.
   UpdateAverageQueueTime(enqueue_time);
-  queued_packed.enqueue_time -= pause_time_sum_;
+  const int index = AllocatePacket();
+  QueuedPacket& queued_packet = packets_[index];
+  queued_packet.packet = std::move(packet);
+  queued_packet.enqueue_time = enqueue_time - pause_time_sum_;
+  queued_packet.push_time = enqueue_time;
+  queued_packet.next = kNoPacket;
+  queued_packet.older = newest_packet_;
+  queued_packet.newer = kNoPacket;
+  if (newest_packet_ == kNoPacket) {
+    oldest_packet_ = index;
+  } else {
+    packets_[newest_packet_].newer = index;
+  }
+  newest_packet_ = index;
+
   ++size_packets_;
   ++size_packets_per_media_type_[static_cast<size_t>(packet_type)];
-  size_payload_ += queued_packed.PacketSize();
+  size_payload_ += queued_packet.PacketSize();
+  if (queued_packet.packet->is_key_frame()) {
+    ++stream_queue->num_keyframe_packets;
+  }
 
-  if (stream_queue->EnqueuePacket(std::move(queued_packed), prio_level)) {
+  if (stream_queue->HasPacketsAtPrio(prio_level)) {
+    packets_[stream_queue->last_packet[prio_level]].next = index;
+  } else {
     // Number packets at `prio_level` for this steam is now non-zero.
-    streams_by_prio_[prio_level].push_back(stream_queue);
+    stream_queue->first_packet[prio_level] = index;
+    AppendStream(*stream_queue, prio_level);
   }
+  stream_queue->last_packet[prio_level] = index;
   if (top_active_prio_level_ < 0 || prio_level < top_active_prio_level_) {
     top_active_prio_level_ = prio_level;
   }
@@ -201,7 +173,7 @@ void PrioritizedPacketQueue::Push(Timestamp enqueue_time,
   if (enqueue_time - last_culling_time_ > kTimeout) {
     for (auto it = streams_.begin(); it != streams_.end();) {
       if (it->second->IsEmpty() &&
-          it->second->LastEnqueueTime() + kTimeout < enqueue_time) {
+          it->second->last_enqueue_time + kTimeout < enqueue_time) {
         streams_.erase(it++);
       } else {
         ++it;
@@ -217,20 +189,20 @@ std::unique_ptr<RtpPacketToSend> PrioritizedPacketQueue::Pop() {
   }
 
   RTC_DCHECK_GE(top_active_prio_level_, 0);
-  StreamQueue& stream_queue = *streams_by_prio_[top_active_prio_level_].front();
-  QueuedPacket packet = stream_queue.DequeuePacket(top_active_prio_level_);
-  DequeuePacketInternal(packet);
+  StreamQueue& stream_queue = *streams_by_prio_[top_active_prio_level_].front;
+  std::unique_ptr<RtpPacketToSend> packet =
+      DequeuePacket(stream_queue, top_active_prio_level_);
 
-  // Remove StreamQueue from head of fifo-queue for this prio level, and
-  // and add it to the end if it still has packets.
-  streams_by_prio_[top_active_prio_level_].pop_front();
+  // Remove StreamQueue from head of round-robin list for this prio level, and
+  // add it to the end if it still has packets.
+  RemoveStream(stream_queue, top_active_prio_level_);
   if (stream_queue.HasPacketsAtPrio(top_active_prio_level_)) {
-    streams_by_prio_[top_active_prio_level_].push_back(&stream_queue);
+    AppendStream(stream_queue, top_active_prio_level_);
   } else {
     MaybeUpdateTopPrioLevel();
   }
 
-  return std::move(packet.packet);
+  return packet;
 }
 
 int PrioritizedPacketQueue::SizeInPackets() const {
@@ -257,8 +229,8 @@ Timestamp PrioritizedPacketQueue::LeadingPacketEnqueueTime(
   if (streams_by_prio_[priority_level].empty()) {
     return Timestamp::MinusInfinity();
   }
-  return streams_by_prio_[priority_level].front()->LeadingPacketEnqueueTime(
-      priority_level);
+  return LeadingPacketEnqueueTime(*streams_by_prio_[priority_level].front,
+                                  priority_level);
 }
 
 Timestamp PrioritizedPacketQueue::LeadingPacketEnqueueTimeForRetransmission()
@@ -269,8 +241,8 @@ Timestamp PrioritizedPacketQueue::LeadingPacketEnqueueTimeForRetransmission()
     if (streams_by_prio_[priority_level].empty()) {
       return Timestamp::PlusInfinity();
     }
-    return streams_by_prio_[priority_level].front()->LeadingPacketEnqueueTime(
-        priority_level);
+    return LeadingPacketEnqueueTime(*streams_by_prio_[priority_level].front,
+                                    priority_level);
   }
   const int audio_priority_level =
       GetPriorityForType(RtpPacketMediaType::kRetransmission,
@@ -282,21 +254,21 @@ Timestamp PrioritizedPacketQueue::LeadingPacketEnqueueTimeForRetransmission()
   Timestamp next_audio =
       streams_by_prio_[audio_priority_level].empty()
           ? Timestamp::PlusInfinity()
-          : streams_by_prio_[audio_priority_level]
-                .front()
-                ->LeadingPacketEnqueueTime(audio_priority_level);
+          : LeadingPacketEnqueueTime(
+                *streams_by_prio_[audio_priority_level].front,
+                audio_priority_level);
   Timestamp next_video =
       streams_by_prio_[video_priority_level].empty()
           ? Timestamp::PlusInfinity()
-          : streams_by_prio_[video_priority_level]
-                .front()
-                ->LeadingPacketEnqueueTime(video_priority_level);
+          : LeadingPacketEnqueueTime(
+                *streams_by_prio_[video_priority_level].front,
+                video_priority_level);
   return std::min(next_audio, next_video);
 }
 
 Timestamp PrioritizedPacketQueue::OldestEnqueueTime() const {
-  return enqueue_times_.empty() ? Timestamp::MinusInfinity()
-                                : enqueue_times_.front();
+  return oldest_packet_ == kNoPacket ? Timestamp::MinusInfinity()
+                                     : packets_[oldest_packet_].push_time;
 }
 
 TimeDelta PrioritizedPacketQueue::AverageQueueTime() const {
@@ -331,41 +303,19 @@ void PrioritizedPacketQueue::SetPauseState(bool paused, Timestamp now) {
 void PrioritizedPacketQueue::RemovePacketsForSsrc(uint32_t ssrc) {
   auto kv = streams_.find(ssrc);
   if (kv != streams_.end()) {
-    // Dequeue all packets from the queue for this SSRC.
+    // Dequeue all packets from the queue for this SSRC, and deregister the
+    // `StreamQueue` from the round-robin lists.
     StreamQueue& queue = *kv->second;
-    std::array<std::deque<QueuedPacket>, kNumPriorityLevels> packets_by_prio =
-        queue.DequeueAll();
     for (int i = 0; i < kNumPriorityLevels; ++i) {
-      std::deque<QueuedPacket>& packet_queue = packets_by_prio[i];
-      if (packet_queue.empty()) {
+      if (!queue.HasPacketsAtPrio(i)) {
         continue;
       }
-
-      // First erase all packets at this prio level.
-      while (!packet_queue.empty()) {
-        QueuedPacket packet = std::move(packet_queue.front());
-        packet_queue.pop_front();
-        DequeuePacketInternal(packet);
-      }
-
-      // Next, deregister this `StreamQueue` from the round-robin tables.
-      RTC_DCHECK(!streams_by_prio_[i].empty());
-      if (streams_by_prio_[i].size() == 1) {
-        // This is the last and only queue that had packets for this prio level.
-        // Update the global top prio level if neccessary.
-        RTC_DCHECK(streams_by_prio_[i].front() == &queue);
-        streams_by_prio_[i].pop_front();
-      } else {
-        // More than stream had packets at this prio level, filter this one out.
-        std::deque<StreamQueue*> filtered_queue;
-        for (StreamQueue* queue_ptr : streams_by_prio_[i]) {
-          if (queue_ptr != &queue) {
-            filtered_queue.push_back(queue_ptr);
-          }
-        }
-        streams_by_prio_[i].swap(filtered_queue);
+      while (queue.HasPacketsAtPrio(i)) {
+        DequeuePacket(queue, i);
       }
+      RemoveStream(queue, i);
     }
+    RTC_DCHECK_EQ(queue.num_keyframe_packets, 0);
   }
   MaybeUpdateTopPrioLevel();
 }
@@ -373,12 +323,43 @@ void PrioritizedPacketQueue::RemovePacketsForSsrc(uint32_t ssrc) {
 bool PrioritizedPacketQueue::HasKeyframePackets(uint32_t ssrc) const {
   auto it = streams_.find(ssrc);
   if (it != streams_.end()) {
-    return it->second->has_keyframe_packets();
+    return it->second->num_keyframe_packets > 0;
   }
   return false;
 }
 
-void PrioritizedPacketQueue::DequeuePacketInternal(QueuedPacket& packet) {
+int PrioritizedPacketQueue::AllocatePacket() {
+  if (first_free_packet_ == kNoPacket) {
+    packets_.emplace_back();
+    return static_cast<int>(packets_.size()) - 1;
+  }
+  const int index = first_free_packet_;
+  first_free_packet_ = packets_[index].next;
+  return index;
+}
+
+Timestamp PrioritizedPacketQueue::LeadingPacketEnqueueTime(
+    const StreamQueue& stream,
+    int priority_level) const {
+  RTC_DCHECK(stream.HasPacketsAtPrio(priority_level));
+  return packets_[stream.first_packet[priority_level]].enqueue_time;
+}
+
+std::unique_ptr<RtpPacketToSend> PrioritizedPacketQueue::DequeuePacket(
+    StreamQueue& stream,
+    int priority_level) {
+  RTC_DCHECK(stream.HasPacketsAtPrio(priority_level));
+  const int index = stream.first_packet[priority_level];
+  QueuedPacket& packet = packets_[index];
+  stream.first_packet[priority_level] = packet.next;
+  if (packet.next == kNoPacket) {
+    stream.last_packet[priority_level] = kNoPacket;
+  }
+  if (packet.packet->is_key_frame()) {
+    RTC_DCHECK_GT(stream.num_keyframe_packets, 0);
+    --stream.num_keyframe_packets;
+  }
+
   --size_packets_;
   RTC_DCHECK(packet.packet->packet_type().has_value());
   RtpPacketMediaType packet_type = packet.packet->packet_type().value();
@@ -405,8 +386,55 @@ void PrioritizedPacketQueue::DequeuePacketInternal(QueuedPacket& packet) {
 
   RTC_DCHECK(size_packets_ > 0 || queue_time_sum_ == TimeDelta::Zero());
 
-  RTC_CHECK(packet.enqueue_time_iterator != enqueue_times_.end());
-  enqueue_times_.erase(packet.enqueue_time_iterator);
+  // Unlink the packet from the enqueue order and put its entry on the free
+  // list.
+  if (packet.older == kNoPacket) {
+    oldest_packet_ = packet.newer;
+  } else {
+    packets_[packet.older].newer = packet.newer;
+  }
+  if (packet.newer == kNoPacket) {
+    newest_packet_ = packet.older;
+  } else {
+    packets_[packet.newer].older = packet.older;
+  }
+  packet.next = first_free_packet_;
+  first_free_packet_ = index;
+  return std::move(packet.packet);
+}
+
+void PrioritizedPacketQueue::AppendStream(StreamQueue& stream,
+                                          int priority_level) {
+  StreamList& list = streams_by_prio_[priority_level];
+  stream.previous_stream[priority_level] = list.back;
+  stream.next_stream[priority_level] = nullptr;
+  if (list.back == nullptr) {
+    list.front = &stream;
+  } else {
+    list.back->next_stream[priority_level] = &stream;
+  }
+  list.back = &stream;
+}
+
+void PrioritizedPacketQueue::RemoveStream(StreamQueue& stream,
+                                          int priority_level) {
+  StreamList& list = streams_by_prio_[priority_level];
+  StreamQueue* previous = stream.previous_stream[priority_level];
+  StreamQueue* next = stream.next_stream[priority_level];
+  RTC_DCHECK(previous != nullptr || list.front == &stream);
+  RTC_DCHECK(next != nullptr || list.back == &stream);
+  if (previous == nullptr) {
+    list.front = next;
+  } else {
+    previous->next_stream[priority_level] = next;
+  }
+  if (next == nullptr) {
+    list.back = previous;
+  } else {
+    next->previous_stream[priority_level] = previous;
+  }
+  stream.previous_stream[priority_level] = nullptr;
+  stream.next_stream[priority_level] = nullptr;
 }
 
 void PrioritizedPacketQueue::MaybeUpdateTopPrioLevel() {
@@ -438,26 +466,24 @@ void PrioritizedPacketQueue::PurgeOldPacketsAtPriorityLevel(int prio_level,
     return;
   }
 
-  std::deque<StreamQueue*>& queues = streams_by_prio_[prio_level];
-  auto iter = queues.begin();
-  while (iter != queues.end()) {
-    StreamQueue* queue_ptr = *iter;
+  StreamQueue* queue_ptr = streams_by_prio_[prio_level].front;
+  while (queue_ptr != nullptr) {
+    StreamQueue* next = queue_ptr->next_stream[prio_level];
     while (queue_ptr->HasPacketsAtPrio(prio_level) &&
-           (now - queue_ptr->LeadingPacketEnqueueTime(prio_level)) >
+           (now - LeadingPacketEnqueueTime(*queue_ptr, prio_level)) >
                time_to_live) {
-      QueuedPacket packet = queue_ptr->DequeuePacket(prio_level);
-      RTC_LOG(LS_INFO) << "Dropping old packet on SSRC: "
-                       << packet.packet->Ssrc()
-                       << " seq:" << packet.packet->SequenceNumber()
-                       << " time in queue:" << (now - packet.enqueue_time).ms()
+      Timestamp enqueue_time = LeadingPacketEnqueueTime(*queue_ptr, prio_level);
+      std::unique_ptr<RtpPacketToSend> packet =
+          DequeuePacket(*queue_ptr, prio_level);
+      RTC_LOG(LS_INFO) << "Dropping old packet on SSRC: " << packet->Ssrc()
+                       << " seq:" << packet->SequenceNumber()
+                       << " time in queue:" << (now - enqueue_time).ms()
                        << " ms";
-      DequeuePacketInternal(packet);
     }
     if (!queue_ptr->HasPacketsAtPrio(prio_level)) {
-      iter = queues.erase(iter);
-    } else {
-      ++iter;
+      RemoveStream(*queue_ptr, prio_level);
     }
+    queue_ptr = next;
   }
 }
 
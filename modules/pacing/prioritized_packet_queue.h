@@ -14,10 +14,9 @@
 #include <stddef.h>
 
 #include <array>
-#include <deque>
-#include <list>
 #include <memory>
 #include <unordered_map>
+#include <vector>
 
 #include "absl/container/inlined_vector.h"
 #include "api/units/data_size.h"
@@ -102,49 +101,67 @@ class PrioritizedPacketQueue {
 
  private:
   static constexpr int kNumPriorityLevels = 5;
+  // Index into `packets_` of no packet.
+  static constexpr int kNoPacket = -1;
 
-  class QueuedPacket {
-   public:
+  // A packet in the queue, linked into the queue of its stream and priority
+  // level and into the list of all packets in enqueue order. Unused entries
+  // are linked into the free list.
+  struct QueuedPacket {
     DataSize PacketSize() const;
 
     std::unique_ptr<RtpPacketToSend> packet;
-    Timestamp enqueue_time;
-    std::list<Timestamp>::iterator enqueue_time_iterator;
+    // The enqueue time, with the pause time up to then subtracted.
+    Timestamp enqueue_time = Timestamp::MinusInfinity();
+    // The enqueue time as given to Push().
+    Timestamp push_time = Timestamp::MinusInfinity();
+    // Next packet of the same stream and priority level, or of the free list.
+    int next = kNoPacket;
+    // Adjacent packets in enqueue order.
+    int older = kNoPacket;
+    int newer = kNoPacket;
   };
 
-  // Class containing packets for an RTP stream.
-  // For each priority level, packets are simply stored in a fifo queue.
-  class StreamQueue {
-   public:
+  // Packets of an RTP stream, in one FIFO queue per priority level.
+  struct StreamQueue {
     explicit StreamQueue(Timestamp creation_time);
-    StreamQueue(StreamQueue&&) = default;
-    StreamQueue& operator=(StreamQueue&&) = default;
 
-    StreamQueue(const StreamQueue&) = delete;
-    StreamQueue& operator=(const StreamQueue&) = delete;
+    bool HasPacketsAtPrio(int priority_level) const {
+      return first_packet[priority_level] != kNoPacket;
+    }
+    bool IsEmpty() const;
 
-    // Enqueue packet at the given priority level. Returns true if the packet
-    // count for that priority level went from zero to non-zero.
-    bool EnqueuePacket(QueuedPacket packet, int priority_level);
+    int first_packet[kNumPriorityLevels];
+    int last_packet[kNumPriorityLevels];
+    Timestamp last_enqueue_time;
+    int num_keyframe_packets = 0;
+    // Adjacent streams in the round-robin list of streams with packets, per
+    // priority level.
+    StreamQueue* previous_stream[kNumPriorityLevels] = {};
+    StreamQueue* next_stream[kNumPriorityLevels] = {};
+  };
 
-    QueuedPacket DequeuePacket(int priority_level);
+  // Round-robin list of the streams with packets at a priority level.
+  struct StreamList {
+    bool empty() const { return front == nullptr; }
 
-    bool HasPacketsAtPrio(int priority_level) const;
-    bool IsEmpty() const;
-    Timestamp LeadingPacketEnqueueTime(int priority_level) const;
-    Timestamp LastEnqueueTime() const;
-    bool has_keyframe_packets() const { return num_keyframe_packets_ > 0; }
+    StreamQueue* front = nullptr;
+    StreamQueue* back = nullptr;
+  };
 
-    std::array<std::deque<QueuedPacket>, kNumPriorityLevels> DequeueAll();
+  // Takes an unused entry of `packets_`, growing it if there is none.
+  int AllocatePacket();
 
-   private:
-    std::deque<QueuedPacket> packets_[kNumPriorityLevels];
-    Timestamp last_enqueue_time_;
-    int num_keyframe_packets_;
-  };
+  Timestamp LeadingPacketEnqueueTime(const StreamQueue& stream,
+                                     int priority_level) const;
+
+  // Remove the first packet of `stream` at `priority_level` from the queue
+  // and from the internal state, e.g. queue time / size etc.
+  std::unique_ptr<RtpPacketToSend> DequeuePacket(StreamQueue& stream,
+                                                 int priority_level);
 
-  // Remove the packet from the internal state, e.g. queue time / size etc.
-  void DequeuePacketInternal(QueuedPacket& packet);
+  void AppendStream(StreamQueue& stream, int priority_level);
+  void RemoveStream(StreamQueue& stream, int priority_level);
 
   // Check if the queue pointed to by `top_active_prio_level_` is empty and
   // if so move it to the lowest non-empty index.
@@ -179,17 +196,23 @@ class PrioritizedPacketQueue {
   // Map from SSRC to packet queues for the associated RTP stream.
   std::unordered_map<uint32_t, std::unique_ptr<StreamQueue>> streams_;
 
-  // For each priority level, a queue of StreamQueues which have at least one
-  // packet pending for that prio level.
-  std::deque<StreamQueue*> streams_by_prio_[kNumPriorityLevels];
+  // For each priority level, the StreamQueues which have at least one packet
+  // pending for that prio level.
+  StreamList streams_by_prio_[kNumPriorityLevels];
 
   // The first index into `stream_by_prio_` that is non-empty.
   int top_active_prio_level_;
 
-  // Ordered list of enqueue times. Additions are always increasing and added to
-  // the end. QueuedPacket instances have a iterators into this list for fast
-  // removal.
-  std::list<Timestamp> enqueue_times_;
+  // Storage of the queued packets, which the queues link by index so that
+  // pushing and popping packets doesn't allocate once it has grown to the
+  // largest queue size.
+  std::vector<QueuedPacket> packets_;
+  int first_free_packet_ = kNoPacket;
+
+  // The oldest and newest packets. Additions are always increasing in time
+  // and added as the newest.
+  int oldest_packet_ = kNoPacket;
+  int newest_packet_ = kNoPacket;
 };
 
 }  // namespace webrtc
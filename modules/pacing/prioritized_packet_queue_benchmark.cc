@@ -0,0 +1,121 @@
+/*
+ *  Copyright 2024 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "api/units/time_delta.h"
+#include "api/units/timestamp.h"
+#include "benchmark/benchmark.h"
+#include "modules/pacing/prioritized_packet_queue.h"
+#include "modules/rtp_rtcp/include/rtp_rtcp_defines.h"
+#include "modules/rtp_rtcp/source/rtp_packet_to_send.h"
+#include "rtc_base/checks.h"
+
+namespace webrtc {
+namespace {
+
+constexpr int kNumPackets = 10000;
+constexpr int kNumSsrcs = 50;
+constexpr uint32_t kFirstSsrc = 1000;
+
+// Mostly video, with some retransmissions and audio, spread over the SSRCs.
+std::vector<std::unique_ptr<RtpPacketToSend>> CreatePackets() {
+  std::vector<std::unique_ptr<RtpPacketToSend>> packets;
+  for (int i = 0; i < kNumPackets; ++i) {
+    auto packet = std::make_unique<RtpPacketToSend>(/*extensions=*/nullptr);
+    packet->set_packet_type(RtpPacketMediaType::kVideo);
+    if (i % 10 == 0) {
+      packet->set_packet_type(RtpPacketMediaType::kRetransmission);
+    } else if (i % 10 == 1) {
+      packet->set_packet_type(RtpPacketMediaType::kAudio);
+    }
+    packet->SetSsrc(kFirstSsrc + i % kNumSsrcs);
+    packet->SetSequenceNumber(i);
+    packet->SetPayloadSize(1000);
+    packet->set_is_key_frame(i % 100 == 2);
+    packets.push_back(std::move(packet));
+  }
+  return packets;
+}
+
+// Pops and pushes back packets with `kNumPackets` queued, as a pacer that
+// keeps up with a sender does.
+void BM_PushPopAtDepth(benchmark::State& state) {
+  Timestamp now = Timestamp::Seconds(1);
+  PrioritizedPacketQueue queue(now);
+  for (auto& packet : CreatePackets()) {
+    queue.Push(now, std::move(packet));
+  }
+
+  for (auto _ : state) {
+    now += TimeDelta::Micros(10);
+    queue.UpdateAverageQueueTime(now);
+    std::unique_ptr<RtpPacketToSend> packet = queue.Pop();
+    queue.Push(now, std::move(packet));
+    benchmark::DoNotOptimize(queue.AverageQueueTime());
+  }
+}
+
+// Fills the queue with `kNumPackets` and drains it.
+void BM_FillAndDrain(benchmark::State& state) {
+  Timestamp now = Timestamp::Seconds(1);
+  PrioritizedPacketQueue queue(now);
+  std::vector<std::unique_ptr<RtpPacketToSend>> packets = CreatePackets();
+
+  for (auto _ : state) {
+    for (auto& packet : packets) {
+      now += TimeDelta::Micros(1);
+      queue.Push(now, std::move(packet));
+    }
+    for (auto& packet : packets) {
+      packet = queue.Pop();
+    }
+    RTC_CHECK(queue.Empty());
+  }
+  state.SetItemsProcessed(state.iterations() * kNumPackets);
+}
+
+// Removes the packets of one of the SSRCs from a full queue.
+void BM_RemovePacketsForSsrc(benchmark::State& state) {
+  Timestamp now = Timestamp::Seconds(1);
+  PrioritizedPacketQueue queue(now);
+  std::vector<std::unique_ptr<RtpPacketToSend>> packets = CreatePackets();
+  for (auto& packet : packets) {
+    queue.Push(now, std::move(packet));
+  }
+
+  int i = 0;
+  for (auto _ : state) {
+    const uint32_t ssrc = kFirstSsrc + i++ % kNumSsrcs;
+    queue.RemovePacketsForSsrc(ssrc);
+    state.PauseTiming();
+    // Put packets of the SSRC back, so that each iteration removes as many.
+    for (int j = ssrc - kFirstSsrc; j < kNumPackets; j += kNumSsrcs) {
+      auto packet = std::make_unique<RtpPacketToSend>(/*extensions=*/nullptr);
+      packet->set_packet_type(RtpPacketMediaType::kVideo);
+      packet->SetSsrc(ssrc);
+      packet->SetPayloadSize(1000);
+      queue.Push(now, std::move(packet));
+    }
+    state.ResumeTiming();
+  }
+}
+
+BENCHMARK(BM_PushPopAtDepth);
+BENCHMARK(BM_FillAndDrain);
+BENCHMARK(BM_RemovePacketsForSsrc);
+
+}  // namespace
+}  // namespace webrtc
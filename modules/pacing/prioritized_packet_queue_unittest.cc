@@ -430,6 +430,33 @@ TEST(PrioritizedPacketQueue, ClearPacketsAffectsOnlySpecifiedSsrc) {
   EXPECT_TRUE(queue.Empty());
 }
 
+TEST(PrioritizedPacketQueue, ClearPacketsKeepsRoundRobinOrderOfOtherSsrcs) {
+  Timestamp now = Timestamp::Zero();
+  PrioritizedPacketQueue queue(now);
+
+  // Three streams with two video packets each, queued in round-robin order.
+  for (uint16_t seq = 0; seq < 2; ++seq) {
+    for (uint32_t ssrc = 1; ssrc <= 3; ++ssrc) {
+      queue.Push(now, CreatePacket(RtpPacketMediaType::kVideo,
+                                   /*seq=*/10 * ssrc + seq, ssrc));
+    }
+  }
+
+  // Removing the middle stream leaves the others in order, and the queue
+  // keeps working as packets are pushed into the released space.
+  queue.RemovePacketsForSsrc(2);
+  EXPECT_EQ(queue.SizeInPackets(), 4);
+  queue.Push(now, CreatePacket(RtpPacketMediaType::kVideo, /*seq=*/20,
+                               /*ssrc=*/2));
+  EXPECT_EQ(queue.Pop()->SequenceNumber(), 10);
+  EXPECT_EQ(queue.Pop()->SequenceNumber(), 30);
+  EXPECT_EQ(queue.Pop()->SequenceNumber(), 20);
+  EXPECT_EQ(queue.Pop()->SequenceNumber(), 11);
+  EXPECT_EQ(queue.Pop()->SequenceNumber(), 31);
+  EXPECT_TRUE(queue.Empty());
+  EXPECT_EQ(queue.OldestEnqueueTime(), Timestamp::MinusInfinity());
+}
+
 TEST(PrioritizedPacketQueue, ReportsKeyframePackets) {
   Timestamp now = Timestamp::Zero();
   PrioritizedPacketQueue queue(now);
@@ -28,7 +28,8 @@ TaskQueuePacedSender::TaskQueuePacedSender(
     PacingController::PacketSender* packet_sender,
     const FieldTrialsView& field_trials,
     TimeDelta max_hold_back_window,
-    int max_hold_back_window_in_packets)
+    int max_hold_back_window_in_packets,
+    PacerScheduler* scheduler)
     : clock_(clock),
       max_hold_back_window_(max_hold_back_window),
       max_hold_back_window_in_packets_(max_hold_back_window_in_packets),
@@ -38,6 +39,7 @@ TaskQueuePacedSender::TaskQueuePacedSender(
       is_shutdown_(false),
       packet_size_(/*alpha=*/0.95),
       include_overhead_(false),
+      scheduler_(scheduler),
       task_queue_(TaskQueueBase::Current()) {
   RTC_DCHECK_GE(max_hold_back_window_, PacingController::kMinSleepTime);
 }
@@ -45,6 +47,9 @@ TaskQueuePacedSender::TaskQueuePacedSender(
 TaskQueuePacedSender::~TaskQueuePacedSender() {
   RTC_DCHECK_RUN_ON(task_queue_);
   is_shutdown_ = true;
+  if (scheduler_) {
+    scheduler_->Cancel(this);
+  }
 }
 
 void TaskQueuePacedSender::SetSendBurstInterval(TimeDelta burst_interval) {
@@ -264,16 +269,25 @@ void TaskQueuePacedSender::MaybeProcessPackets(
   // schedule a new one. Previous in flight task will be retired.
   if (next_process_time_.IsMinusInfinity() ||
       next_process_time_ > next_send_time) {
-    // Prefer low precision if allowed and not probing.
-    task_queue_->PostDelayedHighPrecisionTask(
-        SafeTask(
-            safety_.flag(),
-            [this, next_send_time]() { MaybeProcessPackets(next_send_time); }),
-        time_to_next_process.RoundUpTo(TimeDelta::Millis(1)));
+    if (scheduler_) {
+      scheduler_->Schedule(this, next_send_time);
+    } else {
+      // Prefer low precision if allowed and not probing.
+      task_queue_->PostDelayedHighPrecisionTask(
+          SafeTask(safety_.flag(),
+                   [this, next_send_time]() {
+                     MaybeProcessPackets(next_send_time);
+                   }),
+          time_to_next_process.RoundUpTo(TimeDelta::Millis(1)));
+    }
     next_process_time_ = next_send_time;
   }
 }
 
+void TaskQueuePacedSender::OnScheduledProcess(Timestamp scheduled_time) {
+  MaybeProcessPackets(scheduled_time);
+}
+
 void TaskQueuePacedSender::UpdateStats() {
   Stats new_stats;
   new_stats.expected_queue_time = pacing_controller_.ExpectedQueueTime();
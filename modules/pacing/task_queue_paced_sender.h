@@ -24,6 +24,7 @@
 #include "api/units/data_size.h"
 #include "api/units/time_delta.h"
 #include "api/units/timestamp.h"
+#include "modules/pacing/pacer_scheduler.h"
 #include "modules/pacing/pacing_controller.h"
 #include "modules/pacing/rtp_packet_pacer.h"
 #include "modules/rtp_rtcp/source/rtp_packet_to_send.h"
@@ -34,7 +35,9 @@
 namespace webrtc {
 class Clock;
 
-class TaskQueuePacedSender : public RtpPacketPacer, public RtpPacketSender {
+class TaskQueuePacedSender : public RtpPacketPacer,
+                             public RtpPacketSender,
+                             public PacerScheduler::Client {
  public:
   static const int kNoPacketHoldback;
 
@@ -47,11 +50,16 @@ class TaskQueuePacedSender : public RtpPacketPacer, public RtpPacketSender {
   //
   // The taskqueue used when constructing a TaskQueuePacedSender will also be
   // used for pacing.
+  //
+  // If `scheduler` is set, the delayed processing of the pacer is scheduled
+  // through it, together with that of the other pacers on the task queue,
+  // instead of with a delayed task of its own.
   TaskQueuePacedSender(Clock* clock,
                        PacingController::PacketSender* packet_sender,
                        const FieldTrialsView& field_trials,
                        TimeDelta max_hold_back_window,
-                       int max_hold_back_window_in_packets);
+                       int max_hold_back_window_in_packets,
+                       PacerScheduler* scheduler = nullptr);
 
   ~TaskQueuePacedSender() override;
 
@@ -142,6 +150,9 @@ class TaskQueuePacedSender : public RtpPacketPacer, public RtpPacketSender {
   // method again with desired (finite) scheduled process time.
   void MaybeProcessPackets(Timestamp scheduled_process_time);
 
+  // Implements PacerScheduler::Client.
+  void OnScheduledProcess(Timestamp scheduled_time) override;
+
   void UpdateStats() RTC_RUN_ON(task_queue_);
   Stats GetStats() const;
 
@@ -178,6 +189,7 @@ class TaskQueuePacedSender : public RtpPacketPacer, public RtpPacketSender {
   // Protects against ProcessPackets reentry from packet sent receipts.
   bool processing_packets_ RTC_GUARDED_BY(task_queue_) = false;
 
+  PacerScheduler* const scheduler_;
   ScopedTaskSafety safety_;
   TaskQueueBase* task_queue_;
 };
@@ -25,6 +25,7 @@
 #include "api/units/data_rate.h"
 #include "api/units/data_size.h"
 #include "api/units/time_delta.h"
+#include "modules/pacing/pacer_scheduler.h"
 #include "modules/pacing/pacing_controller.h"
 #include "modules/pacing/packet_router.h"
 #include "modules/rtp_rtcp/include/rtp_rtcp_defines.h"
@@ -164,6 +165,51 @@ TEST(TaskQueuePacedSenderTest, PacesPackets) {
   EXPECT_NEAR((end_time - start_time).ms<double>(), 1000.0, 50.0);
 }
 
+TEST(TaskQueuePacedSenderTest, PacesPacketsOfPacersSharingScheduler) {
+  GlobalSimulatedTimeController time_controller(Timestamp::Millis(1234));
+  ScopedKeyValueConfig trials;
+  PacerScheduler scheduler(time_controller.GetClock());
+  MockPacketRouter packet_routers[2];
+  std::vector<std::unique_ptr<TaskQueuePacedSender>> pacers;
+  for (MockPacketRouter& packet_router : packet_routers) {
+    pacers.push_back(std::make_unique<TaskQueuePacedSender>(
+        time_controller.GetClock(), &packet_router, trials,
+        PacingController::kMinSleepTime,
+        TaskQueuePacedSender::kNoPacketHoldback, &scheduler));
+  }
+
+  // Insert packets covering one second at each pacer's own rate.
+  static constexpr size_t kPacketsToSend[] = {42, 84};
+  size_t packets_sent[] = {0, 0};
+  Timestamp end_time[] = {Timestamp::PlusInfinity(),
+                          Timestamp::PlusInfinity()};
+  for (size_t i = 0; i < pacers.size(); ++i) {
+    pacers[i]->SetPacingRates(
+        DataRate::BitsPerSec(kDefaultPacketSize * 8 * kPacketsToSend[i]),
+        DataRate::Zero());
+    pacers[i]->EnsureStarted();
+    pacers[i]->EnqueuePackets(
+        GeneratePackets(RtpPacketMediaType::kVideo, kPacketsToSend[i]));
+    EXPECT_CALL(packet_routers[i], SendPacket)
+        .WillRepeatedly([&, i](std::unique_ptr<RtpPacketToSend> packet,
+                               const PacedPacketInfo& cluster_info) {
+          if (++packets_sent[i] == kPacketsToSend[i]) {
+            end_time[i] = time_controller.GetClock()->CurrentTime();
+          }
+        });
+  }
+
+  const Timestamp start_time = time_controller.GetClock()->CurrentTime();
+  time_controller.AdvanceTime(TimeDelta::Seconds(1));
+  for (size_t i = 0; i < pacers.size(); ++i) {
+    EXPECT_EQ(packets_sent[i], kPacketsToSend[i]);
+    ASSERT_TRUE(end_time[i].IsFinite());
+    EXPECT_NEAR((end_time[i] - start_time).ms<double>(), 1000.0, 50.0);
+  }
+  // Both pacers are served by the same wakeups where their sends coincide.
+  EXPECT_LT(scheduler.num_wakeups(), kPacketsToSend[0] + kPacketsToSend[1]);
+}
+
 // Same test as above, but with 0.5s of burst applied.
 TEST(TaskQueuePacedSenderTest, PacesPacketsWithBurst) {
   GlobalSimulatedTimeController time_controller(Timestamp::Millis(1234));
@@ -195,6 +195,10 @@ struct RtpPacketSendInfo {
                                 const PacedPacketInfo& pacing_info);
 
   uint16_t transport_sequence_number = 0;
+  // SSRC and sequence number the packet is sent with. Differs from
+  // `media_ssrc` and `rtp_sequence_number` for retransmissions.
+  uint32_t ssrc = 0;
+  uint16_t sequence_number = 0;
   absl::optional<uint32_t> media_ssrc;
   uint16_t rtp_sequence_number = 0;  // Only valid if `media_ssrc` is set.
   uint32_t rtp_timestamp = 0;
@@ -0,0 +1,171 @@
+/*
+ *  Copyright 2024 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <memory>
+#include <vector>
+
+#include "api/array_view.h"
+#include "api/rtp_parameters.h"
+#include "benchmark/benchmark.h"
+#include "modules/include/module_fec_types.h"
+#include "modules/rtp_rtcp/include/flexfec_receiver.h"
+#include "modules/rtp_rtcp/include/flexfec_sender.h"
+#include "modules/rtp_rtcp/include/recovered_packet_receiver.h"
+#include "modules/rtp_rtcp/include/rtp_header_extension_map.h"
+#include "modules/rtp_rtcp/source/rtp_packet_received.h"
+#include "modules/rtp_rtcp/source/rtp_packet_to_send.h"
+#include "modules/rtp_rtcp/source/ulpfec_generator.h"
+#include "rtc_base/checks.h"
+#include "rtc_base/random.h"
+#include "system_wrappers/include/clock.h"
+
+namespace webrtc {
+namespace {
+
+constexpr uint32_t kMediaSsrc = 1234;
+constexpr uint32_t kFlexfecSsrc = 5678;
+constexpr int kMediaPayloadType = 96;
+constexpr int kRedPayloadType = 97;
+constexpr int kUlpfecPayloadType = 98;
+constexpr int kFlexfecPayloadType = 99;
+// Media packets per frame, protected at the highest rate, as screenshare
+// may be.
+constexpr size_t kNumMediaPackets = 12;
+constexpr uint8_t kFecRate = 255;
+
+// Benchmarks are parameterized on the payload size of the media packets and
+// the packet mask table.
+void FecArguments(benchmark::internal::Benchmark* benchmark) {
+  for (int mask_type : {kFecMaskRandom, kFecMaskBursty}) {
+    for (int payload_size : {100, 500, 1200}) {
+      benchmark->Args({payload_size, mask_type});
+    }
+  }
+}
+
+FecProtectionParams ProtectionParams(const benchmark::State& state) {
+  FecProtectionParams params;
+  params.fec_rate = kFecRate;
+  params.max_fec_frames = 1;
+  params.fec_mask_type = static_cast<FecMaskType>(state.range(1));
+  return params;
+}
+
+// One frame of media packets with random payloads.
+std::vector<RtpPacketToSend> CreateFrame(size_t payload_size) {
+  Random random(0x12345678);
+  std::vector<RtpPacketToSend> packets;
+  for (size_t i = 0; i < kNumMediaPackets; ++i) {
+    RtpPacketToSend packet(nullptr);
+    packet.SetPayloadType(kMediaPayloadType);
+    packet.SetSequenceNumber(1000 + i);
+    packet.SetTimestamp(90000);
+    packet.SetSsrc(kMediaSsrc);
+    packet.SetMarker(i == kNumMediaPackets - 1);
+    uint8_t* payload = packet.AllocatePayload(payload_size);
+    for (size_t j = 0; j < payload_size; ++j) {
+      payload[j] = random.Rand<uint8_t>();
+    }
+    packets.push_back(packet);
+  }
+  return packets;
+}
+
+std::unique_ptr<FlexfecSender> CreateFlexfecSender(Clock* clock) {
+  return std::make_unique<FlexfecSender>(
+      kFlexfecPayloadType, kFlexfecSsrc, kMediaSsrc, /*mid=*/"",
+      std::vector<RtpExtension>(), rtc::ArrayView<const RtpExtensionSize>(),
+      /*rtp_state=*/nullptr, clock);
+}
+
+class CountingRecoveredPacketReceiver : public RecoveredPacketReceiver {
+ public:
+  void OnRecoveredPacket(const RtpPacketReceived& packet) override {
+    ++num_recovered_packets_;
+  }
+
+  int num_recovered_packets() const { return num_recovered_packets_; }
+
+ private:
+  int num_recovered_packets_ = 0;
+};
+
+void BM_UlpfecGeneratorEncode(benchmark::State& state) {
+  SimulatedClock clock(1);
+  UlpfecGenerator generator(kRedPayloadType, kUlpfecPayloadType, &clock);
+  generator.SetProtectionParameters(ProtectionParams(state),
+                                    ProtectionParams(state));
+  std::vector<RtpPacketToSend> frame = CreateFrame(state.range(0));
+
+  for (auto _ : state) {
+    for (const RtpPacketToSend& packet : frame) {
+      generator.AddPacketAndGenerateFec(packet);
+    }
+    RTC_CHECK(!generator.GetFecPackets().empty());
+  }
+}
+
+void BM_FlexfecSenderEncode(benchmark::State& state) {
+  SimulatedClock clock(1);
+  std::unique_ptr<FlexfecSender> sender = CreateFlexfecSender(&clock);
+  sender->SetProtectionParameters(ProtectionParams(state),
+                                  ProtectionParams(state));
+  std::vector<RtpPacketToSend> frame = CreateFrame(state.range(0));
+
+  for (auto _ : state) {
+    for (const RtpPacketToSend& packet : frame) {
+      sender->AddPacketAndGenerateFec(packet);
+    }
+    RTC_CHECK(!sender->GetFecPackets().empty());
+  }
+}
+
+// Recovers the first media packet of a frame from the others and the FlexFEC
+// packets protecting them.
+void BM_FlexfecReceiverRecovery(benchmark::State& state) {
+  SimulatedClock clock(1);
+  std::unique_ptr<FlexfecSender> sender = CreateFlexfecSender(&clock);
+  sender->SetProtectionParameters(ProtectionParams(state),
+                                  ProtectionParams(state));
+  std::vector<RtpPacketReceived> received_packets;
+  for (const RtpPacketToSend& packet : CreateFrame(state.range(0))) {
+    sender->AddPacketAndGenerateFec(packet);
+    if (packet.SequenceNumber() != 1000) {
+      RtpPacketReceived received_packet;
+      RTC_CHECK(received_packet.Parse(packet.Buffer()));
+      received_packets.push_back(received_packet);
+    }
+  }
+  for (const auto& fec_packet : sender->GetFecPackets()) {
+    RtpPacketReceived received_packet;
+    RTC_CHECK(received_packet.Parse(fec_packet->Buffer()));
+    received_packets.push_back(received_packet);
+  }
+
+  for (auto _ : state) {
+    CountingRecoveredPacketReceiver recovered_packet_receiver;
+    FlexfecReceiver receiver(&clock, kFlexfecSsrc, kMediaSsrc,
+                             &recovered_packet_receiver);
+    for (const RtpPacketReceived& packet : received_packets) {
+      receiver.OnRtpPacket(packet);
+    }
+    RTC_CHECK_EQ(recovered_packet_receiver.num_recovered_packets(), 1);
+  }
+}
+
+BENCHMARK(BM_UlpfecGeneratorEncode)->Apply(FecArguments);
+BENCHMARK(BM_FlexfecSenderEncode)->Apply(FecArguments);
+BENCHMARK(BM_FlexfecReceiverRecovery)->Apply(FecArguments);
+
+}  // namespace
+}  // namespace webrtc
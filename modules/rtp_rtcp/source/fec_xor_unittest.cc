@@ -0,0 +1,90 @@
+/*
+ *  Copyright (c) 2024 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "modules/rtp_rtcp/source/fec_xor.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <vector>
+
+#include "rtc_base/random.h"
+#include "rtc_base/system/arch.h"
+#include "test/gtest.h"
+
+#if defined(WEBRTC_HAS_NEON)
+#include "modules/rtp_rtcp/source/fec_xor_neon.h"
+#elif defined(WEBRTC_ARCH_X86_FAMILY)
+#include "modules/rtp_rtcp/source/fec_xor_avx2.h"
+#include "modules/rtp_rtcp/source/fec_xor_sse2.h"
+#include "system_wrappers/include/cpu_features_wrapper.h"
+#endif
+
+namespace webrtc {
+namespace {
+
+using XorBytesFunction = void (*)(const uint8_t*, size_t, uint8_t*);
+
+// Checks `xor_bytes` against a byte-wise XOR, for all lengths up to a few
+// vectors and all alignments within a vector, leaving the bytes past the end
+// untouched.
+void VerifyXorBytes(XorBytesFunction xor_bytes) {
+  constexpr size_t kMaxLength = 100;
+  constexpr size_t kMaxOffset = 32;
+  constexpr size_t kSize = kMaxOffset + kMaxLength + 1;
+  Random random(0x12345678);
+  for (size_t offset = 0; offset < kMaxOffset; ++offset) {
+    for (size_t length = 0; length <= kMaxLength; ++length) {
+      std::vector<uint8_t> src(kSize);
+      std::vector<uint8_t> dst(kSize);
+      for (size_t i = 0; i < kSize; ++i) {
+        src[i] = random.Rand<uint8_t>();
+        dst[i] = random.Rand<uint8_t>();
+      }
+      std::vector<uint8_t> expected = dst;
+      for (size_t i = offset; i < offset + length; ++i) {
+        expected[i] ^= src[i];
+      }
+      xor_bytes(src.data() + offset, length, dst.data() + offset);
+      ASSERT_EQ(dst, expected) << "offset " << offset << ", length " << length;
+    }
+  }
+}
+
+TEST(FecXorTest, XorBytes) {
+  VerifyXorBytes(&XorBytes);
+}
+
+TEST(FecXorTest, XorBytesC) {
+  VerifyXorBytes(&XorBytes_C);
+}
+
+#if defined(WEBRTC_HAS_NEON)
+TEST(FecXorTest, XorBytesNeon) {
+  VerifyXorBytes(&XorBytes_NEON);
+}
+#elif defined(WEBRTC_ARCH_X86_FAMILY)
+TEST(FecXorTest, XorBytesSse2) {
+  if (!GetCPUInfo(kSSE2)) {
+    GTEST_SKIP() << "SSE2 not supported";
+  }
+  VerifyXorBytes(&XorBytes_SSE2);
+}
+
+TEST(FecXorTest, XorBytesAvx2) {
+  if (!GetCPUInfo(kAVX2)) {
+    GTEST_SKIP() << "AVX2 not supported";
+  }
+  VerifyXorBytes(&XorBytes_AVX2);
+}
+#endif
+
+}  // namespace
+}  // namespace webrtc
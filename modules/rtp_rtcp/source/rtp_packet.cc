@@ -67,6 +67,14 @@ RtpPacket::RtpPacket(const ExtensionManager* extensions, size_t capacity)
   Clear();
 }
 
+RtpPacket::RtpPacket(const ExtensionManager* extensions,
+                     rtc::CopyOnWriteBuffer buffer)
+    : extensions_(extensions ? *extensions : ExtensionManager()),
+      buffer_(std::move(buffer)) {
+  RTC_DCHECK_GE(buffer_.capacity(), kFixedHeaderSize);
+  Clear();
+}
+
 RtpPacket::RtpPacket(const RtpPacket&) = default;
 RtpPacket::RtpPacket(RtpPacket&&) = default;
 RtpPacket& RtpPacket::operator=(const RtpPacket&) = default;
@@ -77,6 +85,12 @@ void RtpPacket::IdentifyExtensions(ExtensionManager extensions) {
   extensions_ = std::move(extensions);
 }
 
+void RtpPacket::MoveToBuffer(rtc::CopyOnWriteBuffer buffer) {
+  RTC_DCHECK_GE(buffer.capacity(), capacity());
+  buffer.SetData(buffer_.cdata(), buffer_.size());
+  buffer_ = std::move(buffer);
+}
+
 bool RtpPacket::Parse(const uint8_t* buffer, size_t buffer_size) {
   if (!ParseBuffer(buffer, buffer_size)) {
     Clear();
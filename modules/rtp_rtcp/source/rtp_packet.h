@@ -14,6 +14,7 @@
 #include <utility>
 #include <vector>
 
+#include "absl/container/inlined_vector.h"
 #include "absl/types/optional.h"
 #include "api/array_view.h"
 #include "modules/rtp_rtcp/include/rtp_header_extension_map.h"
@@ -36,6 +37,9 @@ class RtpPacket {
   RtpPacket();
   explicit RtpPacket(const ExtensionManager* extensions);
   RtpPacket(const ExtensionManager* extensions, size_t capacity);
+  // Writes the packet to `buffer`, whose capacity becomes the capacity of the
+  // packet. `buffer` must not be shared.
+  RtpPacket(const ExtensionManager* extensions, rtc::CopyOnWriteBuffer buffer);
 
   RtpPacket(const RtpPacket&);
   RtpPacket(RtpPacket&&);
@@ -57,6 +61,11 @@ class RtpPacket {
   // Maps extensions id to their types.
   void IdentifyExtensions(ExtensionManager extensions);
 
+  // Copies the packet to `buffer` and writes to it from now on, so that the
+  // packet stops sharing its buffer with copies of it. `buffer` must not be
+  // shared and must have at least capacity() bytes of capacity.
+  void MoveToBuffer(rtc::CopyOnWriteBuffer buffer);
+
   // Returns the extension map used for identifying extensions in this packet.
   const ExtensionManager& extension_manager() const { return extensions_; }
 
@@ -216,7 +225,9 @@ class RtpPacket {
   size_t payload_size_;
 
   ExtensionManager extensions_;
-  std::vector<ExtensionInfo> extension_entries_;
+  // Sized to hold every one-byte header extension id without allocating, so
+  // that parsing and copying received packets stays off the heap.
+  absl::InlinedVector<ExtensionInfo, 14> extension_entries_;
   size_t extensions_size_ = 0;  // Unaligned.
   rtc::CopyOnWriteBuffer buffer_;
 };
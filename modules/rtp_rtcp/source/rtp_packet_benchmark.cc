@@ -0,0 +1,123 @@
+/*
+ *  Copyright 2024 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <utility>
+
+#include "api/units/timestamp.h"
+#include "benchmark/benchmark.h"
+#include "modules/rtp_rtcp/include/rtp_header_extension_map.h"
+#include "modules/rtp_rtcp/source/rtp_header_extensions.h"
+#include "modules/rtp_rtcp/source/rtp_packet_received.h"
+#include "modules/rtp_rtcp/source/rtp_packet_to_send.h"
+#include "rtc_base/checks.h"
+#include "rtc_base/copy_on_write_buffer.h"
+#include "rtc_base/system/unused.h"
+
+namespace webrtc {
+namespace {
+
+constexpr size_t kPayloadSize = 1200;
+
+RtpHeaderExtensionMap ExtensionMap() {
+  RtpHeaderExtensionMap extensions;
+  extensions.Register<TransmissionOffset>(1);
+  extensions.Register<AbsoluteSendTime>(2);
+  extensions.Register<TransportSequenceNumber>(3);
+  extensions.Register<VideoOrientation>(4);
+  extensions.Register<PlayoutDelayLimits>(5);
+  extensions.Register<VideoContentTypeExtension>(6);
+  extensions.Register<RtpMid>(7);
+  extensions.Register<AbsoluteCaptureTimeExtension>(8);
+  return extensions;
+}
+
+// A video packet with the first `num_extensions` extensions of
+// ExtensionMap().
+rtc::CopyOnWriteBuffer CreatePacket(const RtpHeaderExtensionMap& extensions,
+                                    int num_extensions) {
+  RtpPacketToSend packet(&extensions);
+  packet.SetPayloadType(96);
+  packet.SetSequenceNumber(1234);
+  packet.SetTimestamp(0x12345678);
+  packet.SetSsrc(0x11223344);
+  bool written = true;
+  if (num_extensions > 0)
+    written &= packet.SetExtension<TransmissionOffset>(100);
+  if (num_extensions > 1)
+    written &= packet.SetExtension<AbsoluteSendTime>(0x123456);
+  if (num_extensions > 2)
+    written &= packet.SetExtension<TransportSequenceNumber>(4321);
+  if (num_extensions > 3)
+    written &= packet.SetExtension<VideoOrientation>(kVideoRotation_90);
+  if (num_extensions > 4)
+    written &= packet.SetExtension<PlayoutDelayLimits>(VideoPlayoutDelay());
+  if (num_extensions > 5)
+    written &= packet.SetExtension<VideoContentTypeExtension>(
+        VideoContentType::UNSPECIFIED);
+  if (num_extensions > 6)
+    written &= packet.SetExtension<RtpMid>("video");
+  if (num_extensions > 7)
+    written &= packet.SetExtension<AbsoluteCaptureTimeExtension>(
+        AbsoluteCaptureTime{.absolute_capture_timestamp = 1});
+  RTC_CHECK(written);
+  packet.AllocatePayload(kPayloadSize);
+  return packet.Buffer();
+}
+
+// Parses a received packet the way RtpTransport does before demuxing.
+void BM_Parse(benchmark::State& state) {
+  RtpHeaderExtensionMap extensions = ExtensionMap();
+  rtc::CopyOnWriteBuffer buffer = CreatePacket(extensions, state.range(0));
+  for (auto s : state) {
+    RTC_UNUSED(s);
+    RtpPacketReceived packet(&extensions, Timestamp::Zero());
+    bool parsed = packet.Parse(buffer);
+    benchmark::DoNotOptimize(parsed);
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
+// Copies a parsed packet, as done when it is posted from the network thread
+// to the worker thread.
+void BM_Copy(benchmark::State& state) {
+  RtpHeaderExtensionMap extensions = ExtensionMap();
+  RtpPacketReceived packet(&extensions, Timestamp::Zero());
+  RTC_CHECK(packet.Parse(CreatePacket(extensions, state.range(0))));
+  for (auto s : state) {
+    RTC_UNUSED(s);
+    RtpPacketReceived copy = packet;
+    benchmark::DoNotOptimize(copy);
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
+// Reads the extensions a receive stream and the bandwidth estimator use.
+void BM_GetExtensions(benchmark::State& state) {
+  RtpHeaderExtensionMap extensions = ExtensionMap();
+  RtpPacketReceived packet(&extensions, Timestamp::Zero());
+  RTC_CHECK(packet.Parse(CreatePacket(extensions, state.range(0))));
+  for (auto s : state) {
+    RTC_UNUSED(s);
+    benchmark::DoNotOptimize(packet.GetExtension<TransportSequenceNumber>());
+    benchmark::DoNotOptimize(packet.GetExtension<AbsoluteSendTime>());
+    benchmark::DoNotOptimize(packet.GetExtension<VideoOrientation>());
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK(BM_Parse)->Arg(0)->Arg(4)->Arg(8);
+BENCHMARK(BM_Copy)->Arg(0)->Arg(4)->Arg(8);
+BENCHMARK(BM_GetExtensions)->Arg(4)->Arg(8);
+
+}  // namespace
+}  // namespace webrtc
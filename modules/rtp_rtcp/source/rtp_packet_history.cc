@@ -28,6 +28,11 @@ namespace {
 
 constexpr size_t kOldPayloadPaddingSizeHysteresis = 100;
 constexpr uint16_t kMaxOldPayloadPaddingSequenceNumber = 1 << 13;
+// Initial size of the ring of stored packets, which doubles as needed.
+constexpr size_t kMinRingSize = 64;
+// Packets spanning more sequence numbers than this are not kept together,
+// since the ring index would become ambiguous.
+constexpr size_t kMaxSlots = 1 << 15;
 
 }  // namespace
 
@@ -103,27 +108,37 @@ void RtpPacketHistory::PutRtpPacket(std::unique_ptr<RtpPacketToSend> packet,
   // Store packet.
   const uint16_t rtp_seq_no = packet->SequenceNumber();
   int packet_index = GetPacketIndex(rtp_seq_no);
-  if (packet_index >= 0 &&
-      static_cast<size_t>(packet_index) < packet_history_.size() &&
-      packet_history_[packet_index].packet_ != nullptr) {
+  if (packet_index >= 0 && static_cast<size_t>(packet_index) < num_slots_ &&
+      Slot(packet_index).packet_ != nullptr) {
     RTC_LOG(LS_WARNING) << "Duplicate packet inserted: " << rtp_seq_no;
     // Remove previous packet to avoid inconsistent state.
     RemovePacket(packet_index);
     packet_index = GetPacketIndex(rtp_seq_no);
   }
 
-  // Packet to be inserted ahead of first packet, expand front.
-  for (; packet_index < 0; ++packet_index) {
-    packet_history_.emplace_front();
+  size_t num_slots = packet_index < 0 ? num_slots_ - packet_index
+                                      : std::max<size_t>(num_slots_,
+                                                         packet_index + 1);
+  if (num_slots > kMaxSlots) {
+    RTC_LOG(LS_WARNING) << "Sequence number jump to " << rtp_seq_no
+                        << ", dropping the packets stored before it.";
+    while (num_slots_ > 0) {
+      RemovePacket(0);
+    }
+    packet_index = 0;
+    num_slots = 1;
   }
-  // Packet to be inserted behind last packet, expand back.
-  while (static_cast<int>(packet_history_.size()) <= packet_index) {
-    packet_history_.emplace_back();
+  EnsureRingSize(num_slots);
+  if (packet_index < 0 || num_slots_ == 0) {
+    // Packet to be inserted ahead of first packet, or in an empty history.
+    first_sequence_number_ = rtp_seq_no;
+    packet_index = 0;
   }
+  num_slots_ = num_slots;
 
   RTC_DCHECK_GE(packet_index, 0);
-  RTC_DCHECK_LT(packet_index, packet_history_.size());
-  RTC_DCHECK(packet_history_[packet_index].packet_ == nullptr);
+  RTC_DCHECK_LT(packet_index, num_slots_);
+  RTC_DCHECK(Slot(packet_index).packet_ == nullptr);
 
   if (padding_mode_ == PaddingMode::kRecentLargePacket) {
     if ((!large_payload_packet_ ||
@@ -136,7 +151,8 @@ void RtpPacketHistory::PutRtpPacket(std::unique_ptr<RtpPacketToSend> packet,
     }
   }
 
-  packet_history_[packet_index] =
+  stored_bytes_ += packet->size();
+  Slot(packet_index) =
       StoredPacket(std::move(packet), send_time, packets_inserted_++);
 }
 
@@ -207,11 +223,10 @@ bool RtpPacketHistory::GetPacketState(uint16_t sequence_number) const {
   }
 
   int packet_index = GetPacketIndex(sequence_number);
-  if (packet_index < 0 ||
-      static_cast<size_t>(packet_index) >= packet_history_.size()) {
+  if (packet_index < 0 || static_cast<size_t>(packet_index) >= num_slots_) {
     return false;
   }
-  const StoredPacket& packet = packet_history_[packet_index];
+  const StoredPacket& packet = Slot(packet_index);
   if (packet.packet_ == nullptr) {
     return false;
   }
@@ -255,20 +270,11 @@ std::unique_ptr<RtpPacketToSend> RtpPacketHistory::GetPayloadPaddingPacket(
     return encapsulate(*large_payload_packet_);
   }
 
-  StoredPacket* best_packet = nullptr;
-  if (!packet_history_.empty()) {
-    // Pick the last packet.
-    for (auto it = packet_history_.rbegin(); it != packet_history_.rend();
-         ++it) {
-      if (it->packet_ != nullptr) {
-        best_packet = &(*it);
-        break;
-      }
-    }
-  }
-  if (best_packet == nullptr) {
+  if (num_slots_ == 0) {
     return nullptr;
   }
+  // Pick the last packet.
+  StoredPacket* best_packet = &Slot(num_slots_ - 1);
 
   if (best_packet->pending_transmission_) {
     // Because PacedSender releases it's lock when it calls
@@ -294,8 +300,7 @@ void RtpPacketHistory::CullAcknowledgedPackets(
   MutexLock lock(&lock_);
   for (uint16_t sequence_number : sequence_numbers) {
     int packet_index = GetPacketIndex(sequence_number);
-    if (packet_index < 0 ||
-        static_cast<size_t>(packet_index) >= packet_history_.size()) {
+    if (packet_index < 0 || static_cast<size_t>(packet_index) >= num_slots_) {
       continue;
     }
     RemovePacket(packet_index);
@@ -309,6 +314,8 @@ void RtpPacketHistory::Clear() {
 
 void RtpPacketHistory::Reset() {
   packet_history_.clear();
+  num_slots_ = 0;
+  stored_bytes_ = 0;
   large_payload_packet_ = absl::nullopt;
 }
 
@@ -318,15 +325,15 @@ void RtpPacketHistory::CullOldPackets() {
       rtt_.IsFinite()
           ? std::max(kMinPacketDurationRtt * rtt_, kMinPacketDuration)
           : kMinPacketDuration;
-  while (!packet_history_.empty()) {
-    if (packet_history_.size() >= kMaxCapacity) {
+  while (num_slots_ > 0) {
+    if (num_slots_ >= kMaxCapacity || stored_bytes_ > kMaxStoredBytes) {
       // We have reached the absolute max capacity, remove one packet
       // unconditionally.
       RemovePacket(0);
       continue;
     }
 
-    const StoredPacket& stored_packet = packet_history_.front();
+    const StoredPacket& stored_packet = Slot(0);
     if (stored_packet.pending_transmission_) {
       // Don't remove packets in the pacer queue, pending tranmission.
       return;
@@ -337,7 +344,7 @@ void RtpPacketHistory::CullOldPackets() {
       return;
     }
 
-    if (packet_history_.size() >= number_to_store_ ||
+    if (num_slots_ >= number_to_store_ ||
         stored_packet.send_time() +
                 (packet_duration * kPacketCullingDelayFactor) <=
             now) {
@@ -355,11 +362,20 @@ std::unique_ptr<RtpPacketToSend> RtpPacketHistory::RemovePacket(
     int packet_index) {
   // Move the packet out from the StoredPacket container.
   std::unique_ptr<RtpPacketToSend> rtp_packet =
-      std::move(packet_history_[packet_index].packet_);
+      std::move(Slot(packet_index).packet_);
+  if (rtp_packet) {
+    stored_bytes_ -= rtp_packet->size();
+  }
+  // Keep the first and last slot populated.
+  if (static_cast<size_t>(packet_index) == num_slots_ - 1) {
+    while (num_slots_ > 0 && Slot(num_slots_ - 1).packet_ == nullptr) {
+      --num_slots_;
+    }
+  }
   if (packet_index == 0) {
-    while (!packet_history_.empty() &&
-           packet_history_.front().packet_ == nullptr) {
-      packet_history_.pop_front();
+    while (num_slots_ > 0 && Slot(0).packet_ == nullptr) {
+      ++first_sequence_number_;
+      --num_slots_;
     }
   }
 
@@ -367,12 +383,12 @@ std::unique_ptr<RtpPacketToSend> RtpPacketHistory::RemovePacket(
 }
 
 int RtpPacketHistory::GetPacketIndex(uint16_t sequence_number) const {
-  if (packet_history_.empty()) {
+  if (num_slots_ == 0) {
     return 0;
   }
 
-  RTC_DCHECK(packet_history_.front().packet_ != nullptr);
-  int first_seq = packet_history_.front().packet_->SequenceNumber();
+  RTC_DCHECK(Slot(0).packet_ != nullptr);
+  int first_seq = first_sequence_number_;
   if (first_seq == sequence_number) {
     return 0;
   }
@@ -393,14 +409,50 @@ int RtpPacketHistory::GetPacketIndex(uint16_t sequence_number) const {
   return packet_index;
 }
 
+RtpPacketHistory::StoredPacket& RtpPacketHistory::Slot(int packet_index) {
+  RTC_DCHECK_GE(packet_index, 0);
+  RTC_DCHECK_LT(packet_index, num_slots_);
+  return packet_history_[(first_sequence_number_ + packet_index) &
+                         (packet_history_.size() - 1)];
+}
+
+const RtpPacketHistory::StoredPacket& RtpPacketHistory::Slot(
+    int packet_index) const {
+  RTC_DCHECK_GE(packet_index, 0);
+  RTC_DCHECK_LT(packet_index, num_slots_);
+  return packet_history_[(first_sequence_number_ + packet_index) &
+                         (packet_history_.size() - 1)];
+}
+
+void RtpPacketHistory::EnsureRingSize(size_t num_slots) {
+  RTC_DCHECK_LE(num_slots, kMaxSlots);
+  if (num_slots <= packet_history_.size()) {
+    return;
+  }
+  size_t ring_size = std::max(packet_history_.size(), kMinRingSize);
+  while (ring_size < num_slots) {
+    ring_size *= 2;
+  }
+  // Sequence numbers wrap at a multiple of the ring size, so a packet stays
+  // in the slot of its sequence number across wrap-arounds.
+  std::vector<StoredPacket> ring(ring_size);
+  for (StoredPacket& stored_packet : packet_history_) {
+    if (stored_packet.packet_ != nullptr) {
+      ring[stored_packet.packet_->SequenceNumber() & (ring_size - 1)] =
+          std::move(stored_packet);
+    }
+  }
+  packet_history_ = std::move(ring);
+}
+
 RtpPacketHistory::StoredPacket* RtpPacketHistory::GetStoredPacket(
     uint16_t sequence_number) {
   int index = GetPacketIndex(sequence_number);
-  if (index < 0 || static_cast<size_t>(index) >= packet_history_.size() ||
-      packet_history_[index].packet_ == nullptr) {
+  if (index < 0 || static_cast<size_t>(index) >= num_slots_ ||
+      Slot(index).packet_ == nullptr) {
     return nullptr;
   }
-  return &packet_history_[index];
+  return &Slot(index);
 }
 
 }  // namespace webrtc
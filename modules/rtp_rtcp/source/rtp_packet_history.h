@@ -11,7 +11,6 @@
 #ifndef MODULES_RTP_RTCP_SOURCE_RTP_PACKET_HISTORY_H_
 #define MODULES_RTP_RTCP_SOURCE_RTP_PACKET_HISTORY_H_
 
-#include <deque>
 #include <map>
 #include <memory>
 #include <set>
@@ -48,6 +47,10 @@ class RtpPacketHistory {
 
   // Maximum number of packets we ever allow in the history.
   static constexpr size_t kMaxCapacity = 9600;
+  // Maximum total size of the packets in the history, enough to keep
+  // kMinPacketDuration of 32 Mbps media. Beyond it the oldest packets are
+  // removed, like beyond kMaxCapacity.
+  static constexpr size_t kMaxStoredBytes = 4 * 1024 * 1024;
   // Maximum number of entries in prioritized queue of padding packets.
   static constexpr size_t kMaxPaddingHistory = 63;
   // Don't remove packets within max(1 second, 3x RTT).
@@ -167,8 +170,15 @@ class RtpPacketHistory {
   // stored. Returns the RTP packet instance contained within the StoredPacket.
   std::unique_ptr<RtpPacketToSend> RemovePacket(int packet_index)
       RTC_EXCLUSIVE_LOCKS_REQUIRED(lock_);
+  // Returns the position of `sequence_number` relative to the oldest packet.
   int GetPacketIndex(uint16_t sequence_number) const
       RTC_EXCLUSIVE_LOCKS_REQUIRED(lock_);
+  // Returns the slot at `packet_index`, which must be in [0, num_slots_).
+  StoredPacket& Slot(int packet_index) RTC_EXCLUSIVE_LOCKS_REQUIRED(lock_);
+  const StoredPacket& Slot(int packet_index) const
+      RTC_EXCLUSIVE_LOCKS_REQUIRED(lock_);
+  // Grows the ring to hold at least `num_slots` consecutive sequence numbers.
+  void EnsureRingSize(size_t num_slots) RTC_EXCLUSIVE_LOCKS_REQUIRED(lock_);
   StoredPacket* GetStoredPacket(uint16_t sequence_number)
       RTC_EXCLUSIVE_LOCKS_REQUIRED(lock_);
 
@@ -179,13 +189,17 @@ class RtpPacketHistory {
   StorageMode mode_ RTC_GUARDED_BY(lock_);
   TimeDelta rtt_ RTC_GUARDED_BY(lock_);
 
-  // Queue of stored packets, ordered by sequence number, with older packets in
-  // the front and new packets being added to the back. Note that there may be
-  // wrap-arounds so the back may have a lower sequence number.
-  // Packets may also be removed out-of-order, in which case there will be
-  // instances of StoredPacket with `packet_` set to nullptr. The first and last
-  // entry in the queue will however always be populated.
-  std::deque<StoredPacket> packet_history_ RTC_GUARDED_BY(lock_);
+  // Ring of stored packets, indexed by sequence number modulo its size, which
+  // is a power of two. The history spans `num_slots_` sequence numbers from
+  // `first_sequence_number_`. Packets may be removed out-of-order, in which
+  // case there will be slots in the span with `packet_` set to nullptr. The
+  // first and last slot in the span will however always be populated, and
+  // slots outside of it are empty.
+  std::vector<StoredPacket> packet_history_ RTC_GUARDED_BY(lock_);
+  uint16_t first_sequence_number_ RTC_GUARDED_BY(lock_) = 0;
+  size_t num_slots_ RTC_GUARDED_BY(lock_) = 0;
+  // Total size of the stored packets.
+  size_t stored_bytes_ RTC_GUARDED_BY(lock_) = 0;
 
   // Total number of packets with inserted.
   uint64_t packets_inserted_ RTC_GUARDED_BY(lock_);
@@ -244,6 +244,58 @@ TEST_P(RtpPacketHistoryTest, RemovesOldestPacketWhenAtMaxCapacity) {
   EXPECT_TRUE(hist_.GetPacketState(To16u(kStartSeqNum + 1)));
 }
 
+TEST_P(RtpPacketHistoryTest, RemovesOldestPacketWhenAtMaxStoredBytes) {
+  // Tests the absolute upper bound on the size of stored packets.
+  const size_t kPayloadSize = 1200;
+  hist_.SetStorePacketsStatus(StorageMode::kStoreAndCull,
+                              RtpPacketHistory::kMaxCapacity);
+
+  // Add packets until the total size exceeds the limit.
+  size_t stored_bytes = 0;
+  size_t num_packets = 0;
+  while (stored_bytes <= RtpPacketHistory::kMaxStoredBytes) {
+    std::unique_ptr<RtpPacketToSend> packet =
+        CreateRtpPacket(To16u(kStartSeqNum + num_packets));
+    packet->SetPayloadSize(kPayloadSize);
+    stored_bytes += packet->size();
+    hist_.PutRtpPacket(std::move(packet), fake_clock_.CurrentTime());
+    // Mark packets as pending, preventing it from being removed.
+    hist_.GetPacketAndMarkAsPending(To16u(kStartSeqNum + num_packets));
+    ++num_packets;
+  }
+  ASSERT_LT(num_packets, RtpPacketHistory::kMaxCapacity);
+
+  // First packet should still be there.
+  EXPECT_TRUE(hist_.GetPacketState(kStartSeqNum));
+
+  // History is full, oldest one should be overwritten.
+  std::unique_ptr<RtpPacketToSend> packet =
+      CreateRtpPacket(To16u(kStartSeqNum + num_packets));
+  packet->SetPayloadSize(kPayloadSize);
+  hist_.PutRtpPacket(std::move(packet), fake_clock_.CurrentTime());
+
+  // Oldest packet should be gone, but packet after than one still present.
+  EXPECT_FALSE(hist_.GetPacketState(kStartSeqNum));
+  EXPECT_TRUE(hist_.GetPacketState(To16u(kStartSeqNum + 1)));
+}
+
+TEST_P(RtpPacketHistoryTest, DropsPacketsOnLargeSequenceNumberJump) {
+  hist_.SetStorePacketsStatus(StorageMode::kStoreAndCull,
+                              RtpPacketHistory::kMaxCapacity);
+  hist_.PutRtpPacket(CreateRtpPacket(kStartSeqNum), fake_clock_.CurrentTime());
+  hist_.PutRtpPacket(CreateRtpPacket(To16u(kStartSeqNum + 5000)),
+                     fake_clock_.CurrentTime());
+  EXPECT_TRUE(hist_.GetPacketState(kStartSeqNum));
+
+  // Keeping all of them would span more than half of the sequence number
+  // space.
+  hist_.PutRtpPacket(CreateRtpPacket(To16u(kStartSeqNum - 30000)),
+                     fake_clock_.CurrentTime());
+  EXPECT_FALSE(hist_.GetPacketState(kStartSeqNum));
+  EXPECT_FALSE(hist_.GetPacketState(To16u(kStartSeqNum + 5000)));
+  EXPECT_TRUE(hist_.GetPacketState(To16u(kStartSeqNum - 30000)));
+}
+
 TEST_P(RtpPacketHistoryTest, DontRemoveTooRecentlyTransmittedPackets) {
   // Set size to remove old packets as soon as possible.
   hist_.SetStorePacketsStatus(StorageMode::kStoreAndCull, 1);
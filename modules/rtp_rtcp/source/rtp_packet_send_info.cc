@@ -31,6 +31,8 @@ RtpPacketSendInfo RtpPacketSendInfo::From(const RtpPacketToSend& packet,
     }
   }
 
+  packet_info.ssrc = packet.Ssrc();
+  packet_info.sequence_number = packet.SequenceNumber();
   packet_info.rtp_timestamp = packet.Timestamp();
   packet_info.length = packet.size();
   packet_info.pacing_info = pacing_info;
@@ -25,6 +25,7 @@
 #include "modules/rtp_rtcp/include/rtp_rtcp_defines.h"
 #include "modules/rtp_rtcp/source/rtp_header_extensions.h"
 #include "modules/rtp_rtcp/source/rtp_packet.h"
+#include "rtc_base/copy_on_write_buffer.h"
 
 namespace webrtc {
 // Class to hold rtp packet with metadata for sender side.
@@ -37,6 +38,8 @@ class RtpPacketToSend : public RtpPacket {
 
   explicit RtpPacketToSend(const ExtensionManager* extensions);
   RtpPacketToSend(const ExtensionManager* extensions, size_t capacity);
+  RtpPacketToSend(const ExtensionManager* extensions,
+                  rtc::CopyOnWriteBuffer buffer);
   RtpPacketToSend(const RtpPacketToSend& packet);
   RtpPacketToSend(RtpPacketToSend&& packet);
 
@@ -133,6 +136,11 @@ class RtpPacketToSend : public RtpPacket {
   void set_is_red(bool is_red) { is_red_ = is_red; }
   bool is_red() const { return is_red_; }
 
+  // Indicates if the packet should be sent with the ECN codepoint ECT(1),
+  // marking it as L4S capable (RFC 9331).
+  void set_send_as_ect1(bool send_as_ect1) { send_as_ect1_ = send_as_ect1; }
+  bool send_as_ect1() const { return send_as_ect1_; }
+
   // The amount of time spent in the send queue, used for totalPacketSendDelay.
   // https://w3c.github.io/webrtc-stats/#dom-rtcoutboundrtpstreamstats-totalpacketsenddelay
   void set_time_in_send_queue(TimeDelta time_in_send_queue) {
@@ -163,6 +171,7 @@ class RtpPacketToSend : public RtpPacket {
   bool is_key_frame_ = false;
   bool fec_protect_packet_ = false;
   bool is_red_ = false;
+  bool send_as_ect1_ = false;
   absl::optional<TimeDelta> time_in_send_queue_;
 };
 
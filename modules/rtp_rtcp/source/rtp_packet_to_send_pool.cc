@@ -0,0 +1,86 @@
+/*
+ *  Copyright (c) 2024 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "modules/rtp_rtcp/source/rtp_packet_to_send_pool.h"
+
+#include <utility>
+
+#include "rtc_base/checks.h"
+
+namespace webrtc {
+
+// static
+rtc::scoped_refptr<RtpPacketToSendPool> RtpPacketToSendPool::Create() {
+  return rtc::scoped_refptr<RtpPacketToSendPool>(new RtpPacketToSendPool());
+}
+
+RtpPacketToSendPool::~RtpPacketToSendPool() {
+  for (Storage* storage : free_buffers_) {
+    delete storage;
+  }
+}
+
+std::unique_ptr<RtpPacketToSend> RtpPacketToSendPool::Allocate(
+    const RtpPacket::ExtensionManager* extensions,
+    size_t capacity) {
+  return std::make_unique<RtpPacketToSend>(extensions,
+                                           AllocateBuffer(capacity));
+}
+
+std::unique_ptr<RtpPacketToSend> RtpPacketToSendPool::Copy(
+    const RtpPacketToSend& packet) {
+  auto copy = std::make_unique<RtpPacketToSend>(packet);
+  copy->MoveToBuffer(AllocateBuffer(packet.capacity()));
+  return copy;
+}
+
+size_t RtpPacketToSendPool::free_buffers() const {
+  MutexLock lock(&mutex_);
+  return free_buffers_.size();
+}
+
+rtc::CopyOnWriteBuffer RtpPacketToSendPool::AllocateBuffer(size_t capacity) {
+  Storage* storage = nullptr;
+  {
+    MutexLock lock(&mutex_);
+    while (!storage && !free_buffers_.empty()) {
+      storage = free_buffers_.back();
+      free_buffers_.pop_back();
+      // Buffers of another capacity are left over from before the maximum
+      // packet size changed.
+      if (storage->capacity() != capacity) {
+        delete storage;
+        storage = nullptr;
+      }
+    }
+  }
+  if (!storage) {
+    storage = new Storage(0, capacity);
+    storage->set_recycler(this);
+  }
+  // Each outstanding buffer holds a reference, released in Recycle().
+  AddRef();
+  return rtc::CopyOnWriteBuffer(rtc::scoped_refptr<Storage>(storage), 0);
+}
+
+void RtpPacketToSendPool::Recycle(Storage* storage) {
+  {
+    MutexLock lock(&mutex_);
+    if (free_buffers_.size() < kMaxFreeBuffers) {
+      free_buffers_.push_back(storage);
+      storage = nullptr;
+    }
+  }
+  delete storage;
+  // May delete the pool if it was only kept alive by this buffer.
+  Release();
+}
+
+}  // namespace webrtc
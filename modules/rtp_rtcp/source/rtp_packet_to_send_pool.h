@@ -0,0 +1,78 @@
+/*
+ *  Copyright (c) 2024 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef MODULES_RTP_RTCP_SOURCE_RTP_PACKET_TO_SEND_POOL_H_
+#define MODULES_RTP_RTCP_SOURCE_RTP_PACKET_TO_SEND_POOL_H_
+
+#include <stddef.h>
+
+#include <memory>
+#include <vector>
+
+#include "api/ref_counted_base.h"
+#include "api/scoped_refptr.h"
+#include "modules/rtp_rtcp/source/rtp_packet.h"
+#include "modules/rtp_rtcp/source/rtp_packet_to_send.h"
+#include "rtc_base/copy_on_write_buffer.h"
+#include "rtc_base/synchronization/mutex.h"
+#include "rtc_base/thread_annotations.h"
+
+namespace webrtc {
+
+// Recycles the buffers of outgoing RTP packets. The buffer of a packet made by
+// the pool goes back to it when the last packet sharing it is destroyed,
+// which is when RtpSenderEgress has sent a packet that is not kept for
+// retransmission, or when RtpPacketHistory drops it.
+//
+// Packets are typically made on the encoder queue and released on the worker
+// queue, so the pool is thread safe. Outstanding buffers keep the pool alive.
+class RtpPacketToSendPool : public RefCountedBase,
+                            private rtc::CopyOnWriteBuffer::StorageRecycler {
+ public:
+  // Number of free buffers kept for reuse, beyond which released buffers are
+  // deleted.
+  static constexpr size_t kMaxFreeBuffers = 128;
+
+  static rtc::scoped_refptr<RtpPacketToSendPool> Create();
+
+  // Returns an empty packet with room for `capacity` bytes.
+  std::unique_ptr<RtpPacketToSend> Allocate(
+      const RtpPacket::ExtensionManager* extensions,
+      size_t capacity);
+
+  // Returns a copy of `packet` in its own buffer, so that writing to the copy
+  // does not need to unshare the buffer of `packet`.
+  std::unique_ptr<RtpPacketToSend> Copy(const RtpPacketToSend& packet);
+
+  // Number of buffers waiting to be reused.
+  size_t free_buffers() const;
+
+ protected:
+  ~RtpPacketToSendPool() override;
+
+ private:
+  using Storage = rtc::CopyOnWriteBuffer::Storage;
+
+  RtpPacketToSendPool() = default;
+
+  // Returns an empty buffer of exactly `capacity` bytes of capacity, as the
+  // capacity of a packet limits how large it may grow.
+  rtc::CopyOnWriteBuffer AllocateBuffer(size_t capacity);
+
+  // rtc::CopyOnWriteBuffer::StorageRecycler:
+  void Recycle(Storage* storage) override;
+
+  mutable Mutex mutex_;
+  std::vector<Storage*> free_buffers_ RTC_GUARDED_BY(mutex_);
+};
+
+}  // namespace webrtc
+
+#endif  // MODULES_RTP_RTCP_SOURCE_RTP_PACKET_TO_SEND_POOL_H_
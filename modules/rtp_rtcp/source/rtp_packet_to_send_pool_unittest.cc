@@ -0,0 +1,110 @@
+/*
+ *  Copyright (c) 2024 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "modules/rtp_rtcp/source/rtp_packet_to_send_pool.h"
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "api/scoped_refptr.h"
+#include "modules/rtp_rtcp/source/rtp_packet_to_send.h"
+#include "test/gtest.h"
+
+namespace webrtc {
+namespace {
+
+constexpr size_t kCapacity = 1200;
+constexpr size_t kPayloadSize = 100;
+
+TEST(RtpPacketToSendPoolTest, AllocatesEmptyPacketWithCapacity) {
+  auto pool = RtpPacketToSendPool::Create();
+  std::unique_ptr<RtpPacketToSend> packet = pool->Allocate(nullptr, kCapacity);
+  EXPECT_EQ(packet->capacity(), kCapacity);
+  EXPECT_EQ(packet->headers_size(), 12u);
+  EXPECT_EQ(packet->payload_size(), 0u);
+  EXPECT_EQ(packet->data()[0], 0x80);
+}
+
+TEST(RtpPacketToSendPoolTest, ReusesBufferOfDestroyedPacket) {
+  auto pool = RtpPacketToSendPool::Create();
+  std::unique_ptr<RtpPacketToSend> packet = pool->Allocate(nullptr, kCapacity);
+  packet->AllocatePayload(kPayloadSize);
+  const uint8_t* data = packet->data();
+  packet = nullptr;
+  EXPECT_EQ(pool->free_buffers(), 1u);
+
+  packet = pool->Allocate(nullptr, kCapacity);
+  EXPECT_EQ(packet->data(), data);
+  EXPECT_EQ(packet->payload_size(), 0u);
+  EXPECT_EQ(pool->free_buffers(), 0u);
+}
+
+TEST(RtpPacketToSendPoolTest, CopyHasItsOwnBuffer) {
+  auto pool = RtpPacketToSendPool::Create();
+  std::unique_ptr<RtpPacketToSend> packet = pool->Allocate(nullptr, kCapacity);
+  packet->SetSequenceNumber(1);
+  packet->set_allow_retransmission(true);
+
+  std::unique_ptr<RtpPacketToSend> copy = pool->Copy(*packet);
+  EXPECT_NE(copy->data(), packet->data());
+  EXPECT_EQ(copy->Buffer(), packet->Buffer());
+  EXPECT_EQ(copy->capacity(), kCapacity);
+  EXPECT_TRUE(copy->allow_retransmission());
+
+  copy->SetSequenceNumber(2);
+  EXPECT_EQ(packet->SequenceNumber(), 1);
+}
+
+TEST(RtpPacketToSendPoolTest, ReturnsBufferWhenLastSharingPacketIsDestroyed) {
+  auto pool = RtpPacketToSendPool::Create();
+  std::unique_ptr<RtpPacketToSend> packet = pool->Allocate(nullptr, kCapacity);
+  // Like the copy that RtpSenderEgress keeps in the packet history.
+  auto history_copy = std::make_unique<RtpPacketToSend>(*packet);
+
+  packet = nullptr;
+  EXPECT_EQ(pool->free_buffers(), 0u);
+  history_copy = nullptr;
+  EXPECT_EQ(pool->free_buffers(), 1u);
+}
+
+TEST(RtpPacketToSendPoolTest, DropsBuffersOfAnotherCapacity) {
+  auto pool = RtpPacketToSendPool::Create();
+  pool->Allocate(nullptr, kCapacity);
+  EXPECT_EQ(pool->free_buffers(), 1u);
+
+  std::unique_ptr<RtpPacketToSend> packet =
+      pool->Allocate(nullptr, kCapacity / 2);
+  EXPECT_EQ(packet->capacity(), kCapacity / 2);
+  EXPECT_EQ(pool->free_buffers(), 0u);
+}
+
+TEST(RtpPacketToSendPoolTest, KeepsAtMostMaxFreeBuffers) {
+  auto pool = RtpPacketToSendPool::Create();
+  std::vector<std::unique_ptr<RtpPacketToSend>> packets;
+  for (size_t i = 0; i < RtpPacketToSendPool::kMaxFreeBuffers + 1; ++i) {
+    packets.push_back(pool->Allocate(nullptr, kCapacity));
+  }
+  packets.clear();
+  EXPECT_EQ(pool->free_buffers(), RtpPacketToSendPool::kMaxFreeBuffers);
+}
+
+TEST(RtpPacketToSendPoolTest, PacketsOutliveThePool) {
+  auto pool = RtpPacketToSendPool::Create();
+  std::unique_ptr<RtpPacketToSend> packet = pool->Allocate(nullptr, kCapacity);
+  std::unique_ptr<RtpPacketToSend> copy = pool->Copy(*packet);
+  pool = nullptr;
+  packet->AllocatePayload(kPayloadSize);
+  packet = nullptr;
+  copy = nullptr;
+}
+
+}  // namespace
+}  // namespace webrtc
@@ -712,6 +712,32 @@ TEST(RtpPacketTest, ParseSecondPacketWithFewerExtensions) {
   EXPECT_FALSE(packet.HasExtension<AudioLevelExtension>());
 }
 
+TEST(RtpPacketTest, ParseAndCopyWithMoreExtensionsThanStoredInline) {
+  constexpr int kNumExtensions = 20;
+  constexpr uint8_t kLastId = kNumExtensions;
+  // 19 one byte extensions and a transmission offset, with two-byte headers.
+  constexpr size_t kExtensionsSize = (kNumExtensions - 1) * 3 + 5;
+  constexpr size_t kPaddedExtensionsSize = (kExtensionsSize + 3) / 4 * 4;
+  std::vector<uint8_t> buffer(kMinimumPacket,
+                              kMinimumPacket + sizeof(kMinimumPacket));
+  buffer[0] |= 0x10;
+  buffer.insert(buffer.end(), {0x10, 0x00, 0x00, kPaddedExtensionsSize / 4});
+  for (uint8_t id = 1; id < kLastId; ++id) {
+    buffer.insert(buffer.end(), {id, 0x01, id});
+  }
+  buffer.insert(buffer.end(), {kLastId, 0x03, 0x00, 0x56, 0xce});
+  buffer.resize(buffer.size() + kPaddedExtensionsSize - kExtensionsSize);
+
+  RtpPacketToSend::ExtensionManager extensions(/*extmap_allow_mixed=*/true);
+  extensions.Register<TransmissionOffset>(kLastId);
+  RtpPacketReceived packet(&extensions);
+  ASSERT_TRUE(packet.Parse(buffer.data(), buffer.size()));
+  EXPECT_EQ(packet.GetExtension<TransmissionOffset>(), kTimeOffset);
+
+  RtpPacketReceived copy = packet;
+  EXPECT_EQ(copy.GetExtension<TransmissionOffset>(), kTimeOffset);
+}
+
 TEST(RtpPacketTest, ParseWith2ExtensionsInvalidPadding) {
   RtpPacketToSend::ExtensionManager extensions;
   extensions.Register<TransmissionOffset>(kTransmissionOffsetExtensionId);
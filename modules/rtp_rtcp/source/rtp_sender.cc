@@ -153,6 +153,7 @@ RTPSender::RTPSender(const RtpRtcpInterface::Configuration& config,
                                          : absl::nullopt),
       packet_history_(packet_history),
       paced_sender_(packet_sender),
+      packet_pool_(RtpPacketToSendPool::Create()),
       sending_media_(true),                   // Default to sending media.
       max_packet_size_(IP_PACKET_SIZE - 28),  // Default is IP-v4/UDP.
       rtp_header_extension_map_(config.extmap_allow_mixed),
@@ -496,8 +497,8 @@ std::unique_ptr<RtpPacketToSend> RTPSender::AllocatePacket(
     max_num_csrcs_ = csrcs.size();
     UpdateHeaderSizes();
   }
-  auto packet = std::make_unique<RtpPacketToSend>(&rtp_header_extension_map_,
-                                                  max_packet_size_);
+  std::unique_ptr<RtpPacketToSend> packet =
+      packet_pool_->Allocate(&rtp_header_extension_map_, max_packet_size_);
   packet->SetSsrc(ssrc_);
   packet->SetCsrcs(csrcs);
 
@@ -530,6 +531,11 @@ std::unique_ptr<RtpPacketToSend> RTPSender::AllocatePacket(
   return packet;
 }
 
+std::unique_ptr<RtpPacketToSend> RTPSender::CopyPacket(
+    const RtpPacketToSend& packet) {
+  return packet_pool_->Copy(packet);
+}
+
 size_t RTPSender::RtxPacketOverhead() const {
   MutexLock lock(&send_mutex_);
   if (rtx_ == kRtxOff) {
@@ -659,8 +665,8 @@ std::unique_ptr<RtpPacketToSend> RTPSender::BuildRtxPacket(
     if (kv == rtx_payload_type_map_.end())
       return nullptr;
 
-    rtx_packet = std::make_unique<RtpPacketToSend>(&rtp_header_extension_map_,
-                                                   max_packet_size_);
+    rtx_packet =
+        packet_pool_->Allocate(&rtp_header_extension_map_, max_packet_size_);
 
     rtx_packet->SetPayloadType(kv->second);
 
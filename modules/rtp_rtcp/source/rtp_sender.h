@@ -22,11 +22,13 @@
 #include "api/array_view.h"
 #include "api/call/transport.h"
 #include "api/field_trials_view.h"
+#include "api/scoped_refptr.h"
 #include "modules/rtp_rtcp/include/flexfec_sender.h"
 #include "modules/rtp_rtcp/include/rtp_header_extension_map.h"
 #include "modules/rtp_rtcp/include/rtp_packet_sender.h"
 #include "modules/rtp_rtcp/include/rtp_rtcp_defines.h"
 #include "modules/rtp_rtcp/source/rtp_packet_history.h"
+#include "modules/rtp_rtcp/source/rtp_packet_to_send_pool.h"
 #include "modules/rtp_rtcp/source/rtp_rtcp_config.h"
 #include "modules/rtp_rtcp/source/rtp_rtcp_interface.h"
 #include "rtc_base/random.h"
@@ -129,6 +131,12 @@ class RTPSender {
   std::unique_ptr<RtpPacketToSend> AllocatePacket(
       rtc::ArrayView<const uint32_t> csrcs = {})
       RTC_LOCKS_EXCLUDED(send_mutex_);
+  // Returns a copy of `packet`, typically made by AllocatePacket(), that does
+  // not share its buffer. Use it rather than the copy constructor for packets
+  // that are written to after copying, such as the packets of a video frame.
+  // Both get their buffer from a pool, to which it returns after sending or
+  // when it leaves the packet history.
+  std::unique_ptr<RtpPacketToSend> CopyPacket(const RtpPacketToSend& packet);
 
   // Maximum header overhead per fec/padding packet.
   size_t FecOrPaddingPacketMaxRtpHeaderLength() const
@@ -177,6 +185,7 @@ class RTPSender {
 
   RtpPacketHistory* const packet_history_;
   RtpPacketSender* const paced_sender_;
+  const rtc::scoped_refptr<RtpPacketToSendPool> packet_pool_;
 
   mutable Mutex send_mutex_;
 
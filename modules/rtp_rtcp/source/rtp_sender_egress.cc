@@ -293,6 +293,7 @@ void RtpSenderEgress::CompleteSendPacket(const Packet& compound_packet,
   }
   options.batchable = enable_send_packet_batching_ && !is_audio_;
   options.last_packet_in_batch = last_in_batch;
+  options.send_as_ect1 = packet->send_as_ect1();
   const bool send_success = SendPacketToNetwork(*packet, options, pacing_info);
 
   // Put packet in retransmission history or update pending status even if
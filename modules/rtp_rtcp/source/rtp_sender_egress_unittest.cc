@@ -833,6 +833,18 @@ TEST_F(RtpSenderEgressTest,
   EXPECT_EQ(packet_options.packet_id, kTransportSequenceNumber);
 }
 
+TEST_F(RtpSenderEgressTest, SendPacketSetsPacketOptionsSendAsEct1) {
+  RtpSenderEgress sender(DefaultConfig(), &packet_history_);
+  std::unique_ptr<RtpPacketToSend> packet = BuildRtpPacket();
+  packet->set_send_as_ect1(true);
+
+  EXPECT_CALL(send_packet_observer_, OnSendPacket);
+  sender.SendPacket(std::move(packet), PacedPacketInfo());
+
+  ASSERT_TRUE(transport_.last_packet().has_value());
+  EXPECT_TRUE(transport_.last_packet()->options.send_as_ect1);
+}
+
 TEST_F(RtpSenderEgressTest, SendPacketUpdatesStats) {
   const size_t kPayloadSize = 1000;
 
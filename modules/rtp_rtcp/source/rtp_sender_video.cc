@@ -552,9 +552,9 @@ bool RTPSenderVideo::SendVideo(int payload_type,
             video_header.absolute_capture_time->estimated_capture_clock_offset);
   }
 
-  auto first_packet = std::make_unique<RtpPacketToSend>(*single_packet);
-  auto middle_packet = std::make_unique<RtpPacketToSend>(*single_packet);
-  auto last_packet = std::make_unique<RtpPacketToSend>(*single_packet);
+  auto first_packet = rtp_sender_->CopyPacket(*single_packet);
+  auto middle_packet = rtp_sender_->CopyPacket(*single_packet);
+  auto last_packet = rtp_sender_->CopyPacket(*single_packet);
   // Simplest way to estimate how much extensions would occupy is to set them.
   AddRtpHeaderExtensions(video_header,
                          /*first_packet=*/true, /*last_packet=*/true,
@@ -666,7 +666,7 @@ bool RTPSenderVideo::SendVideo(int payload_type,
       expected_payload_capacity =
           limits.max_payload_len - limits.last_packet_reduction_len;
     } else {
-      packet = std::make_unique<RtpPacketToSend>(*middle_packet);
+      packet = rtp_sender_->CopyPacket(*middle_packet);
       expected_payload_capacity = limits.max_payload_len;
     }
 
@@ -690,7 +690,8 @@ bool RTPSenderVideo::SendVideo(int payload_type,
     if (red_enabled()) {
       // TODO(sprang): Consider packetizing directly into packets with the RED
       // header already in place, to avoid this copy.
-      std::unique_ptr<RtpPacketToSend> red_packet(new RtpPacketToSend(*packet));
+      std::unique_ptr<RtpPacketToSend> red_packet =
+          rtp_sender_->CopyPacket(*packet);
       BuildRedPayload(*packet, red_packet.get());
       red_packet->SetPayloadType(*red_payload_type_);
       red_packet->set_is_red(true);
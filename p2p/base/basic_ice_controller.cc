@@ -10,11 +10,17 @@
 
 #include "p2p/base/basic_ice_controller.h"
 
+#include <tuple>
+
 namespace {
 
 // The minimum improvement in RTT that justifies a switch.
 const int kMinImprovement = 10;
 
+// The number of connections that SortAndSwitchConnection() moves one by one
+// before it sorts all of them.
+const size_t kMaxSortMoves = 16;
+
 bool IsRelayRelay(const cricket::Connection* conn) {
   return conn->local_candidate().is_relay() &&
          conn->remote_candidate().is_relay();
@@ -528,16 +534,68 @@ BasicIceController::SortAndSwitchConnection(IceSwitchReason reason) {
   // that amongst equal preference, writable connections, this will choose the
   // one whose estimated latency is lowest.  So it is the only one that we
   // need to consider switching to.
-  // TODO(honghaiz): Don't sort;  Just use std::max_element in the right places.
-  absl::c_stable_sort(
-      connections_, [this](const Connection* a, const Connection* b) {
-        int cmp = CompareConnections(a, b, absl::nullopt, nullptr);
-        if (cmp != 0) {
-          return cmp > 0;
-        }
-        // Otherwise, sort based on latency estimate.
-        return a->rtt() < b->rtt();
-      });
+  //
+  // `connections_` is still in the order of the previous sort, and usually
+  // only a few connections have changed since, e.g. one that received a ping
+  // response with a new RTT. Every connection is therefore only compared with
+  // its neighbours. The ones that became better than their predecessor or
+  // worse than their successor are taken out, and the others stay in sorted
+  // order. The ones taken out are put back after a binary search. If many
+  // connections moved, everything is sorted instead. Both yield the order of a
+  // stable sort by CompareConnections() and RTT.
+  const bool controlled = ice_role_func_() == ICEROLE_CONTROLLED;
+  sort_entries_.clear();
+  for (size_t i = 0; i < connections_.size(); ++i) {
+    sort_entries_.push_back(
+        {GetSortKey(connections_[i], controlled), i, connections_[i]});
+  }
+  // Fields for which lower values are better are compared the other way. Ties
+  // are broken by the previous position, as in a stable sort.
+  auto better = [](const SortEntry& a, const SortEntry& b) {
+    const SortKey& x = a.key;
+    const SortKey& y = b.key;
+    return std::tie(x.writable, y.write_state, x.receiving, x.connected,
+                    x.remote_nomination, x.last_data_received,
+                    x.preferred_network, x.vpn_rank, y.network_cost,
+                    x.priority, x.generation, y.pruned, y.rtt, b.index) >
+           std::tie(y.writable, x.write_state, y.receiving, y.connected,
+                    y.remote_nomination, y.last_data_received,
+                    y.preferred_network, y.vpn_rank, x.network_cost,
+                    y.priority, y.generation, x.pruned, x.rtt, a.index);
+  };
+  // A connection that is worse than its successor is only taken out if the
+  // successor fits after the predecessor. Otherwise the successor is the one
+  // that changed.
+  sort_moved_.clear();
+  auto sorted_end = sort_entries_.begin();
+  for (auto it = sort_entries_.begin(); it != sort_entries_.end(); ++it) {
+    bool moved =
+        sorted_end != sort_entries_.begin() && better(*it, *(sorted_end - 1));
+    if (!moved && it + 1 != sort_entries_.end() && better(*(it + 1), *it)) {
+      moved = sorted_end == sort_entries_.begin() ||
+              !better(*(it + 1), *(sorted_end - 1));
+    }
+    if (moved) {
+      sort_moved_.push_back(*it);
+    } else {
+      *sorted_end++ = *it;
+    }
+  }
+  if (sort_moved_.size() > kMaxSortMoves) {
+    std::copy(sort_moved_.begin(), sort_moved_.end(), sorted_end);
+    std::sort(sort_entries_.begin(), sort_entries_.end(), better);
+  } else {
+    for (const SortEntry& entry : sort_moved_) {
+      auto it = std::upper_bound(sort_entries_.begin(), sorted_end, entry,
+                                 better);
+      std::move_backward(it, sorted_end, sorted_end + 1);
+      *it = entry;
+      ++sorted_end;
+    }
+  }
+  for (size_t i = 0; i < sort_entries_.size(); ++i) {
+    connections_[i] = sort_entries_[i].connection;
+  }
 
   RTC_LOG(LS_VERBOSE) << "Sorting " << connections_.size()
                       << " available connections due to: "
@@ -729,6 +787,41 @@ int BasicIceController::CompareConnections(
   return CompareConnectionCandidates(a, b);
 }
 
+BasicIceController::SortKey BasicIceController::GetSortKey(
+    const Connection* conn,
+    bool controlled) const {
+  SortKey key;
+  key.writable = conn->writable() || PresumedWritable(conn);
+  key.write_state = conn->write_state();
+  key.receiving = conn->receiving();
+  // CompareConnectionStates() only compares this when both are writable.
+  key.connected =
+      conn->write_state() == Connection::STATE_WRITABLE && conn->connected();
+  key.remote_nomination = controlled ? conn->remote_nomination() : 0;
+  key.last_data_received = controlled ? conn->last_data_received() : 0;
+  key.preferred_network =
+      LocalCandidateUsesPreferredNetwork(conn, config_.network_preference);
+  key.vpn_rank = 0;
+  switch (config_.vpn_preference) {
+    case webrtc::VpnPreference::kOnlyUseVpn:
+    case webrtc::VpnPreference::kPreferVpn:
+      key.vpn_rank = conn->network()->IsVpn() ? 1 : 0;
+      break;
+    case webrtc::VpnPreference::kNeverUseVpn:
+    case webrtc::VpnPreference::kAvoidVpn:
+      key.vpn_rank = conn->network()->IsVpn() ? 0 : 1;
+      break;
+    default:
+      break;
+  }
+  key.network_cost = conn->ComputeNetworkCost();
+  key.priority = conn->priority();
+  key.generation = conn->remote_candidate().generation() + conn->generation();
+  key.pruned = is_connection_pruned_func_(conn);
+  key.rtt = conn->rtt();
+  return key;
+}
+
 int BasicIceController::CompareCandidatePairNetworks(
     const Connection* a,
     const Connection* b,
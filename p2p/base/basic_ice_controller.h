@@ -59,6 +59,8 @@ class BasicIceController : public IceControllerInterface {
   void MarkConnectionPinged(const Connection* conn) override;
 
  private:
+  friend class BasicIceControllerTest;
+
   // A transport channel is weak if the current best connection is either
   // not receiving or not writable, or if there is no best connection at all.
   bool weak() const {
@@ -138,6 +140,27 @@ class BasicIceController : public IceControllerInterface {
                          absl::optional<int64_t> receiving_unchanged_threshold,
                          bool* missed_receiving_unchanged_threshold) const;
 
+  // The criteria of CompareConnections() without a receiving threshold,
+  // followed by the RTT, evaluated for one connection. Comparing keys field by
+  // field is equivalent to comparing the connections, so sorting reads the
+  // state of each connection once instead of once per comparison.
+  struct SortKey {
+    bool writable;
+    int write_state;
+    bool receiving;
+    bool connected;
+    uint32_t remote_nomination;
+    int64_t last_data_received;
+    bool preferred_network;
+    int vpn_rank;
+    uint32_t network_cost;
+    uint64_t priority;
+    int generation;
+    bool pruned;
+    int rtt;
+  };
+  SortKey GetSortKey(const Connection* conn, bool controlled) const;
+
   SwitchResult HandleInitialSelectDampening(IceSwitchReason reason,
                                             const Connection* new_connection);
 
@@ -157,6 +180,15 @@ class BasicIceController : public IceControllerInterface {
   std::vector<const Connection*> connections_;
   std::set<const Connection*> pinged_connections_;
   std::set<const Connection*> unpinged_connections_;
+  // Scratch space of SortAndSwitchConnection(). `index` is the position in
+  // `connections_` before sorting.
+  struct SortEntry {
+    SortKey key;
+    size_t index;
+    const Connection* connection;
+  };
+  std::vector<SortEntry> sort_entries_;
+  std::vector<SortEntry> sort_moved_;
 
   // Timestamp for when we got the first selectable connection.
   int64_t initial_select_timestamp_ms_ = 0;
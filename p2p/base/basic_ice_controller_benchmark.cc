@@ -0,0 +1,190 @@
+/*
+ *  Copyright 2024 The WebRTC Project Authors. All rights reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <memory>
+#include <vector>
+
+#include "absl/strings/string_view.h"
+#include "api/candidate.h"
+#include "benchmark/benchmark.h"
+#include "p2p/base/basic_ice_controller.h"
+#include "p2p/base/basic_packet_socket_factory.h"
+#include "p2p/base/connection.h"
+#include "p2p/base/ice_controller_factory_interface.h"
+#include "p2p/base/ice_switch_reason.h"
+#include "p2p/base/ice_transport_internal.h"
+#include "p2p/base/p2p_constants.h"
+#include "p2p/base/p2p_transport_channel_ice_field_trials.h"
+#include "p2p/base/port.h"
+#include "p2p/base/port_interface.h"
+#include "p2p/base/transport_description.h"
+#include "rtc_base/async_packet_socket.h"
+#include "rtc_base/ip_address.h"
+#include "rtc_base/network.h"
+#include "rtc_base/network/sent_packet.h"
+#include "rtc_base/socket_address.h"
+#include "rtc_base/system/unused.h"
+#include "rtc_base/thread.h"
+#include "rtc_base/virtual_socket_server.h"
+
+namespace cricket {
+namespace {
+
+constexpr uint32_t kRemotePriority = 2130706431;
+
+// A host port without a socket, whose connections drop every packet.
+class NullPort : public Port {
+ public:
+  explicit NullPort(const PortParametersRef& args)
+      : Port(args, webrtc::IceCandidateType::kHost) {}
+
+  void PrepareAddress() override {
+    rtc::SocketAddress address(Network()->GetBestIP(), 10000);
+    AddAddress(address, address, rtc::SocketAddress(), UDP_PROTOCOL_NAME, "",
+               "", type(), ICE_TYPE_PREFERENCE_HOST, 0, "", true);
+  }
+  bool SupportsProtocol(absl::string_view protocol) const override {
+    return true;
+  }
+  ProtocolType GetProtocol() const override { return PROTO_UDP; }
+  Connection* CreateConnection(const Candidate& remote_candidate,
+                               CandidateOrigin origin) override {
+    Connection* connection =
+        new ProxyConnection(NewWeakPtr(), 0, remote_candidate);
+    AddOrReplaceConnection(connection);
+    return connection;
+  }
+  int SendTo(const void* data,
+             size_t size,
+             const rtc::SocketAddress& address,
+             const rtc::PacketOptions& options,
+             bool payload) override {
+    return static_cast<int>(size);
+  }
+  int SetOption(rtc::Socket::Option opt, int value) override { return 0; }
+  int GetOption(rtc::Socket::Option opt, int* value) override { return -1; }
+  int GetError() override { return 0; }
+  void OnSentPacket(rtc::AsyncPacketSocket* socket,
+                    const rtc::SentPacket& sent_packet) override {}
+};
+
+// A controller with `num_connections` writable connections to remote
+// candidates of equal priority, so that they are ranked by RTT.
+class ControllerFixture {
+ public:
+  explicit ControllerFixture(int num_connections)
+      : main_thread_(&socket_server_),
+        socket_factory_(&socket_server_),
+        network_("eth0", "eth0", rtc::IPAddress(0x0A000000), 8),
+        controller_(IceControllerFactoryArgs{
+            .ice_transport_state_func =
+                [] { return IceTransportState::STATE_COMPLETED; },
+            .ice_role_func = [] { return ICEROLE_CONTROLLING; },
+            .is_connection_pruned_func =
+                [](const Connection*) { return false; },
+            .ice_field_trials = &field_trials_,
+            .ice_controller_field_trials = ""}) {
+    network_.AddIP(rtc::IPAddress(0x0A000001));
+    port_ = std::make_unique<NullPort>(
+        Port::PortParametersRef{.network_thread = rtc::Thread::Current(),
+                                .socket_factory = &socket_factory_,
+                                .network = &network_,
+                                .ice_username_fragment = "ufrag",
+                                .ice_password = "password",
+                                .field_trials = nullptr});
+    port_->PrepareAddress();
+    for (int i = 0; i < num_connections; ++i) {
+      Candidate remote;
+      remote.set_address(rtc::SocketAddress("10.0.1.1", 10000 + i));
+      remote.set_protocol(UDP_PROTOCOL_NAME);
+      remote.set_priority(kRemotePriority);
+      Connection* connection =
+          port_->CreateConnection(remote, PortInterface::ORIGIN_MESSAGE);
+      connection->ReceivedPingResponse(100 + i % 100, "");
+      controller_.AddConnection(connection);
+      connections_.push_back(connection);
+    }
+    controller_.SortAndSwitchConnection(
+        IceSwitchReason::NEW_CONNECTION_FROM_LOCAL_CANDIDATE);
+  }
+
+  BasicIceController& controller() { return controller_; }
+  Port& port() { return *port_; }
+  const std::vector<Connection*>& connections() const { return connections_; }
+
+ private:
+  rtc::VirtualSocketServer socket_server_;
+  rtc::AutoSocketServerThread main_thread_;
+  rtc::BasicPacketSocketFactory socket_factory_;
+  rtc::Network network_;
+  IceFieldTrials field_trials_;
+  BasicIceController controller_;
+  std::unique_ptr<NullPort> port_;
+  std::vector<Connection*> connections_;
+};
+
+// The RTT of one connection changes, which can move it anywhere in the
+// ranking, and the connections are ranked again.
+void BM_RankAfterRttChange(benchmark::State& state) {
+  ControllerFixture fixture(state.range(0));
+  const std::vector<Connection*>& connections = fixture.connections();
+  size_t next = 0;
+  int rtt = 0;
+  for (auto s : state) {
+    RTC_UNUSED(s);
+    connections[next]->ReceivedPingResponse(rtt, "");
+    fixture.controller().SortAndSwitchConnection(
+        IceSwitchReason::CONNECT_STATE_CHANGE);
+    if (++next == connections.size()) {
+      next = 0;
+    }
+    rtt = (rtt + 37) % 1000;
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
+// Ranks connections that have not changed since the last ranking.
+void BM_RankUnchanged(benchmark::State& state) {
+  ControllerFixture fixture(state.range(0));
+  for (auto s : state) {
+    RTC_UNUSED(s);
+    fixture.controller().SortAndSwitchConnection(
+        IceSwitchReason::CONNECT_STATE_CHANGE);
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
+// Finds the connection of a received packet by its source address.
+void BM_GetConnection(benchmark::State& state) {
+  ControllerFixture fixture(state.range(0));
+  std::vector<rtc::SocketAddress> addresses;
+  for (const Connection* connection : fixture.connections()) {
+    addresses.push_back(connection->remote_candidate().address());
+  }
+  size_t next = 0;
+  for (auto s : state) {
+    RTC_UNUSED(s);
+    benchmark::DoNotOptimize(fixture.port().GetConnection(addresses[next]));
+    if (++next == addresses.size()) {
+      next = 0;
+    }
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK(BM_RankAfterRttChange)->Arg(10)->Arg(1000);
+BENCHMARK(BM_RankUnchanged)->Arg(10)->Arg(1000);
+BENCHMARK(BM_GetConnection)->Arg(10)->Arg(1000);
+
+}  // namespace
+}  // namespace cricket
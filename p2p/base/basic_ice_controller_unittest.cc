@@ -0,0 +1,199 @@
+/*
+ *  Copyright 2024 The WebRTC Project Authors. All rights reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "p2p/base/basic_ice_controller.h"
+
+#include <stdint.h>
+
+#include <algorithm>
+#include <memory>
+#include <set>
+#include <vector>
+
+#include "absl/strings/string_view.h"
+#include "absl/types/optional.h"
+#include "api/candidate.h"
+#include "p2p/base/basic_packet_socket_factory.h"
+#include "p2p/base/connection.h"
+#include "p2p/base/ice_controller_factory_interface.h"
+#include "p2p/base/ice_switch_reason.h"
+#include "p2p/base/ice_transport_internal.h"
+#include "p2p/base/p2p_constants.h"
+#include "p2p/base/p2p_transport_channel_ice_field_trials.h"
+#include "p2p/base/port.h"
+#include "p2p/base/port_interface.h"
+#include "rtc_base/async_packet_socket.h"
+#include "rtc_base/ip_address.h"
+#include "rtc_base/network.h"
+#include "rtc_base/network/sent_packet.h"
+#include "rtc_base/random.h"
+#include "rtc_base/socket_address.h"
+#include "rtc_base/thread.h"
+#include "rtc_base/virtual_socket_server.h"
+#include "test/gtest.h"
+
+namespace cricket {
+namespace {
+
+// A host port without a socket, whose connections drop every packet.
+class NullPort : public Port {
+ public:
+  explicit NullPort(const PortParametersRef& args)
+      : Port(args, webrtc::IceCandidateType::kHost) {}
+
+  void PrepareAddress() override {
+    rtc::SocketAddress address(Network()->GetBestIP(), 10000);
+    AddAddress(address, address, rtc::SocketAddress(), UDP_PROTOCOL_NAME, "",
+               "", type(), ICE_TYPE_PREFERENCE_HOST, 0, "", true);
+  }
+  bool SupportsProtocol(absl::string_view protocol) const override {
+    return true;
+  }
+  ProtocolType GetProtocol() const override { return PROTO_UDP; }
+  Connection* CreateConnection(const Candidate& remote_candidate,
+                               CandidateOrigin origin) override {
+    Connection* connection =
+        new ProxyConnection(NewWeakPtr(), 0, remote_candidate);
+    AddOrReplaceConnection(connection);
+    return connection;
+  }
+  int SendTo(const void* data,
+             size_t size,
+             const rtc::SocketAddress& address,
+             const rtc::PacketOptions& options,
+             bool payload) override {
+    return static_cast<int>(size);
+  }
+  int SetOption(rtc::Socket::Option opt, int value) override { return 0; }
+  int GetOption(rtc::Socket::Option opt, int* value) override { return -1; }
+  int GetError() override { return 0; }
+  void OnSentPacket(rtc::AsyncPacketSocket* socket,
+                    const rtc::SentPacket& sent_packet) override {}
+};
+
+}  // namespace
+
+class BasicIceControllerTest : public ::testing::Test {
+ public:
+  BasicIceControllerTest()
+      : main_thread_(&socket_server_),
+        socket_factory_(&socket_server_),
+        network_("eth0", "eth0", rtc::IPAddress(0x0A000000), 8),
+        controller_(IceControllerFactoryArgs{
+            .ice_transport_state_func =
+                [] { return IceTransportState::STATE_COMPLETED; },
+            .ice_role_func = [] { return ICEROLE_CONTROLLING; },
+            .is_connection_pruned_func =
+                [this](const Connection* connection) {
+                  return pruned_.count(connection) > 0;
+                },
+            .ice_field_trials = &field_trials_,
+            .ice_controller_field_trials = ""}) {
+    network_.AddIP(rtc::IPAddress(0x0A000001));
+    port_ = std::make_unique<NullPort>(
+        Port::PortParametersRef{.network_thread = rtc::Thread::Current(),
+                                .socket_factory = &socket_factory_,
+                                .network = &network_,
+                                .ice_username_fragment = "ufrag",
+                                .ice_password = "password",
+                                .field_trials = nullptr});
+    port_->PrepareAddress();
+  }
+
+ protected:
+  Connection* AddConnection(uint32_t remote_priority) {
+    Candidate remote;
+    remote.set_address(
+        rtc::SocketAddress("10.0.1.1", 10000 + connections_.size()));
+    remote.set_protocol(UDP_PROTOCOL_NAME);
+    remote.set_priority(remote_priority);
+    Connection* connection =
+        port_->CreateConnection(remote, PortInterface::ORIGIN_MESSAGE);
+    controller_.AddConnection(connection);
+    connections_.push_back(connection);
+    return connection;
+  }
+
+  // The order of a stable sort of `connections` by CompareConnections() and
+  // RTT, which SortAndSwitchConnection() is expected to produce.
+  std::vector<const Connection*> StableSorted(
+      std::vector<const Connection*> connections) const {
+    std::stable_sort(connections.begin(), connections.end(),
+                     [this](const Connection* a, const Connection* b) {
+                       int cmp = controller_.CompareConnections(
+                           a, b, absl::nullopt, nullptr);
+                       if (cmp != 0) {
+                         return cmp > 0;
+                       }
+                       return a->rtt() < b->rtt();
+                     });
+    return connections;
+  }
+
+  rtc::VirtualSocketServer socket_server_;
+  rtc::AutoSocketServerThread main_thread_;
+  rtc::BasicPacketSocketFactory socket_factory_;
+  rtc::Network network_;
+  IceFieldTrials field_trials_;
+  std::set<const Connection*> pruned_;
+  BasicIceController controller_;
+  std::unique_ptr<NullPort> port_;
+  std::vector<Connection*> connections_;
+};
+
+// Changes a few connections at a time, for better or worse, and sometimes
+// many, and checks that the repaired order is the one of a full stable sort.
+TEST_F(BasicIceControllerTest, SortMatchesStableSortByCompareConnections) {
+  webrtc::Random random(4711);
+  for (int i = 0; i < 40; ++i) {
+    // Few distinct priorities and RTTs, so that many connections tie.
+    Connection* connection = AddConnection(random.Rand(1, 3) << 24);
+    if (random.Rand(3) > 0) {
+      connection->ReceivedPingResponse(random.Rand(1, 4) * 100, "");
+    }
+  }
+  controller_.SortAndSwitchConnection(
+      IceSwitchReason::NEW_CONNECTION_FROM_LOCAL_CANDIDATE);
+
+  for (int round = 0; round < 500; ++round) {
+    std::vector<const Connection*> expected(
+        controller_.GetConnections().begin(),
+        controller_.GetConnections().end());
+    int num_changes = random.Rand(9) == 0 ? 30 : random.Rand(1, 3);
+    for (int i = 0; i < num_changes; ++i) {
+      Connection* connection =
+          connections_[random.Rand(connections_.size() - 1)];
+      switch (random.Rand(2)) {
+        case 0:
+          connection->ReceivedPingResponse(random.Rand(1, 4) * 100, "");
+          break;
+        case 1:
+          if (!pruned_.erase(connection)) {
+            pruned_.insert(connection);
+          }
+          break;
+        case 2:
+          expected.push_back(AddConnection(random.Rand(1, 3) << 24));
+          break;
+      }
+    }
+    expected = StableSorted(expected);
+
+    controller_.SortAndSwitchConnection(IceSwitchReason::CONNECT_STATE_CHANGE);
+
+    ASSERT_EQ(std::vector<const Connection*>(
+                  controller_.GetConnections().begin(),
+                  controller_.GetConnections().end()),
+              expected)
+        << "round " << round;
+  }
+}
+
+}  // namespace cricket
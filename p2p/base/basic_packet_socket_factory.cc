@@ -48,7 +48,15 @@ AsyncPacketSocket* BasicPacketSocketFactory::CreateUdpSocket(
     delete socket;
     return NULL;
   }
-  return new AsyncUDPSocket(socket);
+  AsyncUDPSocket* udp_socket = new AsyncUDPSocket(socket);
+  udp_socket->SetBatchedReceive(batched_udp_receive_);
+  if (use_packet_buffer_pool_) {
+    if (!packet_buffer_pool_) {
+      packet_buffer_pool_ = PacketBufferPool::Create();
+    }
+    udp_socket->SetPacketBufferPool(packet_buffer_pool_);
+  }
+  return udp_socket;
 }
 
 AsyncListenSocket* BasicPacketSocketFactory::CreateServerTcpSocket(
@@ -18,7 +18,9 @@
 
 #include "api/async_dns_resolver.h"
 #include "api/packet_socket_factory.h"
+#include "api/scoped_refptr.h"
 #include "rtc_base/async_packet_socket.h"
+#include "rtc_base/packet_buffer_pool.h"
 #include "rtc_base/socket.h"
 #include "rtc_base/socket_address.h"
 #include "rtc_base/socket_factory.h"
@@ -48,6 +50,20 @@ class RTC_EXPORT BasicPacketSocketFactory : public PacketSocketFactory {
   std::unique_ptr<webrtc::AsyncDnsResolverInterface> CreateAsyncDnsResolver()
       override;
 
+  // If set, UDP sockets created by this factory read multiple datagrams per
+  // read event, see AsyncUDPSocket::SetBatchedReceive().
+  void set_batched_udp_receive(bool enabled) {
+    batched_udp_receive_ = enabled;
+  }
+
+  // If set, UDP sockets created by this factory deliver each datagram in a
+  // buffer from a PacketBufferPool shared by all of them, see
+  // AsyncUDPSocket::SetPacketBufferPool(). The pool is created on the thread
+  // that creates the first socket, which must create all later ones too.
+  void set_use_packet_buffer_pool(bool enabled) {
+    use_packet_buffer_pool_ = enabled;
+  }
+
  private:
   int BindSocket(Socket* socket,
                  const SocketAddress& local_address,
@@ -55,6 +71,9 @@ class RTC_EXPORT BasicPacketSocketFactory : public PacketSocketFactory {
                  uint16_t max_port);
 
   SocketFactory* socket_factory_;
+  bool batched_udp_receive_ = false;
+  bool use_packet_buffer_pool_ = false;
+  scoped_refptr<PacketBufferPool> packet_buffer_pool_;
 };
 
 }  // namespace rtc
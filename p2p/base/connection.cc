@@ -152,12 +152,31 @@ constexpr int64_t kMinExtraPingDelayMs = 100;
 // Default field trials.
 const IceFieldTrials kDefaultFieldTrials;
 
+// False if `payload` can't be a STUN message, by the same check as
+// Port::GetStunMessage() makes before parsing.
+bool MaybeStunMessage(rtc::ArrayView<const uint8_t> payload) {
+  int types[] = {GOOG_PING_REQUEST, GOOG_PING_RESPONSE,
+                 GOOG_PING_ERROR_RESPONSE};
+  const char* data = reinterpret_cast<const char*>(payload.data());
+  return StunMessage::IsStunMethod(types, data, payload.size()) ||
+         StunMessage::ValidateFingerprint(data, payload.size());
+}
+
 constexpr int kSupportGoogPingVersionRequestIndex = static_cast<int>(
     IceGoogMiscInfoBindingRequestAttributeIndex::SUPPORT_GOOG_PING_VERSION);
 
 constexpr int kSupportGoogPingVersionResponseIndex = static_cast<int>(
     IceGoogMiscInfoBindingResponseAttributeIndex::SUPPORT_GOOG_PING_VERSION);
 
+// Returns `key`, after rebuilding it if it is not for `password`.
+const StunMessageIntegrityKey& PasswordKey(StunMessageIntegrityKey& key,
+                                           const std::string& password) {
+  if (key.password() != password) {
+    key = StunMessageIntegrityKey(password);
+  }
+  return key;
+}
+
 }  // namespace
 
 // A ConnectionRequest is a STUN binding used to determine writability.
@@ -247,6 +266,7 @@ Connection::~Connection() {
   RTC_DCHECK_RUN_ON(network_thread_);
   RTC_DCHECK(!port_);
   RTC_DCHECK(!received_packet_callback_);
+  RTC_DCHECK(!received_packets_callback_);
 }
 
 webrtc::TaskQueueBase* Connection::network_thread() const {
@@ -454,9 +474,19 @@ void Connection::RegisterReceivedPacketCallback(
   received_packet_callback_ = std::move(received_packet_callback);
 }
 
+void Connection::RegisterReceivedPacketsCallback(
+    absl::AnyInvocable<void(Connection*,
+                            rtc::ArrayView<const rtc::ReceivedPacket>)>
+        received_packets_callback) {
+  RTC_DCHECK_RUN_ON(network_thread_);
+  RTC_CHECK(!received_packets_callback_);
+  received_packets_callback_ = std::move(received_packets_callback);
+}
+
 void Connection::DeregisterReceivedPacketCallback() {
   RTC_DCHECK_RUN_ON(network_thread_);
   received_packet_callback_ = nullptr;
+  received_packets_callback_ = nullptr;
 }
 
 void Connection::OnReadPacket(const char* data,
@@ -475,20 +505,7 @@ void Connection::OnReadPacket(const rtc::ReceivedPacket& packet) {
           packet.payload().size(), addr, &msg, &remote_ufrag)) {
     // The packet did not parse as a valid STUN message
     // This is a data packet, pass it along.
-    last_data_received_ = rtc::TimeMillis();
-    UpdateReceiving(last_data_received_);
-    recv_rate_tracker_.AddSamples(packet.payload().size());
-    stats_.packets_received++;
-    if (received_packet_callback_) {
-      received_packet_callback_(this, packet);
-    }
-    // If timed out sending writability checks, start up again
-    if (!pruned_ && (write_state_ == STATE_WRITE_TIMEOUT)) {
-      RTC_LOG(LS_WARNING)
-          << "Received a data packet on a timed-out Connection. "
-             "Resetting state to STATE_WRITE_INIT.";
-      set_write_state(STATE_WRITE_INIT);
-    }
+    OnReadDataPackets(rtc::MakeArrayView(&packet, 1));
     return;
   } else if (!msg) {
     // The packet was STUN, but failed a check and was handled internally.
@@ -518,7 +535,8 @@ void Connection::OnReadPacket(const rtc::ReceivedPacket& packet) {
   } else if (IsStunSuccessResponseType(msg->type()) ||
              IsStunErrorResponseType(msg->type())) {
     RTC_DCHECK(msg->integrity() == StunMessage::IntegrityStatus::kNotSet);
-    if (msg->ValidateMessageIntegrity(remote_candidate().password()) !=
+    if (msg->ValidateMessageIntegrity(PasswordKey(
+            remote_password_key_, remote_candidate_.password())) !=
         StunMessage::IntegrityStatus::kIntegrityOk) {
       // "silently" discard the response.
       RTC_LOG(LS_VERBOSE) << ToString() << ": Discarding "
@@ -581,6 +599,53 @@ void Connection::OnReadPacket(const rtc::ReceivedPacket& packet) {
   }
 }
 
+void Connection::OnReadPackets(
+    rtc::ArrayView<const rtc::ReceivedPacket> packets) {
+  RTC_DCHECK_RUN_ON(network_thread_);
+  // Runs of data packets are passed along together, anything that may be a
+  // STUN message goes through OnReadPacket() on its own.
+  size_t begin = 0;
+  for (size_t i = 0; i < packets.size(); ++i) {
+    if (!MaybeStunMessage(packets[i].payload())) {
+      continue;
+    }
+    if (i > begin) {
+      OnReadDataPackets(packets.subview(begin, i - begin));
+    }
+    OnReadPacket(packets[i]);
+    begin = i + 1;
+  }
+  if (begin < packets.size()) {
+    OnReadDataPackets(packets.subview(begin));
+  }
+}
+
+void Connection::OnReadDataPackets(
+    rtc::ArrayView<const rtc::ReceivedPacket> packets) {
+  last_data_received_ = rtc::TimeMillis();
+  UpdateReceiving(last_data_received_);
+  size_t bytes = 0;
+  for (const rtc::ReceivedPacket& packet : packets) {
+    bytes += packet.payload().size();
+  }
+  recv_rate_tracker_.AddSamples(bytes);
+  stats_.packets_received += packets.size();
+  if (received_packets_callback_ &&
+      (packets.size() > 1 || !received_packet_callback_)) {
+    received_packets_callback_(this, packets);
+  } else if (received_packet_callback_) {
+    for (const rtc::ReceivedPacket& packet : packets) {
+      received_packet_callback_(this, packet);
+    }
+  }
+  // If timed out sending writability checks, start up again
+  if (!pruned_ && (write_state_ == STATE_WRITE_TIMEOUT)) {
+    RTC_LOG(LS_WARNING) << "Received a data packet on a timed-out Connection. "
+                           "Resetting state to STATE_WRITE_INIT.";
+    set_write_state(STATE_WRITE_INIT);
+  }
+}
+
 void Connection::HandleStunBindingOrGoogPingRequest(IceMessage* msg) {
   RTC_DCHECK_RUN_ON(network_thread_);
   // This connection should now be receiving.
@@ -690,51 +755,35 @@ void Connection::SendStunBindingResponse(const StunMessage* message) {
     return;
   }
 
-  // Fill in the response.
-  StunMessage response(STUN_BINDING_RESPONSE, message->transaction_id());
   const StunUInt32Attribute* retransmit_attr =
       message->GetUInt32(STUN_ATTR_RETRANSMIT_COUNT);
-  if (retransmit_attr) {
-    // Inherit the incoming retransmit value in the response so the other side
-    // can see our view of lost pings.
-    response.AddAttribute(std::make_unique<StunUInt32Attribute>(
-        STUN_ATTR_RETRANSMIT_COUNT, retransmit_attr->value()));
-
-    if (retransmit_attr->value() > CONNECTION_WRITE_CONNECT_FAILURES) {
-      RTC_LOG(LS_INFO)
-          << ToString()
-          << ": Received a remote ping with high retransmit count: "
-          << retransmit_attr->value();
-    }
+  if (retransmit_attr &&
+      retransmit_attr->value() > CONNECTION_WRITE_CONNECT_FAILURES) {
+    RTC_LOG(LS_INFO) << ToString()
+                     << ": Received a remote ping with high retransmit count: "
+                     << retransmit_attr->value();
   }
 
-  response.AddAttribute(std::make_unique<StunXorAddressAttribute>(
-      STUN_ATTR_XOR_MAPPED_ADDRESS, remote_candidate_.address()));
-
+  bool announce_goog_ping = false;
   if (field_trials_->announce_goog_ping) {
     // Check if message contains a announce-request.
     auto goog_misc = message->GetUInt16List(STUN_ATTR_GOOG_MISC_INFO);
-    if (goog_misc != nullptr &&
+    announce_goog_ping =
+        goog_misc != nullptr &&
         goog_misc->Size() >= kSupportGoogPingVersionRequestIndex &&
         // Which version can we handle...currently any >= 1
-        goog_misc->GetType(kSupportGoogPingVersionRequestIndex) >= 1) {
-      auto list =
-          StunAttribute::CreateUInt16ListAttribute(STUN_ATTR_GOOG_MISC_INFO);
-      list->AddTypeAtIndex(kSupportGoogPingVersionResponseIndex,
-                           kGoogPingVersion);
-      response.AddAttribute(std::move(list));
-    }
+        goog_misc->GetType(kSupportGoogPingVersionRequestIndex) >= 1;
   }
 
+  std::unique_ptr<StunAttribute> delta_ack;
   const StunByteStringAttribute* delta =
       message->GetByteString(STUN_ATTR_GOOG_DELTA);
   if (delta) {
     if (field_trials_->answer_goog_delta && goog_delta_consumer_) {
-      auto ack = (*goog_delta_consumer_)(delta);
-      if (ack) {
+      delta_ack = (*goog_delta_consumer_)(delta);
+      if (delta_ack) {
         RTC_LOG(LS_INFO) << "Sending GOOG_DELTA_ACK"
                          << " delta len: " << delta->length();
-        response.AddAttribute(std::move(ack));
       } else {
         RTC_LOG(LS_ERROR) << "GOOG_DELTA consumer did not return ack!";
       }
@@ -748,7 +797,55 @@ void Connection::SendStunBindingResponse(const StunMessage* message) {
     }
   }
 
-  response.AddMessageIntegrity(local_candidate().password());
+  const StunMessageIntegrityKey& key =
+      PasswordKey(local_password_key_, local_candidate_.password());
+
+  // Write the usual response in place. Responses to legacy requests and
+  // those carrying a GOOG_DELTA_ACK are built as a StunMessage below.
+  if (!delta_ack &&
+      message->transaction_id().size() == kStunTransactionIdLength) {
+    StunBindingWriter writer(STUN_BINDING_RESPONSE, message->transaction_id());
+    uint16_t misc_info[kSupportGoogPingVersionResponseIndex + 1] = {};
+    misc_info[kSupportGoogPingVersionResponseIndex] = kGoogPingVersion;
+    if ((!retransmit_attr || writer.AddUInt32(STUN_ATTR_RETRANSMIT_COUNT,
+                                              retransmit_attr->value())) &&
+        writer.AddXorAddress(STUN_ATTR_XOR_MAPPED_ADDRESS,
+                             remote_candidate_.address()) &&
+        (!announce_goog_ping ||
+         writer.AddUInt16List(STUN_ATTR_GOOG_MISC_INFO, misc_info)) &&
+        writer.Finish(key)) {
+      SendResponse(writer.data(), STUN_BINDING_RESPONSE,
+                   message->transaction_id(),
+                   message->reduced_transaction_id());
+      return;
+    }
+  }
+
+  // Fill in the response.
+  StunMessage response(STUN_BINDING_RESPONSE, message->transaction_id());
+  if (retransmit_attr) {
+    // Inherit the incoming retransmit value in the response so the other side
+    // can see our view of lost pings.
+    response.AddAttribute(std::make_unique<StunUInt32Attribute>(
+        STUN_ATTR_RETRANSMIT_COUNT, retransmit_attr->value()));
+  }
+
+  response.AddAttribute(std::make_unique<StunXorAddressAttribute>(
+      STUN_ATTR_XOR_MAPPED_ADDRESS, remote_candidate_.address()));
+
+  if (announce_goog_ping) {
+    auto list =
+        StunAttribute::CreateUInt16ListAttribute(STUN_ATTR_GOOG_MISC_INFO);
+    list->AddTypeAtIndex(kSupportGoogPingVersionResponseIndex,
+                         kGoogPingVersion);
+    response.AddAttribute(std::move(list));
+  }
+
+  if (delta_ack) {
+    response.AddAttribute(std::move(delta_ack));
+  }
+
+  response.AddMessageIntegrity(key);
   response.AddFingerprint();
 
   SendResponseMessage(response);
@@ -760,39 +857,49 @@ void Connection::SendGoogPingResponse(const StunMessage* message) {
 
   // Fill in the response.
   StunMessage response(GOOG_PING_RESPONSE, message->transaction_id());
-  response.AddMessageIntegrity32(local_candidate().password());
+  response.AddMessageIntegrity32(
+      PasswordKey(local_password_key_, local_candidate_.password()));
   SendResponseMessage(response);
 }
 
 void Connection::SendResponseMessage(const StunMessage& response) {
   RTC_DCHECK_RUN_ON(network_thread_);
+  rtc::ByteBufferWriter buf;
+  response.Write(&buf);
+  SendResponse(rtc::MakeArrayView(buf.Data(), buf.Length()), response.type(),
+               response.transaction_id(), response.reduced_transaction_id());
+}
+
+void Connection::SendResponse(rtc::ArrayView<const uint8_t> response,
+                              int type,
+                              absl::string_view transaction_id,
+                              uint32_t reduced_transaction_id) {
+  RTC_DCHECK_RUN_ON(network_thread_);
   // Where I send the response.
   const rtc::SocketAddress& addr = remote_candidate_.address();
 
   // Send the response.
-  rtc::ByteBufferWriter buf;
-  response.Write(&buf);
   rtc::PacketOptions options(port_->StunDscpValue());
   options.info_signaled_after_sent.packet_type =
       rtc::PacketType::kIceConnectivityCheckResponse;
-  auto err = port_->SendTo(buf.Data(), buf.Length(), addr, options, false);
+  auto err =
+      port_->SendTo(response.data(), response.size(), addr, options, false);
   if (err < 0) {
     RTC_LOG(LS_ERROR) << ToString() << ": Failed to send "
-                      << StunMethodToString(response.type())
+                      << StunMethodToString(type)
                       << ", to=" << addr.ToSensitiveString() << ", err=" << err
-                      << ", id=" << rtc::hex_encode(response.transaction_id());
+                      << ", id=" << rtc::hex_encode(transaction_id);
   } else {
     // Log at LS_INFO if we send a stun ping response on an unwritable
     // connection.
     rtc::LoggingSeverity sev = (!writable()) ? rtc::LS_INFO : rtc::LS_VERBOSE;
-    RTC_LOG_V(sev) << ToString() << ": Sent "
-                   << StunMethodToString(response.type())
+    RTC_LOG_V(sev) << ToString() << ": Sent " << StunMethodToString(type)
                    << ", to=" << addr.ToSensitiveString()
-                   << ", id=" << rtc::hex_encode(response.transaction_id());
+                   << ", id=" << rtc::hex_encode(transaction_id);
 
     stats_.sent_ping_responses++;
     LogCandidatePairEvent(webrtc::IceCandidatePairEventType::kCheckResponseSent,
-                          response.reduced_transaction_id());
+                          reduced_transaction_id);
   }
 }
 
@@ -1007,7 +1114,8 @@ void Connection::Ping(int64_t now,
 
   if (!has_delta && ShouldSendGoogPing(req->msg())) {
     auto message = std::make_unique<IceMessage>(GOOG_PING_REQUEST, req->id());
-    message->AddMessageIntegrity32(remote_candidate_.password());
+    message->AddMessageIntegrity32(
+        PasswordKey(remote_password_key_, remote_candidate_.password()));
     req.reset(new ConnectionRequest(requests_, this, std::move(message)));
   }
 
@@ -1084,7 +1192,8 @@ std::unique_ptr<IceMessage> Connection::BuildPingRequest(
     message->AddAttribute(std::move(delta));
   }
 
-  message->AddMessageIntegrity(remote_candidate_.password());
+  message->AddMessageIntegrity(
+      PasswordKey(remote_password_key_, remote_candidate_.password()));
   message->AddFingerprint();
 
   return message;
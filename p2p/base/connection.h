@@ -24,6 +24,7 @@
 #include "absl/functional/any_invocable.h"
 #include "absl/strings/string_view.h"
 #include "absl/types/optional.h"
+#include "api/array_view.h"
 #include "api/candidate.h"
 #include "api/rtc_error.h"
 #include "api/sequence_checker.h"
@@ -151,12 +152,23 @@ class RTC_EXPORT Connection : public CandidatePairInterface {
   void RegisterReceivedPacketCallback(
       absl::AnyInvocable<void(Connection*, const rtc::ReceivedPacket&)>
           received_packet_callback);
+  // Register as a recipient of the data packets of OnReadPackets() together.
+  // Single packets are delivered to it as batches of one, unless a received
+  // packet callback is registered too. There can only be one.
+  void RegisterReceivedPacketsCallback(
+      absl::AnyInvocable<void(Connection*,
+                              rtc::ArrayView<const rtc::ReceivedPacket>)>
+          received_packets_callback);
+  // Deregisters both callbacks.
   void DeregisterReceivedPacketCallback();
 
   sigslot::signal1<Connection*> SignalReadyToSend;
 
   // Called when a packet is received on this connection.
   void OnReadPacket(const rtc::ReceivedPacket& packet);
+  // Called when packets read from the socket together are received on this
+  // connection.
+  void OnReadPackets(rtc::ArrayView<const rtc::ReceivedPacket> packets);
   [[deprecated("Pass a rtc::ReceivedPacket")]] void
   OnReadPacket(const char* data, size_t size, int64_t packet_time_us);
 
@@ -324,6 +336,11 @@ class RTC_EXPORT Connection : public CandidatePairInterface {
   void SendStunBindingResponse(const StunMessage* message);
   void SendGoogPingResponse(const StunMessage* message);
   void SendResponseMessage(const StunMessage& response);
+  // Sends the serialized `response`, of `type`, to the remote candidate.
+  void SendResponse(rtc::ArrayView<const uint8_t> response,
+                    int type,
+                    absl::string_view transaction_id,
+                    uint32_t reduced_transaction_id);
 
   // An accessor for unit tests.
   PortInterface* PortForTest() { return port_.get(); }
@@ -407,6 +424,10 @@ class RTC_EXPORT Connection : public CandidatePairInterface {
   rtc::WeakPtr<PortInterface> port_;
   Candidate local_candidate_ RTC_GUARDED_BY(network_thread_);
   Candidate remote_candidate_;
+  // Keys for the passwords of the candidates, which sign and check the
+  // connectivity checks. Rebuilt when a password changes.
+  StunMessageIntegrityKey local_password_key_ RTC_GUARDED_BY(network_thread_);
+  StunMessageIntegrityKey remote_password_key_ RTC_GUARDED_BY(network_thread_);
 
   ConnectionInfo stats_;
   rtc::RateTracker recv_rate_tracker_;
@@ -414,6 +435,10 @@ class RTC_EXPORT Connection : public CandidatePairInterface {
   int64_t last_send_data_ = 0;
 
  private:
+  // Handles received packets that are not STUN messages.
+  void OnReadDataPackets(rtc::ArrayView<const rtc::ReceivedPacket> packets)
+      RTC_RUN_ON(network_thread_);
+
   // Update the local candidate based on the mapped address attribute.
   // If the local candidate changed, fires SignalStateChange.
   void MaybeUpdateLocalCandidate(StunRequest* request, StunMessage* response)
@@ -512,6 +537,9 @@ class RTC_EXPORT Connection : public CandidatePairInterface {
       goog_delta_ack_consumer_;
   absl::AnyInvocable<void(Connection*, const rtc::ReceivedPacket&)>
       received_packet_callback_;
+  absl::AnyInvocable<void(Connection*,
+                          rtc::ArrayView<const rtc::ReceivedPacket>)>
+      received_packets_callback_;
 };
 
 // ProxyConnection defers all the interesting work to the port.
@@ -15,6 +15,7 @@
 #include <memory>
 #include <utility>
 
+#include "absl/container/inlined_vector.h"
 #include "absl/memory/memory.h"
 #include "absl/strings/string_view.h"
 #include "api/array_view.h"
@@ -217,6 +218,16 @@ bool DtlsTransport::SetDtlsRole(rtc::SSLRole role) {
   return true;
 }
 
+void DtlsTransport::SetSessionCache(
+    rtc::scoped_refptr<rtc::SSLSessionCache> cache) {
+  RTC_DCHECK(!dtls_);
+  session_cache_ = std::move(cache);
+}
+
+bool DtlsTransport::IsSessionResumed() const {
+  return dtls_ && dtls_->IsSessionResumed();
+}
+
 bool DtlsTransport::GetDtlsRole(rtc::SSLRole* role) const {
   if (!dtls_role_) {
     return false;
@@ -379,6 +390,9 @@ bool DtlsTransport::SetupDtls() {
   dtls_->SetMode(rtc::SSL_MODE_DTLS);
   dtls_->SetMaxProtocolVersion(ssl_max_version_);
   dtls_->SetServerRole(*dtls_role_);
+  if (session_cache_) {
+    dtls_->SetSessionCache(session_cache_);
+  }
   dtls_->SetEventCallback(
       [this](int events, int err) { OnDtlsEvent(events, err); });
   if (remote_fingerprint_value_.size() &&
@@ -523,10 +537,10 @@ void DtlsTransport::ConnectToIceTransport() {
   RTC_DCHECK(ice_transport_);
   ice_transport_->SignalWritableState.connect(this,
                                               &DtlsTransport::OnWritableState);
-  ice_transport_->RegisterReceivedPacketCallback(
+  ice_transport_->RegisterReceivedPacketsCallback(
       this, [&](rtc::PacketTransportInternal* transport,
-                const rtc::ReceivedPacket& packet) {
-        OnReadPacket(transport, packet);
+                rtc::ArrayView<const rtc::ReceivedPacket> packets) {
+        OnReadPackets(transport, packets);
       });
 
   ice_transport_->SignalSentPacket.connect(this, &DtlsTransport::OnSentPacket);
@@ -686,6 +700,40 @@ void DtlsTransport::OnReadPacket(rtc::PacketTransportInternal* transport,
   }
 }
 
+void DtlsTransport::OnReadPackets(
+    rtc::PacketTransportInternal* transport,
+    rtc::ArrayView<const rtc::ReceivedPacket> packets) {
+  RTC_DCHECK_RUN_ON(&thread_checker_);
+  RTC_DCHECK(transport == ice_transport_);
+
+  if (!dtls_active_) {
+    // Not doing DTLS.
+    NotifyPacketsReceived(packets);
+    return;
+  }
+
+  // Runs of SRTP packets are signalled upwards together, as bypass packets.
+  // Anything else goes through OnReadPacket() on its own.
+  absl::InlinedVector<rtc::ReceivedPacket, 16> srtp_packets;
+  for (const rtc::ReceivedPacket& packet : packets) {
+    if (dtls_state() == webrtc::DtlsTransportState::kConnected &&
+        !IsDtlsPacket(packet.payload()) && IsRtpPacket(packet.payload())) {
+      RTC_DCHECK(!srtp_ciphers_.empty());
+      srtp_packets.push_back(
+          packet.CopyAndSet(rtc::ReceivedPacket::kSrtpEncrypted));
+      continue;
+    }
+    if (!srtp_packets.empty()) {
+      NotifyPacketsReceived(srtp_packets);
+      srtp_packets.clear();
+    }
+    OnReadPacket(transport, packet);
+  }
+  if (!srtp_packets.empty()) {
+    NotifyPacketsReceived(srtp_packets);
+  }
+}
+
 void DtlsTransport::OnSentPacket(rtc::PacketTransportInternal* transport,
                                  const rtc::SentPacket& sent_packet) {
   RTC_DCHECK_RUN_ON(&thread_checker_);
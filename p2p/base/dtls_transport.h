@@ -16,8 +16,10 @@
 #include <vector>
 
 #include "absl/strings/string_view.h"
+#include "api/array_view.h"
 #include "api/crypto/crypto_options.h"
 #include "api/dtls_transport_interface.h"
+#include "api/scoped_refptr.h"
 #include "api/sequence_checker.h"
 #include "p2p/base/dtls_transport_internal.h"
 #include "p2p/base/ice_transport_internal.h"
@@ -167,6 +169,12 @@ class DtlsTransport : public DtlsTransportInternal {
   bool GetDtlsRole(rtc::SSLRole* role) const override;
   bool SetDtlsRole(rtc::SSLRole role) override;
 
+  // Resumes DTLS sessions from `cache`, and stores the session of the
+  // handshake in it. Must be called before SetRemoteFingerprint.
+  void SetSessionCache(rtc::scoped_refptr<rtc::SSLSessionCache> cache);
+  // Tells if the DTLS handshake resumed a cached session.
+  bool IsSessionResumed() const;
+
   // Find out which DTLS cipher was negotiated
   bool GetSslCipherSuite(int* cipher) override;
 
@@ -217,6 +225,8 @@ class DtlsTransport : public DtlsTransportInternal {
   void OnWritableState(rtc::PacketTransportInternal* transport);
   void OnReadPacket(rtc::PacketTransportInternal* transport,
                     const rtc::ReceivedPacket& packet);
+  void OnReadPackets(rtc::PacketTransportInternal* transport,
+                     rtc::ArrayView<const rtc::ReceivedPacket> packets);
   void OnSentPacket(rtc::PacketTransportInternal* transport,
                     const rtc::SentPacket& sent_packet);
   void OnReadyToSend(rtc::PacketTransportInternal* transport);
@@ -248,6 +258,7 @@ class DtlsTransport : public DtlsTransportInternal {
   rtc::scoped_refptr<rtc::RTCCertificate> local_certificate_;
   absl::optional<rtc::SSLRole> dtls_role_;
   const rtc::SSLProtocolVersion ssl_max_version_;
+  rtc::scoped_refptr<rtc::SSLSessionCache> session_cache_;
   rtc::Buffer remote_fingerprint_value_;
   std::string remote_fingerprint_algorithm_;
 
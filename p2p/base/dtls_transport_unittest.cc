@@ -30,6 +30,7 @@
 #include "rtc_base/ssl_adapter.h"
 #include "rtc_base/ssl_identity.h"
 #include "rtc_base/ssl_stream_adapter.h"
+#include "rtc_base/time_utils.h"
 
 #define MAYBE_SKIP_TEST(feature)                                  \
   if (!(rtc::SSLStreamAdapter::feature())) {                      \
@@ -83,6 +84,9 @@ class DtlsTestClient : public sigslot::has_slots<> {
   void SetupMaxProtocolVersion(rtc::SSLProtocolVersion version) {
     ssl_max_version_ = version;
   }
+  void SetupSessionCache(rtc::scoped_refptr<rtc::SSLSessionCache> cache) {
+    session_cache_ = std::move(cache);
+  }
   // Set up fake ICE transport and real DTLS transport under test.
   void SetupTransports(IceRole role, int async_delay_ms = 0) {
     dtls_transport_ = nullptr;
@@ -104,6 +108,9 @@ class DtlsTestClient : public sigslot::has_slots<> {
         /*event_log=*/nullptr, ssl_max_version_);
     // Note: Certificate may be null here if testing passthrough.
     dtls_transport_->SetLocalCertificate(certificate_);
+    if (session_cache_) {
+      dtls_transport_->SetSessionCache(session_cache_);
+    }
     dtls_transport_->SignalWritableState.connect(
         this, &DtlsTestClient::OnTransportWritableState);
     dtls_transport_->RegisterReceivedPacketCallback(
@@ -310,6 +317,7 @@ class DtlsTestClient : public sigslot::has_slots<> {
   size_t packet_size_ = 0u;
   std::set<int> received_;
   rtc::SSLProtocolVersion ssl_max_version_ = rtc::SSL_PROTOCOL_DTLS_12;
+  rtc::scoped_refptr<rtc::SSLSessionCache> session_cache_;
   int received_dtls_client_hellos_ = 0;
   int received_dtls_server_hellos_ = 0;
   rtc::SentPacket sent_packet_;
@@ -612,6 +620,55 @@ TEST_F(DtlsTransportTest, TestRetransmissionSchedule) {
   }
 }
 
+// Connects twice with the same certificates over a link with a one way delay
+// of 50 ms, each time creating new transports as a new PeerConnection would.
+// The second handshake resumes the session of the first, and the DTLS client
+// becomes writable one round trip earlier.
+TEST_F(DtlsTransportTest, TestSessionResumptionSavesRoundTrip) {
+  constexpr int kDelayMs = 50;
+  PrepareDtls(rtc::KT_DEFAULT);
+  client1_.SetupSessionCache(rtc::SSLSessionCache::Create());
+  client2_.SetupSessionCache(rtc::SSLSessionCache::Create());
+
+  int64_t handshake_ms[2];
+  for (int64_t& elapsed_ms : handshake_ms) {
+    client1_.SetupTransports(ICEROLE_CONTROLLING, kDelayMs);
+    client2_.SetupTransports(ICEROLE_CONTROLLED, kDelayMs);
+    client1_.dtls_transport()->SetDtlsRole(rtc::SSL_SERVER);
+    client2_.dtls_transport()->SetDtlsRole(rtc::SSL_CLIENT);
+    SetRemoteFingerprintFromCert(client1_.dtls_transport(),
+                                 client2_.certificate());
+    SetRemoteFingerprintFromCert(client2_.dtls_transport(),
+                                 client1_.certificate());
+    int64_t start_ms = rtc::TimeMillis();
+    EXPECT_TRUE(client1_.Connect(&client2_, false));
+    EXPECT_TRUE_SIMULATED_WAIT(client2_.dtls_transport()->writable(), kTimeout,
+                               fake_clock_);
+    elapsed_ms = rtc::TimeMillis() - start_ms;
+    EXPECT_TRUE_SIMULATED_WAIT(client1_.dtls_transport()->writable(), kTimeout,
+                               fake_clock_);
+  }
+
+  EXPECT_TRUE(client1_.dtls_transport()->IsSessionResumed());
+  EXPECT_TRUE(client2_.dtls_transport()->IsSessionResumed());
+  EXPECT_LE(handshake_ms[1], handshake_ms[0] - 2 * kDelayMs);
+  TestTransfer(1000, 100, /*srtp=*/true);
+}
+
+// A session is not resumed once the peer uses a different certificate.
+TEST_F(DtlsTransportTest, TestSessionNotResumedWithNewCertificate) {
+  PrepareDtls(rtc::KT_DEFAULT);
+  client1_.SetupSessionCache(rtc::SSLSessionCache::Create());
+  client2_.SetupSessionCache(rtc::SSLSessionCache::Create());
+  ASSERT_TRUE(Connect());
+  EXPECT_FALSE(client2_.dtls_transport()->IsSessionResumed());
+
+  client1_.CreateCertificate(rtc::KT_DEFAULT);
+  ASSERT_TRUE(Connect());
+  EXPECT_FALSE(client1_.dtls_transport()->IsSessionResumed());
+  EXPECT_FALSE(client2_.dtls_transport()->IsSessionResumed());
+}
+
 // The following events can occur in many different orders:
 // 1. Caller receives remote fingerprint.
 // 2. Caller is writable.
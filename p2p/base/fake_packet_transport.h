@@ -101,6 +101,7 @@ class FakePacketTransport : public PacketTransportInternal {
 
   using PacketTransportInternal::NotifyOnClose;
   using PacketTransportInternal::NotifyPacketReceived;
+  using PacketTransportInternal::NotifyPacketsReceived;
 
  private:
   void set_writable(bool writable) {
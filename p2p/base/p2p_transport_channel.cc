@@ -258,9 +258,10 @@ void P2PTransportChannel::AddConnection(Connection* connection) {
   connection->set_unwritable_timeout(config_.ice_unwritable_timeout);
   connection->set_unwritable_min_checks(config_.ice_unwritable_min_checks);
   connection->set_inactive_timeout(config_.ice_inactive_timeout);
-  connection->RegisterReceivedPacketCallback(
-      [&](Connection* connection, const rtc::ReceivedPacket& packet) {
-        OnReadPacket(connection, packet);
+  connection->RegisterReceivedPacketsCallback(
+      [&](Connection* connection,
+          rtc::ArrayView<const rtc::ReceivedPacket> packets) {
+        OnReadPackets(connection, packets);
       });
   connection->SignalReadyToSend.connect(this,
                                         &P2PTransportChannel::OnReadyToSend);
@@ -285,6 +286,7 @@ void P2PTransportChannel::AddConnection(Connection* connection) {
                          webrtc::IceCandidatePairConfigType::kAdded);
 
   connections_.push_back(connection);
+  connection_set_.insert(connection);
   ice_controller_->OnConnectionAdded(connection);
 }
 
@@ -1447,7 +1449,7 @@ bool P2PTransportChannel::CreateConnection(PortInterface* port,
 
 bool P2PTransportChannel::FindConnection(const Connection* connection) const {
   RTC_DCHECK_RUN_ON(network_thread_);
-  return absl::c_linear_search(connections_, connection);
+  return connection_set_.count(connection) > 0;
 }
 
 uint32_t P2PTransportChannel::GetRemoteCandidateGeneration(
@@ -2113,6 +2115,7 @@ void P2PTransportChannel::RemoveConnection(Connection* connection) {
   RTC_DCHECK(it != connections_.end());
   connection->DeregisterReceivedPacketCallback();
   connections_.erase(it);
+  connection_set_.erase(connection);
   connection->ClearStunDictConsumer();
   ice_controller_->OnConnectionDestroyed(connection);
 }
@@ -2183,8 +2186,9 @@ bool P2PTransportChannel::PrunePort(PortInterface* port) {
 }
 
 // We data is available, let listeners know
-void P2PTransportChannel::OnReadPacket(Connection* connection,
-                                       const rtc::ReceivedPacket& packet) {
+void P2PTransportChannel::OnReadPackets(
+    Connection* connection,
+    rtc::ArrayView<const rtc::ReceivedPacket> packets) {
   RTC_DCHECK_RUN_ON(network_thread_);
   if (connection != selected_connection_ && !FindConnection(connection)) {
     // Do not deliver, if packet doesn't belong to the correct transport
@@ -2193,14 +2197,16 @@ void P2PTransportChannel::OnReadPacket(Connection* connection,
     return;
   }
 
-    // Let the client know of an incoming packet
-    packets_received_++;
-    bytes_received_ += packet.payload().size();
+    // Let the client know of the incoming packets
+    packets_received_ += packets.size();
+    for (const rtc::ReceivedPacket& packet : packets) {
+      bytes_received_ += packet.payload().size();
+    }
     RTC_DCHECK(connection->last_data_received() >= last_data_received_ms_);
     last_data_received_ms_ =
         std::max(last_data_received_ms_, connection->last_data_received());
 
-    NotifyPacketReceived(packet);
+    NotifyPacketsReceived(packets);
 
     // May need to switch the sending connection based on the receiving media
     // path if this is the controlled side.
@@ -28,6 +28,7 @@
 #include <memory>
 #include <set>
 #include <string>
+#include <unordered_set>
 #include <utility>
 #include <vector>
 
@@ -333,7 +334,9 @@ class RTC_EXPORT P2PTransportChannel : public IceTransportInternal,
   void OnRoleConflict(PortInterface* port);
 
   void OnConnectionStateChange(Connection* connection);
-  void OnReadPacket(Connection* connection, const rtc::ReceivedPacket& packet);
+  // Handles data packets received on `connection` together.
+  void OnReadPackets(Connection* connection,
+                     rtc::ArrayView<const rtc::ReceivedPacket> packets);
   void OnSentPacket(const rtc::SentPacket& sent_packet);
   void OnReadyToSend(Connection* connection);
   void OnConnectionDestroyed(Connection* connection);
@@ -426,6 +429,9 @@ class RTC_EXPORT P2PTransportChannel : public IceTransportInternal,
 
   Connection* selected_connection_ RTC_GUARDED_BY(network_thread_) = nullptr;
   std::vector<Connection*> connections_ RTC_GUARDED_BY(network_thread_);
+  // The members of `connections_`, for FindConnection() on every packet.
+  std::unordered_set<const Connection*> connection_set_
+      RTC_GUARDED_BY(network_thread_);
 
   std::vector<RemoteCandidate> remote_candidates_
       RTC_GUARDED_BY(network_thread_);
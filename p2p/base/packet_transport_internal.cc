@@ -35,9 +35,19 @@ void PacketTransportInternal::RegisterReceivedPacketCallback(
   received_packet_callback_list_.AddReceiver(id, std::move(callback));
 }
 
+void PacketTransportInternal::RegisterReceivedPacketsCallback(
+    void* id,
+    absl::AnyInvocable<void(PacketTransportInternal*,
+                            rtc::ArrayView<const rtc::ReceivedPacket>)>
+        callback) {
+  RTC_DCHECK_RUN_ON(&network_checker_);
+  received_packets_callback_list_.AddReceiver(id, std::move(callback));
+}
+
 void PacketTransportInternal::DeregisterReceivedPacketCallback(void* id) {
   RTC_DCHECK_RUN_ON(&network_checker_);
   received_packet_callback_list_.RemoveReceivers(id);
+  received_packets_callback_list_.RemoveReceivers(id);
 }
 
 void PacketTransportInternal::SetOnCloseCallback(
@@ -51,6 +61,16 @@ void PacketTransportInternal::NotifyPacketReceived(
     const rtc::ReceivedPacket& packet) {
   RTC_DCHECK_RUN_ON(&network_checker_);
   received_packet_callback_list_.Send(this, packet);
+  received_packets_callback_list_.Send(this, rtc::MakeArrayView(&packet, 1));
+}
+
+void PacketTransportInternal::NotifyPacketsReceived(
+    rtc::ArrayView<const rtc::ReceivedPacket> packets) {
+  RTC_DCHECK_RUN_ON(&network_checker_);
+  received_packets_callback_list_.Send(this, packets);
+  for (const rtc::ReceivedPacket& packet : packets) {
+    received_packet_callback_list_.Send(this, packet);
+  }
 }
 
 void PacketTransportInternal::NotifyOnClose() {
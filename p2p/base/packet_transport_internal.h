@@ -17,6 +17,7 @@
 
 #include "absl/functional/any_invocable.h"
 #include "absl/types/optional.h"
+#include "api/array_view.h"
 #include "p2p/base/port.h"
 #include "rtc_base/async_packet_socket.h"
 #include "rtc_base/callback_list.h"
@@ -88,6 +89,17 @@ class RTC_EXPORT PacketTransportInternal : public sigslot::has_slots<> {
       absl::AnyInvocable<void(PacketTransportInternal*,
                               const rtc::ReceivedPacket&)> callback);
 
+  // Callback is invoked with the packets received on this channel together,
+  // such as those read from a socket at once. Packets received on their own
+  // are delivered as batches of one. A receiver registers either this or the
+  // received packet callback.
+  void RegisterReceivedPacketsCallback(
+      void* id,
+      absl::AnyInvocable<void(PacketTransportInternal*,
+                              rtc::ArrayView<const rtc::ReceivedPacket>)>
+          callback);
+
+  // Deregisters the callbacks of both kinds registered with `id`.
   void DeregisterReceivedPacketCallback(void* id);
 
   // Signalled each time a packet is sent on this channel.
@@ -105,6 +117,7 @@ class RTC_EXPORT PacketTransportInternal : public sigslot::has_slots<> {
   ~PacketTransportInternal() override;
 
   void NotifyPacketReceived(const rtc::ReceivedPacket& packet);
+  void NotifyPacketsReceived(rtc::ArrayView<const rtc::ReceivedPacket> packets);
   void NotifyOnClose();
 
   webrtc::SequenceChecker network_checker_{webrtc::SequenceChecker::kDetached};
@@ -112,6 +125,9 @@ class RTC_EXPORT PacketTransportInternal : public sigslot::has_slots<> {
  private:
   webrtc::CallbackList<PacketTransportInternal*, const rtc::ReceivedPacket&>
       received_packet_callback_list_ RTC_GUARDED_BY(&network_checker_);
+  webrtc::CallbackList<PacketTransportInternal*,
+                       rtc::ArrayView<const rtc::ReceivedPacket>>
+      received_packets_callback_list_ RTC_GUARDED_BY(&network_checker_);
   absl::AnyInvocable<void() &&> on_close_;
 };
 
@@ -10,7 +10,11 @@
 
 #include "p2p/base/packet_transport_internal.h"
 
+#include <vector>
+
+#include "api/array_view.h"
 #include "p2p/base/fake_packet_transport.h"
+#include "rtc_base/copy_on_write_buffer.h"
 #include "rtc_base/gunit.h"
 #include "rtc_base/network/received_packet.h"
 #include "rtc_base/third_party/sigslot/sigslot.h"
@@ -19,6 +23,7 @@
 namespace {
 
 using ::testing::MockFunction;
+using ::testing::SizeIs;
 
 TEST(PacketTransportInternal,
      NotifyPacketReceivedPassthrougPacketToRegisteredListener) {
@@ -41,6 +46,78 @@ TEST(PacketTransportInternal,
   packet_transport.DeregisterReceivedPacketCallback(&receiver);
 }
 
+TEST(PacketTransportInternal, NotifyPacketsReceivedDeliversBatchOrPackets) {
+  rtc::FakePacketTransport packet_transport("test");
+  MockFunction<void(rtc::PacketTransportInternal*,
+                    rtc::ArrayView<const rtc::ReceivedPacket>)>
+      batch_receiver;
+  MockFunction<void(rtc::PacketTransportInternal*, const rtc::ReceivedPacket&)>
+      receiver;
+  packet_transport.RegisterReceivedPacketsCallback(
+      &batch_receiver, batch_receiver.AsStdFunction());
+  packet_transport.RegisterReceivedPacketCallback(&receiver,
+                                                  receiver.AsStdFunction());
+
+  EXPECT_CALL(batch_receiver, Call(&packet_transport, SizeIs(2)));
+  EXPECT_CALL(receiver, Call).Times(2);
+  std::vector<rtc::ReceivedPacket> packets = {
+      rtc::ReceivedPacket({}, rtc::SocketAddress()),
+      rtc::ReceivedPacket({}, rtc::SocketAddress())};
+  packet_transport.NotifyPacketsReceived(packets);
+
+  // A single packet reaches the batch receiver as a batch of one.
+  EXPECT_CALL(batch_receiver, Call(&packet_transport, SizeIs(1)));
+  EXPECT_CALL(receiver, Call);
+  packet_transport.NotifyPacketReceived(
+      rtc::ReceivedPacket({}, rtc::SocketAddress()));
+
+  packet_transport.DeregisterReceivedPacketCallback(&batch_receiver);
+  packet_transport.DeregisterReceivedPacketCallback(&receiver);
+  EXPECT_CALL(batch_receiver, Call).Times(0);
+  EXPECT_CALL(receiver, Call).Times(0);
+  packet_transport.NotifyPacketsReceived(packets);
+}
+
+TEST(PacketTransportInternal, ReceiversSeePayloadSharedByEarlierReceiver) {
+  rtc::FakePacketTransport packet_transport("test");
+  MockFunction<void(rtc::PacketTransportInternal*,
+                    rtc::ArrayView<const rtc::ReceivedPacket>)>
+      batch_receiver;
+  MockFunction<void(rtc::PacketTransportInternal*, const rtc::ReceivedPacket&)>
+      receiver;
+  packet_transport.RegisterReceivedPacketsCallback(
+      &batch_receiver, batch_receiver.AsStdFunction());
+  packet_transport.RegisterReceivedPacketCallback(&receiver,
+                                                  receiver.AsStdFunction());
+
+  const uint8_t kPayload[] = {1, 2, 3, 4};
+  rtc::CopyOnWriteBuffer buffer(kPayload);
+  std::vector<rtc::ReceivedPacket> packets = {
+      rtc::ReceivedPacket(buffer, rtc::SocketAddress())};
+  packets[0].set_payload_buffer(&buffer);
+
+  // The batch receiver is called first, and modifies the payload it keeps.
+  rtc::CopyOnWriteBuffer kept_payload;
+  EXPECT_CALL(batch_receiver, Call)
+      .WillOnce([&](rtc::PacketTransportInternal*,
+                    rtc::ArrayView<const rtc::ReceivedPacket> packets) {
+        kept_payload = packets[0].SharePayload();
+        kept_payload.MutableData()[0] = 0xff;
+      });
+  EXPECT_CALL(receiver, Call)
+      .WillOnce(
+          [&](rtc::PacketTransportInternal*, const rtc::ReceivedPacket& packet) {
+            EXPECT_EQ(rtc::CopyOnWriteBuffer(packet.payload()),
+                      rtc::CopyOnWriteBuffer(kPayload));
+            EXPECT_EQ(packet.SharePayload(), rtc::CopyOnWriteBuffer(kPayload));
+          });
+  packet_transport.NotifyPacketsReceived(packets);
+  EXPECT_EQ(kept_payload[0], 0xff);
+
+  packet_transport.DeregisterReceivedPacketCallback(&batch_receiver);
+  packet_transport.DeregisterReceivedPacketCallback(&receiver);
+}
+
 TEST(PacketTransportInternal, NotifiesOnceOnClose) {
   rtc::FakePacketTransport packet_transport("test");
   int call_count = 0;
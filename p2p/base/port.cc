@@ -132,6 +132,7 @@ Port::Port(const PortParametersRef& args,
     ice_username_fragment_ = rtc::CreateRandomString(ICE_UFRAG_LENGTH);
     password_ = rtc::CreateRandomString(ICE_PWD_LENGTH);
   }
+  password_key_ = StunMessageIntegrityKey(password_);
   network_->SignalTypeChanged.connect(this, &Port::OnNetworkTypeChanged);
 
   PostDestroyIfDead(/*delayed=*/true);
@@ -179,6 +180,7 @@ void Port::SetIceParameters(int component,
   component_ = component;
   ice_username_fragment_ = std::string(username_fragment);
   password_ = std::string(password);
+  password_key_ = StunMessageIntegrityKey(password_);
   for (Candidate& c : candidates_) {
     c.set_component(component);
     c.set_username(username_fragment);
@@ -451,7 +453,7 @@ bool Port::GetStunMessage(const char* data,
     }
 
     // If ICE, and the MESSAGE-INTEGRITY is bad, fail with a 401 Unauthorized
-    if (stun_msg->ValidateMessageIntegrity(password_) !=
+    if (stun_msg->ValidateMessageIntegrity(password_key_) !=
         StunMessage::IntegrityStatus::kIntegrityOk) {
       RTC_LOG(LS_ERROR) << ToString() << ": Received "
                         << StunMethodToString(stun_msg->type())
@@ -518,7 +520,7 @@ bool Port::GetStunMessage(const char* data,
     // No stun attributes will be verified, if it's stun indication message.
     // Returning from end of the this method.
   } else if (stun_msg->type() == GOOG_PING_REQUEST) {
-    if (stun_msg->ValidateMessageIntegrity(password_) !=
+    if (stun_msg->ValidateMessageIntegrity(password_key_) !=
         StunMessage::IntegrityStatus::kIntegrityOk) {
       RTC_LOG(LS_ERROR) << ToString() << ": Received "
                         << StunMethodToString(stun_msg->type())
@@ -720,9 +722,9 @@ void Port::SendBindingErrorResponse(StunMessage* message,
       error_code != STUN_ERROR_UNAUTHORIZED &&
       message->type() != GOOG_PING_REQUEST) {
     if (message->type() == STUN_BINDING_REQUEST) {
-      response.AddMessageIntegrity(password_);
+      response.AddMessageIntegrity(password_key_);
     } else {
-      response.AddMessageIntegrity32(password_);
+      response.AddMessageIntegrity32(password_key_);
     }
   }
 
@@ -765,7 +767,7 @@ void Port::SendUnknownAttributesErrorResponse(
   }
   response.AddAttribute(std::move(unknown_attr));
 
-  response.AddMessageIntegrity(password_);
+  response.AddMessageIntegrity(password_key_);
   response.AddFingerprint();
 
   // Send the response message.
@@ -15,11 +15,11 @@
 #include <stdint.h>
 
 #include <functional>
-#include <map>
 #include <memory>
 #include <set>
 #include <string>
 #include <type_traits>
+#include <unordered_map>
 #include <utility>
 #include <vector>
 
@@ -280,9 +280,17 @@ class RTC_EXPORT Port : public PortInterface, public sigslot::has_slots<> {
   void SubscribePortDestroyed(
       std::function<void(PortInterface*)> callback) override;
   void SendPortDestroyed(Port* port);
+  struct SocketAddressHasher {
+    size_t operator()(const rtc::SocketAddress& address) const {
+      return address.Hash();
+    }
+  };
   // Returns a map containing all of the connections of this port, keyed by the
-  // remote address.
-  typedef std::map<rtc::SocketAddress, Connection*> AddressMap;
+  // remote address. It is hashed since GetConnection() runs for every packet.
+  typedef std::unordered_map<rtc::SocketAddress,
+                             Connection*,
+                             SocketAddressHasher>
+      AddressMap;
   const AddressMap& connections() { return connections_; }
 
   // Returns the connection to the given address or NULL if none exists.
@@ -485,6 +493,8 @@ class RTC_EXPORT Port : public PortInterface, public sigslot::has_slots<> {
   // PortAllocatorSession will provide these username_fragment and password.
   std::string ice_username_fragment_ RTC_GUARDED_BY(thread_);
   std::string password_ RTC_GUARDED_BY(thread_);
+  // Checks the connectivity checks sent to this port.
+  StunMessageIntegrityKey password_key_ RTC_GUARDED_BY(thread_);
   std::vector<Candidate> candidates_ RTC_GUARDED_BY(thread_);
   AddressMap connections_;
   int timeout_delay_;
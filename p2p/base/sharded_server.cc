@@ -0,0 +1,152 @@
+/*
+ *  Copyright 2024 The WebRTC Project Authors. All rights reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "p2p/base/sharded_server.h"
+
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "p2p/base/basic_packet_socket_factory.h"
+#include "p2p/base/port_interface.h"
+#include "rtc_base/async_udp_socket.h"
+#include "rtc_base/checks.h"
+#include "rtc_base/logging.h"
+#include "rtc_base/socket.h"
+
+namespace cricket {
+namespace {
+
+// Creates a UDP socket bound to `address` with SO_REUSEPORT set. The option
+// is only required when the address is going to be shared.
+rtc::AsyncUDPSocket* CreateReusePortSocket(rtc::SocketFactory* factory,
+                                           const rtc::SocketAddress& address,
+                                           bool shared) {
+  rtc::Socket* socket = factory->CreateSocket(address.family(), SOCK_DGRAM);
+  if (!socket) {
+    return nullptr;
+  }
+  if (socket->SetOption(rtc::Socket::OPT_REUSEPORT, 1) < 0 && shared) {
+    RTC_LOG(LS_ERROR) << "Failed to set SO_REUSEPORT, error "
+                      << socket->GetError();
+    delete socket;
+    return nullptr;
+  }
+  return rtc::AsyncUDPSocket::Create(socket, address);
+}
+
+// Starts `num_workers` threads and creates a server on each of them with
+// `create_server`, passing the thread and a socket bound to `address`. On
+// return `address` holds the bound address.
+template <typename Server, typename CreateServer>
+bool StartWorkers(int num_workers,
+                  rtc::SocketAddress& address,
+                  std::vector<std::unique_ptr<rtc::Thread>>& threads,
+                  std::vector<std::unique_ptr<Server>>& servers,
+                  CreateServer create_server) {
+  RTC_DCHECK_GT(num_workers, 0);
+  for (int i = 0; i < num_workers; ++i) {
+    std::unique_ptr<rtc::Thread> thread =
+        rtc::Thread::CreateWithSocketServer();
+    thread->SetName("ShardedServerWorker", nullptr);
+    thread->Start();
+    std::unique_ptr<Server> server = thread->BlockingCall([&] {
+      std::unique_ptr<Server> server;
+      rtc::AsyncUDPSocket* socket = CreateReusePortSocket(
+          thread->socketserver(), address, num_workers > 1);
+      if (socket) {
+        address = socket->GetLocalAddress();
+        server = create_server(*thread, socket);
+      }
+      return server;
+    });
+    threads.push_back(std::move(thread));
+    if (!server) {
+      servers.resize(threads.size());
+      return false;
+    }
+    servers.push_back(std::move(server));
+  }
+  return true;
+}
+
+// Destroys each server on its own thread, then stops the threads.
+template <typename Server>
+void StopWorkers(std::vector<std::unique_ptr<rtc::Thread>>& threads,
+                 std::vector<std::unique_ptr<Server>>& servers) {
+  RTC_DCHECK_EQ(threads.size(), servers.size());
+  for (size_t i = 0; i < threads.size(); ++i) {
+    threads[i]->BlockingCall([&] { servers[i] = nullptr; });
+  }
+  threads.clear();
+}
+
+}  // namespace
+
+std::unique_ptr<ShardedStunServer> ShardedStunServer::Create(
+    int num_workers,
+    const rtc::SocketAddress& address) {
+  std::unique_ptr<ShardedStunServer> server(new ShardedStunServer());
+  server->address_ = address;
+  if (!StartWorkers(num_workers, server->address_, server->threads_,
+                    server->servers_,
+                    [](rtc::Thread&, rtc::AsyncUDPSocket* socket) {
+                      return std::make_unique<StunServer>(socket);
+                    })) {
+    RTC_LOG(LS_ERROR) << "Failed to start STUN workers on "
+                      << address.ToString();
+    return nullptr;
+  }
+  return server;
+}
+
+ShardedStunServer::~ShardedStunServer() {
+  StopWorkers(threads_, servers_);
+}
+
+std::unique_ptr<ShardedTurnServer> ShardedTurnServer::Create(
+    int num_workers,
+    const rtc::SocketAddress& address,
+    const rtc::IPAddress& external_ip,
+    rtc::FunctionView<void(TurnServer&)> configure) {
+  std::unique_ptr<ShardedTurnServer> server(new ShardedTurnServer());
+  server->address_ = address;
+  if (!StartWorkers(
+          num_workers, server->address_, server->threads_, server->servers_,
+          [&](rtc::Thread& thread, rtc::AsyncUDPSocket* socket) {
+            auto turn_server = std::make_unique<TurnServer>(&thread);
+            turn_server->AddInternalSocket(socket, PROTO_UDP);
+            turn_server->SetExternalSocketFactory(
+                new rtc::BasicPacketSocketFactory(thread.socketserver()),
+                rtc::SocketAddress(external_ip, 0));
+            configure(*turn_server);
+            return turn_server;
+          })) {
+    RTC_LOG(LS_ERROR) << "Failed to start TURN workers on "
+                      << address.ToString();
+    return nullptr;
+  }
+  return server;
+}
+
+ShardedTurnServer::~ShardedTurnServer() {
+  StopWorkers(threads_, servers_);
+}
+
+std::vector<size_t> ShardedTurnServer::GetAllocationCounts() const {
+  std::vector<size_t> counts;
+  for (size_t i = 0; i < threads_.size(); ++i) {
+    counts.push_back(threads_[i]->BlockingCall(
+        [&] { return servers_[i]->allocations().size(); }));
+  }
+  return counts;
+}
+
+}  // namespace cricket
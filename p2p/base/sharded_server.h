@@ -0,0 +1,91 @@
+/*
+ *  Copyright 2024 The WebRTC Project Authors. All rights reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef P2P_BASE_SHARDED_SERVER_H_
+#define P2P_BASE_SHARDED_SERVER_H_
+
+#include <stddef.h>
+
+#include <memory>
+#include <vector>
+
+#include "api/function_view.h"
+#include "p2p/base/stun_server.h"
+#include "p2p/base/turn_server.h"
+#include "rtc_base/ip_address.h"
+#include "rtc_base/socket_address.h"
+#include "rtc_base/thread.h"
+
+namespace cricket {
+
+// The servers below run one StunServer or TurnServer per worker thread so
+// that a single process can use all cores. Every worker owns a UDP socket
+// bound to the same address with SO_REUSEPORT. The kernel hashes the address
+// pair of each datagram to pick the socket, so all packets of a client reach
+// the same worker. Each worker's server, and for TURN its allocations and
+// relay sockets, is only accessed on that worker's thread, so no state is
+// shared between workers and no lock is taken on the relay path.
+//
+// SO_REUSEPORT is not available on Windows, where only one worker can be run.
+
+class ShardedStunServer {
+ public:
+  // Starts `num_workers` threads serving STUN on `address`. If the port of
+  // `address` is 0, a port is picked for the first worker and shared by the
+  // others. Returns null if the sockets could not be bound.
+  static std::unique_ptr<ShardedStunServer> Create(
+      int num_workers,
+      const rtc::SocketAddress& address);
+  ~ShardedStunServer();
+
+  const rtc::SocketAddress& address() const { return address_; }
+  int num_workers() const { return static_cast<int>(threads_.size()); }
+
+ private:
+  ShardedStunServer() = default;
+
+  rtc::SocketAddress address_;
+  std::vector<std::unique_ptr<rtc::Thread>> threads_;
+  std::vector<std::unique_ptr<StunServer>> servers_;
+};
+
+class ShardedTurnServer {
+ public:
+  // Starts `num_workers` threads serving TURN over UDP on `address`, relaying
+  // from sockets bound to `external_ip`. `configure` is called on each
+  // worker's thread before its server receives any packets, e.g. to set the
+  // realm and the auth hook. Hooks passed to several servers are called
+  // concurrently and must be thread safe. Returns null if the sockets could
+  // not be bound.
+  static std::unique_ptr<ShardedTurnServer> Create(
+      int num_workers,
+      const rtc::SocketAddress& address,
+      const rtc::IPAddress& external_ip,
+      rtc::FunctionView<void(TurnServer&)> configure);
+  ~ShardedTurnServer();
+
+  const rtc::SocketAddress& address() const { return address_; }
+  int num_workers() const { return static_cast<int>(threads_.size()); }
+
+  // Returns the number of allocations of each worker. Blocks on every worker
+  // thread, so it is meant for tests and statistics.
+  std::vector<size_t> GetAllocationCounts() const;
+
+ private:
+  ShardedTurnServer() = default;
+
+  rtc::SocketAddress address_;
+  std::vector<std::unique_ptr<rtc::Thread>> threads_;
+  std::vector<std::unique_ptr<TurnServer>> servers_;
+};
+
+}  // namespace cricket
+
+#endif  // P2P_BASE_SHARDED_SERVER_H_
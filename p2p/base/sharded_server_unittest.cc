@@ -0,0 +1,174 @@
+/*
+ *  Copyright 2024 The WebRTC Project Authors. All rights reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "p2p/base/sharded_server.h"
+
+#include <memory>
+#include <numeric>
+#include <string>
+#include <vector>
+
+#include "absl/memory/memory.h"
+#include "absl/strings/string_view.h"
+#include "api/transport/stun.h"
+#include "rtc_base/async_udp_socket.h"
+#include "rtc_base/byte_buffer.h"
+#include "rtc_base/crypto_random.h"
+#include "rtc_base/ip_address.h"
+#include "rtc_base/physical_socket_server.h"
+#include "rtc_base/test_client.h"
+#include "rtc_base/thread.h"
+#include "test/gtest.h"
+
+namespace cricket {
+namespace {
+
+constexpr int kNumWorkers = 3;
+constexpr int kNumClients = 12;
+constexpr char kRealm[] = "example.org";
+
+// Accepts users whose password equals their user name. Only reads constant
+// state, so it can be shared by all workers.
+class PasswordIsUsernameAuth : public TurnAuthInterface {
+ public:
+  bool GetKey(absl::string_view username,
+              absl::string_view realm,
+              std::string* key) override {
+    return ComputeStunCredentialHash(std::string(username), std::string(realm),
+                                     std::string(username), key);
+  }
+};
+
+class ShardedServerTest : public ::testing::Test {
+ protected:
+  ShardedServerTest() : main_thread_(&socket_server_) {}
+
+  std::unique_ptr<rtc::TestClient> CreateClient() {
+    return std::make_unique<rtc::TestClient>(
+        absl::WrapUnique(rtc::AsyncUDPSocket::Create(
+            &socket_server_, rtc::SocketAddress(kLoopback, 0))));
+  }
+
+  void Send(rtc::TestClient& client,
+            const StunMessage& msg,
+            const rtc::SocketAddress& server_address) {
+    rtc::ByteBufferWriter buf;
+    msg.Write(&buf);
+    client.SendTo(reinterpret_cast<const char*>(buf.Data()), buf.Length(),
+                  server_address);
+  }
+
+  std::unique_ptr<TurnMessage> Receive(rtc::TestClient& client) {
+    std::unique_ptr<rtc::TestClient::Packet> packet =
+        client.NextPacket(rtc::TestClient::kTimeoutMs);
+    if (!packet) {
+      return nullptr;
+    }
+    rtc::ByteBufferReader buf(packet->buf);
+    auto msg = std::make_unique<TurnMessage>();
+    if (!msg->Read(&buf)) {
+      return nullptr;
+    }
+    return msg;
+  }
+
+  const rtc::IPAddress kLoopback = rtc::IPAddress(INADDR_LOOPBACK);
+  rtc::PhysicalSocketServer socket_server_;
+  rtc::AutoSocketServerThread main_thread_;
+};
+
+TEST_F(ShardedServerTest, WorkersShareOneAddress) {
+  std::unique_ptr<ShardedStunServer> server = ShardedStunServer::Create(
+      kNumWorkers, rtc::SocketAddress(kLoopback, 0));
+  ASSERT_NE(server, nullptr);
+  EXPECT_EQ(server->num_workers(), kNumWorkers);
+  EXPECT_EQ(server->address().ipaddr(), kLoopback);
+  EXPECT_NE(server->address().port(), 0);
+}
+
+TEST_F(ShardedServerTest, StunServerAnswersEveryClient) {
+  std::unique_ptr<ShardedStunServer> server = ShardedStunServer::Create(
+      kNumWorkers, rtc::SocketAddress(kLoopback, 0));
+  ASSERT_NE(server, nullptr);
+  for (int i = 0; i < kNumClients; ++i) {
+    std::unique_ptr<rtc::TestClient> client = CreateClient();
+    StunMessage request(STUN_BINDING_REQUEST, rtc::CreateRandomString(12));
+    Send(*client, request, server->address());
+    std::unique_ptr<TurnMessage> response = Receive(*client);
+    ASSERT_NE(response, nullptr);
+    EXPECT_EQ(response->type(), STUN_BINDING_RESPONSE);
+    EXPECT_EQ(response->transaction_id(), request.transaction_id());
+    const StunAddressAttribute* mapped_address =
+        response->GetAddress(STUN_ATTR_XOR_MAPPED_ADDRESS);
+    ASSERT_NE(mapped_address, nullptr);
+    EXPECT_EQ(mapped_address->GetAddress(), client->address());
+  }
+}
+
+// The nonce handed out with the 401 response is only valid at the worker
+// that created it, so authenticated allocations only succeed if every client
+// sticks to one worker.
+TEST_F(ShardedServerTest, TurnClientsStickToOneWorker) {
+  PasswordIsUsernameAuth auth;
+  std::unique_ptr<ShardedTurnServer> server = ShardedTurnServer::Create(
+      kNumWorkers, rtc::SocketAddress(kLoopback, 0), kLoopback,
+      [&](TurnServer& turn_server) {
+        turn_server.set_realm(kRealm);
+        turn_server.set_auth_hook(&auth);
+      });
+  ASSERT_NE(server, nullptr);
+
+  std::vector<std::unique_ptr<rtc::TestClient>> clients;
+  for (int i = 0; i < kNumClients; ++i) {
+    clients.push_back(CreateClient());
+    rtc::TestClient& client = *clients.back();
+    TurnMessage request(STUN_ALLOCATE_REQUEST, rtc::CreateRandomString(12));
+    request.AddAttribute(std::make_unique<StunUInt32Attribute>(
+        STUN_ATTR_REQUESTED_TRANSPORT, IPPROTO_UDP << 24));
+    Send(client, request, server->address());
+    std::unique_ptr<TurnMessage> challenge = Receive(client);
+    ASSERT_NE(challenge, nullptr);
+    ASSERT_EQ(challenge->type(), STUN_ALLOCATE_ERROR_RESPONSE);
+    const StunByteStringAttribute* nonce =
+        challenge->GetByteString(STUN_ATTR_NONCE);
+    ASSERT_NE(nonce, nullptr);
+
+    std::string username = "user" + std::to_string(i);
+    std::string key;
+    ASSERT_TRUE(ComputeStunCredentialHash(username, kRealm, username, &key));
+    TurnMessage authenticated(STUN_ALLOCATE_REQUEST,
+                              rtc::CreateRandomString(12));
+    authenticated.AddAttribute(std::make_unique<StunUInt32Attribute>(
+        STUN_ATTR_REQUESTED_TRANSPORT, IPPROTO_UDP << 24));
+    authenticated.AddAttribute(std::make_unique<StunByteStringAttribute>(
+        STUN_ATTR_USERNAME, username));
+    authenticated.AddAttribute(
+        std::make_unique<StunByteStringAttribute>(STUN_ATTR_REALM, kRealm));
+    authenticated.AddAttribute(std::make_unique<StunByteStringAttribute>(
+        STUN_ATTR_NONCE, nonce->string_view()));
+    authenticated.AddMessageIntegrity(key);
+    Send(client, authenticated, server->address());
+    std::unique_ptr<TurnMessage> response = Receive(client);
+    ASSERT_NE(response, nullptr);
+    EXPECT_EQ(response->type(), STUN_ALLOCATE_RESPONSE);
+    const StunAddressAttribute* relayed_address =
+        response->GetAddress(STUN_ATTR_XOR_RELAYED_ADDRESS);
+    ASSERT_NE(relayed_address, nullptr);
+    EXPECT_EQ(relayed_address->GetAddress().ipaddr(), kLoopback);
+  }
+
+  std::vector<size_t> counts = server->GetAllocationCounts();
+  ASSERT_EQ(counts.size(), static_cast<size_t>(kNumWorkers));
+  EXPECT_EQ(std::accumulate(counts.begin(), counts.end(), size_t{0}),
+            static_cast<size_t>(kNumClients));
+}
+
+}  // namespace
+}  // namespace cricket
@@ -26,6 +26,7 @@
 #include "rtc_base/logging.h"
 #include "rtc_base/network/received_packet.h"
 #include "rtc_base/strings/string_builder.h"
+#include "rtc_base/weak_ptr.h"
 
 namespace cricket {
 
@@ -208,10 +209,19 @@ bool UDPPort::Init() {
         [&](rtc::AsyncPacketSocket* socket, const rtc::ReceivedPacket& packet) {
           OnReadPacket(socket, packet);
         });
+    socket_->RegisterReceivedPacketsCallback(
+        [&](rtc::AsyncPacketSocket* socket,
+            rtc::ArrayView<const rtc::ReceivedPacket> packets) {
+          OnReadPackets(socket, packets);
+        });
   }
   socket_->SignalSentPacket.connect(this, &UDPPort::OnSentPacket);
   socket_->SignalReadyToSend.connect(this, &UDPPort::OnReadyToSend);
   socket_->SignalAddressReady.connect(this, &UDPPort::OnLocalAddressReady);
+  // RFC 8888 feedback reports the ECN marking of every received packet.
+  if (field_trials().IsEnabled("WebRTC-RFC8888CongestionControlFeedback")) {
+    socket_->SetOption(rtc::Socket::OPT_RECV_ECN, 1);
+  }
   return true;
 }
 
@@ -395,6 +405,35 @@ void UDPPort::OnReadPacket(rtc::AsyncPacketSocket* socket,
   }
 }
 
+void UDPPort::OnReadPackets(
+    rtc::AsyncPacketSocket* socket,
+    rtc::ArrayView<const rtc::ReceivedPacket> packets) {
+  RTC_DCHECK(socket == socket_);
+  rtc::WeakPtr<Port> alive = NewWeakPtr();
+  size_t begin = 0;
+  while (begin < packets.size()) {
+    const rtc::SocketAddress& source = packets[begin].source_address();
+    Connection* conn = server_addresses_.find(source) == server_addresses_.end()
+                           ? GetConnection(source)
+                           : nullptr;
+    if (!conn) {
+      OnReadPacket(socket, packets[begin]);
+      ++begin;
+    } else {
+      // Consecutive packets of a connection are handed to it together.
+      size_t end = begin + 1;
+      while (end < packets.size() && packets[end].source_address() == source) {
+        ++end;
+      }
+      conn->OnReadPackets(packets.subview(begin, end - begin));
+      begin = end;
+    }
+    if (!alive) {
+      return;
+    }
+  }
+}
+
 void UDPPort::OnSentPacket(rtc::AsyncPacketSocket* socket,
                            const rtc::SentPacket& sent_packet) {
   PortInterface::SignalSentPacket(sent_packet);
@@ -18,6 +18,7 @@
 
 #include "absl/memory/memory.h"
 #include "absl/strings/string_view.h"
+#include "api/array_view.h"
 #include "api/task_queue/pending_task_safety_flag.h"
 #include "p2p/base/port.h"
 #include "p2p/base/stun_request.h"
@@ -175,6 +176,9 @@ class RTC_EXPORT UDPPort : public Port {
 
   void OnReadPacket(rtc::AsyncPacketSocket* socket,
                     const rtc::ReceivedPacket& packet);
+  // Handles packets read from the socket together.
+  void OnReadPackets(rtc::AsyncPacketSocket* socket,
+                     rtc::ArrayView<const rtc::ReceivedPacket> packets);
 
   void OnSentPacket(rtc::AsyncPacketSocket* socket,
                     const rtc::SentPacket& sent_packet) override;
@@ -11,15 +11,20 @@
 #include "p2p/base/stun_port.h"
 
 #include <memory>
+#include <vector>
 
+#include "api/array_view.h"
 #include "api/test/mock_async_dns_resolver.h"
 #include "p2p/base/basic_packet_socket_factory.h"
 #include "p2p/base/mock_dns_resolving_packet_socket_factory.h"
 #include "p2p/base/test_stun_server.h"
 #include "rtc_base/async_packet_socket.h"
+#include "rtc_base/checks.h"
 #include "rtc_base/crypto_random.h"
 #include "rtc_base/gunit.h"
+#include "rtc_base/network/ecn_marking.h"
 #include "rtc_base/network/received_packet.h"
+#include "rtc_base/physical_socket_server.h"
 #include "rtc_base/socket_address.h"
 #include "rtc_base/ssl_adapter.h"
 #include "rtc_base/virtual_socket_server.h"
@@ -625,6 +630,108 @@ TEST_F(StunPortTest, TestStunPacketsHaveDscpPacketOption) {
   EXPECT_TRUE_SIMULATED_WAIT(done(), kTimeoutMs, fake_clock);
 }
 
+// Sends an ECT(1) marked packet over real sockets to a connection of a
+// UDPPort and returns the marking that the connection saw.
+rtc::EcnMarking ReceiveEct1PacketOnUdpPort(
+    const webrtc::FieldTrialsView& field_trials) {
+  rtc::PhysicalSocketServer socket_server;
+  rtc::AutoSocketServerThread thread(&socket_server);
+  rtc::BasicPacketSocketFactory socket_factory(&socket_server);
+  rtc::Network network("unittest", "unittest", kLocalAddr.ipaddr(), 32);
+  network.AddIP(kLocalAddr.ipaddr());
+  std::unique_ptr<cricket::UDPPort> port = cricket::UDPPort::Create(
+      {.network_thread = rtc::Thread::Current(),
+       .socket_factory = &socket_factory,
+       .network = &network,
+       .ice_username_fragment = rtc::CreateRandomString(16),
+       .ice_password = rtc::CreateRandomString(22),
+       .field_trials = &field_trials},
+      0, 0, false, absl::nullopt);
+  RTC_CHECK(port);
+  port->PrepareAddress();
+  RTC_CHECK_EQ(port->Candidates().size(), 1u);
+
+  std::unique_ptr<rtc::Socket> sender(
+      socket_server.CreateSocket(AF_INET, SOCK_DGRAM));
+  RTC_CHECK_EQ(sender->Bind(kLocalAddr), 0);
+  sender->SetOption(rtc::Socket::OPT_SEND_ECN, 1);
+  cricket::Candidate remote_candidate;
+  remote_candidate.set_address(sender->GetLocalAddress());
+  remote_candidate.set_protocol(cricket::UDP_PROTOCOL_NAME);
+  cricket::Connection* connection = port->CreateConnection(
+      remote_candidate, cricket::PortInterface::ORIGIN_MESSAGE);
+  RTC_CHECK(connection);
+  absl::optional<rtc::EcnMarking> ecn;
+  connection->RegisterReceivedPacketCallback(
+      [&](cricket::Connection*, const rtc::ReceivedPacket& packet) {
+        ecn = packet.ecn();
+      });
+
+  sender->SendTo("data", 4, port->Candidates()[0].address());
+  EXPECT_TRUE_WAIT(ecn.has_value(), kTimeoutMs);
+  connection->DeregisterReceivedPacketCallback();
+  return ecn.value_or(rtc::EcnMarking::kNotEct);
+}
+
+TEST(UdpPortTest, ReceivesEcnWithCongestionControlFeedback) {
+  webrtc::test::ScopedKeyValueConfig field_trials(
+      "WebRTC-RFC8888CongestionControlFeedback/Enabled/");
+  EXPECT_EQ(ReceiveEct1PacketOnUdpPort(field_trials),
+            rtc::EcnMarking::kEct1);
+}
+
+TEST(UdpPortTest, IgnoresEcnWithoutCongestionControlFeedback) {
+  webrtc::test::ScopedKeyValueConfig field_trials;
+  EXPECT_EQ(ReceiveEct1PacketOnUdpPort(field_trials),
+            rtc::EcnMarking::kNotEct);
+}
+
+TEST(UdpPortTest, DeliversPacketsReadTogetherToConnectionTogether) {
+  webrtc::test::ScopedKeyValueConfig field_trials;
+  rtc::PhysicalSocketServer socket_server;
+  rtc::AutoSocketServerThread thread(&socket_server);
+  rtc::BasicPacketSocketFactory socket_factory(&socket_server);
+  socket_factory.set_batched_udp_receive(true);
+  rtc::Network network("unittest", "unittest", kLocalAddr.ipaddr(), 32);
+  network.AddIP(kLocalAddr.ipaddr());
+  std::unique_ptr<cricket::UDPPort> port = cricket::UDPPort::Create(
+      {.network_thread = rtc::Thread::Current(),
+       .socket_factory = &socket_factory,
+       .network = &network,
+       .ice_username_fragment = rtc::CreateRandomString(16),
+       .ice_password = rtc::CreateRandomString(22),
+       .field_trials = &field_trials},
+      0, 0, false, absl::nullopt);
+  ASSERT_TRUE(port);
+  port->PrepareAddress();
+  ASSERT_EQ(port->Candidates().size(), 1u);
+
+  std::unique_ptr<rtc::Socket> sender(
+      socket_server.CreateSocket(AF_INET, SOCK_DGRAM));
+  ASSERT_EQ(sender->Bind(kLocalAddr), 0);
+  cricket::Candidate remote_candidate;
+  remote_candidate.set_address(sender->GetLocalAddress());
+  remote_candidate.set_protocol(cricket::UDP_PROTOCOL_NAME);
+  cricket::Connection* connection = port->CreateConnection(
+      remote_candidate, cricket::PortInterface::ORIGIN_MESSAGE);
+  ASSERT_TRUE(connection);
+  std::vector<size_t> batch_sizes;
+  connection->RegisterReceivedPacketsCallback(
+      [&](cricket::Connection*,
+          rtc::ArrayView<const rtc::ReceivedPacket> packets) {
+        batch_sizes.push_back(packets.size());
+      });
+
+  // Sent before the port's thread gets to read any of them.
+  for (int i = 0; i < 3; ++i) {
+    sender->SendTo("data", 4, port->Candidates()[0].address());
+  }
+  EXPECT_TRUE_WAIT(!batch_sizes.empty(), kTimeoutMs);
+  EXPECT_THAT(batch_sizes, ::testing::ElementsAre(3));
+  EXPECT_EQ(connection->stats().packets_received, 3u);
+  connection->DeregisterReceivedPacketCallback();
+}
+
 class StunIPv6PortTestBase : public StunPortTestBase {
  public:
   StunIPv6PortTestBase()
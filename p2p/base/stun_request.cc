@@ -129,7 +129,10 @@ bool StunRequestManager::CheckResponse(StunMessage* msg) {
   } else {
     if (msg->integrity() == StunMessage::IntegrityStatus::kNotSet) {
       // Checking status for the first time. Normal.
-      msg->ValidateMessageIntegrity(request->msg()->password());
+      if (response_key_.password() != request->msg()->password()) {
+        response_key_ = StunMessageIntegrityKey(request->msg()->password());
+      }
+      msg->ValidateMessageIntegrity(response_key_);
     } else if (msg->integrity() == StunMessage::IntegrityStatus::kIntegrityOk &&
                msg->password() == request->msg()->password()) {
       // Status is already checked, with the same password. This is the case
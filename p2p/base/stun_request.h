@@ -83,6 +83,9 @@ class StunRequestManager {
 
   webrtc::TaskQueueBase* const thread_;
   RequestMap requests_ RTC_GUARDED_BY(thread_);
+  // Key for the password of the last response checked, which is the same for
+  // all requests of most managers.
+  StunMessageIntegrityKey response_key_ RTC_GUARDED_BY(thread_);
   const std::function<void(const void*, size_t, StunRequest*)> send_packet_;
 };
 
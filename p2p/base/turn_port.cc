@@ -1189,7 +1189,7 @@ void TurnPort::AddRequestAuthInfo(StunMessage* msg) {
       std::make_unique<StunByteStringAttribute>(STUN_ATTR_REALM, realm_));
   msg->AddAttribute(
       std::make_unique<StunByteStringAttribute>(STUN_ATTR_NONCE, nonce_));
-  const bool success = msg->AddMessageIntegrity(hash());
+  const bool success = msg->AddMessageIntegrity(hash_key_);
   RTC_DCHECK(success);
 }
 
@@ -1203,6 +1203,7 @@ void TurnPort::UpdateHash() {
   const bool success = ComputeStunCredentialHash(credentials_.username, realm_,
                                                  credentials_.password, &hash_);
   RTC_DCHECK(success);
+  hash_key_ = StunMessageIntegrityKey(hash_);
 }
 
 bool TurnPort::UpdateNonce(StunMessage* response) {
@@ -1231,6 +1232,7 @@ bool TurnPort::UpdateNonce(StunMessage* response) {
 
 void TurnPort::ResetNonce() {
   hash_.clear();
+  hash_key_ = StunMessageIntegrityKey();
   nonce_.clear();
   realm_.clear();
 }
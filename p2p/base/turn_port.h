@@ -24,6 +24,7 @@
 #include "api/async_dns_resolver.h"
 #include "api/task_queue/pending_task_safety_flag.h"
 #include "api/task_queue/task_queue_base.h"
+#include "api/transport/stun.h"
 #include "p2p/base/port.h"
 #include "p2p/base/port_allocator.h"
 #include "p2p/client/relay_port_factory_interface.h"
@@ -364,6 +365,7 @@ class TurnPort : public Port {
   std::string realm_;  // From 401/438 response message.
   std::string nonce_;  // From 401/438 response message.
   std::string hash_;   // Digest of username:realm:password
+  StunMessageIntegrityKey hash_key_;
 
   int next_channel_number_;
   std::vector<std::unique_ptr<TurnEntry>> entries_;
@@ -10,12 +10,13 @@
 
 #include "p2p/base/turn_server.h"
 
+#include <string.h>
+
 #include <algorithm>
 #include <memory>
 #include <tuple>  // for std::tie
 #include <utility>
 
-#include "absl/algorithm/container.h"
 #include "absl/memory/memory.h"
 #include "absl/strings/string_view.h"
 #include "api/array_view.h"
@@ -24,6 +25,7 @@
 #include "api/transport/stun.h"
 #include "p2p/base/async_stun_tcp_socket.h"
 #include "rtc_base/byte_buffer.h"
+#include "rtc_base/byte_order.h"
 #include "rtc_base/checks.h"
 #include "rtc_base/crypto_random.h"
 #include "rtc_base/logging.h"
@@ -100,9 +102,10 @@ void TurnServer::AddInternalSocket(rtc::AsyncPacketSocket* socket,
   RTC_DCHECK(server_sockets_.end() == server_sockets_.find(socket));
   server_sockets_[socket] = proto;
   socket->RegisterReceivedPacketCallback(
-      [&](rtc::AsyncPacketSocket* socket, const rtc::ReceivedPacket& packet) {
+      [this, proto](rtc::AsyncPacketSocket* socket,
+                    const rtc::ReceivedPacket& packet) {
         RTC_DCHECK_RUN_ON(thread_);
-        OnInternalPacket(socket, packet);
+        OnInternalPacket(socket, proto, packet);
       });
 }
 
@@ -164,15 +167,15 @@ void TurnServer::OnInternalSocketClose(rtc::AsyncPacketSocket* socket,
 }
 
 void TurnServer::OnInternalPacket(rtc::AsyncPacketSocket* socket,
+                                  ProtocolType proto,
                                   const rtc::ReceivedPacket& packet) {
   RTC_DCHECK_RUN_ON(thread_);
   // Fail if the packet is too small to even contain a channel header.
   if (packet.payload().size() < TURN_CHANNEL_HEADER_SIZE) {
     return;
   }
-  InternalSocketMap::iterator iter = server_sockets_.find(socket);
-  RTC_DCHECK(iter != server_sockets_.end());
-  TurnServerConnection conn(packet.source_address(), iter->second, socket);
+  RTC_DCHECK(server_sockets_.find(socket) != server_sockets_.end());
+  TurnServerConnection conn(packet.source_address(), proto, socket);
   uint16_t msg_type = rtc::GetBE16(packet.payload().data());
   if (!IsTurnChannelData(msg_type)) {
     // This is a STUN message.
@@ -491,6 +494,22 @@ void TurnServer::Send(TurnServerConnection* conn,
   conn->socket()->SendTo(buf.Data(), buf.Length(), conn->src(), options);
 }
 
+void TurnServer::SendChannelData(TurnServerConnection* conn,
+                                 int channel_id,
+                                 rtc::ArrayView<const uint8_t> payload) {
+  RTC_DCHECK_RUN_ON(thread_);
+  channel_data_buffer_.SetSize(TURN_CHANNEL_HEADER_SIZE + payload.size());
+  uint8_t* data = channel_data_buffer_.data();
+  rtc::SetBE16(data, static_cast<uint16_t>(channel_id));
+  rtc::SetBE16(data + 2, static_cast<uint16_t>(payload.size()));
+  if (!payload.empty()) {
+    memcpy(data + TURN_CHANNEL_HEADER_SIZE, payload.data(), payload.size());
+  }
+  rtc::PacketOptions options;
+  conn->socket()->SendTo(data, channel_data_buffer_.size(), conn->src(),
+                         options);
+}
+
 void TurnServer::DestroyAllocation(TurnServerAllocation* allocation) {
   // Removing the internal socket if the connection is not udp.
   rtc::AsyncPacketSocket* socket = allocation->conn()->socket();
@@ -526,7 +545,10 @@ TurnServerConnection::TurnServerConnection(const rtc::SocketAddress& src,
                                            ProtocolType proto,
                                            rtc::AsyncPacketSocket* socket)
     : src_(src),
-      dst_(socket->GetRemoteAddress()),
+      // The internal UDP sockets are not connected, skip asking the OS for a
+      // remote address on every packet.
+      dst_(proto == PROTO_UDP ? rtc::SocketAddress()
+                              : socket->GetRemoteAddress()),
       proto_(proto),
       socket_(socket) {}
 
@@ -538,6 +560,10 @@ bool TurnServerConnection::operator<(const TurnServerConnection& c) const {
   return std::tie(src_, dst_, proto_) < std::tie(c.src_, c.dst_, c.proto_);
 }
 
+size_t TurnServerConnection::Hash() const {
+  return src_.Hash() ^ (dst_.Hash() * 31) ^ proto_;
+}
+
 std::string TurnServerConnection::ToString() const {
   const char* const kProtos[] = {"unknown", "udp", "tcp", "ssltcp"};
   rtc::StringBuilder ost;
@@ -565,6 +591,7 @@ TurnServerAllocation::TurnServerAllocation(TurnServer* server,
 
 TurnServerAllocation::~TurnServerAllocation() {
   channels_.clear();
+  channel_ids_.clear();
   perms_.clear();
   RTC_LOG(LS_INFO) << ToString() << ": Allocation destroyed";
 }
@@ -734,15 +761,17 @@ void TurnServerAllocation::HandleChannelBindRequest(const TurnMessage* msg) {
   }
 
   // Add or refresh this channel.
-  if (channel1 == channels_.end()) {
-    channel1 = channels_.insert(
-        channels_.end(), {.id = channel_id, .peer = peer_attr->GetAddress()});
+  if (channel1 == nullptr) {
+    channel1 = &channels_[channel_id];
+    channel1->id = channel_id;
+    channel1->peer = peer_attr->GetAddress();
+    channel_ids_[channel1->peer] = channel_id;
   } else {
     channel1->pending_delete.reset();
   }
   thread_->PostDelayedTask(
       SafeTask(channel1->pending_delete.flag(),
-               [this, channel1] { channels_.erase(channel1); }),
+               [this, channel_id] { RemoveChannel(channel_id); }),
       kChannelTimeout);
 
   // Channel binds also refresh permissions.
@@ -761,9 +790,9 @@ void TurnServerAllocation::HandleChannelData(
     rtc::ArrayView<const uint8_t> payload) {
   // Extract the channel number from the data.
   uint16_t channel_id = rtc::GetBE16(payload.data());
-  auto channel = FindChannel(channel_id);
-  if (channel != channels_.end()) {
-    // Send the data to the peer address.
+  Channel* channel = FindChannel(channel_id);
+  if (channel != nullptr) {
+    // Send the data to the peer address, straight from the received packet.
     SendExternal(payload.data() + TURN_CHANNEL_HEADER_SIZE,
                  payload.size() - TURN_CHANNEL_HEADER_SIZE, channel->peer);
   } else {
@@ -776,14 +805,10 @@ void TurnServerAllocation::HandleChannelData(
 void TurnServerAllocation::OnExternalPacket(rtc::AsyncPacketSocket* socket,
                                             const rtc::ReceivedPacket& packet) {
   RTC_DCHECK(external_socket_.get() == socket);
-  auto channel = FindChannel(packet.source_address());
-  if (channel != channels_.end()) {
+  Channel* channel = FindChannel(packet.source_address());
+  if (channel != nullptr) {
     // There is a channel bound to this address. Send as a channel message.
-    rtc::ByteBufferWriter buf;
-    buf.WriteUInt16(channel->id);
-    buf.WriteUInt16(static_cast<uint16_t>(packet.payload().size()));
-    buf.WriteBytes(packet.payload().data(), packet.payload().size());
-    server_->Send(&conn_, buf);
+    server_->SendChannelData(&conn_, channel->id, packet.payload());
   } else if (!server_->enable_permission_checks_ ||
              HasPermission(packet.source_address().ipaddr())) {
     // No channel, but a permission exists. Send as a data indication.
@@ -809,37 +834,35 @@ TimeDelta TurnServerAllocation::ComputeLifetime(const TurnMessage& msg) {
 }
 
 bool TurnServerAllocation::HasPermission(const rtc::IPAddress& addr) {
-  return FindPermission(addr) != perms_.end();
+  return perms_.find(addr) != perms_.end();
 }
 
 void TurnServerAllocation::AddPermission(const rtc::IPAddress& addr) {
-  auto perm = FindPermission(addr);
-  if (perm == perms_.end()) {
-    perm = perms_.insert(perms_.end(), {.peer = addr});
-  } else {
-    perm->pending_delete.reset();
-  }
-  thread_->PostDelayedTask(SafeTask(perm->pending_delete.flag(),
-                                    [this, perm] { perms_.erase(perm); }),
+  // Refreshing an existing permission cancels its pending removal.
+  Permission& perm = perms_[addr];
+  perm.pending_delete.reset();
+  thread_->PostDelayedTask(SafeTask(perm.pending_delete.flag(),
+                                    [this, addr] { perms_.erase(addr); }),
                            kPermissionTimeout);
 }
 
-TurnServerAllocation::PermissionList::iterator
-TurnServerAllocation::FindPermission(const rtc::IPAddress& addr) {
-  return absl::c_find_if(perms_,
-                         [&](const Permission& p) { return p.peer == addr; });
-}
-
-TurnServerAllocation::ChannelList::iterator TurnServerAllocation::FindChannel(
+TurnServerAllocation::Channel* TurnServerAllocation::FindChannel(
     int channel_id) {
-  return absl::c_find_if(channels_,
-                         [&](const Channel& c) { return c.id == channel_id; });
+  auto it = channels_.find(channel_id);
+  return it != channels_.end() ? &it->second : nullptr;
 }
 
-TurnServerAllocation::ChannelList::iterator TurnServerAllocation::FindChannel(
+TurnServerAllocation::Channel* TurnServerAllocation::FindChannel(
     const rtc::SocketAddress& addr) {
-  return absl::c_find_if(channels_,
-                         [&](const Channel& c) { return c.peer == addr; });
+  auto it = channel_ids_.find(addr);
+  return it != channel_ids_.end() ? FindChannel(it->second) : nullptr;
+}
+
+void TurnServerAllocation::RemoveChannel(int channel_id) {
+  auto it = channels_.find(channel_id);
+  RTC_DCHECK(it != channels_.end());
+  channel_ids_.erase(it->second.peer);
+  channels_.erase(it);
 }
 
 void TurnServerAllocation::SendResponse(TurnMessage* msg) {
@@ -11,11 +11,13 @@
 #ifndef P2P_BASE_TURN_SERVER_H_
 #define P2P_BASE_TURN_SERVER_H_
 
-#include <list>
+#include <stddef.h>
+
 #include <map>
 #include <memory>
 #include <set>
 #include <string>
+#include <unordered_map>
 #include <utility>
 #include <vector>
 
@@ -26,6 +28,8 @@
 #include "api/units/time_delta.h"
 #include "p2p/base/port_interface.h"
 #include "rtc_base/async_packet_socket.h"
+#include "rtc_base/buffer.h"
+#include "rtc_base/ip_address.h"
 #include "rtc_base/network/received_packet.h"
 #include "rtc_base/socket_address.h"
 #include "rtc_base/ssl_adapter.h"
@@ -51,6 +55,10 @@ const int TURN_SERVER_PORT = 3478;
 // Encapsulates the client's connection to the server.
 class TurnServerConnection {
  public:
+  struct Hasher {
+    size_t operator()(const TurnServerConnection& c) const { return c.Hash(); }
+  };
+
   TurnServerConnection() : proto_(PROTO_UDP), socket_(NULL) {}
   TurnServerConnection(const rtc::SocketAddress& src,
                        ProtocolType proto,
@@ -59,6 +67,8 @@ class TurnServerConnection {
   rtc::AsyncPacketSocket* socket() { return socket_; }
   bool operator==(const TurnServerConnection& t) const;
   bool operator<(const TurnServerConnection& t) const;
+  // Hashes the fields compared by operator==.
+  size_t Hash() const;
   std::string ToString() const;
 
  private:
@@ -104,10 +114,23 @@ class TurnServerAllocation {
   };
   struct Permission {
     webrtc::ScopedTaskSafety pending_delete;
-    rtc::IPAddress peer;
   };
-  using PermissionList = std::list<Permission>;
-  using ChannelList = std::list<Channel>;
+  struct IPAddressHasher {
+    size_t operator()(const rtc::IPAddress& ip) const {
+      return rtc::HashIP(ip);
+    }
+  };
+  struct SocketAddressHasher {
+    size_t operator()(const rtc::SocketAddress& address) const {
+      return address.Hash();
+    }
+  };
+  // Relayed packets look up permissions and channels, so they are hashed.
+  using PermissionMap =
+      std::unordered_map<rtc::IPAddress, Permission, IPAddressHasher>;
+  using ChannelMap = std::unordered_map<int, Channel>;
+  using ChannelIdMap =
+      std::unordered_map<rtc::SocketAddress, int, SocketAddressHasher>;
 
   void PostDeleteSelf(webrtc::TimeDelta delay);
 
@@ -123,9 +146,9 @@ class TurnServerAllocation {
   static webrtc::TimeDelta ComputeLifetime(const TurnMessage& msg);
   bool HasPermission(const rtc::IPAddress& addr);
   void AddPermission(const rtc::IPAddress& addr);
-  PermissionList::iterator FindPermission(const rtc::IPAddress& addr);
-  ChannelList::iterator FindChannel(int channel_id);
-  ChannelList::iterator FindChannel(const rtc::SocketAddress& addr);
+  Channel* FindChannel(int channel_id);
+  Channel* FindChannel(const rtc::SocketAddress& addr);
+  void RemoveChannel(int channel_id);
 
   void SendResponse(TurnMessage* msg);
   void SendBadRequestResponse(const TurnMessage* req);
@@ -144,8 +167,10 @@ class TurnServerAllocation {
   std::string transaction_id_;
   std::string username_;
   std::string last_nonce_;
-  PermissionList perms_;
-  ChannelList channels_;
+  PermissionMap perms_;
+  ChannelMap channels_;
+  // The channel id bound to each peer address.
+  ChannelIdMap channel_ids_;
   webrtc::ScopedTaskSafety safety_;
 };
 
@@ -182,7 +207,9 @@ class StunMessageObserver {
 // Not yet wired up: TCP support.
 class TurnServer : public sigslot::has_slots<> {
  public:
-  typedef std::map<TurnServerConnection, std::unique_ptr<TurnServerAllocation>>
+  typedef std::unordered_map<TurnServerConnection,
+                             std::unique_ptr<TurnServerAllocation>,
+                             TurnServerConnection::Hasher>
       AllocationMap;
 
   explicit TurnServer(webrtc::TaskQueueBase* thread);
@@ -271,6 +298,7 @@ class TurnServer : public sigslot::has_slots<> {
 
   std::string GenerateNonce(int64_t now) const RTC_RUN_ON(thread_);
   void OnInternalPacket(rtc::AsyncPacketSocket* socket,
+                        ProtocolType proto,
                         const rtc::ReceivedPacket& packet) RTC_RUN_ON(thread_);
 
   void OnNewInternalConnection(rtc::Socket* socket);
@@ -319,6 +347,10 @@ class TurnServer : public sigslot::has_slots<> {
 
   void SendStun(TurnServerConnection* conn, StunMessage* msg);
   void Send(TurnServerConnection* conn, const rtc::ByteBufferWriter& buf);
+  // Sends `payload` to the client as ChannelData of `channel_id`.
+  void SendChannelData(TurnServerConnection* conn,
+                       int channel_id,
+                       rtc::ArrayView<const uint8_t> payload);
 
   void DestroyAllocation(TurnServerAllocation* allocation) RTC_RUN_ON(thread_);
   void DestroyInternalSocket(rtc::AsyncPacketSocket* socket)
@@ -353,6 +385,10 @@ class TurnServer : public sigslot::has_slots<> {
 
   AllocationMap allocations_ RTC_GUARDED_BY(thread_);
 
+  // Reused to frame the packets relayed to clients as ChannelData, so that
+  // relaying does not allocate.
+  rtc::Buffer channel_data_buffer_ RTC_GUARDED_BY(thread_);
+
   // For testing only. If this is non-zero, the next NONCE will be generated
   // from this value, and it will be reset to 0 after generating the NONCE.
   int64_t ts_for_next_nonce_ RTC_GUARDED_BY(thread_) = 0;
@@ -0,0 +1,278 @@
+/*
+ *  Copyright 2024 The WebRTC Project Authors. All rights reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <stdint.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "absl/strings/string_view.h"
+#include "api/array_view.h"
+#include "api/async_dns_resolver.h"
+#include "api/packet_socket_factory.h"
+#include "api/transport/stun.h"
+#include "benchmark/benchmark.h"
+#include "p2p/base/turn_server.h"
+#include "rtc_base/async_packet_socket.h"
+#include "rtc_base/byte_buffer.h"
+#include "rtc_base/byte_order.h"
+#include "rtc_base/checks.h"
+#include "rtc_base/network/received_packet.h"
+#include "rtc_base/socket_address.h"
+#include "rtc_base/system/unused.h"
+#include "rtc_base/thread.h"
+
+namespace cricket {
+namespace {
+
+constexpr char kRealm[] = "example.org";
+constexpr int kChannelId = kMinTurnChannelNumber;
+constexpr size_t kChannelHeaderSize = 4;
+constexpr size_t kPayloadSize = 1200;
+const rtc::SocketAddress kServerAddress("10.0.0.1", 3478);
+const rtc::SocketAddress kPeerAddress("10.0.0.3", 5000);
+
+// A UDP socket without I/O. Packets are injected with Receive(), and sent
+// packets are dropped unless captured.
+class FakeUdpSocket : public rtc::AsyncPacketSocket {
+ public:
+  explicit FakeUdpSocket(const rtc::SocketAddress& address)
+      : address_(address) {}
+
+  void Receive(rtc::ArrayView<const uint8_t> data,
+               const rtc::SocketAddress& from) {
+    NotifyPacketReceived(rtc::ReceivedPacket(data, from));
+  }
+
+  // Returns the last packet sent while capturing.
+  const std::vector<uint8_t>& last_sent() const { return last_sent_; }
+  void set_capture(bool capture) { capture_ = capture; }
+
+  rtc::SocketAddress GetLocalAddress() const override { return address_; }
+  rtc::SocketAddress GetRemoteAddress() const override {
+    return rtc::SocketAddress();
+  }
+  int Send(const void* pv,
+           size_t cb,
+           const rtc::PacketOptions& options) override {
+    return -1;
+  }
+  int SendTo(const void* pv,
+             size_t cb,
+             const rtc::SocketAddress& addr,
+             const rtc::PacketOptions& options) override {
+    if (capture_) {
+      const uint8_t* data = static_cast<const uint8_t*>(pv);
+      last_sent_.assign(data, data + cb);
+    }
+    benchmark::DoNotOptimize(pv);
+    return static_cast<int>(cb);
+  }
+  int Close() override { return 0; }
+  State GetState() const override { return STATE_BOUND; }
+  int GetOption(rtc::Socket::Option opt, int* value) override { return -1; }
+  int SetOption(rtc::Socket::Option opt, int value) override { return -1; }
+  int GetError() const override { return 0; }
+  void SetError(int error) override {}
+
+ private:
+  const rtc::SocketAddress address_;
+  bool capture_ = true;
+  std::vector<uint8_t> last_sent_;
+};
+
+// Hands out FakeUdpSocket relay sockets and remembers the last one.
+class FakeSocketFactory : public rtc::PacketSocketFactory {
+ public:
+  FakeUdpSocket* last_socket() { return last_socket_; }
+
+  rtc::AsyncPacketSocket* CreateUdpSocket(const rtc::SocketAddress& address,
+                                          uint16_t min_port,
+                                          uint16_t max_port) override {
+    last_socket_ =
+        new FakeUdpSocket(rtc::SocketAddress(address.ipaddr(), next_port_++));
+    return last_socket_;
+  }
+  rtc::AsyncListenSocket* CreateServerTcpSocket(
+      const rtc::SocketAddress& local_address,
+      uint16_t min_port,
+      uint16_t max_port,
+      int opts) override {
+    return nullptr;
+  }
+  rtc::AsyncPacketSocket* CreateClientTcpSocket(
+      const rtc::SocketAddress& local_address,
+      const rtc::SocketAddress& remote_address,
+      const rtc::PacketSocketTcpOptions& tcp_options) override {
+    return nullptr;
+  }
+  std::unique_ptr<webrtc::AsyncDnsResolverInterface> CreateAsyncDnsResolver()
+      override {
+    return nullptr;
+  }
+
+ private:
+  FakeUdpSocket* last_socket_ = nullptr;
+  int next_port_ = 50000;
+};
+
+class PasswordIsUsernameAuth : public TurnAuthInterface {
+ public:
+  bool GetKey(absl::string_view username,
+              absl::string_view realm,
+              std::string* key) override {
+    return ComputeStunCredentialHash(std::string(username), std::string(realm),
+                                     std::string(username), key);
+  }
+};
+
+// A TurnServer with `num_allocations` clients, each with a channel bound to
+// the same peer.
+class RelayFixture {
+ public:
+  explicit RelayFixture(int num_allocations)
+      : server_(rtc::Thread::Current()),
+        internal_socket_(new FakeUdpSocket(kServerAddress)),
+        socket_factory_(new FakeSocketFactory()) {
+    server_.AddInternalSocket(internal_socket_, PROTO_UDP);
+    server_.SetExternalSocketFactory(socket_factory_,
+                                     rtc::SocketAddress("10.0.0.2", 0));
+    server_.set_realm(kRealm);
+    server_.set_auth_hook(&auth_);
+    for (int i = 0; i < num_allocations; ++i) {
+      rtc::SocketAddress client("192.168.0.1", 10000 + i);
+      Allocate(client);
+      clients_.push_back(client);
+      relay_sockets_.push_back(socket_factory_->last_socket());
+      relay_sockets_.back()->set_capture(false);
+    }
+    internal_socket_->set_capture(false);
+  }
+
+  FakeUdpSocket& internal_socket() { return *internal_socket_; }
+  const std::vector<rtc::SocketAddress>& clients() const { return clients_; }
+  const std::vector<FakeUdpSocket*>& relay_sockets() const {
+    return relay_sockets_;
+  }
+
+ private:
+  void Allocate(const rtc::SocketAddress& client) {
+    TurnMessage challenge_request(STUN_ALLOCATE_REQUEST, NewTransactionId());
+    AddRequestedTransport(challenge_request);
+    std::unique_ptr<TurnMessage> challenge =
+        Exchange(client, challenge_request);
+    const StunByteStringAttribute* nonce =
+        challenge->GetByteString(STUN_ATTR_NONCE);
+    RTC_CHECK(nonce);
+    std::string nonce_value(nonce->string_view());
+
+    std::string username = "user" + std::to_string(client.port());
+    TurnMessage allocate(STUN_ALLOCATE_REQUEST, NewTransactionId());
+    AddRequestedTransport(allocate);
+    Authenticate(allocate, username, nonce_value);
+    RTC_CHECK_EQ(Exchange(client, allocate)->type(), STUN_ALLOCATE_RESPONSE);
+
+    TurnMessage bind(TURN_CHANNEL_BIND_REQUEST, NewTransactionId());
+    bind.AddAttribute(std::make_unique<StunUInt32Attribute>(
+        STUN_ATTR_CHANNEL_NUMBER, kChannelId << 16));
+    bind.AddAttribute(std::make_unique<StunXorAddressAttribute>(
+        STUN_ATTR_XOR_PEER_ADDRESS, kPeerAddress));
+    Authenticate(bind, username, nonce_value);
+    RTC_CHECK_EQ(Exchange(client, bind)->type(), TURN_CHANNEL_BIND_RESPONSE);
+  }
+
+  std::unique_ptr<TurnMessage> Exchange(const rtc::SocketAddress& client,
+                                        const StunMessage& request) {
+    rtc::ByteBufferWriter buf;
+    request.Write(&buf);
+    internal_socket_->Receive(
+        rtc::ArrayView<const uint8_t>(buf.Data(), buf.Length()), client);
+    rtc::ByteBufferReader reader(internal_socket_->last_sent());
+    auto response = std::make_unique<TurnMessage>();
+    RTC_CHECK(response->Read(&reader));
+    return response;
+  }
+
+  void AddRequestedTransport(StunMessage& msg) {
+    msg.AddAttribute(std::make_unique<StunUInt32Attribute>(
+        STUN_ATTR_REQUESTED_TRANSPORT, IPPROTO_UDP << 24));
+  }
+
+  void Authenticate(StunMessage& msg,
+                    const std::string& username,
+                    const std::string& nonce) {
+    std::string key;
+    RTC_CHECK(ComputeStunCredentialHash(username, kRealm, username, &key));
+    msg.AddAttribute(std::make_unique<StunByteStringAttribute>(
+        STUN_ATTR_USERNAME, username));
+    msg.AddAttribute(
+        std::make_unique<StunByteStringAttribute>(STUN_ATTR_REALM, kRealm));
+    msg.AddAttribute(
+        std::make_unique<StunByteStringAttribute>(STUN_ATTR_NONCE, nonce));
+    msg.AddMessageIntegrity(key);
+  }
+
+  std::string NewTransactionId() {
+    std::string id = std::to_string(next_transaction_id_++);
+    return std::string(kStunTransactionIdLength - id.size(), '0') + id;
+  }
+
+  rtc::AutoThread main_thread_;
+  PasswordIsUsernameAuth auth_;
+  TurnServer server_;
+  // Owned by `server_`.
+  FakeUdpSocket* const internal_socket_;
+  FakeSocketFactory* const socket_factory_;
+  std::vector<rtc::SocketAddress> clients_;
+  std::vector<FakeUdpSocket*> relay_sockets_;
+  int next_transaction_id_ = 0;
+};
+
+// ChannelData from the clients, relayed to the peer. Items per second is the
+// number of packets relayed per second on one core.
+void BM_RelayChannelDataToPeer(benchmark::State& state) {
+  RelayFixture fixture(state.range(0));
+  std::vector<uint8_t> packet(kChannelHeaderSize + kPayloadSize);
+  rtc::SetBE16(packet.data(), kChannelId);
+  rtc::SetBE16(packet.data() + 2, kPayloadSize);
+  const std::vector<rtc::SocketAddress>& clients = fixture.clients();
+  size_t next_client = 0;
+  for (auto s : state) {
+    RTC_UNUSED(s);
+    fixture.internal_socket().Receive(packet, clients[next_client]);
+    if (++next_client == clients.size()) {
+      next_client = 0;
+    }
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
+// Data from the peer, relayed to the clients as ChannelData.
+void BM_RelayPeerDataToClient(benchmark::State& state) {
+  RelayFixture fixture(state.range(0));
+  std::vector<uint8_t> payload(kPayloadSize);
+  const std::vector<FakeUdpSocket*>& relay_sockets = fixture.relay_sockets();
+  size_t next_socket = 0;
+  for (auto s : state) {
+    RTC_UNUSED(s);
+    relay_sockets[next_socket]->Receive(payload, kPeerAddress);
+    if (++next_socket == relay_sockets.size()) {
+      next_socket = 0;
+    }
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK(BM_RelayChannelDataToPeer)->Arg(1)->Arg(1000);
+BENCHMARK(BM_RelayPeerDataToClient)->Arg(1)->Arg(1000);
+
+}  // namespace
+}  // namespace cricket
@@ -112,6 +112,7 @@ ConnectionContext::ConnectionContext(
       sctp_factory_(
           MaybeCreateSctpFactory(std::move(dependencies->sctp_factory),
                                  network_thread())),
+      dtls_session_cache_(rtc::SSLSessionCache::Create()),
       use_rtx_(true) {
   RTC_DCHECK_RUN_ON(signaling_thread_);
   RTC_DCHECK(!(default_network_manager_ && network_monitor_factory_))
@@ -176,6 +177,15 @@ ConnectionContext::ConnectionContext(
   }
 }
 
+rtc::scoped_refptr<SrtpCryptoPool> ConnectionContext::srtp_crypto_pool(
+    int num_threads) {
+  RTC_DCHECK_RUN_ON(network_thread_);
+  if (!srtp_crypto_pool_) {
+    srtp_crypto_pool_ = SrtpCryptoPool::Create(num_threads);
+  }
+  return srtp_crypto_pool_;
+}
+
 ConnectionContext::~ConnectionContext() {
   RTC_DCHECK_RUN_ON(signaling_thread_);
   // `media_engine_` requires destruction to happen on the worker thread.
@@ -23,11 +23,13 @@
 #include "api/transport/sctp_transport_factory_interface.h"
 #include "media/base/media_engine.h"
 #include "p2p/base/basic_packet_socket_factory.h"
+#include "pc/srtp_crypto_pool.h"
 #include "rtc_base/checks.h"
 #include "rtc_base/network.h"
 #include "rtc_base/network_monitor_factory.h"
 #include "rtc_base/rtc_certificate_generator.h"
 #include "rtc_base/socket_factory.h"
+#include "rtc_base/ssl_stream_adapter.h"
 #include "rtc_base/thread.h"
 #include "rtc_base/thread_annotations.h"
 
@@ -92,6 +94,13 @@ class ConnectionContext final : public RefCountedNonVirtual<ConnectionContext> {
     return call_factory_.get();
   }
   rtc::UniqueRandomIdGenerator* ssrc_generator() { return &ssrc_generator_; }
+  // Shared by the PeerConnections that enable DTLS session resumption.
+  const rtc::scoped_refptr<rtc::SSLSessionCache>& dtls_session_cache() const {
+    return dtls_session_cache_;
+  }
+  // Shared by the PeerConnections that offload SRTP crypto. Created with
+  // `num_threads` threads when first requested.
+  rtc::scoped_refptr<SrtpCryptoPool> srtp_crypto_pool(int num_threads);
   // Note: There is lots of code that wants to know whether or not we
   // use RTX, but so far, no code has been found that sets it to false.
   // Kept in the API in order to ease introduction if we want to resurrect
@@ -140,6 +149,9 @@ class ConnectionContext final : public RefCountedNonVirtual<ConnectionContext> {
   std::unique_ptr<rtc::PacketSocketFactory> default_socket_factory_
       RTC_GUARDED_BY(signaling_thread_);
   std::unique_ptr<SctpTransportFactoryInterface> const sctp_factory_;
+  const rtc::scoped_refptr<rtc::SSLSessionCache> dtls_session_cache_;
+  rtc::scoped_refptr<SrtpCryptoPool> srtp_crypto_pool_
+      RTC_GUARDED_BY(network_thread_);
 
   // Controls whether to announce support for the the rfc4588 payload format
   // for retransmitted video packets.
@@ -419,9 +419,13 @@ JsepTransportController::CreateDtlsTransport(
     dtls = config_.dtls_transport_factory->CreateDtlsTransport(
         ice, config_.crypto_options, config_.ssl_max_version);
   } else {
-    dtls = std::make_unique<cricket::DtlsTransport>(ice, config_.crypto_options,
-                                                    config_.event_log,
-                                                    config_.ssl_max_version);
+    auto dtls_transport = std::make_unique<cricket::DtlsTransport>(
+        ice, config_.crypto_options, config_.event_log,
+        config_.ssl_max_version);
+    if (config_.dtls_session_cache) {
+      dtls_transport->SetSessionCache(config_.dtls_session_cache);
+    }
+    dtls = std::move(dtls_transport);
   }
 
   RTC_DCHECK(dtls);
@@ -502,6 +506,8 @@ std::unique_ptr<SrtpTransport> JsepTransportController::CreateSdesTransport(
   }
   if (config_.enable_external_auth) {
     srtp_transport->EnableExternalAuth();
+  } else if (config_.srtp_crypto_pool) {
+    srtp_transport->SetCryptoPool(config_.srtp_crypto_pool);
   }
   return srtp_transport;
 }
@@ -516,6 +522,8 @@ JsepTransportController::CreateDtlsSrtpTransport(
       rtcp_dtls_transport == nullptr, env_.field_trials());
   if (config_.enable_external_auth) {
     dtls_srtp_transport->EnableExternalAuth();
+  } else if (config_.srtp_crypto_pool) {
+    dtls_srtp_transport->SetCryptoPool(config_.srtp_crypto_pool);
   }
 
   dtls_srtp_transport->SetDtlsTransports(rtp_dtls_transport,
@@ -56,6 +56,7 @@
 #include "pc/rtp_transport_internal.h"
 #include "pc/sctp_transport.h"
 #include "pc/session_description.h"
+#include "pc/srtp_crypto_pool.h"
 #include "pc/srtp_transport.h"
 #include "pc/transport_stats.h"
 #include "rtc_base/callback_list.h"
@@ -114,6 +115,12 @@ class JsepTransportController : public sigslot::has_slots<> {
     // `crypto_options` is used to determine if created DTLS transports
     // negotiate GCM crypto suites or not.
     CryptoOptions crypto_options;
+    // If set, DTLS transports created without `dtls_transport_factory` resume
+    // sessions from this cache.
+    rtc::scoped_refptr<rtc::SSLSessionCache> dtls_session_cache;
+    // If set, SRTP transports offload encryption and decryption to this pool,
+    // unless `enable_external_auth` is set.
+    rtc::scoped_refptr<SrtpCryptoPool> srtp_crypto_pool;
     PeerConnectionInterface::BundlePolicy bundle_policy =
         PeerConnectionInterface::kBundlePolicyBalanced;
     PeerConnectionInterface::RtcpMuxPolicy rtcp_mux_policy =
@@ -751,6 +751,13 @@ JsepTransportController* PeerConnection::InitializeTransportController_n(
   config.crypto_options = configuration.crypto_options.has_value()
                               ? *configuration.crypto_options
                               : options_.crypto_options;
+  if (options_.enable_dtls_session_resumption) {
+    config.dtls_session_cache = context_->dtls_session_cache();
+  }
+  if (options_.srtp_crypto_threads > 0) {
+    config.srtp_crypto_pool =
+        context_->srtp_crypto_pool(options_.srtp_crypto_threads);
+  }
   config.transport_observer = this;
   config.rtcp_handler = InitializeRtcpCallback();
   config.un_demuxable_packet_handler = InitializeUnDemuxablePacketHandler();
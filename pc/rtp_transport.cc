@@ -64,10 +64,10 @@ void RtpTransport::SetRtpPacketTransport(
   if (new_packet_transport) {
     new_packet_transport->SignalReadyToSend.connect(
         this, &RtpTransport::OnReadyToSend);
-    new_packet_transport->RegisterReceivedPacketCallback(
+    new_packet_transport->RegisterReceivedPacketsCallback(
         this, [&](rtc::PacketTransportInternal* transport,
-                  const rtc::ReceivedPacket& packet) {
-          OnReadPacket(transport, packet);
+                  rtc::ArrayView<const rtc::ReceivedPacket> packets) {
+          OnReadPackets(transport, packets);
         });
     new_packet_transport->SignalNetworkRouteChanged.connect(
         this, &RtpTransport::OnNetworkRouteChanged);
@@ -103,10 +103,10 @@ void RtpTransport::SetRtcpPacketTransport(
   if (new_packet_transport) {
     new_packet_transport->SignalReadyToSend.connect(
         this, &RtpTransport::OnReadyToSend);
-    new_packet_transport->RegisterReceivedPacketCallback(
+    new_packet_transport->RegisterReceivedPacketsCallback(
         this, [&](rtc::PacketTransportInternal* transport,
-                  const rtc::ReceivedPacket& packet) {
-          OnReadPacket(transport, packet);
+                  rtc::ArrayView<const rtc::ReceivedPacket> packets) {
+          OnReadPackets(transport, packets);
         });
     new_packet_transport->SignalNetworkRouteChanged.connect(
         this, &RtpTransport::OnNetworkRouteChanged);
@@ -249,16 +249,23 @@ void RtpTransport::OnSentPacket(rtc::PacketTransportInternal* packet_transport,
 
 void RtpTransport::OnRtpPacketReceived(
     const rtc::ReceivedPacket& received_packet) {
-  rtc::CopyOnWriteBuffer payload(received_packet.payload());
+  rtc::CopyOnWriteBuffer payload = received_packet.SharePayload();
   DemuxPacket(
-      payload,
+      std::move(payload),
       received_packet.arrival_time().value_or(Timestamp::MinusInfinity()),
       received_packet.ecn());
 }
 
+void RtpTransport::OnRtpPacketsReceived(
+    rtc::ArrayView<const rtc::ReceivedPacket> packets) {
+  for (const rtc::ReceivedPacket& packet : packets) {
+    OnRtpPacketReceived(packet);
+  }
+}
+
 void RtpTransport::OnRtcpPacketReceived(
     const rtc::ReceivedPacket& received_packet) {
-  rtc::CopyOnWriteBuffer payload(received_packet.payload());
+  rtc::CopyOnWriteBuffer payload = received_packet.SharePayload();
   // TODO(bugs.webrtc.org/15368): Propagate timestamp and maybe received packet
   // further.
   SendRtcpPacketReceived(&payload, received_packet.arrival_time()
@@ -266,34 +273,56 @@ void RtpTransport::OnRtcpPacketReceived(
                                        : -1);
 }
 
-void RtpTransport::OnReadPacket(rtc::PacketTransportInternal* transport,
-                                const rtc::ReceivedPacket& received_packet) {
-  TRACE_EVENT0("webrtc", "RtpTransport::OnReadPacket");
-
-  // When using RTCP multiplexing we might get RTCP packets on the RTP
-  // transport. We check the RTP payload type to determine if it is RTCP.
-  cricket::RtpPacketType packet_type =
-      cricket::InferRtpPacketType(received_packet.payload());
-  // Filter out the packet that is neither RTP nor RTCP.
-  if (packet_type == cricket::RtpPacketType::kUnknown) {
-    return;
-  }
+void RtpTransport::OnReadPackets(
+    rtc::PacketTransportInternal* transport,
+    rtc::ArrayView<const rtc::ReceivedPacket> received_packets) {
+  TRACE_EVENT1("webrtc", "RtpTransport::OnReadPackets", "packets",
+               received_packets.size());
+
+  // Consecutive RTP packets are handed on together, up to the next packet
+  // that is not, so that the packets stay in order.
+  size_t rtp_begin = 0;
+  size_t rtp_count = 0;
+  auto flush_rtp_packets = [&] {
+    if (rtp_count > 0) {
+      OnRtpPacketsReceived(received_packets.subview(rtp_begin, rtp_count));
+      rtp_count = 0;
+    }
+  };
+  for (size_t i = 0; i < received_packets.size(); ++i) {
+    const rtc::ReceivedPacket& received_packet = received_packets[i];
+    // When using RTCP multiplexing we might get RTCP packets on the RTP
+    // transport. We check the RTP payload type to determine if it is RTCP.
+    cricket::RtpPacketType packet_type =
+        cricket::InferRtpPacketType(received_packet.payload());
+    // Filter out the packet that is neither RTP nor RTCP.
+    if (packet_type == cricket::RtpPacketType::kUnknown) {
+      flush_rtp_packets();
+      continue;
+    }
 
-  // Protect ourselves against crazy data.
-  if (!cricket::IsValidRtpPacketSize(packet_type,
-                                     received_packet.payload().size())) {
-    RTC_LOG(LS_ERROR) << "Dropping incoming "
-                      << cricket::RtpPacketTypeToString(packet_type)
-                      << " packet: wrong size="
-                      << received_packet.payload().size();
-    return;
-  }
+    // Protect ourselves against crazy data.
+    if (!cricket::IsValidRtpPacketSize(packet_type,
+                                       received_packet.payload().size())) {
+      RTC_LOG(LS_ERROR) << "Dropping incoming "
+                        << cricket::RtpPacketTypeToString(packet_type)
+                        << " packet: wrong size="
+                        << received_packet.payload().size();
+      flush_rtp_packets();
+      continue;
+    }
 
-  if (packet_type == cricket::RtpPacketType::kRtcp) {
-    OnRtcpPacketReceived(received_packet);
-  } else {
-    OnRtpPacketReceived(received_packet);
+    if (packet_type == cricket::RtpPacketType::kRtcp) {
+      flush_rtp_packets();
+      OnRtcpPacketReceived(received_packet);
+    } else {
+      if (rtp_count == 0) {
+        rtp_begin = i;
+      }
+      ++rtp_count;
+    }
   }
+  flush_rtp_packets();
 }
 
 void RtpTransport::SetReadyToSend(bool rtcp, bool ready) {
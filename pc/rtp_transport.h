@@ -17,6 +17,7 @@
 #include <string>
 
 #include "absl/types/optional.h"
+#include "api/array_view.h"
 #include "api/task_queue/pending_task_safety_flag.h"
 #include "api/units/timestamp.h"
 #include "call/rtp_demuxer.h"
@@ -106,6 +107,10 @@ class RtpTransport : public RtpTransportInternal {
   virtual void OnNetworkRouteChanged(
       absl::optional<rtc::NetworkRoute> network_route);
   virtual void OnRtpPacketReceived(const rtc::ReceivedPacket& packet);
+  // Handles a run of RTP packets received together, in order. Calls
+  // OnRtpPacketReceived for each packet by default.
+  virtual void OnRtpPacketsReceived(
+      rtc::ArrayView<const rtc::ReceivedPacket> packets);
   virtual void OnRtcpPacketReceived(const rtc::ReceivedPacket& packet);
   // Overridden by SrtpTransport and DtlsSrtpTransport.
   virtual void OnWritableState(rtc::PacketTransportInternal* packet_transport);
@@ -114,8 +119,10 @@ class RtpTransport : public RtpTransportInternal {
   void OnReadyToSend(rtc::PacketTransportInternal* transport);
   void OnSentPacket(rtc::PacketTransportInternal* packet_transport,
                     const rtc::SentPacket& sent_packet);
-  void OnReadPacket(rtc::PacketTransportInternal* transport,
-                    const rtc::ReceivedPacket& received_packet);
+  // Handles the packets received on `transport` together.
+  void OnReadPackets(
+      rtc::PacketTransportInternal* transport,
+      rtc::ArrayView<const rtc::ReceivedPacket> received_packets);
 
   // Updates "ready to send" for an individual channel and fires
   // SignalReadyToSend.
@@ -11,18 +11,24 @@
 #include "pc/rtp_transport.h"
 
 #include <utility>
+#include <vector>
 
 #include "p2p/base/fake_packet_transport.h"
 #include "pc/test/rtp_transport_test_util.h"
 #include "rtc_base/buffer.h"
 #include "rtc_base/containers/flat_set.h"
 #include "rtc_base/gunit.h"
+#include "rtc_base/network/received_packet.h"
+#include "rtc_base/socket_address.h"
 #include "rtc_base/third_party/sigslot/sigslot.h"
+#include "test/gmock.h"
 #include "test/gtest.h"
 #include "test/run_loop.h"
 
 namespace webrtc {
 
+using ::testing::ElementsAre;
+
 constexpr bool kMuxDisabled = false;
 constexpr bool kMuxEnabled = true;
 constexpr uint16_t kLocalNetId = 1;
@@ -348,6 +354,47 @@ TEST(RtpTransportTest, DontSignalUnhandledRtpPayloadType) {
   transport.UnregisterRtpDemuxerSink(&observer);
 }
 
+// Records the runs of RTP packets that are handled together.
+class RunRecordingRtpTransport : public RtpTransport {
+ public:
+  using RtpTransport::RtpTransport;
+
+  void OnRtpPacketsReceived(
+      rtc::ArrayView<const rtc::ReceivedPacket> packets) override {
+    run_sizes.push_back(packets.size());
+    RtpTransport::OnRtpPacketsReceived(packets);
+  }
+
+  std::vector<size_t> run_sizes;
+};
+
+// Test that consecutive RTP packets of a received batch are handled together,
+// and that the runs are split by the RTCP and unknown packets between them.
+TEST(RtpTransportTest, HandlesRunsOfReceivedRtpPacketsTogether) {
+  RunRecordingRtpTransport transport(kMuxEnabled);
+  rtc::FakePacketTransport fake_rtp("fake_rtp");
+  transport.SetRtpPacketTransport(&fake_rtp);
+  TransportObserver observer(&transport);
+  RtpDemuxerCriteria demuxer_criteria;
+  demuxer_criteria.payload_types().insert(0x11);
+  transport.RegisterRtpDemuxerSink(demuxer_criteria, &observer);
+
+  const unsigned char rtcp_data[] = {0x80, 73, 0, 0};
+  const unsigned char unknown_data[kRtpLen] = {};
+  rtc::SocketAddress source;
+  rtc::ReceivedPacket rtp(kRtpData, source);
+  rtc::ReceivedPacket rtcp(rtcp_data, source);
+  rtc::ReceivedPacket unknown(unknown_data, source);
+  std::vector<rtc::ReceivedPacket> packets = {rtp,     rtp, rtcp, rtp,
+                                              unknown, rtp, rtp};
+  fake_rtp.NotifyPacketsReceived(packets);
+  EXPECT_THAT(transport.run_sizes, ElementsAre(2, 1, 2));
+  EXPECT_EQ(5, observer.rtp_count());
+  EXPECT_EQ(1, observer.rtcp_count());
+  // Remove the sink before destroying the transport.
+  transport.UnregisterRtpDemuxerSink(&observer);
+}
+
 TEST(RtpTransportTest, RecursiveSetSendDoesNotCrash) {
   const int kShortTimeout = 100;
   test::RunLoop loop;
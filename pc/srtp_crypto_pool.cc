@@ -0,0 +1,42 @@
+/*
+ *  Copyright 2024 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "pc/srtp_crypto_pool.h"
+
+#include <string>
+#include <utility>
+
+#include "api/make_ref_counted.h"
+#include "rtc_base/checks.h"
+
+namespace webrtc {
+
+// static
+scoped_refptr<SrtpCryptoPool> SrtpCryptoPool::Create(int num_threads) {
+  return make_ref_counted<SrtpCryptoPool>(num_threads);
+}
+
+SrtpCryptoPool::SrtpCryptoPool(int num_threads) {
+  RTC_DCHECK_GT(num_threads, 0);
+  for (int i = 0; i < num_threads; ++i) {
+    std::unique_ptr<rtc::Thread> thread = rtc::Thread::Create();
+    thread->SetName("SrtpCrypto" + std::to_string(i), nullptr);
+    thread->Start();
+    threads_.push_back(std::move(thread));
+  }
+}
+
+SrtpCryptoPool::~SrtpCryptoPool() = default;
+
+rtc::Thread* SrtpCryptoPool::AssignThread() {
+  return threads_[next_thread_++ % threads_.size()].get();
+}
+
+}  // namespace webrtc
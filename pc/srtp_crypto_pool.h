@@ -0,0 +1,50 @@
+/*
+ *  Copyright 2024 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef PC_SRTP_CRYPTO_POOL_H_
+#define PC_SRTP_CRYPTO_POOL_H_
+
+#include <atomic>
+#include <memory>
+#include <vector>
+
+#include "api/ref_count.h"
+#include "api/scoped_refptr.h"
+#include "rtc_base/thread.h"
+
+namespace webrtc {
+
+// A pool of threads that SrtpTransports move their encryption and decryption
+// to, so that SRTP is not limited to the network thread. Each transport is
+// assigned one thread for its lifetime, which keeps its packets in order and
+// its sessions, including their replay windows, on a single thread. The pool
+// is thread safe and can be shared by any number of transports.
+class SrtpCryptoPool : public RefCountInterface {
+ public:
+  static scoped_refptr<SrtpCryptoPool> Create(int num_threads);
+
+  // Returns the thread for the next transport. Threads are handed out round
+  // robin.
+  rtc::Thread* AssignThread();
+
+  int num_threads() const { return static_cast<int>(threads_.size()); }
+
+ protected:
+  explicit SrtpCryptoPool(int num_threads);
+  ~SrtpCryptoPool() override;
+
+ private:
+  std::vector<std::unique_ptr<rtc::Thread>> threads_;
+  std::atomic<unsigned> next_thread_{0};
+};
+
+}  // namespace webrtc
+
+#endif  // PC_SRTP_CRYPTO_POOL_H_
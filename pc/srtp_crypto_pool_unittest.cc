@@ -0,0 +1,38 @@
+/*
+ *  Copyright 2024 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "pc/srtp_crypto_pool.h"
+
+#include "api/scoped_refptr.h"
+#include "rtc_base/thread.h"
+#include "test/gtest.h"
+
+namespace webrtc {
+namespace {
+
+TEST(SrtpCryptoPoolTest, AssignsThreadsRoundRobin) {
+  scoped_refptr<SrtpCryptoPool> pool = SrtpCryptoPool::Create(2);
+  EXPECT_EQ(2, pool->num_threads());
+  rtc::Thread* first = pool->AssignThread();
+  rtc::Thread* second = pool->AssignThread();
+  EXPECT_NE(first, second);
+  EXPECT_EQ(first, pool->AssignThread());
+  EXPECT_EQ(second, pool->AssignThread());
+}
+
+TEST(SrtpCryptoPoolTest, ThreadsAreRunning) {
+  scoped_refptr<SrtpCryptoPool> pool = SrtpCryptoPool::Create(1);
+  rtc::Thread* thread = pool->AssignThread();
+  EXPECT_FALSE(thread->IsCurrent());
+  EXPECT_TRUE(thread->BlockingCall([&] { return thread->IsCurrent(); }));
+}
+
+}  // namespace
+}  // namespace webrtc
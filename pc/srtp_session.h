@@ -16,6 +16,7 @@
 
 #include <vector>
 
+#include "api/array_view.h"
 #include "api/field_trials_view.h"
 #include "api/scoped_refptr.h"
 #include "api/sequence_checker.h"
@@ -79,6 +80,24 @@ class SrtpSession {
   bool UnprotectRtp(void* data, int in_len, int* out_len);
   bool UnprotectRtcp(void* data, int in_len, int* out_len);
 
+  // An RTP packet for the batch versions of ProtectRtp and UnprotectRtp.
+  struct BatchPacket {
+    void* data = nullptr;
+    // The length of the packet. Updated if the packet is processed.
+    int len = 0;
+    // The size of the buffer, only used when protecting.
+    int max_len = 0;
+    // Set to whether the packet was processed.
+    bool ok = false;
+  };
+  // Encrypts/signs or decrypts/verifies a batch of RTP packets in place, in
+  // order. Equivalent to calling ProtectRtp or UnprotectRtp for each packet,
+  // but the thread and session checks and the trace event are done once per
+  // batch. A packet that fails does not stop the others. Returns the number
+  // of packets processed.
+  int ProtectRtp(rtc::ArrayView<BatchPacket> packets);
+  int UnprotectRtp(rtc::ArrayView<BatchPacket> packets);
+
   // Helper method to get authentication params.
   bool GetRtpAuthParams(uint8_t** key, int* key_len, int* tag_len);
 
@@ -105,6 +124,11 @@ class SrtpSession {
   // https://www.rfc-editor.org/rfc/rfc7714#section-8.4
   bool RemoveSsrcFromSession(uint32_t ssrc);
 
+  // Detaches the session from the current thread, so that it can be handed
+  // over to another thread once its parameters are set. It must then only be
+  // used on that thread.
+  void DetachFromThread() { thread_checker_.Detach(); }
+
  private:
   bool DoSetKey(int type,
                 int crypto_suite,
@@ -121,6 +145,9 @@ class SrtpSession {
                  const uint8_t* key,
                  size_t len,
                  const std::vector<int>& extension_ids);
+  // ProtectRtp and UnprotectRtp, without the checks of the session.
+  bool DoProtectRtp(void* data, int in_len, int max_len, int* out_len);
+  bool DoUnprotectRtp(void* data, int in_len, int* out_len);
   // Returns send stream current packet index from srtp db.
   bool GetSendStreamPacketIndex(void* data, int in_len, int64_t* index);
 
@@ -0,0 +1,152 @@
+/*
+ *  Copyright 2024 The WebRTC Project Authors. All rights reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <vector>
+
+#include "api/array_view.h"
+#include "benchmark/benchmark.h"
+#include "pc/srtp_session.h"
+#include "rtc_base/byte_order.h"
+#include "rtc_base/checks.h"
+#include "rtc_base/ssl_stream_adapter.h"
+#include "rtc_base/system/unused.h"
+
+namespace rtc {
+namespace {
+
+constexpr size_t kRtpHeaderSize = 12;
+constexpr size_t kPacketSize = 1200;
+// Room for the largest auth tag.
+constexpr size_t kBufferSize = kPacketSize + 16;
+constexpr int kBatchSize = 16;
+// Long enough for the key and salt of every supported crypto suite.
+constexpr uint8_t kKey[] = "0123456789ABCDEF0123456789ABCDEF0123456789ABCDEF";
+
+// A sender and a receiver session for `crypto_suite`, and a batch of
+// `kPacketSize` RTP packets with consecutive sequence numbers.
+class SessionFixture {
+ public:
+  explicit SessionFixture(int crypto_suite)
+      : buffers_(kBatchSize, std::vector<uint8_t>(kBufferSize)),
+        batch_(kBatchSize) {
+    int key_len = 0;
+    int salt_len = 0;
+    RTC_CHECK(GetSrtpKeyAndSaltLengths(crypto_suite, &key_len, &salt_len));
+    RTC_CHECK_LE(key_len + salt_len, sizeof(kKey));
+    RTC_CHECK(sender_.SetSend(crypto_suite, kKey, key_len + salt_len, {}));
+    RTC_CHECK(receiver_.SetRecv(crypto_suite, kKey, key_len + salt_len, {}));
+    for (std::vector<uint8_t>& buffer : buffers_) {
+      // Version 2, payload type 96, SSRC 1.
+      buffer[0] = 0x80;
+      buffer[1] = 96;
+      SetBE32(buffer.data() + 8, 1);
+    }
+  }
+
+  cricket::SrtpSession& sender() { return sender_; }
+  cricket::SrtpSession& receiver() { return receiver_; }
+
+  // Returns the next batch of plain RTP packets.
+  rtc::ArrayView<cricket::SrtpSession::BatchPacket> NextBatch() {
+    for (int i = 0; i < kBatchSize; ++i) {
+      SetBE16(buffers_[i].data() + 2, sequence_number_++);
+      SetBE32(buffers_[i].data() + 4, sequence_number_ * 960);
+      batch_[i] = {.data = buffers_[i].data(),
+                   .len = static_cast<int>(kPacketSize),
+                   .max_len = static_cast<int>(kBufferSize)};
+    }
+    return batch_;
+  }
+
+ private:
+  cricket::SrtpSession sender_;
+  cricket::SrtpSession receiver_;
+  std::vector<std::vector<uint8_t>> buffers_;
+  std::vector<cricket::SrtpSession::BatchPacket> batch_;
+  uint16_t sequence_number_ = 0;
+};
+
+void SetProcessed(benchmark::State& state) {
+  state.SetItemsProcessed(state.iterations() * kBatchSize);
+  state.SetBytesProcessed(state.iterations() * kBatchSize *
+                          (kPacketSize - kRtpHeaderSize));
+}
+
+// Protects the packets of a batch one call at a time.
+void BM_ProtectRtp(benchmark::State& state) {
+  SessionFixture fixture(state.range(0));
+  for (auto s : state) {
+    RTC_UNUSED(s);
+    for (cricket::SrtpSession::BatchPacket& packet : fixture.NextBatch()) {
+      benchmark::DoNotOptimize(fixture.sender().ProtectRtp(
+          packet.data, packet.len, packet.max_len, &packet.len));
+    }
+  }
+  SetProcessed(state);
+}
+
+// Protects the packets of a batch with one call.
+void BM_ProtectRtpBatch(benchmark::State& state) {
+  SessionFixture fixture(state.range(0));
+  for (auto s : state) {
+    RTC_UNUSED(s);
+    benchmark::DoNotOptimize(fixture.sender().ProtectRtp(fixture.NextBatch()));
+  }
+  SetProcessed(state);
+}
+
+// Unprotects the packets of a batch one call at a time. The packets are
+// protected outside of the timed region, since replayed packets are rejected.
+void BM_UnprotectRtp(benchmark::State& state) {
+  SessionFixture fixture(state.range(0));
+  for (auto s : state) {
+    RTC_UNUSED(s);
+    state.PauseTiming();
+    rtc::ArrayView<cricket::SrtpSession::BatchPacket> batch =
+        fixture.NextBatch();
+    RTC_CHECK_EQ(fixture.sender().ProtectRtp(batch), kBatchSize);
+    state.ResumeTiming();
+    for (cricket::SrtpSession::BatchPacket& packet : batch) {
+      benchmark::DoNotOptimize(fixture.receiver().UnprotectRtp(
+          packet.data, packet.len, &packet.len));
+    }
+  }
+  SetProcessed(state);
+}
+
+// Unprotects the packets of a batch with one call.
+void BM_UnprotectRtpBatch(benchmark::State& state) {
+  SessionFixture fixture(state.range(0));
+  for (auto s : state) {
+    RTC_UNUSED(s);
+    state.PauseTiming();
+    rtc::ArrayView<cricket::SrtpSession::BatchPacket> batch =
+        fixture.NextBatch();
+    RTC_CHECK_EQ(fixture.sender().ProtectRtp(batch), kBatchSize);
+    state.ResumeTiming();
+    benchmark::DoNotOptimize(fixture.receiver().UnprotectRtp(batch));
+  }
+  SetProcessed(state);
+}
+
+BENCHMARK(BM_ProtectRtp)->Arg(kSrtpAes128CmSha1_80)->Arg(kSrtpAeadAes128Gcm);
+BENCHMARK(BM_ProtectRtpBatch)
+    ->Arg(kSrtpAes128CmSha1_80)
+    ->Arg(kSrtpAeadAes128Gcm);
+BENCHMARK(BM_UnprotectRtp)->Arg(kSrtpAes128CmSha1_80)->Arg(kSrtpAeadAes128Gcm);
+BENCHMARK(BM_UnprotectRtpBatch)
+    ->Arg(kSrtpAes128CmSha1_80)
+    ->Arg(kSrtpAeadAes128Gcm);
+
+}  // namespace
+}  // namespace rtc
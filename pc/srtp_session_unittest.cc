@@ -13,6 +13,7 @@
 #include <string.h>
 
 #include <string>
+#include <vector>
 
 #include "media/base/fake_rtp.h"
 #include "pc/test/srtp_test_util.h"
@@ -195,6 +196,46 @@ TEST_F(SrtpSessionTest, TestBuffersTooSmall) {
                                sizeof(rtcp_packet_) - 14, &out_len));
 }
 
+// Test that a batch of RTP packets is protected and unprotected, and that a
+// packet that fails does not stop the others.
+TEST_F(SrtpSessionTest, TestProtectAndUnprotectBatch) {
+  EXPECT_TRUE(s1_.SetSend(kSrtpAes128CmSha1_80, kTestKey1, kTestKeyLen,
+                          kEncryptedHeaderExtensionIds));
+  EXPECT_TRUE(s2_.SetRecv(kSrtpAes128CmSha1_80, kTestKey1, kTestKeyLen,
+                          kEncryptedHeaderExtensionIds));
+  constexpr int kNumPackets = 4;
+  const int tag_len = rtp_auth_tag_len(kSrtpAes128CmSha1_80);
+  char packets[kNumPackets][sizeof(kPcmuFrame) + 10];
+  std::vector<cricket::SrtpSession::BatchPacket> batch(kNumPackets);
+  for (int i = 0; i < kNumPackets; ++i) {
+    memcpy(packets[i], kPcmuFrame, sizeof(kPcmuFrame));
+    SetBE16(packets[i] + 2, i + 1);
+    batch[i].data = packets[i];
+    batch[i].len = sizeof(kPcmuFrame);
+    batch[i].max_len = sizeof(packets[i]);
+  }
+  // The buffer of the third packet has no room for the auth tag.
+  batch[2].max_len = sizeof(kPcmuFrame);
+
+  EXPECT_EQ(kNumPackets - 1, s1_.ProtectRtp(batch));
+  for (int i = 0; i < kNumPackets; ++i) {
+    EXPECT_EQ(i != 2, batch[i].ok);
+  }
+  EXPECT_EQ(static_cast<int>(sizeof(kPcmuFrame)) + tag_len, batch[0].len);
+  EXPECT_EQ(static_cast<int>(sizeof(kPcmuFrame)), batch[2].len);
+
+  // Drop the third packet and tamper with the payload of the second.
+  batch.erase(batch.begin() + 2);
+  packets[1][sizeof(kPcmuFrame) - 1] ^= 1;
+  EXPECT_EQ(2, s2_.UnprotectRtp(batch));
+  EXPECT_TRUE(batch[0].ok);
+  EXPECT_FALSE(batch[1].ok);
+  EXPECT_TRUE(batch[2].ok);
+  EXPECT_EQ(static_cast<int>(sizeof(kPcmuFrame)), batch[2].len);
+  // The packets differ from kPcmuFrame in the sequence number only.
+  EXPECT_EQ(0, memcmp(packets[3] + 4, kPcmuFrame + 4, sizeof(kPcmuFrame) - 4));
+}
+
 TEST_F(SrtpSessionTest, TestReplay) {
   static const uint16_t kMaxSeqnum = static_cast<uint16_t>(-1);
   static const uint16_t seqnum_big = 62275;
@@ -17,11 +17,17 @@
 #include <vector>
 
 #include "absl/strings/match.h"
+#include "api/make_ref_counted.h"
+#include "api/ref_counted_base.h"
+#include "api/task_queue/pending_task_safety_flag.h"
+#include "api/units/timestamp.h"
 #include "media/base/rtp_utils.h"
 #include "modules/rtp_rtcp/source/rtp_util.h"
 #include "pc/rtp_transport.h"
+#include "pc/srtp_crypto_pool.h"
 #include "pc/srtp_session.h"
 #include "rtc_base/async_packet_socket.h"
+#include "rtc_base/buffer.h"
 #include "rtc_base/checks.h"
 #include "rtc_base/copy_on_write_buffer.h"
 #include "rtc_base/logging.h"
@@ -33,10 +39,83 @@
 
 namespace webrtc {
 
+// The sessions of a transport that offloads crypto, used only on its crypto
+// thread. The queued crypto tasks share them with the transport, so that the
+// transport can be destroyed without waiting for the tasks.
+struct SrtpTransport::CryptoSessions final
+    : public RefCountedNonVirtual<CryptoSessions> {
+  bool Protect(bool rtcp, rtc::CopyOnWriteBuffer& packet) {
+    if (!send_session) {
+      RTC_LOG(LS_WARNING) << "Failed to protect: SRTP not active";
+      return false;
+    }
+    uint8_t* data = packet.MutableData();
+    int len = rtc::checked_cast<int>(packet.size());
+    int max_len = rtc::checked_cast<int>(packet.capacity());
+    bool protected_packet = false;
+    if (!rtcp) {
+      protected_packet = send_session->ProtectRtp(data, len, max_len, &len);
+    } else if (send_rtcp_session) {
+      protected_packet =
+          send_rtcp_session->ProtectRtcp(data, len, max_len, &len);
+    } else {
+      protected_packet = send_session->ProtectRtcp(data, len, max_len, &len);
+    }
+    if (protected_packet) {
+      packet.SetSize(len);
+    }
+    return protected_packet;
+  }
+
+  // On failure, `len` is the length of the packet for logging.
+  bool Unprotect(bool rtcp, rtc::CopyOnWriteBuffer& packet, int& len) {
+    len = rtc::checked_cast<int>(packet.size());
+    if (!recv_session) {
+      RTC_LOG(LS_WARNING) << "Failed to unprotect: SRTP not active";
+      return false;
+    }
+    char* data = packet.MutableData<char>();
+    bool unprotected = false;
+    if (!rtcp) {
+      unprotected = recv_session->UnprotectRtp(data, len, &len);
+    } else if (recv_rtcp_session) {
+      unprotected = recv_rtcp_session->UnprotectRtcp(data, len, &len);
+    } else {
+      unprotected = recv_session->UnprotectRtcp(data, len, &len);
+    }
+    if (unprotected) {
+      packet.SetSize(len);
+    }
+    return unprotected;
+  }
+
+  std::unique_ptr<cricket::SrtpSession> send_session;
+  std::unique_ptr<cricket::SrtpSession> recv_session;
+  std::unique_ptr<cricket::SrtpSession> send_rtcp_session;
+  std::unique_ptr<cricket::SrtpSession> recv_rtcp_session;
+};
+
 SrtpTransport::SrtpTransport(bool rtcp_mux_enabled,
                              const FieldTrialsView& field_trials)
     : RtpTransport(rtcp_mux_enabled), field_trials_(field_trials) {}
 
+SrtpTransport::~SrtpTransport() = default;
+
+void SrtpTransport::SetCryptoPool(rtc::scoped_refptr<SrtpCryptoPool> pool) {
+  RTC_DCHECK(!IsSrtpActive());
+  RTC_DCHECK(!send_rtcp_session_);
+  RTC_DCHECK(pool);
+  if (external_auth_enabled_) {
+    RTC_LOG(LS_WARNING) << "SRTP crypto is not offloaded with external auth.";
+    return;
+  }
+  network_thread_ = TaskQueueBase::Current();
+  RTC_DCHECK(network_thread_);
+  crypto_pool_ = std::move(pool);
+  crypto_thread_ = crypto_pool_->AssignThread();
+  crypto_sessions_ = make_ref_counted<CryptoSessions>();
+}
+
 bool SrtpTransport::SendRtpPacket(rtc::CopyOnWriteBuffer* packet,
                                   const rtc::PacketOptions& options,
                                   int flags) {
@@ -45,6 +124,12 @@ bool SrtpTransport::SendRtpPacket(rtc::CopyOnWriteBuffer* packet,
         << "Failed to send the packet because SRTP transport is inactive.";
     return false;
   }
+  if (crypto_thread_) {
+    SendOffloadedPacket(/*rtcp=*/false, std::move(*packet), options, flags);
+    // Offloaded packets are protected and sent asynchronously, failures are
+    // counted by OnOffloadedSendFailed().
+    return true;
+  }
   rtc::PacketOptions updated_options = options;
   TRACE_EVENT0("webrtc", "SRTP Encode");
   bool res;
@@ -101,6 +186,12 @@ bool SrtpTransport::SendRtcpPacket(rtc::CopyOnWriteBuffer* packet,
         << "Failed to send the packet because SRTP transport is inactive.";
     return false;
   }
+  if (crypto_thread_) {
+    SendOffloadedPacket(/*rtcp=*/true, std::move(*packet), options, flags);
+    // Offloaded packets are protected and sent asynchronously, failures are
+    // counted by OnOffloadedSendFailed().
+    return true;
+  }
 
   TRACE_EVENT0("webrtc", "SRTP Encode");
   uint8_t* data = packet->MutableData();
@@ -126,27 +217,78 @@ void SrtpTransport::OnRtpPacketReceived(const rtc::ReceivedPacket& packet) {
     return;
   }
 
-  rtc::CopyOnWriteBuffer payload(packet.payload());
+  rtc::CopyOnWriteBuffer payload = packet.SharePayload();
+  Timestamp arrival_time =
+      packet.arrival_time().value_or(Timestamp::MinusInfinity());
+  if (crypto_thread_) {
+    crypto_thread_->PostTask([this, sessions = crypto_sessions_,
+                              network_thread = network_thread_,
+                              safety = network_safety_.flag(),
+                              payload = std::move(payload), arrival_time,
+                              ecn = packet.ecn()]() mutable {
+      TRACE_EVENT0("webrtc", "SRTP Decode");
+      int len = 0;
+      bool unprotected = sessions->Unprotect(/*rtcp=*/false, payload, len);
+      network_thread->PostTask(SafeTask(
+          std::move(safety), [this, unprotected, len,
+                              payload = std::move(payload), arrival_time,
+                              ecn]() mutable {
+            if (!unprotected) {
+              OnUnprotectRtpFailed(payload, len);
+              return;
+            }
+            DemuxPacket(std::move(payload), arrival_time, ecn);
+          }));
+    });
+    return;
+  }
   char* data = payload.MutableData<char>();
   int len = rtc::checked_cast<int>(payload.size());
   if (!UnprotectRtp(data, len, &len)) {
-    // Limit the error logging to avoid excessive logs when there are lots of
-    // bad packets.
-    const int kFailureLogThrottleCount = 100;
-    if (decryption_failure_count_ % kFailureLogThrottleCount == 0) {
-      RTC_LOG(LS_ERROR) << "Failed to unprotect RTP packet: size=" << len
-                        << ", seqnum=" << ParseRtpSequenceNumber(payload)
-                        << ", SSRC=" << ParseRtpSsrc(payload)
-                        << ", previous failure count: "
-                        << decryption_failure_count_;
-    }
-    ++decryption_failure_count_;
+    OnUnprotectRtpFailed(payload, len);
     return;
   }
   payload.SetSize(len);
-  DemuxPacket(std::move(payload),
-              packet.arrival_time().value_or(Timestamp::MinusInfinity()),
-              packet.ecn());
+  DemuxPacket(std::move(payload), arrival_time, packet.ecn());
+}
+
+void SrtpTransport::OnRtpPacketsReceived(
+    rtc::ArrayView<const rtc::ReceivedPacket> packets) {
+  // Offloaded packets are posted to `crypto_thread_` one at a time.
+  if (packets.size() == 1 || crypto_thread_) {
+    RtpTransport::OnRtpPacketsReceived(packets);
+    return;
+  }
+  TRACE_EVENT1("webrtc", "SrtpTransport::OnRtpPacketsReceived", "packets",
+               packets.size());
+  if (!IsSrtpActive()) {
+    RTC_LOG(LS_WARNING)
+        << "Inactive SRTP transport received RTP packets. Drop them.";
+    return;
+  }
+
+  std::vector<rtc::CopyOnWriteBuffer> payloads;
+  std::vector<cricket::SrtpSession::BatchPacket> batch;
+  payloads.reserve(packets.size());
+  batch.reserve(packets.size());
+  for (const rtc::ReceivedPacket& packet : packets) {
+    rtc::CopyOnWriteBuffer& payload =
+        payloads.emplace_back(packet.SharePayload());
+    batch.push_back({.data = payload.MutableData(),
+                     .len = rtc::checked_cast<int>(payload.size())});
+  }
+  RTC_CHECK(recv_session_);
+  recv_session_->UnprotectRtp(batch);
+  for (size_t i = 0; i < packets.size(); ++i) {
+    if (!batch[i].ok) {
+      OnUnprotectRtpFailed(payloads[i], batch[i].len);
+      continue;
+    }
+    payloads[i].SetSize(batch[i].len);
+    DemuxPacket(std::move(payloads[i]),
+                packets[i].arrival_time().value_or(Timestamp::MinusInfinity()),
+                packets[i].ecn());
+  }
 }
 
 void SrtpTransport::OnRtcpPacketReceived(const rtc::ReceivedPacket& packet) {
@@ -156,19 +298,100 @@ void SrtpTransport::OnRtcpPacketReceived(const rtc::ReceivedPacket& packet) {
         << "Inactive SRTP transport received an RTCP packet. Drop it.";
     return;
   }
-  rtc::CopyOnWriteBuffer payload(packet.payload());
+  rtc::CopyOnWriteBuffer payload = packet.SharePayload();
+  int64_t packet_time_us =
+      packet.arrival_time() ? packet.arrival_time()->us() : -1;
+  if (crypto_thread_) {
+    crypto_thread_->PostTask([this, sessions = crypto_sessions_,
+                              network_thread = network_thread_,
+                              safety = network_safety_.flag(),
+                              payload = std::move(payload),
+                              packet_time_us]() mutable {
+      TRACE_EVENT0("webrtc", "SRTCP Decode");
+      int len = 0;
+      bool unprotected = sessions->Unprotect(/*rtcp=*/true, payload, len);
+      network_thread->PostTask(SafeTask(
+          std::move(safety), [this, unprotected, len,
+                              payload = std::move(payload),
+                              packet_time_us]() mutable {
+            if (!unprotected) {
+              OnUnprotectRtcpFailed(payload, len);
+              return;
+            }
+            SendRtcpPacketReceived(&payload, packet_time_us);
+          }));
+    });
+    return;
+  }
   char* data = payload.MutableData<char>();
   int len = rtc::checked_cast<int>(payload.size());
   if (!UnprotectRtcp(data, len, &len)) {
-    int type = -1;
-    cricket::GetRtcpType(data, len, &type);
-    RTC_LOG(LS_ERROR) << "Failed to unprotect RTCP packet: size=" << len
-                      << ", type=" << type;
+    OnUnprotectRtcpFailed(payload, len);
     return;
   }
   payload.SetSize(len);
-  SendRtcpPacketReceived(
-      &payload, packet.arrival_time() ? packet.arrival_time()->us() : -1);
+  SendRtcpPacketReceived(&payload, packet_time_us);
+}
+
+void SrtpTransport::SendOffloadedPacket(bool rtcp,
+                                        rtc::CopyOnWriteBuffer packet,
+                                        const rtc::PacketOptions& options,
+                                        int flags) {
+  crypto_thread_->PostTask([this, rtcp, sessions = crypto_sessions_,
+                            network_thread = network_thread_,
+                            safety = network_safety_.flag(),
+                            packet = std::move(packet), options,
+                            flags]() mutable {
+    TRACE_EVENT0("webrtc", "SRTP Encode");
+    bool protected_packet = sessions->Protect(rtcp, packet);
+    if (!protected_packet) {
+      RTC_LOG(LS_ERROR) << "Failed to protect " << (rtcp ? "RTCP" : "RTP")
+                        << " packet: size=" << packet.size();
+    }
+    network_thread->PostTask(SafeTask(
+        std::move(safety), [this, rtcp, protected_packet,
+                            packet = std::move(packet), options,
+                            flags]() mutable {
+          if (!protected_packet || !SendPacket(rtcp, &packet, options, flags)) {
+            OnOffloadedSendFailed(rtcp);
+          }
+        }));
+  });
+}
+
+void SrtpTransport::OnUnprotectRtpFailed(const rtc::CopyOnWriteBuffer& payload,
+                                         int len) {
+  // Limit the error logging to avoid excessive logs when there are lots of
+  // bad packets.
+  const int kFailureLogThrottleCount = 100;
+  if (decryption_failure_count_ % kFailureLogThrottleCount == 0) {
+    RTC_LOG(LS_ERROR) << "Failed to unprotect RTP packet: size=" << len
+                      << ", seqnum=" << ParseRtpSequenceNumber(payload)
+                      << ", SSRC=" << ParseRtpSsrc(payload)
+                      << ", previous failure count: "
+                      << decryption_failure_count_;
+  }
+  ++decryption_failure_count_;
+}
+
+void SrtpTransport::OnOffloadedSendFailed(bool rtcp) {
+  // Limit the error logging like for unprotect failures.
+  const int kFailureLogThrottleCount = 100;
+  if (offloaded_send_failure_count_ % kFailureLogThrottleCount == 0) {
+    RTC_LOG(LS_ERROR) << "Failed to send offloaded " << (rtcp ? "RTCP" : "RTP")
+                      << " packet, previous failure count: "
+                      << offloaded_send_failure_count_;
+  }
+  ++offloaded_send_failure_count_;
+}
+
+void SrtpTransport::OnUnprotectRtcpFailed(
+    const rtc::CopyOnWriteBuffer& payload,
+    int len) {
+  int type = -1;
+  cricket::GetRtcpType(payload.data(), len, &type);
+  RTC_LOG(LS_ERROR) << "Failed to unprotect RTCP packet: size=" << len
+                    << ", type=" << type;
 }
 
 void SrtpTransport::OnNetworkRouteChanged(
@@ -197,6 +420,11 @@ bool SrtpTransport::SetRtpParams(int send_crypto_suite,
                                  const uint8_t* recv_key,
                                  int recv_key_len,
                                  const std::vector<int>& recv_extension_ids) {
+  if (crypto_thread_) {
+    return SetOffloadedRtpParams(send_crypto_suite, send_key, send_key_len,
+                                 send_extension_ids, recv_crypto_suite,
+                                 recv_key, recv_key_len, recv_extension_ids);
+  }
   // If parameters are being set for the first time, we should create new SRTP
   // sessions and call "SetSend/SetRecv". Otherwise we should call
   // "UpdateSend"/"UpdateRecv" on the existing sessions, which will internally
@@ -243,6 +471,11 @@ bool SrtpTransport::SetRtcpParams(int send_crypto_suite,
                                   const uint8_t* recv_key,
                                   int recv_key_len,
                                   const std::vector<int>& recv_extension_ids) {
+  if (crypto_thread_) {
+    return SetOffloadedRtcpParams(send_crypto_suite, send_key, send_key_len,
+                                  send_extension_ids, recv_crypto_suite,
+                                  recv_key, recv_key_len, recv_extension_ids);
+  }
   // This can only be called once, but can be safely called after
   // SetRtpParams
   if (send_rtcp_session_ || recv_rtcp_session_) {
@@ -270,8 +503,123 @@ bool SrtpTransport::SetRtcpParams(int send_crypto_suite,
   return true;
 }
 
+bool SrtpTransport::SetOffloadedRtpParams(
+    int send_crypto_suite,
+    const uint8_t* send_key,
+    int send_key_len,
+    const std::vector<int>& send_extension_ids,
+    int recv_crypto_suite,
+    const uint8_t* recv_key,
+    int recv_key_len,
+    const std::vector<int>& recv_extension_ids) {
+  // The sessions are always set up here, so that bad parameters are reported
+  // synchronously. Sessions that are already active are updated on the crypto
+  // thread instead of being replaced, which keeps their rollover counters and
+  // replay windows.
+  auto send_session = std::make_unique<cricket::SrtpSession>(field_trials_);
+  auto recv_session = std::make_unique<cricket::SrtpSession>(field_trials_);
+  if (!send_session->SetSend(send_crypto_suite, send_key, send_key_len,
+                             send_extension_ids) ||
+      !recv_session->SetRecv(recv_crypto_suite, recv_key, recv_key_len,
+                             recv_extension_ids)) {
+    ResetParams();
+    return false;
+  }
+  crypto_srtp_overhead_ = send_session->GetSrtpOverhead();
+  bool new_sessions = !crypto_srtp_active_;
+  if (new_sessions) {
+    send_session->DetachFromThread();
+    recv_session->DetachFromThread();
+    crypto_thread_->PostTask([sessions = crypto_sessions_,
+                              send_session = std::move(send_session),
+                              recv_session =
+                                  std::move(recv_session)]() mutable {
+      sessions->send_session = std::move(send_session);
+      sessions->recv_session = std::move(recv_session);
+    });
+  } else {
+    crypto_thread_->PostTask(
+        [sessions = crypto_sessions_, send_crypto_suite,
+         send_key = rtc::ZeroOnFreeBuffer<uint8_t>(send_key, send_key_len),
+         send_extension_ids, recv_crypto_suite,
+         recv_key = rtc::ZeroOnFreeBuffer<uint8_t>(recv_key, recv_key_len),
+         recv_extension_ids] {
+          cricket::SrtpSession* send_session = sessions->send_session.get();
+          cricket::SrtpSession* recv_session = sessions->recv_session.get();
+          if (!send_session || !recv_session) {
+            return;
+          }
+          if (!send_session->UpdateSend(send_crypto_suite, send_key.data(),
+                                        send_key.size(), send_extension_ids) ||
+              !recv_session->UpdateRecv(recv_crypto_suite, recv_key.data(),
+                                        recv_key.size(), recv_extension_ids)) {
+            RTC_LOG(LS_ERROR) << "Failed to update offloaded SRTP sessions.";
+          }
+        });
+  }
+  crypto_srtp_active_ = true;
+
+  RTC_LOG(LS_INFO) << "SRTP " << (new_sessions ? "activated" : "updated")
+                   << " with negotiated parameters: send crypto_suite "
+                   << send_crypto_suite << " recv crypto_suite "
+                   << recv_crypto_suite;
+  MaybeUpdateWritableState();
+  return true;
+}
+
+bool SrtpTransport::SetOffloadedRtcpParams(
+    int send_crypto_suite,
+    const uint8_t* send_key,
+    int send_key_len,
+    const std::vector<int>& send_extension_ids,
+    int recv_crypto_suite,
+    const uint8_t* recv_key,
+    int recv_key_len,
+    const std::vector<int>& recv_extension_ids) {
+  if (crypto_srtcp_active_) {
+    RTC_LOG(LS_ERROR) << "Tried to set SRTCP Params when filter already active";
+    return false;
+  }
+  auto send_session = std::make_unique<cricket::SrtpSession>(field_trials_);
+  auto recv_session = std::make_unique<cricket::SrtpSession>(field_trials_);
+  if (!send_session->SetSend(send_crypto_suite, send_key, send_key_len,
+                             send_extension_ids) ||
+      !recv_session->SetRecv(recv_crypto_suite, recv_key, recv_key_len,
+                             recv_extension_ids)) {
+    return false;
+  }
+  send_session->DetachFromThread();
+  recv_session->DetachFromThread();
+  crypto_thread_->PostTask([sessions = crypto_sessions_,
+                            send_session = std::move(send_session),
+                            recv_session = std::move(recv_session)]() mutable {
+    sessions->send_rtcp_session = std::move(send_session);
+    sessions->recv_rtcp_session = std::move(recv_session);
+  });
+  crypto_srtcp_active_ = true;
+
+  RTC_LOG(LS_INFO) << "SRTCP activated with negotiated parameters:"
+                      " send crypto_suite "
+                   << send_crypto_suite << " recv crypto_suite "
+                   << recv_crypto_suite;
+  MaybeUpdateWritableState();
+  return true;
+}
+
+void SrtpTransport::ResetOffloadedParams() {
+  crypto_thread_->PostTask([sessions = crypto_sessions_] {
+    sessions->send_session = nullptr;
+    sessions->recv_session = nullptr;
+    sessions->send_rtcp_session = nullptr;
+    sessions->recv_rtcp_session = nullptr;
+  });
+  crypto_srtp_active_ = false;
+  crypto_srtcp_active_ = false;
+  crypto_srtp_overhead_ = 0;
+}
+
 bool SrtpTransport::IsSrtpActive() const {
-  return send_session_ && recv_session_;
+  return (send_session_ && recv_session_) || crypto_srtp_active_;
 }
 
 bool SrtpTransport::IsWritable(bool rtcp) const {
@@ -279,6 +627,9 @@ bool SrtpTransport::IsWritable(bool rtcp) const {
 }
 
 void SrtpTransport::ResetParams() {
+  if (crypto_thread_) {
+    ResetOffloadedParams();
+  }
   send_session_ = nullptr;
   recv_session_ = nullptr;
   send_rtcp_session_ = nullptr;
@@ -362,6 +713,10 @@ bool SrtpTransport::GetRtpAuthParams(uint8_t** key,
     RTC_LOG(LS_WARNING) << "Failed to GetRtpAuthParams: SRTP not active";
     return false;
   }
+  if (crypto_thread_) {
+    // External auth is not supported with offloaded crypto.
+    return false;
+  }
 
   RTC_CHECK(send_session_);
   return send_session_->GetRtpAuthParams(key, key_len, tag_len);
@@ -372,6 +727,10 @@ bool SrtpTransport::GetSrtpOverhead(int* srtp_overhead) const {
     RTC_LOG(LS_WARNING) << "Failed to GetSrtpOverhead: SRTP not active";
     return false;
   }
+  if (crypto_thread_) {
+    *srtp_overhead = crypto_srtp_overhead_;
+    return true;
+  }
 
   RTC_CHECK(send_session_);
   *srtp_overhead = send_session_->GetSrtpOverhead();
@@ -380,6 +739,7 @@ bool SrtpTransport::GetSrtpOverhead(int* srtp_overhead) const {
 
 void SrtpTransport::EnableExternalAuth() {
   RTC_DCHECK(!IsSrtpActive());
+  RTC_DCHECK(!crypto_thread_);
   external_auth_enabled_ = true;
 }
 
@@ -393,6 +753,9 @@ bool SrtpTransport::IsExternalAuthActive() const {
         << "Failed to check IsExternalAuthActive: SRTP not active";
     return false;
   }
+  if (crypto_thread_) {
+    return false;
+  }
 
   RTC_CHECK(send_session_);
   return send_session_->IsExternalAuthActive();
@@ -444,6 +807,21 @@ void SrtpTransport::MaybeUpdateWritableState() {
 }
 
 bool SrtpTransport::UnregisterRtpDemuxerSink(RtpPacketSinkInterface* sink) {
+  if (crypto_srtp_active_ &&
+      field_trials_.IsEnabled("WebRTC-SrtpRemoveReceiveStream")) {
+    crypto_thread_->PostTask([sessions = crypto_sessions_,
+                              ssrcs = GetSsrcsForSink(sink)] {
+      if (!sessions->recv_session) {
+        return;
+      }
+      for (const auto ssrc : ssrcs) {
+        if (!sessions->recv_session->RemoveSsrcFromSession(ssrc)) {
+          RTC_LOG(LS_WARNING)
+              << "Could not remove SSRC " << ssrc << " from SRTP session.";
+        }
+      }
+    });
+  }
   if (recv_session_ &&
       field_trials_.IsEnabled("WebRTC-SrtpRemoveReceiveStream")) {
     // Remove the SSRCs explicitly registered with the demuxer
@@ -19,15 +19,21 @@
 #include <vector>
 
 #include "absl/types/optional.h"
+#include "api/array_view.h"
 #include "api/field_trials_view.h"
 #include "api/rtc_error.h"
+#include "api/scoped_refptr.h"
+#include "api/task_queue/pending_task_safety_flag.h"
+#include "api/task_queue/task_queue_base.h"
 #include "p2p/base/packet_transport_internal.h"
 #include "pc/rtp_transport.h"
+#include "pc/srtp_crypto_pool.h"
 #include "pc/srtp_session.h"
 #include "rtc_base/async_packet_socket.h"
 #include "rtc_base/buffer.h"
 #include "rtc_base/copy_on_write_buffer.h"
 #include "rtc_base/network_route.h"
+#include "rtc_base/thread.h"
 
 namespace webrtc {
 
@@ -38,7 +44,7 @@ class SrtpTransport : public RtpTransport {
  public:
   SrtpTransport(bool rtcp_mux_enabled, const FieldTrialsView& field_trials);
 
-  virtual ~SrtpTransport() = default;
+  virtual ~SrtpTransport();
 
   bool SendRtpPacket(rtc::CopyOnWriteBuffer* packet,
                      const rtc::PacketOptions& options,
@@ -93,6 +99,19 @@ class SrtpTransport : public RtpTransport {
   // been set.
   bool IsExternalAuthActive() const;
 
+  // Moves encryption and decryption to a thread of `pool`. Packets are still
+  // protected and unprotected in the order they are sent and received, and
+  // are handed back to the current thread to be sent or demuxed, so sending
+  // succeeds once the packet is queued. Must be called before the SRTP params
+  // are set. Not supported with external auth.
+  void SetCryptoPool(rtc::scoped_refptr<SrtpCryptoPool> pool);
+
+  // Returns the number of queued packets that failed to be protected or sent
+  // after SetCryptoPool().
+  int offloaded_send_failure_count() const {
+    return offloaded_send_failure_count_;
+  }
+
   // Returns srtp overhead for rtp packets.
   bool GetSrtpOverhead(int* srtp_overhead) const;
 
@@ -114,10 +133,14 @@ class SrtpTransport : public RtpTransport {
   void MaybeUpdateWritableState();
 
  private:
+  struct CryptoSessions;
+
   void ConnectToRtpTransport();
   void CreateSrtpSessions();
 
   void OnRtpPacketReceived(const rtc::ReceivedPacket& packet) override;
+  void OnRtpPacketsReceived(
+      rtc::ArrayView<const rtc::ReceivedPacket> packets) override;
   void OnRtcpPacketReceived(const rtc::ReceivedPacket& packet) override;
   void OnNetworkRouteChanged(
       absl::optional<rtc::NetworkRoute> network_route) override;
@@ -141,6 +164,37 @@ class SrtpTransport : public RtpTransport {
 
   bool UnprotectRtcp(void* data, int in_len, int* out_len);
 
+  // Variants of SetRtpParams, SetRtcpParams and ResetParams when crypto is
+  // offloaded. The sessions are set up here and handed over to
+  // `crypto_thread_`.
+  bool SetOffloadedRtpParams(int send_crypto_suite,
+                             const uint8_t* send_key,
+                             int send_key_len,
+                             const std::vector<int>& send_extension_ids,
+                             int recv_crypto_suite,
+                             const uint8_t* recv_key,
+                             int recv_key_len,
+                             const std::vector<int>& recv_extension_ids);
+  bool SetOffloadedRtcpParams(int send_crypto_suite,
+                              const uint8_t* send_key,
+                              int send_key_len,
+                              const std::vector<int>& send_extension_ids,
+                              int recv_crypto_suite,
+                              const uint8_t* recv_key,
+                              int recv_key_len,
+                              const std::vector<int>& recv_extension_ids);
+  void ResetOffloadedParams();
+
+  // Protects `packet` on `crypto_thread_` and sends it from here. A packet
+  // that fails to be protected or sent is counted by OnOffloadedSendFailed().
+  void SendOffloadedPacket(bool rtcp,
+                           rtc::CopyOnWriteBuffer packet,
+                           const rtc::PacketOptions& options,
+                           int flags);
+  void OnOffloadedSendFailed(bool rtcp);
+  void OnUnprotectRtpFailed(const rtc::CopyOnWriteBuffer& payload, int len);
+  void OnUnprotectRtcpFailed(const rtc::CopyOnWriteBuffer& payload, int len);
+
   bool MaybeSetKeyParams();
   bool ParseKeyParams(const std::string& key_params, uint8_t* key, size_t len);
 
@@ -165,6 +219,19 @@ class SrtpTransport : public RtpTransport {
   int decryption_failure_count_ = 0;
 
   const FieldTrialsView& field_trials_;
+
+  // Set if crypto is offloaded to a thread of `crypto_pool_`. The sessions
+  // are then kept in `crypto_sessions_` instead of the members above.
+  rtc::scoped_refptr<SrtpCryptoPool> crypto_pool_;
+  rtc::Thread* crypto_thread_ = nullptr;
+  TaskQueueBase* network_thread_ = nullptr;
+  rtc::scoped_refptr<CryptoSessions> crypto_sessions_;
+  // The state of `crypto_sessions_` as seen from the network thread.
+  bool crypto_srtp_active_ = false;
+  bool crypto_srtcp_active_ = false;
+  int crypto_srtp_overhead_ = 0;
+  int offloaded_send_failure_count_ = 0;
+  ScopedTaskSafety network_safety_;
 };
 
 }  // namespace webrtc
@@ -18,14 +18,21 @@
 #include "media/base/fake_rtp.h"
 #include "p2p/base/dtls_transport_internal.h"
 #include "p2p/base/fake_packet_transport.h"
+#include "pc/srtp_crypto_pool.h"
+#include "pc/srtp_session.h"
 #include "pc/test/rtp_transport_test_util.h"
 #include "pc/test/srtp_test_util.h"
 #include "rtc_base/async_packet_socket.h"
+#include "rtc_base/buffer.h"
 #include "rtc_base/byte_order.h"
 #include "rtc_base/checks.h"
 #include "rtc_base/containers/flat_set.h"
+#include "rtc_base/gunit.h"
+#include "rtc_base/network/received_packet.h"
+#include "rtc_base/socket_address.h"
 #include "rtc_base/ssl_stream_adapter.h"
 #include "rtc_base/third_party/sigslot/sigslot.h"
+#include "rtc_base/thread.h"
 #include "test/gtest.h"
 #include "test/scoped_key_value_config.h"
 
@@ -43,6 +50,7 @@ static const uint8_t kTestKeyGcm256_1[] =
 static const uint8_t kTestKeyGcm256_2[] =
     "rqponmlkjihgfedcbaZYXWVUTSRQPONMLKJIHGFEDCBA";
 static const int kTestKeyGcm256Len = 44;  // 256 bits key + 96 bits salt.
+static const int kTimeoutMs = 1000;
 
 class SrtpTransportTest : public ::testing::Test, public sigslot::has_slots<> {
  protected:
@@ -332,6 +340,9 @@ class SrtpTransportTest : public ::testing::Test, public sigslot::has_slots<> {
                                                    encrypted_headers);
   }
 
+  // Receives the packets handed back by offloaded crypto.
+  rtc::AutoThread main_thread_;
+
   std::unique_ptr<SrtpTransport> srtp_transport1_;
   std::unique_ptr<SrtpTransport> srtp_transport2_;
 
@@ -421,6 +432,127 @@ TEST_F(SrtpTransportTest, TestSetParamsKeyTooShort) {
       rtc::kSrtpAes128CmSha1_80, kTestKey1, kTestKeyLen - 1, extension_ids));
 }
 
+// Test that packets keep their order when crypto is offloaded, and that the
+// replay window of the receiving session still applies.
+TEST_F(SrtpTransportTest, SendAndRecvPacketsWithCryptoPool) {
+  scoped_refptr<SrtpCryptoPool> pool = SrtpCryptoPool::Create(2);
+  srtp_transport1_->SetCryptoPool(pool);
+  srtp_transport2_->SetCryptoPool(pool);
+  std::vector<int> extension_ids;
+  EXPECT_TRUE(srtp_transport1_->SetRtpParams(
+      rtc::kSrtpAes128CmSha1_80, kTestKey1, kTestKeyLen, extension_ids,
+      rtc::kSrtpAes128CmSha1_80, kTestKey2, kTestKeyLen, extension_ids));
+  EXPECT_TRUE(srtp_transport2_->SetRtpParams(
+      rtc::kSrtpAes128CmSha1_80, kTestKey2, kTestKeyLen, extension_ids,
+      rtc::kSrtpAes128CmSha1_80, kTestKey1, kTestKeyLen, extension_ids));
+  EXPECT_TRUE(srtp_transport1_->IsSrtpActive());
+  EXPECT_TRUE(srtp_transport2_->IsSrtpActive());
+  int overhead = 0;
+  EXPECT_TRUE(srtp_transport1_->GetSrtpOverhead(&overhead));
+  EXPECT_EQ(rtc::rtp_auth_tag_len(rtc::kSrtpAes128CmSha1_80), overhead);
+
+  size_t rtp_len = sizeof(kPcmuFrame);
+  size_t packet_size =
+      rtp_len + rtc::rtp_auth_tag_len(rtc::kSrtpAes128CmSha1_80);
+  auto send_packet = [&](uint16_t sequence_number) {
+    rtc::CopyOnWriteBuffer packet(kPcmuFrame, rtp_len, packet_size);
+    rtc::SetBE16(packet.MutableData() + 2, sequence_number);
+    return srtp_transport1_->SendRtpPacket(&packet, rtc::PacketOptions(),
+                                           cricket::PF_SRTP_BYPASS);
+  };
+
+  constexpr int kNumPackets = 50;
+  for (int i = 1; i <= kNumPackets; ++i) {
+    EXPECT_TRUE(send_packet(i));
+  }
+  EXPECT_EQ_WAIT(kNumPackets, rtp_sink2_.rtp_count(), kTimeoutMs);
+  EXPECT_EQ(kNumPackets, rtp_sink2_.last_recv_rtp_packet().SequenceNumber());
+
+  // The replayed packet is dropped before the next one is received.
+  EXPECT_TRUE(send_packet(1));
+  EXPECT_TRUE(send_packet(kNumPackets + 1));
+  EXPECT_EQ_WAIT(kNumPackets + 1, rtp_sink2_.rtp_count(), kTimeoutMs);
+  EXPECT_EQ(kNumPackets + 1,
+            rtp_sink2_.last_recv_rtp_packet().SequenceNumber());
+}
+
+// Test that a packet dropped on the crypto thread is counted as a failure,
+// and that sends of other packets still succeed.
+TEST_F(SrtpTransportTest, CountsFailedOffloadedSends) {
+  scoped_refptr<SrtpCryptoPool> pool = SrtpCryptoPool::Create(1);
+  srtp_transport1_->SetCryptoPool(pool);
+  srtp_transport2_->SetCryptoPool(pool);
+  std::vector<int> extension_ids;
+  EXPECT_TRUE(srtp_transport1_->SetRtpParams(
+      rtc::kSrtpAes128CmSha1_80, kTestKey1, kTestKeyLen, extension_ids,
+      rtc::kSrtpAes128CmSha1_80, kTestKey2, kTestKeyLen, extension_ids));
+  EXPECT_TRUE(srtp_transport2_->SetRtpParams(
+      rtc::kSrtpAes128CmSha1_80, kTestKey2, kTestKeyLen, extension_ids,
+      rtc::kSrtpAes128CmSha1_80, kTestKey1, kTestKeyLen, extension_ids));
+
+  size_t rtp_len = sizeof(kPcmuFrame);
+  auto send_packet = [&](uint16_t sequence_number, size_t capacity) {
+    rtc::CopyOnWriteBuffer packet(kPcmuFrame, rtp_len, capacity);
+    rtc::SetBE16(packet.MutableData() + 2, sequence_number);
+    return srtp_transport1_->SendRtpPacket(&packet, rtc::PacketOptions(),
+                                           cricket::PF_SRTP_BYPASS);
+  };
+  size_t packet_size =
+      rtp_len + rtc::rtp_auth_tag_len(rtc::kSrtpAes128CmSha1_80);
+
+  // Without room for the auth tag the packet can't be protected, which is
+  // only known once it has been handed to the crypto thread.
+  EXPECT_TRUE(send_packet(1, rtp_len));
+  EXPECT_TRUE(send_packet(2, packet_size));
+  EXPECT_EQ_WAIT(1, rtp_sink2_.rtp_count(), kTimeoutMs);
+  EXPECT_EQ(2, rtp_sink2_.last_recv_rtp_packet().SequenceNumber());
+  EXPECT_EQ(1, srtp_transport1_->offloaded_send_failure_count());
+
+  EXPECT_TRUE(send_packet(3, packet_size));
+  EXPECT_EQ_WAIT(2, rtp_sink2_.rtp_count(), kTimeoutMs);
+  EXPECT_EQ(1, srtp_transport1_->offloaded_send_failure_count());
+}
+
+// Test that a batch of received packets is unprotected together, and that a
+// packet that fails to be unprotected does not stop the others.
+TEST_F(SrtpTransportTest, UnprotectsReceivedBatch) {
+  std::vector<int> extension_ids;
+  EXPECT_TRUE(srtp_transport2_->SetRtpParams(
+      rtc::kSrtpAes128CmSha1_80, kTestKey2, kTestKeyLen, extension_ids,
+      rtc::kSrtpAes128CmSha1_80, kTestKey1, kTestKeyLen, extension_ids));
+  cricket::SrtpSession sender;
+  EXPECT_TRUE(sender.SetSend(rtc::kSrtpAes128CmSha1_80, kTestKey1, kTestKeyLen,
+                             extension_ids));
+
+  constexpr int kNumPackets = 4;
+  size_t rtp_len = sizeof(kPcmuFrame);
+  size_t packet_size =
+      rtp_len + rtc::rtp_auth_tag_len(rtc::kSrtpAes128CmSha1_80);
+  std::vector<rtc::Buffer> buffers;
+  for (int i = 1; i <= kNumPackets; ++i) {
+    rtc::Buffer& buffer = buffers.emplace_back(kPcmuFrame, rtp_len);
+    buffer.EnsureCapacity(packet_size);
+    rtc::SetBE16(buffer.data() + 2, i);
+    int len = 0;
+    ASSERT_TRUE(sender.ProtectRtp(buffer.data(), static_cast<int>(rtp_len),
+                                  static_cast<int>(packet_size), &len));
+    buffer.SetSize(len);
+  }
+  // Tamper with the payload of the second packet.
+  buffers[1][rtp_len - 1] ^= 1;
+  rtc::SocketAddress source;
+  std::vector<rtc::ReceivedPacket> packets;
+  for (const rtc::Buffer& buffer : buffers) {
+    packets.emplace_back(buffer, source);
+  }
+
+  rtp_packet_transport2_->NotifyPacketsReceived(packets);
+  EXPECT_EQ(kNumPackets - 1, rtp_sink2_.rtp_count());
+  EXPECT_EQ(kNumPackets, rtp_sink2_.last_recv_rtp_packet().SequenceNumber());
+  EXPECT_EQ(0, memcmp(rtp_sink2_.last_recv_rtp_packet().data() + 4,
+                      kPcmuFrame + 4, rtp_len - 4));
+}
+
 TEST_F(SrtpTransportTest, RemoveSrtpReceiveStream) {
   test::ScopedKeyValueConfig field_trials(
       "WebRTC-SrtpRemoveReceiveStream/Enabled/");
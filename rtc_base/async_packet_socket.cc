@@ -26,7 +26,11 @@ PacketOptions::PacketOptions(DiffServCodePoint dscp) : dscp(dscp) {}
 PacketOptions::PacketOptions(const PacketOptions& other) = default;
 PacketOptions::~PacketOptions() = default;
 
-AsyncPacketSocket::~AsyncPacketSocket() = default;
+AsyncPacketSocket::~AsyncPacketSocket() {
+  if (destroyed_flag_) {
+    *destroyed_flag_ = true;
+  }
+}
 
 void AsyncPacketSocket::SubscribeCloseEvent(
     const void* removal_tag,
@@ -51,6 +55,16 @@ void AsyncPacketSocket::RegisterReceivedPacketCallback(
 void AsyncPacketSocket::DeregisterReceivedPacketCallback() {
   RTC_DCHECK_RUN_ON(&network_checker_);
   received_packet_callback_ = nullptr;
+  received_packets_callback_ = nullptr;
+}
+
+void AsyncPacketSocket::RegisterReceivedPacketsCallback(
+    absl::AnyInvocable<void(AsyncPacketSocket*,
+                            rtc::ArrayView<const rtc::ReceivedPacket>)>
+        received_packets_callback) {
+  RTC_DCHECK_RUN_ON(&network_checker_);
+  RTC_CHECK(!received_packets_callback_);
+  received_packets_callback_ = std::move(received_packets_callback);
 }
 
 void AsyncPacketSocket::NotifyPacketReceived(
@@ -60,6 +74,37 @@ void AsyncPacketSocket::NotifyPacketReceived(
     received_packet_callback_(this, packet);
     return;
   }
+  if (received_packets_callback_) {
+    received_packets_callback_(this, rtc::MakeArrayView(&packet, 1));
+  }
+}
+
+void AsyncPacketSocket::NotifyPacketsReceived(
+    rtc::ArrayView<const rtc::ReceivedPacket> packets) {
+  RTC_DCHECK_RUN_ON(&network_checker_);
+  if (packets.empty()) {
+    return;
+  }
+  if (received_packets_callback_) {
+    received_packets_callback_(this, packets);
+    return;
+  }
+  bool destroyed = false;
+  bool* outer_destroyed_flag = destroyed_flag_;
+  destroyed_flag_ = &destroyed;
+  for (const rtc::ReceivedPacket& packet : packets) {
+    if (!received_packet_callback_) {
+      break;
+    }
+    received_packet_callback_(this, packet);
+    if (destroyed) {
+      if (outer_destroyed_flag) {
+        *outer_destroyed_flag = true;
+      }
+      return;
+    }
+  }
+  destroyed_flag_ = outer_destroyed_flag;
 }
 
 void CopySocketInformationToPacketInfo(size_t packet_size_bytes,
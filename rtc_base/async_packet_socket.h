@@ -14,6 +14,7 @@
 #include <cstdint>
 #include <vector>
 
+#include "api/array_view.h"
 #include "api/sequence_checker.h"
 #include "rtc_base/callback_list.h"
 #include "rtc_base/dscp.h"
@@ -54,8 +55,7 @@ struct RTC_EXPORT PacketOptions {
   // Packet will be sent with ECN(1), RFC-3168, Section 5.
   // Intended to be used with L4S
   // https://www.rfc-editor.org/rfc/rfc9331.html
-  // TODO(https://bugs.webrtc.org/15368): Actually implement support for sending
-  // packets with different marking.
+  // TODO(https://bugs.webrtc.org/15368): Only implemented by AsyncUDPSocket.
   bool ecn_1 = false;
 
   // When used with RTP packets (for example, webrtc::PacketOptions), the value
@@ -128,8 +128,19 @@ class RTC_EXPORT AsyncPacketSocket : public sigslot::has_slots<> {
   void RegisterReceivedPacketCallback(
       absl::AnyInvocable<void(AsyncPacketSocket*, const rtc::ReceivedPacket&)>
           received_packet_callback);
+  // Also deregisters the received packets callback.
   void DeregisterReceivedPacketCallback();
 
+  // Registers a callback that receives the packets read from the socket on one
+  // read event together, see AsyncUDPSocket::SetBatchedReceive(). Packets read
+  // one at a time are delivered to it as batches of one, unless a received
+  // packet callback is registered too. Without this callback, batches are
+  // delivered one packet at a time to the received packet callback.
+  void RegisterReceivedPacketsCallback(
+      absl::AnyInvocable<void(AsyncPacketSocket*,
+                              rtc::ArrayView<const rtc::ReceivedPacket>)>
+          received_packets_callback);
+
   // Emitted each time a packet is sent.
   sigslot::signal2<AsyncPacketSocket*, const SentPacket&> SignalSentPacket;
 
@@ -160,6 +171,8 @@ class RTC_EXPORT AsyncPacketSocket : public sigslot::has_slots<> {
   }
 
   void NotifyPacketReceived(const rtc::ReceivedPacket& packet);
+  // Delivers packets read from the socket on one read event.
+  void NotifyPacketsReceived(rtc::ArrayView<const rtc::ReceivedPacket> packets);
 
   RTC_NO_UNIQUE_ADDRESS webrtc::SequenceChecker network_checker_{
       webrtc::SequenceChecker::kDetached};
@@ -169,6 +182,12 @@ class RTC_EXPORT AsyncPacketSocket : public sigslot::has_slots<> {
       RTC_GUARDED_BY(&network_checker_);
   absl::AnyInvocable<void(AsyncPacketSocket*, const rtc::ReceivedPacket&)>
       received_packet_callback_ RTC_GUARDED_BY(&network_checker_);
+  absl::AnyInvocable<void(AsyncPacketSocket*,
+                          rtc::ArrayView<const rtc::ReceivedPacket>)>
+      received_packets_callback_ RTC_GUARDED_BY(&network_checker_);
+  // Points to a flag on the stack of an ongoing NotifyPacketsReceived() call,
+  // used to stop delivering a batch if a callback destroys the socket.
+  bool* destroyed_flag_ RTC_GUARDED_BY(&network_checker_) = nullptr;
 };
 
 // Listen socket, producing an AsyncPacketSocket when a peer connects.
@@ -10,6 +10,9 @@
 
 #include "rtc_base/async_packet_socket.h"
 
+#include <memory>
+#include <vector>
+
 #include "rtc_base/socket_address.h"
 #include "rtc_base/third_party/sigslot/sigslot.h"
 #include "test/gmock.h"
@@ -19,6 +22,7 @@ namespace rtc {
 namespace {
 
 using ::testing::MockFunction;
+using ::testing::SizeIs;
 
 class MockAsyncPacketSocket : public rtc::AsyncPacketSocket {
  public:
@@ -49,6 +53,7 @@ class MockAsyncPacketSocket : public rtc::AsyncPacketSocket {
   MOCK_METHOD(void, SetError, (int error), (override));
 
   using AsyncPacketSocket::NotifyPacketReceived;
+  using AsyncPacketSocket::NotifyPacketsReceived;
 };
 
 TEST(AsyncPacketSocket, RegisteredCallbackReceivePacketsFromNotify) {
@@ -61,5 +66,63 @@ TEST(AsyncPacketSocket, RegisteredCallbackReceivePacketsFromNotify) {
   mock_socket.NotifyPacketReceived(ReceivedPacket({}, SocketAddress()));
 }
 
+TEST(AsyncPacketSocket, RegisteredPacketsCallbackReceivesBatch) {
+  MockAsyncPacketSocket mock_socket;
+  MockFunction<void(AsyncPacketSocket*, rtc::ArrayView<const ReceivedPacket>)>
+      received_packets;
+  MockFunction<void(AsyncPacketSocket*, const rtc::ReceivedPacket&)>
+      received_packet;
+
+  EXPECT_CALL(received_packets, Call(&mock_socket, SizeIs(2)));
+  EXPECT_CALL(received_packet, Call).Times(0);
+  mock_socket.RegisterReceivedPacketCallback(received_packet.AsStdFunction());
+  mock_socket.RegisterReceivedPacketsCallback(
+      received_packets.AsStdFunction());
+  SocketAddress address;
+  std::vector<ReceivedPacket> packets = {ReceivedPacket({}, address),
+                                         ReceivedPacket({}, address)};
+  mock_socket.NotifyPacketsReceived(packets);
+}
+
+TEST(AsyncPacketSocket, RegisteredPacketsCallbackReceivesSinglePackets) {
+  MockAsyncPacketSocket mock_socket;
+  MockFunction<void(AsyncPacketSocket*, rtc::ArrayView<const ReceivedPacket>)>
+      received_packets;
+
+  EXPECT_CALL(received_packets, Call(&mock_socket, SizeIs(1)));
+  mock_socket.RegisterReceivedPacketsCallback(
+      received_packets.AsStdFunction());
+  mock_socket.NotifyPacketReceived(ReceivedPacket({}, SocketAddress()));
+}
+
+TEST(AsyncPacketSocket, DeliversBatchPerPacket) {
+  MockAsyncPacketSocket mock_socket;
+  MockFunction<void(AsyncPacketSocket*, const rtc::ReceivedPacket&)>
+      received_packet;
+
+  EXPECT_CALL(received_packet, Call).Times(3);
+  mock_socket.RegisterReceivedPacketCallback(received_packet.AsStdFunction());
+  SocketAddress address;
+  std::vector<ReceivedPacket> packets = {ReceivedPacket({}, address),
+                                         ReceivedPacket({}, address),
+                                         ReceivedPacket({}, address)};
+  mock_socket.NotifyPacketsReceived(packets);
+}
+
+TEST(AsyncPacketSocket, StopsDeliveringBatchIfSocketIsDestroyed) {
+  auto mock_socket = std::make_unique<MockAsyncPacketSocket>();
+  MockFunction<void(AsyncPacketSocket*, const rtc::ReceivedPacket&)>
+      received_packet;
+
+  EXPECT_CALL(received_packet, Call).WillOnce([&] { mock_socket = nullptr; });
+  mock_socket->RegisterReceivedPacketCallback(received_packet.AsStdFunction());
+  SocketAddress address;
+  std::vector<ReceivedPacket> packets = {ReceivedPacket({}, address),
+                                         ReceivedPacket({}, address)};
+  // Keep a raw pointer since the callback resets `mock_socket`.
+  MockAsyncPacketSocket* socket = mock_socket.get();
+  socket->NotifyPacketsReceived(packets);
+}
+
 }  // namespace
 }  // namespace rtc
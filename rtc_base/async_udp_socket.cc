@@ -10,7 +10,14 @@
 
 #include "rtc_base/async_udp_socket.h"
 
+#include <algorithm>
+#include <array>
+
+#include "absl/base/attributes.h"
+#include "absl/container/inlined_vector.h"
 #include "absl/types/optional.h"
+#include "api/ref_counted_base.h"
+#include "api/task_queue/task_queue_base.h"
 #include "api/units/time_delta.h"
 #include "rtc_base/checks.h"
 #include "rtc_base/logging.h"
@@ -21,6 +28,47 @@
 
 namespace rtc {
 
+namespace {
+
+ABSL_CONST_INIT thread_local ReceiveBatchBuffers* current_batch_buffers =
+    nullptr;
+
+}  // namespace
+
+// A batched read delivers its packets before it returns, so the batched
+// sockets reading on a thread take turns using the same buffers rather than
+// holding large buffers of their own.
+class ReceiveBatchBuffers final
+    : public webrtc::RefCountedNonVirtual<ReceiveBatchBuffers> {
+ public:
+  // Returns the buffers of the current thread, which are released with the
+  // last socket holding them.
+  static scoped_refptr<ReceiveBatchBuffers> ForCurrentThread(
+      size_t count,
+      size_t capacity) {
+    if (!current_batch_buffers) {
+      current_batch_buffers = new ReceiveBatchBuffers(count, capacity);
+    }
+    return scoped_refptr<ReceiveBatchBuffers>(current_batch_buffers);
+  }
+
+  ReceiveBatchBuffers(size_t count, size_t capacity) : buffers(count) {
+    for (rtc::Buffer& buffer : buffers) {
+      buffer.EnsureCapacity(capacity);
+    }
+  }
+  ~ReceiveBatchBuffers() {
+    if (current_batch_buffers == this) {
+      current_batch_buffers = nullptr;
+    }
+  }
+
+  std::vector<rtc::Buffer> buffers;
+  // Set while the packets of a read, which point into `buffers`, are
+  // delivered.
+  bool in_use = false;
+};
+
 AsyncUDPSocket* AsyncUDPSocket::Create(Socket* socket,
                                        const SocketAddress& bind_address) {
   std::unique_ptr<Socket> owned_socket(socket);
@@ -46,6 +94,13 @@ AsyncUDPSocket::AsyncUDPSocket(Socket* socket) : socket_(socket) {
   socket_->SignalWriteEvent.connect(this, &AsyncUDPSocket::OnWriteEvent);
 }
 
+AsyncUDPSocket::~AsyncUDPSocket() {
+  if (batch_buffers_) {
+    // Released on the thread whose buffers they are.
+    RTC_DCHECK_RUN_ON(&sequence_checker_);
+  }
+}
+
 SocketAddress AsyncUDPSocket::GetLocalAddress() const {
   return socket_->GetLocalAddress();
 }
@@ -57,6 +112,15 @@ SocketAddress AsyncUDPSocket::GetRemoteAddress() const {
 int AsyncUDPSocket::Send(const void* pv,
                          size_t cb,
                          const rtc::PacketOptions& options) {
+  FlushPendingPackets();
+  if (BlockedOnPendingPackets()) {
+    return -1;
+  }
+  const EcnMarking ecn =
+      options.ecn_1 ? EcnMarking::kEct1 : EcnMarking::kNotEct;
+  if (ecn != socket_ecn_) {
+    SetOption(Socket::OPT_SEND_ECN, static_cast<int>(ecn));
+  }
   rtc::SentPacket sent_packet(options.packet_id, rtc::TimeMillis(),
                               options.info_signaled_after_sent);
   CopySocketInformationToPacketInfo(cb, *this, false, &sent_packet.info);
@@ -69,15 +133,137 @@ int AsyncUDPSocket::SendTo(const void* pv,
                            size_t cb,
                            const SocketAddress& addr,
                            const rtc::PacketOptions& options) {
+  const EcnMarking ecn =
+      options.ecn_1 ? EcnMarking::kEct1 : EcnMarking::kNotEct;
+  if (options.batchable) {
+    if (num_pending_packets_ > 0 && addr != pending_address_) {
+      FlushPendingPackets();
+    }
+    if (BlockedOnPendingPackets()) {
+      return -1;
+    }
+    bool flush_now = options.last_packet_in_batch;
+    if (num_pending_packets_ == 0) {
+      pending_address_ = addr;
+      // Don't let the packets linger if the last packet of the batch never
+      // makes it to the socket.
+      if (webrtc::TaskQueueBase* current = webrtc::TaskQueueBase::Current()) {
+        current->PostTask(webrtc::SafeTask(safety_.flag(),
+                                           [this] { FlushPendingPackets(); }));
+      } else {
+        flush_now = true;
+      }
+    }
+    if (num_pending_packets_ == pending_packets_.size()) {
+      pending_packets_.emplace_back();
+    }
+    PendingPacket& pending = pending_packets_[num_pending_packets_++];
+    pending.payload.SetData(static_cast<const uint8_t*>(pv), cb);
+    pending.ecn = ecn;
+    pending.sent_packet =
+        rtc::SentPacket(options.packet_id, /*send_time_ms=*/-1,
+                        options.info_signaled_after_sent);
+    CopySocketInformationToPacketInfo(cb, *this, true,
+                                      &pending.sent_packet.info);
+    if (flush_now || num_pending_packets_ == kMaxSendBatchSize) {
+      FlushPendingPackets();
+    }
+    if (send_error_ != 0) {
+      socket_->SetError(send_error_);
+      send_error_ = 0;
+      return -1;
+    }
+    return static_cast<int>(cb);
+  }
+
+  FlushPendingPackets();
+  if (BlockedOnPendingPackets()) {
+    return -1;
+  }
   rtc::SentPacket sent_packet(options.packet_id, rtc::TimeMillis(),
                               options.info_signaled_after_sent);
   CopySocketInformationToPacketInfo(cb, *this, true, &sent_packet.info);
-  int ret = socket_->SendTo(pv, cb, addr);
+  int ret;
+  if (ecn == socket_ecn_) {
+    ret = socket_->SendTo(pv, cb, addr);
+  } else {
+    const rtc::ArrayView<const uint8_t> packet(static_cast<const uint8_t*>(pv),
+                                               cb);
+    ret = socket_->SendToBatch(rtc::MakeArrayView(&packet, 1), addr,
+                               rtc::MakeArrayView(&ecn, 1));
+    if (ret == 1) {
+      ret = static_cast<int>(cb);
+    }
+  }
   SignalSentPacket(this, sent_packet);
   return ret;
 }
 
+void AsyncUDPSocket::FlushPendingPackets() {
+  if (num_pending_packets_ == 0) {
+    return;
+  }
+  absl::InlinedVector<rtc::ArrayView<const uint8_t>, kMaxSendBatchSize> packets;
+  absl::InlinedVector<EcnMarking, kMaxSendBatchSize> ecn_markings;
+  bool marked_as_socket = true;
+  for (size_t i = 0; i < num_pending_packets_; ++i) {
+    packets.push_back(pending_packets_[i].payload);
+    ecn_markings.push_back(pending_packets_[i].ecn);
+    marked_as_socket &= pending_packets_[i].ecn == socket_ecn_;
+  }
+  if (marked_as_socket) {
+    // Sent with the marking of the socket option, without per-datagram
+    // markings.
+    ecn_markings.clear();
+  }
+
+  send_blocked_ = false;
+  size_t done = 0;
+  while (done < num_pending_packets_) {
+    const int sent = socket_->SendToBatch(
+        rtc::ArrayView<const rtc::ArrayView<const uint8_t>>(packets).subview(
+            done),
+        pending_address_,
+        ecn_markings.empty()
+            ? rtc::ArrayView<const EcnMarking>()
+            : rtc::ArrayView<const EcnMarking>(ecn_markings).subview(done));
+    if (sent > 0) {
+      const int64_t now_ms = rtc::TimeMillis();
+      for (size_t i = done; i < done + sent; ++i) {
+        pending_packets_[i].sent_packet.send_time_ms = now_ms;
+        SignalSentPacket(this, pending_packets_[i].sent_packet);
+      }
+      done += sent;
+      continue;
+    }
+    const int error = socket_->GetError();
+    if (IsBlockingError(error)) {
+      // Sent from OnWriteEvent().
+      send_blocked_ = true;
+      break;
+    }
+    RTC_LOG(LS_WARNING) << "AsyncUDPSocket dropped a batched packet, error "
+                        << error;
+    send_error_ = error;
+    ++done;
+  }
+
+  // Keeps the blocked packets, and their buffers, at the front.
+  std::rotate(pending_packets_.begin(), pending_packets_.begin() + done,
+              pending_packets_.begin() + num_pending_packets_);
+  num_pending_packets_ -= done;
+}
+
+bool AsyncUDPSocket::BlockedOnPendingPackets() {
+  if (num_pending_packets_ == 0 || !send_blocked_) {
+    return false;
+  }
+  socket_->SetError(EWOULDBLOCK);
+  return true;
+}
+
 int AsyncUDPSocket::Close() {
+  FlushPendingPackets();
   return socket_->Close();
 }
 
@@ -90,7 +276,11 @@ int AsyncUDPSocket::GetOption(Socket::Option opt, int* value) {
 }
 
 int AsyncUDPSocket::SetOption(Socket::Option opt, int value) {
-  return socket_->SetOption(opt, value);
+  int ret = socket_->SetOption(opt, value);
+  if (opt == Socket::OPT_SEND_ECN && ret == 0) {
+    socket_ecn_ = static_cast<EcnMarking>(value & 0x3);
+  }
+  return ret;
 }
 
 int AsyncUDPSocket::GetError() const {
@@ -105,6 +295,11 @@ void AsyncUDPSocket::OnReadEvent(Socket* socket) {
   RTC_DCHECK(socket_.get() == socket);
   RTC_DCHECK_RUN_ON(&sequence_checker_);
 
+  if (batched_receive_enabled_) {
+    ReadBatch();
+    return;
+  }
+
   Socket::ReceiveBuffer receive_buffer(buffer_);
   int len = socket_->RecvFrom(receive_buffer);
   if (len < 0) {
@@ -122,6 +317,73 @@ void AsyncUDPSocket::OnReadEvent(Socket* socket) {
     return;
   }
 
+  UpdateArrivalTime(receive_buffer);
+  if (packet_buffer_pool_) {
+    CopyOnWriteBuffer payload =
+        packet_buffer_pool_->CopyFrom(receive_buffer.payload);
+    ReceivedPacket packet(payload, receive_buffer.source_address,
+                          receive_buffer.arrival_time, receive_buffer.ecn);
+    packet.set_payload_buffer(&payload);
+    NotifyPacketReceived(packet);
+    return;
+  }
+  NotifyPacketReceived(
+      ReceivedPacket(receive_buffer.payload, receive_buffer.source_address,
+                     receive_buffer.arrival_time, receive_buffer.ecn));
+}
+
+void AsyncUDPSocket::ReadBatch() {
+  if (!batch_buffers_) {
+    batch_buffers_ = ReceiveBatchBuffers::ForCurrentThread(
+        kMaxReceiveBatchSize, kBatchedReceiveBufferSize);
+  }
+  scoped_refptr<ReceiveBatchBuffers> buffers = batch_buffers_;
+  if (buffers->in_use) {
+    // Read from a packet callback of another socket of this thread.
+    buffers = scoped_refptr<ReceiveBatchBuffers>(new ReceiveBatchBuffers(
+        kMaxReceiveBatchSize, kBatchedReceiveBufferSize));
+  }
+  absl::InlinedVector<Socket::ReceiveBuffer, kMaxReceiveBatchSize>
+      receive_buffers(buffers->buffers.begin(), buffers->buffers.end());
+  int count = socket_->RecvFromBatch(receive_buffers);
+  if (count < 0) {
+    // See OnReadEvent() for the single datagram case.
+    SocketAddress local_addr = socket_->GetLocalAddress();
+    RTC_LOG(LS_INFO) << "AsyncUDPSocket[" << local_addr.ToSensitiveString()
+                     << "] batched receive failed with error "
+                     << socket_->GetError();
+    return;
+  }
+
+  absl::InlinedVector<ReceivedPacket, kMaxReceiveBatchSize> packets;
+  // Not resized while the packets point to its elements.
+  std::array<CopyOnWriteBuffer, kMaxReceiveBatchSize> payloads;
+  for (int i = 0; i < count; ++i) {
+    Socket::ReceiveBuffer& receive_buffer = receive_buffers[i];
+    if (receive_buffer.payload.empty()) {
+      // Spurious wakeup or dropped datagram.
+      continue;
+    }
+    UpdateArrivalTime(receive_buffer);
+    if (packet_buffer_pool_) {
+      CopyOnWriteBuffer& payload = payloads[i];
+      payload = packet_buffer_pool_->CopyFrom(receive_buffer.payload);
+      packets.emplace_back(payload, receive_buffer.source_address,
+                           receive_buffer.arrival_time, receive_buffer.ecn);
+      packets.back().set_payload_buffer(&payload);
+    } else {
+      packets.emplace_back(receive_buffer.payload,
+                           receive_buffer.source_address,
+                           receive_buffer.arrival_time, receive_buffer.ecn);
+    }
+  }
+  buffers->in_use = true;
+  NotifyPacketsReceived(packets);
+  // This socket may be destroyed by now, but `buffers` is still held.
+  buffers->in_use = false;
+}
+
+void AsyncUDPSocket::UpdateArrivalTime(Socket::ReceiveBuffer& receive_buffer) {
   if (!receive_buffer.arrival_time) {
     // Timestamp from socket is not available.
     receive_buffer.arrival_time = webrtc::Timestamp::Micros(rtc::TimeMicros());
@@ -133,13 +395,13 @@ void AsyncUDPSocket::OnReadEvent(Socket* socket) {
     }
     *receive_buffer.arrival_time += *socket_time_offset_;
   }
-  NotifyPacketReceived(
-      ReceivedPacket(receive_buffer.payload, receive_buffer.source_address,
-                     receive_buffer.arrival_time, receive_buffer.ecn));
 }
 
 void AsyncUDPSocket::OnWriteEvent(Socket* socket) {
-  SignalReadyToSend(this);
+  FlushPendingPackets();
+  if (num_pending_packets_ == 0) {
+    SignalReadyToSend(this);
+  }
 }
 
 }  // namespace rtc
@@ -15,11 +15,19 @@
 
 #include <cstdint>
 #include <memory>
+#include <utility>
+#include <vector>
 
 #include "absl/types/optional.h"
+#include "api/scoped_refptr.h"
 #include "api/sequence_checker.h"
+#include "api/task_queue/pending_task_safety_flag.h"
 #include "api/units/time_delta.h"
 #include "rtc_base/async_packet_socket.h"
+#include "rtc_base/buffer.h"
+#include "rtc_base/copy_on_write_buffer.h"
+#include "rtc_base/network/sent_packet.h"
+#include "rtc_base/packet_buffer_pool.h"
 #include "rtc_base/socket.h"
 #include "rtc_base/socket_address.h"
 #include "rtc_base/socket_factory.h"
@@ -28,8 +36,23 @@
 
 namespace rtc {
 
+// Receive buffers shared by the batched sockets of a thread, defined in
+// async_udp_socket.cc.
+class ReceiveBatchBuffers;
+
 // Provides the ability to receive packets asynchronously.  Sends are not
 // buffered since it is acceptable to drop packets under high load.
+//
+// Packets sent with PacketOptions::batchable set are held back until the
+// packet marked `last_packet_in_batch` arrives, and are then handed to the
+// socket in a single Socket::SendToBatch() call. Any other send, a change of
+// destination, or the end of the current task flushes the held packets first.
+// The ECN marking of PacketOptions::ecn_1 is carried with each packet that
+// SendTo() sends, so it does not break up batches. Packets the socket would
+// block on stay held back until it is writable, and sends fail with
+// EWOULDBLOCK until then. A packet the socket rejects is dropped, and its
+// error is returned by the SendTo() call that flushed it, or else by the next
+// batchable SendTo().
 class AsyncUDPSocket : public AsyncPacketSocket {
  public:
   // Binds `socket` and creates AsyncUDPSocket for it. Takes ownership
@@ -42,7 +65,7 @@ class AsyncUDPSocket : public AsyncPacketSocket {
   static AsyncUDPSocket* Create(SocketFactory* factory,
                                 const SocketAddress& bind_address);
   explicit AsyncUDPSocket(Socket* socket);
-  ~AsyncUDPSocket() = default;
+  ~AsyncUDPSocket() override;
 
   SocketAddress GetLocalAddress() const override;
   SocketAddress GetRemoteAddress() const override;
@@ -61,17 +84,80 @@ class AsyncUDPSocket : public AsyncPacketSocket {
   int GetError() const override;
   void SetError(int error) override;
 
+  // When enabled, each read event drains up to `kMaxReceiveBatchSize`
+  // datagrams from the socket with a single call, and then delivers them to
+  // the received packet callback. Disabled by default. Must be called before
+  // the socket starts receiving.
+  void SetBatchedReceive(bool enabled) { batched_receive_enabled_ = enabled; }
+
+  // When set, each received datagram is delivered in its own buffer from
+  // `pool`, attached to the ReceivedPacket so that consumers can keep the
+  // payload without copying it, see ReceivedPacket::SharePayload(). Must be
+  // called on the thread that owns `pool` and before the socket starts
+  // receiving.
+  void SetPacketBufferPool(scoped_refptr<PacketBufferPool> pool) {
+    packet_buffer_pool_ = std::move(pool);
+  }
+
  private:
+  // Maximum number of datagrams read on a single read event in batched mode.
+  static constexpr size_t kMaxReceiveBatchSize = 16;
+  // Capacity of each batched receive buffer, large enough for any datagram
+  // like the buffer of the unbatched path.
+  static constexpr size_t kBatchedReceiveBufferSize = 64 * 1024;
+  // Maximum number of batchable packets held back before they are sent.
+  static constexpr size_t kMaxSendBatchSize = 64;
+
+  struct PendingPacket {
+    rtc::Buffer payload;
+    EcnMarking ecn = EcnMarking::kNotEct;
+    rtc::SentPacket sent_packet;
+  };
+
   // Called when the underlying socket is ready to be read from.
   void OnReadEvent(Socket* socket);
   // Called when the underlying socket is ready to send.
   void OnWriteEvent(Socket* socket);
 
+  void ReadBatch() RTC_RUN_ON(sequence_checker_);
+  // Sends the packets held back by SendTo() to `pending_address_`, except
+  // those the socket blocks on. SignalSentPacket is fired for the packets that
+  // are sent.
+  void FlushPendingPackets();
+  // Sets EWOULDBLOCK and returns true if held back packets wait for the socket
+  // to become writable.
+  bool BlockedOnPendingPackets();
+  // Fills in or translates the arrival time of a received datagram to the
+  // rtc::TimeMicros() clock.
+  void UpdateArrivalTime(Socket::ReceiveBuffer& receive_buffer)
+      RTC_RUN_ON(sequence_checker_);
+
   RTC_NO_UNIQUE_ADDRESS webrtc::SequenceChecker sequence_checker_;
   std::unique_ptr<Socket> socket_;
+  bool batched_receive_enabled_ = false;
+  scoped_refptr<PacketBufferPool> packet_buffer_pool_;
   rtc::Buffer buffer_ RTC_GUARDED_BY(sequence_checker_);
+  // Taken on the first batched read, and shared with the other batched
+  // sockets reading on the same thread.
+  scoped_refptr<ReceiveBatchBuffers> batch_buffers_
+      RTC_GUARDED_BY(sequence_checker_);
   absl::optional<webrtc::TimeDelta> socket_time_offset_
       RTC_GUARDED_BY(sequence_checker_);
+  // Buffers are reused across batches, only the first `num_pending_packets_`
+  // entries hold packets waiting to be sent.
+  std::vector<PendingPacket> pending_packets_;
+  size_t num_pending_packets_ = 0;
+  SocketAddress pending_address_;
+  // Set when a held back packet is blocked on the socket.
+  bool send_blocked_ = false;
+  // Error of the last held back packet that the socket rejected, until it is
+  // returned by SendTo().
+  int send_error_ = 0;
+  // OPT_SEND_ECN of the socket, which Send() and SetOption() change. Packets
+  // sent with another marking carry it per datagram, see
+  // Socket::SendToBatch().
+  EcnMarking socket_ecn_ = EcnMarking::kNotEct;
+  webrtc::ScopedTaskSafetyDetached safety_;
 };
 
 }  // namespace rtc
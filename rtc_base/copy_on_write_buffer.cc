@@ -40,6 +40,16 @@ CopyOnWriteBuffer::CopyOnWriteBuffer(size_t size)
   RTC_DCHECK(IsConsistent());
 }
 
+CopyOnWriteBuffer::CopyOnWriteBuffer(scoped_refptr<Storage> storage,
+                                     size_t size)
+    : buffer_(std::move(storage)), offset_(0), size_(size) {
+  RTC_DCHECK(buffer_);
+  RTC_DCHECK(buffer_->HasOneRef());
+  RTC_DCHECK_LE(size, buffer_->capacity());
+  buffer_->SetSize(size);
+  RTC_DCHECK(IsConsistent());
+}
+
 CopyOnWriteBuffer::CopyOnWriteBuffer(size_t size, size_t capacity)
     : buffer_(size > 0 || capacity > 0 ? new RefCountedBuffer(size, capacity)
                                        : nullptr),
@@ -23,7 +23,9 @@
 #include "api/scoped_refptr.h"
 #include "rtc_base/buffer.h"
 #include "rtc_base/checks.h"
+#include "rtc_base/ref_count.h"
 #include "rtc_base/ref_counted_object.h"
+#include "rtc_base/ref_counter.h"
 #include "rtc_base/system/rtc_export.h"
 #include "rtc_base/type_traits.h"
 
@@ -31,6 +33,44 @@ namespace rtc {
 
 class RTC_EXPORT CopyOnWriteBuffer {
  public:
+  class Storage;
+
+  // Takes back storage when its last reference is dropped, instead of it
+  // being deleted, so that the allocation can be reused. See PacketBufferPool.
+  class StorageRecycler {
+   public:
+    virtual void Recycle(Storage* storage) = 0;
+
+   protected:
+    virtual ~StorageRecycler() = default;
+  };
+
+  // Reference counted memory shared by CopyOnWriteBuffer instances.
+  class Storage final : public Buffer {
+   public:
+    using Buffer::Buffer;
+
+    void AddRef() const { ref_count_.IncRef(); }
+    RefCountReleaseStatus Release() const {
+      const RefCountReleaseStatus status = ref_count_.DecRef();
+      if (status == RefCountReleaseStatus::kDroppedLastRef) {
+        if (recycler_) {
+          recycler_->Recycle(const_cast<Storage*>(this));
+        } else {
+          delete this;
+        }
+      }
+      return status;
+    }
+    bool HasOneRef() const { return ref_count_.HasOneRef(); }
+
+    void set_recycler(StorageRecycler* recycler) { recycler_ = recycler; }
+
+   private:
+    mutable webrtc::webrtc_impl::RefCounter ref_count_{0};
+    StorageRecycler* recycler_ = nullptr;
+  };
+
   // An empty buffer.
   CopyOnWriteBuffer();
   // Share the data with an existing buffer.
@@ -45,6 +85,10 @@ class RTC_EXPORT CopyOnWriteBuffer {
   explicit CopyOnWriteBuffer(size_t size);
   CopyOnWriteBuffer(size_t size, size_t capacity);
 
+  // Construct a buffer of `size` uninitialized bytes in `storage`, which must
+  // not be shared and have at least that capacity.
+  CopyOnWriteBuffer(scoped_refptr<Storage> storage, size_t size);
+
   // Construct a buffer and copy the specified number of bytes into it. The
   // source array may be (const) uint8_t*, int8_t*, or char*.
   template <typename T,
@@ -289,7 +333,7 @@ class RTC_EXPORT CopyOnWriteBuffer {
   }
 
  private:
-  using RefCountedBuffer = FinalRefCountedObject<Buffer>;
+  using RefCountedBuffer = Storage;
   // Create a copy of the underlying data if it is referenced from other Buffer
   // objects or there is not enough capacity.
   void UnshareAndEnsureCapacity(size_t new_capacity);
@@ -60,7 +60,9 @@ bool Event::Wait(TimeDelta give_up_after, TimeDelta /*warn_after*/) {
       give_up_after.IsPlusInfinity()
           ? INFINITE
           : give_up_after.RoundUpTo(webrtc::TimeDelta::Millis(1)).ms();
-  return (WaitForSingleObject(event_handle_, ms) == WAIT_OBJECT_0);
+  const bool signaled = WaitForSingleObject(event_handle_, ms) == WAIT_OBJECT_0;
+  ScopedYieldPolicy::ResumeExecution();
+  return signaled;
 }
 
 #elif defined(WEBRTC_POSIX)
@@ -201,6 +203,7 @@ bool Event::Wait(TimeDelta give_up_after, TimeDelta warn_after) {
     event_status_ = false;
 
   pthread_mutex_unlock(&event_mutex_);
+  ScopedYieldPolicy::ResumeExecution();
 
   return (error == 0);
 }
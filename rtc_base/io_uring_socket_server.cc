@@ -0,0 +1,800 @@
+/*
+ *  Copyright 2024 The WebRTC Project Authors. All rights reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "rtc_base/io_uring_socket_server.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/time.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <utility>
+
+#include "absl/algorithm/container.h"
+#include "api/units/timestamp.h"
+#include "rtc_base/checks.h"
+#include "rtc_base/logging.h"
+
+namespace rtc {
+
+namespace {
+
+constexpr unsigned kSubmissionQueueSize = 256;
+// Every datagram produces a completion, so leave room for bursts.
+constexpr unsigned kCompletionQueueSize = 4096;
+
+// Provided receive buffers shared by all sockets. Must be a power of two.
+constexpr unsigned kNumReceiveBuffers = 512;
+constexpr uint16_t kReceiveBufferGroup = 0;
+// Same ancillary data space as PhysicalSocket uses for recvmsg().
+constexpr size_t kReceiveControlSize =
+    CMSG_SPACE(sizeof(struct timeval) + 5 * sizeof(int));
+// Each receive buffer starts with a io_uring_recvmsg_out header followed by
+// the source address and the ancillary data, then the payload.
+constexpr size_t kReceiveHeaderSize = sizeof(io_uring_recvmsg_out) +
+                                      sizeof(sockaddr_storage) +
+                                      kReceiveControlSize;
+// Any UDP datagram fits, as in PhysicalSocket::RecvFrom(). Memory is only
+// committed for the pages that datagrams are written to.
+constexpr size_t kMaxReceivePayloadSize = 64 * 1024;
+constexpr size_t kReceiveBufferSize =
+    kReceiveHeaderSize + kMaxReceivePayloadSize;
+static_assert(kReceiveBufferSize % alignof(cmsghdr) == 0,
+              "Receive buffers must keep the ancillary data aligned");
+
+// Upper bound on the number of sends in flight across all sockets.
+constexpr uint32_t kNumSendSlots = 256;
+
+// The operation a completion belongs to is stored in the top byte of its
+// user data, the socket key or send slot in the remaining bits.
+enum class Operation : uint64_t {
+  kReceive = 1,
+  kSend = 2,
+  kCancel = 3,
+};
+constexpr int kOperationShift = 56;
+constexpr uint64_t kValueMask = (uint64_t{1} << kOperationShift) - 1;
+
+uint64_t MakeUserData(Operation operation, uint64_t value) {
+  RTC_DCHECK_EQ(value & ~kValueMask, 0);
+  return (static_cast<uint64_t>(operation) << kOperationShift) | value;
+}
+
+int IoUringSetup(unsigned entries, io_uring_params* params) {
+  return static_cast<int>(syscall(__NR_io_uring_setup, entries, params));
+}
+
+int IoUringEnter(int fd,
+                 unsigned to_submit,
+                 unsigned min_complete,
+                 unsigned flags) {
+  return static_cast<int>(syscall(__NR_io_uring_enter, fd, to_submit,
+                                  min_complete, flags, nullptr, 0));
+}
+
+int IoUringRegister(int fd, unsigned opcode, void* arg, unsigned nr_args) {
+  return static_cast<int>(
+      syscall(__NR_io_uring_register, fd, opcode, arg, nr_args));
+}
+
+template <typename T>
+T* RingPointer(void* ring, uint32_t offset) {
+  return reinterpret_cast<T*>(static_cast<uint8_t*>(ring) + offset);
+}
+
+}  // namespace
+
+// Reports the io_uring file descriptor as readable to the PhysicalSocketServer
+// whenever completions are available.
+class IoUringSocketServer::CompletionDispatcher : public Dispatcher {
+ public:
+  explicit CompletionDispatcher(IoUringSocketServer* ss) : ss_(ss) {
+    ss_->Add(this);
+  }
+  ~CompletionDispatcher() override { ss_->Remove(this); }
+
+  uint32_t GetRequestedEvents() override { return DE_READ; }
+  void OnEvent(uint32_t ff, int err) override { ss_->ProcessCompletions(); }
+  int GetDescriptor() override { return ss_->ring_fd_; }
+  bool IsDescriptorClosed() override { return false; }
+
+ private:
+  IoUringSocketServer* const ss_;
+};
+
+std::unique_ptr<IoUringSocketServer> IoUringSocketServer::Create() {
+  std::unique_ptr<IoUringSocketServer> ss(new IoUringSocketServer());
+  if (!ss->Initialize()) {
+    return nullptr;
+  }
+  return ss;
+}
+
+IoUringSocketServer::IoUringSocketServer() = default;
+
+IoUringSocketServer::~IoUringSocketServer() {
+  RTC_DCHECK(sockets_.empty());
+  completion_dispatcher_.reset();
+  if (ring_fd_ >= 0) {
+    close(ring_fd_);
+  }
+  if (rings_) {
+    munmap(rings_, rings_size_);
+  }
+  if (sqes_) {
+    munmap(sqes_, sqes_size_);
+  }
+  if (buffer_ring_) {
+    munmap(buffer_ring_, buffer_ring_size_);
+  }
+  if (buffers_) {
+    munmap(buffers_, kNumReceiveBuffers * kReceiveBufferSize);
+  }
+}
+
+bool IoUringSocketServer::Initialize() {
+  io_uring_params params = {};
+  params.flags = IORING_SETUP_CQSIZE;
+  params.cq_entries = kCompletionQueueSize;
+  ring_fd_ = IoUringSetup(kSubmissionQueueSize, &params);
+  if (ring_fd_ < 0) {
+    RTC_LOG_E(LS_WARNING, EN, errno) << "io_uring_setup";
+    return false;
+  }
+  if (!(params.features & IORING_FEAT_SINGLE_MMAP) ||
+      !(params.features & IORING_FEAT_NODROP)) {
+    RTC_LOG(LS_WARNING) << "io_uring lacks required features";
+    return false;
+  }
+
+  rings_size_ = std::max<size_t>(
+      params.sq_off.array + params.sq_entries * sizeof(unsigned),
+      params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe));
+  void* rings = mmap(nullptr, rings_size_, PROT_READ | PROT_WRITE,
+                     MAP_SHARED | MAP_POPULATE, ring_fd_, IORING_OFF_SQ_RING);
+  if (rings == MAP_FAILED) {
+    RTC_LOG_E(LS_WARNING, EN, errno) << "mmap";
+    return false;
+  }
+  rings_ = rings;
+  sqes_size_ = params.sq_entries * sizeof(io_uring_sqe);
+  void* sqes = mmap(nullptr, sqes_size_, PROT_READ | PROT_WRITE,
+                    MAP_SHARED | MAP_POPULATE, ring_fd_, IORING_OFF_SQES);
+  if (sqes == MAP_FAILED) {
+    RTC_LOG_E(LS_WARNING, EN, errno) << "mmap";
+    return false;
+  }
+  sqes_ = static_cast<io_uring_sqe*>(sqes);
+  sq_entries_ = params.sq_entries;
+  sq_head_ = RingPointer<unsigned>(rings_, params.sq_off.head);
+  sq_tail_ = RingPointer<unsigned>(rings_, params.sq_off.tail);
+  sq_flags_ = RingPointer<unsigned>(rings_, params.sq_off.flags);
+  sq_mask_ = *RingPointer<unsigned>(rings_, params.sq_off.ring_mask);
+  sq_array_ = RingPointer<unsigned>(rings_, params.sq_off.array);
+  sqe_tail_ = *sq_tail_;
+  cq_head_ = RingPointer<unsigned>(rings_, params.cq_off.head);
+  cq_tail_ = RingPointer<unsigned>(rings_, params.cq_off.tail);
+  cq_mask_ = *RingPointer<unsigned>(rings_, params.cq_off.ring_mask);
+  cqes_ = RingPointer<io_uring_cqe>(rings_, params.cq_off.cqes);
+
+  // Provided buffer rings were added in Linux 5.19.
+  buffer_ring_size_ = kNumReceiveBuffers * sizeof(io_uring_buf);
+  void* buffer_ring = mmap(nullptr, buffer_ring_size_, PROT_READ | PROT_WRITE,
+                           MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  if (buffer_ring == MAP_FAILED) {
+    RTC_LOG_E(LS_WARNING, EN, errno) << "mmap";
+    return false;
+  }
+  buffer_ring_ = static_cast<io_uring_buf*>(buffer_ring);
+  io_uring_buf_reg registration = {};
+  registration.ring_addr = reinterpret_cast<uint64_t>(buffer_ring_);
+  registration.ring_entries = kNumReceiveBuffers;
+  registration.bgid = kReceiveBufferGroup;
+  if (IoUringRegister(ring_fd_, IORING_REGISTER_PBUF_RING, &registration,
+                      1) != 0) {
+    RTC_LOG_E(LS_WARNING, EN, errno) << "IORING_REGISTER_PBUF_RING";
+    return false;
+  }
+  void* buffers = mmap(nullptr, kNumReceiveBuffers * kReceiveBufferSize,
+                       PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1,
+                       0);
+  if (buffers == MAP_FAILED) {
+    RTC_LOG_E(LS_WARNING, EN, errno) << "mmap";
+    return false;
+  }
+  buffers_ = static_cast<uint8_t*>(buffers);
+  for (unsigned i = 0; i < kNumReceiveBuffers; ++i) {
+    ProvideBuffer(static_cast<uint16_t>(i));
+  }
+  receive_msg_.msg_namelen = sizeof(sockaddr_storage);
+  receive_msg_.msg_controllen = kReceiveControlSize;
+
+  if (!SupportsMultishotReceive()) {
+    RTC_LOG(LS_WARNING) << "io_uring does not support multishot receive";
+    return false;
+  }
+
+  send_slots_.resize(kNumSendSlots);
+  free_send_slots_.reserve(kNumSendSlots);
+  for (uint32_t i = kNumSendSlots; i > 0; --i) {
+    free_send_slots_.push_back(i - 1);
+  }
+
+  completion_dispatcher_ = std::make_unique<CompletionDispatcher>(this);
+  return true;
+}
+
+bool IoUringSocketServer::SupportsMultishotReceive() {
+  // Multishot receives were added in Linux 6.0, older kernels fail them with
+  // EINVAL. Post one on a throwaway socket and cancel it again to find out.
+  const int fd = ::socket(AF_INET, SOCK_DGRAM | SOCK_NONBLOCK, 0);
+  if (fd < 0) {
+    return false;
+  }
+  const uint64_t key = next_socket_key_++;
+  PostReceive(key, fd);
+  CancelReceive(key);
+  Submit();
+  bool supported = false;
+  for (int completions = 0; completions < 2;) {
+    if (IoUringEnter(ring_fd_, 0, 1, IORING_ENTER_GETEVENTS) < 0 &&
+        errno != EINTR) {
+      break;
+    }
+    const unsigned tail = __atomic_load_n(cq_tail_, __ATOMIC_ACQUIRE);
+    for (unsigned head = *cq_head_; head != tail; ++head) {
+      const io_uring_cqe& cqe = cqes_[head & cq_mask_];
+      if (cqe.user_data == MakeUserData(Operation::kReceive, key)) {
+        supported = cqe.res == -ECANCELED;
+      }
+      ++completions;
+    }
+    __atomic_store_n(cq_head_, tail, __ATOMIC_RELEASE);
+  }
+  ::close(fd);
+  return supported;
+}
+
+Socket* IoUringSocketServer::CreateSocket(int family, int type) {
+  if (type != SOCK_DGRAM) {
+    return PhysicalSocketServer::CreateSocket(family, type);
+  }
+  IoUringUdpSocket* socket = new IoUringUdpSocket(this);
+  if (socket->Create(family, type)) {
+    return socket;
+  } else {
+    delete socket;
+    return nullptr;
+  }
+}
+
+bool IoUringSocketServer::Wait(webrtc::TimeDelta max_wait_duration,
+                               bool process_io) {
+  // Datagrams that are already queued must not wait for new completions.
+  if (process_io && !readable_sockets_.empty()) {
+    SignalReadEvents();
+    max_wait_duration = webrtc::TimeDelta::Zero();
+  }
+  return PhysicalSocketServer::Wait(max_wait_duration, process_io);
+}
+
+void IoUringSocketServer::AddSocket(IoUringUdpSocket* socket) {
+  socket->key_ = next_socket_key_++;
+  sockets_.emplace(socket->key_, socket);
+  PostReceive(socket->key_, socket->GetSocketFD());
+  Submit();
+}
+
+void IoUringSocketServer::RemoveSocket(IoUringUdpSocket* socket) {
+  sockets_.erase(socket->key_);
+  CancelReceive(socket->key_);
+  Submit();
+  for (const IoUringUdpSocket::ReceivedDatagram& datagram :
+       socket->received_) {
+    ReturnBuffer(datagram.buffer_id);
+  }
+  socket->received_.clear();
+  socket->queued_as_readable_ = false;
+}
+
+size_t IoUringSocketServer::SubmitSends(
+    IoUringUdpSocket* socket,
+    rtc::ArrayView<const rtc::ArrayView<const uint8_t>> packets,
+    rtc::ArrayView<const EcnMarking> ecn_markings,
+    const sockaddr_storage* addr,
+    socklen_t addr_len) {
+  RTC_DCHECK(ecn_markings.empty() || ecn_markings.size() == packets.size());
+  RTC_DCHECK(ecn_markings.empty() || addr);
+  size_t submitted = 0;
+  for (rtc::ArrayView<const uint8_t> packet : packets) {
+    if (free_send_slots_.empty()) {
+      break;
+    }
+    io_uring_sqe* sqe = GetSqe();
+    if (!sqe) {
+      break;
+    }
+    const uint32_t index = free_send_slots_.back();
+    free_send_slots_.pop_back();
+    // The kernel may read the message after this call returns, so it is
+    // copied into a slot that stays alive until the send completes.
+    SendSlot& slot = send_slots_[index];
+    slot.payload.SetData(packet.data(), packet.size());
+    slot.iov = {.iov_base = slot.payload.data(),
+                .iov_len = slot.payload.size()};
+    slot.msg = {.msg_iov = &slot.iov, .msg_iovlen = 1};
+    if (addr) {
+      slot.addr = *addr;
+      slot.msg.msg_name = &slot.addr;
+      slot.msg.msg_namelen = addr_len;
+    }
+    if (!ecn_markings.empty()) {
+      slot.msg.msg_control = slot.control;
+      slot.msg.msg_controllen = sizeof(slot.control);
+      socket->WriteDsControlMessage(CMSG_FIRSTHDR(&slot.msg), slot.addr,
+                                    ecn_markings[submitted]);
+    }
+    slot.socket_key = socket->key_;
+
+    sqe->opcode = IORING_OP_SENDMSG;
+    sqe->fd = socket->GetSocketFD();
+    sqe->addr = reinterpret_cast<uint64_t>(&slot.msg);
+    sqe->len = 1;
+    sqe->msg_flags = MSG_NOSIGNAL;
+    sqe->user_data = MakeUserData(Operation::kSend, index);
+    ++submitted;
+  }
+  Submit();
+  return submitted;
+}
+
+void IoUringSocketServer::WaitForSendSlot(IoUringUdpSocket* socket) {
+  if (!absl::c_linear_search(blocked_writers_, socket->key_)) {
+    blocked_writers_.push_back(socket->key_);
+  }
+}
+
+void IoUringSocketServer::MarkReadable(IoUringUdpSocket* socket) {
+  if (!socket->queued_as_readable_) {
+    socket->queued_as_readable_ = true;
+    readable_sockets_.push_back(socket->key_);
+  }
+}
+
+uint8_t* IoUringSocketServer::GetBuffer(uint16_t buffer_id) {
+  RTC_DCHECK_LT(buffer_id, kNumReceiveBuffers);
+  return buffers_ + buffer_id * kReceiveBufferSize;
+}
+
+void IoUringSocketServer::ProvideBuffer(uint16_t buffer_id) {
+  io_uring_buf& buffer =
+      buffer_ring_[buffer_ring_tail_ & (kNumReceiveBuffers - 1)];
+  buffer.addr = reinterpret_cast<uint64_t>(GetBuffer(buffer_id));
+  buffer.len = kReceiveBufferSize;
+  buffer.bid = buffer_id;
+  ++buffer_ring_tail_;
+  // The ring tail overlays the reserved field of the first entry.
+  __atomic_store_n(&buffer_ring_[0].resv, buffer_ring_tail_, __ATOMIC_RELEASE);
+}
+
+void IoUringSocketServer::ReturnBuffer(uint16_t buffer_id) {
+  ProvideBuffer(buffer_id);
+  RTC_DCHECK_GT(buffers_in_use_, 0);
+  --buffers_in_use_;
+  // Resume receiving on sockets that ran out of buffers once enough have
+  // been returned, rather than after every single one.
+  if (!starved_sockets_.empty() && buffers_in_use_ <= kNumReceiveBuffers / 2) {
+    std::vector<uint64_t> starved_sockets = std::move(starved_sockets_);
+    starved_sockets_.clear();
+    for (uint64_t key : starved_sockets) {
+      auto it = sockets_.find(key);
+      if (it != sockets_.end()) {
+        PostReceive(key, it->second->GetSocketFD());
+      }
+    }
+    Submit();
+  }
+}
+
+io_uring_sqe* IoUringSocketServer::GetSqe() {
+  if (sqe_tail_ - __atomic_load_n(sq_head_, __ATOMIC_ACQUIRE) == sq_entries_) {
+    Submit();
+    if (sqe_tail_ - __atomic_load_n(sq_head_, __ATOMIC_ACQUIRE) ==
+        sq_entries_) {
+      RTC_LOG(LS_ERROR) << "io_uring submission queue is full";
+      return nullptr;
+    }
+  }
+  const unsigned index = sqe_tail_ & sq_mask_;
+  io_uring_sqe* sqe = &sqes_[index];
+  memset(sqe, 0, sizeof(*sqe));
+  sq_array_[index] = index;
+  ++sqe_tail_;
+  ++pending_submissions_;
+  return sqe;
+}
+
+void IoUringSocketServer::Submit() {
+  if (pending_submissions_ == 0) {
+    return;
+  }
+  __atomic_store_n(sq_tail_, sqe_tail_, __ATOMIC_RELEASE);
+  int submitted;
+  do {
+    submitted = IoUringEnter(ring_fd_, pending_submissions_, 0, 0);
+  } while (submitted < 0 && errno == EINTR);
+  if (submitted < 0) {
+    // The entries stay queued and are submitted with the next call.
+    RTC_LOG_E(LS_ERROR, EN, errno) << "io_uring_enter";
+    return;
+  }
+  pending_submissions_ -= submitted;
+}
+
+void IoUringSocketServer::PostReceive(uint64_t key, int fd) {
+  io_uring_sqe* sqe = GetSqe();
+  if (!sqe) {
+    starved_sockets_.push_back(key);
+    return;
+  }
+  sqe->opcode = IORING_OP_RECVMSG;
+  sqe->fd = fd;
+  sqe->addr = reinterpret_cast<uint64_t>(&receive_msg_);
+  sqe->ioprio = IORING_RECV_MULTISHOT;
+  sqe->flags = IOSQE_BUFFER_SELECT;
+  sqe->buf_group = kReceiveBufferGroup;
+  sqe->user_data = MakeUserData(Operation::kReceive, key);
+}
+
+void IoUringSocketServer::CancelReceive(uint64_t key) {
+  io_uring_sqe* sqe = GetSqe();
+  if (!sqe) {
+    return;
+  }
+  sqe->opcode = IORING_OP_ASYNC_CANCEL;
+  sqe->fd = -1;
+  sqe->addr = MakeUserData(Operation::kReceive, key);
+  sqe->user_data = MakeUserData(Operation::kCancel, key);
+}
+
+void IoUringSocketServer::ProcessCompletions() {
+  if (__atomic_load_n(sq_flags_, __ATOMIC_RELAXED) & IORING_SQ_CQ_OVERFLOW) {
+    // Move completions that did not fit into the queue back into it.
+    IoUringEnter(ring_fd_, 0, 0, IORING_ENTER_GETEVENTS);
+  }
+  unsigned head = *cq_head_;
+  unsigned tail = __atomic_load_n(cq_tail_, __ATOMIC_ACQUIRE);
+  while (head != tail) {
+    for (; head != tail; ++head) {
+      const io_uring_cqe cqe = cqes_[head & cq_mask_];
+      __atomic_store_n(cq_head_, head + 1, __ATOMIC_RELEASE);
+      const uint64_t value = cqe.user_data & kValueMask;
+      switch (static_cast<Operation>(cqe.user_data >> kOperationShift)) {
+        case Operation::kReceive:
+          OnReceiveCompletion(value, cqe);
+          break;
+        case Operation::kSend:
+          OnSendCompletion(static_cast<uint32_t>(value), cqe.res);
+          break;
+        case Operation::kCancel:
+          break;
+      }
+    }
+    tail = __atomic_load_n(cq_tail_, __ATOMIC_ACQUIRE);
+  }
+  Submit();
+  SignalReadEvents();
+  SignalWriteEvents();
+}
+
+void IoUringSocketServer::OnReceiveCompletion(uint64_t key,
+                                              const io_uring_cqe& cqe) {
+  const bool has_buffer = cqe.flags & IORING_CQE_F_BUFFER;
+  const uint16_t buffer_id =
+      static_cast<uint16_t>(cqe.flags >> IORING_CQE_BUFFER_SHIFT);
+  if (has_buffer) {
+    ++buffers_in_use_;
+  }
+  auto it = sockets_.find(key);
+  if (it == sockets_.end()) {
+    // The socket was closed while the datagram was on its way.
+    if (has_buffer) {
+      ReturnBuffer(buffer_id);
+    }
+    return;
+  }
+  IoUringUdpSocket* socket = it->second;
+  if (has_buffer) {
+    if (cqe.res > 0 && socket->OnDatagramReceived(buffer_id,
+                                                  GetBuffer(buffer_id),
+                                                  cqe.res, receive_msg_)) {
+      MarkReadable(socket);
+    } else {
+      ReturnBuffer(buffer_id);
+    }
+  }
+  if (cqe.flags & IORING_CQE_F_MORE) {
+    return;
+  }
+  // The kernel stopped the multishot receive, repost it.
+  if (cqe.res == -ENOBUFS) {
+    // Wait until the application has consumed enough datagrams.
+    starved_sockets_.push_back(key);
+    return;
+  }
+  if (cqe.res < 0) {
+    RTC_LOG_E(LS_VERBOSE, EN, -cqe.res) << "io_uring recvmsg";
+  }
+  PostReceive(key, socket->GetSocketFD());
+}
+
+void IoUringSocketServer::OnSendCompletion(uint32_t index, int result) {
+  SendSlot& slot = send_slots_[index];
+  if (result < 0) {
+    // Like with sendto() on a non-blocking UDP socket, errors are not
+    // reported to the application other than through the log.
+    RTC_LOG_E(LS_VERBOSE, EN, -result)
+        << "io_uring sendmsg, socket key=" << slot.socket_key;
+  }
+  free_send_slots_.push_back(index);
+}
+
+void IoUringSocketServer::SignalReadEvents() {
+  while (!readable_sockets_.empty()) {
+    const uint64_t key = readable_sockets_.front();
+    readable_sockets_.pop_front();
+    auto it = sockets_.find(key);
+    if (it == sockets_.end()) {
+      continue;
+    }
+    IoUringUdpSocket* socket = it->second;
+    socket->queued_as_readable_ = false;
+    if (socket->received_.empty() ||
+        !(socket->enabled_events() & DE_READ)) {
+      continue;
+    }
+    // Reading re-enables DE_READ, which queues the socket again while it
+    // has datagrams left. The socket may be deleted by the handler.
+    socket->DisableEvents(DE_READ);
+    socket->SignalReadEvent(socket);
+  }
+}
+
+void IoUringSocketServer::SignalWriteEvents() {
+  if (blocked_writers_.empty() || free_send_slots_.empty()) {
+    return;
+  }
+  std::vector<uint64_t> blocked_writers = std::move(blocked_writers_);
+  blocked_writers_.clear();
+  for (uint64_t key : blocked_writers) {
+    auto it = sockets_.find(key);
+    if (it == sockets_.end()) {
+      continue;
+    }
+    IoUringUdpSocket* socket = it->second;
+    if (socket->enabled_events() & DE_WRITE) {
+      socket->DisableEvents(DE_WRITE);
+      socket->SignalWriteEvent(socket);
+    }
+  }
+}
+
+IoUringUdpSocket::IoUringUdpSocket(IoUringSocketServer* ss)
+    : PhysicalSocket(ss), server_(ss) {}
+
+IoUringUdpSocket::~IoUringUdpSocket() {
+  Close();
+}
+
+bool IoUringUdpSocket::Create(int family, int type) {
+  RTC_DCHECK_EQ(type, SOCK_DGRAM);
+  if (!PhysicalSocket::Create(family, type)) {
+    return false;
+  }
+  fcntl(s_, F_SETFL, fcntl(s_, F_GETFL, 0) | O_NONBLOCK);
+  int value = 1;
+  // Attempt to get receive packet timestamp from the socket.
+  if (::setsockopt(s_, SOL_SOCKET, SO_TIMESTAMP, &value, sizeof(value)) != 0) {
+    RTC_DLOG(LS_ERROR) << "::setsockopt failed. errno: " << errno;
+  }
+  server_->AddSocket(this);
+  return true;
+}
+
+int IoUringUdpSocket::Send(const void* pv, size_t cb) {
+  const rtc::ArrayView<const uint8_t> packet(static_cast<const uint8_t*>(pv),
+                                             cb);
+  return SubmitSends(rtc::MakeArrayView(&packet, 1), {}, nullptr, 0) == 1
+             ? static_cast<int>(cb)
+             : SOCKET_ERROR;
+}
+
+int IoUringUdpSocket::SendTo(const void* buffer,
+                             size_t length,
+                             const SocketAddress& addr) {
+  sockaddr_storage saddr;
+  socklen_t saddr_len = static_cast<socklen_t>(addr.ToSockAddrStorage(&saddr));
+  const rtc::ArrayView<const uint8_t> packet(
+      static_cast<const uint8_t*>(buffer), length);
+  return SubmitSends(rtc::MakeArrayView(&packet, 1), {}, &saddr,
+                     saddr_len) == 1
+             ? static_cast<int>(length)
+             : SOCKET_ERROR;
+}
+
+int IoUringUdpSocket::SendToBatch(
+    rtc::ArrayView<const rtc::ArrayView<const uint8_t>> packets,
+    const SocketAddress& addr,
+    rtc::ArrayView<const EcnMarking> ecn_markings) {
+  if (packets.empty()) {
+    return 0;
+  }
+  sockaddr_storage saddr;
+  socklen_t saddr_len = static_cast<socklen_t>(addr.ToSockAddrStorage(&saddr));
+  const int submitted = SubmitSends(packets, ecn_markings, &saddr, saddr_len);
+  return submitted > 0 ? submitted : SOCKET_ERROR;
+}
+
+int IoUringUdpSocket::SubmitSends(
+    rtc::ArrayView<const rtc::ArrayView<const uint8_t>> packets,
+    rtc::ArrayView<const EcnMarking> ecn_markings,
+    const sockaddr_storage* addr,
+    socklen_t addr_len) {
+  if (s_ == INVALID_SOCKET) {
+    SetError(EBADF);
+    return 0;
+  }
+  const size_t submitted =
+      server_->SubmitSends(this, packets, ecn_markings, addr, addr_len);
+  if (submitted < packets.size()) {
+    SetError(EWOULDBLOCK);
+    EnableEvents(DE_WRITE);
+    server_->WaitForSendSlot(this);
+  }
+  return static_cast<int>(submitted);
+}
+
+int IoUringUdpSocket::Recv(void* buffer, size_t length, int64_t* timestamp) {
+  return RecvFrom(buffer, length, /*out_addr=*/nullptr, timestamp);
+}
+
+int IoUringUdpSocket::RecvFrom(void* buffer,
+                               size_t length,
+                               SocketAddress* out_addr,
+                               int64_t* timestamp) {
+  if (received_.empty()) {
+    return WouldBlock();
+  }
+  const ReceivedDatagram datagram = received_.front();
+  received_.pop_front();
+  const size_t size = std::min(datagram.size, length);
+  memcpy(buffer, datagram.payload, size);
+  if (out_addr) {
+    *out_addr = datagram.source_address;
+  }
+  if (timestamp) {
+    *timestamp = datagram.timestamp;
+  }
+  server_->ReturnBuffer(datagram.buffer_id);
+  EnableEvents(DE_READ);
+  return static_cast<int>(size);
+}
+
+int IoUringUdpSocket::RecvFrom(ReceiveBuffer& buffer) {
+  if (received_.empty()) {
+    return WouldBlock();
+  }
+  buffer.payload.EnsureCapacity(received_.front().size);
+  const int received = PopDatagram(buffer);
+  EnableEvents(DE_READ);
+  return received;
+}
+
+int IoUringUdpSocket::RecvFromBatch(rtc::ArrayView<ReceiveBuffer> buffers) {
+  RTC_DCHECK(!buffers.empty());
+  if (received_.empty()) {
+    return WouldBlock();
+  }
+  size_t count = 0;
+  while (count < buffers.size() && !received_.empty()) {
+    ReceiveBuffer& buffer = buffers[count++];
+    if (received_.front().size > buffer.payload.capacity()) {
+      // Any remote sender can cause this, so it is logged rarely.
+      if (num_truncated_datagrams_++ % 1000 == 0) {
+        RTC_LOG(LS_WARNING) << "Dropped " << num_truncated_datagrams_
+                            << " datagrams larger than "
+                            << buffer.payload.capacity() << " bytes";
+      }
+      server_->ReturnBuffer(received_.front().buffer_id);
+      received_.pop_front();
+      buffer.payload.SetSize(0);
+      continue;
+    }
+    PopDatagram(buffer);
+  }
+  EnableEvents(DE_READ);
+  return static_cast<int>(count);
+}
+
+int IoUringUdpSocket::Close() {
+  if (s_ == INVALID_SOCKET) {
+    return 0;
+  }
+  server_->RemoveSocket(this);
+  return PhysicalSocket::Close();
+}
+
+void IoUringUdpSocket::EnableEvents(uint8_t events) {
+  PhysicalSocket::EnableEvents(events);
+  if ((events & DE_READ) && !received_.empty()) {
+    server_->MarkReadable(this);
+  }
+}
+
+bool IoUringUdpSocket::OnDatagramReceived(uint16_t buffer_id,
+                                          const uint8_t* data,
+                                          size_t size,
+                                          const msghdr& layout) {
+  const uint8_t* name = data + sizeof(io_uring_recvmsg_out);
+  const uint8_t* control = name + layout.msg_namelen;
+  const uint8_t* payload = control + layout.msg_controllen;
+  if (size < static_cast<size_t>(payload - data)) {
+    return false;
+  }
+  io_uring_recvmsg_out out;
+  memcpy(&out, data, sizeof(out));
+  if (out.flags & MSG_TRUNC) {
+    // Only possible for datagrams larger than IP allows.
+    RTC_LOG(LS_WARNING) << "Dropping datagram larger than "
+                        << kMaxReceivePayloadSize << " bytes";
+    return false;
+  }
+
+  ReceivedDatagram datagram = {.buffer_id = buffer_id,
+                               .payload = payload,
+                               .size = out.payloadlen,
+                               .timestamp = -1,
+                               .ecn = EcnMarking::kNotEct};
+  sockaddr_storage addr = {};
+  memcpy(&addr, name, std::min<size_t>(out.namelen, sizeof(addr)));
+  SocketAddressFromSockAddrStorage(addr, &datagram.source_address);
+  msghdr msg = {.msg_control = const_cast<uint8_t*>(control),
+                .msg_controllen = out.controllen};
+  ParseControlMessages(msg, &datagram.timestamp, &datagram.ecn);
+  received_.push_back(std::move(datagram));
+  return true;
+}
+
+int IoUringUdpSocket::PopDatagram(ReceiveBuffer& buffer) {
+  const ReceivedDatagram datagram = std::move(received_.front());
+  received_.pop_front();
+  RTC_DCHECK_GE(buffer.payload.capacity(), datagram.size);
+  buffer.payload.SetData(datagram.payload, datagram.size);
+  buffer.source_address = datagram.source_address;
+  buffer.arrival_time = absl::nullopt;
+  if (datagram.timestamp != -1) {
+    buffer.arrival_time = webrtc::Timestamp::Micros(datagram.timestamp);
+  }
+  buffer.ecn = (ecn_ || recv_ecn_) ? datagram.ecn : EcnMarking::kNotEct;
+  server_->ReturnBuffer(datagram.buffer_id);
+  return static_cast<int>(datagram.size);
+}
+
+int IoUringUdpSocket::WouldBlock() {
+  SetError(EWOULDBLOCK);
+  EnableEvents(DE_READ);
+  return SOCKET_ERROR;
+}
+
+}  // namespace rtc
@@ -0,0 +1,240 @@
+/*
+ *  Copyright 2024 The WebRTC Project Authors. All rights reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef RTC_BASE_IO_URING_SOCKET_SERVER_H_
+#define RTC_BASE_IO_URING_SOCKET_SERVER_H_
+
+#if !defined(WEBRTC_LINUX)
+#error "IoUringSocketServer is only available on Linux."
+#endif
+
+#include <linux/io_uring.h>
+#include <sys/socket.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+#include "api/array_view.h"
+#include "api/units/time_delta.h"
+#include "rtc_base/buffer.h"
+#include "rtc_base/physical_socket_server.h"
+#include "rtc_base/system/rtc_export.h"
+
+namespace rtc {
+
+class IoUringUdpSocket;
+
+// A socket server that uses io_uring for UDP sockets. Each UDP socket keeps a
+// multishot receive posted, which lets the kernel write datagrams into a ring
+// of provided buffers shared by all sockets without a recvfrom() call per
+// datagram. Reading a datagram copies it from there into the buffer of the
+// reader. Sends are submitted without waiting for their completion. All other
+// sockets are handled by the PhysicalSocketServer base class, which also waits
+// on the io_uring completion queue, so both kinds can be mixed on one thread.
+//
+// Requires Linux 6.0 or later. To use it on a network thread:
+//
+//   std::unique_ptr<rtc::SocketServer> ss = rtc::IoUringSocketServer::Create();
+//   if (!ss) {
+//     ss = rtc::CreateDefaultSocketServer();
+//   }
+//   auto network_thread = std::make_unique<rtc::Thread>(std::move(ss));
+//
+// Sockets created by this class must only be used on the thread that waits on
+// the socket server.
+class RTC_EXPORT IoUringSocketServer : public PhysicalSocketServer {
+ public:
+  // Returns null if the running kernel lacks the required io_uring features.
+  static std::unique_ptr<IoUringSocketServer> Create();
+
+  ~IoUringSocketServer() override;
+
+  // SocketFactory:
+  Socket* CreateSocket(int family, int type) override;
+
+  // SocketServer:
+  bool Wait(webrtc::TimeDelta max_wait_duration, bool process_io) override;
+
+ private:
+  friend class IoUringUdpSocket;
+  class CompletionDispatcher;
+
+  // State of a send that has been submitted but not yet completed. Owned by
+  // the socket server so that it outlives the socket that submitted it.
+  struct SendSlot {
+    msghdr msg;
+    iovec iov;
+    sockaddr_storage addr;
+    alignas(cmsghdr) char control[CMSG_SPACE(sizeof(int))];
+    Buffer payload;
+    uint64_t socket_key;
+  };
+
+  IoUringSocketServer();
+
+  bool Initialize();
+  bool SupportsMultishotReceive();
+
+  // Registers `socket` and posts a multishot receive for it.
+  void AddSocket(IoUringUdpSocket* socket);
+  // Cancels the receive posted for `socket` and forgets about it.
+  void RemoveSocket(IoUringUdpSocket* socket);
+
+  // Queues a send of `packets` to `addr`, or on the connected socket if `addr`
+  // is null, with the markings in `ecn_markings` unless it is empty. Returns
+  // the number of packets queued, which is less than the number requested if
+  // there are not enough free send slots.
+  size_t SubmitSends(
+      IoUringUdpSocket* socket,
+      rtc::ArrayView<const rtc::ArrayView<const uint8_t>> packets,
+      rtc::ArrayView<const EcnMarking> ecn_markings,
+      const sockaddr_storage* addr,
+      socklen_t addr_len);
+  // Signals write events to `socket` once a send slot becomes available.
+  void WaitForSendSlot(IoUringUdpSocket* socket);
+  // Arranges for a read event to be signaled to `socket`.
+  void MarkReadable(IoUringUdpSocket* socket);
+  // Hands a buffer that was filled by a receive back to the kernel.
+  void ReturnBuffer(uint16_t buffer_id);
+  void ProvideBuffer(uint16_t buffer_id);
+  uint8_t* GetBuffer(uint16_t buffer_id);
+
+  // Returns the next free submission queue entry, or null if the queue is
+  // full. Entries are handed to the kernel by Submit().
+  io_uring_sqe* GetSqe();
+  void Submit();
+  void PostReceive(uint64_t key, int fd);
+  void CancelReceive(uint64_t key);
+
+  void ProcessCompletions();
+  void OnReceiveCompletion(uint64_t key, const io_uring_cqe& cqe);
+  void OnSendCompletion(uint32_t slot, int result);
+  void SignalReadEvents();
+  void SignalWriteEvents();
+
+  int ring_fd_ = -1;
+
+  // Submission and completion queues shared with the kernel.
+  void* rings_ = nullptr;
+  size_t rings_size_ = 0;
+  io_uring_sqe* sqes_ = nullptr;
+  size_t sqes_size_ = 0;
+  unsigned sq_entries_ = 0;
+  unsigned* sq_head_ = nullptr;
+  unsigned* sq_tail_ = nullptr;
+  unsigned* sq_flags_ = nullptr;
+  unsigned sq_mask_ = 0;
+  unsigned* sq_array_ = nullptr;
+  // Tail of the entries handed out by GetSqe(), published by Submit().
+  unsigned sqe_tail_ = 0;
+  unsigned* cq_head_ = nullptr;
+  unsigned* cq_tail_ = nullptr;
+  unsigned cq_mask_ = 0;
+  io_uring_cqe* cqes_ = nullptr;
+  unsigned pending_submissions_ = 0;
+
+  // Provided buffer ring the kernel selects receive buffers from. Not typed
+  // as io_uring_buf_ring, whose flexible array member is laid out
+  // differently when compiled as C++.
+  io_uring_buf* buffer_ring_ = nullptr;
+  size_t buffer_ring_size_ = 0;
+  uint8_t* buffers_ = nullptr;
+  uint16_t buffer_ring_tail_ = 0;
+  size_t buffers_in_use_ = 0;
+  // Describes the layout of each provided buffer to multishot receives.
+  msghdr receive_msg_ = {};
+
+  std::vector<SendSlot> send_slots_;
+  std::vector<uint32_t> free_send_slots_;
+
+  uint64_t next_socket_key_ = 0;
+  std::unordered_map<uint64_t, IoUringUdpSocket*> sockets_;
+  // Sockets with queued datagrams that should be signaled.
+  std::deque<uint64_t> readable_sockets_;
+  // Sockets waiting for a free send slot.
+  std::vector<uint64_t> blocked_writers_;
+  // Sockets whose receive stopped because the buffer ring was exhausted.
+  std::vector<uint64_t> starved_sockets_;
+
+  std::unique_ptr<CompletionDispatcher> completion_dispatcher_;
+};
+
+// A UDP socket whose I/O is performed through an IoUringSocketServer.
+class IoUringUdpSocket : public PhysicalSocket {
+ public:
+  explicit IoUringUdpSocket(IoUringSocketServer* ss);
+  ~IoUringUdpSocket() override;
+
+  bool Create(int family, int type) override;
+
+  int Send(const void* pv, size_t cb) override;
+  int SendTo(const void* buffer,
+             size_t length,
+             const SocketAddress& addr) override;
+  int SendToBatch(rtc::ArrayView<const rtc::ArrayView<const uint8_t>> packets,
+                  const SocketAddress& addr,
+                  rtc::ArrayView<const EcnMarking> ecn_markings) override;
+
+  int Recv(void* buffer, size_t length, int64_t* timestamp) override;
+  int RecvFrom(void* buffer,
+               size_t length,
+               SocketAddress* out_addr,
+               int64_t* timestamp) override;
+  int RecvFrom(ReceiveBuffer& buffer) override;
+  int RecvFromBatch(rtc::ArrayView<ReceiveBuffer> buffers) override;
+
+  int Close() override;
+
+ protected:
+  void EnableEvents(uint8_t events) override;
+
+ private:
+  friend class IoUringSocketServer;
+
+  // A datagram written into a provided buffer by the kernel, waiting to be
+  // read by the application.
+  struct ReceivedDatagram {
+    uint16_t buffer_id;
+    const uint8_t* payload;
+    size_t size;
+    SocketAddress source_address;
+    int64_t timestamp;
+    EcnMarking ecn;
+  };
+
+  // Returns the number of `packets` submitted.
+  int SubmitSends(rtc::ArrayView<const rtc::ArrayView<const uint8_t>> packets,
+                  rtc::ArrayView<const EcnMarking> ecn_markings,
+                  const sockaddr_storage* addr,
+                  socklen_t addr_len);
+  // Queues the datagram in a receive buffer laid out as described by
+  // `layout`. Returns false if the datagram is dropped.
+  bool OnDatagramReceived(uint16_t buffer_id,
+                          const uint8_t* data,
+                          size_t size,
+                          const msghdr& layout);
+  // Moves the oldest received datagram into `buffer`, which must be large
+  // enough, and releases its receive buffer.
+  int PopDatagram(ReceiveBuffer& buffer);
+  int WouldBlock();
+
+  IoUringSocketServer* const server_;
+  uint64_t key_ = 0;
+  bool queued_as_readable_ = false;
+  std::deque<ReceivedDatagram> received_;
+};
+
+}  // namespace rtc
+
+#endif  // RTC_BASE_IO_URING_SOCKET_SERVER_H_
@@ -0,0 +1,244 @@
+/*
+ *  Copyright 2024 The WebRTC Project Authors. All rights reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "rtc_base/io_uring_socket_server.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "rtc_base/gunit.h"
+#include "rtc_base/logging.h"
+#include "rtc_base/net_test_helpers.h"
+#include "rtc_base/network/ecn_marking.h"
+#include "rtc_base/socket_unittest.h"
+#include "rtc_base/thread.h"
+#include "test/gtest.h"
+
+namespace rtc {
+
+#define MAYBE_SKIP_IPV4                        \
+  if (!HasIPv4Enabled()) {                     \
+    RTC_LOG(LS_INFO) << "No IPv4... skipping"; \
+    return;                                    \
+  }
+
+#define MAYBE_SKIP_IPV6                        \
+  if (!HasIPv6Enabled()) {                     \
+    RTC_LOG(LS_INFO) << "No IPv6... skipping"; \
+    return;                                    \
+  }
+
+class IoUringSocketServerTest : public SocketTest {
+ protected:
+  IoUringSocketServerTest()
+      : IoUringSocketServerTest(IoUringSocketServer::Create()) {}
+  explicit IoUringSocketServerTest(std::unique_ptr<IoUringSocketServer> server)
+      : SocketTest(server.get()), server_(std::move(server)) {}
+
+  void SetUp() override {
+    if (!server_) {
+      GTEST_SKIP() << "io_uring is not supported by this kernel.";
+    }
+    thread_ = std::make_unique<AutoSocketServerThread>(server_.get());
+  }
+
+  // Reads datagrams from `socket` until `count` have been received or the
+  // wait times out.
+  std::vector<std::string> Receive(Socket* socket, size_t count) {
+    std::vector<std::string> received;
+    Buffer buffer;
+    while (received.size() < count) {
+      Socket::ReceiveBuffer receive_buffer(buffer);
+      int result = -1;
+      WAIT((result = socket->RecvFrom(receive_buffer)) >= 0, kTimeout);
+      if (result < 0) {
+        break;
+      }
+      received.emplace_back(buffer.data<char>(), buffer.size());
+    }
+    return received;
+  }
+
+  std::unique_ptr<IoUringSocketServer> server_;
+  std::unique_ptr<AutoSocketServerThread> thread_;
+};
+
+TEST_F(IoUringSocketServerTest, TestConnectIPv4) {
+  MAYBE_SKIP_IPV4;
+  SocketTest::TestConnectIPv4();
+}
+
+TEST_F(IoUringSocketServerTest, TestTcpIPv4) {
+  MAYBE_SKIP_IPV4;
+  SocketTest::TestTcpIPv4();
+}
+
+TEST_F(IoUringSocketServerTest, TestUdpIPv4) {
+  MAYBE_SKIP_IPV4;
+  SocketTest::TestUdpIPv4();
+}
+
+TEST_F(IoUringSocketServerTest, TestUdpIPv6) {
+  MAYBE_SKIP_IPV6;
+  SocketTest::TestUdpIPv6();
+}
+
+TEST_F(IoUringSocketServerTest, TestUdpReadyToSendIPv4) {
+  MAYBE_SKIP_IPV4;
+  SocketTest::TestUdpReadyToSendIPv4();
+}
+
+TEST_F(IoUringSocketServerTest, TestGetSetOptionsIPv4) {
+  MAYBE_SKIP_IPV4;
+  SocketTest::TestGetSetOptionsIPv4();
+}
+
+TEST_F(IoUringSocketServerTest, TestSocketRecvTimestampIPv4) {
+  MAYBE_SKIP_IPV4;
+  SocketTest::TestSocketRecvTimestampIPv4();
+}
+
+TEST_F(IoUringSocketServerTest, TestUdpSocketRecvTimestampUseRtcEpochIPv4) {
+  MAYBE_SKIP_IPV4;
+  SocketTest::TestUdpSocketRecvTimestampUseRtcEpochIPv4();
+}
+
+TEST_F(IoUringSocketServerTest, TestSocketSendRecvWithEcnIPV4) {
+  MAYBE_SKIP_IPV4;
+  SocketTest::TestSocketSendRecvWithEcnIPV4();
+}
+
+TEST_F(IoUringSocketServerTest, SendToBatchAndRecvFromBatch) {
+  MAYBE_SKIP_IPV4;
+  std::unique_ptr<Socket> receiver(server_->CreateSocket(AF_INET, SOCK_DGRAM));
+  ASSERT_EQ(0, receiver->Bind(SocketAddress(kIPv4Loopback, 0)));
+  std::unique_ptr<Socket> sender(server_->CreateSocket(AF_INET, SOCK_DGRAM));
+
+  const std::vector<std::string> payloads = {"a", "bb", "ccc"};
+  std::vector<rtc::ArrayView<const uint8_t>> packets;
+  for (const std::string& payload : payloads) {
+    packets.emplace_back(reinterpret_cast<const uint8_t*>(payload.data()),
+                         payload.size());
+  }
+  EXPECT_EQ(sender->SendToBatch(packets, receiver->GetLocalAddress(),
+                                /*ecn_markings=*/{}),
+            3);
+
+  std::vector<Buffer> buffers(4);
+  std::vector<Socket::ReceiveBuffer> receive_buffers;
+  receive_buffers.reserve(buffers.size());
+  for (Buffer& buffer : buffers) {
+    buffer.EnsureCapacity(16);
+    receive_buffers.emplace_back(buffer);
+  }
+  rtc::ArrayView<Socket::ReceiveBuffer> pending(receive_buffers);
+  int received = 0;
+  while (received < 3) {
+    int result = -1;
+    ASSERT_TRUE_WAIT(
+        (result = receiver->RecvFromBatch(pending.subview(received))) > 0,
+        kTimeout);
+    received += result;
+  }
+  EXPECT_EQ(received, 3);
+  for (size_t i = 0; i < payloads.size(); ++i) {
+    EXPECT_EQ(std::string(buffers[i].data<char>(), buffers[i].size()),
+              payloads[i]);
+    EXPECT_EQ(receive_buffers[i].source_address.port(),
+              sender->GetLocalAddress().port());
+  }
+}
+
+TEST_F(IoUringSocketServerTest, ReceivesEcnOfEachDatagram) {
+  MAYBE_SKIP_IPV4;
+  std::unique_ptr<Socket> receiver(server_->CreateSocket(AF_INET, SOCK_DGRAM));
+  ASSERT_EQ(0, receiver->Bind(SocketAddress(kIPv4Loopback, 0)));
+  receiver->SetOption(Socket::OPT_RECV_ECN, 1);
+  std::unique_ptr<Socket> sender(server_->CreateSocket(AF_INET, SOCK_DGRAM));
+
+  const std::string payload = "a";
+  const std::vector<rtc::ArrayView<const uint8_t>> packets(
+      3, rtc::ArrayView<const uint8_t>(
+             reinterpret_cast<const uint8_t*>(payload.data()),
+             payload.size()));
+  const std::vector<EcnMarking> ecn_markings = {
+      EcnMarking::kEct1, EcnMarking::kNotEct, EcnMarking::kEct1};
+  EXPECT_EQ(
+      sender->SendToBatch(packets, receiver->GetLocalAddress(), ecn_markings),
+      3);
+
+  Buffer buffer;
+  for (EcnMarking ecn : ecn_markings) {
+    Socket::ReceiveBuffer receive_buffer(buffer);
+    EXPECT_TRUE_WAIT(receiver->RecvFrom(receive_buffer) > 0, kTimeout);
+    EXPECT_EQ(receive_buffer.ecn, ecn);
+  }
+}
+
+TEST_F(IoUringSocketServerTest, ReceiveBuffersAreRecycled) {
+  MAYBE_SKIP_IPV4;
+  std::unique_ptr<Socket> receiver(server_->CreateSocket(AF_INET, SOCK_DGRAM));
+  ASSERT_EQ(0, receiver->Bind(SocketAddress(kIPv4Loopback, 0)));
+  std::unique_ptr<Socket> sender(server_->CreateSocket(AF_INET, SOCK_DGRAM));
+
+  // Receives many more datagrams than there are provided buffers.
+  constexpr int kRounds = 40;
+  constexpr int kDatagramsPerRound = 50;
+  for (int round = 0; round < kRounds; ++round) {
+    for (int i = 0; i < kDatagramsPerRound; ++i) {
+      const std::string payload = std::to_string(round * 1000 + i);
+      ASSERT_EQ(sender->SendTo(payload.data(), payload.size(),
+                               receiver->GetLocalAddress()),
+                static_cast<int>(payload.size()));
+    }
+    std::vector<std::string> received =
+        Receive(receiver.get(), kDatagramsPerRound);
+    ASSERT_EQ(received.size(), static_cast<size_t>(kDatagramsPerRound));
+    EXPECT_EQ(received.front(), std::to_string(round * 1000));
+  }
+}
+
+TEST_F(IoUringSocketServerTest, ClosingSocketReleasesQueuedDatagrams) {
+  MAYBE_SKIP_IPV4;
+  std::unique_ptr<Socket> sender(server_->CreateSocket(AF_INET, SOCK_DGRAM));
+  // Leave more datagrams unread in closed sockets than there are buffers.
+  for (int i = 0; i < 20; ++i) {
+    std::unique_ptr<Socket> receiver(
+        server_->CreateSocket(AF_INET, SOCK_DGRAM));
+    ASSERT_EQ(0, receiver->Bind(SocketAddress(kIPv4Loopback, 0)));
+    for (int j = 0; j < 50; ++j) {
+      sender->SendTo("x", 1, receiver->GetLocalAddress());
+    }
+    ASSERT_EQ(Receive(receiver.get(), 1).size(), 1u);
+  }
+
+  std::unique_ptr<Socket> receiver(server_->CreateSocket(AF_INET, SOCK_DGRAM));
+  ASSERT_EQ(0, receiver->Bind(SocketAddress(kIPv4Loopback, 0)));
+  EXPECT_EQ(sender->SendTo("y", 1, receiver->GetLocalAddress()), 1);
+  EXPECT_EQ(Receive(receiver.get(), 1), std::vector<std::string>({"y"}));
+}
+
+TEST_F(IoUringSocketServerTest, ReceivesDatagramsOfAnySize) {
+  MAYBE_SKIP_IPV4;
+  std::unique_ptr<Socket> receiver(server_->CreateSocket(AF_INET, SOCK_DGRAM));
+  ASSERT_EQ(0, receiver->Bind(SocketAddress(kIPv4Loopback, 0)));
+  std::unique_ptr<Socket> sender(server_->CreateSocket(AF_INET, SOCK_DGRAM));
+
+  // Close to the largest UDP payload over IPv4.
+  const std::string large(65000, 'l');
+  EXPECT_EQ(sender->SendTo(large.data(), large.size(),
+                           receiver->GetLocalAddress()),
+            static_cast<int>(large.size()));
+  EXPECT_EQ(sender->SendTo("s", 1, receiver->GetLocalAddress()), 1);
+  EXPECT_EQ(Receive(receiver.get(), 2), std::vector<std::string>({large, "s"}));
+}
+
+}  // namespace rtc
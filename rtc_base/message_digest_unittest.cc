@@ -11,6 +11,7 @@
 #include "rtc_base/message_digest.h"
 
 #include "absl/strings/string_view.h"
+#include "rtc_base/openssl_digest.h"
 #include "rtc_base/string_encode.h"
 #include "test/gtest.h"
 
@@ -147,6 +148,35 @@ TEST(MessageDigestTest, TestSha1Hmac) {
                         input.size(), output, sizeof(output) - 1));
 }
 
+// RFC 2202 vectors, including a key larger than a block, with the input split
+// at every position.
+TEST(MessageDigestTest, TestPrecomputedSha1Hmac) {
+  const struct {
+    std::string key;
+    std::string input;
+    std::string hmac;
+  } kVectors[] = {
+      {std::string(20, '\x0b'), "Hi There",
+       "b617318655057264e28bc0b6fb378c8ef146be00"},
+      {"Jefe", "what do ya want for nothing?",
+       "effcdf6ae5eb2fa2d27416d5f184df9c259a7c79"},
+      {std::string(80, '\xaa'),
+       "Test Using Larger Than Block-Size Key and Larger "
+       "Than One Block-Size Data",
+       "e8e99d0f45237d786d6bbaa7965c7808bbff1a91"},
+  };
+  for (const auto& vector : kVectors) {
+    OpenSSLHmacSha1 hmac(vector.key);
+    for (size_t split = 0; split <= vector.input.size(); ++split) {
+      char output[OpenSSLHmacSha1::kSize];
+      hmac.Compute(vector.input.data(), split, vector.input.data() + split,
+                   vector.input.size() - split, output);
+      EXPECT_EQ(vector.hmac,
+                hex_encode(absl::string_view(output, sizeof(output))));
+    }
+  }
+}
+
 TEST(MessageDigestTest, TestBadHmac) {
   std::string output;
   EXPECT_FALSE(ComputeHmac("sha-9000", "key", "abc", &output));
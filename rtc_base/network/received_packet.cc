@@ -30,8 +30,18 @@ ReceivedPacket::ReceivedPacket(rtc::ArrayView<const uint8_t> payload,
 
 ReceivedPacket ReceivedPacket::CopyAndSet(
     DecryptionInfo decryption_info) const {
-  return ReceivedPacket(payload_, source_address_, arrival_time_, ecn_,
+  ReceivedPacket packet(payload_, source_address_, arrival_time_, ecn_,
                         decryption_info);
+  packet.payload_buffer_ = payload_buffer_;
+  return packet;
+}
+
+CopyOnWriteBuffer ReceivedPacket::SharePayload() const {
+  if (payload_buffer_ && payload_buffer_->cdata() == payload_.data() &&
+      payload_buffer_->size() == payload_.size()) {
+    return *payload_buffer_;
+  }
+  return CopyOnWriteBuffer(payload_.data(), payload_.size());
 }
 
 // static
@@ -15,6 +15,7 @@
 #include "absl/types/optional.h"
 #include "api/array_view.h"
 #include "api/units/timestamp.h"
+#include "rtc_base/copy_on_write_buffer.h"
 #include "rtc_base/network/ecn_marking.h"
 #include "rtc_base/socket_address.h"
 #include "rtc_base/system/rtc_export.h"
@@ -59,6 +60,19 @@ class RTC_EXPORT ReceivedPacket {
 
   const DecryptionInfo& decryption_info() const { return decryption_info_; }
 
+  // Attaches the buffer holding exactly the payload, which lets consumers
+  // share the payload with SharePayload() instead of copying it. `buffer`
+  // must outlive this packet and the packets copied from it.
+  void set_payload_buffer(CopyOnWriteBuffer* buffer) {
+    payload_buffer_ = buffer;
+  }
+
+  // Returns the payload in a CopyOnWriteBuffer. If a payload buffer is
+  // attached, the returned buffer shares it, so the payload is not copied
+  // unless it is modified while the attached buffer is alive. The packet is
+  // left intact for the other receivers it is passed to.
+  CopyOnWriteBuffer SharePayload() const;
+
   static ReceivedPacket CreateFromLegacy(
       const char* data,
       size_t size,
@@ -80,6 +94,7 @@ class RTC_EXPORT ReceivedPacket {
   const SocketAddress& source_address_;
   EcnMarking ecn_;
   DecryptionInfo decryption_info_;
+  CopyOnWriteBuffer* payload_buffer_ = nullptr;
 };
 
 }  // namespace rtc
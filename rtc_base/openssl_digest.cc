@@ -10,11 +10,17 @@
 
 #include "rtc_base/openssl_digest.h"
 
+#include <openssl/crypto.h>
+#include <string.h>
+
 #include "absl/strings/string_view.h"
 #include "rtc_base/checks.h"  // RTC_DCHECK, RTC_CHECK
 #include "rtc_base/openssl.h"
 
 namespace rtc {
+namespace {
+constexpr size_t kSha1BlockSize = 64;
+}  // namespace
 
 OpenSSLDigest::OpenSSLDigest(absl::string_view algorithm) {
   ctx_ = EVP_MD_CTX_new();
@@ -115,4 +121,54 @@ bool OpenSSLDigest::GetDigestSize(absl::string_view algorithm, size_t* length) {
   return true;
 }
 
+OpenSSLHmacSha1::OpenSSLHmacSha1(absl::string_view key)
+    : inner_(EVP_MD_CTX_new()),
+      outer_(EVP_MD_CTX_new()),
+      ctx_(EVP_MD_CTX_new()) {
+  RTC_CHECK(inner_ && outer_ && ctx_);
+  const EVP_MD* md = EVP_sha1();
+  // The padded key, as in RFC 2104. Keys longer than a block are hashed.
+  uint8_t block[kSha1BlockSize] = {};
+  if (key.size() > sizeof(block)) {
+    RTC_CHECK(EVP_Digest(key.data(), key.size(), block, nullptr, md, nullptr));
+  } else {
+    memcpy(block, key.data(), key.size());
+  }
+  uint8_t pad[kSha1BlockSize];
+  for (size_t i = 0; i < sizeof(block); ++i) {
+    pad[i] = block[i] ^ 0x36;
+  }
+  EVP_DigestInit_ex(inner_, md, nullptr);
+  EVP_DigestUpdate(inner_, pad, sizeof(pad));
+  for (size_t i = 0; i < sizeof(block); ++i) {
+    pad[i] = block[i] ^ 0x5c;
+  }
+  EVP_DigestInit_ex(outer_, md, nullptr);
+  EVP_DigestUpdate(outer_, pad, sizeof(pad));
+  OPENSSL_cleanse(block, sizeof(block));
+  OPENSSL_cleanse(pad, sizeof(pad));
+}
+
+OpenSSLHmacSha1::~OpenSSLHmacSha1() {
+  EVP_MD_CTX_free(ctx_);
+  EVP_MD_CTX_free(outer_);
+  EVP_MD_CTX_free(inner_);
+}
+
+void OpenSSLHmacSha1::Compute(const void* data1,
+                              size_t len1,
+                              const void* data2,
+                              size_t len2,
+                              void* mac) const {
+  RTC_DCHECK_RUN_ON(&sequence_checker_);
+  uint8_t* out = static_cast<uint8_t*>(mac);
+  EVP_MD_CTX_copy_ex(ctx_, inner_);
+  EVP_DigestUpdate(ctx_, data1, len1);
+  EVP_DigestUpdate(ctx_, data2, len2);
+  EVP_DigestFinal_ex(ctx_, out, nullptr);
+  EVP_MD_CTX_copy_ex(ctx_, outer_);
+  EVP_DigestUpdate(ctx_, out, kSize);
+  EVP_DigestFinal_ex(ctx_, out, nullptr);
+}
+
 }  // namespace rtc
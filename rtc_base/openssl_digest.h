@@ -17,7 +17,10 @@
 #include <string>
 
 #include "absl/strings/string_view.h"
+#include "api/sequence_checker.h"
 #include "rtc_base/message_digest.h"
+#include "rtc_base/system/no_unique_address.h"
+#include "rtc_base/thread_annotations.h"
 
 namespace rtc {
 
@@ -46,6 +49,40 @@ class OpenSSLDigest final : public MessageDigest {
   const EVP_MD* md_;
 };
 
+// HMAC-SHA1 for many messages authenticated with the same key. The padded
+// key is hashed into the inner and outer SHA-1 states once, here, instead of
+// for every message as ComputeHmac() does, and computing a MAC does not
+// allocate. Compute() leaves the key states alone, so it is const, but it
+// reuses one digest context: an object must be used on a single sequence.
+class OpenSSLHmacSha1 final {
+ public:
+  static constexpr size_t kSize = 20;
+
+  explicit OpenSSLHmacSha1(absl::string_view key);
+  ~OpenSSLHmacSha1();
+
+  OpenSSLHmacSha1(const OpenSSLHmacSha1&) = delete;
+  OpenSSLHmacSha1& operator=(const OpenSSLHmacSha1&) = delete;
+
+  // Writes the MAC of `data1` followed by `data2` to `mac`, which must hold
+  // kSize bytes. Taking the input in two parts lets callers authenticate a
+  // modified copy of a header together with the unmodified rest of a buffer.
+  void Compute(const void* data1,
+               size_t len1,
+               const void* data2,
+               size_t len2,
+               void* mac) const;
+
+ private:
+  RTC_NO_UNIQUE_ADDRESS webrtc::SequenceChecker sequence_checker_{
+      webrtc::SequenceChecker::kDetached};
+  EVP_MD_CTX* const inner_;
+  EVP_MD_CTX* const outer_;
+  // Copy of `inner_` or `outer_` that a MAC is computed in. Written by the
+  // const Compute().
+  mutable EVP_MD_CTX* ctx_ RTC_GUARDED_BY(sequence_checker_);
+};
+
 }  // namespace rtc
 
 #endif  // RTC_BASE_OPENSSL_DIGEST_H_
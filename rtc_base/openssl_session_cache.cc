@@ -10,6 +10,8 @@
 
 #include "rtc_base/openssl_session_cache.h"
 
+#include <openssl/rand.h>
+
 #include "absl/strings/string_view.h"
 #include "rtc_base/checks.h"
 #include "rtc_base/openssl.h"
@@ -51,4 +53,61 @@ SSLMode OpenSSLSessionCache::GetSSLMode() const {
   return ssl_mode_;
 }
 
+OpenSSLDtlsSessionCache::OpenSSLDtlsSessionCache() {
+  RTC_CHECK_EQ(RAND_bytes(ticket_keys_, sizeof(ticket_keys_)), 1);
+}
+
+OpenSSLDtlsSessionCache::~OpenSSLDtlsSessionCache() {
+  for (const auto& it : sessions_) {
+    SSL_SESSION_free(it.second);
+  }
+}
+
+SSL_SESSION* OpenSSLDtlsSessionCache::LookupSession(
+    absl::string_view key) const {
+  webrtc::MutexLock lock(&mutex_);
+  auto it = sessions_.find(key);
+  if (it == sessions_.end()) {
+    return nullptr;
+  }
+  SSL_SESSION_up_ref(it->second);
+  return it->second;
+}
+
+void OpenSSLDtlsSessionCache::AddSession(absl::string_view key,
+                                         SSL_SESSION* session) {
+  SSL_SESSION_up_ref(session);
+  webrtc::MutexLock lock(&mutex_);
+  auto [it, inserted] = sessions_.emplace(std::string(key), session);
+  if (!inserted) {
+    SSL_SESSION_free(it->second);
+    it->second = session;
+    return;
+  }
+  keys_.push_back(it->first);
+  if (keys_.size() > kMaxSessions) {
+    auto oldest = sessions_.find(keys_.front());
+    SSL_SESSION_free(oldest->second);
+    sessions_.erase(oldest);
+    keys_.pop_front();
+  }
+}
+
+size_t OpenSSLDtlsSessionCache::size() const {
+  webrtc::MutexLock lock(&mutex_);
+  return sessions_.size();
+}
+
+bool OpenSSLDtlsSessionCache::ConfigureTicketKeys(SSL_CTX* ssl_ctx) const {
+  // The length of the key differs between BoringSSL and OpenSSL, and is
+  // returned when passing no buffer.
+  long length = SSL_CTX_get_tlsext_ticket_keys(ssl_ctx, nullptr, 0);
+  if (length <= 0 || static_cast<size_t>(length) > sizeof(ticket_keys_)) {
+    return false;
+  }
+  // The key is never written after construction.
+  return SSL_CTX_set_tlsext_ticket_keys(
+             ssl_ctx, const_cast<uint8_t*>(ticket_keys_), length) == 1;
+}
+
 }  // namespace rtc
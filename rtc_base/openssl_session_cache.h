@@ -13,12 +13,18 @@
 
 #include <openssl/ossl_typ.h>
 
+#include <stddef.h>
+#include <stdint.h>
+
+#include <deque>
 #include <map>
 #include <string>
 
 #include "absl/strings/string_view.h"
 #include "rtc_base/ssl_stream_adapter.h"
 #include "rtc_base/string_utils.h"
+#include "rtc_base/synchronization/mutex.h"
+#include "rtc_base/thread_annotations.h"
 
 #ifndef OPENSSL_IS_BORINGSSL
 typedef struct ssl_session_st SSL_SESSION;
@@ -67,6 +73,41 @@ class OpenSSLSessionCache final {
   // The cache should never be copied or assigned directly.
 };
 
+// The SSLSessionCache of OpenSSLStreamAdapter. Client sessions are looked up
+// by a key derived from the certificates of both ends. Servers share one
+// session ticket key, generated on construction and kept for the lifetime of
+// the cache.
+class OpenSSLDtlsSessionCache : public SSLSessionCache {
+ public:
+  // The number of client sessions that are kept. The oldest is evicted first.
+  static constexpr size_t kMaxSessions = 256;
+
+  OpenSSLDtlsSessionCache();
+  ~OpenSSLDtlsSessionCache() override;
+
+  OpenSSLDtlsSessionCache(const OpenSSLDtlsSessionCache&) = delete;
+  OpenSSLDtlsSessionCache& operator=(const OpenSSLDtlsSessionCache&) = delete;
+
+  // Looks up a session by key. The returned SSL_SESSION is up_refed, since
+  // another thread may replace it in the cache.
+  SSL_SESSION* LookupSession(absl::string_view key) const;
+  // Adds a session to the cache, and up_refs it. Any existing session with the
+  // same key is replaced.
+  void AddSession(absl::string_view key, SSL_SESSION* session);
+  size_t size() const;
+
+  // Makes `ssl_ctx` encrypt and decrypt session tickets with the shared key.
+  bool ConfigureTicketKeys(SSL_CTX* ssl_ctx) const;
+
+ private:
+  mutable webrtc::Mutex mutex_;
+  std::map<std::string, SSL_SESSION*, rtc::AbslStringViewCmp> sessions_
+      RTC_GUARDED_BY(mutex_);
+  // The keys of `sessions_` in the order they were added.
+  std::deque<std::string> keys_ RTC_GUARDED_BY(mutex_);
+  uint8_t ticket_keys_[80];
+};
+
 }  // namespace rtc
 
 #endif  // RTC_BASE_OPENSSL_SESSION_CACHE_H_
@@ -26,6 +26,7 @@
 #include "api/array_view.h"
 #include "rtc_base/checks.h"
 #include "rtc_base/logging.h"
+#include "rtc_base/message_digest.h"
 #include "rtc_base/numerics/safe_conversions.h"
 #include "rtc_base/openssl.h"
 #include "rtc_base/openssl_adapter.h"
@@ -556,6 +557,18 @@ void OpenSSLStreamAdapter::SetInitialRetransmissionTimeout(int timeout_ms) {
   dtls_handshake_timeout_ms_ = timeout_ms;
 }
 
+void OpenSSLStreamAdapter::SetSessionCache(
+    scoped_refptr<SSLSessionCache> cache) {
+  RTC_DCHECK(ssl_ctx_ == nullptr);
+  // SSLSessionCache::Create() only creates OpenSSLDtlsSessionCaches.
+  session_cache_ = scoped_refptr<OpenSSLDtlsSessionCache>(
+      static_cast<OpenSSLDtlsSessionCache*>(cache.get()));
+}
+
+bool OpenSSLStreamAdapter::IsSessionResumed() const {
+  return state_ == SSL_CONNECTED && SSL_session_reused(ssl_);
+}
+
 //
 // StreamInterface Implementation
 //
@@ -861,6 +874,9 @@ int OpenSSLStreamAdapter::BeginSSL() {
   SSL_set_app_data(ssl_, this);
 
   SSL_set_bio(ssl_, bio, bio);  // the SSL object owns the bio now.
+  if (session_cache_ && role_ == SSL_CLIENT) {
+    OfferCachedSession();
+  }
   if (ssl_mode_ == SSL_MODE_DTLS) {
 #ifdef OPENSSL_IS_BORINGSSL
     DTLSv1_set_initial_timeout_duration(ssl_, dtls_handshake_timeout_ms_);
@@ -892,6 +908,15 @@ int OpenSSLStreamAdapter::ContinueSSL() {
   switch (ssl_error) {
     case SSL_ERROR_NONE:
       RTC_DLOG(LS_VERBOSE) << " -- success";
+      if (SSL_session_reused(ssl_) && !VerifyResumedSession()) {
+        return -1;
+      }
+      if (!session_key_.empty()) {
+        SSL_SESSION* session = SSL_get_session(ssl_);
+        if (session && SSL_SESSION_is_resumable(session)) {
+          session_cache_->AddSession(session_key_, session);
+        }
+      }
       // By this point, OpenSSL should have given us a certificate, or errored
       // out if one was missing.
       RTC_DCHECK(peer_cert_chain_ || !GetClientAuthEnabled());
@@ -1070,9 +1095,72 @@ SSL_CTX* OpenSSLStreamAdapter::SetupSSLContext() {
   SSL_CTX_set_permute_extensions(ctx, permute_extension_);
 #endif
 
+  if (session_cache_) {
+    // Servers that verify the peer refuse to resume sessions without a
+    // session ID context.
+    static constexpr char kSessionIdContext[] = "WebRTC";
+    SSL_CTX_set_session_id_context(
+        ctx, reinterpret_cast<const uint8_t*>(kSessionIdContext),
+        sizeof(kSessionIdContext) - 1);
+    if (!session_cache_->ConfigureTicketKeys(ctx)) {
+      SSL_CTX_free(ctx);
+      return nullptr;
+    }
+  }
+
   return ctx;
 }
 
+void OpenSSLStreamAdapter::OfferCachedSession() {
+  // The session is only valid between the same pair of certificates.
+  unsigned char digest[EVP_MAX_MD_SIZE];
+  size_t digest_length;
+  if (!HasPeerCertificateDigest() || !identity_ ||
+      !identity_->certificate().ComputeDigest(DIGEST_SHA_256, digest,
+                                              sizeof(digest), &digest_length)) {
+    return;
+  }
+  session_key_.assign(reinterpret_cast<const char*>(digest), digest_length);
+  session_key_.append(peer_certificate_digest_algorithm_);
+  session_key_.append(peer_certificate_digest_value_.data<char>(),
+                      peer_certificate_digest_value_.size());
+
+  SSL_SESSION* session = session_cache_->LookupSession(session_key_);
+  if (session) {
+    SSL_set_session(ssl_, session);
+    SSL_SESSION_free(session);
+  }
+}
+
+bool OpenSSLStreamAdapter::VerifyResumedSession() {
+#ifdef OPENSSL_IS_BORINGSSL
+  const STACK_OF(CRYPTO_BUFFER)* chain = SSL_get0_peer_certificates(ssl_);
+  if (chain) {
+    std::vector<std::unique_ptr<SSLCertificate>> cert_chain;
+    for (CRYPTO_BUFFER* cert : chain) {
+      cert_chain.emplace_back(new BoringSSLCertificate(bssl::UpRef(cert)));
+    }
+    peer_cert_chain_.reset(new SSLCertChain(std::move(cert_chain)));
+  }
+#else
+  X509* cert = SSL_get_peer_certificate(ssl_);
+  if (cert) {
+    peer_cert_chain_.reset(
+        new SSLCertChain(std::make_unique<OpenSSLCertificate>(cert)));
+    X509_free(cert);
+  }
+#endif
+  if (!peer_cert_chain_ && role_ == SSL_SERVER && !GetClientAuthEnabled()) {
+    return true;
+  }
+  // As after a full handshake, the certificate is verified once the digest
+  // is known.
+  if (peer_certificate_digest_algorithm_.empty()) {
+    return true;
+  }
+  return VerifyPeerCertificate();
+}
+
 bool OpenSSLStreamAdapter::VerifyPeerCertificate() {
   if (!HasPeerCertificateDigest() || !peer_cert_chain_ ||
       !peer_cert_chain_->GetSize()) {
@@ -28,7 +28,9 @@
 #else
 #include "rtc_base/openssl_identity.h"
 #endif
+#include "api/scoped_refptr.h"
 #include "api/task_queue/pending_task_safety_flag.h"
+#include "rtc_base/openssl_session_cache.h"
 #include "rtc_base/ssl_identity.h"
 #include "rtc_base/ssl_stream_adapter.h"
 #include "rtc_base/stream.h"
@@ -93,6 +95,8 @@ class OpenSSLStreamAdapter final : public SSLStreamAdapter,
   void SetMode(SSLMode mode) override;
   void SetMaxProtocolVersion(SSLProtocolVersion version) override;
   void SetInitialRetransmissionTimeout(int timeout_ms) override;
+  void SetSessionCache(scoped_refptr<SSLSessionCache> cache) override;
+  bool IsSessionResumed() const override;
 
   StreamResult Read(rtc::ArrayView<uint8_t> data,
                     size_t& read,
@@ -182,6 +186,12 @@ class OpenSSLStreamAdapter final : public SSLStreamAdapter,
   SSL_CTX* SetupSSLContext();
   // Verify the peer certificate matches the signaled digest.
   bool VerifyPeerCertificate();
+  // Offers the cached session for the current peer, if any. Client only.
+  void OfferCachedSession();
+  // Takes the peer certificate from a resumed session, for which the
+  // verification callback is not called, and verifies it if the digest is
+  // known.
+  bool VerifyResumedSession();
 
 #ifdef OPENSSL_IS_BORINGSSL
   // SSL certificate verification callback. See SSL_CTX_set_custom_verify.
@@ -241,6 +251,12 @@ class OpenSSLStreamAdapter final : public SSLStreamAdapter,
   // The DtlsSrtp ciphers
   std::string srtp_ciphers_;
 
+  // Sessions to resume, if resumption is enabled.
+  scoped_refptr<OpenSSLDtlsSessionCache> session_cache_;
+  // The key of the session of this client in `session_cache_`, set if the
+  // session will be stored.
+  std::string session_key_;
+
   // Do DTLS or not
   SSLMode ssl_mode_;
 
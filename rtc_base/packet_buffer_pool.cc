@@ -0,0 +1,162 @@
+/*
+ *  Copyright 2024 The WebRTC Project Authors. All rights reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "rtc_base/packet_buffer_pool.h"
+
+#include <cstring>
+#include <utility>
+
+#include "rtc_base/checks.h"
+
+namespace rtc {
+namespace {
+
+struct SizeClass {
+  size_t capacity;
+  // Number of free buffers kept for reuse, beyond which released buffers are
+  // deleted.
+  size_t max_free_buffers;
+};
+
+// STUN and RTCP, media packets up to a typical MTU, and then the occasional
+// large datagram, e.g. on loopback.
+constexpr SizeClass kSizeClasses[PacketBufferPool::kNumSizeClasses] = {
+    {256, 512},
+    {2048, 512},
+    {16 * 1024, 32},
+    {PacketBufferPool::kMaxPooledSize, 8},
+};
+
+int SizeClassForSize(size_t size) {
+  for (size_t i = 0; i < PacketBufferPool::kNumSizeClasses; ++i) {
+    if (size <= kSizeClasses[i].capacity) {
+      return static_cast<int>(i);
+    }
+  }
+  return -1;
+}
+
+// Returns -1 if the capacity was changed after the buffer was handed out.
+int SizeClassForCapacity(size_t capacity) {
+  for (size_t i = 0; i < PacketBufferPool::kNumSizeClasses; ++i) {
+    if (capacity == kSizeClasses[i].capacity) {
+      return static_cast<int>(i);
+    }
+  }
+  return -1;
+}
+
+}  // namespace
+
+// static
+scoped_refptr<PacketBufferPool> PacketBufferPool::Create() {
+  return scoped_refptr<PacketBufferPool>(new PacketBufferPool());
+}
+
+PacketBufferPool::PacketBufferPool() : owner_thread_(CurrentThreadRef()) {
+  for (size_t i = 0; i < kNumSizeClasses; ++i) {
+    free_buffers_[i].reserve(kSizeClasses[i].max_free_buffers);
+  }
+}
+
+PacketBufferPool::~PacketBufferPool() {
+  for (std::vector<Storage*>& free_buffers : free_buffers_) {
+    for (Storage* storage : free_buffers) {
+      delete storage;
+    }
+  }
+  for (Storage* storage : returned_buffers_) {
+    delete storage;
+  }
+}
+
+CopyOnWriteBuffer PacketBufferPool::Allocate(size_t size) {
+  RTC_DCHECK(IsThreadRefEqual(owner_thread_, CurrentThreadRef()));
+  const int size_class = SizeClassForSize(size);
+  if (size == 0 || size_class < 0) {
+    return CopyOnWriteBuffer(size);
+  }
+  std::vector<Storage*>& free_buffers = free_buffers_[size_class];
+  if (free_buffers.empty()) {
+    ReclaimReturnedBuffers();
+  }
+  Storage* storage;
+  if (free_buffers.empty()) {
+    storage = new Storage(0, kSizeClasses[size_class].capacity);
+    storage->set_recycler(this);
+  } else {
+    storage = free_buffers.back();
+    free_buffers.pop_back();
+  }
+  // Each outstanding buffer holds a reference, released in Recycle().
+  AddRef();
+  return CopyOnWriteBuffer(scoped_refptr<Storage>(storage), size);
+}
+
+CopyOnWriteBuffer PacketBufferPool::CopyFrom(
+    rtc::ArrayView<const uint8_t> data) {
+  CopyOnWriteBuffer buffer = Allocate(data.size());
+  if (!data.empty()) {
+    std::memcpy(buffer.MutableData(), data.data(), data.size());
+  }
+  return buffer;
+}
+
+size_t PacketBufferPool::free_buffers() const {
+  RTC_DCHECK(IsThreadRefEqual(owner_thread_, CurrentThreadRef()));
+  size_t count = 0;
+  for (const std::vector<Storage*>& free_buffers : free_buffers_) {
+    count += free_buffers.size();
+  }
+  webrtc::MutexLock lock(&returned_lock_);
+  return count + returned_buffers_.size();
+}
+
+void PacketBufferPool::Recycle(Storage* storage) {
+  const int size_class = SizeClassForCapacity(storage->capacity());
+  if (size_class < 0) {
+    delete storage;
+  } else if (IsThreadRefEqual(owner_thread_, CurrentThreadRef())) {
+    std::vector<Storage*>& free_buffers = free_buffers_[size_class];
+    if (free_buffers.size() < kSizeClasses[size_class].max_free_buffers) {
+      free_buffers.push_back(storage);
+    } else {
+      delete storage;
+    }
+  } else {
+    webrtc::MutexLock lock(&returned_lock_);
+    returned_buffers_.push_back(storage);
+  }
+  // May delete the pool if it was only kept alive by this buffer.
+  Release();
+}
+
+void PacketBufferPool::ReclaimReturnedBuffers() {
+  {
+    webrtc::MutexLock lock(&returned_lock_);
+    if (returned_buffers_.empty()) {
+      return;
+    }
+    // Swapping keeps the capacity of both vectors around.
+    reclaimed_buffers_.swap(returned_buffers_);
+  }
+  for (Storage* storage : reclaimed_buffers_) {
+    const size_t size_class = SizeClassForCapacity(storage->capacity());
+    std::vector<Storage*>& free_buffers = free_buffers_[size_class];
+    if (free_buffers.size() < kSizeClasses[size_class].max_free_buffers) {
+      free_buffers.push_back(storage);
+    } else {
+      delete storage;
+    }
+  }
+  reclaimed_buffers_.clear();
+}
+
+}  // namespace rtc
@@ -0,0 +1,85 @@
+/*
+ *  Copyright 2024 The WebRTC Project Authors. All rights reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef RTC_BASE_PACKET_BUFFER_POOL_H_
+#define RTC_BASE_PACKET_BUFFER_POOL_H_
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "api/array_view.h"
+#include "api/ref_counted_base.h"
+#include "api/scoped_refptr.h"
+#include "rtc_base/copy_on_write_buffer.h"
+#include "rtc_base/platform_thread_types.h"
+#include "rtc_base/synchronization/mutex.h"
+#include "rtc_base/system/rtc_export.h"
+#include "rtc_base/thread_annotations.h"
+
+namespace rtc {
+
+// Hands out CopyOnWriteBuffers for received packets without a heap allocation
+// per packet. Memory comes in a few size classes and goes back to the pool
+// when the last CopyOnWriteBuffer referencing it is destroyed, so a packet can
+// be read from the socket, decrypted and parsed in the same buffer.
+//
+// The pool is thread-affine: Allocate() and CopyFrom() must be called on the
+// thread that created the pool, typically the network thread. Buffers may be
+// released on any thread. Those released on other threads are handed back
+// through a locked list and reused once the free list of their size class on
+// the owning thread runs dry. Outstanding buffers keep the pool alive.
+class RTC_EXPORT PacketBufferPool
+    : public webrtc::RefCountedBase,
+      private CopyOnWriteBuffer::StorageRecycler {
+ public:
+  static constexpr size_t kNumSizeClasses = 4;
+  // Largest buffer handed out by the pool. Larger requests are served by the
+  // heap.
+  static constexpr size_t kMaxPooledSize = 64 * 1024;
+
+  static scoped_refptr<PacketBufferPool> Create();
+
+  // Returns a buffer of `size` uninitialized bytes.
+  CopyOnWriteBuffer Allocate(size_t size);
+  // Returns a buffer holding a copy of `data`.
+  CopyOnWriteBuffer CopyFrom(rtc::ArrayView<const uint8_t> data);
+
+  // Number of buffers waiting to be reused, including those released on other
+  // threads. Must be called on the owning thread.
+  size_t free_buffers() const;
+
+ protected:
+  ~PacketBufferPool() override;
+
+ private:
+  using Storage = CopyOnWriteBuffer::Storage;
+
+  PacketBufferPool();
+
+  // CopyOnWriteBuffer::StorageRecycler:
+  void Recycle(Storage* storage) override;
+
+  // Moves buffers released on other threads to the free lists.
+  void ReclaimReturnedBuffers();
+
+  const PlatformThreadRef owner_thread_;
+  // Only accessed on `owner_thread_`, or by the destructor.
+  std::array<std::vector<Storage*>, kNumSizeClasses> free_buffers_;
+  std::vector<Storage*> reclaimed_buffers_;
+
+  mutable webrtc::Mutex returned_lock_;
+  std::vector<Storage*> returned_buffers_ RTC_GUARDED_BY(returned_lock_);
+};
+
+}  // namespace rtc
+
+#endif  // RTC_BASE_PACKET_BUFFER_POOL_H_
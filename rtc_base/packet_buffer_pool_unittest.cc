@@ -0,0 +1,140 @@
+/*
+ *  Copyright 2024 The WebRTC Project Authors. All rights reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "rtc_base/packet_buffer_pool.h"
+
+#include <cstdint>
+#include <utility>
+
+#include "rtc_base/copy_on_write_buffer.h"
+#include "rtc_base/network/received_packet.h"
+#include "rtc_base/platform_thread.h"
+#include "rtc_base/socket_address.h"
+#include "test/gtest.h"
+
+namespace rtc {
+namespace {
+
+const uint8_t kTestData[] = {0x0, 0x1, 0x2, 0x3, 0x4, 0x5, 0x6, 0x7};
+
+TEST(PacketBufferPoolTest, CopiesData) {
+  scoped_refptr<PacketBufferPool> pool = PacketBufferPool::Create();
+  CopyOnWriteBuffer buffer = pool->CopyFrom(kTestData);
+  EXPECT_EQ(buffer, CopyOnWriteBuffer(kTestData));
+  EXPECT_GE(buffer.capacity(), sizeof(kTestData));
+}
+
+TEST(PacketBufferPoolTest, ReusesReleasedBuffers) {
+  scoped_refptr<PacketBufferPool> pool = PacketBufferPool::Create();
+  const uint8_t* data;
+  {
+    CopyOnWriteBuffer buffer = pool->Allocate(1200);
+    data = buffer.cdata();
+    EXPECT_EQ(pool->free_buffers(), 0u);
+  }
+  EXPECT_EQ(pool->free_buffers(), 1u);
+  CopyOnWriteBuffer buffer = pool->Allocate(1500);
+  EXPECT_EQ(buffer.cdata(), data);
+  EXPECT_EQ(buffer.size(), 1500u);
+  EXPECT_EQ(pool->free_buffers(), 0u);
+}
+
+TEST(PacketBufferPoolTest, UsesSeparateSizeClasses) {
+  scoped_refptr<PacketBufferPool> pool = PacketBufferPool::Create();
+  pool->Allocate(100);
+  CopyOnWriteBuffer large = pool->Allocate(1500);
+  EXPECT_GE(large.capacity(), 1500u);
+  EXPECT_EQ(pool->free_buffers(), 1u);
+  CopyOnWriteBuffer small = pool->Allocate(100);
+  EXPECT_EQ(pool->free_buffers(), 0u);
+}
+
+TEST(PacketBufferPoolTest, DoesNotPoolOversizedBuffers) {
+  scoped_refptr<PacketBufferPool> pool = PacketBufferPool::Create();
+  pool->Allocate(PacketBufferPool::kMaxPooledSize + 1);
+  EXPECT_EQ(pool->free_buffers(), 0u);
+}
+
+TEST(PacketBufferPoolTest, ModifiesUnsharedBufferInPlace) {
+  scoped_refptr<PacketBufferPool> pool = PacketBufferPool::Create();
+  CopyOnWriteBuffer buffer = pool->CopyFrom(kTestData);
+  const uint8_t* data = buffer.cdata();
+  buffer.MutableData()[0] = 0xff;
+  buffer.SetSize(4);
+  EXPECT_EQ(buffer.cdata(), data);
+}
+
+TEST(PacketBufferPoolTest, CopyOfSharedBufferIsNotPooled) {
+  scoped_refptr<PacketBufferPool> pool = PacketBufferPool::Create();
+  CopyOnWriteBuffer buffer = pool->CopyFrom(kTestData);
+  {
+    CopyOnWriteBuffer copy = buffer;
+    copy.MutableData()[0] = 0xff;
+    EXPECT_NE(copy.cdata(), buffer.cdata());
+  }
+  EXPECT_EQ(pool->free_buffers(), 0u);
+  buffer = CopyOnWriteBuffer();
+  EXPECT_EQ(pool->free_buffers(), 1u);
+}
+
+TEST(PacketBufferPoolTest, ReusesBuffersReleasedOnOtherThreads) {
+  scoped_refptr<PacketBufferPool> pool = PacketBufferPool::Create();
+  CopyOnWriteBuffer buffer = pool->Allocate(1000);
+  const uint8_t* data = buffer.cdata();
+  PlatformThread::SpawnJoinable(
+      [buffer = std::move(buffer)]() mutable { buffer = CopyOnWriteBuffer(); },
+      "release");
+  EXPECT_EQ(pool->free_buffers(), 1u);
+  EXPECT_EQ(pool->Allocate(1000).cdata(), data);
+}
+
+TEST(PacketBufferPoolTest, OutstandingBuffersOutliveThePool) {
+  scoped_refptr<PacketBufferPool> pool = PacketBufferPool::Create();
+  CopyOnWriteBuffer buffer = pool->CopyFrom(kTestData);
+  pool = nullptr;
+  EXPECT_EQ(buffer, CopyOnWriteBuffer(kTestData));
+}
+
+TEST(PacketBufferPoolTest, ReceivedPacketSharesAttachedBuffer) {
+  scoped_refptr<PacketBufferPool> pool = PacketBufferPool::Create();
+  CopyOnWriteBuffer buffer = pool->CopyFrom(kTestData);
+  const uint8_t* data = buffer.cdata();
+  SocketAddress address;
+  ReceivedPacket packet(buffer, address);
+  packet.set_payload_buffer(&buffer);
+
+  CopyOnWriteBuffer payload =
+      packet.CopyAndSet(ReceivedPacket::kSrtpEncrypted).SharePayload();
+  EXPECT_EQ(payload.cdata(), data);
+  EXPECT_EQ(packet.SharePayload().cdata(), data);
+
+  // Modifying the payload while the packet is alive copies it.
+  payload.MutableData()[0] = 0xff;
+  EXPECT_NE(payload.cdata(), data);
+  EXPECT_EQ(packet.payload().data(), data);
+  EXPECT_EQ(packet.payload()[0], kTestData[0]);
+
+  // Once the attached buffer is released, it is modified in place.
+  payload = packet.SharePayload();
+  buffer = CopyOnWriteBuffer();
+  payload.MutableData()[0] = 0xff;
+  EXPECT_EQ(payload.cdata(), data);
+}
+
+TEST(PacketBufferPoolTest, ReceivedPacketCopiesPayloadWithoutBuffer) {
+  SocketAddress address;
+  ReceivedPacket packet(kTestData, address);
+  CopyOnWriteBuffer payload = packet.SharePayload();
+  EXPECT_NE(payload.cdata(), kTestData);
+  EXPECT_EQ(payload, CopyOnWriteBuffer(kTestData));
+}
+
+}  // namespace
+}  // namespace rtc
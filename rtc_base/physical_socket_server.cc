@@ -9,6 +9,8 @@
  */
 #include "rtc_base/physical_socket_server.h"
 
+#include <algorithm>
+#include <array>
 #include <cstdint>
 #include <utility>
 
@@ -43,6 +45,7 @@
 
 #include <errno.h>
 
+#include "absl/types/optional.h"
 #include "rtc_base/async_dns_resolver.h"
 #include "rtc_base/checks.h"
 #include "rtc_base/event.h"
@@ -56,6 +59,12 @@
 
 #if defined(WEBRTC_LINUX)
 #include <linux/sockios.h>
+#include <netinet/udp.h>
+#include <string.h>
+
+#if !defined(UDP_SEGMENT)
+#define UDP_SEGMENT 103
+#endif  // !defined(UDP_SEGMENT)
 #endif
 
 #if defined(WEBRTC_WIN)
@@ -113,6 +122,9 @@ namespace {
 // RFC-3168, Section 5. ECN is the two least significant bits.
 static constexpr uint8_t kEcnMask = 0x03;
 
+using PacketList = rtc::ArrayView<const rtc::ArrayView<const uint8_t>>;
+using EcnMarkingList = rtc::ArrayView<const rtc::EcnMarking>;
+
 #if defined(WEBRTC_POSIX)
 
 rtc::EcnMarking EcnFromDs(uint8_t ds) {
@@ -134,6 +146,54 @@ rtc::EcnMarking EcnFromDs(uint8_t ds) {
   return rtc::EcnMarking::kNotEct;
 }
 
+// TODO(bugs.webrtc.org/15368): What size is needed? IPV6_TCLASS is supposed
+// to be an int. Why is a larger size needed?
+// The union aligns the buffer for CMSG_FIRSTHDR() and CMSG_NXTHDR().
+union ControlBuffer {
+  cmsghdr header;
+  char data[CMSG_SPACE(sizeof(struct timeval) + 5 * sizeof(int))];
+};
+
+#endif
+
+#if defined(WEBRTC_LINUX)
+// Upper bound on the number of datagrams read by a single recvmmsg() call.
+constexpr size_t kMaxRecvBatchSize = 64;
+// Upper bound on the number of datagrams sent by a single sendmmsg() call.
+constexpr size_t kMaxSendBatchSize = 64;
+// Kernel limits for UDP generic segmentation offload, see UDP_MAX_SEGMENTS in
+// include/linux/udp.h and the maximum UDP payload over IPv4.
+constexpr size_t kMaxGsoSegments = 64;
+constexpr size_t kMaxGsoPayloadSize = 65507;
+
+// Returns how many of the leading `packets` can be sent as one GSO
+// super-datagram. All segments must have the same size, except for the last
+// one which may be shorter, and the same ECN marking, if any.
+size_t CountGsoSegments(PacketList packets, EcnMarkingList ecn_markings) {
+  const size_t segment_size = packets[0].size();
+  size_t total_size = 0;
+  size_t count = 0;
+  for (rtc::ArrayView<const uint8_t> packet : packets) {
+    if (count == kMaxGsoSegments || packet.size() > segment_size ||
+        total_size + packet.size() > kMaxGsoPayloadSize ||
+        (!ecn_markings.empty() && ecn_markings[count] != ecn_markings[0])) {
+      break;
+    }
+    total_size += packet.size();
+    ++count;
+    if (packet.size() < segment_size) {
+      break;
+    }
+  }
+  return count;
+}
+
+// Errors returned by sendmsg() when the kernel or the outgoing device does not
+// support UDP_SEGMENT.
+bool IsGsoUnsupportedError(int error) {
+  return error == EIO || error == EINVAL || error == ENOPROTOOPT ||
+         error == EOPNOTSUPP;
+}
 #endif
 
 class ScopedSetTrue {
@@ -369,6 +429,8 @@ int PhysicalSocket::SetOption(Option opt, int value) {
   } else if (opt == OPT_SEND_ECN) {
     ecn_ = value;
     value = dscp_ + (ecn_ & kEcnMask);
+  } else if (opt == OPT_RECV_ECN) {
+    recv_ecn_ = value != 0;
   }
 #if defined(WEBRTC_POSIX)
   if (sopt == IPV6_TCLASS) {
@@ -436,6 +498,160 @@ int PhysicalSocket::SendTo(const void* buffer,
   return sent;
 }
 
+int PhysicalSocket::SendToBatch(PacketList packets,
+                                const SocketAddress& addr,
+                                EcnMarkingList ecn_markings) {
+  RTC_DCHECK(ecn_markings.empty() || ecn_markings.size() == packets.size());
+#if defined(WEBRTC_LINUX)
+  if (!udp_) {
+    return Socket::SendToBatch(packets, addr, ecn_markings);
+  }
+  if (packets.empty()) {
+    return 0;
+  }
+  sockaddr_storage saddr;
+  socklen_t saddr_len = static_cast<socklen_t>(addr.ToSockAddrStorage(&saddr));
+  size_t sent = 0;
+  while (sent < packets.size()) {
+    PacketList remaining = packets.subview(sent);
+    EcnMarkingList remaining_ecn_markings = ecn_markings.subview(sent);
+    const size_t gso_segments =
+        udp_gso_enabled_ ? CountGsoSegments(remaining, remaining_ecn_markings)
+                         : 0;
+    int result;
+    if (gso_segments > 1) {
+      result = DoSendWithGso(
+          remaining.subview(0, gso_segments),
+          remaining_ecn_markings.empty()
+              ? absl::nullopt
+              : absl::make_optional(remaining_ecn_markings[0]),
+          saddr, saddr_len);
+      if (result < 0 && IsGsoUnsupportedError(LAST_SYSTEM_ERROR)) {
+        RTC_LOG(LS_INFO) << "UDP GSO is not available, using sendmmsg.";
+        udp_gso_enabled_ = false;
+        continue;
+      }
+    } else {
+      result = DoSendMmsg(remaining, remaining_ecn_markings, saddr, saddr_len);
+    }
+    UpdateLastError();
+    if (result <= 0) {
+      break;
+    }
+    sent += result;
+  }
+  MaybeRemapSendError();
+  if (sent < packets.size() && IsBlockingError(GetError())) {
+    EnableEvents(DE_WRITE);
+  }
+  return sent > 0 ? static_cast<int>(sent) : SOCKET_ERROR;
+#else
+  // Without per-datagram markings, the socket option is only changed where
+  // the marking does, and restored at the end.
+  const int socket_ecn = ecn_;
+  int sent = static_cast<int>(packets.size());
+  for (size_t i = 0; i < packets.size(); ++i) {
+    if (!ecn_markings.empty() &&
+        static_cast<uint8_t>(ecn_markings[i]) != (ecn_ & kEcnMask)) {
+      SetOption(OPT_SEND_ECN, static_cast<int>(ecn_markings[i]));
+    }
+    if (SendTo(packets[i].data(), packets[i].size(), addr) < 0) {
+      sent = i > 0 ? static_cast<int>(i) : SOCKET_ERROR;
+      break;
+    }
+  }
+  if (ecn_ != socket_ecn) {
+    const int error = GetError();
+    SetOption(OPT_SEND_ECN, socket_ecn);
+    SetError(error);
+  }
+  return sent;
+#endif
+}
+
+#if defined(WEBRTC_LINUX)
+int PhysicalSocket::DoSendWithGso(PacketList packets,
+                                  absl::optional<EcnMarking> ecn,
+                                  const sockaddr_storage& addr,
+                                  socklen_t addr_len) {
+  RTC_DCHECK_LE(packets.size(), kMaxGsoSegments);
+  std::array<iovec, kMaxGsoSegments> iovecs;
+  for (size_t i = 0; i < packets.size(); ++i) {
+    iovecs[i] = {.iov_base = const_cast<uint8_t*>(packets[i].data()),
+                 .iov_len = packets[i].size()};
+  }
+  alignas(cmsghdr) char control[CMSG_SPACE(sizeof(uint16_t)) +
+                                CMSG_SPACE(sizeof(int))] = {};
+  msghdr msg = {.msg_name = const_cast<sockaddr_storage*>(&addr),
+                .msg_namelen = addr_len,
+                .msg_iov = iovecs.data(),
+                .msg_iovlen = packets.size(),
+                .msg_control = control,
+                .msg_controllen = sizeof(control)};
+  cmsghdr* cmsg = CMSG_FIRSTHDR(&msg);
+  cmsg->cmsg_level = IPPROTO_UDP;
+  cmsg->cmsg_type = UDP_SEGMENT;
+  cmsg->cmsg_len = CMSG_LEN(sizeof(uint16_t));
+  const uint16_t segment_size = static_cast<uint16_t>(packets[0].size());
+  memcpy(CMSG_DATA(cmsg), &segment_size, sizeof(segment_size));
+  if (ecn.has_value()) {
+    WriteDsControlMessage(CMSG_NXTHDR(&msg, cmsg), addr, *ecn);
+  } else {
+    msg.msg_controllen = CMSG_SPACE(sizeof(uint16_t));
+  }
+
+  int sent = ::sendmsg(s_, &msg, MSG_NOSIGNAL);
+  return sent < 0 ? sent : static_cast<int>(packets.size());
+}
+
+int PhysicalSocket::DoSendMmsg(PacketList packets,
+                               EcnMarkingList ecn_markings,
+                               const sockaddr_storage& addr,
+                               socklen_t addr_len) {
+  union DsControlBuffer {
+    cmsghdr header;
+    char data[CMSG_SPACE(sizeof(int))];
+  };
+  const size_t count = std::min(packets.size(), kMaxSendBatchSize);
+  std::array<mmsghdr, kMaxSendBatchSize> messages;
+  std::array<iovec, kMaxSendBatchSize> iovecs;
+  std::array<DsControlBuffer, kMaxSendBatchSize> controls;
+  for (size_t i = 0; i < count; ++i) {
+    iovecs[i] = {.iov_base = const_cast<uint8_t*>(packets[i].data()),
+                 .iov_len = packets[i].size()};
+    messages[i] = {};
+    messages[i].msg_hdr = {.msg_name = const_cast<sockaddr_storage*>(&addr),
+                           .msg_namelen = addr_len,
+                           .msg_iov = &iovecs[i],
+                           .msg_iovlen = 1};
+    if (!ecn_markings.empty()) {
+      msghdr& msg = messages[i].msg_hdr;
+      msg.msg_control = &controls[i];
+      msg.msg_controllen = sizeof(controls[i]);
+      WriteDsControlMessage(CMSG_FIRSTHDR(&msg), addr, ecn_markings[i]);
+    }
+  }
+  return ::sendmmsg(s_, messages.data(), count, MSG_NOSIGNAL);
+}
+#endif
+
+#if defined(WEBRTC_POSIX)
+void PhysicalSocket::WriteDsControlMessage(cmsghdr* cmsg,
+                                           const sockaddr_storage& addr,
+                                           EcnMarking ecn) const {
+  // IPv4 destinations, also when mapped on an IPv6 socket, take IP_TOS.
+  const bool ipv6 =
+      addr.ss_family == AF_INET6 &&
+      !IN6_IS_ADDR_V4MAPPED(
+          &reinterpret_cast<const sockaddr_in6&>(addr).sin6_addr);
+  cmsg->cmsg_level = ipv6 ? IPPROTO_IPV6 : IPPROTO_IP;
+  cmsg->cmsg_type = ipv6 ? IPV6_TCLASS : IP_TOS;
+  cmsg->cmsg_len = CMSG_LEN(sizeof(int));
+  const int ds = dscp_ | (static_cast<int>(ecn) & kEcnMask);
+  memcpy(CMSG_DATA(cmsg), &ds, sizeof(ds));
+}
+#endif
+
 int PhysicalSocket::Recv(void* buffer, size_t length, int64_t* timestamp) {
   int received = DoReadFromSocket(buffer, length, /*out_addr*/ nullptr,
                                   timestamp, /*ecn=*/nullptr);
@@ -488,7 +704,7 @@ int PhysicalSocket::RecvFrom(ReceiveBuffer& buffer) {
 
   int received = DoReadFromSocket(
       buffer.payload.data(), buffer.payload.capacity(), &buffer.source_address,
-      &timestamp, ecn_ ? &buffer.ecn : nullptr);
+      &timestamp, (ecn_ || recv_ecn_) ? &buffer.ecn : nullptr);
   buffer.payload.SetSize(received > 0 ? received : 0);
   if (received > 0 && timestamp != -1) {
     buffer.arrival_time = webrtc::Timestamp::Micros(timestamp);
@@ -505,6 +721,68 @@ int PhysicalSocket::RecvFrom(ReceiveBuffer& buffer) {
   return received;
 }
 
+int PhysicalSocket::RecvFromBatch(rtc::ArrayView<ReceiveBuffer> buffers) {
+#if defined(WEBRTC_LINUX)
+  RTC_DCHECK(!buffers.empty());
+  const size_t count = std::min(buffers.size(), kMaxRecvBatchSize);
+  std::array<mmsghdr, kMaxRecvBatchSize> messages;
+  std::array<iovec, kMaxRecvBatchSize> iovecs;
+  std::array<sockaddr_storage, kMaxRecvBatchSize> addrs;
+  std::array<ControlBuffer, kMaxRecvBatchSize> controls;
+  for (size_t i = 0; i < count; ++i) {
+    Buffer& payload = buffers[i].payload;
+    RTC_DCHECK_GT(payload.capacity(), 0);
+    iovecs[i] = {.iov_base = payload.data(), .iov_len = payload.capacity()};
+    messages[i] = {};
+    messages[i].msg_hdr = {.msg_name = &addrs[i],
+                           .msg_namelen = sizeof(addrs[i]),
+                           .msg_iov = &iovecs[i],
+                           .msg_iovlen = 1,
+                           .msg_control = &controls[i],
+                           .msg_controllen = sizeof(controls[i])};
+  }
+
+  int received = ::recvmmsg(s_, messages.data(), count, 0, nullptr);
+  UpdateLastError();
+  for (int i = 0; i < received; ++i) {
+    ReceiveBuffer& buffer = buffers[i];
+    msghdr& msg = messages[i].msg_hdr;
+    if (msg.msg_flags & MSG_TRUNC) {
+      // Any remote sender can cause this, so it is logged rarely.
+      if (num_truncated_datagrams_++ % 1000 == 0) {
+        RTC_LOG(LS_WARNING) << "Dropped " << num_truncated_datagrams_
+                            << " datagrams larger than "
+                            << buffer.payload.capacity() << " bytes";
+      }
+      buffer.payload.SetSize(0);
+      continue;
+    }
+    buffer.payload.SetSize(messages[i].msg_len);
+    buffer.arrival_time = absl::nullopt;
+    buffer.ecn = EcnMarking::kNotEct;
+    int64_t timestamp = -1;
+    ParseControlMessages(msg, &timestamp,
+                         (ecn_ || recv_ecn_) ? &buffer.ecn : nullptr);
+    if (timestamp != -1) {
+      buffer.arrival_time = webrtc::Timestamp::Micros(timestamp);
+    }
+    SocketAddressFromSockAddrStorage(addrs[i], &buffer.source_address);
+  }
+
+  int error = GetError();
+  bool success = (received >= 0) || IsBlockingError(error);
+  if (udp_ || success) {
+    EnableEvents(DE_READ);
+  }
+  if (!success) {
+    RTC_LOG_F(LS_VERBOSE) << "Error = " << error;
+  }
+  return received;
+#else
+  return Socket::RecvFromBatch(buffers);
+#endif
+}
+
 int PhysicalSocket::DoReadFromSocket(void* buffer,
                                      size_t length,
                                      SocketAddress* out_addr,
@@ -523,9 +801,7 @@ int PhysicalSocket::DoReadFromSocket(void* buffer,
     msg.msg_name = addr;
     msg.msg_namelen = addr_len;
   }
-    // TODO(bugs.webrtc.org/15368): What size is needed? IPV6_TCLASS is supposed
-    // to be an int. Why is a larger size needed?
-    char control[CMSG_SPACE(sizeof(struct timeval) + 5 * sizeof(int))] = {};
+    ControlBuffer control = {};
     if (timestamp || ecn) {
       *timestamp = -1;
       msg.msg_control = &control;
@@ -537,24 +813,7 @@ int PhysicalSocket::DoReadFromSocket(void* buffer,
       return received;
     }
     if (timestamp || ecn) {
-      struct cmsghdr* cmsg;
-      for (cmsg = CMSG_FIRSTHDR(&msg); cmsg; cmsg = CMSG_NXTHDR(&msg, cmsg)) {
-        if (ecn) {
-          if ((cmsg->cmsg_type == IPV6_TCLASS &&
-               cmsg->cmsg_level == IPPROTO_IPV6) ||
-              (cmsg->cmsg_type == IP_TOS && cmsg->cmsg_level == IPPROTO_IP)) {
-            *ecn = EcnFromDs(CMSG_DATA(cmsg)[0]);
-          }
-        }
-        if (cmsg->cmsg_level != SOL_SOCKET)
-          continue;
-        if (timestamp && cmsg->cmsg_type == SCM_TIMESTAMP) {
-          timeval* ts = reinterpret_cast<timeval*>(CMSG_DATA(cmsg));
-          *timestamp =
-              rtc::kNumMicrosecsPerSec * static_cast<int64_t>(ts->tv_sec) +
-              static_cast<int64_t>(ts->tv_usec);
-        }
-      }
+      ParseControlMessages(msg, timestamp, ecn);
     }
     if (out_addr) {
       SocketAddressFromSockAddrStorage(addr_storage, out_addr);
@@ -578,6 +837,30 @@ int PhysicalSocket::DoReadFromSocket(void* buffer,
 #endif
 }
 
+#if defined(WEBRTC_POSIX)
+void PhysicalSocket::ParseControlMessages(msghdr& msg,
+                                          int64_t* timestamp,
+                                          EcnMarking* ecn) {
+  for (cmsghdr* cmsg = CMSG_FIRSTHDR(&msg); cmsg;
+       cmsg = CMSG_NXTHDR(&msg, cmsg)) {
+    if (ecn) {
+      if ((cmsg->cmsg_type == IPV6_TCLASS &&
+           cmsg->cmsg_level == IPPROTO_IPV6) ||
+          (cmsg->cmsg_type == IP_TOS && cmsg->cmsg_level == IPPROTO_IP)) {
+        *ecn = EcnFromDs(CMSG_DATA(cmsg)[0]);
+      }
+    }
+    if (cmsg->cmsg_level != SOL_SOCKET)
+      continue;
+    if (timestamp && cmsg->cmsg_type == SCM_TIMESTAMP) {
+      timeval* ts = reinterpret_cast<timeval*>(CMSG_DATA(cmsg));
+      *timestamp = kNumMicrosecsPerSec * static_cast<int64_t>(ts->tv_sec) +
+                   static_cast<int64_t>(ts->tv_usec);
+    }
+  }
+}
+#endif
+
 int PhysicalSocket::Listen(int backlog) {
   int err = ::listen(s_, backlog);
   UpdateLastError();
@@ -789,6 +1072,15 @@ int PhysicalSocket::TranslateOption(Option opt, int* slevel, int* sopt) {
 #else
       RTC_LOG(LS_WARNING) << "Socket::OPT_TCP_USER_TIMEOUT not supported.";
       return -1;
+#endif
+    case OPT_REUSEPORT:
+#if defined(WEBRTC_POSIX) && defined(SO_REUSEPORT)
+      *slevel = SOL_SOCKET;
+      *sopt = SO_REUSEPORT;
+      break;
+#else
+      RTC_LOG(LS_WARNING) << "Socket::OPT_REUSEPORT not supported.";
+      return -1;
 #endif
     default:
       RTC_DCHECK_NOTREACHED();
@@ -11,6 +11,7 @@
 #ifndef RTC_BASE_PHYSICAL_SOCKET_SERVER_H_
 #define RTC_BASE_PHYSICAL_SOCKET_SERVER_H_
 
+#include "absl/types/optional.h"
 #include "api/async_dns_resolver.h"
 #include "api/units/time_delta.h"
 #include "rtc_base/socket.h"
@@ -183,6 +184,11 @@ class PhysicalSocket : public Socket, public sigslot::has_slots<> {
   int SendTo(const void* buffer,
              size_t length,
              const SocketAddress& addr) override;
+  // Uses UDP generic segmentation offload (GSO) for runs of equally sized
+  // packets and sendmmsg() otherwise, where available.
+  int SendToBatch(rtc::ArrayView<const rtc::ArrayView<const uint8_t>> packets,
+                  const SocketAddress& addr,
+                  rtc::ArrayView<const EcnMarking> ecn_markings) override;
 
   int Recv(void* buffer, size_t length, int64_t* timestamp) override;
   // TODO(webrtc:15368): Deprecate and remove.
@@ -191,6 +197,8 @@ class PhysicalSocket : public Socket, public sigslot::has_slots<> {
                SocketAddress* out_addr,
                int64_t* timestamp) override;
   int RecvFrom(ReceiveBuffer& buffer) override;
+  // Uses recvmmsg() where available.
+  int RecvFromBatch(rtc::ArrayView<ReceiveBuffer> buffers) override;
 
   int Listen(int backlog) override;
   Socket* Accept(SocketAddress* out_addr) override;
@@ -218,12 +226,46 @@ class PhysicalSocket : public Socket, public sigslot::has_slots<> {
                        const struct sockaddr* dest_addr,
                        socklen_t addrlen);
 
+#if defined(WEBRTC_LINUX)
+  // Sends all `packets` with a single sendmsg() call using UDP_SEGMENT, with
+  // the marking `ecn` if set. Returns the number of packets sent or a negative
+  // value on error.
+  int DoSendWithGso(rtc::ArrayView<const rtc::ArrayView<const uint8_t>> packets,
+                    absl::optional<EcnMarking> ecn,
+                    const sockaddr_storage& addr,
+                    socklen_t addr_len);
+  // Sends up to `kMaxSendBatchSize` of `packets` with a single sendmmsg()
+  // call. `ecn_markings` is empty or parallel to `packets`. Returns the number
+  // of packets sent or a negative value on error.
+  int DoSendMmsg(rtc::ArrayView<const rtc::ArrayView<const uint8_t>> packets,
+                 rtc::ArrayView<const EcnMarking> ecn_markings,
+                 const sockaddr_storage& addr,
+                 socklen_t addr_len);
+#endif
+
+#if defined(WEBRTC_POSIX)
+  // Writes a control message to `cmsg` that sets the DS field of a datagram
+  // sent to `addr` to the DSCP of the socket and `ecn`. The message takes
+  // CMSG_SPACE(sizeof(int)) bytes.
+  void WriteDsControlMessage(cmsghdr* cmsg,
+                             const sockaddr_storage& addr,
+                             EcnMarking ecn) const;
+#endif
+
   int DoReadFromSocket(void* buffer,
                        size_t length,
                        SocketAddress* out_addr,
                        int64_t* timestamp,
                        EcnMarking* ecn);
 
+#if defined(WEBRTC_POSIX)
+  // Extracts the receive timestamp and ECN marking from the ancillary data of
+  // a received message. Either of `timestamp` and `ecn` may be null.
+  static void ParseControlMessages(msghdr& msg,
+                                   int64_t* timestamp,
+                                   EcnMarking* ecn);
+#endif
+
   void OnResolveResult(const webrtc::AsyncDnsResolverResult& resolver);
 
   void UpdateLastError();
@@ -246,6 +288,12 @@ class PhysicalSocket : public Socket, public sigslot::has_slots<> {
   std::unique_ptr<webrtc::AsyncDnsResolverInterface> resolver_;
   uint8_t dscp_ = 0;  // 6bit.
   uint8_t ecn_ = 0;   // 2bits.
+  // Set by OPT_RECV_ECN, reports the ECN marking of received packets.
+  bool recv_ecn_ = false;
+  // Cleared when the kernel rejects UDP_SEGMENT, to fall back to sendmmsg().
+  bool udp_gso_enabled_ = true;
+  // Datagrams dropped by RecvFromBatch() for not fitting their buffer.
+  int num_truncated_datagrams_ = 0;
 
 #if !defined(NDEBUG)
   std::string dbg_addr_;
@@ -14,17 +14,25 @@
 
 #include <algorithm>
 #include <memory>
+#include <string>
+#include <vector>
 
+#include "rtc_base/async_udp_socket.h"
 #include "rtc_base/gunit.h"
 #include "rtc_base/ip_address.h"
 #include "rtc_base/logging.h"
 #include "rtc_base/net_helpers.h"
 #include "rtc_base/net_test_helpers.h"
+#include "rtc_base/network/ecn_marking.h"
+#include "rtc_base/network/received_packet.h"
 #include "rtc_base/network_monitor.h"
+#include "rtc_base/packet_buffer_pool.h"
 #include "rtc_base/socket_unittest.h"
 #include "rtc_base/test_utils.h"
+#include "rtc_base/third_party/sigslot/sigslot.h"
 #include "rtc_base/thread.h"
 #include "test/field_trial.h"
+#include "test/gmock.h"
 #include "test/gtest.h"
 
 namespace rtc {
@@ -106,6 +114,15 @@ class FakeNetworkBinder : public NetworkBinderInterface {
   int num_binds_ = 0;
 };
 
+class SentPacketCounter : public sigslot::has_slots<> {
+ public:
+  void OnSentPacket(AsyncPacketSocket* socket, const SentPacket& sent_packet) {
+    ++count;
+  }
+
+  int count = 0;
+};
+
 class PhysicalSocketTest : public SocketTest {
  public:
   // Set flag to simluate failures when calling "::accept" on a Socket.
@@ -484,6 +501,22 @@ TEST_F(PhysicalSocketTest, TestSocketSendRecvWithEcnIPv6) {
   SocketTest::TestSocketSendRecvWithEcnIPV6();
 }
 
+TEST_F(PhysicalSocketTest, ReusePortAllowsBindingToTheSameAddress) {
+  MAYBE_SKIP_IPV4;
+  std::unique_ptr<Socket> first(server_.CreateSocket(AF_INET, SOCK_DGRAM));
+  std::unique_ptr<Socket> second(server_.CreateSocket(AF_INET, SOCK_DGRAM));
+  ASSERT_EQ(0, first->SetOption(Socket::OPT_REUSEPORT, 1));
+  ASSERT_EQ(0, second->SetOption(Socket::OPT_REUSEPORT, 1));
+  int reuse_port = 0;
+  ASSERT_EQ(0, first->GetOption(Socket::OPT_REUSEPORT, &reuse_port));
+  EXPECT_NE(0, reuse_port);
+  ASSERT_EQ(0, first->Bind(SocketAddress(kIPv4Loopback, 0)));
+  EXPECT_EQ(0, second->Bind(first->GetLocalAddress()));
+
+  std::unique_ptr<Socket> third(server_.CreateSocket(AF_INET, SOCK_DGRAM));
+  EXPECT_NE(0, third->Bind(first->GetLocalAddress()));
+}
+
 // Verify that if the socket was unable to be bound to a real network interface
 // (not loopback), Bind will return an error.
 TEST_F(PhysicalSocketTest,
@@ -523,6 +556,329 @@ TEST_F(PhysicalSocketTest,
 
 #endif
 
+#if defined(WEBRTC_LINUX)
+TEST_F(PhysicalSocketTest, RecvFromBatchReadsAllPendingDatagrams) {
+  MAYBE_SKIP_IPV4;
+  webrtc::testing::StreamSink sink;
+  std::unique_ptr<Socket> socket(server_.CreateSocket(AF_INET, SOCK_DGRAM));
+  ASSERT_EQ(0, socket->Bind(SocketAddress(kIPv4Loopback, 0)));
+  SocketAddress address = socket->GetLocalAddress();
+  sink.Monitor(socket.get());
+
+  socket->SendTo("foo", 3, address);
+  socket->SendTo("barbaz", 6, address);
+  EXPECT_TRUE_WAIT(sink.Check(socket.get(), webrtc::testing::SSE_READ),
+                   kTimeout);
+
+  std::vector<Buffer> payloads(4);
+  std::vector<Socket::ReceiveBuffer> buffers;
+  for (Buffer& payload : payloads) {
+    payload.EnsureCapacity(1500);
+    buffers.emplace_back(payload);
+  }
+  ASSERT_EQ(socket->RecvFromBatch(buffers), 2);
+  EXPECT_EQ(payloads[0], Buffer("foo", 3));
+  EXPECT_EQ(buffers[0].source_address, address);
+  EXPECT_TRUE(buffers[0].arrival_time.has_value());
+  EXPECT_EQ(payloads[1], Buffer("barbaz", 6));
+  EXPECT_EQ(buffers[1].source_address, address);
+
+  // Nothing left to read.
+  EXPECT_LT(socket->RecvFromBatch(buffers), 0);
+  EXPECT_TRUE(socket->IsBlocking());
+}
+
+TEST_F(PhysicalSocketTest, RecvFromBatchDropsDatagramsLargerThanBuffer) {
+  MAYBE_SKIP_IPV4;
+  webrtc::testing::StreamSink sink;
+  std::unique_ptr<Socket> socket(server_.CreateSocket(AF_INET, SOCK_DGRAM));
+  ASSERT_EQ(0, socket->Bind(SocketAddress(kIPv4Loopback, 0)));
+  SocketAddress address = socket->GetLocalAddress();
+  sink.Monitor(socket.get());
+
+  socket->SendTo("barbaz", 6, address);
+  socket->SendTo("foo", 3, address);
+  EXPECT_TRUE_WAIT(sink.Check(socket.get(), webrtc::testing::SSE_READ),
+                   kTimeout);
+
+  std::vector<Buffer> payloads(2);
+  std::vector<Socket::ReceiveBuffer> buffers;
+  for (Buffer& payload : payloads) {
+    payload.EnsureCapacity(4);
+    buffers.emplace_back(payload);
+  }
+  ASSERT_EQ(socket->RecvFromBatch(buffers), 2);
+  EXPECT_TRUE(payloads[0].empty());
+  EXPECT_EQ(payloads[1], Buffer("foo", 3));
+}
+#endif  // WEBRTC_LINUX
+
+TEST_F(PhysicalSocketTest, AsyncUdpSocketWithBatchedReceive) {
+  MAYBE_SKIP_IPV4;
+  std::unique_ptr<AsyncUDPSocket> receiver(
+      AsyncUDPSocket::Create(&server_, SocketAddress(kIPv4Loopback, 0)));
+  ASSERT_TRUE(receiver);
+  receiver->SetBatchedReceive(true);
+  std::vector<std::string> received;
+  receiver->RegisterReceivedPacketCallback(
+      [&](AsyncPacketSocket* socket, const ReceivedPacket& packet) {
+        EXPECT_TRUE(packet.arrival_time().has_value());
+        received.emplace_back(
+            reinterpret_cast<const char*>(packet.payload().data()),
+            packet.payload().size());
+      });
+
+  std::unique_ptr<Socket> sender(server_.CreateSocket(AF_INET, SOCK_DGRAM));
+  const SocketAddress address = receiver->GetLocalAddress();
+  // Datagrams of any size are received, as by the unbatched path.
+  const std::string large(10000, 'd');
+  sender->SendTo("a", 1, address);
+  sender->SendTo("bb", 2, address);
+  sender->SendTo(large.data(), large.size(), address);
+  sender->SendTo("ccc", 3, address);
+
+  EXPECT_EQ_WAIT(received.size(), 4u, kTimeout);
+  EXPECT_THAT(received, ::testing::ElementsAre("a", "bb", large, "ccc"));
+}
+
+TEST_F(PhysicalSocketTest, AsyncUdpSocketsShareBatchedReceiveBuffers) {
+  MAYBE_SKIP_IPV4;
+  std::vector<std::unique_ptr<AsyncUDPSocket>> receivers;
+  std::vector<std::string> received;
+  for (int i = 0; i < 2; ++i) {
+    receivers.emplace_back(
+        AsyncUDPSocket::Create(&server_, SocketAddress(kIPv4Loopback, 0)));
+    ASSERT_TRUE(receivers.back());
+    receivers.back()->SetBatchedReceive(true);
+    receivers.back()->RegisterReceivedPacketCallback(
+        [&](AsyncPacketSocket* socket, const ReceivedPacket& packet) {
+          received.emplace_back(
+              reinterpret_cast<const char*>(packet.payload().data()),
+              packet.payload().size());
+        });
+  }
+
+  // Each socket's packets are delivered before the other socket reads into
+  // the same buffers.
+  std::unique_ptr<Socket> sender(server_.CreateSocket(AF_INET, SOCK_DGRAM));
+  sender->SendTo("a", 1, receivers[0]->GetLocalAddress());
+  sender->SendTo("b", 1, receivers[1]->GetLocalAddress());
+  sender->SendTo("aa", 2, receivers[0]->GetLocalAddress());
+  sender->SendTo("bb", 2, receivers[1]->GetLocalAddress());
+  EXPECT_EQ_WAIT(received.size(), 4u, kTimeout);
+  EXPECT_THAT(received,
+              ::testing::UnorderedElementsAre("a", "b", "aa", "bb"));
+
+  // The buffers outlive the first socket for the second one.
+  receivers[0] = nullptr;
+  received.clear();
+  sender->SendTo("bbb", 3, receivers[1]->GetLocalAddress());
+  EXPECT_EQ_WAIT(received.size(), 1u, kTimeout);
+  EXPECT_THAT(received, ::testing::ElementsAre("bbb"));
+}
+
+TEST_F(PhysicalSocketTest, AsyncUdpSocketDeliversPacketsInPooledBuffers) {
+  MAYBE_SKIP_IPV4;
+  scoped_refptr<PacketBufferPool> pool = PacketBufferPool::Create();
+  std::unique_ptr<Socket> sender(server_.CreateSocket(AF_INET, SOCK_DGRAM));
+  for (bool batched_receive : {false, true}) {
+    std::unique_ptr<AsyncUDPSocket> receiver(
+        AsyncUDPSocket::Create(&server_, SocketAddress(kIPv4Loopback, 0)));
+    ASSERT_TRUE(receiver);
+    receiver->SetBatchedReceive(batched_receive);
+    receiver->SetPacketBufferPool(pool);
+    std::vector<CopyOnWriteBuffer> received;
+    receiver->RegisterReceivedPacketCallback(
+        [&](AsyncPacketSocket* socket, const ReceivedPacket& packet) {
+          CopyOnWriteBuffer payload = packet.SharePayload();
+          // The payload is shared rather than copied.
+          EXPECT_EQ(payload.cdata(), packet.payload().data());
+          received.push_back(std::move(payload));
+        });
+
+    sender->SendTo("a", 1, receiver->GetLocalAddress());
+    sender->SendTo("bb", 2, receiver->GetLocalAddress());
+    EXPECT_EQ_WAIT(received.size(), 2u, kTimeout);
+    EXPECT_THAT(received, ::testing::ElementsAre(CopyOnWriteBuffer("a", 1),
+                                                 CopyOnWriteBuffer("bb", 2)));
+    received.clear();
+    EXPECT_GE(pool->free_buffers(), 2u);
+  }
+}
+
+TEST_F(PhysicalSocketTest, SendToBatchSendsDatagramsInOrder) {
+  MAYBE_SKIP_IPV4;
+  std::unique_ptr<Socket> receiver(server_.CreateSocket(AF_INET, SOCK_DGRAM));
+  ASSERT_EQ(0, receiver->Bind(SocketAddress(kIPv4Loopback, 0)));
+  std::unique_ptr<Socket> sender(server_.CreateSocket(AF_INET, SOCK_DGRAM));
+
+  // A run of equally sized packets, which may be sent with GSO, followed by
+  // packets of different sizes.
+  const std::vector<std::string> payloads = {"aaaa", "bbbb", "cccc", "dd",
+                                             "eeeeee", "f"};
+  std::vector<rtc::ArrayView<const uint8_t>> packets;
+  for (const std::string& payload : payloads) {
+    packets.emplace_back(reinterpret_cast<const uint8_t*>(payload.data()),
+                         payload.size());
+  }
+  EXPECT_EQ(sender->SendToBatch(packets, receiver->GetLocalAddress(),
+                                /*ecn_markings=*/{}),
+            static_cast<int>(payloads.size()));
+
+  Buffer buffer;
+  for (const std::string& payload : payloads) {
+    Socket::ReceiveBuffer receive_buffer(buffer);
+    EXPECT_TRUE_WAIT(receiver->RecvFrom(receive_buffer) > 0, kTimeout);
+    EXPECT_EQ(std::string(buffer.data<char>(), buffer.size()), payload);
+  }
+}
+
+TEST_F(PhysicalSocketTest, SendToBatchMarksEachDatagram) {
+  MAYBE_SKIP_IPV4;
+  std::unique_ptr<Socket> receiver(server_.CreateSocket(AF_INET, SOCK_DGRAM));
+  ASSERT_EQ(0, receiver->Bind(SocketAddress(kIPv4Loopback, 0)));
+  receiver->SetOption(Socket::OPT_RECV_ECN, 1);
+  std::unique_ptr<Socket> sender(server_.CreateSocket(AF_INET, SOCK_DGRAM));
+
+  // Equally sized packets, which are split where the marking changes if sent
+  // with GSO.
+  const std::string payload = "aaaa";
+  const std::vector<rtc::ArrayView<const uint8_t>> packets(
+      4, rtc::ArrayView<const uint8_t>(
+             reinterpret_cast<const uint8_t*>(payload.data()),
+             payload.size()));
+  const std::vector<EcnMarking> ecn_markings = {
+      EcnMarking::kEct1, EcnMarking::kEct1, EcnMarking::kNotEct,
+      EcnMarking::kEct1};
+  EXPECT_EQ(
+      sender->SendToBatch(packets, receiver->GetLocalAddress(), ecn_markings),
+      4);
+
+  Buffer buffer;
+  for (EcnMarking ecn : ecn_markings) {
+    Socket::ReceiveBuffer receive_buffer(buffer);
+    EXPECT_TRUE_WAIT(receiver->RecvFrom(receive_buffer) > 0, kTimeout);
+    EXPECT_EQ(receive_buffer.ecn, ecn);
+  }
+#if defined(WEBRTC_LINUX)
+  // The markings are per datagram and leave the socket option untouched.
+  int send_ecn = -1;
+  ASSERT_EQ(0, sender->GetOption(Socket::OPT_SEND_ECN, &send_ecn));
+  EXPECT_EQ(send_ecn, 0);
+#endif
+}
+
+TEST_F(PhysicalSocketTest, AsyncUdpSocketSendsBatchablePacketsTogether) {
+  MAYBE_SKIP_IPV4;
+  std::unique_ptr<Socket> receiver(server_.CreateSocket(AF_INET, SOCK_DGRAM));
+  ASSERT_EQ(0, receiver->Bind(SocketAddress(kIPv4Loopback, 0)));
+  std::unique_ptr<AsyncUDPSocket> sender(
+      AsyncUDPSocket::Create(&server_, SocketAddress(kIPv4Loopback, 0)));
+  ASSERT_TRUE(sender);
+  SentPacketCounter sent_packets;
+  sender->SignalSentPacket.connect(&sent_packets,
+                                   &SentPacketCounter::OnSentPacket);
+
+  PacketOptions options;
+  options.batchable = true;
+  const SocketAddress address = receiver->GetLocalAddress();
+  EXPECT_EQ(sender->SendTo("a", 1, address, options), 1);
+  EXPECT_EQ(sender->SendTo("b", 1, address, options), 1);
+  EXPECT_EQ(sent_packets.count, 0);
+
+  Buffer buffer;
+  Socket::ReceiveBuffer receive_buffer(buffer);
+  EXPECT_LT(receiver->RecvFrom(receive_buffer), 0);
+
+  options.last_packet_in_batch = true;
+  EXPECT_EQ(sender->SendTo("c", 1, address, options), 1);
+  EXPECT_EQ(sent_packets.count, 3);
+  for (const char* payload : {"a", "b", "c"}) {
+    Socket::ReceiveBuffer receive_buffer(buffer);
+    EXPECT_TRUE_WAIT(receiver->RecvFrom(receive_buffer) > 0, kTimeout);
+    EXPECT_EQ(std::string(buffer.data<char>(), buffer.size()), payload);
+  }
+}
+
+TEST_F(PhysicalSocketTest, AsyncUdpSocketFlushesIncompleteBatch) {
+  MAYBE_SKIP_IPV4;
+  std::unique_ptr<Socket> receiver(server_.CreateSocket(AF_INET, SOCK_DGRAM));
+  ASSERT_EQ(0, receiver->Bind(SocketAddress(kIPv4Loopback, 0)));
+  std::unique_ptr<AsyncUDPSocket> sender(
+      AsyncUDPSocket::Create(&server_, SocketAddress(kIPv4Loopback, 0)));
+  ASSERT_TRUE(sender);
+
+  PacketOptions options;
+  options.batchable = true;
+  EXPECT_EQ(sender->SendTo("a", 1, receiver->GetLocalAddress(), options), 1);
+
+  // The batch is sent once the current task completes, even though the last
+  // packet of the batch never arrived.
+  Buffer buffer;
+  Socket::ReceiveBuffer receive_buffer(buffer);
+  EXPECT_TRUE_WAIT(receiver->RecvFrom(receive_buffer) > 0, kTimeout);
+  EXPECT_EQ(std::string(buffer.data<char>(), buffer.size()), "a");
+}
+
+TEST_F(PhysicalSocketTest, AsyncUdpSocketReportsRejectedBatchablePacket) {
+  MAYBE_SKIP_IPV4;
+  std::unique_ptr<Socket> receiver(server_.CreateSocket(AF_INET, SOCK_DGRAM));
+  ASSERT_EQ(0, receiver->Bind(SocketAddress(kIPv4Loopback, 0)));
+  std::unique_ptr<AsyncUDPSocket> sender(
+      AsyncUDPSocket::Create(&server_, SocketAddress(kIPv4Loopback, 0)));
+  ASSERT_TRUE(sender);
+  SentPacketCounter sent_packets;
+  sender->SignalSentPacket.connect(&sent_packets,
+                                   &SentPacketCounter::OnSentPacket);
+
+  // Larger than any UDP datagram.
+  const std::string too_large(70000, 'x');
+  PacketOptions options;
+  options.batchable = true;
+  const SocketAddress address = receiver->GetLocalAddress();
+  EXPECT_EQ(sender->SendTo("a", 1, address, options), 1);
+  EXPECT_EQ(sender->SendTo(too_large.data(), too_large.size(), address,
+                           options),
+            static_cast<int>(too_large.size()));
+  options.last_packet_in_batch = true;
+  EXPECT_LT(sender->SendTo("c", 1, address, options), 0);
+  EXPECT_EQ(sender->GetError(), EMSGSIZE);
+  EXPECT_EQ(sent_packets.count, 2);
+
+  Buffer buffer;
+  for (const char* payload : {"a", "c"}) {
+    Socket::ReceiveBuffer receive_buffer(buffer);
+    EXPECT_TRUE_WAIT(receiver->RecvFrom(receive_buffer) > 0, kTimeout);
+    EXPECT_EQ(std::string(buffer.data<char>(), buffer.size()), payload);
+  }
+}
+
+TEST_F(PhysicalSocketTest, AsyncUdpSocketSendsPacketsWithEcnOfOptions) {
+  MAYBE_SKIP_IPV4;
+  std::unique_ptr<Socket> receiver(server_.CreateSocket(AF_INET, SOCK_DGRAM));
+  ASSERT_EQ(0, receiver->Bind(SocketAddress(kIPv4Loopback, 0)));
+  receiver->SetOption(Socket::OPT_RECV_ECN, 1);
+  std::unique_ptr<AsyncUDPSocket> sender(
+      AsyncUDPSocket::Create(&server_, SocketAddress(kIPv4Loopback, 0)));
+  ASSERT_TRUE(sender);
+
+  // Packets of one batch may be sent with different markings.
+  PacketOptions options;
+  options.batchable = true;
+  options.ecn_1 = true;
+  EXPECT_EQ(sender->SendTo("a", 1, receiver->GetLocalAddress(), options), 1);
+  options.ecn_1 = false;
+  options.last_packet_in_batch = true;
+  EXPECT_EQ(sender->SendTo("b", 1, receiver->GetLocalAddress(), options), 1);
+
+  Buffer buffer;
+  for (EcnMarking ecn : {EcnMarking::kEct1, EcnMarking::kNotEct}) {
+    Socket::ReceiveBuffer receive_buffer(buffer);
+    EXPECT_TRUE_WAIT(receiver->RecvFrom(receive_buffer) > 0, kTimeout);
+    EXPECT_EQ(receive_buffer.ecn, ecn);
+  }
+}
+
 TEST_F(PhysicalSocketTest, UdpSocketRecvTimestampUseRtcEpochIPv4) {
   MAYBE_SKIP_IPV4;
   SocketTest::TestUdpSocketRecvTimestampUseRtcEpochIPv4();
@@ -0,0 +1,189 @@
+/*
+ *  Copyright 2024 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "rtc_base/rtc_certificate_pool.h"
+
+#include <algorithm>
+#include <utility>
+
+#include "api/make_ref_counted.h"
+#include "rtc_base/checks.h"
+#include "rtc_base/logging.h"
+#include "rtc_base/time_utils.h"
+
+namespace rtc {
+
+namespace {
+
+// Pooled certificates that expire sooner than this are discarded, so that a
+// pool that sat idle for a long time does not hand out stale certificates.
+constexpr uint64_t kMinRemainingLifetimeMs = 24 * 60 * 60 * 1000;
+
+// Backoff of the retries after a failed generation.
+constexpr webrtc::TimeDelta kMinRetryDelay = webrtc::TimeDelta::Seconds(1);
+constexpr webrtc::TimeDelta kMaxRetryDelay = webrtc::TimeDelta::Minutes(1);
+
+bool SameKeyParams(const KeyParams& a, const KeyParams& b) {
+  if (a.type() != b.type()) {
+    return false;
+  }
+  if (a.type() == KT_RSA) {
+    return a.rsa_params().mod_size == b.rsa_params().mod_size &&
+           a.rsa_params().pub_exp == b.rsa_params().pub_exp;
+  }
+  return a.ec_curve() == b.ec_curve();
+}
+
+}  // namespace
+
+// static
+scoped_refptr<RTCCertificatePool> RTCCertificatePool::Create(
+    const webrtc::TaskQueueFactory& task_queue_factory,
+    const std::vector<PoolSize>& sizes) {
+  return webrtc::make_ref_counted<RTCCertificatePool>(
+      task_queue_factory, sizes, [](const KeyParams& key_params) {
+        return RTCCertificateGenerator::GenerateCertificate(key_params,
+                                                            absl::nullopt);
+      });
+}
+
+// static
+scoped_refptr<RTCCertificatePool> RTCCertificatePool::CreateForTesting(
+    const webrtc::TaskQueueFactory& task_queue_factory,
+    const std::vector<PoolSize>& sizes,
+    GenerateFunction generate) {
+  return webrtc::make_ref_counted<RTCCertificatePool>(
+      task_queue_factory, sizes, std::move(generate));
+}
+
+RTCCertificatePool::RTCCertificatePool(
+    const webrtc::TaskQueueFactory& task_queue_factory,
+    const std::vector<PoolSize>& sizes,
+    GenerateFunction generate)
+    : generate_(std::move(generate)),
+      task_queue_(task_queue_factory.CreateTaskQueue(
+          "RTCCertificatePool",
+          webrtc::TaskQueueFactory::Priority::LOW)) {
+  for (const PoolSize& size : sizes) {
+    RTC_DCHECK(size.key_params.IsValid());
+    RTC_DCHECK_GE(size.size, 0);
+    entries_.push_back({.key_params = size.key_params,
+                        .size = size.size,
+                        .retry_delay = kMinRetryDelay});
+  }
+  for (Entry& entry : entries_) {
+    for (int i = 0; i < entry.size; ++i) {
+      task_queue_->PostTask([this, entry = &entry] { Refill(entry); });
+    }
+  }
+}
+
+RTCCertificatePool::~RTCCertificatePool() {
+  // Waits for a running refill and drops the pending ones, which refer to
+  // this pool.
+  task_queue_ = nullptr;
+}
+
+scoped_refptr<RTCCertificate> RTCCertificatePool::Take(
+    const KeyParams& key_params) {
+  webrtc::MutexLock lock(&mutex_);
+  Entry* entry = FindEntry(key_params);
+  if (!entry) {
+    return nullptr;
+  }
+  scoped_refptr<RTCCertificate> certificate;
+  uint64_t now_ms = TimeUTCMillis();
+  while (!certificate && !entry->certificates.empty()) {
+    if (!entry->certificates.front()->HasExpired(now_ms +
+                                                 kMinRemainingLifetimeMs)) {
+      certificate = std::move(entry->certificates.front());
+    }
+    entry->certificates.pop_front();
+    task_queue_->PostTask([this, entry] { Refill(entry); });
+  }
+  return certificate;
+}
+
+int RTCCertificatePool::ready_count(const KeyParams& key_params) const {
+  webrtc::MutexLock lock(&mutex_);
+  for (const Entry& entry : entries_) {
+    if (SameKeyParams(entry.key_params, key_params)) {
+      return static_cast<int>(entry.certificates.size());
+    }
+  }
+  return 0;
+}
+
+RTCCertificatePool::Entry* RTCCertificatePool::FindEntry(
+    const KeyParams& key_params) {
+  for (Entry& entry : entries_) {
+    if (SameKeyParams(entry.key_params, key_params)) {
+      return &entry;
+    }
+  }
+  return nullptr;
+}
+
+void RTCCertificatePool::Refill(Entry* entry) {
+  {
+    // Refills run one at a time on `task_queue_`, so the entry cannot fill
+    // up while the certificate is generated.
+    webrtc::MutexLock lock(&mutex_);
+    if (static_cast<int>(entry->certificates.size()) >= entry->size) {
+      return;
+    }
+  }
+  scoped_refptr<RTCCertificate> certificate = generate_(entry->key_params);
+  if (!certificate) {
+    RTC_LOG(LS_ERROR) << "Failed to generate a pooled certificate, retrying in "
+                      << webrtc::ToString(entry->retry_delay) << ".";
+    task_queue_->PostDelayedTask([this, entry] { Refill(entry); },
+                                 entry->retry_delay);
+    entry->retry_delay = std::min(2 * entry->retry_delay, kMaxRetryDelay);
+    return;
+  }
+  entry->retry_delay = kMinRetryDelay;
+  webrtc::MutexLock lock(&mutex_);
+  entry->certificates.push_back(std::move(certificate));
+}
+
+PooledRTCCertificateGenerator::PooledRTCCertificateGenerator(
+    scoped_refptr<RTCCertificatePool> pool,
+    Thread* signaling_thread,
+    Thread* worker_thread)
+    : pool_(std::move(pool)),
+      signaling_thread_(signaling_thread),
+      generator_(signaling_thread, worker_thread) {
+  RTC_DCHECK(pool_);
+}
+
+void PooledRTCCertificateGenerator::GenerateCertificateAsync(
+    const KeyParams& key_params,
+    const absl::optional<uint64_t>& expires_ms,
+    Callback callback) {
+  RTC_DCHECK(signaling_thread_->IsCurrent());
+  RTC_DCHECK(callback);
+  scoped_refptr<RTCCertificate> certificate;
+  if (!expires_ms) {
+    certificate = pool_->Take(key_params);
+  }
+  if (!certificate) {
+    generator_.GenerateCertificateAsync(key_params, expires_ms,
+                                        std::move(callback));
+    return;
+  }
+  // Like RTCCertificateGenerator, never invoke the callback synchronously.
+  signaling_thread_->PostTask(
+      [cert = std::move(certificate), cb = std::move(callback)]() mutable {
+        std::move(cb)(std::move(cert));
+      });
+}
+
+}  // namespace rtc
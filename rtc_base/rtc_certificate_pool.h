@@ -0,0 +1,127 @@
+/*
+ *  Copyright 2024 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef RTC_BASE_RTC_CERTIFICATE_POOL_H_
+#define RTC_BASE_RTC_CERTIFICATE_POOL_H_
+
+#include <stdint.h>
+
+#include <deque>
+#include <memory>
+#include <vector>
+
+#include "absl/functional/any_invocable.h"
+#include "absl/types/optional.h"
+#include "api/ref_count.h"
+#include "api/scoped_refptr.h"
+#include "api/task_queue/task_queue_base.h"
+#include "api/task_queue/task_queue_factory.h"
+#include "api/units/time_delta.h"
+#include "rtc_base/rtc_certificate.h"
+#include "rtc_base/rtc_certificate_generator.h"
+#include "rtc_base/ssl_identity.h"
+#include "rtc_base/synchronization/mutex.h"
+#include "rtc_base/system/rtc_export.h"
+#include "rtc_base/thread.h"
+#include "rtc_base/thread_annotations.h"
+
+namespace rtc {
+
+// Keeps a number of certificates ready for each configured kind of key, so
+// that creating a PeerConnection does not wait for key generation. Taken
+// certificates are replaced on a low priority task queue. The pool is thread
+// safe and can be shared by any number of PeerConnections and factories.
+class RTC_EXPORT RTCCertificatePool : public webrtc::RefCountInterface {
+ public:
+  // The number of certificates to keep ready for one kind of key.
+  struct PoolSize {
+    KeyParams key_params;
+    int size = 0;
+  };
+
+  // Generates a certificate, or returns null on failure.
+  using GenerateFunction =
+      absl::AnyInvocable<scoped_refptr<RTCCertificate>(const KeyParams&)>;
+
+  // Starts generating the certificates in the background.
+  static scoped_refptr<RTCCertificatePool> Create(
+      const webrtc::TaskQueueFactory& task_queue_factory,
+      const std::vector<PoolSize>& sizes);
+  // Like Create(), but generates the certificates with `generate`.
+  static scoped_refptr<RTCCertificatePool> CreateForTesting(
+      const webrtc::TaskQueueFactory& task_queue_factory,
+      const std::vector<PoolSize>& sizes,
+      GenerateFunction generate);
+
+  // Returns a ready certificate with the default expiration time and starts
+  // generating its replacement. Returns null if no certificate with
+  // `key_params` is ready.
+  scoped_refptr<RTCCertificate> Take(const KeyParams& key_params);
+
+  // Returns the number of certificates with `key_params` that are ready.
+  int ready_count(const KeyParams& key_params) const;
+
+ protected:
+  RTCCertificatePool(const webrtc::TaskQueueFactory& task_queue_factory,
+                     const std::vector<PoolSize>& sizes,
+                     GenerateFunction generate);
+  ~RTCCertificatePool() override;
+
+ private:
+  struct Entry {
+    KeyParams key_params;
+    int size;
+    std::deque<scoped_refptr<RTCCertificate>> certificates;
+    // Delay before retrying a failed generation, doubled on each failure.
+    // Only accessed on `task_queue_`.
+    webrtc::TimeDelta retry_delay;
+  };
+
+  Entry* FindEntry(const KeyParams& key_params)
+      RTC_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+  // Generates one certificate for `entry` unless it is full, and tries again
+  // later if that fails. Runs on `task_queue_`.
+  void Refill(Entry* entry);
+
+  // Only called on `task_queue_`.
+  GenerateFunction generate_;
+  mutable webrtc::Mutex mutex_;
+  // Entries are never added or removed after construction, so pointers to
+  // them stay valid.
+  std::vector<Entry> entries_ RTC_GUARDED_BY(mutex_);
+  std::unique_ptr<webrtc::TaskQueueBase, webrtc::TaskQueueDeleter>
+      task_queue_;
+};
+
+// An RTCCertificateGeneratorInterface that hands out certificates from an
+// RTCCertificatePool, and generates them like RTCCertificateGenerator when
+// the pool has none ready or a specific expiration time is requested.
+// Meant to be passed as PeerConnectionDependencies::cert_generator.
+class RTC_EXPORT PooledRTCCertificateGenerator
+    : public RTCCertificateGeneratorInterface {
+ public:
+  PooledRTCCertificateGenerator(scoped_refptr<RTCCertificatePool> pool,
+                                Thread* signaling_thread,
+                                Thread* worker_thread);
+  ~PooledRTCCertificateGenerator() override {}
+
+  void GenerateCertificateAsync(const KeyParams& key_params,
+                                const absl::optional<uint64_t>& expires_ms,
+                                Callback callback) override;
+
+ private:
+  const scoped_refptr<RTCCertificatePool> pool_;
+  Thread* const signaling_thread_;
+  RTCCertificateGenerator generator_;
+};
+
+}  // namespace rtc
+
+#endif  // RTC_BASE_RTC_CERTIFICATE_POOL_H_
@@ -0,0 +1,235 @@
+/*
+ *  Copyright 2024 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "rtc_base/rtc_certificate_pool.h"
+
+#include <memory>
+#include <utility>
+
+#include "absl/strings/string_view.h"
+#include "absl/types/optional.h"
+#include "api/task_queue/task_queue_base.h"
+#include "api/task_queue/task_queue_factory.h"
+#include "api/units/time_delta.h"
+#include "rtc_base/event.h"
+#include "rtc_base/fake_clock.h"
+#include "rtc_base/gunit.h"
+#include "rtc_base/synchronization/mutex.h"
+#include "rtc_base/thread.h"
+#include "rtc_base/thread_annotations.h"
+#include "test/gtest.h"
+
+namespace rtc {
+namespace {
+
+constexpr int kGenerationTimeoutMs = 10000;
+constexpr int kPoolSize = 2;
+
+// Runs task queues on Threads, and remembers the last one so that tests can
+// hold up the refills of a pool.
+class ThreadTaskQueueFactory : public webrtc::TaskQueueFactory {
+ public:
+  std::unique_ptr<webrtc::TaskQueueBase, webrtc::TaskQueueDeleter>
+  CreateTaskQueue(absl::string_view name, Priority priority) const override {
+    std::unique_ptr<Thread> thread = Thread::Create();
+    thread->Start();
+    last_task_queue_ = thread.get();
+    return std::unique_ptr<webrtc::TaskQueueBase, webrtc::TaskQueueDeleter>(
+        thread.release());
+  }
+
+  webrtc::TaskQueueBase* last_task_queue() const { return last_task_queue_; }
+
+ private:
+  mutable webrtc::TaskQueueBase* last_task_queue_ = nullptr;
+};
+
+// Generates certificates like RTCCertificateGenerator unless told to fail,
+// and counts the attempts.
+class FailingGenerator {
+ public:
+  RTCCertificatePool::GenerateFunction AsFunction() {
+    return [this](const KeyParams& key_params) {
+      webrtc::MutexLock lock(&mutex_);
+      ++attempts_;
+      scoped_refptr<RTCCertificate> certificate;
+      if (!fail_) {
+        certificate = RTCCertificateGenerator::GenerateCertificate(
+            key_params, absl::nullopt);
+      }
+      return certificate;
+    };
+  }
+
+  void set_fail(bool fail) {
+    webrtc::MutexLock lock(&mutex_);
+    fail_ = fail;
+  }
+  int attempts() const {
+    webrtc::MutexLock lock(&mutex_);
+    return attempts_;
+  }
+
+ private:
+  mutable webrtc::Mutex mutex_;
+  bool fail_ RTC_GUARDED_BY(mutex_) = true;
+  int attempts_ RTC_GUARDED_BY(mutex_) = 0;
+};
+
+class RTCCertificatePoolTest : public ::testing::Test {
+ protected:
+  RTCCertificatePoolTest() : worker_thread_(Thread::Create()) {
+    worker_thread_->Start();
+  }
+
+  scoped_refptr<RTCCertificatePool> CreatePool(int ecdsa_size) {
+    return RTCCertificatePool::Create(
+        task_queue_factory_,
+        {{.key_params = KeyParams::ECDSA(), .size = ecdsa_size}});
+  }
+
+  // Generates a certificate with `generator` and waits for the callback.
+  scoped_refptr<RTCCertificate> Generate(
+      RTCCertificateGeneratorInterface& generator,
+      const absl::optional<uint64_t>& expires_ms) {
+    bool done = false;
+    scoped_refptr<RTCCertificate> result;
+    generator.GenerateCertificateAsync(
+        KeyParams::ECDSA(), expires_ms,
+        [&](scoped_refptr<RTCCertificate> certificate) {
+          result = std::move(certificate);
+          done = true;
+        });
+    // The callback is never invoked synchronously.
+    EXPECT_FALSE(done);
+    EXPECT_TRUE_WAIT(done, kGenerationTimeoutMs);
+    return result;
+  }
+
+  // Waits until the pool's task queue has finished the running refill, which
+  // schedules the retry of a failed one.
+  void FlushRefills() {
+    Event done;
+    task_queue_factory_.last_task_queue()->PostTask([&] { done.Set(); });
+    ASSERT_TRUE(done.Wait(webrtc::TimeDelta::Millis(kGenerationTimeoutMs)));
+  }
+
+  AutoThread main_thread_;
+  ThreadTaskQueueFactory task_queue_factory_;
+  std::unique_ptr<Thread> worker_thread_;
+};
+
+TEST_F(RTCCertificatePoolTest, FillsInBackground) {
+  scoped_refptr<RTCCertificatePool> pool = CreatePool(kPoolSize);
+  EXPECT_EQ_WAIT(kPoolSize, pool->ready_count(KeyParams::ECDSA()),
+                 kGenerationTimeoutMs);
+  EXPECT_EQ(0, pool->ready_count(KeyParams::RSA()));
+}
+
+TEST_F(RTCCertificatePoolTest, RefillsTakenCertificates) {
+  scoped_refptr<RTCCertificatePool> pool = CreatePool(kPoolSize);
+  ASSERT_EQ_WAIT(kPoolSize, pool->ready_count(KeyParams::ECDSA()),
+                 kGenerationTimeoutMs);
+
+  scoped_refptr<RTCCertificate> first = pool->Take(KeyParams::ECDSA());
+  scoped_refptr<RTCCertificate> second = pool->Take(KeyParams::ECDSA());
+  ASSERT_TRUE(first);
+  ASSERT_TRUE(second);
+  EXPECT_NE(first, second);
+  EXPECT_FALSE(*first == *second);
+
+  EXPECT_EQ_WAIT(kPoolSize, pool->ready_count(KeyParams::ECDSA()),
+                 kGenerationTimeoutMs);
+}
+
+TEST_F(RTCCertificatePoolTest, TakeReturnsNullForKeyTypeNotPooled) {
+  scoped_refptr<RTCCertificatePool> pool = CreatePool(kPoolSize);
+  EXPECT_FALSE(pool->Take(KeyParams::RSA()));
+}
+
+TEST_F(RTCCertificatePoolTest, GeneratorHandsOutPooledCertificate) {
+  scoped_refptr<RTCCertificatePool> pool = CreatePool(kPoolSize);
+  ASSERT_EQ_WAIT(kPoolSize, pool->ready_count(KeyParams::ECDSA()),
+                 kGenerationTimeoutMs);
+  PooledRTCCertificateGenerator generator(pool, Thread::Current(),
+                                          worker_thread_.get());
+
+  // Hold up refills so that the taken certificate is not replaced yet.
+  Event resume_refills;
+  task_queue_factory_.last_task_queue()->PostTask(
+      [&] { resume_refills.Wait(Event::kForever); });
+
+  EXPECT_TRUE(Generate(generator, absl::nullopt));
+  EXPECT_EQ(kPoolSize - 1, pool->ready_count(KeyParams::ECDSA()));
+  resume_refills.Set();
+  EXPECT_EQ_WAIT(kPoolSize, pool->ready_count(KeyParams::ECDSA()),
+                 kGenerationTimeoutMs);
+}
+
+TEST_F(RTCCertificatePoolTest, GeneratorGeneratesCertificateWithExpiration) {
+  scoped_refptr<RTCCertificatePool> pool = CreatePool(kPoolSize);
+  ASSERT_EQ_WAIT(kPoolSize, pool->ready_count(KeyParams::ECDSA()),
+                 kGenerationTimeoutMs);
+  PooledRTCCertificateGenerator generator(pool, Thread::Current(),
+                                          worker_thread_.get());
+
+  EXPECT_TRUE(Generate(generator, /*expires_ms=*/60000));
+  EXPECT_EQ(kPoolSize, pool->ready_count(KeyParams::ECDSA()));
+}
+
+TEST_F(RTCCertificatePoolTest, GeneratorGeneratesCertificateIfPoolIsEmpty) {
+  PooledRTCCertificateGenerator generator(CreatePool(0), Thread::Current(),
+                                          worker_thread_.get());
+  EXPECT_TRUE(Generate(generator, absl::nullopt));
+}
+
+TEST_F(RTCCertificatePoolTest, RetriesFailedGenerationWithBackoff) {
+  // Delayed tasks of the pool's task queue run when the clock is advanced.
+  ScopedFakeClock clock;
+  FailingGenerator generator;
+  scoped_refptr<RTCCertificatePool> pool = RTCCertificatePool::CreateForTesting(
+      task_queue_factory_, {{.key_params = KeyParams::ECDSA(), .size = 1}},
+      generator.AsFunction());
+  ASSERT_EQ_WAIT(1, generator.attempts(), kGenerationTimeoutMs);
+  FlushRefills();
+
+  // The first retry is delayed by a second.
+  clock.AdvanceTime(webrtc::TimeDelta::Millis(999));
+  EXPECT_EQ(1, generator.attempts());
+  clock.AdvanceTime(webrtc::TimeDelta::Millis(1));
+  EXPECT_EQ(2, generator.attempts());
+
+  // The delay doubles on each failure.
+  clock.AdvanceTime(webrtc::TimeDelta::Millis(1999));
+  EXPECT_EQ(2, generator.attempts());
+  clock.AdvanceTime(webrtc::TimeDelta::Millis(1));
+  EXPECT_EQ(3, generator.attempts());
+
+  generator.set_fail(false);
+  clock.AdvanceTime(webrtc::TimeDelta::Millis(3999));
+  EXPECT_EQ(3, generator.attempts());
+  EXPECT_EQ(0, pool->ready_count(KeyParams::ECDSA()));
+  clock.AdvanceTime(webrtc::TimeDelta::Millis(1));
+  EXPECT_EQ(4, generator.attempts());
+  EXPECT_EQ(1, pool->ready_count(KeyParams::ECDSA()));
+
+  // A successful refill resets the delay.
+  generator.set_fail(true);
+  EXPECT_TRUE(pool->Take(KeyParams::ECDSA()));
+  ASSERT_EQ_WAIT(5, generator.attempts(), kGenerationTimeoutMs);
+  FlushRefills();
+  clock.AdvanceTime(webrtc::TimeDelta::Millis(999));
+  EXPECT_EQ(5, generator.attempts());
+  clock.AdvanceTime(webrtc::TimeDelta::Millis(1));
+  EXPECT_EQ(6, generator.attempts());
+}
+
+}  // namespace
+}  // namespace rtc
@@ -13,6 +13,7 @@
 #include <cstdint>
 
 #include "rtc_base/buffer.h"
+#include "rtc_base/checks.h"
 
 namespace rtc {
 
@@ -30,4 +31,40 @@ int Socket::RecvFrom(ReceiveBuffer& buffer) {
   return len;
 }
 
+int Socket::SendToBatch(
+    rtc::ArrayView<const rtc::ArrayView<const uint8_t>> packets,
+    const SocketAddress& addr,
+    rtc::ArrayView<const EcnMarking> ecn_markings) {
+  RTC_DCHECK(ecn_markings.empty() || ecn_markings.size() == packets.size());
+  int socket_ecn = 0;
+  if (!ecn_markings.empty() && GetOption(OPT_SEND_ECN, &socket_ecn) != 0) {
+    socket_ecn = 0;
+  }
+  int ecn = socket_ecn;
+  int sent = static_cast<int>(packets.size());
+  for (size_t i = 0; i < packets.size(); ++i) {
+    if (!ecn_markings.empty() && static_cast<int>(ecn_markings[i]) != ecn) {
+      ecn = static_cast<int>(ecn_markings[i]);
+      SetOption(OPT_SEND_ECN, ecn);
+    }
+    if (SendTo(packets[i].data(), packets[i].size(), addr) < 0) {
+      sent = i > 0 ? static_cast<int>(i) : -1;
+      break;
+    }
+  }
+  if (ecn != socket_ecn) {
+    // Keeps the error of the failed send, if any.
+    const int error = GetError();
+    SetOption(OPT_SEND_ECN, socket_ecn);
+    SetError(error);
+  }
+  return sent;
+}
+
+int Socket::RecvFromBatch(rtc::ArrayView<ReceiveBuffer> buffers) {
+  RTC_DCHECK(!buffers.empty());
+  int len = RecvFrom(buffers[0]);
+  return len < 0 ? len : 1;
+}
+
 }  // namespace rtc
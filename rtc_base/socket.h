@@ -28,6 +28,7 @@
 #include "rtc_base/win32.h"
 #endif
 
+#include "api/array_view.h"
 #include "api/units/timestamp.h"
 #include "rtc_base/buffer.h"
 #include "rtc_base/network/ecn_marking.h"
@@ -112,6 +113,16 @@ class RTC_EXPORT Socket {
   virtual int Connect(const SocketAddress& addr) = 0;
   virtual int Send(const void* pv, size_t cb) = 0;
   virtual int SendTo(const void* pv, size_t cb, const SocketAddress& addr) = 0;
+  // Sends `packets` to `addr` in order, as separate datagrams. Unless
+  // `ecn_markings` is empty, it holds the ECN marking of each packet, which
+  // takes precedence over OPT_SEND_ECN, which is left unchanged. Returns the
+  // number of packets sent, or a negative value if not even the first packet
+  // could be sent. Default implementation calls SendTo() for each packet, and
+  // sets OPT_SEND_ECN where the marking changes, restoring it at the end.
+  virtual int SendToBatch(
+      rtc::ArrayView<const rtc::ArrayView<const uint8_t>> packets,
+      const SocketAddress& addr,
+      rtc::ArrayView<const EcnMarking> ecn_markings);
   // `timestamp` is in units of microseconds.
   virtual int Recv(void* pv, size_t cb, int64_t* timestamp) = 0;
   // TODO(webrtc:15368): Deprecate and remove.
@@ -126,6 +137,11 @@ class RTC_EXPORT Socket {
   // Default implementation calls RecvFrom(void* ...) with 64Kbyte buffer.
   // Returns number of bytes received or a negative value on error.
   virtual int RecvFrom(ReceiveBuffer& buffer);
+  // Receives up to `buffers.size()` datagrams in one call. Each payload is
+  // filled up to its current capacity; datagrams that do not fit are dropped.
+  // Returns the number of buffers filled, or a negative value on error.
+  // Default implementation calls RecvFrom(ReceiveBuffer&) once.
+  virtual int RecvFromBatch(rtc::ArrayView<ReceiveBuffer> buffers);
   virtual int Listen(int backlog) = 0;
   virtual Socket* Accept(SocketAddress* paddr) = 0;
   virtual int Close() = 0;
@@ -153,6 +169,7 @@ class RTC_EXPORT Socket {
     OPT_TCP_KEEPIDLE,      // Set TCP keep alive idle time in seconds
     OPT_TCP_KEEPINTVL,     // Set TCP keep alive interval in seconds
     OPT_TCP_USER_TIMEOUT,  // Set TCP user timeout
+    OPT_REUSEPORT,         // Allow binding several sockets to one address
   };
   virtual int GetOption(Option opt, int* value) = 0;
   virtual int SetOption(Option opt, int value) = 0;
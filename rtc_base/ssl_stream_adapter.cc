@@ -12,6 +12,8 @@
 
 #include "absl/memory/memory.h"
 #include "absl/strings/string_view.h"
+#include "api/make_ref_counted.h"
+#include "rtc_base/openssl_session_cache.h"
 #include "rtc_base/openssl_stream_adapter.h"
 
 namespace rtc {
@@ -71,6 +73,10 @@ bool IsGcmCryptoSuite(int crypto_suite) {
           crypto_suite == kSrtpAeadAes128Gcm);
 }
 
+scoped_refptr<SSLSessionCache> SSLSessionCache::Create() {
+  return make_ref_counted<OpenSSLDtlsSessionCache>();
+}
+
 std::unique_ptr<SSLStreamAdapter> SSLStreamAdapter::Create(
     std::unique_ptr<StreamInterface> stream,
     absl::AnyInvocable<void(SSLHandshakeError)> handshake_error) {
@@ -21,6 +21,8 @@
 #include "absl/functional/any_invocable.h"
 #include "absl/memory/memory.h"
 #include "absl/strings/string_view.h"
+#include "api/ref_count.h"
+#include "api/scoped_refptr.h"
 #include "rtc_base/ssl_certificate.h"
 #include "rtc_base/ssl_identity.h"
 #include "rtc_base/stream.h"
@@ -106,6 +108,27 @@ enum { SSE_MSG_TRUNC = 0xff0001 };
 // Used to send back UMA histogram value. Logged when Dtls handshake fails.
 enum class SSLHandshakeError { UNKNOWN, INCOMPATIBLE_CIPHERSUITE, MAX_VALUE };
 
+// Holds the sessions of completed handshakes so that SSLStreamAdapters
+// sharing the cache can resume them, e.g. all DTLS transports created by one
+// PeerConnectionFactory. A client stores its session keyed by the digests of
+// its own and of the peer's certificate, and offers it the next time it
+// connects to a peer with the same certificates. A server accepts the session
+// tickets issued by any adapter sharing its cache. A resumed handshake skips
+// the key exchange and the certificate messages and completes one round trip
+// earlier; the peer certificate stored in the session is still verified
+// against the signaled digest. The cache is thread safe.
+//
+// Resumed sessions reuse the master secret of the original handshake, so a
+// leaked ticket key compromises all sessions resumed with it. Resumption is
+// therefore opt-in.
+class SSLSessionCache : public webrtc::RefCountInterface {
+ public:
+  static scoped_refptr<SSLSessionCache> Create();
+
+ protected:
+  ~SSLSessionCache() override = default;
+};
+
 class SSLStreamAdapter : public StreamInterface {
  public:
   // Instantiate an SSLStreamAdapter wrapping the given stream,
@@ -146,6 +169,15 @@ class SSLStreamAdapter : public StreamInterface {
   // This should only be called before StartSSL().
   virtual void SetInitialRetransmissionTimeout(int timeout_ms) = 0;
 
+  // Stores the session in `cache` once the handshake completes, and resumes
+  // a session from it if possible. The session of a client is only resumed
+  // if the peer certificate digest is known when the handshake starts.
+  // This should only be called before StartSSL().
+  virtual void SetSessionCache(scoped_refptr<SSLSessionCache> cache) {}
+
+  // Returns true if the established connection resumed a cached session.
+  virtual bool IsSessionResumed() const { return false; }
+
   // StartSSL starts negotiation with a peer, whose certificate is verified
   // using the certificate digest. Generally, SetIdentity() and possibly
   // SetServerRole() should have been called before this.
@@ -0,0 +1,208 @@
+/*
+ *  Copyright 2024 The WebRTC Project Authors. All rights reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef RTC_BASE_SYNCHRONIZATION_MPSC_QUEUE_H_
+#define RTC_BASE_SYNCHRONIZATION_MPSC_QUEUE_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <new>
+#include <type_traits>
+
+#include "rtc_base/system/no_unique_address.h"
+
+namespace webrtc {
+
+template <typename T, typename Deleter = std::default_delete<T>>
+class MpscQueue;
+
+// Base class of the elements of an MpscQueue.
+class MpscQueueNode {
+ public:
+  MpscQueueNode() = default;
+  MpscQueueNode(const MpscQueueNode&) = delete;
+  MpscQueueNode& operator=(const MpscQueueNode&) = delete;
+
+ private:
+  template <typename T, typename Deleter>
+  friend class MpscQueue;
+
+  std::atomic<MpscQueueNode*> next_{nullptr};
+};
+
+// Intrusive lock-free multi-producer single-consumer FIFO queue, after Dmitry
+// Vyukov's design. Push() is wait-free and may be called on any thread; it
+// costs one atomic exchange on the shared end of the queue. Pop() may only be
+// called by one thread at a time and never blocks.
+//
+// Pop() may return null while a Push() on another thread is halfway done, even
+// though empty() already reports the element. The consumer is expected to wait
+// for the pushing thread's wake up signal, or simply try again.
+//
+// T must derive from MpscQueueNode. The queue owns the elements it holds, and
+// destroys them with `Deleter`, e.g. one of an MpscNodePool.
+template <typename T, typename Deleter>
+class MpscQueue {
+ public:
+  explicit MpscQueue(Deleter deleter = Deleter()) : deleter_(deleter) {}
+  ~MpscQueue() {
+    while (Pop() != nullptr) {
+    }
+  }
+
+  MpscQueue(const MpscQueue&) = delete;
+  MpscQueue& operator=(const MpscQueue&) = delete;
+
+  void Push(std::unique_ptr<T, Deleter> element) {
+    static_assert(std::is_base_of_v<MpscQueueNode, T>);
+    PushNode(element.release());
+  }
+
+  std::unique_ptr<T, Deleter> Pop() {
+    MpscQueueNode* tail = tail_.load(std::memory_order_relaxed);
+    MpscQueueNode* next = tail->next_.load(std::memory_order_acquire);
+    if (tail == &stub_) {
+      if (next == nullptr) {
+        return std::unique_ptr<T, Deleter>(nullptr, deleter_);
+      }
+      tail_.store(next, std::memory_order_relaxed);
+      tail = next;
+      next = next->next_.load(std::memory_order_acquire);
+    }
+    if (next == nullptr) {
+      // `tail` is the last element. It can only be handed out once another
+      // node is behind it, so push the stub unless a producer is about to link
+      // its element.
+      if (tail != head_.load(std::memory_order_acquire)) {
+        return std::unique_ptr<T, Deleter>(nullptr, deleter_);
+      }
+      PushNode(&stub_);
+      next = tail->next_.load(std::memory_order_acquire);
+      if (next == nullptr) {
+        return std::unique_ptr<T, Deleter>(nullptr, deleter_);
+      }
+    }
+    tail_.store(next, std::memory_order_relaxed);
+    return std::unique_ptr<T, Deleter>(static_cast<T*>(tail), deleter_);
+  }
+
+  // Returns true if no elements are queued. Exact on the consuming thread,
+  // a snapshot on other threads. Uses sequentially consistent ordering, so a
+  // consumer that announces it is about to sleep and then finds the queue
+  // empty is guaranteed to be seen by later pushers.
+  bool empty() const {
+    return tail_.load(std::memory_order_relaxed) == &stub_ &&
+           head_.load() == &stub_;
+  }
+
+ private:
+  void PushNode(MpscQueueNode* node) {
+    node->next_.store(nullptr, std::memory_order_relaxed);
+    MpscQueueNode* previous = head_.exchange(node);
+    previous->next_.store(node, std::memory_order_release);
+  }
+
+  RTC_NO_UNIQUE_ADDRESS Deleter deleter_;
+  MpscQueueNode stub_;
+  // The end producers push to.
+  std::atomic<MpscQueueNode*> head_{&stub_};
+  // The end the consumer pops from. Only written by the consumer.
+  std::atomic<MpscQueueNode*> tail_{&stub_};
+};
+
+// Recycles the elements of an MpscQueue, so that pushing does not allocate
+// while at most `kCapacity` elements are in use. Further elements are
+// allocated on the heap. Take() may be called on any thread, and elements are
+// returned to the pool, reset to a default constructed T, on whichever thread
+// destroys them. Both are lock-free: free elements are kept in a stack of
+// indices, whose head carries a counter against the ABA problem.
+//
+// The pool must outlive the elements it hands out, so declare it before the
+// queue that holds them.
+template <typename T, size_t kCapacity>
+class MpscNodePool {
+ public:
+  class Recycler {
+   public:
+    explicit Recycler(MpscNodePool* pool) : pool_(pool) {}
+    void operator()(T* element) const { pool_->Recycle(element); }
+
+   private:
+    MpscNodePool* pool_;
+  };
+  using Ptr = std::unique_ptr<T, Recycler>;
+
+  MpscNodePool() : elements_(new T[kCapacity]) {
+    static_assert(kCapacity > 0 && kCapacity < (uint64_t{1} << 32));
+    for (size_t i = 0; i < kCapacity; ++i) {
+      next_free_[i].store(i + 1 < kCapacity ? i + 2 : 0,
+                          std::memory_order_relaxed);
+    }
+  }
+
+  MpscNodePool(const MpscNodePool&) = delete;
+  MpscNodePool& operator=(const MpscNodePool&) = delete;
+
+  Ptr Take() {
+    uint64_t head = free_head_.load(std::memory_order_acquire);
+    while (static_cast<uint32_t>(head) != 0) {
+      const uint32_t index = static_cast<uint32_t>(head) - 1;
+      const uint64_t next =
+          NextCount(head) | next_free_[index].load(std::memory_order_relaxed);
+      if (free_head_.compare_exchange_weak(head, next,
+                                           std::memory_order_acquire)) {
+        return Ptr(&elements_[index], Recycler(this));
+      }
+    }
+    return Ptr(new T(), Recycler(this));
+  }
+
+  Recycler recycler() { return Recycler(this); }
+
+ private:
+  // The head of the free stack holds the index of the top element plus one in
+  // its lower half, zero if the stack is empty, and a counter of the changes in
+  // its upper half.
+  static uint64_t NextCount(uint64_t head) {
+    return ((head >> 32) + 1) << 32;
+  }
+
+  void Recycle(T* element) {
+    T* const begin = elements_.get();
+    if (std::less<T*>()(element, begin) ||
+        !std::less<T*>()(element, begin + kCapacity)) {
+      delete element;
+      return;
+    }
+    element->~T();
+    new (element) T();
+    const uint32_t index = static_cast<uint32_t>(element - begin);
+    uint64_t head = free_head_.load(std::memory_order_relaxed);
+    do {
+      next_free_[index].store(static_cast<uint32_t>(head),
+                              std::memory_order_relaxed);
+    } while (!free_head_.compare_exchange_weak(
+        head, NextCount(head) | (index + 1), std::memory_order_release,
+        std::memory_order_relaxed));
+  }
+
+  const std::unique_ptr<T[]> elements_;
+  // Index plus one of the next free element, for each free element.
+  std::atomic<uint32_t> next_free_[kCapacity];
+  std::atomic<uint64_t> free_head_{1};
+};
+
+}  // namespace webrtc
+
+#endif  // RTC_BASE_SYNCHRONIZATION_MPSC_QUEUE_H_
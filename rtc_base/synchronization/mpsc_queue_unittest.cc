@@ -0,0 +1,179 @@
+/*
+ *  Copyright 2024 The WebRTC Project Authors. All rights reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "rtc_base/synchronization/mpsc_queue.h"
+
+#include <memory>
+#include <set>
+#include <vector>
+
+#include "rtc_base/platform_thread.h"
+#include "test/gtest.h"
+
+namespace webrtc {
+namespace {
+
+struct Element : public MpscQueueNode {
+  Element() = default;
+  Element(int producer, int value) : producer(producer), value(value) {}
+
+  int producer = -1;
+  int value = -1;
+};
+
+std::unique_ptr<Element> MakeElement(int value) {
+  return std::make_unique<Element>(0, value);
+}
+
+TEST(MpscQueueTest, PopsInPushOrder) {
+  MpscQueue<Element> queue;
+  EXPECT_TRUE(queue.empty());
+  EXPECT_EQ(queue.Pop(), nullptr);
+  for (int i = 0; i < 3; ++i) {
+    queue.Push(MakeElement(i));
+  }
+  EXPECT_FALSE(queue.empty());
+  for (int i = 0; i < 3; ++i) {
+    std::unique_ptr<Element> element = queue.Pop();
+    ASSERT_NE(element, nullptr);
+    EXPECT_EQ(element->value, i);
+  }
+  EXPECT_TRUE(queue.empty());
+  EXPECT_EQ(queue.Pop(), nullptr);
+}
+
+TEST(MpscQueueTest, InterleavesPushAndPop) {
+  MpscQueue<Element> queue;
+  queue.Push(MakeElement(1));
+  EXPECT_EQ(queue.Pop()->value, 1);
+  EXPECT_TRUE(queue.empty());
+  queue.Push(MakeElement(2));
+  queue.Push(MakeElement(3));
+  EXPECT_EQ(queue.Pop()->value, 2);
+  EXPECT_FALSE(queue.empty());
+  queue.Push(MakeElement(4));
+  EXPECT_EQ(queue.Pop()->value, 3);
+  EXPECT_EQ(queue.Pop()->value, 4);
+  EXPECT_TRUE(queue.empty());
+}
+
+TEST(MpscQueueTest, DestroysQueuedElements) {
+  struct Counted : public MpscQueueNode {
+    explicit Counted(int* destroyed) : destroyed(destroyed) {}
+    ~Counted() { ++*destroyed; }
+    int* destroyed;
+  };
+  int destroyed = 0;
+  {
+    MpscQueue<Counted> queue;
+    queue.Push(std::make_unique<Counted>(&destroyed));
+    queue.Push(std::make_unique<Counted>(&destroyed));
+  }
+  EXPECT_EQ(destroyed, 2);
+}
+
+TEST(MpscQueueTest, KeepsOrderOfEachProducer) {
+  constexpr int kNumProducers = 4;
+  constexpr int kElementsPerProducer = 20000;
+  MpscQueue<Element> queue;
+  std::vector<rtc::PlatformThread> producers;
+  for (int producer = 0; producer < kNumProducers; ++producer) {
+    producers.push_back(rtc::PlatformThread::SpawnJoinable(
+        [&queue, producer] {
+          for (int i = 0; i < kElementsPerProducer; ++i) {
+            queue.Push(std::make_unique<Element>(producer, i));
+          }
+        },
+        "Producer"));
+  }
+  std::vector<int> next_value(kNumProducers, 0);
+  int received = 0;
+  while (received < kNumProducers * kElementsPerProducer) {
+    std::unique_ptr<Element> element = queue.Pop();
+    if (element == nullptr) {
+      continue;
+    }
+    ASSERT_EQ(element->value, next_value[element->producer]);
+    ++next_value[element->producer];
+    ++received;
+  }
+  producers.clear();
+  EXPECT_TRUE(queue.empty());
+}
+
+TEST(MpscNodePoolTest, ReusesElementsReturnedByTheQueue) {
+  using Pool = MpscNodePool<Element, /*kCapacity=*/2>;
+  Pool pool;
+  MpscQueue<Element, Pool::Recycler> queue(pool.recycler());
+  Pool::Ptr element = pool.Take();
+  Element* const address = element.get();
+  element->value = 1;
+  queue.Push(std::move(element));
+  EXPECT_EQ(queue.Pop()->value, 1);
+
+  element = pool.Take();
+  // The element returned last is handed out first, reset.
+  EXPECT_EQ(element.get(), address);
+  EXPECT_EQ(element->value, -1);
+}
+
+TEST(MpscNodePoolTest, AllocatesBeyondCapacity) {
+  using Pool = MpscNodePool<Element, /*kCapacity=*/2>;
+  Pool pool;
+  std::vector<Pool::Ptr> elements;
+  std::set<Element*> addresses;
+  for (int i = 0; i < 5; ++i) {
+    elements.push_back(pool.Take());
+    addresses.insert(elements.back().get());
+  }
+  EXPECT_EQ(addresses.size(), 5u);
+  elements.clear();
+  for (int i = 0; i < 2; ++i) {
+    elements.push_back(pool.Take());
+    EXPECT_EQ(addresses.count(elements.back().get()), 1u);
+  }
+}
+
+TEST(MpscNodePoolTest, KeepsOrderOfEachProducerWhileRecycling) {
+  constexpr int kNumProducers = 4;
+  constexpr int kElementsPerProducer = 20000;
+  using Pool = MpscNodePool<Element, /*kCapacity=*/16>;
+  Pool pool;
+  MpscQueue<Element, Pool::Recycler> queue(pool.recycler());
+  std::vector<rtc::PlatformThread> producers;
+  for (int producer = 0; producer < kNumProducers; ++producer) {
+    producers.push_back(rtc::PlatformThread::SpawnJoinable(
+        [&pool, &queue, producer] {
+          for (int i = 0; i < kElementsPerProducer; ++i) {
+            Pool::Ptr element = pool.Take();
+            element->producer = producer;
+            element->value = i;
+            queue.Push(std::move(element));
+          }
+        },
+        "Producer"));
+  }
+  std::vector<int> next_value(kNumProducers, 0);
+  int received = 0;
+  while (received < kNumProducers * kElementsPerProducer) {
+    Pool::Ptr element = queue.Pop();
+    if (element == nullptr) {
+      continue;
+    }
+    ASSERT_EQ(element->value, next_value[element->producer]);
+    ++next_value[element->producer];
+    ++received;
+  }
+  producers.clear();
+  EXPECT_TRUE(queue.empty());
+}
+
+}  // namespace
+}  // namespace webrtc
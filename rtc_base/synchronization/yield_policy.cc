@@ -79,4 +79,10 @@ void ScopedYieldPolicy::YieldExecution() {
     current->YieldExecution();
 }
 
+void ScopedYieldPolicy::ResumeExecution() {
+  YieldInterface* current = GetCurrentYieldPolicy();
+  if (current)
+    current->ResumeExecution();
+}
+
 }  // namespace rtc
@@ -15,6 +15,8 @@ class YieldInterface {
  public:
   virtual ~YieldInterface() = default;
   virtual void YieldExecution() = 0;
+  // Called when the wait that followed YieldExecution() returns.
+  virtual void ResumeExecution() {}
 };
 
 // Sets the current thread-local yield policy while it's in scope and reverts
@@ -28,6 +30,9 @@ class ScopedYieldPolicy final {
   // Will yield as specified by the currently active thread-local yield policy
   // (which by default is a no-op).
   static void YieldExecution();
+  // Tells the currently active yield policy that the wait that followed
+  // YieldExecution() has returned.
+  static void ResumeExecution();
 
  private:
   YieldInterface* const previous_;
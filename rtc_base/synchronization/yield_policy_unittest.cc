@@ -21,6 +21,7 @@ namespace {
 class MockYieldHandler : public YieldInterface {
  public:
   MOCK_METHOD(void, YieldExecution, (), (override));
+  MOCK_METHOD(void, ResumeExecution, (), (override));
 };
 }  // namespace
 TEST(YieldPolicyTest, HandlerReceivesYieldSignalWhenSet) {
@@ -28,6 +29,7 @@ TEST(YieldPolicyTest, HandlerReceivesYieldSignalWhenSet) {
   {
     Event event;
     EXPECT_CALL(handler, YieldExecution()).Times(1);
+    EXPECT_CALL(handler, ResumeExecution()).Times(1);
     ScopedYieldPolicy policy(&handler);
     event.Set();
     event.Wait(Event::kForever);
@@ -35,6 +37,7 @@ TEST(YieldPolicyTest, HandlerReceivesYieldSignalWhenSet) {
   {
     Event event;
     EXPECT_CALL(handler, YieldExecution()).Times(0);
+    EXPECT_CALL(handler, ResumeExecution()).Times(0);
     event.Set();
     event.Wait(Event::kForever);
   }
@@ -46,6 +49,7 @@ TEST(YieldPolicyTest, IsThreadLocal) {
     ::testing::StrictMock<MockYieldHandler> local_handler;
     // The local handler is never called as we never Wait on this thread.
     EXPECT_CALL(local_handler, YieldExecution()).Times(0);
+    EXPECT_CALL(local_handler, ResumeExecution()).Times(0);
     ScopedYieldPolicy policy(&local_handler);
     events[0].Set();
     events[1].Set();
@@ -61,6 +65,7 @@ TEST(YieldPolicyTest, IsThreadLocal) {
   // We can set a policy that's active on this thread independently.
   ::testing::StrictMock<MockYieldHandler> main_handler;
   EXPECT_CALL(main_handler, YieldExecution()).Times(1);
+  EXPECT_CALL(main_handler, ResumeExecution()).Times(1);
   ScopedYieldPolicy policy(&main_handler);
   events[2].Wait(Event::kForever);
   other_thread.join();
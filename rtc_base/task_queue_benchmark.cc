@@ -0,0 +1,127 @@
+/*
+ *  Copyright 2024 The WebRTC Project Authors. All rights reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <atomic>
+#include <memory>
+#include <vector>
+
+#include "api/task_queue/task_queue_base.h"
+#include "api/task_queue/task_queue_factory.h"
+#include "api/units/time_delta.h"
+#include "benchmark/benchmark.h"
+#include "rtc_base/event.h"
+#include "rtc_base/system/unused.h"
+#include "rtc_base/task_queue_stdlib.h"
+#include "rtc_base/task_queue_thread_pool.h"
+
+#if defined(WEBRTC_ENABLE_LIBEVENT)
+#include "rtc_base/task_queue_libevent.h"
+#endif
+
+namespace webrtc {
+namespace {
+
+using TaskQueueFactoryCreator = std::unique_ptr<TaskQueueFactory> (*)();
+
+constexpr int kTasksPerIteration = 1000;
+
+std::unique_ptr<TaskQueueFactory> CreateThreadPoolFactory() {
+  return CreateTaskQueueThreadPoolFactory(/*num_threads=*/4);
+}
+
+std::vector<std::unique_ptr<TaskQueueBase, TaskQueueDeleter>> CreateQueues(
+    TaskQueueFactory& factory,
+    int num_queues) {
+  std::vector<std::unique_ptr<TaskQueueBase, TaskQueueDeleter>> queues;
+  for (int i = 0; i < num_queues; ++i) {
+    queues.push_back(
+        factory.CreateTaskQueue("Bench", TaskQueueFactory::Priority::NORMAL));
+  }
+  return queues;
+}
+
+// Posts `kTasksPerIteration` tasks spread over `state.range(0)` task queues
+// and waits for all of them to run.
+void BM_PostTaskThroughput(benchmark::State& state,
+                           TaskQueueFactoryCreator create_factory) {
+  std::unique_ptr<TaskQueueFactory> factory = create_factory();
+  auto queues = CreateQueues(*factory, state.range(0));
+  std::atomic<int> remaining{0};
+  rtc::Event done;
+  for (auto s : state) {
+    RTC_UNUSED(s);
+    remaining = kTasksPerIteration;
+    for (int i = 0; i < kTasksPerIteration; ++i) {
+      queues[i % queues.size()]->PostTask([&] {
+        if (--remaining == 0) {
+          done.Set();
+        }
+      });
+    }
+    done.Wait(rtc::Event::kForever);
+  }
+  state.SetItemsProcessed(state.iterations() * kTasksPerIteration);
+}
+
+// Measures the time for a task to hop from one task queue to another and back
+// while `state.range(0)` task queues exist, most of them idle.
+void BM_PostTaskRoundTrip(benchmark::State& state,
+                          TaskQueueFactoryCreator create_factory) {
+  std::unique_ptr<TaskQueueFactory> factory = create_factory();
+  auto queues = CreateQueues(*factory, state.range(0));
+  TaskQueueBase* ping = queues.front().get();
+  TaskQueueBase* pong = queues.back().get();
+  rtc::Event done;
+  for (auto s : state) {
+    RTC_UNUSED(s);
+    ping->PostTask([&] {
+      pong->PostTask([&] { ping->PostTask([&] { done.Set(); }); });
+    });
+    done.Wait(rtc::Event::kForever);
+  }
+}
+
+BENCHMARK_CAPTURE(BM_PostTaskThroughput, stdlib, &CreateTaskQueueStdlibFactory)
+    ->Arg(1)
+    ->Arg(16)
+    ->Arg(256)
+    ->UseRealTime();
+BENCHMARK_CAPTURE(BM_PostTaskThroughput, thread_pool, &CreateThreadPoolFactory)
+    ->Arg(1)
+    ->Arg(16)
+    ->Arg(256)
+    ->UseRealTime();
+BENCHMARK_CAPTURE(BM_PostTaskRoundTrip, stdlib, &CreateTaskQueueStdlibFactory)
+    ->Arg(2)
+    ->Arg(256)
+    ->UseRealTime();
+BENCHMARK_CAPTURE(BM_PostTaskRoundTrip, thread_pool, &CreateThreadPoolFactory)
+    ->Arg(2)
+    ->Arg(256)
+    ->UseRealTime();
+
+#if defined(WEBRTC_ENABLE_LIBEVENT)
+BENCHMARK_CAPTURE(BM_PostTaskThroughput,
+                  libevent,
+                  &CreateTaskQueueLibeventFactory)
+    ->Arg(1)
+    ->Arg(16)
+    ->Arg(256)
+    ->UseRealTime();
+BENCHMARK_CAPTURE(BM_PostTaskRoundTrip,
+                  libevent,
+                  &CreateTaskQueueLibeventFactory)
+    ->Arg(2)
+    ->Arg(256)
+    ->UseRealTime();
+#endif
+
+}  // namespace
+}  // namespace webrtc
@@ -13,7 +13,7 @@
 #include <string.h>
 
 #include <algorithm>
-#include <map>
+#include <atomic>
 #include <memory>
 #include <queue>
 #include <utility>
@@ -22,13 +22,13 @@
 #include "absl/strings/string_view.h"
 #include "api/task_queue/task_queue_base.h"
 #include "api/units/time_delta.h"
+#include "api/units/timestamp.h"
 #include "rtc_base/checks.h"
 #include "rtc_base/event.h"
 #include "rtc_base/logging.h"
-#include "rtc_base/numerics/divide_round.h"
 #include "rtc_base/platform_thread.h"
-#include "rtc_base/synchronization/mutex.h"
-#include "rtc_base/thread_annotations.h"
+#include "rtc_base/synchronization/mpsc_queue.h"
+#include "rtc_base/task_utils/timing_wheel.h"
 #include "rtc_base/time_utils.h"
 
 namespace webrtc {
@@ -65,16 +65,16 @@ class TaskQueueStdlib final : public TaskQueueBase {
  private:
   using OrderId = uint64_t;
 
-  struct DelayedEntryTimeout {
-    // TODO(bugs.webrtc.org/13756): Migrate to Timestamp.
-    int64_t next_fire_at_us{};
-    OrderId order{};
-
-    bool operator<(const DelayedEntryTimeout& o) const {
-      return std::tie(next_fire_at_us, order) <
-             std::tie(o.next_fire_at_us, o.order);
-    }
+  // A task posted to the worker thread, which sorts it into `pending_queue_`
+  // or `delayed_queue_` on arrival.
+  struct IncomingTask : public MpscQueueNode {
+    absl::AnyInvocable<void() &&> task;
+    // MinusInfinity() for tasks to run right away.
+    Timestamp run_at = Timestamp::MinusInfinity();
   };
+  // IncomingTasks are recycled once the worker thread has sorted them, so few
+  // are in use at a time.
+  using IncomingTaskPool = MpscNodePool<IncomingTask, /*kCapacity=*/64>;
 
   struct NextTask {
     bool final_task = false;
@@ -90,33 +90,42 @@ class TaskQueueStdlib final : public TaskQueueBase {
 
   void ProcessTasks();
 
+  void PostIncomingTask(IncomingTaskPool::Ptr incoming);
+
   void NotifyWake();
 
   // Signaled whenever a new task is pending.
   rtc::Event flag_notify_;
 
-  Mutex pending_lock_;
+  // Set while the worker thread is about to wait on, or waiting on,
+  // `flag_notify_`.
+  std::atomic<bool> waiting_{false};
 
   // Indicates if the worker thread needs to shutdown now.
-  bool thread_should_quit_ RTC_GUARDED_BY(pending_lock_) = false;
+  std::atomic<bool> thread_should_quit_{false};
+
+  // Tasks posted from any thread that the worker thread has not picked up
+  // yet. Posting does not take a lock, nor allocate unless many tasks are
+  // posted at once.
+  IncomingTaskPool incoming_pool_;
+  MpscQueue<IncomingTask, IncomingTaskPool::Recycler> incoming_queue_{
+      incoming_pool_.recycler()};
+
+  // The members below are only accessed on the worker thread.
 
   // Holds the next order to use for the next task to be
   // put into one of the pending queues.
-  OrderId thread_posting_order_ RTC_GUARDED_BY(pending_lock_) = 0;
+  OrderId thread_posting_order_ = 0;
 
   // The list of all pending tasks that need to be processed in the
   // FIFO queue ordering on the worker thread.
-  std::queue<std::pair<OrderId, absl::AnyInvocable<void() &&>>> pending_queue_
-      RTC_GUARDED_BY(pending_lock_);
+  std::queue<std::pair<OrderId, absl::AnyInvocable<void() &&>>> pending_queue_;
 
   // The list of all pending tasks that need to be processed at a future
   // time based upon a delay. On the off change the delayed task should
   // happen at exactly the same time interval as another task then the
-  // task is processed based on FIFO ordering. std::priority_queue was
-  // considered but rejected due to its inability to extract the
-  // move-only value out of the queue without the presence of a hack.
-  std::map<DelayedEntryTimeout, absl::AnyInvocable<void() &&>> delayed_queue_
-      RTC_GUARDED_BY(pending_lock_);
+  // task is processed based on FIFO ordering.
+  TimingWheel delayed_queue_;
 
   // Contains the active worker thread assigned to processing
   // tasks (including delayed tasks).
@@ -150,10 +159,7 @@ rtc::PlatformThread TaskQueueStdlib::InitializeThread(
 void TaskQueueStdlib::Delete() {
   RTC_DCHECK(!IsCurrent());
 
-  {
-    MutexLock lock(&pending_lock_);
-    thread_should_quit_ = true;
-  }
+  thread_should_quit_.store(true, std::memory_order_release);
 
   NotifyWake();
 
@@ -163,29 +169,28 @@ void TaskQueueStdlib::Delete() {
 void TaskQueueStdlib::PostTaskImpl(absl::AnyInvocable<void() &&> task,
                                    const PostTaskTraits& traits,
                                    const Location& location) {
-  {
-    MutexLock lock(&pending_lock_);
-    pending_queue_.push(
-        std::make_pair(++thread_posting_order_, std::move(task)));
-  }
-
-  NotifyWake();
+  IncomingTaskPool::Ptr incoming = incoming_pool_.Take();
+  incoming->task = std::move(task);
+  PostIncomingTask(std::move(incoming));
 }
 
 void TaskQueueStdlib::PostDelayedTaskImpl(absl::AnyInvocable<void() &&> task,
                                           TimeDelta delay,
                                           const PostDelayedTaskTraits& traits,
                                           const Location& location) {
-  DelayedEntryTimeout delayed_entry;
-  delayed_entry.next_fire_at_us = rtc::TimeMicros() + delay.us();
+  IncomingTaskPool::Ptr incoming = incoming_pool_.Take();
+  incoming->task = std::move(task);
+  incoming->run_at = Timestamp::Micros(rtc::TimeMicros()) + delay;
+  PostIncomingTask(std::move(incoming));
+}
 
-  {
-    MutexLock lock(&pending_lock_);
-    delayed_entry.order = ++thread_posting_order_;
-    delayed_queue_[delayed_entry] = std::move(task);
+void TaskQueueStdlib::PostIncomingTask(IncomingTaskPool::Ptr incoming) {
+  incoming_queue_.Push(std::move(incoming));
+  // Only signal when the worker thread may be waiting, this saves a system
+  // call per task while the worker thread is busy.
+  if (waiting_.load()) {
+    NotifyWake();
   }
-
-  NotifyWake();
 }
 
 TaskQueueStdlib::NextTask TaskQueueStdlib::GetNextTask() {
@@ -193,36 +198,43 @@ TaskQueueStdlib::NextTask TaskQueueStdlib::GetNextTask() {
 
   const int64_t tick_us = rtc::TimeMicros();
 
-  MutexLock lock(&pending_lock_);
-
-  if (thread_should_quit_) {
+  if (thread_should_quit_.load(std::memory_order_acquire)) {
     result.final_task = true;
     return result;
   }
 
-  if (delayed_queue_.size() > 0) {
-    auto delayed_entry = delayed_queue_.begin();
-    const auto& delay_info = delayed_entry->first;
-    auto& delay_run = delayed_entry->second;
-    if (tick_us >= delay_info.next_fire_at_us) {
+  // Sort newly posted tasks into the pending queues, keeping the order in
+  // which they were posted.
+  while (IncomingTaskPool::Ptr incoming = incoming_queue_.Pop()) {
+    OrderId order = ++thread_posting_order_;
+    if (incoming->run_at.IsMinusInfinity()) {
+      pending_queue_.push(std::make_pair(order, std::move(incoming->task)));
+    } else {
+      delayed_queue_.Schedule(Timestamp::Micros(tick_us), incoming->run_at,
+                              order, std::move(incoming->task));
+    }
+  }
+
+  if (!delayed_queue_.empty()) {
+    delayed_queue_.Advance(Timestamp::Micros(tick_us));
+    if (delayed_queue_.has_ready_task()) {
       if (pending_queue_.size() > 0) {
         auto& entry = pending_queue_.front();
         auto& entry_order = entry.first;
         auto& entry_run = entry.second;
-        if (entry_order < delay_info.order) {
+        if (entry_order < delayed_queue_.next_ready_order()) {
           result.run_task = std::move(entry_run);
           pending_queue_.pop();
           return result;
         }
       }
 
-      result.run_task = std::move(delay_run);
-      delayed_queue_.erase(delayed_entry);
+      result.run_task = delayed_queue_.PopReadyTask();
       return result;
     }
 
-    result.sleep_time = TimeDelta::Millis(
-        DivideRoundUp(delay_info.next_fire_at_us - tick_us, 1'000));
+    result.sleep_time =
+        delayed_queue_.NextRunTime() - Timestamp::Micros(tick_us);
   }
 
   if (pending_queue_.size() > 0) {
@@ -249,21 +261,22 @@ void TaskQueueStdlib::ProcessTasks() {
       continue;
     }
 
-    flag_notify_.Wait(task.sleep_time);
+    // Announce the wait before looking for new tasks a last time: a task
+    // posted concurrently is either seen here, or its poster sees `waiting_`
+    // set and signals `flag_notify_`.
+    waiting_.store(true);
+    if (incoming_queue_.empty()) {
+      flag_notify_.Wait(task.sleep_time);
+    }
+    waiting_.store(false, std::memory_order_relaxed);
   }
 
   // Ensure remaining deleted tasks are destroyed with Current() set up to this
   // task queue.
-  std::queue<std::pair<OrderId, absl::AnyInvocable<void() &&>>> pending_queue;
-  {
-    MutexLock lock(&pending_lock_);
-    pending_queue_.swap(pending_queue);
+  while (incoming_queue_.Pop() != nullptr) {
   }
-  pending_queue = {};
-#if RTC_DCHECK_IS_ON
-  MutexLock lock(&pending_lock_);
-  RTC_DCHECK(pending_queue_.empty());
-#endif
+  pending_queue_ = {};
+  delayed_queue_.Clear();
 }
 
 void TaskQueueStdlib::NotifyWake() {
@@ -277,13 +290,14 @@ void TaskQueueStdlib::NotifyWake() {
   // wait on flag_notify_ until signaled that a task has been added (or the
   // thread to be told to shutdown).
 
-  // In all cases, when a new immediate task, delayed task, or request to
-  // shutdown the thread is added the flag_notify_ is signaled after. If the
-  // thread was waiting then the thread will wake up immediately and re-assess
-  // what task needs to be run next (i.e. run a task now, wait for the nearest
-  // timed delayed task, or shutdown the thread). If the thread was not waiting
-  // then the thread will remained signaled to wake up the next time any
-  // attempt to wait on the flag_notify_ event occurs.
+  // When a new immediate task, delayed task, or request to shutdown the
+  // thread is added the flag_notify_ is signaled after, unless `waiting_`
+  // shows that the thread is busy and will look for new tasks before it
+  // waits. If the thread was waiting then the thread will wake up immediately
+  // and re-assess what task needs to be run next (i.e. run a task now, wait
+  // for the nearest timed delayed task, or shutdown the thread). If the thread
+  // was not waiting then the thread will remained signaled to wake up the next
+  // time any attempt to wait on the flag_notify_ event occurs.
 
   // Any immediate or delayed pending task (or request to shutdown the thread)
   // must always be added to the queue prior to signaling flag_notify_ to wake
@@ -0,0 +1,676 @@
+/*
+ *  Copyright 2024 The WebRTC Project Authors. All rights reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "rtc_base/task_queue_thread_pool.h"
+
+#include <algorithm>
+#include <atomic>
+#include <deque>
+#include <functional>
+#include <limits>
+#include <map>
+#include <memory>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include "absl/base/attributes.h"
+#include "absl/container/inlined_vector.h"
+#include "absl/functional/any_invocable.h"
+#include "absl/strings/string_view.h"
+#include "api/scoped_refptr.h"
+#include "api/task_queue/task_queue_base.h"
+#include "api/units/time_delta.h"
+#include "rtc_base/checks.h"
+#include "rtc_base/event.h"
+#include "rtc_base/logging.h"
+#include "rtc_base/numerics/divide_round.h"
+#include "rtc_base/platform_thread.h"
+#include "rtc_base/ref_count.h"
+#include "rtc_base/ref_counter.h"
+#include "rtc_base/synchronization/mutex.h"
+#include "rtc_base/synchronization/yield_policy.h"
+#include "rtc_base/thread_annotations.h"
+#include "rtc_base/time_utils.h"
+
+namespace webrtc {
+namespace {
+
+// Maximum number of tasks run from one task queue before its worker moves on,
+// so that a busy task queue can't starve the others.
+constexpr int kMaxTasksPerSlice = 32;
+
+constexpr int64_t kNoTimer = std::numeric_limits<int64_t>::max();
+
+// Upper bound on the workers started in addition to the requested ones, while
+// all workers are blocked in tasks that wait for other task queues.
+constexpr int kMaxExtraWorkers = 32;
+
+class Scheduler;
+class ThreadPoolTaskQueue;
+
+struct Worker final : public rtc::YieldInterface {
+  // Called when the task being run is about to block on an rtc::Event, and
+  // when the wait returns.
+  void YieldExecution() override;
+  void ResumeExecution() override;
+
+  Scheduler* scheduler = nullptr;
+  size_t index = 0;
+  // Set while the task being run is blocked. Only accessed by the worker.
+  bool blocked = false;
+  // Signaled to wake the worker up when it is parked.
+  rtc::Event wake;
+  Mutex lock;
+  // Task queues with tasks to run. The worker takes them from the front, other
+  // workers steal from the back.
+  std::deque<rtc::scoped_refptr<ThreadPoolTaskQueue>> runnable
+      RTC_GUARDED_BY(lock);
+  rtc::PlatformThread thread;
+};
+
+// The worker running on the current thread, if any.
+ABSL_CONST_INIT thread_local Worker* current_worker = nullptr;
+
+class ThreadPoolTaskQueue final : public TaskQueueBase {
+ public:
+  ThreadPoolTaskQueue(rtc::scoped_refptr<Scheduler> scheduler,
+                      bool high_priority)
+      : scheduler_(std::move(scheduler)), high_priority_(high_priority) {}
+
+  void AddRef() const { ref_count_.IncRef(); }
+  RefCountReleaseStatus Release() const {
+    const RefCountReleaseStatus status = ref_count_.DecRef();
+    if (status == RefCountReleaseStatus::kDroppedLastRef) {
+      delete this;
+    }
+    return status;
+  }
+
+  void Delete() override;
+
+  bool high_priority() const { return high_priority_; }
+
+  // Runs up to kMaxTasksPerSlice tasks. Returns true if tasks remain, in which
+  // case the caller must schedule the task queue again.
+  bool RunTasks();
+  // Moves the delayed task `id` to the back of the task queue.
+  void OnTimer(uint64_t id);
+
+ protected:
+  void PostTaskImpl(absl::AnyInvocable<void() &&> task,
+                    const PostTaskTraits& traits,
+                    const Location& location) override;
+  void PostDelayedTaskImpl(absl::AnyInvocable<void() &&> task,
+                           TimeDelta delay,
+                           const PostDelayedTaskTraits& traits,
+                           const Location& location) override;
+
+ private:
+  enum class State {
+    // No tasks to run.
+    kIdle,
+    // Waiting in the runnable queue of a worker.
+    kScheduled,
+    // A worker is running tasks.
+    kRunning,
+  };
+
+  ~ThreadPoolTaskQueue() override = default;
+
+  // Destroys `task` as if it had been posted and never run.
+  void DropTask(absl::AnyInvocable<void() &&> task);
+
+  // Keeps the workers running until Delete(), after which the scheduler is not
+  // used anymore. Posts use it while holding `lock_`, so that Delete() can't
+  // release it, or the last reference to this task queue, meanwhile.
+  rtc::scoped_refptr<Scheduler> scheduler_ RTC_GUARDED_BY(lock_);
+  const bool high_priority_;
+  // Starts with the reference owned by the creator, released by Delete().
+  mutable webrtc_impl::RefCounter ref_count_{1};
+
+  Mutex lock_;
+  State state_ RTC_GUARDED_BY(lock_) = State::kIdle;
+  bool deleted_ RTC_GUARDED_BY(lock_) = false;
+  // Signaled when the worker stops running tasks of a deleted task queue.
+  rtc::Event* stopped_ RTC_GUARDED_BY(lock_) = nullptr;
+  std::deque<absl::AnyInvocable<void() &&>> tasks_ RTC_GUARDED_BY(lock_);
+  uint64_t next_delayed_task_id_ RTC_GUARDED_BY(lock_) = 0;
+  std::map<uint64_t, absl::AnyInvocable<void() &&>> delayed_tasks_
+      RTC_GUARDED_BY(lock_);
+};
+
+// Owns the workers. Referenced by the factory and by each task queue that has
+// not been deleted, so that task queues may outlive the factory.
+class Scheduler {
+ public:
+  explicit Scheduler(int num_threads);
+
+  void AddRef() const { ref_count_.IncRef(); }
+  // Stops and joins the workers when the last reference is released.
+  void Release() const;
+
+  // Hands `queue`, which has tasks to run, to a worker. Task queues scheduled
+  // from a worker go to that worker, those scheduled from other threads to
+  // whichever worker picks them up first.
+  void Schedule(rtc::scoped_refptr<ThreadPoolTaskQueue> queue);
+  // Calls `queue->OnTimer(id)` once `fire_at_us` has passed.
+  void AddTimer(int64_t fire_at_us,
+                rtc::scoped_refptr<ThreadPoolTaskQueue> queue,
+                uint64_t id);
+  // Called when a task running on a worker blocks. If all workers are blocked,
+  // the task queues their tasks wait for may never run, so another worker is
+  // started.
+  void OnWorkerBlocked();
+  void OnWorkerUnblocked();
+
+ private:
+  struct Timer {
+    int64_t fire_at_us;
+    uint64_t order;
+    rtc::scoped_refptr<ThreadPoolTaskQueue> queue;
+    uint64_t id;
+
+    // Orders `timers_` as a min-heap.
+    bool operator<(const Timer& o) const {
+      return std::tie(fire_at_us, order) > std::tie(o.fire_at_us, o.order);
+    }
+  };
+
+  ~Scheduler();
+
+  void StartWorker() RTC_EXCLUSIVE_LOCKS_REQUIRED(idle_lock_);
+  void RunWorker(Worker* worker);
+  rtc::scoped_refptr<ThreadPoolTaskQueue> FindWork(Worker* worker);
+  void FireDueTimers();
+  // Waits until there might be work for `worker`. Returns false if the worker
+  // should exit.
+  bool Park(Worker* worker);
+  // Wakes up a parked worker, if there is one.
+  void WakeWorker();
+  // Wakes up the worker waiting for the next timer, or any parked worker if
+  // none is.
+  void WakeTimerWaiter();
+
+  mutable webrtc_impl::RefCounter ref_count_{0};
+
+  // Allocated up front, including the extra workers, so that other workers can
+  // steal from the first `num_started_workers_` without locking.
+  std::vector<std::unique_ptr<Worker>> workers_;
+  std::atomic<size_t> num_started_workers_{0};
+
+  // Task queues scheduled from threads that are not workers.
+  Mutex injected_lock_;
+  std::deque<rtc::scoped_refptr<ThreadPoolTaskQueue>> injected_
+      RTC_GUARDED_BY(injected_lock_);
+  // Number of task queues waiting in `injected_` and in the workers' runnable
+  // queues.
+  std::atomic<int> num_runnable_{0};
+
+  Mutex idle_lock_;
+  std::vector<Worker*> parked_workers_ RTC_GUARDED_BY(idle_lock_);
+  // Parked worker that wakes up for the next timer.
+  Worker* timer_waiter_ RTC_GUARDED_BY(idle_lock_) = nullptr;
+  bool quit_ RTC_GUARDED_BY(idle_lock_) = false;
+  int num_blocked_workers_ RTC_GUARDED_BY(idle_lock_) = 0;
+
+  Mutex timer_lock_;
+  std::vector<Timer> timers_ RTC_GUARDED_BY(timer_lock_);
+  uint64_t next_timer_order_ RTC_GUARDED_BY(timer_lock_) = 0;
+  // Fire time of the earliest timer, readable without `timer_lock_`.
+  std::atomic<int64_t> next_timer_us_{kNoTimer};
+};
+
+void ThreadPoolTaskQueue::Delete() {
+  RTC_DCHECK(!IsCurrent());
+  rtc::Event stopped;
+  bool running;
+  {
+    MutexLock lock(&lock_);
+    deleted_ = true;
+    running = state_ == State::kRunning;
+    if (running) {
+      stopped_ = &stopped;
+    }
+  }
+  if (running) {
+    stopped.Wait(rtc::Event::kForever);
+  }
+
+  // No task is running and none will start, so the pending tasks can be
+  // destroyed here. Scheduled task queues and timers keep a reference until
+  // they are done with this task queue.
+  std::deque<absl::AnyInvocable<void() &&>> tasks;
+  std::map<uint64_t, absl::AnyInvocable<void() &&>> delayed_tasks;
+  {
+    MutexLock lock(&lock_);
+    tasks.swap(tasks_);
+    delayed_tasks.swap(delayed_tasks_);
+  }
+  {
+    CurrentTaskQueueSetter set_current(this);
+    tasks.clear();
+    delayed_tasks.clear();
+  }
+  rtc::scoped_refptr<Scheduler> scheduler;
+  {
+    MutexLock lock(&lock_);
+    scheduler = std::move(scheduler_);
+  }
+  // Releasing the last reference joins the workers, so not under `lock_`.
+  scheduler = nullptr;
+  Release();
+}
+
+bool ThreadPoolTaskQueue::RunTasks() {
+  {
+    MutexLock lock(&lock_);
+    if (deleted_) {
+      state_ = State::kIdle;
+      return false;
+    }
+    RTC_DCHECK(state_ == State::kScheduled);
+    state_ = State::kRunning;
+  }
+  for (int i = 0; i < kMaxTasksPerSlice; ++i) {
+    absl::AnyInvocable<void() &&> task;
+    {
+      MutexLock lock(&lock_);
+      if (deleted_ || tasks_.empty()) {
+        break;
+      }
+      task = std::move(tasks_.front());
+      tasks_.pop_front();
+    }
+    CurrentTaskQueueSetter set_current(this);
+    std::move(task)();
+    // Destroy the task while Current() still points to this task queue.
+    task = nullptr;
+  }
+
+  MutexLock lock(&lock_);
+  if (deleted_) {
+    state_ = State::kIdle;
+    if (stopped_) {
+      stopped_->Set();
+      stopped_ = nullptr;
+    }
+    return false;
+  }
+  if (tasks_.empty()) {
+    state_ = State::kIdle;
+    return false;
+  }
+  state_ = State::kScheduled;
+  return true;
+}
+
+void ThreadPoolTaskQueue::OnTimer(uint64_t id) {
+  absl::AnyInvocable<void() &&> task;
+  {
+    MutexLock lock(&lock_);
+    auto it = delayed_tasks_.find(id);
+    if (it == delayed_tasks_.end()) {
+      // Destroyed by Delete().
+      return;
+    }
+    task = std::move(it->second);
+    delayed_tasks_.erase(it);
+  }
+  PostTaskImpl(std::move(task), PostTaskTraits{}, Location::Current());
+}
+
+void ThreadPoolTaskQueue::PostTaskImpl(absl::AnyInvocable<void() &&> task,
+                                       const PostTaskTraits& traits,
+                                       const Location& location) {
+  {
+    MutexLock lock(&lock_);
+    if (!deleted_) {
+      tasks_.push_back(std::move(task));
+      if (state_ != State::kIdle) {
+        // Picked up by the worker that is about to run, or is running, this
+        // task queue.
+        return;
+      }
+      state_ = State::kScheduled;
+      scheduler_->Schedule(rtc::scoped_refptr<ThreadPoolTaskQueue>(this));
+      return;
+    }
+  }
+  DropTask(std::move(task));
+}
+
+void ThreadPoolTaskQueue::PostDelayedTaskImpl(
+    absl::AnyInvocable<void() &&> task,
+    TimeDelta delay,
+    const PostDelayedTaskTraits& traits,
+    const Location& location) {
+  if (delay <= TimeDelta::Zero()) {
+    PostTaskImpl(std::move(task), PostTaskTraits{}, location);
+    return;
+  }
+  const int64_t fire_at_us = rtc::TimeMicros() + delay.us();
+  {
+    MutexLock lock(&lock_);
+    if (!deleted_) {
+      const uint64_t id = next_delayed_task_id_++;
+      delayed_tasks_.emplace(id, std::move(task));
+      scheduler_->AddTimer(fire_at_us,
+                           rtc::scoped_refptr<ThreadPoolTaskQueue>(this), id);
+      return;
+    }
+  }
+  DropTask(std::move(task));
+}
+
+void ThreadPoolTaskQueue::DropTask(absl::AnyInvocable<void() &&> task) {
+  CurrentTaskQueueSetter set_current(this);
+  task = nullptr;
+}
+
+void Worker::YieldExecution() {
+  if (!blocked) {
+    blocked = true;
+    scheduler->OnWorkerBlocked();
+  }
+}
+
+void Worker::ResumeExecution() {
+  if (blocked) {
+    blocked = false;
+    scheduler->OnWorkerUnblocked();
+  }
+}
+
+Scheduler::Scheduler(int num_threads) {
+  RTC_DCHECK_GT(num_threads, 0);
+  const int max_workers = num_threads + kMaxExtraWorkers;
+  workers_.reserve(max_workers);
+  parked_workers_.reserve(max_workers);
+  for (int i = 0; i < max_workers; ++i) {
+    workers_.push_back(std::make_unique<Worker>());
+    workers_.back()->scheduler = this;
+    workers_.back()->index = i;
+  }
+  MutexLock lock(&idle_lock_);
+  for (int i = 0; i < num_threads; ++i) {
+    StartWorker();
+  }
+}
+
+Scheduler::~Scheduler() {
+  size_t num_workers;
+  {
+    MutexLock lock(&idle_lock_);
+    quit_ = true;
+    num_workers = num_started_workers_.load();
+  }
+  for (size_t i = 0; i < num_workers; ++i) {
+    workers_[i]->wake.Set();
+  }
+  for (size_t i = 0; i < num_workers; ++i) {
+    workers_[i]->thread.Finalize();
+  }
+}
+
+void Scheduler::Release() const {
+  if (ref_count_.DecRef() != RefCountReleaseStatus::kDroppedLastRef) {
+    return;
+  }
+  // A worker only runs tasks of task queues that hold a reference, so the
+  // last reference is never released on a worker, which can't join itself.
+  RTC_DCHECK(!current_worker || current_worker->scheduler != this);
+  delete this;
+}
+
+void Scheduler::StartWorker() {
+  const size_t index = num_started_workers_.load();
+  RTC_DCHECK_LT(index, workers_.size());
+  Worker* worker = workers_[index].get();
+  worker->thread = rtc::PlatformThread::SpawnJoinable(
+      [this, worker] { RunWorker(worker); },
+      "TaskQueuePool" + std::to_string(index));
+  num_started_workers_.store(index + 1);
+}
+
+void Scheduler::OnWorkerBlocked() {
+  MutexLock lock(&idle_lock_);
+  ++num_blocked_workers_;
+  const size_t num_workers = num_started_workers_.load();
+  if (quit_ || static_cast<size_t>(num_blocked_workers_) < num_workers) {
+    return;
+  }
+  if (num_workers == workers_.size()) {
+    RTC_LOG(LS_WARNING) << "All " << num_workers
+                        << " task queue pool workers are blocked.";
+    return;
+  }
+  StartWorker();
+}
+
+void Scheduler::OnWorkerUnblocked() {
+  MutexLock lock(&idle_lock_);
+  --num_blocked_workers_;
+}
+
+void Scheduler::Schedule(rtc::scoped_refptr<ThreadPoolTaskQueue> queue) {
+  Worker* worker = current_worker;
+  if (worker && worker->scheduler == this) {
+    MutexLock lock(&worker->lock);
+    if (queue->high_priority()) {
+      worker->runnable.push_front(std::move(queue));
+    } else {
+      worker->runnable.push_back(std::move(queue));
+    }
+  } else {
+    MutexLock lock(&injected_lock_);
+    if (queue->high_priority()) {
+      injected_.push_front(std::move(queue));
+    } else {
+      injected_.push_back(std::move(queue));
+    }
+  }
+  num_runnable_.fetch_add(1);
+  WakeWorker();
+}
+
+void Scheduler::AddTimer(int64_t fire_at_us,
+                         rtc::scoped_refptr<ThreadPoolTaskQueue> queue,
+                         uint64_t id) {
+  bool earliest;
+  {
+    MutexLock lock(&timer_lock_);
+    earliest = fire_at_us < next_timer_us_.load();
+    timers_.push_back(
+        Timer{fire_at_us, next_timer_order_++, std::move(queue), id});
+    std::push_heap(timers_.begin(), timers_.end());
+    if (earliest) {
+      next_timer_us_.store(fire_at_us);
+    }
+  }
+  if (earliest) {
+    WakeTimerWaiter();
+  }
+}
+
+void Scheduler::RunWorker(Worker* worker) {
+  current_worker = worker;
+  while (true) {
+    FireDueTimers();
+    if (rtc::scoped_refptr<ThreadPoolTaskQueue> queue = FindWork(worker)) {
+      bool more_tasks;
+      {
+        rtc::ScopedYieldPolicy yield_policy(worker);
+        more_tasks = queue->RunTasks();
+      }
+      RTC_DCHECK(!worker->blocked);
+      if (more_tasks) {
+        Schedule(std::move(queue));
+      }
+      continue;
+    }
+    if (!Park(worker)) {
+      break;
+    }
+  }
+  current_worker = nullptr;
+}
+
+rtc::scoped_refptr<ThreadPoolTaskQueue> Scheduler::FindWork(Worker* worker) {
+  rtc::scoped_refptr<ThreadPoolTaskQueue> queue;
+  if (num_runnable_.load() == 0) {
+    return queue;
+  }
+  {
+    MutexLock lock(&worker->lock);
+    if (!worker->runnable.empty()) {
+      queue = std::move(worker->runnable.front());
+      worker->runnable.pop_front();
+    }
+  }
+  if (!queue) {
+    MutexLock lock(&injected_lock_);
+    if (!injected_.empty()) {
+      queue = std::move(injected_.front());
+      injected_.pop_front();
+    }
+  }
+  const size_t num_workers = num_started_workers_.load();
+  for (size_t i = 1; !queue && i < num_workers; ++i) {
+    Worker* victim = workers_[(worker->index + i) % num_workers].get();
+    MutexLock lock(&victim->lock);
+    if (!victim->runnable.empty()) {
+      queue = std::move(victim->runnable.back());
+      victim->runnable.pop_back();
+    }
+  }
+  if (queue) {
+    num_runnable_.fetch_sub(1);
+  }
+  return queue;
+}
+
+void Scheduler::FireDueTimers() {
+  const int64_t now_us = rtc::TimeMicros();
+  if (next_timer_us_.load() > now_us) {
+    return;
+  }
+  absl::InlinedVector<Timer, 8> due;
+  {
+    MutexLock lock(&timer_lock_);
+    while (!timers_.empty() && timers_.front().fire_at_us <= now_us) {
+      std::pop_heap(timers_.begin(), timers_.end());
+      due.push_back(std::move(timers_.back()));
+      timers_.pop_back();
+    }
+    next_timer_us_.store(timers_.empty() ? kNoTimer
+                                         : timers_.front().fire_at_us);
+  }
+  for (Timer& timer : due) {
+    timer.queue->OnTimer(timer.id);
+  }
+}
+
+bool Scheduler::Park(Worker* worker) {
+  TimeDelta wait = rtc::Event::kForever;
+  {
+    MutexLock lock(&idle_lock_);
+    if (quit_) {
+      return false;
+    }
+    // Schedule() increments `num_runnable_` before looking for a parked
+    // worker to wake, so work scheduled after this check finds this worker
+    // parked.
+    if (num_runnable_.load() > 0) {
+      return true;
+    }
+    const int64_t next_timer_us = next_timer_us_.load();
+    if (next_timer_us != kNoTimer && !timer_waiter_) {
+      const int64_t now_us = rtc::TimeMicros();
+      if (next_timer_us <= now_us) {
+        return true;
+      }
+      timer_waiter_ = worker;
+      wait = TimeDelta::Millis(DivideRoundUp(next_timer_us - now_us, 1'000));
+    }
+    parked_workers_.push_back(worker);
+  }
+  worker->wake.Wait(wait, /*warn_after=*/rtc::Event::kForever);
+  MutexLock lock(&idle_lock_);
+  auto it =
+      std::find(parked_workers_.begin(), parked_workers_.end(), worker);
+  if (it != parked_workers_.end()) {
+    parked_workers_.erase(it);
+  }
+  if (timer_waiter_ == worker) {
+    timer_waiter_ = nullptr;
+    // This worker may go on to run tasks for a while. Hand the timers over to
+    // a parked worker, which waits for them when it parks again.
+    if (next_timer_us_.load() != kNoTimer && !parked_workers_.empty()) {
+      Worker* next_waiter = parked_workers_.back();
+      parked_workers_.pop_back();
+      next_waiter->wake.Set();
+    }
+  }
+  return true;
+}
+
+void Scheduler::WakeWorker() {
+  MutexLock lock(&idle_lock_);
+  if (parked_workers_.empty()) {
+    return;
+  }
+  // Keep the timer waiter parked unless no other worker is, so that it still
+  // wakes up for the next timer.
+  auto it = parked_workers_.end() - 1;
+  if (*it == timer_waiter_ && it != parked_workers_.begin()) {
+    --it;
+  }
+  Worker* worker = *it;
+  parked_workers_.erase(it);
+  worker->wake.Set();
+}
+
+void Scheduler::WakeTimerWaiter() {
+  MutexLock lock(&idle_lock_);
+  if (timer_waiter_) {
+    timer_waiter_->wake.Set();
+  } else if (!parked_workers_.empty()) {
+    Worker* worker = parked_workers_.back();
+    parked_workers_.pop_back();
+    worker->wake.Set();
+  }
+}
+
+class TaskQueueThreadPoolFactory final : public TaskQueueFactory {
+ public:
+  explicit TaskQueueThreadPoolFactory(int num_threads)
+      : scheduler_(rtc::scoped_refptr<Scheduler>(new Scheduler(num_threads))) {}
+
+  std::unique_ptr<TaskQueueBase, TaskQueueDeleter> CreateTaskQueue(
+      absl::string_view name,
+      Priority priority) const override {
+    return std::unique_ptr<TaskQueueBase, TaskQueueDeleter>(
+        new ThreadPoolTaskQueue(scheduler_, priority == Priority::HIGH));
+  }
+
+ private:
+  const rtc::scoped_refptr<Scheduler> scheduler_;
+};
+
+}  // namespace
+
+std::unique_ptr<TaskQueueFactory> CreateTaskQueueThreadPoolFactory(
+    int num_threads) {
+  return std::make_unique<TaskQueueThreadPoolFactory>(num_threads);
+}
+
+}  // namespace webrtc
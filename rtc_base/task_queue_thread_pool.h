@@ -0,0 +1,40 @@
+/*
+ *  Copyright 2024 The WebRTC Project Authors. All rights reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef RTC_BASE_TASK_QUEUE_THREAD_POOL_H_
+#define RTC_BASE_TASK_QUEUE_THREAD_POOL_H_
+
+#include <memory>
+
+#include "api/task_queue/task_queue_factory.h"
+
+namespace webrtc {
+
+// Returns a factory whose task queues share a fixed pool of `num_threads`
+// worker threads, rather than each task queue owning a thread. A task queue is
+// handed to a worker while it has tasks to run, and idle workers steal
+// runnable task queues from busy ones. Tasks of a task queue still run one at
+// a time and in order, though not necessarily on the same thread.
+//
+// Meant for processes with many mostly idle task queues, such as servers
+// hosting hundreds of calls. A task that blocks holds up its worker, so task
+// queues that block for long periods should not use this factory. When all
+// workers are blocked on an rtc::Event, for example by BlockingCall() between
+// task queues of the pool, another worker is started so that the task queues
+// they wait for can run. Priorities only affect the order in which runnable
+// task queues are picked up.
+//
+// Task queues keep the workers running, so they may outlive the factory.
+std::unique_ptr<TaskQueueFactory> CreateTaskQueueThreadPoolFactory(
+    int num_threads);
+
+}  // namespace webrtc
+
+#endif  // RTC_BASE_TASK_QUEUE_THREAD_POOL_H_
@@ -0,0 +1,186 @@
+/*
+ *  Copyright 2024 The WebRTC Project Authors. All rights reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "rtc_base/task_queue_thread_pool.h"
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "api/task_queue/task_queue_base.h"
+#include "api/task_queue/task_queue_test.h"
+#include "api/units/time_delta.h"
+#include "rtc_base/event.h"
+#include "rtc_base/time_utils.h"
+#include "test/gtest.h"
+
+namespace webrtc {
+namespace {
+
+std::unique_ptr<TaskQueueFactory> CreateTaskQueueFactory(
+    const webrtc::FieldTrialsView*) {
+  return CreateTaskQueueThreadPoolFactory(/*num_threads=*/2);
+}
+
+INSTANTIATE_TEST_SUITE_P(TaskQueueThreadPool,
+                         TaskQueueTest,
+                         ::testing::Values(CreateTaskQueueFactory));
+
+TEST(TaskQueueThreadPoolTest, RunsTasksOfManyQueuesInOrder) {
+  constexpr int kNumQueues = 100;
+  constexpr int kTasksPerQueue = 100;
+  std::unique_ptr<TaskQueueFactory> factory =
+      CreateTaskQueueThreadPoolFactory(/*num_threads=*/4);
+  std::vector<std::unique_ptr<TaskQueueBase, TaskQueueDeleter>> queues;
+  std::vector<int> last_task(kNumQueues, -1);
+  std::atomic<int> out_of_order{0};
+  std::atomic<int> remaining{kNumQueues * kTasksPerQueue};
+  rtc::Event done;
+  for (int i = 0; i < kNumQueues; ++i) {
+    queues.push_back(factory->CreateTaskQueue(
+        "Queue", TaskQueueFactory::Priority::NORMAL));
+  }
+  for (int task = 0; task < kTasksPerQueue; ++task) {
+    for (int i = 0; i < kNumQueues; ++i) {
+      TaskQueueBase* queue = queues[i].get();
+      queue->PostTask([&, queue, i, task] {
+        EXPECT_TRUE(queue->IsCurrent());
+        // Not synchronized, relies on the tasks of a queue never overlapping.
+        if (last_task[i] != task - 1) {
+          ++out_of_order;
+        }
+        last_task[i] = task;
+        if (--remaining == 0) {
+          done.Set();
+        }
+      });
+    }
+  }
+  EXPECT_TRUE(done.Wait(TimeDelta::Seconds(10)));
+  EXPECT_EQ(out_of_order, 0);
+}
+
+TEST(TaskQueueThreadPoolTest, BlockedQueueDoesNotBlockOthers) {
+  rtc::Event unblock;
+  rtc::Event ran;
+  std::unique_ptr<TaskQueueFactory> factory =
+      CreateTaskQueueThreadPoolFactory(/*num_threads=*/2);
+  auto blocked_queue =
+      factory->CreateTaskQueue("Blocked", TaskQueueFactory::Priority::NORMAL);
+  auto queue =
+      factory->CreateTaskQueue("Other", TaskQueueFactory::Priority::NORMAL);
+  blocked_queue->PostTask([&] { unblock.Wait(rtc::Event::kForever); });
+  queue->PostTask([&] { ran.Set(); });
+  EXPECT_TRUE(ran.Wait(TimeDelta::Seconds(5)));
+  unblock.Set();
+}
+
+TEST(TaskQueueThreadPoolTest, DeleteWaitsForRunningTask) {
+  std::unique_ptr<TaskQueueFactory> factory =
+      CreateTaskQueueThreadPoolFactory(/*num_threads=*/1);
+  auto queue =
+      factory->CreateTaskQueue("Queue", TaskQueueFactory::Priority::NORMAL);
+  rtc::Event started;
+  std::atomic<bool> finished{false};
+  queue->PostTask([&] {
+    started.Set();
+    rtc::Event().Wait(TimeDelta::Millis(50));
+    finished = true;
+  });
+  queue->PostTask([] { ADD_FAILURE() << "Runs after Delete()."; });
+  ASSERT_TRUE(started.Wait(TimeDelta::Seconds(5)));
+  queue = nullptr;
+  EXPECT_TRUE(finished);
+}
+
+TEST(TaskQueueThreadPoolTest, RunsDelayedTasksInOrderOfDeadline) {
+  std::unique_ptr<TaskQueueFactory> factory =
+      CreateTaskQueueThreadPoolFactory(/*num_threads=*/2);
+  auto queue =
+      factory->CreateTaskQueue("Queue", TaskQueueFactory::Priority::NORMAL);
+  std::vector<int> order;
+  rtc::Event done;
+  queue->PostDelayedTask([&] { order.push_back(3); }, TimeDelta::Millis(30));
+  queue->PostDelayedTask([&] { order.push_back(1); }, TimeDelta::Millis(10));
+  queue->PostDelayedTask([&] { order.push_back(2); }, TimeDelta::Millis(20));
+  queue->PostDelayedTask([&] { done.Set(); }, TimeDelta::Millis(40));
+  ASSERT_TRUE(done.Wait(TimeDelta::Seconds(5)));
+  EXPECT_EQ(order, std::vector<int>({1, 2, 3}));
+}
+
+TEST(TaskQueueThreadPoolTest, RunsDelayedTaskOnTimeWhileWorkerIsBusy) {
+  std::unique_ptr<TaskQueueFactory> factory =
+      CreateTaskQueueThreadPoolFactory(/*num_threads=*/2);
+  auto busy_queue =
+      factory->CreateTaskQueue("Busy", TaskQueueFactory::Priority::NORMAL);
+  auto queue =
+      factory->CreateTaskQueue("Queue", TaskQueueFactory::Priority::NORMAL);
+  // Let both workers park, then one of them wake up and park again to wait
+  // for the delayed task. That makes it the most recently parked worker.
+  rtc::Event().Wait(TimeDelta::Millis(20));
+  rtc::Event fired;
+  queue->PostDelayedTask([&] { fired.Set(); }, TimeDelta::Millis(100));
+  rtc::Event().Wait(TimeDelta::Millis(20));
+
+  // Keep one worker busy without blocking, which would start another worker.
+  // It yields so that the other worker gets to run on a single core.
+  std::atomic<bool> stop{false};
+  rtc::Event started;
+  busy_queue->PostTask([&] {
+    started.Set();
+    const int64_t give_up_ms = rtc::TimeMillis() + 5'000;
+    while (!stop && rtc::TimeMillis() < give_up_ms) {
+      std::this_thread::yield();
+    }
+  });
+  ASSERT_TRUE(started.Wait(TimeDelta::Seconds(5)));
+  EXPECT_TRUE(fired.Wait(TimeDelta::Millis(1'000)));
+  stop = true;
+}
+
+TEST(TaskQueueThreadPoolTest, TaskQueuesOutliveFactory) {
+  std::unique_ptr<TaskQueueFactory> factory =
+      CreateTaskQueueThreadPoolFactory(/*num_threads=*/1);
+  auto queue =
+      factory->CreateTaskQueue("Queue", TaskQueueFactory::Priority::NORMAL);
+  factory = nullptr;
+  rtc::Event ran;
+  queue->PostTask([&] { ran.Set(); });
+  EXPECT_TRUE(ran.Wait(TimeDelta::Seconds(5)));
+}
+
+TEST(TaskQueueThreadPoolTest, BlockingWaitsBetweenTaskQueuesDoNotDeadlock) {
+  std::unique_ptr<TaskQueueFactory> factory =
+      CreateTaskQueueThreadPoolFactory(/*num_threads=*/1);
+  std::vector<std::unique_ptr<TaskQueueBase, TaskQueueDeleter>> queues;
+  for (int i = 0; i < 3; ++i) {
+    queues.push_back(
+        factory->CreateTaskQueue("Queue", TaskQueueFactory::Priority::NORMAL));
+  }
+  // Each task waits for a task on the next task queue, like BlockingCall().
+  rtc::Event done;
+  queues[0]->PostTask([&] {
+    rtc::Event first;
+    queues[1]->PostTask([&] {
+      rtc::Event second;
+      queues[2]->PostTask([&] { second.Set(); });
+      EXPECT_TRUE(second.Wait(TimeDelta::Seconds(5)));
+      first.Set();
+    });
+    EXPECT_TRUE(first.Wait(TimeDelta::Seconds(5)));
+    done.Set();
+  });
+  EXPECT_TRUE(done.Wait(TimeDelta::Seconds(10)));
+}
+
+}  // namespace
+}  // namespace webrtc
@@ -0,0 +1,308 @@
+/*
+ *  Copyright 2024 The WebRTC Project Authors. All rights reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "rtc_base/task_utils/timing_wheel.h"
+
+#include <algorithm>
+#include <limits>
+#include <tuple>
+#include <utility>
+
+#include "absl/numeric/bits.h"
+#include "rtc_base/checks.h"
+
+namespace webrtc {
+namespace {
+
+constexpr int16_t kReady = -1;
+constexpr int16_t kFree = -2;
+constexpr int64_t kNoTick = std::numeric_limits<int64_t>::max();
+
+}  // namespace
+
+struct TimingWheel::Node {
+  absl::AnyInvocable<void() &&> task;
+  int64_t run_at_us = 0;
+  int64_t tick = 0;
+  uint64_t order = 0;
+  uint32_t prev = kNone;
+  uint32_t next = kNone;
+  uint32_t generation = 1;
+  // `level * kNumSlots + slot` while linked into a slot, otherwise kReady or
+  // kFree.
+  int16_t location = kFree;
+};
+
+TimingWheel::TimingWheel(TimeDelta resolution)
+    : resolution_us_(resolution.us()) {
+  RTC_DCHECK_GT(resolution_us_, 0);
+  for (auto& level : slots_) {
+    level.fill(kNone);
+  }
+}
+
+TimingWheel::~TimingWheel() = default;
+
+TimingWheel::TaskId TimingWheel::Schedule(Timestamp now,
+                                          Timestamp run_at,
+                                          uint64_t order,
+                                          absl::AnyInvocable<void() &&> task) {
+  RTC_DCHECK(run_at.IsFinite());
+  int64_t now_tick = TickAtOrBefore(now);
+  if (size_ == ready_.size()) {
+    // Nothing is waiting in the wheel, so it can be moved to any time.
+    current_tick_ = now_tick;
+  } else if (now_tick < current_tick_) {
+    Rebase(now_tick);
+  }
+
+  uint32_t index;
+  if (free_list_ != kNone) {
+    index = free_list_;
+    free_list_ = nodes_[index].next;
+  } else {
+    index = static_cast<uint32_t>(nodes_.size());
+    nodes_.emplace_back();
+  }
+  Node& node = nodes_[index];
+  node.task = std::move(task);
+  node.run_at_us = run_at.us();
+  node.tick = TickAtOrAfter(run_at);
+  node.order = order;
+  ++size_;
+  Place(index);
+  return (TaskId{node.generation} << 32) | index;
+}
+
+bool TimingWheel::Cancel(TaskId id) {
+  uint32_t index = static_cast<uint32_t>(id);
+  if (index >= nodes_.size()) {
+    return false;
+  }
+  Node& node = nodes_[index];
+  if (node.location == kFree || node.generation != id >> 32) {
+    return false;
+  }
+  if (node.location == kReady) {
+    ready_.erase(std::find(ready_.begin(), ready_.end(), index));
+  } else {
+    Unlink(index);
+  }
+  // The task is destroyed after the wheel is consistent again, in case its
+  // destructor schedules another task.
+  absl::AnyInvocable<void() &&> task = std::move(node.task);
+  FreeNode(index);
+  return true;
+}
+
+void TimingWheel::Advance(Timestamp now) {
+  int64_t now_tick = TickAtOrBefore(now);
+  if (now_tick < current_tick_) {
+    Rebase(now_tick);
+    return;
+  }
+  // Jump straight to the ticks that have work, empty slots need no processing.
+  for (int64_t tick = NextEventTick(); tick <= now_tick;
+       tick = NextEventTick()) {
+    current_tick_ = tick;
+    ProcessTick();
+  }
+  current_tick_ = now_tick;
+}
+
+uint64_t TimingWheel::next_ready_order() const {
+  RTC_DCHECK(has_ready_task());
+  return nodes_[ready_.back()].order;
+}
+
+absl::AnyInvocable<void() &&> TimingWheel::PopReadyTask() {
+  RTC_DCHECK(has_ready_task());
+  uint32_t index = ready_.back();
+  ready_.pop_back();
+  absl::AnyInvocable<void() &&> task = std::move(nodes_[index].task);
+  FreeNode(index);
+  return task;
+}
+
+Timestamp TimingWheel::NextRunTime() const {
+  int64_t tick = NextEventTick();
+  if (tick == kNoTick) {
+    return Timestamp::PlusInfinity();
+  }
+  return Timestamp::Micros(tick * resolution_us_);
+}
+
+void TimingWheel::Clear() {
+  std::vector<absl::AnyInvocable<void() &&>> tasks;
+  tasks.reserve(size_);
+  for (uint32_t index = 0; index < nodes_.size(); ++index) {
+    if (nodes_[index].location != kFree) {
+      tasks.push_back(std::move(nodes_[index].task));
+      FreeNode(index);
+    }
+  }
+  for (auto& level : slots_) {
+    level.fill(kNone);
+  }
+  occupied_ = {};
+  ready_.clear();
+  RTC_DCHECK_EQ(size_, 0u);
+}
+
+int64_t TimingWheel::TickAtOrAfter(Timestamp time) const {
+  return (time.us() + resolution_us_ - 1) / resolution_us_;
+}
+
+int64_t TimingWheel::TickAtOrBefore(Timestamp time) const {
+  return time.us() / resolution_us_;
+}
+
+int64_t TimingWheel::NextEventTick() const {
+  int64_t next_tick = kNoTick;
+  for (int level = 0; level < kNumLevels; ++level) {
+    if (occupied_[level] == 0) {
+      continue;
+    }
+    // Slots of a level are processed in turn, one every 64^level ticks. Find
+    // the first occupied slot after the current one, wrapping around to the
+    // current one last.
+    int shift = kSlotBits * level;
+    int64_t bucket = current_tick_ >> shift;
+    int first_slot = static_cast<int>((bucket + 1) & (kNumSlots - 1));
+    int offset = absl::countr_zero(absl::rotr(occupied_[level], first_slot));
+    next_tick = std::min(next_tick, (bucket + 1 + offset) << shift);
+  }
+  return next_tick;
+}
+
+void TimingWheel::ProcessTick() {
+  // Move tasks of outer slots whose range starts now inwards, outermost first
+  // so that they can cascade all the way down.
+  for (int level = kNumLevels - 1; level > 0; --level) {
+    int shift = kSlotBits * level;
+    if ((current_tick_ & ((int64_t{1} << shift) - 1)) != 0) {
+      continue;
+    }
+    int slot = static_cast<int>((current_tick_ >> shift) & (kNumSlots - 1));
+    for (uint32_t index = TakeSlot(level, slot); index != kNone;) {
+      uint32_t next = nodes_[index].next;
+      Place(index);
+      index = next;
+    }
+  }
+  int slot = static_cast<int>(current_tick_ & (kNumSlots - 1));
+  for (uint32_t index = TakeSlot(0, slot); index != kNone;) {
+    uint32_t next = nodes_[index].next;
+    RTC_DCHECK_EQ(nodes_[index].tick, current_tick_);
+    AddReady(index);
+    index = next;
+  }
+}
+
+void TimingWheel::Rebase(int64_t tick) {
+  std::vector<uint32_t> waiting;
+  for (int level = 0; level < kNumLevels; ++level) {
+    for (int slot = 0; slot < kNumSlots; ++slot) {
+      for (uint32_t index = TakeSlot(level, slot); index != kNone;
+           index = nodes_[index].next) {
+        waiting.push_back(index);
+      }
+    }
+  }
+  current_tick_ = tick;
+  for (uint32_t index : waiting) {
+    Place(index);
+  }
+}
+
+void TimingWheel::Place(uint32_t index) {
+  int64_t tick = nodes_[index].tick;
+  int64_t delta = tick - current_tick_;
+  if (delta <= 0) {
+    AddReady(index);
+    return;
+  }
+  int level = 0;
+  while (level < kNumLevels - 1 &&
+         delta >= (int64_t{1} << (kSlotBits * (level + 1)))) {
+    ++level;
+  }
+  // Beyond the range of the outermost wheel, wait in its furthest slot and be
+  // placed again from there.
+  tick = std::min(tick,
+                  current_tick_ + (int64_t{1} << (kSlotBits * kNumLevels)) - 1);
+  int slot =
+      static_cast<int>((tick >> (kSlotBits * level)) & (kNumSlots - 1));
+  Link(index, level, slot);
+}
+
+void TimingWheel::Link(uint32_t index, int level, int slot) {
+  Node& node = nodes_[index];
+  uint32_t& head = slots_[level][slot];
+  node.location = static_cast<int16_t>(level * kNumSlots + slot);
+  node.prev = kNone;
+  node.next = head;
+  if (head != kNone) {
+    nodes_[head].prev = index;
+  }
+  head = index;
+  occupied_[level] |= uint64_t{1} << slot;
+}
+
+void TimingWheel::Unlink(uint32_t index) {
+  Node& node = nodes_[index];
+  int level = node.location / kNumSlots;
+  int slot = node.location % kNumSlots;
+  if (node.prev != kNone) {
+    nodes_[node.prev].next = node.next;
+  } else {
+    slots_[level][slot] = node.next;
+  }
+  if (node.next != kNone) {
+    nodes_[node.next].prev = node.prev;
+  }
+  if (slots_[level][slot] == kNone) {
+    occupied_[level] &= ~(uint64_t{1} << slot);
+  }
+}
+
+uint32_t TimingWheel::TakeSlot(int level, int slot) {
+  uint32_t head = slots_[level][slot];
+  slots_[level][slot] = kNone;
+  occupied_[level] &= ~(uint64_t{1} << slot);
+  return head;
+}
+
+void TimingWheel::AddReady(uint32_t index) {
+  nodes_[index].location = kReady;
+  // `ready_` is sorted descending so that the next task is popped off the
+  // back. Tasks with equal keys keep the order in which they became ready.
+  auto runs_later = [this](uint32_t a, uint32_t b) {
+    return std::tie(nodes_[a].run_at_us, nodes_[a].order) >
+           std::tie(nodes_[b].run_at_us, nodes_[b].order);
+  };
+  ready_.insert(
+      std::lower_bound(ready_.begin(), ready_.end(), index, runs_later),
+      index);
+}
+
+void TimingWheel::FreeNode(uint32_t index) {
+  Node& node = nodes_[index];
+  node.task = nullptr;
+  node.location = kFree;
+  if (++node.generation == 0) {
+    node.generation = 1;
+  }
+  node.next = free_list_;
+  free_list_ = index;
+  --size_;
+}
+
+}  // namespace webrtc
@@ -0,0 +1,126 @@
+/*
+ *  Copyright 2024 The WebRTC Project Authors. All rights reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef RTC_BASE_TASK_UTILS_TIMING_WHEEL_H_
+#define RTC_BASE_TASK_UTILS_TIMING_WHEEL_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <array>
+#include <vector>
+
+#include "absl/functional/any_invocable.h"
+#include "api/units/time_delta.h"
+#include "api/units/timestamp.h"
+
+namespace webrtc {
+
+// Hierarchical timing wheel holding the delayed tasks of a task queue.
+//
+// Time is divided into ticks of `resolution`. Scheduling and cancelling a task
+// is O(1): the task is linked into the slot of one of four wheels of 64 slots,
+// picked by how far away its tick is. Advancing time expires the slots passed
+// on the innermost wheel and moves the tasks of outer wheel slots inwards as
+// their range is reached. Tasks beyond the range of the outermost wheel
+// (about 4.6 hours at millisecond resolution) are parked in its last slot and
+// re-sorted when it is reached. Task storage is recycled, so scheduling does
+// not allocate once the wheel has grown to its working size.
+//
+// A task becomes ready on the first Advance() at or after the end of the tick
+// containing its run time, so it runs at most one tick late and never early.
+// Ready tasks are handed out in order of run time, with ties broken by the
+// caller provided `order`.
+//
+// The class is not thread safe.
+class TimingWheel {
+ public:
+  using TaskId = uint64_t;
+  static constexpr TaskId kInvalidTaskId = 0;
+
+  explicit TimingWheel(TimeDelta resolution = TimeDelta::Millis(1));
+  ~TimingWheel();
+
+  TimingWheel(const TimingWheel&) = delete;
+  TimingWheel& operator=(const TimingWheel&) = delete;
+
+  // Schedules `task` to become ready at `run_at`. `now` is the current time,
+  // which may be behind the time last passed to Advance() when the clock has
+  // been replaced, e.g. by a fake clock in tests.
+  TaskId Schedule(Timestamp now,
+                  Timestamp run_at,
+                  uint64_t order,
+                  absl::AnyInvocable<void() &&> task);
+
+  // Destroys a task that has not been returned by PopReadyTask() yet. Returns
+  // false if the task is unknown.
+  bool Cancel(TaskId id);
+
+  // Makes all tasks due at `now` ready.
+  void Advance(Timestamp now);
+
+  bool has_ready_task() const { return !ready_.empty(); }
+  // The `order` of the next ready task. Requires has_ready_task().
+  uint64_t next_ready_order() const;
+  // Removes and returns the next ready task. Requires has_ready_task().
+  absl::AnyInvocable<void() &&> PopReadyTask();
+
+  // Returns the time of the next Advance() that may make a task ready, or
+  // PlusInfinity() if no tasks are waiting. For tasks far in the future this
+  // may be earlier than their run time, in which case Advance() only moves
+  // them closer and NextRunTime() should be asked again.
+  Timestamp NextRunTime() const;
+
+  // Destroys all tasks.
+  void Clear();
+
+  // Number of tasks scheduled, including ready ones.
+  size_t size() const { return size_; }
+  bool empty() const { return size_ == 0; }
+
+ private:
+  static constexpr int kSlotBits = 6;
+  static constexpr int kNumSlots = 1 << kSlotBits;
+  static constexpr int kNumLevels = 4;
+  static constexpr uint32_t kNone = UINT32_MAX;
+
+  struct Node;
+
+  int64_t TickAtOrAfter(Timestamp time) const;
+  int64_t TickAtOrBefore(Timestamp time) const;
+  // Returns the next tick at which a non-empty slot is processed.
+  int64_t NextEventTick() const;
+  void ProcessTick();
+  void Rebase(int64_t tick);
+
+  // Puts a node into the slot matching its tick, or onto the ready list.
+  void Place(uint32_t index);
+  void Link(uint32_t index, int level, int slot);
+  void Unlink(uint32_t index);
+  // Detaches the list of a slot and returns its first node.
+  uint32_t TakeSlot(int level, int slot);
+  void AddReady(uint32_t index);
+  void FreeNode(uint32_t index);
+
+  const int64_t resolution_us_;
+  int64_t current_tick_ = 0;
+  size_t size_ = 0;
+  std::vector<Node> nodes_;
+  uint32_t free_list_ = kNone;
+  std::array<std::array<uint32_t, kNumSlots>, kNumLevels> slots_;
+  // Bit `i` of `occupied_[level]` is set if `slots_[level][i]` is non-empty.
+  std::array<uint64_t, kNumLevels> occupied_ = {};
+  // Ready nodes, sorted with the next one to run last.
+  std::vector<uint32_t> ready_;
+};
+
+}  // namespace webrtc
+
+#endif  // RTC_BASE_TASK_UTILS_TIMING_WHEEL_H_
@@ -0,0 +1,111 @@
+/*
+ *  Copyright 2024 The WebRTC Project Authors. All rights reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <cstdint>
+#include <map>
+#include <random>
+#include <utility>
+
+#include "absl/functional/any_invocable.h"
+#include "api/units/time_delta.h"
+#include "api/units/timestamp.h"
+#include "benchmark/benchmark.h"
+#include "rtc_base/system/unused.h"
+#include "rtc_base/task_utils/timing_wheel.h"
+
+namespace webrtc {
+namespace {
+
+// The delayed task container TaskQueueStdlib used before TimingWheel.
+class DelayedTaskMap {
+ public:
+  void Schedule(Timestamp now,
+                Timestamp run_at,
+                uint64_t order,
+                absl::AnyInvocable<void() &&> task) {
+    tasks_[{run_at.us(), order}] = std::move(task);
+  }
+
+  int RunDueTasks(Timestamp now) {
+    int ran = 0;
+    while (!tasks_.empty() && tasks_.begin()->first.first <= now.us()) {
+      std::move(tasks_.begin()->second)();
+      tasks_.erase(tasks_.begin());
+      ++ran;
+    }
+    return ran;
+  }
+
+ private:
+  std::map<std::pair<int64_t, uint64_t>, absl::AnyInvocable<void() &&>> tasks_;
+};
+
+class DelayedTaskWheel {
+ public:
+  void Schedule(Timestamp now,
+                Timestamp run_at,
+                uint64_t order,
+                absl::AnyInvocable<void() &&> task) {
+    wheel_.Schedule(now, run_at, order, std::move(task));
+  }
+
+  int RunDueTasks(Timestamp now) {
+    int ran = 0;
+    wheel_.Advance(now);
+    while (wheel_.has_ready_task()) {
+      wheel_.PopReadyTask()();
+      ++ran;
+    }
+    return ran;
+  }
+
+ private:
+  TimingWheel wheel_;
+};
+
+// Keeps `state.range(0)` timers with delays of up to a second pending, and
+// per iteration schedules one more and runs those that have become due, like
+// a task queue serving repeating tasks and protocol timers.
+template <typename Container>
+void BM_ScheduleAndRunDelayedTasks(benchmark::State& state) {
+  const int num_pending = state.range(0);
+  std::mt19937 random(1234);
+  std::uniform_int_distribution<int> delay_us(1, 1'000'000);
+  Container container;
+  Timestamp now = Timestamp::Seconds(1000);
+  uint64_t order = 0;
+  int counter = 0;
+  for (int i = 0; i < num_pending; ++i) {
+    container.Schedule(now, now + TimeDelta::Micros(delay_us(random)), order++,
+                       [&counter] { ++counter; });
+  }
+  // Advance time such that on average one task becomes due per iteration.
+  const TimeDelta step = TimeDelta::Micros(500'000 / num_pending + 1);
+  for (auto s : state) {
+    RTC_UNUSED(s);
+    container.Schedule(now, now + TimeDelta::Micros(delay_us(random)), order++,
+                       [&counter] { ++counter; });
+    now += step;
+    benchmark::DoNotOptimize(container.RunDueTasks(now));
+  }
+  benchmark::DoNotOptimize(counter);
+}
+
+BENCHMARK_TEMPLATE(BM_ScheduleAndRunDelayedTasks, DelayedTaskMap)
+    ->Arg(100)
+    ->Arg(10'000)
+    ->Arg(100'000);
+BENCHMARK_TEMPLATE(BM_ScheduleAndRunDelayedTasks, DelayedTaskWheel)
+    ->Arg(100)
+    ->Arg(10'000)
+    ->Arg(100'000);
+
+}  // namespace
+}  // namespace webrtc
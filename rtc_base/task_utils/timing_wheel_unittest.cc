@@ -0,0 +1,225 @@
+/*
+ *  Copyright 2024 The WebRTC Project Authors. All rights reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "rtc_base/task_utils/timing_wheel.h"
+
+#include <cstdint>
+#include <iterator>
+#include <map>
+#include <memory>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include "api/units/time_delta.h"
+#include "api/units/timestamp.h"
+#include "test/gmock.h"
+#include "test/gtest.h"
+
+namespace webrtc {
+namespace {
+
+using ::testing::ElementsAre;
+using ::testing::IsEmpty;
+
+constexpr Timestamp kStart = Timestamp::Seconds(1000);
+
+class TimingWheelTest : public ::testing::Test {
+ protected:
+  void Schedule(TimeDelta delay, int value) {
+    wheel_.Schedule(now_, now_ + delay, next_order_++,
+                    [this, value] { ran_.push_back(value); });
+  }
+
+  // Runs the tasks due at `now` and returns their values.
+  std::vector<int> AdvanceTo(Timestamp now) {
+    now_ = now;
+    wheel_.Advance(now_);
+    ran_.clear();
+    while (wheel_.has_ready_task()) {
+      wheel_.PopReadyTask()();
+    }
+    return ran_;
+  }
+
+  std::vector<int> AdvanceBy(TimeDelta delta) {
+    return AdvanceTo(now_ + delta);
+  }
+
+  TimingWheel wheel_;
+  Timestamp now_ = kStart;
+  uint64_t next_order_ = 0;
+  std::vector<int> ran_;
+};
+
+TEST_F(TimingWheelTest, RunsTaskWhenDue) {
+  Schedule(TimeDelta::Millis(10), 1);
+  EXPECT_THAT(AdvanceBy(TimeDelta::Millis(9)), IsEmpty());
+  EXPECT_THAT(AdvanceBy(TimeDelta::Millis(1)), ElementsAre(1));
+  EXPECT_TRUE(wheel_.empty());
+}
+
+TEST_F(TimingWheelTest, RoundsRunTimeUpToResolution) {
+  Schedule(TimeDelta::Micros(10'500), 1);
+  EXPECT_THAT(AdvanceBy(TimeDelta::Micros(10'999)), IsEmpty());
+  EXPECT_EQ(wheel_.NextRunTime(), kStart + TimeDelta::Millis(11));
+  EXPECT_THAT(AdvanceBy(TimeDelta::Micros(1)), ElementsAre(1));
+}
+
+TEST_F(TimingWheelTest, RunsDueTasksImmediately) {
+  Schedule(TimeDelta::Zero(), 1);
+  EXPECT_TRUE(wheel_.has_ready_task());
+  EXPECT_THAT(AdvanceBy(TimeDelta::Zero()), ElementsAre(1));
+}
+
+TEST_F(TimingWheelTest, OrdersTasksByRunTimeThenOrder) {
+  Schedule(TimeDelta::Micros(300), 3);
+  Schedule(TimeDelta::Micros(100), 1);
+  Schedule(TimeDelta::Micros(300), 4);
+  Schedule(TimeDelta::Micros(200), 2);
+  Schedule(TimeDelta::Seconds(10), 6);
+  Schedule(TimeDelta::Millis(100), 5);
+  EXPECT_THAT(AdvanceBy(TimeDelta::Seconds(20)), ElementsAre(1, 2, 3, 4, 5, 6));
+}
+
+TEST_F(TimingWheelTest, ReportsNextRunTime) {
+  EXPECT_TRUE(wheel_.NextRunTime().IsPlusInfinity());
+  Schedule(TimeDelta::Millis(40), 1);
+  EXPECT_EQ(wheel_.NextRunTime(), kStart + TimeDelta::Millis(40));
+  Schedule(TimeDelta::Millis(20), 2);
+  EXPECT_EQ(wheel_.NextRunTime(), kStart + TimeDelta::Millis(20));
+}
+
+TEST_F(TimingWheelTest, NextRunTimeIsNeverLate) {
+  const TimeDelta kDelays[] = {
+      TimeDelta::Millis(1),    TimeDelta::Millis(63),
+      TimeDelta::Millis(64),   TimeDelta::Millis(700),
+      TimeDelta::Seconds(5),   TimeDelta::Seconds(300),
+      TimeDelta::Seconds(1e4), TimeDelta::Seconds(1e5)};
+  for (TimeDelta delay : kDelays) {
+    Schedule(delay, delay.ms());
+  }
+  std::vector<int> ran;
+  while (!wheel_.empty()) {
+    Timestamp next_run_time = wheel_.NextRunTime();
+    ASSERT_TRUE(next_run_time.IsFinite());
+    for (int value : AdvanceTo(next_run_time)) {
+      EXPECT_EQ(now_, kStart + TimeDelta::Millis(value));
+      ran.push_back(value);
+    }
+  }
+  EXPECT_EQ(ran.size(), std::size(kDelays));
+}
+
+TEST_F(TimingWheelTest, CancelsWaitingAndReadyTasks) {
+  TimingWheel::TaskId waiting =
+      wheel_.Schedule(now_, now_ + TimeDelta::Seconds(1), 0, [] {});
+  TimingWheel::TaskId ready = wheel_.Schedule(now_, now_, 1, [] {});
+  EXPECT_EQ(wheel_.size(), 2u);
+  EXPECT_TRUE(wheel_.Cancel(waiting));
+  EXPECT_TRUE(wheel_.Cancel(ready));
+  EXPECT_TRUE(wheel_.empty());
+  EXPECT_FALSE(wheel_.has_ready_task());
+  EXPECT_TRUE(wheel_.NextRunTime().IsPlusInfinity());
+  EXPECT_FALSE(wheel_.Cancel(waiting));
+}
+
+TEST_F(TimingWheelTest, DoesNotCancelReusedStorage) {
+  TimingWheel::TaskId first = wheel_.Schedule(now_, now_, 0, [] {});
+  wheel_.PopReadyTask();
+  TimingWheel::TaskId second = wheel_.Schedule(now_, now_, 1, [] {});
+  EXPECT_NE(first, second);
+  EXPECT_FALSE(wheel_.Cancel(first));
+  EXPECT_TRUE(wheel_.Cancel(second));
+}
+
+TEST_F(TimingWheelTest, CancelDestroysTask) {
+  auto alive = std::make_shared<int>();
+  TimingWheel::TaskId id = wheel_.Schedule(
+      now_, now_ + TimeDelta::Seconds(1), 0, [alive] {});
+  EXPECT_EQ(alive.use_count(), 2);
+  wheel_.Cancel(id);
+  EXPECT_EQ(alive.use_count(), 1);
+}
+
+TEST_F(TimingWheelTest, ClearDestroysAllTasks) {
+  Schedule(TimeDelta::Zero(), 1);
+  Schedule(TimeDelta::Seconds(1), 2);
+  Schedule(TimeDelta::Seconds(1e5), 3);
+  wheel_.Clear();
+  EXPECT_TRUE(wheel_.empty());
+  EXPECT_THAT(AdvanceBy(TimeDelta::Seconds(1e6)), IsEmpty());
+}
+
+TEST_F(TimingWheelTest, HandlesClockGoingBackwards) {
+  Schedule(TimeDelta::Millis(100), 1);
+  now_ = Timestamp::Millis(10);
+  Schedule(TimeDelta::Millis(50), 2);
+  EXPECT_THAT(AdvanceTo(Timestamp::Millis(59)), IsEmpty());
+  EXPECT_THAT(AdvanceTo(Timestamp::Millis(60)), ElementsAre(2));
+  // The first task keeps its absolute run time.
+  EXPECT_THAT(AdvanceTo(kStart + TimeDelta::Millis(99)), IsEmpty());
+  EXPECT_THAT(AdvanceTo(kStart + TimeDelta::Millis(100)), ElementsAre(1));
+}
+
+TEST_F(TimingWheelTest, MatchesSortedReference) {
+  std::mt19937_64 random(1234);
+  // Delays up to about 10 hours, biased towards short ones.
+  std::uniform_int_distribution<int> delay_bits(0, 35);
+  std::uniform_int_distribution<int> step_us(0, 5'000'000);
+  std::multimap<std::pair<int64_t, uint64_t>, int> reference;
+  std::map<int, TimingWheel::TaskId> ids;
+  std::vector<int> expected;
+  std::vector<int> actual;
+  int next_value = 0;
+  for (int round = 0; round < 2000; ++round) {
+    for (int i = 0; i < 5; ++i) {
+      int64_t delay_us = random() & ((int64_t{1} << delay_bits(random)) - 1);
+      Timestamp run_at = now_ + TimeDelta::Micros(delay_us);
+      int value = next_value++;
+      uint64_t order = next_order_++;
+      ids[value] =
+          wheel_.Schedule(now_, run_at, order,
+                          [&actual, value] { actual.push_back(value); });
+      reference.emplace(std::make_pair(run_at.us(), order), value);
+    }
+    if (round % 3 == 0 && !ids.empty()) {
+      auto it = ids.begin();
+      std::advance(it, random() % ids.size());
+      EXPECT_TRUE(wheel_.Cancel(it->second));
+      for (auto ref = reference.begin(); ref != reference.end(); ++ref) {
+        if (ref->second == it->first) {
+          reference.erase(ref);
+          break;
+        }
+      }
+      ids.erase(it);
+    }
+    now_ += TimeDelta::Micros(step_us(random));
+    wheel_.Advance(now_);
+    while (wheel_.has_ready_task()) {
+      wheel_.PopReadyTask()();
+      ids.erase(actual.back());
+    }
+    // Everything due at the last whole millisecond has run, and nothing that
+    // is not due yet.
+    int64_t tick_end_us = now_.us() / 1000 * 1000;
+    while (!reference.empty() &&
+           reference.begin()->first.first <= tick_end_us) {
+      expected.push_back(reference.begin()->second);
+      reference.erase(reference.begin());
+    }
+    ASSERT_EQ(actual, expected);
+    ASSERT_EQ(wheel_.size(), reference.size());
+  }
+}
+
+}  // namespace
+}  // namespace webrtc
@@ -13,6 +13,7 @@
 #include "absl/strings/string_view.h"
 #include "api/task_queue/task_queue_base.h"
 #include "api/units/time_delta.h"
+#include "api/units/timestamp.h"
 #include "rtc_base/socket_server.h"
 
 #if defined(WEBRTC_WIN)
@@ -363,8 +364,10 @@ void Thread::DoDestroy() {
   ThreadManager::Remove(this);
   // Clear.
   CurrentTaskQueueSetter set_current(this);
+  while (incoming_messages_.Pop() != nullptr) {
+  }
   messages_ = {};
-  delayed_messages_ = {};
+  delayed_messages_.Clear();
 }
 
 SocketServer* Thread::socketserver() {
@@ -402,16 +405,21 @@ absl::AnyInvocable<void() &&> Thread::Get(int cmsWait) {
       // All queue operations need to be locked, but nothing else in this loop
       // can happen while holding the `mutex_`.
       MutexLock lock(&mutex_);
+      // Take over messages posted since the last check.
+      while (PostedMessagePool::Ptr posted = incoming_messages_.Pop()) {
+        messages_.push(std::move(posted->functor));
+      }
       // Check for delayed messages that have been triggered and calculate the
       // next trigger time.
-      while (!delayed_messages_.empty()) {
-        if (msCurrent < delayed_messages_.top().run_time_ms) {
-          cmsDelayNext =
-              TimeDiff(delayed_messages_.top().run_time_ms, msCurrent);
-          break;
+      if (!delayed_messages_.empty()) {
+        delayed_messages_.Advance(webrtc::Timestamp::Millis(msCurrent));
+        while (delayed_messages_.has_ready_task()) {
+          messages_.push(delayed_messages_.PopReadyTask());
+        }
+        webrtc::Timestamp next_run_time = delayed_messages_.NextRunTime();
+        if (next_run_time.IsFinite()) {
+          cmsDelayNext = TimeDiff(next_run_time.ms(), msCurrent);
         }
-        messages_.push(std::move(delayed_messages_.top().functor));
-        delayed_messages_.pop();
       }
       // Pull a message off the message queue, if available.
       if (!messages_.empty()) {
@@ -436,10 +444,18 @@ absl::AnyInvocable<void() &&> Thread::Get(int cmsWait) {
     }
 
     {
-      // Wait and multiplex in the meantime
-      if (!ss_->Wait(cmsNext == kForever ? SocketServer::kForever
-                                         : webrtc::TimeDelta::Millis(cmsNext),
-                     /*process_io=*/true))
+      // Wait and multiplex in the meantime. Announce the wait before checking
+      // for posted messages a last time: a message posted concurrently is
+      // either seen here, or its poster sees `waiting_` and wakes up the
+      // socket server.
+      waiting_.store(true);
+      bool keep_going =
+          !incoming_messages_.empty() ||
+          ss_->Wait(cmsNext == kForever ? SocketServer::kForever
+                                        : webrtc::TimeDelta::Millis(cmsNext),
+                    /*process_io=*/true);
+      waiting_.store(false, std::memory_order_relaxed);
+      if (!keep_going)
         return nullptr;
     }
 
@@ -464,13 +480,14 @@ void Thread::PostTaskImpl(absl::AnyInvocable<void() &&> task,
 
   // Keep thread safe
   // Add the message to the end of the queue
-  // Signal for the multiplexer to return
+  // Signal for the multiplexer to return, unless the thread is busy and will
+  // look for new messages before it waits
 
-  {
-    MutexLock lock(&mutex_);
-    messages_.push(std::move(task));
-  }
-  WakeUpSocketServer();
+  PostedMessagePool::Ptr posted = posted_message_pool_.Take();
+  posted->functor = std::move(task);
+  incoming_messages_.Push(std::move(posted));
+  if (waiting_.load())
+    WakeUpSocketServer();
 }
 
 void Thread::PostDelayedTaskImpl(absl::AnyInvocable<void() &&> task,
@@ -482,17 +499,16 @@ void Thread::PostDelayedTaskImpl(absl::AnyInvocable<void() &&> task,
   }
 
   // Keep thread safe
-  // Add to the priority queue. Gets sorted soonest first.
+  // Add to the timing wheel. Gets sorted soonest first.
   // Signal for the multiplexer to return.
 
   int64_t delay_ms = delay.RoundUpTo(webrtc::TimeDelta::Millis(1)).ms<int>();
-  int64_t run_time_ms = TimeAfter(delay_ms);
+  int64_t now_ms = TimeMillis();
   {
     MutexLock lock(&mutex_);
-    delayed_messages_.push({.delay_ms = delay_ms,
-                            .run_time_ms = run_time_ms,
-                            .message_number = delayed_next_num_,
-                            .functor = std::move(task)});
+    delayed_messages_.Schedule(webrtc::Timestamp::Millis(now_ms),
+                               webrtc::Timestamp::Millis(now_ms + delay_ms),
+                               delayed_next_num_, std::move(task));
     // If this message queue processes 1 message every millisecond for 50 days,
     // we will wrap this number.  Even then, only messages with identical times
     // will be misordered, and then only briefly.  This is probably ok.
@@ -505,11 +521,15 @@ void Thread::PostDelayedTaskImpl(absl::AnyInvocable<void() &&> task,
 int Thread::GetDelay() {
   MutexLock lock(&mutex_);
 
-  if (!messages_.empty())
+  if (!incoming_messages_.empty() || !messages_.empty())
+    return 0;
+
+  if (delayed_messages_.has_ready_task())
     return 0;
 
-  if (!delayed_messages_.empty()) {
-    int delay = TimeUntil(delayed_messages_.top().run_time_ms);
+  webrtc::Timestamp next_run_time = delayed_messages_.NextRunTime();
+  if (next_run_time.IsFinite()) {
+    int delay = TimeUntil(next_run_time.ms());
     if (delay < 0)
       delay = 0;
     return delay;
@@ -13,6 +13,7 @@
 
 #include <stdint.h>
 
+#include <atomic>
 #include <list>
 #include <map>
 #include <memory>
@@ -37,8 +38,10 @@
 #include "rtc_base/checks.h"
 #include "rtc_base/platform_thread_types.h"
 #include "rtc_base/socket_server.h"
+#include "rtc_base/synchronization/mpsc_queue.h"
 #include "rtc_base/synchronization/mutex.h"
 #include "rtc_base/system/rtc_export.h"
+#include "rtc_base/task_utils/timing_wheel.h"
 #include "rtc_base/thread_annotations.h"
 
 #if defined(WEBRTC_WIN)
@@ -265,10 +268,10 @@ class RTC_LOCKABLE RTC_EXPORT Thread : public webrtc::TaskQueueBase {
   // Amount of time until the next message can be retrieved
   virtual int GetDelay();
 
-  bool empty() const { return size() == 0u; }
-  size_t size() const {
+  bool empty() const {
     webrtc::MutexLock lock(&mutex_);
-    return messages_.size() + delayed_messages_.size();
+    return incoming_messages_.empty() && messages_.empty() &&
+           delayed_messages_.empty();
   }
 
   bool IsCurrent() const;
@@ -394,26 +397,6 @@ class RTC_LOCKABLE RTC_EXPORT Thread : public webrtc::TaskQueueBase {
     rtc::Thread* const previous_;
   };
 
-  // DelayedMessage goes into a priority queue, sorted by trigger time. Messages
-  // with the same trigger time are processed in num_ (FIFO) order.
-  struct DelayedMessage {
-    bool operator<(const DelayedMessage& dmsg) const {
-      return (dmsg.run_time_ms < run_time_ms) ||
-             ((dmsg.run_time_ms == run_time_ms) &&
-              (dmsg.message_number < message_number));
-    }
-
-    int64_t delay_ms;  // for debugging
-    int64_t run_time_ms;
-    // Monotonicaly incrementing number used for ordering of messages
-    // targeted to execute at the same time.
-    uint32_t message_number;
-    // std::priority_queue doesn't allow to extract elements, but functor
-    // is move-only and thus need to be changed when pulled out of the
-    // priority queue. That is ok because `functor` doesn't affect operator<
-    mutable absl::AnyInvocable<void() &&> functor;
-  };
-
   // TaskQueueBase implementation.
   void PostTaskImpl(absl::AnyInvocable<void() &&> task,
                     const PostTaskTraits& traits,
@@ -485,8 +468,28 @@ class RTC_LOCKABLE RTC_EXPORT Thread : public webrtc::TaskQueueBase {
   // Called by the ThreadManager when being unset as the current thread.
   void ClearCurrentTaskQueue();
 
+  // A message posted to the thread, which moves it to `messages_` when it
+  // looks for the next message.
+  struct PostedMessage : public webrtc::MpscQueueNode {
+    absl::AnyInvocable<void() &&> functor;
+  };
+  // PostedMessages are recycled once moved to `messages_`, so few are in use
+  // at a time.
+  using PostedMessagePool =
+      webrtc::MpscNodePool<PostedMessage, /*kCapacity=*/64>;
+
+  // Messages posted from any thread. Posting does not take `mutex_`, nor
+  // allocate unless many messages are posted at once.
+  PostedMessagePool posted_message_pool_;
+  webrtc::MpscQueue<PostedMessage, PostedMessagePool::Recycler>
+      incoming_messages_{posted_message_pool_.recycler()};
+  // Set while the thread is about to wait on, or waiting on, the socket
+  // server. Posting only wakes up the socket server when set.
+  std::atomic<bool> waiting_{false};
   std::queue<absl::AnyInvocable<void() &&>> messages_ RTC_GUARDED_BY(mutex_);
-  std::priority_queue<DelayedMessage> delayed_messages_ RTC_GUARDED_BY(mutex_);
+  // Delayed messages, sorted by trigger time. Messages with the same trigger
+  // time are processed in `delayed_next_num_` (FIFO) order.
+  webrtc::TimingWheel delayed_messages_ RTC_GUARDED_BY(mutex_);
   uint32_t delayed_next_num_ RTC_GUARDED_BY(mutex_);
 #if RTC_DCHECK_IS_ON
   uint32_t blocking_call_count_ RTC_GUARDED_BY(this) = 0;
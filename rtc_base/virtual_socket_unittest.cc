@@ -15,6 +15,7 @@
 #include <time.h>
 
 #include "rtc_base/network/received_packet.h"
+#include "rtc_base/network/sent_packet.h"
 #if defined(WEBRTC_POSIX)
 #include <netinet/in.h>
 #endif
@@ -93,6 +94,14 @@ struct Sender {
   char dummy[4096];
 };
 
+struct SentPacketCounter : public sigslot::has_slots<> {
+  void OnSentPacket(AsyncPacketSocket* socket, const SentPacket& sent_packet) {
+    ++count;
+  }
+
+  int count = 0;
+};
+
 struct Receiver : public sigslot::has_slots<> {
   Receiver(Thread* th, Socket* s, uint32_t bw)
       : thread(th),
@@ -1041,6 +1050,64 @@ TEST_F(VirtualSocketServerTest, SetSendingBlockedWithUdpSocket) {
   EXPECT_EQ(3, client1->SendTo("foo", 3, socket2->GetLocalAddress()));
 }
 
+TEST_F(VirtualSocketServerTest, AsyncUdpSocketHoldsBatchWhileSendingBlocked) {
+  Socket* socket1 = ss_.CreateSocket(kIPv4AnyAddress.family(), SOCK_DGRAM);
+  Socket* socket2 = ss_.CreateSocket(kIPv4AnyAddress.family(), SOCK_DGRAM);
+  socket1->Bind(kIPv4AnyAddress);
+  socket2->Bind(kIPv4AnyAddress);
+  AsyncUDPSocket* udp_socket = new AsyncUDPSocket(socket1);
+  auto client1 =
+      std::make_unique<TestClient>(absl::WrapUnique(udp_socket), &fake_clock_);
+  auto client2 = std::make_unique<TestClient>(
+      std::make_unique<AsyncUDPSocket>(socket2), &fake_clock_);
+  SentPacketCounter sent_packets;
+  udp_socket->SignalSentPacket.connect(&sent_packets,
+                                       &SentPacketCounter::OnSentPacket);
+
+  ss_.SetSendingBlocked(true);
+  PacketOptions options;
+  options.batchable = true;
+  EXPECT_EQ(1, udp_socket->SendTo("a", 1, client2->address(), options));
+  options.last_packet_in_batch = true;
+  EXPECT_EQ(1, udp_socket->SendTo("b", 1, client2->address(), options));
+  EXPECT_EQ(0, sent_packets.count);
+  // Held back packets keep later ones from overtaking them.
+  EXPECT_EQ(-1, udp_socket->SendTo("c", 1, client2->address(), options));
+  EXPECT_TRUE(udp_socket->GetError() == EWOULDBLOCK ||
+              udp_socket->GetError() == EAGAIN);
+  EXPECT_EQ(0, client1->ready_to_send_count());
+
+  ss_.SetSendingBlocked(false);
+  EXPECT_EQ(2, sent_packets.count);
+  EXPECT_EQ(1, client1->ready_to_send_count());
+  EXPECT_TRUE(client2->CheckNextPacket("a", 1, nullptr));
+  EXPECT_TRUE(client2->CheckNextPacket("b", 1, nullptr));
+  EXPECT_TRUE(client2->CheckNoPacket());
+}
+
+TEST_F(VirtualSocketServerTest, AsyncUdpSocketKeepsSendEcnOptionOfSend) {
+  Socket* socket1 = ss_.CreateSocket(kIPv4AnyAddress.family(), SOCK_DGRAM);
+  std::unique_ptr<Socket> socket2 =
+      absl::WrapUnique(ss_.CreateSocket(kIPv4AnyAddress.family(), SOCK_DGRAM));
+  socket1->Bind(kIPv4AnyAddress);
+  socket2->Bind(kIPv4AnyAddress);
+  socket1->Connect(socket2->GetLocalAddress());
+  AsyncUDPSocket udp_socket(socket1);
+
+  PacketOptions options;
+  options.ecn_1 = true;
+  EXPECT_EQ(1, udp_socket.Send("a", 1, options));
+  // Sent as Not-ECT without changing the socket option, so that the next
+  // Send() is still marked ECT(1).
+  options.ecn_1 = false;
+  EXPECT_EQ(1, udp_socket.SendTo("b", 1, socket2->GetLocalAddress(), options));
+  options.ecn_1 = true;
+  EXPECT_EQ(1, udp_socket.Send("c", 1, options));
+  int send_ecn = 0;
+  ASSERT_EQ(0, udp_socket.GetOption(Socket::OPT_SEND_ECN, &send_ecn));
+  EXPECT_EQ(1, send_ecn);
+}
+
 TEST_F(VirtualSocketServerTest, SetSendingBlockedWithTcpSocket) {
   constexpr size_t kBufferSize = 1024;
   ss_.set_send_buffer_capacity(kBufferSize);
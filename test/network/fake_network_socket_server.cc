@@ -20,6 +20,7 @@
 #include "api/task_queue/pending_task_safety_flag.h"
 #include "rtc_base/event.h"
 #include "rtc_base/logging.h"
+#include "rtc_base/network/ecn_marking.h"
 #include "rtc_base/thread.h"
 
 namespace webrtc {
@@ -29,6 +30,20 @@ std::string ToString(const rtc::SocketAddress& addr) {
   return addr.HostAsURIString() + ":" + std::to_string(addr.port());
 }
 
+// Converts the 2-bit ECN codepoint set with Socket::OPT_SEND_ECN.
+rtc::EcnMarking EcnMarkingFromOption(int value) {
+  switch (value & 0b11) {
+    case 0b01:
+      return rtc::EcnMarking::kEct1;
+    case 0b10:
+      return rtc::EcnMarking::kEct0;
+    case 0b11:
+      return rtc::EcnMarking::kCe;
+    default:
+      return rtc::EcnMarking::kNotEct;
+  }
+}
+
 }  // namespace
 
 // Represents a socket, which will operate with emulated network.
@@ -57,6 +72,7 @@ class FakeNetworkSocket : public rtc::Socket,
                size_t cb,
                rtc::SocketAddress* paddr,
                int64_t* timestamp) override;
+  int RecvFrom(ReceiveBuffer& buffer) override;
   int Listen(int backlog) override;
   rtc::Socket* Accept(rtc::SocketAddress* paddr) override;
   int GetError() const override;
@@ -175,7 +191,11 @@ int FakeNetworkSocket::SendTo(const void* pv,
     return -1;
   }
   rtc::CopyOnWriteBuffer packet(static_cast<const uint8_t*>(pv), cb);
-  endpoint_->SendPacket(local_addr_, addr, packet);
+  auto ecn_option = options_map_.find(OPT_SEND_ECN);
+  endpoint_->SendPacket(local_addr_, addr, packet, /*application_overhead=*/0,
+                        ecn_option != options_map_.end()
+                            ? EcnMarkingFromOption(ecn_option->second)
+                            : rtc::EcnMarking::kNotEct);
   return cb;
 }
 
@@ -218,6 +238,13 @@ int FakeNetworkSocket::RecvFrom(void* pv,
   return static_cast<int>(data_read);
 }
 
+int FakeNetworkSocket::RecvFrom(ReceiveBuffer& buffer) {
+  RTC_DCHECK_RUN_ON(thread_);
+  RTC_CHECK(pending_);
+  buffer.ecn = pending_->ecn;
+  return rtc::Socket::RecvFrom(buffer);
+}
+
 int FakeNetworkSocket::Listen(int backlog) {
   RTC_CHECK(false) << "Listen() isn't valid for SOCK_DGRAM";
 }
@@ -33,6 +33,7 @@
 #include "api/units/timestamp.h"
 #include "rtc_base/copy_on_write_buffer.h"
 #include "rtc_base/network.h"
+#include "rtc_base/network/ecn_marking.h"
 #include "rtc_base/network_constants.h"
 #include "rtc_base/socket_address.h"
 #include "rtc_base/synchronization/mutex.h"
@@ -297,7 +298,8 @@ class EmulatedEndpointImpl : public EmulatedEndpoint {
   void SendPacket(const rtc::SocketAddress& from,
                   const rtc::SocketAddress& to,
                   rtc::CopyOnWriteBuffer packet_data,
-                  uint16_t application_overhead = 0) override;
+                  uint16_t application_overhead = 0,
+                  rtc::EcnMarking ecn = rtc::EcnMarking::kNotEct) override;
 
   absl::optional<uint16_t> BindReceiver(
       uint16_t desired_port,
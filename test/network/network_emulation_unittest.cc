@@ -19,10 +19,12 @@
 #include "api/task_queue/task_queue_base.h"
 #include "api/test/create_time_controller.h"
 #include "api/test/simulated_network.h"
+#include "api/units/data_rate.h"
 #include "api/units/time_delta.h"
 #include "api/units/timestamp.h"
 #include "rtc_base/event.h"
 #include "rtc_base/gunit.h"
+#include "rtc_base/network/ecn_marking.h"
 #include "rtc_base/synchronization/mutex.h"
 #include "rtc_base/task_queue_for_test.h"
 #include "test/gmock.h"
@@ -655,6 +657,41 @@ TEST(NetworkEmulationManagerTest,
   network_manager.time_controller()->AdvanceTime(TimeDelta::Seconds(1));
 }
 
+TEST(NetworkEmulationManagerTest, DeliversPacketsWithEcnMarkingOfNetwork) {
+  NetworkEmulationManagerImpl network_manager(
+      {.time_mode = TimeMode::kSimulated});
+  auto* sender_endpoint =
+      network_manager.CreateEndpoint(EmulatedEndpointConfig());
+  auto* receiver_endpoint =
+      network_manager.CreateEndpoint(EmulatedEndpointConfig());
+  // Each packet takes more than 100 ms to send through the link, so the second
+  // packet queues long enough to be marked as congestion experienced.
+  EmulatedNetworkNode* node = network_manager.CreateEmulatedNode(
+      {.link_capacity = DataRate::KilobitsPerSec(1),
+       .ecn_marking_queue_delay = TimeDelta::Millis(100)});
+  network_manager.CreateRoute(sender_endpoint, {node}, receiver_endpoint);
+
+  MockReceiver receiver;
+  ASSERT_EQ(receiver_endpoint->BindReceiver(80, &receiver), 80);
+  {
+    ::testing::InSequence s;
+    EXPECT_CALL(receiver,
+                OnPacketReceived(::testing::Field(&EmulatedIpPacket::ecn,
+                                                  rtc::EcnMarking::kEct1)));
+    EXPECT_CALL(receiver,
+                OnPacketReceived(::testing::Field(&EmulatedIpPacket::ecn,
+                                                  rtc::EcnMarking::kCe)));
+  }
+
+  for (int i = 0; i < 2; ++i) {
+    sender_endpoint->SendPacket(
+        rtc::SocketAddress(sender_endpoint->GetPeerLocalAddress(), 80),
+        rtc::SocketAddress(receiver_endpoint->GetPeerLocalAddress(), 80),
+        "Hello", /*application_overhead=*/0, rtc::EcnMarking::kEct1);
+  }
+  network_manager.time_controller()->AdvanceTime(TimeDelta::Seconds(1));
+}
+
 TEST(NetworkEmulationManagerTURNTest, GetIceServerConfig) {
   NetworkEmulationManagerImpl network_manager(
       {.time_mode = TimeMode::kRealTime});
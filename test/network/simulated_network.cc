@@ -22,6 +22,7 @@
 #include "api/units/time_delta.h"
 #include "api/units/timestamp.h"
 #include "rtc_base/checks.h"
+#include "rtc_base/network/ecn_marking.h"
 
 namespace webrtc {
 namespace {
@@ -225,6 +226,17 @@ void SimulatedNetwork::UpdateCapacityQueue(ConfigState state,
     RTC_DCHECK(packet.arrival_time.IsFinite());
     capacity_link_.pop();
 
+    // The packet has queued while the packets ahead of it were sent through
+    // the capacity link.
+    TimeDelta queue_delay =
+        std::max(last_capacity_link_exit_time_ -
+                     Timestamp::Micros(packet.packet.send_time_us),
+                 TimeDelta::Zero());
+    if (packet.packet.ecn == rtc::EcnMarking::kEct1 &&
+        queue_delay > state.config.ecn_marking_queue_delay) {
+      packet.packet.ecn = rtc::EcnMarking::kCe;
+    }
+
     // If the network is paused, the pause will be implemented as an extra delay
     // to be spent in the `delay_link_` queue.
     if (state.pause_transmission_until_us > packet.arrival_time.us()) {
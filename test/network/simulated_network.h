@@ -37,6 +37,7 @@ namespace webrtc {
 // - Extra delay with or without packets reorder
 // - Packet overhead
 // - Queue max capacity
+// - ECN marking of L4S capable packets that queue too long
 class RTC_EXPORT SimulatedNetwork : public SimulatedNetworkInterface {
  public:
   using Config = BuiltInNetworkBehaviorConfig;
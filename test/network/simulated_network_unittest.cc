@@ -21,6 +21,7 @@
 #include "api/units/data_rate.h"
 #include "api/units/time_delta.h"
 #include "api/units/timestamp.h"
+#include "rtc_base/network/ecn_marking.h"
 #include "test/gmock.h"
 #include "test/gtest.h"
 
@@ -643,6 +644,50 @@ TEST(SimulatedNetworkTest, CongestedNetworkRespectsLinkCapacity) {
   EXPECT_EQ(last_delivered_packet.packet_id, 999ul);
 }
 
+TEST(SimulatedNetworkTest, MarksL4sPacketsThatQueueTooLong) {
+  SimulatedNetwork network =
+      SimulatedNetwork({.link_capacity = DataRate::KilobitsPerSec(1),
+                        .ecn_marking_queue_delay = TimeDelta::Millis(1500)});
+  // Each packet takes 1 second to send through the link, so the packets wait
+  // 0, 1 and 2 seconds for the link to become free.
+  for (uint64_t i = 0; i < 3; ++i) {
+    ASSERT_TRUE(network.EnqueuePacket(
+        PacketInFlightInfo(/*size=*/125, /*send_time_us=*/0, /*packet_id=*/i,
+                           rtc::EcnMarking::kEct1)));
+  }
+
+  std::vector<PacketDeliveryInfo> delivered_packets =
+      network.DequeueDeliverablePackets(
+          /*receive_time_us=*/TimeDelta::Seconds(3).us());
+  ASSERT_THAT(delivered_packets, SizeIs(3));
+  EXPECT_EQ(delivered_packets[0].ecn, rtc::EcnMarking::kEct1);
+  EXPECT_EQ(delivered_packets[1].ecn, rtc::EcnMarking::kEct1);
+  EXPECT_EQ(delivered_packets[2].ecn, rtc::EcnMarking::kCe);
+}
+
+TEST(SimulatedNetworkTest, DoesNotMarkPacketsThatAreNotL4sCapable) {
+  SimulatedNetwork network =
+      SimulatedNetwork({.link_capacity = DataRate::KilobitsPerSec(1),
+                        .ecn_marking_queue_delay = TimeDelta::Zero()});
+  ASSERT_TRUE(network.EnqueuePacket(
+      PacketInFlightInfo(/*size=*/125, /*send_time_us=*/0, /*packet_id=*/0,
+                         rtc::EcnMarking::kEct1)));
+  ASSERT_TRUE(network.EnqueuePacket(
+      PacketInFlightInfo(/*size=*/125, /*send_time_us=*/0, /*packet_id=*/1,
+                         rtc::EcnMarking::kNotEct)));
+  ASSERT_TRUE(network.EnqueuePacket(
+      PacketInFlightInfo(/*size=*/125, /*send_time_us=*/0, /*packet_id=*/2,
+                         rtc::EcnMarking::kEct0)));
+
+  std::vector<PacketDeliveryInfo> delivered_packets =
+      network.DequeueDeliverablePackets(
+          /*receive_time_us=*/TimeDelta::Seconds(3).us());
+  ASSERT_THAT(delivered_packets, SizeIs(3));
+  EXPECT_EQ(delivered_packets[0].ecn, rtc::EcnMarking::kEct1);
+  EXPECT_EQ(delivered_packets[1].ecn, rtc::EcnMarking::kNotEct);
+  EXPECT_EQ(delivered_packets[2].ecn, rtc::EcnMarking::kEct0);
+}
+
 TEST(SimulatedNetworkTest, EnqueuePacketWithSubSecondNonMonotonicBehaviour) {
   // On multi-core systems, different threads can experience sub-millisecond
   // non monothonic behaviour when running on different cores. This test
@@ -74,6 +74,9 @@ std::unique_ptr<Call> CreateCall(
   call_config.bitrate_config.start_bitrate_bps =
       config.transport.rates.start_rate.bps();
   call_config.network_controller_factory = network_controller_factory;
+  call_config.bandwidth_cache = config.transport.bandwidth_cache;
+  call_config.bandwidth_cache_destination =
+      config.transport.bandwidth_cache_destination;
   call_config.audio_state = audio_state;
   return Call::Create(call_config);
 }
@@ -312,6 +315,7 @@ void CallClient::OnPacketReceived(EmulatedIpPacket packet) {
                                                  : video_extensions_;
       RtpPacketReceived received_packet(&extension_map, packet.arrival_time);
       RTC_CHECK(received_packet.Parse(packet.data));
+      received_packet.set_ecn(packet.ecn);
       call_->Receiver()->DeliverRtpPacket(media_type, received_packet,
                                           /*undemuxable_packet_handler=*/
                                           [](const RtpPacketReceived& packet) {
@@ -16,6 +16,7 @@
 #include "absl/cleanup/cleanup.h"
 #include "api/sequence_checker.h"
 #include "rtc_base/net_helper.h"
+#include "rtc_base/network/ecn_marking.h"
 #include "rtc_base/numerics/safe_minmax.h"
 
 namespace webrtc {
@@ -32,6 +33,7 @@ SimulatedNetwork::Config CreateSimulationConfig(
   sim_config.packet_overhead = config.packet_overhead.bytes<int>();
   sim_config.queue_length_packets =
       config.packet_queue_length_limit.value_or(0);
+  sim_config.ecn_marking_queue_delay = config.ecn_marking_queue_delay;
   return sim_config;
 }
 
@@ -97,8 +99,9 @@ bool NetworkNodeTransport::SendRtp(rtc::ArrayView<const uint8_t> packet,
   if (!endpoint_)
     return false;
   rtc::CopyOnWriteBuffer buffer(packet);
-  endpoint_->SendPacket(local_address_, remote_address_, buffer,
-                        packet_overhead_.bytes());
+  endpoint_->SendPacket(
+      local_address_, remote_address_, buffer, packet_overhead_.bytes(),
+      options.send_as_ect1 ? rtc::EcnMarking::kEct1 : rtc::EcnMarking::kNotEct);
   return true;
 }
 
@@ -7,11 +7,54 @@
  *  in the file PATENTS.  All contributing project authors may
  *  be found in the AUTHORS file in the root of the source tree.
  */
+#include "call/in_memory_bandwidth_cache.h"
+#include "system_wrappers/include/clock.h"
 #include "test/gtest.h"
 #include "test/scenario/scenario.h"
 
 namespace webrtc {
 namespace test {
+namespace {
+
+// Runs a call over a link of `capacity` until the caller's estimate reaches
+// `target_rate`, and returns how long that took. Then runs on for a while,
+// for `bandwidth_cache` to get the settled estimate when the call ends.
+// `cache_clock`, the clock of `bandwidth_cache`, is advanced along with the
+// call's simulated time.
+TimeDelta RunCallUntilTargetRate(SimulatedClock* cache_clock,
+                                 BandwidthCache* bandwidth_cache,
+                                 DataRate capacity,
+                                 DataRate target_rate) {
+  Scenario s;
+  NetworkSimulationConfig network;
+  network.bandwidth = capacity;
+  network.delay = TimeDelta::Millis(50);
+
+  CallClientConfig send_config;
+  send_config.transport.rates.max_rate = 2 * capacity;
+  send_config.transport.bandwidth_cache = bandwidth_cache;
+  send_config.transport.bandwidth_cache_destination = "callee";
+  auto* caller = s.CreateClient("caller", send_config);
+  auto* callee = s.CreateClient("callee", CallClientConfig());
+  auto route = s.CreateRoutes(caller, {s.CreateSimulationNode(network)}, callee,
+                              {s.CreateSimulationNode(network)});
+  VideoStreamConfig video_config;
+  video_config.encoder.codec =
+      VideoStreamConfig::Encoder::Codec::kVideoCodecVP8;
+  s.CreateVideoStream(route->forward(), video_config);
+
+  do {
+    s.RunFor(TimeDelta::Millis(10));
+    cache_clock->AdvanceTime(TimeDelta::Millis(10));
+  } while (caller->send_bandwidth() < target_rate &&
+           s.TimeSinceStart() < TimeDelta::Seconds(10));
+  TimeDelta time_to_target_rate = s.TimeSinceStart();
+  s.RunFor(TimeDelta::Seconds(5));
+  cache_clock->AdvanceTime(TimeDelta::Seconds(5));
+  return time_to_target_rate;
+}
+
+}  // namespace
 
 TEST(ProbingTest, InitialProbingRampsUpTargetRateWhenNetworkIsGood) {
   Scenario s;
@@ -34,6 +77,30 @@ TEST(ProbingTest, InitialProbingRampsUpTargetRateWhenNetworkIsGood) {
             3 * send_config.transport.rates.start_rate);
 }
 
+TEST(ProbingTest, RampsUpFasterFromEstimateCachedForRoute) {
+  const DataRate kCapacity = DataRate::KilobitsPerSec(3000);
+  const DataRate kTargetRate = DataRate::KilobitsPerSec(1500);
+  SimulatedClock clock(Timestamp::Seconds(10000));
+  InMemoryBandwidthCache bandwidth_cache(&clock,
+                                         {.max_age = TimeDelta::Minutes(1)});
+
+  // The first call over the route ramps up from the start rate, the second
+  // starts from the estimate the first call ended with.
+  TimeDelta first_call_time = RunCallUntilTargetRate(
+      &clock, &bandwidth_cache, kCapacity, kTargetRate);
+  TimeDelta second_call_time = RunCallUntilTargetRate(
+      &clock, &bandwidth_cache, kCapacity, kTargetRate);
+  EXPECT_LT(first_call_time, TimeDelta::Seconds(10));
+  EXPECT_LT(2 * second_call_time, first_call_time);
+
+  // Once the cached estimate is too old, calls ramp up from the start rate
+  // again.
+  clock.AdvanceTime(TimeDelta::Minutes(2));
+  TimeDelta third_call_time = RunCallUntilTargetRate(
+      &clock, &bandwidth_cache, kCapacity, kTargetRate);
+  EXPECT_LT(2 * second_call_time, third_call_time);
+}
+
 TEST(ProbingTest, MidCallProbingRampupTriggeredByUpdatedBitrateConstraints) {
   Scenario s;
 
@@ -24,6 +24,7 @@
 #include "api/units/time_delta.h"
 #include "api/video/video_codec_type.h"
 #include "api/video_codecs/scalability_mode.h"
+#include "call/bandwidth_cache.h"
 #include "test/scenario/performance_stats.h"
 
 namespace webrtc {
@@ -48,6 +49,8 @@ struct TransportControllerConfig {
     DataRate start_rate = DataRate::KilobitsPerSec(300);
   } rates;
   NetworkControllerFactoryInterface* cc_factory = nullptr;
+  BandwidthCache* bandwidth_cache = nullptr;
+  std::string bandwidth_cache_destination;
   TimeDelta state_log_interval = TimeDelta::Millis(100);
 };
 
@@ -223,6 +226,8 @@ struct NetworkSimulationConfig {
   double loss_rate = 0;
   absl::optional<int> packet_queue_length_limit;
   DataSize packet_overhead = DataSize::Zero();
+  // L4S capable packets queued longer than this are marked with ECN-CE.
+  TimeDelta ecn_marking_queue_delay = TimeDelta::PlusInfinity();
 };
 }  // namespace test
 }  // namespace webrtc